@@ -25,12 +25,26 @@
 #include <lal/LALAtomicDatatypes.h>
 #include <lal/LALConstants.h>
 #include <lal/AVFactories.h>
+#include <lal/SeqFactories.h>
 #include <lal/Sequence.h>
 #include <lal/TimeFreqFFT.h>
 #include <lal/Units.h>
 #include <lal/Window.h>
 #include <lal/Date.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#define AVERAGE_SPECTRUM_MAX_THREADS omp_get_max_threads()
+#define AVERAGE_SPECTRUM_THREAD_NUM omp_get_thread_num()
+#else
+#define omp ignore
+#define AVERAGE_SPECTRUM_MAX_THREADS 1
+#define AVERAGE_SPECTRUM_THREAD_NUM 0
+#endif
+
+/* number of segment periodograms held in memory at once by Welch's method */
+#define AVERAGE_SPECTRUM_BLOCK_LENGTH (4 * AVERAGE_SPECTRUM_MAX_THREADS)
+
 static COMPLEX16 cabs2(COMPLEX16 z)
 {
 	double x = creal(z);
@@ -191,6 +205,212 @@ int XLALREAL8ModifiedPeriodogram(
 }
 
 
+/* cleanup temporary workspace... ignore xlal errors */
+static void median_cleanup_REAL4( REAL4FrequencySeries *work, UINT4 n )
+{
+  int saveErrno = xlalErrno;
+  UINT4 i;
+  for ( i = 0; i < n; ++i )
+    if ( work[i].data )
+      XLALDestroyREAL4Vector( work[i].data );
+  XLALFree( work );
+  xlalErrno = saveErrno;
+  return;
+}
+static void median_cleanup_REAL8( REAL8FrequencySeries *work, UINT4 n )
+{
+  int saveErrno = xlalErrno;
+  UINT4 i;
+  for ( i = 0; i < n; ++i )
+    if ( work[i].data )
+      XLALDestroyREAL8Vector( work[i].data );
+  XLALFree( work );
+  xlalErrno = saveErrno;
+  return;
+}
+
+/*
+ * select the nth smallest of the n values in a[], partially reordering a[]
+ * so that a[nth] holds that value, no value before it is larger, and no
+ * value after it is smaller (Wirth's selection algorithm)
+ */
+static void select_nth_REAL4( REAL4 *a, UINT4 n, UINT4 nth )
+{
+  long l = 0;
+  long m = (long) n - 1;
+  const long kth = nth;
+  while ( l < m )
+  {
+    const REAL4 x = a[kth];
+    long i = l;
+    long j = m;
+    do
+    {
+      while ( a[i] < x )
+        ++i;
+      while ( x < a[j] )
+        --j;
+      if ( i <= j )
+      {
+        const REAL4 t = a[i];
+        a[i] = a[j];
+        a[j] = t;
+        ++i;
+        --j;
+      }
+    } while ( i <= j );
+    if ( j < kth )
+      l = i;
+    if ( kth < i )
+      m = j;
+  }
+}
+
+/*
+ * find the median of the n values in bin[] by selection rather than sorting;
+ * the result is identical to sorting bin[] and taking the middle value, or
+ * the mean of the two middle values if n is even
+ */
+static REAL4 select_median_REAL4( REAL4 *bin, UINT4 n )
+{
+  REAL4 lower;
+  select_nth_REAL4( bin, n, n/2 );
+  if ( n % 2 ) /* odd number */
+    return bin[n/2];
+  /* even number... take average with the largest value below the middle */
+  lower = bin[0];
+  for ( UINT4 i = 1; i < n/2; ++i )
+    if ( bin[i] > lower )
+      lower = bin[i];
+  return 0.5*(lower + bin[n/2]);
+}
+
+/*
+ * compute the modified periodograms of the numper segments of length seglen
+ * of tseries which start at samples first, first + step, first + 2*step, ...;
+ * the segments are processed in parallel, and tseries is not modified
+ */
+static int modified_periodograms_REAL4(
+    REAL4FrequencySeries        *periodograms,
+    UINT4                        numper,
+    const REAL4TimeSeries       *tseries,
+    UINT4                        first,
+    UINT4                        step,
+    UINT4                        seglen,
+    const REAL4Window           *window,
+    const REAL4FFTPlan          *plan
+    )
+{
+  int errnum = XLAL_SUCCESS;
+#pragma omp parallel for
+  for ( UINT4 i = 0; i < numper; ++i )
+  {
+    REAL4Sequence sequence; /* segment of input time series data */
+    REAL4TimeSeries segment; /* segment of input time series */
+    if ( XLALGetCollectedErrno( &errnum ) != XLAL_SUCCESS )
+      continue;
+    sequence.length = seglen;
+    sequence.data   = tseries->data->data + first + i * step;
+    segment         = *tseries;
+    segment.data    = &sequence;
+    XLALCollectErrno( &errnum, XLALREAL4ModifiedPeriodogram( periodograms + i, &segment, window, plan ) );
+  }
+  if ( errnum != XLAL_SUCCESS )
+    XLAL_ERROR( errnum );
+  return 0;
+}
+
+/*
+ * select the nth smallest of the n values in a[], partially reordering a[]
+ * so that a[nth] holds that value, no value before it is larger, and no
+ * value after it is smaller (Wirth's selection algorithm)
+ */
+static void select_nth_REAL8( REAL8 *a, UINT4 n, UINT4 nth )
+{
+  long l = 0;
+  long m = (long) n - 1;
+  const long kth = nth;
+  while ( l < m )
+  {
+    const REAL8 x = a[kth];
+    long i = l;
+    long j = m;
+    do
+    {
+      while ( a[i] < x )
+        ++i;
+      while ( x < a[j] )
+        --j;
+      if ( i <= j )
+      {
+        const REAL8 t = a[i];
+        a[i] = a[j];
+        a[j] = t;
+        ++i;
+        --j;
+      }
+    } while ( i <= j );
+    if ( j < kth )
+      l = i;
+    if ( kth < i )
+      m = j;
+  }
+}
+
+/*
+ * find the median of the n values in bin[] by selection rather than sorting;
+ * the result is identical to sorting bin[] and taking the middle value, or
+ * the mean of the two middle values if n is even
+ */
+static REAL8 select_median_REAL8( REAL8 *bin, UINT4 n )
+{
+  REAL8 lower;
+  select_nth_REAL8( bin, n, n/2 );
+  if ( n % 2 ) /* odd number */
+    return bin[n/2];
+  /* even number... take average with the largest value below the middle */
+  lower = bin[0];
+  for ( UINT4 i = 1; i < n/2; ++i )
+    if ( bin[i] > lower )
+      lower = bin[i];
+  return 0.5*(lower + bin[n/2]);
+}
+
+/*
+ * compute the modified periodograms of the numper segments of length seglen
+ * of tseries which start at samples first, first + step, first + 2*step, ...;
+ * the segments are processed in parallel, and tseries is not modified
+ */
+static int modified_periodograms_REAL8(
+    REAL8FrequencySeries        *periodograms,
+    UINT4                        numper,
+    const REAL8TimeSeries       *tseries,
+    UINT4                        first,
+    UINT4                        step,
+    UINT4                        seglen,
+    const REAL8Window           *window,
+    const REAL8FFTPlan          *plan
+    )
+{
+  int errnum = XLAL_SUCCESS;
+#pragma omp parallel for
+  for ( UINT4 i = 0; i < numper; ++i )
+  {
+    REAL8Sequence sequence; /* segment of input time series data */
+    REAL8TimeSeries segment; /* segment of input time series */
+    if ( XLALGetCollectedErrno( &errnum ) != XLAL_SUCCESS )
+      continue;
+    sequence.length = seglen;
+    sequence.data   = tseries->data->data + first + i * step;
+    segment         = *tseries;
+    segment.data    = &sequence;
+    XLALCollectErrno( &errnum, XLALREAL8ModifiedPeriodogram( periodograms + i, &segment, window, plan ) );
+  }
+  if ( errnum != XLAL_SUCCESS )
+    XLAL_ERROR( errnum );
+  return 0;
+}
+
 /**
  * Use Welch's method to compute the average power spectrum of a time series.
  *
@@ -209,10 +429,9 @@ int XLALREAL4AverageSpectrumWelch(
     const REAL4FFTPlan          *plan
     )
 {
-  REAL4FrequencySeries *work; /* workspace */
-  REAL4Sequence sequence; /* working copy of input time series data */
-  REAL4TimeSeries tseriescopy; /* working copy of input time series */
+  REAL4FrequencySeries *work; /* array of frequency series for a block of segments */
   UINT4 numseg;
+  UINT4 blklen;
   UINT4 seg;
   UINT4 k;
 
@@ -223,12 +442,6 @@ int XLALREAL4AverageSpectrumWelch(
   if ( tseries->deltaT <= 0.0 )
       XLAL_ERROR( XLAL_EINVAL );
 
-  /* construct local copy of time series */
-  sequence = *tseries->data;
-  tseriescopy = *tseries;
-  tseriescopy.data = &sequence;
-  tseriescopy.data->length = seglen;
-
   numseg = 1 + (tseries->data->length - seglen)/stride;
 
   /* consistency check for lengths: make sure that the segments cover the
@@ -242,37 +455,52 @@ int XLALREAL4AverageSpectrumWelch(
   memset( spectrum->data->data, 0,
       spectrum->data->length * sizeof( *spectrum->data->data ) );
 
-  /* create frequency series data workspace */
-  work = XLALCutREAL4FrequencySeries( spectrum, 0, spectrum->data->length );
-  if( ! work )
-    XLAL_ERROR( XLAL_EFUNC );
+  /* create frequency series data workspaces for a block of segments */
+  blklen = AVERAGE_SPECTRUM_BLOCK_LENGTH < numseg ? AVERAGE_SPECTRUM_BLOCK_LENGTH : numseg;
+  work = XLALCalloc( blklen, sizeof( *work ) );
+  if ( ! work )
+    XLAL_ERROR( XLAL_ENOMEM );
+  for ( seg = 0; seg < blklen; ++seg )
+  {
+    work[seg].data = XLALCreateREAL4Vector( spectrum->data->length );
+    if ( ! work[seg].data )
+    {
+      median_cleanup_REAL4( work, blklen ); /* cleanup */
+      XLAL_ERROR( XLAL_EFUNC );
+    }
+  }
 
-  for ( seg = 0; seg < numseg; seg++, tseriescopy.data->data += stride )
+  for ( seg = 0; seg < numseg; seg += blklen )
   {
-    /* compute the modified periodogram; clean up and exit on failure */
-    if ( XLALREAL4ModifiedPeriodogram( work, &tseriescopy, window, plan ) == XLAL_FAILURE )
+    UINT4 nblk = numseg - seg < blklen ? numseg - seg : blklen;
+
+    /* compute the modified periodograms of this block of segments in
+     * parallel; clean up and exit on failure */
+    if ( modified_periodograms_REAL4( work, nblk, tseries, seg * stride, stride, seglen, window, plan ) == XLAL_FAILURE )
     {
-      XLALDestroyREAL4FrequencySeries( work );
+      median_cleanup_REAL4( work, blklen ); /* cleanup */
       XLAL_ERROR( XLAL_EFUNC );
     }
 
-    /* add the periodogram to the running sum */
-    for ( k = 0; k < spectrum->data->length; ++k )
-      spectrum->data->data[k] += work->data->data[k];
+    /* add the periodograms to the running sum, in segment order so the
+     * result does not depend on the number of threads */
+    for ( UINT4 blk = 0; blk < nblk; ++blk )
+      for ( k = 0; k < spectrum->data->length; ++k )
+        spectrum->data->data[k] += work[blk].data->data[k];
   }
 
-  /* set metadata */
-  spectrum->epoch       = work->epoch;
-  spectrum->f0          = work->f0;
-  spectrum->deltaF      = work->deltaF;
-  spectrum->sampleUnits = work->sampleUnits;
+  /* set metadata from the periodogram of the last segment */
+  spectrum->epoch       = work[(numseg - 1) % blklen].epoch;
+  spectrum->f0          = work[(numseg - 1) % blklen].f0;
+  spectrum->deltaF      = work[(numseg - 1) % blklen].deltaF;
+  spectrum->sampleUnits = work[(numseg - 1) % blklen].sampleUnits;
 
   /* divide spectrum data by the number of segments in average */
   for ( k = 0; k < spectrum->data->length; ++k )
     spectrum->data->data[k] /= numseg;
 
   /* clean up */
-  XLALDestroyREAL4FrequencySeries( work );
+  median_cleanup_REAL4( work, blklen );
 
   return 0;
 }
@@ -295,10 +523,9 @@ int XLALREAL8AverageSpectrumWelch(
     const REAL8FFTPlan          *plan
     )
 {
-  REAL8FrequencySeries *work; /* workspace */
-  REAL8Sequence sequence; /* working copy of input time series data */
-  REAL8TimeSeries tseriescopy; /* working copy of input time series */
+  REAL8FrequencySeries *work; /* array of frequency series for a block of segments */
   UINT4 numseg;
+  UINT4 blklen;
   UINT4 seg;
   UINT4 k;
 
@@ -309,12 +536,6 @@ int XLALREAL8AverageSpectrumWelch(
   if ( tseries->deltaT <= 0.0 )
       XLAL_ERROR( XLAL_EINVAL );
 
-  /* construct local copy of time series */
-  sequence = *tseries->data;
-  tseriescopy = *tseries;
-  tseriescopy.data = &sequence;
-  tseriescopy.data->length = seglen;
-
   numseg = 1 + (tseries->data->length - seglen)/stride;
 
   /* consistency check for lengths: make sure that the segments cover the
@@ -328,37 +549,52 @@ int XLALREAL8AverageSpectrumWelch(
   memset( spectrum->data->data, 0,
       spectrum->data->length * sizeof( *spectrum->data->data ) );
 
-  /* create frequency series data workspace */
-  work = XLALCutREAL8FrequencySeries( spectrum, 0, spectrum->data->length );
-  if( ! work )
-    XLAL_ERROR( XLAL_EFUNC );
+  /* create frequency series data workspaces for a block of segments */
+  blklen = AVERAGE_SPECTRUM_BLOCK_LENGTH < numseg ? AVERAGE_SPECTRUM_BLOCK_LENGTH : numseg;
+  work = XLALCalloc( blklen, sizeof( *work ) );
+  if ( ! work )
+    XLAL_ERROR( XLAL_ENOMEM );
+  for ( seg = 0; seg < blklen; ++seg )
+  {
+    work[seg].data = XLALCreateREAL8Vector( spectrum->data->length );
+    if ( ! work[seg].data )
+    {
+      median_cleanup_REAL8( work, blklen ); /* cleanup */
+      XLAL_ERROR( XLAL_EFUNC );
+    }
+  }
 
-  for ( seg = 0; seg < numseg; seg++, tseriescopy.data->data += stride )
+  for ( seg = 0; seg < numseg; seg += blklen )
   {
-    /* compute the modified periodogram; clean up and exit on failure */
-    if ( XLALREAL8ModifiedPeriodogram( work, &tseriescopy, window, plan ) == XLAL_FAILURE )
+    UINT4 nblk = numseg - seg < blklen ? numseg - seg : blklen;
+
+    /* compute the modified periodograms of this block of segments in
+     * parallel; clean up and exit on failure */
+    if ( modified_periodograms_REAL8( work, nblk, tseries, seg * stride, stride, seglen, window, plan ) == XLAL_FAILURE )
     {
-      XLALDestroyREAL8FrequencySeries( work );
+      median_cleanup_REAL8( work, blklen ); /* cleanup */
       XLAL_ERROR( XLAL_EFUNC );
     }
 
-    /* add the periodogram to the running sum */
-    for ( k = 0; k < spectrum->data->length; ++k )
-      spectrum->data->data[k] += work->data->data[k];
+    /* add the periodograms to the running sum, in segment order so the
+     * result does not depend on the number of threads */
+    for ( UINT4 blk = 0; blk < nblk; ++blk )
+      for ( k = 0; k < spectrum->data->length; ++k )
+        spectrum->data->data[k] += work[blk].data->data[k];
   }
 
-  /* set metadata */
-  spectrum->epoch       = work->epoch;
-  spectrum->f0          = work->f0;
-  spectrum->deltaF      = work->deltaF;
-  spectrum->sampleUnits = work->sampleUnits;
+  /* set metadata from the periodogram of the last segment */
+  spectrum->epoch       = work[(numseg - 1) % blklen].epoch;
+  spectrum->f0          = work[(numseg - 1) % blklen].f0;
+  spectrum->deltaF      = work[(numseg - 1) % blklen].deltaF;
+  spectrum->sampleUnits = work[(numseg - 1) % blklen].sampleUnits;
 
   /* divide spectrum data by the number of segments in average */
   for ( k = 0; k < spectrum->data->length; ++k )
     spectrum->data->data[k] /= numseg;
 
   /* clean up */
-  XLALDestroyREAL8FrequencySeries( work );
+  median_cleanup_REAL8( work, blklen );
 
   return 0;
 }
@@ -394,45 +630,6 @@ REAL8 XLALMedianBias( UINT4 nn )
   return ans;
 }
 
-/* cleanup temporary workspace... ignore xlal errors */
-static void median_cleanup_REAL4( REAL4FrequencySeries *work, UINT4 n )
-{
-  int saveErrno = xlalErrno;
-  UINT4 i;
-  for ( i = 0; i < n; ++i )
-    if ( work[i].data )
-      XLALDestroyREAL4Vector( work[i].data );
-  XLALFree( work );
-  xlalErrno = saveErrno;
-  return;
-}
-static void median_cleanup_REAL8( REAL8FrequencySeries *work, UINT4 n )
-{
-  int saveErrno = xlalErrno;
-  UINT4 i;
-  for ( i = 0; i < n; ++i )
-    if ( work[i].data )
-      XLALDestroyREAL8Vector( work[i].data );
-  XLALFree( work );
-  xlalErrno = saveErrno;
-  return;
-}
-
-/* comparison for floating point numbers */
-static int compare_REAL4( const void *p1, const void *p2 )
-{
-  REAL4 x1 = *(const REAL4 *)p1;
-  REAL4 x2 = *(const REAL4 *)p2;
-  return (x1 > x2) - (x1 < x2);
-}
-static int compare_REAL8( const void *p1, const void *p2 )
-{
-  REAL8 x1 = *(const REAL8 *)p1;
-  REAL8 x2 = *(const REAL8 *)p2;
-  return (x1 > x2) - (x1 < x2);
-}
-
-
 /**
  * Median Method: use median average rather than mean.  Note: this will
  * cause a bias if the segments overlap, i.e., if the stride is less than
@@ -451,7 +648,7 @@ int XLALREAL4AverageSpectrumMedian(
     )
 {
   REAL4FrequencySeries *work; /* array of frequency series */
-  REAL4 *bin; /* array of bin values */
+  REAL4 *bin; /* array of bin values for each thread */
   REAL4 biasfac; /* median bias factor */
   REAL4 normfac; /* normalization factor */
   UINT4 reclen; /* length of entire data record */
@@ -490,34 +687,15 @@ int XLALREAL4AverageSpectrumMedian(
     }
   }
 
-  for ( seg = 0; seg < numseg; ++seg )
+  /* compute the modified periodograms of all segments in parallel */
+  if ( modified_periodograms_REAL4( work, numseg, tseries, 0, stride, seglen, window, plan ) == XLAL_FAILURE )
   {
-    REAL4Vector savevec; /* save the time series data vector */
-    int code;
-
-    /* save the time series data vector */
-    savevec = *tseries->data;
-
-    /* set the data vector to be appropriate for the even segment */
-    tseries->data->length  = seglen;
-    tseries->data->data   += seg * stride;
-
-    /* compute the modified periodogram for the even segment */
-    code = XLALREAL4ModifiedPeriodogram( work + seg, tseries, window, plan );
-
-    /* restore the time series data vector to its original state */
-    *tseries->data = savevec;
-
-    /* now check for failure of the XLAL routine */
-    if ( code == XLAL_FAILURE )
-    {
-      median_cleanup_REAL4( work, numseg ); /* cleanup */
-      XLAL_ERROR( XLAL_EFUNC );
-    }
+    median_cleanup_REAL4( work, numseg ); /* cleanup */
+    XLAL_ERROR( XLAL_EFUNC );
   }
 
-  /* create array to hold a particular frequency bin data */
-  bin = XLALMalloc( numseg * sizeof( *bin ) );
+  /* create arrays to hold a particular frequency bin data in each thread */
+  bin = XLALMalloc( AVERAGE_SPECTRUM_MAX_THREADS * numseg * sizeof( *bin ) );
   if ( ! bin )
   {
     median_cleanup_REAL4( work, numseg ); /* cleanup */
@@ -530,19 +708,18 @@ int XLALREAL4AverageSpectrumMedian(
   /* normaliztion takes into account bias */
   normfac = 1.0 / biasfac;
 
-  /* now loop over frequency bins and compute the median-mean */
+  /* now loop over frequency bins and compute the median */
+#pragma omp parallel for
   for ( k = 0; k < spectrum->data->length; ++k )
   {
-    /* assign array of even segment values to bin array for this freq bin */
-    for ( seg = 0; seg < numseg; ++seg )
-      bin[seg] = work[seg].data->data[k];
+    REAL4 *thread_bin = bin + AVERAGE_SPECTRUM_THREAD_NUM * numseg;
+
+    /* assign array of segment values to bin array for this freq bin */
+    for ( UINT4 i = 0; i < numseg; ++i )
+      thread_bin[i] = work[i].data->data[k];
 
-    /* sort them and find median */
-    qsort( bin, numseg, sizeof( *bin ), compare_REAL4 );
-    if ( numseg % 2 ) /* odd number of evens */
-      spectrum->data->data[k] = bin[numseg/2];
-    else /* even number... take average */
-      spectrum->data->data[k] = 0.5*(bin[numseg/2-1] + bin[numseg/2]);
+    /* select the median */
+    spectrum->data->data[k] = select_median_REAL4( thread_bin, numseg );
 
     /* remove median bias */
     spectrum->data->data[k] *= normfac;
@@ -579,7 +756,7 @@ int XLALREAL8AverageSpectrumMedian(
     )
 {
   REAL8FrequencySeries *work; /* array of frequency series */
-  REAL8 *bin; /* array of bin values */
+  REAL8 *bin; /* array of bin values for each thread */
   REAL8 biasfac; /* median bias factor */
   REAL8 normfac; /* normalization factor */
   UINT4 reclen; /* length of entire data record */
@@ -618,34 +795,15 @@ int XLALREAL8AverageSpectrumMedian(
     }
   }
 
-  for ( seg = 0; seg < numseg; ++seg )
+  /* compute the modified periodograms of all segments in parallel */
+  if ( modified_periodograms_REAL8( work, numseg, tseries, 0, stride, seglen, window, plan ) == XLAL_FAILURE )
   {
-    REAL8Vector savevec; /* save the time series data vector */
-    int code;
-
-    /* save the time series data vector */
-    savevec = *tseries->data;
-
-    /* set the data vector to be appropriate for the even segment */
-    tseries->data->length  = seglen;
-    tseries->data->data   += seg * stride;
-
-    /* compute the modified periodogram for the even segment */
-    code = XLALREAL8ModifiedPeriodogram( work + seg, tseries, window, plan );
-
-    /* restore the time series data vector to its original state */
-    *tseries->data = savevec;
-
-    /* now check for failure of the XLAL routine */
-    if ( code == XLAL_FAILURE )
-    {
-      median_cleanup_REAL8( work, numseg ); /* cleanup */
-      XLAL_ERROR( XLAL_EFUNC );
-    }
+    median_cleanup_REAL8( work, numseg ); /* cleanup */
+    XLAL_ERROR( XLAL_EFUNC );
   }
 
-  /* create array to hold a particular frequency bin data */
-  bin = XLALMalloc( numseg * sizeof( *bin ) );
+  /* create arrays to hold a particular frequency bin data in each thread */
+  bin = XLALMalloc( AVERAGE_SPECTRUM_MAX_THREADS * numseg * sizeof( *bin ) );
   if ( ! bin )
   {
     median_cleanup_REAL8( work, numseg ); /* cleanup */
@@ -658,19 +816,18 @@ int XLALREAL8AverageSpectrumMedian(
   /* normaliztion takes into account bias */
   normfac = 1.0 / biasfac;
 
-  /* now loop over frequency bins and compute the median-mean */
+  /* now loop over frequency bins and compute the median */
+#pragma omp parallel for
   for ( k = 0; k < spectrum->data->length; ++k )
   {
-    /* assign array of even segment values to bin array for this freq bin */
-    for ( seg = 0; seg < numseg; ++seg )
-      bin[seg] = work[seg].data->data[k];
+    REAL8 *thread_bin = bin + AVERAGE_SPECTRUM_THREAD_NUM * numseg;
+
+    /* assign array of segment values to bin array for this freq bin */
+    for ( UINT4 i = 0; i < numseg; ++i )
+      thread_bin[i] = work[i].data->data[k];
 
-    /* sort them and find median */
-    qsort( bin, numseg, sizeof( *bin ), compare_REAL8 );
-    if ( numseg % 2 ) /* odd number of evens */
-      spectrum->data->data[k] = bin[numseg/2];
-    else /* even number... take average */
-      spectrum->data->data[k] = 0.5*(bin[numseg/2-1] + bin[numseg/2]);
+    /* select the median */
+    spectrum->data->data[k] = select_median_REAL8( thread_bin, numseg );
 
     /* remove median bias */
     spectrum->data->data[k] *= normfac;
@@ -749,7 +906,7 @@ int XLALREAL4AverageSpectrumMedianMean(
 {
   REAL4FrequencySeries *even; /* array of even frequency series */
   REAL4FrequencySeries *odd;  /* array of odd frequency series */
-  REAL4 *bin; /* array of bin values */
+  REAL4 *bin; /* array of bin values for each thread */
   REAL4 biasfac; /* median bias factor */
   REAL4 normfac; /* normalization factor */
   UINT4 reclen; /* length of entire data record */
@@ -799,49 +956,17 @@ int XLALREAL4AverageSpectrumMedianMean(
     }
   }
 
-  for ( seg = 0; seg < halfnumseg; ++seg )
+  /* compute the modified periodograms for the even and the odd segments in
+   * parallel */
+  if ( modified_periodograms_REAL4( even, halfnumseg, tseries, 0, 2 * stride, seglen, window, plan ) == XLAL_FAILURE
+    || modified_periodograms_REAL4( odd, halfnumseg, tseries, stride, 2 * stride, seglen, window, plan ) == XLAL_FAILURE )
   {
-    REAL4Vector savevec; /* save the time series data vector */
-    int code;
-
-    /* save the time series data vector */
-    savevec = *tseries->data;
-
-    /* set the data vector to be appropriate for the even segment */
-    tseries->data->length  = seglen;
-    tseries->data->data   += 2 * seg * stride;
-
-    /* compute the modified periodogram for the even segment */
-    code = XLALREAL4ModifiedPeriodogram( even + seg, tseries, window, plan );
-
-    /* now check for failure of the XLAL routine */
-    if ( code == XLAL_FAILURE )
-    {
-      *tseries->data = savevec;
-      median_mean_cleanup_REAL4( even, odd, halfnumseg ); /* cleanup */
-      XLAL_ERROR( XLAL_EFUNC );
-    }
-
-    /* set the data vector to be appropriate for the odd segment */
-    tseries->data->data += stride;
-
-    /* compute the modified periodogram for the odd segment */
-    code = XLALREAL4ModifiedPeriodogram( odd + seg, tseries, window, plan );
-
-    /* now check for failure of the XLAL routine */
-    if ( code == XLAL_FAILURE )
-    {
-      *tseries->data = savevec;
-      median_mean_cleanup_REAL4( even, odd, halfnumseg ); /* cleanup */
-      XLAL_ERROR( XLAL_EFUNC );
-    }
-
-    /* restore the time series data vector to its original state */
-    *tseries->data = savevec;
+    median_mean_cleanup_REAL4( even, odd, halfnumseg ); /* cleanup */
+    XLAL_ERROR( XLAL_EFUNC );
   }
 
-  /* create array to hold a particular frequency bin data */
-  bin = XLALMalloc( halfnumseg * sizeof( *bin ) );
+  /* create arrays to hold a particular frequency bin data in each thread */
+  bin = XLALMalloc( AVERAGE_SPECTRUM_MAX_THREADS * halfnumseg * sizeof( *bin ) );
   if ( ! bin )
   {
     median_mean_cleanup_REAL4( even, odd, halfnumseg ); /* cleanup */
@@ -856,32 +981,26 @@ int XLALREAL4AverageSpectrumMedianMean(
   normfac = 1.0 / ( 2.0 * biasfac );
 
   /* now loop over frequency bins and compute the median-mean */
+#pragma omp parallel for
   for ( k = 0; k < spectrum->data->length; ++k )
   {
+    REAL4 *thread_bin = bin + AVERAGE_SPECTRUM_THREAD_NUM * halfnumseg;
     REAL4 evenmedian;
     REAL4 oddmedian;
 
     /* assign array of even segment values to bin array for this freq bin */
-    for ( seg = 0; seg < halfnumseg; ++seg )
-      bin[seg] = even[seg].data->data[k];
+    for ( UINT4 i = 0; i < halfnumseg; ++i )
+      thread_bin[i] = even[i].data->data[k];
 
-    /* sort them and find median */
-    qsort( bin, halfnumseg, sizeof( *bin ), compare_REAL4 );
-    if ( halfnumseg % 2 ) /* odd number of evens */
-      evenmedian = bin[halfnumseg/2];
-    else /* even number... take average */
-      evenmedian = 0.5*(bin[halfnumseg/2-1] + bin[halfnumseg/2]);
+    /* select the median */
+    evenmedian = select_median_REAL4( thread_bin, halfnumseg );
 
     /* assign array of odd segment values to bin array for this freq bin */
-    for ( seg = 0; seg < halfnumseg; ++seg )
-      bin[seg] = odd[seg].data->data[k];
+    for ( UINT4 i = 0; i < halfnumseg; ++i )
+      thread_bin[i] = odd[i].data->data[k];
 
-    /* sort them and find median */
-    qsort( bin, halfnumseg, sizeof( *bin ), compare_REAL4 );
-    if ( halfnumseg % 2 ) /* odd number of odds */
-      oddmedian = bin[halfnumseg/2];
-    else /* even number... take average */
-      oddmedian = 0.5*(bin[halfnumseg/2-1] + bin[halfnumseg/2]);
+    /* select the median */
+    oddmedian = select_median_REAL4( thread_bin, halfnumseg );
 
     /* spectrum for this bin is the mean of the medians */
     spectrum->data->data[k] = normfac * (evenmedian + oddmedian);
@@ -918,7 +1037,7 @@ int XLALREAL8AverageSpectrumMedianMean(
 {
   REAL8FrequencySeries *even; /* array of even frequency series */
   REAL8FrequencySeries *odd;  /* array of odd frequency series */
-  REAL8 *bin; /* array of bin values */
+  REAL8 *bin; /* array of bin values for each thread */
   REAL8 biasfac; /* median bias factor */
   REAL8 normfac; /* normalization factor */
   UINT4 reclen; /* length of entire data record */
@@ -968,49 +1087,17 @@ int XLALREAL8AverageSpectrumMedianMean(
     }
   }
 
-  for ( seg = 0; seg < halfnumseg; ++seg )
+  /* compute the modified periodograms for the even and the odd segments in
+   * parallel */
+  if ( modified_periodograms_REAL8( even, halfnumseg, tseries, 0, 2 * stride, seglen, window, plan ) == XLAL_FAILURE
+    || modified_periodograms_REAL8( odd, halfnumseg, tseries, stride, 2 * stride, seglen, window, plan ) == XLAL_FAILURE )
   {
-    REAL8Vector savevec; /* save the time series data vector */
-    int code;
-
-    /* save the time series data vector */
-    savevec = *tseries->data;
-
-    /* set the data vector to be appropriate for the even segment */
-    tseries->data->length  = seglen;
-    tseries->data->data   += 2 * seg * stride;
-
-    /* compute the modified periodogram for the even segment */
-    code = XLALREAL8ModifiedPeriodogram( even + seg, tseries, window, plan );
-
-    /* now check for failure of the XLAL routine */
-    if ( code == XLAL_FAILURE )
-    {
-      *tseries->data = savevec;
-      median_mean_cleanup_REAL8( even, odd, halfnumseg ); /* cleanup */
-      XLAL_ERROR( XLAL_EFUNC );
-    }
-
-    /* set the data vector to be appropriate for the odd segment */
-    tseries->data->data += stride;
-
-    /* compute the modified periodogram for the odd segment */
-    code = XLALREAL8ModifiedPeriodogram( odd + seg, tseries, window, plan );
-
-    /* now check for failure of the XLAL routine */
-    if ( code == XLAL_FAILURE )
-    {
-      *tseries->data = savevec;
-      median_mean_cleanup_REAL8( even, odd, halfnumseg ); /* cleanup */
-      XLAL_ERROR( XLAL_EFUNC );
-    }
-
-    /* restore the time series data vector to its original state */
-    *tseries->data = savevec;
+    median_mean_cleanup_REAL8( even, odd, halfnumseg ); /* cleanup */
+    XLAL_ERROR( XLAL_EFUNC );
   }
 
-  /* create array to hold a particular frequency bin data */
-  bin = XLALMalloc( halfnumseg * sizeof( *bin ) );
+  /* create arrays to hold a particular frequency bin data in each thread */
+  bin = XLALMalloc( AVERAGE_SPECTRUM_MAX_THREADS * halfnumseg * sizeof( *bin ) );
   if ( ! bin )
   {
     median_mean_cleanup_REAL8( even, odd, halfnumseg ); /* cleanup */
@@ -1025,32 +1112,26 @@ int XLALREAL8AverageSpectrumMedianMean(
   normfac = 1.0 / ( 2.0 * biasfac );
 
   /* now loop over frequency bins and compute the median-mean */
+#pragma omp parallel for
   for ( k = 0; k < spectrum->data->length; ++k )
   {
+    REAL8 *thread_bin = bin + AVERAGE_SPECTRUM_THREAD_NUM * halfnumseg;
     REAL8 evenmedian;
     REAL8 oddmedian;
 
     /* assign array of even segment values to bin array for this freq bin */
-    for ( seg = 0; seg < halfnumseg; ++seg )
-      bin[seg] = even[seg].data->data[k];
+    for ( UINT4 i = 0; i < halfnumseg; ++i )
+      thread_bin[i] = even[i].data->data[k];
 
-    /* sort them and find median */
-    qsort( bin, halfnumseg, sizeof( *bin ), compare_REAL8 );
-    if ( halfnumseg % 2 ) /* odd number of evens */
-      evenmedian = bin[halfnumseg/2];
-    else /* even number... take average */
-      evenmedian = 0.5*(bin[halfnumseg/2-1] + bin[halfnumseg/2]);
+    /* select the median */
+    evenmedian = select_median_REAL8( thread_bin, halfnumseg );
 
     /* assign array of odd segment values to bin array for this freq bin */
-    for ( seg = 0; seg < halfnumseg; ++seg )
-      bin[seg] = odd[seg].data->data[k];
+    for ( UINT4 i = 0; i < halfnumseg; ++i )
+      thread_bin[i] = odd[i].data->data[k];
 
-    /* sort them and find median */
-    qsort( bin, halfnumseg, sizeof( *bin ), compare_REAL8 );
-    if ( halfnumseg % 2 ) /* odd number of odds */
-      oddmedian = bin[halfnumseg/2];
-    else /* even number... take average */
-      oddmedian = 0.5*(bin[halfnumseg/2-1] + bin[halfnumseg/2]);
+    /* select the median */
+    oddmedian = select_median_REAL8( thread_bin, halfnumseg );
 
     /* spectrum for this bin is the mean of the medians */
     spectrum->data->data[k] = normfac * (evenmedian + oddmedian);
@@ -1425,6 +1506,18 @@ REAL8 XLALLogMedianBiasGeometric( UINT4 nn )
   return log(XLALMedianBias(nn)) - nn * (gsl_sf_lngamma(1.0 / nn) - log(nn));
 }
 
+/*
+ * update the logarithm of the geometric mean square of a frequency bin
+ * from the logarithm of the median of its recent history, see
+ * XLALPSDRegressorAdd()
+ */
+static double psd_regressor_update(double log_mean_square, double log_bin_median, unsigned n_samples, double median_bias)
+{
+  if(isinf(log_bin_median) && log_bin_median < 0)
+    return log_mean_square + log((n_samples - 1.0) / n_samples);
+  return (log_mean_square * (n_samples - 1) + log_bin_median - median_bias) / n_samples;
+}
+
 /**
  * Allocate and initialize a LALPSDRegressor object.
  *
@@ -1526,7 +1619,7 @@ void XLALPSDRegressorFree(LALPSDRegressor *r)
     XLALFree(r->history);
     r->history = NULL;
   }
-  free(r);
+  XLALFree(r);
 }
 
 /**
@@ -1738,9 +1831,9 @@ int XLALPSDRegressorAdd(LALPSDRegressor *r, const COMPLEX16FrequencySeries *samp
     for(j = 0; j < history_length; j++)
       bin_history[j] = r->history[j]->data[i];
 
-    /* sort (to find the median) */
+    /* select the median */
 
-    qsort(bin_history, history_length, sizeof(*bin_history), compare_REAL8);
+    select_nth_REAL8(bin_history, history_length, history_length / 2);
     log_bin_median = log(bin_history[history_length / 2]);
 
     /* use logarithm of median to update geometric mean.
@@ -1755,10 +1848,7 @@ int XLALPSDRegressorAdd(LALPSDRegressor *r, const COMPLEX16FrequencySeries *samp
      * variable that is so the correction factor is the same.
      */
 
-    if(isinf(log_bin_median) && log_bin_median < 0)
-      r->mean_square->data->data[i] = r->mean_square->data->data[i] + log((r->n_samples - 1.0) / r->n_samples);
-    else
-      r->mean_square->data->data[i] = (r->mean_square->data->data[i] * (r->n_samples - 1) + log_bin_median - median_bias) / r->n_samples;
+    r->mean_square->data->data[i] = psd_regressor_update(r->mean_square->data->data[i], log_bin_median, r->n_samples, median_bias);
   }
 
   XLALFree(bin_history);
@@ -1898,6 +1988,199 @@ int XLALPSDRegressorSetPSD(LALPSDRegressor *r, const REAL8FrequencySeries *psd,
 }
 
 
+/**
+ * Allocate and initialize a LALPSDMultiRegressor object.
+ *
+ * The LALPSDMultiRegressor object implements the same algorithm as the
+ * LALPSDRegressor object (see XLALPSDRegressorNew()) for n_channels
+ * channels at once, for example for the online whitening of many
+ * channels of a detector.  Each update is a block of n_channels frequency
+ * series of length bins stored one after another in a single
+ * COMPLEX16VectorSequence, which must have been computed from real-valued
+ * data with a frequency resolution of deltaF, and all channels are
+ * updated in a single pass over the block.  The current PSD estimates are
+ * kept up to date with each update and can be read without copying them
+ * with XLALPSDMultiRegressorGetPSDs().
+ *
+ * The average_samples and median_samples parameters have the same meaning
+ * as for XLALPSDRegressorNew(), and median_samples must be odd.
+ */
+LALPSDMultiRegressor *XLALPSDMultiRegressorNew(unsigned n_channels, unsigned bins, REAL8 deltaF, unsigned average_samples, unsigned median_samples)
+{
+  LALPSDMultiRegressor *new;
+
+  /* require the number of samples used for the average and the number of
+   * snapshots used for the median to both be positive, and the number of
+   * snapshots used for the median to be odd */
+  if(average_samples < 1 || median_samples < 1 || !(median_samples & 1))
+    XLAL_ERROR_NULL(XLAL_EINVAL);
+  if(n_channels < 1 || bins < 1 || deltaF <= 0.0)
+    XLAL_ERROR_NULL(XLAL_EINVAL);
+
+  new = XLALCalloc(1, sizeof(*new));
+  if(!new)
+    XLAL_ERROR_NULL(XLAL_ENOMEM);
+
+  new->average_samples = average_samples;
+  new->median_samples = median_samples;
+  new->n_samples = 0;
+  new->newest = 0;
+  new->deltaF = deltaF;
+
+  /* the median history of each bin is stored contiguously */
+  new->history = XLALCreateREAL8Vector((size_t) n_channels * bins * median_samples);
+  new->mean_square = XLALCreateREAL8VectorSequence(n_channels, bins);
+  new->psd = XLALCreateREAL8VectorSequence(n_channels, bins);
+  if(!new->history || !new->mean_square || !new->psd)
+  {
+    XLALPSDMultiRegressorFree(new);
+    XLAL_ERROR_NULL(XLAL_EFUNC);
+  }
+
+  return new;
+}
+
+/**
+ * Reset a LALPSDMultiRegressor object to the newly-allocated state.
+ */
+void XLALPSDMultiRegressorReset(LALPSDMultiRegressor *r)
+{
+  r->n_samples = 0;
+  r->newest = 0;
+}
+
+/**
+ * Free all memory associated with a LALPSDMultiRegressor object.  The
+ * object must not be used again after calling this function.
+ */
+void XLALPSDMultiRegressorFree(LALPSDMultiRegressor *r)
+{
+  if(r)
+  {
+    XLALDestroyREAL8Vector(r->history);
+    XLALDestroyREAL8VectorSequence(r->mean_square);
+    XLALDestroyREAL8VectorSequence(r->psd);
+  }
+  XLALFree(r);
+}
+
+/**
+ * Return the number of updates over which the running averages of a
+ * LALPSDMultiRegressor object have been computed.  See
+ * XLALPSDRegressorGetNSamples().
+ */
+unsigned XLALPSDMultiRegressorGetNSamples(const LALPSDMultiRegressor *r)
+{
+  return r->n_samples;
+}
+
+/**
+ * Update a LALPSDMultiRegressor object from a block of frequency series.
+ * Vector i of samples holds the non-negative frequency components of
+ * channel i, and samples must have as many vectors, of as many bins, as
+ * the regressor has channels and bins.  The contents of samples are
+ * digested, and this code does not take ownership of it.
+ *
+ * The channels are processed in exactly the same way as by
+ * XLALPSDRegressorAdd(), and the PSD estimates returned by
+ * XLALPSDMultiRegressorGetPSDs() are updated.
+ */
+int XLALPSDMultiRegressorAdd(LALPSDMultiRegressor *r, const COMPLEX16VectorSequence *samples)
+{
+  /* arbitrary constant to make result comply with LAL definition of PSD */
+  const double lal_normalization_constant = 2 * r->deltaF;
+  const unsigned median_samples = r->median_samples;
+  const size_t n = (size_t) r->psd->length * r->psd->vectorLength;
+  const int first = !r->n_samples;
+  double *bin_history;
+  unsigned history_length;
+  unsigned n_samples;
+  unsigned newest;
+  double median_bias;
+
+  if(!samples)
+    XLAL_ERROR(XLAL_EFAULT);
+  if(samples->length != r->psd->length || samples->vectorLength != r->psd->vectorLength)
+  {
+    XLALPrintError("%s(): input parameter mismatch", __func__);
+    XLAL_ERROR(XLAL_EBADLEN);
+  }
+
+  /* bump the number of samples that have been recorded, and find where in
+   * the history buffers the new sample goes */
+
+  n_samples = first ? 1 : r->n_samples < r->average_samples ? r->n_samples + 1 : r->average_samples;
+  newest = first ? 0 : (r->newest + 1) % median_samples;
+
+  /* create arrays to hold one frequency bin's history in each thread */
+
+  history_length = n_samples < median_samples ? n_samples : median_samples;
+  bin_history = XLALMalloc(AVERAGE_SPECTRUM_MAX_THREADS * history_length * sizeof(*bin_history));
+  if(!bin_history)
+    XLAL_ERROR(XLAL_ENOMEM);
+
+  /* compute the logarithm of the median bias factor */
+
+  median_bias = first ? 0.0 : XLALLogMedianBiasGeometric(history_length);
+
+  /* update the geometric mean square and the PSD of all bins of all
+   * channels, as in XLALPSDRegressorAdd() and XLALPSDRegressorGetPSD() */
+
+#pragma omp parallel for
+  for(size_t i = 0; i < n; i++)
+  {
+    double *history = r->history->data + i * median_samples;
+    double *mean_square = r->mean_square->data + i;
+
+    history[newest] = cabs2(samples->data[i]);
+
+    if(first)
+      *mean_square = log(history[newest]);
+    else
+    {
+      double *thread_bin_history = bin_history + AVERAGE_SPECTRUM_THREAD_NUM * history_length;
+
+      /* retrieve the most recent history for this bin and select the
+       * median */
+
+      for(unsigned j = 0; j < history_length; j++)
+        thread_bin_history[j] = history[(newest + median_samples - j) % median_samples];
+      select_nth_REAL8(thread_bin_history, history_length, history_length / 2);
+
+      *mean_square = psd_regressor_update(*mean_square, log(thread_bin_history[history_length / 2]), n_samples, median_bias);
+    }
+
+    r->psd->data[i] = exp(*mean_square + LAL_GAMMA) * lal_normalization_constant;
+  }
+
+  r->n_samples = n_samples;
+  r->newest = newest;
+
+  XLALFree(bin_history);
+  return 0;
+}
+
+/**
+ * Return the current PSD estimates of a LALPSDMultiRegressor object.
+ * Vector i of the result is the PSD of channel i, normalized as by
+ * XLALPSDRegressorGetPSD().  The result points to the internal storage of
+ * the regressor rather than being a copy:  it must not be modified or
+ * freed, and it is overwritten by the next call to
+ * XLALPSDMultiRegressorAdd().
+ */
+const REAL8VectorSequence *XLALPSDMultiRegressorGetPSDs(const LALPSDMultiRegressor *r)
+{
+  /* initialized yet? */
+
+  if(!r->n_samples) {
+    XLALPrintError("%s: not initialized", __func__);
+    XLAL_ERROR_NULL(XLAL_EDATA);
+  }
+
+  return r->psd;
+}
+
+
 /**
  * Compute the two-point spectral correlation function for a whitened
  * frequency series from the window applied to the original time series.
@@ -186,6 +186,24 @@ tagLALPSDRegressor
 }
 LALPSDRegressor;
 
+/**
+ * A LALPSDRegressor for many channels which are updated together from a
+ * single block of frequency series; see XLALPSDMultiRegressorNew().
+ */
+typedef struct
+tagLALPSDMultiRegressor
+{
+  unsigned average_samples;
+  unsigned median_samples;
+  unsigned n_samples;
+  unsigned newest;			/**< position of the newest sample in the history of each bin */
+  REAL8 deltaF;
+  REAL8Vector *history;			/**< median history, median_samples values for each bin of each channel */
+  REAL8VectorSequence *mean_square;	/**< logarithm of the geometric mean square of each bin of each channel */
+  REAL8VectorSequence *psd;		/**< current PSD estimate of each channel */
+}
+LALPSDMultiRegressor;
+
 /*
  *
  * XLAL Functions
@@ -410,6 +428,40 @@ XLALPSDRegressorSetPSD(
     unsigned weight
 );
 
+LALPSDMultiRegressor *
+XLALPSDMultiRegressorNew(
+    unsigned n_channels,
+    unsigned bins,
+    REAL8 deltaF,
+    unsigned average_samples,
+    unsigned median_samples
+);
+
+void
+XLALPSDMultiRegressorFree(
+    LALPSDMultiRegressor *r
+);
+
+void
+XLALPSDMultiRegressorReset(
+    LALPSDMultiRegressor *r
+);
+
+unsigned XLALPSDMultiRegressorGetNSamples(
+    const LALPSDMultiRegressor *r
+);
+
+int
+XLALPSDMultiRegressorAdd(
+    LALPSDMultiRegressor *r,
+    const COMPLEX16VectorSequence *samples
+);
+
+const REAL8VectorSequence *
+XLALPSDMultiRegressorGetPSDs(
+    const LALPSDMultiRegressor *r
+);
+
 
 /** @} */
 
@@ -124,6 +124,196 @@ void XLALFreeLong(void *p, const char *file UNUSED, int line UNUSED)
     return;
 }
 
+/*
+ * Memory region (arena) routines.
+ *
+ * Each thread keeps its own stack of regions. A region owns a chain of large
+ * blocks, from which allocations are carved by bumping an offset; popping the
+ * region releases its blocks, and therefore every allocation made from it, in
+ * one go. Only XLALRegionMalloc() draws from a region, and region memory is
+ * never passed to XLALFree() or XLALRealloc(), so the ordinary heap routines
+ * need not know about regions at all.
+ */
+
+#if defined(LAL_PTHREAD_LOCK) && !defined(_LAL_THREAD_LOCAL_)
+#define LAL_MEM_REGIONS_DISABLED
+#define REGION_TLS
+#elif defined(LAL_PTHREAD_LOCK)
+#define REGION_TLS _LAL_THREAD_LOCAL_
+#else
+#define REGION_TLS
+#endif
+
+/* round up to a multiple of the region alignment */
+#define REGION_ROUND(n) (((n) + LAL_MEM_REGION_ALIGNMENT - 1) & ~((size_t)(LAL_MEM_REGION_ALIGNMENT - 1)))
+
+typedef struct tagRegionBlock {
+    struct tagRegionBlock *prev;	/* previous (older) block of the region */
+    char *base;				/* aligned start of allocatable memory */
+    size_t size;			/* number of allocatable bytes */
+    size_t used;			/* number of bytes used so far */
+} RegionBlock;
+
+typedef struct tagRegion {
+    RegionBlock *top;			/* most recent block of the region */
+    size_t blockSize;			/* minimum size of new blocks */
+} Region;
+
+static REGION_TLS Region regionStack[LAL_MEM_REGION_MAX_DEPTH];
+static REGION_TLS int regionDepth = 0;
+static REGION_TLS RegionBlock *regionSpare = NULL;	/* released block kept for reuse by nested regions */
+
+/* Add a new block of at least 'n' allocatable bytes to region 'r' */
+static RegionBlock *RegionNewBlock(Region *r, size_t n)
+{
+    size_t size = REGION_ROUND(n > r->blockSize ? n : r->blockSize);
+    RegionBlock *block = regionSpare;
+    if (block != NULL && block->size >= size) {
+        regionSpare = NULL;
+    } else {
+        char *p = malloc(sizeof(RegionBlock) + size + LAL_MEM_REGION_ALIGNMENT);
+        if (!p) {
+            return NULL;
+        }
+        block = (RegionBlock *) p;
+        p += sizeof(RegionBlock);
+        block->base = p + (LAL_MEM_REGION_ALIGNMENT - ((size_t) p) % LAL_MEM_REGION_ALIGNMENT) % LAL_MEM_REGION_ALIGNMENT;
+        block->size = size;
+    }
+    block->used = 0;
+    block->prev = r->top;
+    return r->top = block;
+}
+
+/* Release a block, keeping the largest released block for reuse */
+static void RegionFreeBlock(RegionBlock *block)
+{
+    if (XLALGetDebugLevel() & LALMEMPADBIT) {
+        /* poison released memory to expose use after the region is popped */
+        memset(block->base, 0xDB, block->used);
+    }
+    if (regionSpare == NULL || regionSpare->size < block->size) {
+        free(regionSpare);
+        regionSpare = block;
+    } else {
+        free(block);
+    }
+}
+
+/* Find the region of the calling thread which owns 'p', or return NULL */
+static Region *RegionFind(const void *p)
+{
+    const char *c = (const char *) p;
+    for (int i = regionDepth - 1; i >= 0; --i) {
+        for (const RegionBlock *block = regionStack[i].top; block != NULL; block = block->prev) {
+            if (block->base <= c && c < block->base + block->used) {
+                return &regionStack[i];
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Allocate 'n' bytes from region 'r', or return NULL */
+static void *RegionAlloc(Region *r, size_t n)
+{
+    size_t need = REGION_ROUND(n ? n : 1);
+    RegionBlock *block = r->top;
+    if (block == NULL || block->used + need > block->size) {
+        if ((block = RegionNewBlock(r, need)) == NULL) {
+            return NULL;
+        }
+    }
+    char *p = block->base + block->used;
+    block->used += need;
+    return p;
+}
+
+/**
+ * Push a new memory region onto the stack of regions owned by the calling
+ * thread. Until the matching XLALPopMemoryRegion(), memory obtained from
+ * XLALRegionMalloc() is carved from blocks of at least \c blockSize bytes (or
+ * #LAL_MEM_REGION_BLOCK_SIZE if \c blockSize is zero), and is released all at
+ * once when the region is popped.
+ *
+ * Regions are strictly opt-in: XLALMalloc() and the XLAL factory functions
+ * for vectors, sequences and series always use the heap, so objects which
+ * library code creates or caches while a region is active are unaffected.
+ * Region memory must not be passed to XLALFree() or XLALRealloc(), nor used
+ * after its region is popped. Regions are strictly per-thread.
+ */
+int XLALPushMemoryRegion(size_t blockSize)
+{
+#ifdef LAL_MEM_REGIONS_DISABLED
+    XLAL_ERROR(XLAL_EFAILED, "Memory regions require compiler support for thread-local storage");
+#else
+    XLAL_CHECK(regionDepth < LAL_MEM_REGION_MAX_DEPTH, XLAL_ESIZE, "Memory regions nested deeper than %i", LAL_MEM_REGION_MAX_DEPTH);
+    Region *r = &regionStack[regionDepth++];
+    r->top = NULL;
+    r->blockSize = blockSize > 0 ? blockSize : LAL_MEM_REGION_BLOCK_SIZE;
+    return XLAL_SUCCESS;
+#endif
+}
+
+/**
+ * Pop the innermost memory region of the calling thread, releasing all memory
+ * allocated from it since the matching XLALPushMemoryRegion().
+ */
+int XLALPopMemoryRegion(void)
+{
+    XLAL_CHECK(regionDepth > 0, XLAL_EFAILED, "No memory region to pop");
+    Region *r = &regionStack[--regionDepth];
+    while (r->top != NULL) {
+        RegionBlock *prev = r->top->prev;
+        RegionFreeBlock(r->top);
+        r->top = prev;
+    }
+    if (regionDepth == 0) {
+        free(regionSpare);
+        regionSpare = NULL;
+    }
+    return XLAL_SUCCESS;
+}
+
+/**
+ * Return the number of memory regions currently pushed by the calling thread.
+ */
+int XLALMemoryRegionDepth(void)
+{
+    return regionDepth;
+}
+
+/**
+ * Return true if \c p points to memory allocated from a memory region of the
+ * calling thread. This walks every block of every active region, and is meant
+ * for debugging and tests; the allocation routines never call it.
+ */
+int XLALIsMemoryRegionPointer(const void *p)
+{
+    if (regionDepth == 0 || p == NULL) {
+        return 0;
+    }
+    return RegionFind(p) != NULL;
+}
+
+/**
+ * Allocate \c n bytes, aligned to #LAL_MEM_REGION_ALIGNMENT, from the innermost
+ * memory region of the calling thread. It is an error to call this function
+ * while no region is active.
+ */
+void *XLALRegionMallocLong(size_t n, const char *file, int line)
+{
+    XLAL_CHECK_NULL(regionDepth > 0, XLAL_EFAILED, "No memory region to allocate from (%s:%d)", file, line);
+    void *p = RegionAlloc(&regionStack[regionDepth - 1], n);
+    XLAL_TEST_POINTER_LONG(p, 1, file, line);
+    return p;
+}
+
+void *(XLALRegionMalloc) (size_t n)
+{
+    return XLALRegionMallocLong(n, "unknown", -1);
+}
+
 /*
  * Aligned memory routines.
  */
@@ -69,6 +69,22 @@ void XLALFreeAligned(void *ptr);
 #endif /* LAL_FFTW3_MEMALIGN_ENABLED */
 /** @} */
 
+/** \addtogroup LALMalloc_h */ /** @{ */
+/* memory regions are released wholesale, and so cannot be safely exposed to SWIG */
+#ifndef SWIG    /* exclude from SWIG interface */
+#define LAL_MEM_REGION_ALIGNMENT 0x40
+#define LAL_MEM_REGION_BLOCK_SIZE 0x100000
+#define LAL_MEM_REGION_MAX_DEPTH 32
+int XLALPushMemoryRegion(size_t blockSize);
+int XLALPopMemoryRegion(void);
+int XLALMemoryRegionDepth(void);
+int XLALIsMemoryRegionPointer(const void *p);
+void *XLALRegionMalloc(size_t n);
+void *XLALRegionMallocLong(size_t n, const char *file, int line);
+#define XLALRegionMalloc( n )  XLALRegionMallocLong( n, __FILE__, __LINE__ )
+#endif /* SWIG */
+/** @} */
+
 #ifdef LAL_MEMORY_FUNCTIONS_DISABLED
 
 #ifndef SWIG    /* exclude from SWIG interface */
@@ -42,6 +42,13 @@
 # define _LAL_INLINE_
 #endif
 
+/* macro for thread-local storage class, if supported by the compiler */
+#if __STDC_VERSION__ >= 201112L
+# define _LAL_THREAD_LOCAL_ _Thread_local
+#elif defined __GNUC__
+# define _LAL_THREAD_LOCAL_ __thread
+#endif
+
 /* macros for compiler-specific attributes */
 #if defined(__GNUC__)
 # define _LAL_GCC_PRINTF_FORMAT_(NFMT, NARG) __attribute__ ((format (printf, NFMT, NARG)))
@@ -220,7 +220,27 @@ XLALErrorHandlerType **XLALGetErrorHandlerPtr(void)
     return &xlalErrorHandlerGlobal;
 }
 
-#else /* pthread safe code */
+#elif defined(_LAL_THREAD_LOCAL_)      /* thread-local storage */
+
+/* XLAL error number is a thread-local variable, which needs no allocation */
+static _LAL_THREAD_LOCAL_ int xlalErrnoLocal = 0;
+
+/* XLALGetErrnoPtr returns the address of the variable in this thread */
+int *XLALGetErrnoPtr(void)
+{
+    return &xlalErrnoLocal;
+}
+
+/* XLAL error handler is a thread-local variable, which needs no allocation */
+static _LAL_THREAD_LOCAL_ XLALErrorHandlerType *xlalErrorHandlerLocal = NULL;
+
+/* XLALGetErrorHandlerPtr returns the address of the variable in this thread */
+XLALErrorHandlerType **XLALGetErrorHandlerPtr(void)
+{
+    return &xlalErrorHandlerLocal;
+}
+
+#else /* pthread safe code, without thread-local storage */
 
 /* Note: malloc and free are used here rather than LALMalloc and LALFree...
  * this is so that if a user checks for memory leaks within a thread before
@@ -368,6 +388,73 @@ int XLALClearErrno(void)
 }
 
 
+/*
+ * Record an error raised in a parallel worker thread. Atomic builtins are used
+ * where available; otherwise, in thread-safe builds, a mutex is used.
+ */
+#if !defined(__GNUC__) && defined(LAL_PTHREAD_LOCK)
+#include <pthread.h>
+static pthread_mutex_t xlalCollectMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+int XLALCollectErrno(int *collected, int errnum)
+{
+    if (errnum == XLAL_SUCCESS) {
+        return XLALGetCollectedErrno(collected);
+    }
+
+    /* a failure return code: take the error number from this thread */
+    if (errnum < 0) {
+        errnum = XLALGetBaseErrno();
+        if (errnum == XLAL_SUCCESS) {
+            errnum = XLAL_EFAILED;
+        }
+    }
+
+    /* the error will be raised again by the collecting thread */
+    XLALClearErrno();
+
+    /* keep the first error collected */
+#if defined(__GNUC__)
+    int expected = XLAL_SUCCESS;
+    if (!__atomic_compare_exchange_n(collected, &expected, errnum, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+        return expected;
+    }
+    return errnum;
+#else
+#if defined(LAL_PTHREAD_LOCK)
+    pthread_mutex_lock(&xlalCollectMutex);
+#endif
+    if (*collected == XLAL_SUCCESS) {
+        *collected = errnum;
+    }
+    errnum = *collected;
+#if defined(LAL_PTHREAD_LOCK)
+    pthread_mutex_unlock(&xlalCollectMutex);
+#endif
+    return errnum;
+#endif
+}
+
+
+/* Return the error collected from parallel worker threads, if any. */
+int XLALGetCollectedErrno(const int *collected)
+{
+#if defined(__GNUC__)
+    return __atomic_load_n(collected, __ATOMIC_SEQ_CST);
+#else
+    int errnum;
+#if defined(LAL_PTHREAD_LOCK)
+    pthread_mutex_lock(&xlalCollectMutex);
+#endif
+    errnum = *collected;
+#if defined(LAL_PTHREAD_LOCK)
+    pthread_mutex_unlock(&xlalCollectMutex);
+#endif
+    return errnum;
+#endif
+}
+
+
 /* Set the XLAL error handler to newHandler; return the old handler. */
 XLALErrorHandlerType *XLALSetErrorHandler(XLALErrorHandlerType *
                                           newHandler)
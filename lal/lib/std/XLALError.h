@@ -550,6 +550,35 @@ int XLALGetBaseErrno(void);
 int XLALClearErrno(void);
 
 
+#ifndef SWIG    /* exclude from SWIG interface */
+
+/**
+ * Records an error raised inside a parallel region (e.g. an OpenMP loop),
+ * where XLAL_ERROR() cannot be used to return from the enclosing function.
+ * If \c errnum is a positive XLAL error number it is recorded; if it is a
+ * failure return code such as #XLAL_FAILURE, the error number of the calling
+ * thread is recorded instead. Only the first error collected in \c *collected
+ * is kept, and the error number of the calling thread is cleared. Returns the
+ * collected error number. For example:
+ * \code
+ * int errnum = XLAL_SUCCESS;
+ * #pragma omp parallel for
+ * for (size_t i = 0; i < n; ++i) {
+ *   if (XLALGetCollectedErrno(&errnum) != XLAL_SUCCESS)
+ *     continue;
+ *   XLALCollectErrno(&errnum, WorkerFunction(i));
+ * }
+ * XLAL_CHECK(errnum == XLAL_SUCCESS, errnum);
+ * \endcode
+ */
+int XLALCollectErrno(int *collected, int errnum);
+
+/** Returns the error number collected by XLALCollectErrno(), if any. */
+int XLALGetCollectedErrno(const int *collected);
+
+#endif /* SWIG */
+
+
 #ifndef SWIG    /* exclude from SWIG interface */
 
 
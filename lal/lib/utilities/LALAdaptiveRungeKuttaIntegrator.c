@@ -17,6 +17,9 @@
 *  MA  02110-1301  USA
 */
 
+#include <config.h>
+#include <stdlib.h>
+#include <string.h>
 #include <lal/LALAdaptiveRungeKuttaIntegrator.h>
 
 #define XLAL_BEGINGSL \
@@ -28,87 +31,80 @@
           gsl_set_error_handler( saveGSLErrorHandler_ ); \
         }
 
-LALAdaptiveRungeKuttaIntegrator *XLALAdaptiveRungeKutta4Init(int dim, int (*dydt) (double t, const double y[], double dydt[], void *params),   /* These are XLAL functions! */
-    int (*stop) (double t, const double y[], double dydt[], void *params), double eps_abs, double eps_rel)
-{
-    LALAdaptiveRungeKuttaIntegrator *integrator;
-
-    /* allocate our custom integrator structure */
-    if (!(integrator = (LALAdaptiveRungeKuttaIntegrator *) LALCalloc(1, sizeof(LALAdaptiveRungeKuttaIntegrator)))) {
-        XLAL_ERROR_NULL(XLAL_ENOMEM);
-    }
+/* number of integrators each thread keeps for reuse */
+#define LAL_RK4_THREAD_CACHE_SIZE 4
 
-    /* allocate the GSL ODE components */
-        XLAL_CALLGSL(integrator->step = gsl_odeiv_step_alloc(gsl_odeiv_step_rkf45, dim));
-    //XLAL_CALLGSL(integrator->step = gsl_odeiv_step_alloc(gsl_odeiv_step_rk8pd, dim));
-    XLAL_CALLGSL(integrator->control = gsl_odeiv_control_y_new(eps_abs, eps_rel));
-    XLAL_CALLGSL(integrator->evolve = gsl_odeiv_evolve_alloc(dim));
+/* initial number of steps of each variable the integration buffers hold */
+#define LAL_RK4_INITIAL_BUFFER_LENGTH 1024
 
-    /* allocate the GSL system (functions, etc.) */
-    integrator->sys = (gsl_odeiv_system *) LALCalloc(1, sizeof(gsl_odeiv_system));
+/* largest number of rows (time, variables, and extra outputs) of the integration buffers, for dim variables */
+#define LAL_RK4_MAX_BUFFER_ROWS(dim) ((dim) + 4)
 
-    /* if something failed to be allocated, bail out */
-    if (!(integrator->step) || !(integrator->control) || !(integrator->evolve) || !(integrator->sys)) {
-        XLALAdaptiveRungeKuttaFree(integrator);
-        XLAL_ERROR_NULL(XLAL_ENOMEM);
-    }
+/*
+ * Integrators which belong to the cache of a thread are allocated with malloc
+ * and free rather than LALMalloc and LALFree, like the XLAL error state of a
+ * thread, so that memory leak checks do not report the integrators kept by a
+ * thread between waveform calls.
+ */
 
-    integrator->dydt = dydt;
-    integrator->stop = stop;
+static void AdaptiveRungeKuttaDestroy(LALAdaptiveRungeKuttaIntegrator * integrator);
 
-    integrator->sys->function = dydt;
-    integrator->sys->jacobian = NULL;
-    integrator->sys->dimension = dim;
-    integrator->sys->params = NULL;
+static void *IntegratorCalloc(int threadcached, size_t m, size_t n)
+{
+    return threadcached ? calloc(m, n) : XLALCalloc(m, n);
+}
 
-    integrator->retries = 6;
-    integrator->stopontestonly = 0;
+static void *IntegratorRealloc(int threadcached, void *p, size_t n)
+{
+    return threadcached ? realloc(p, n) : XLALRealloc(p, n);
+}
 
-    return integrator;
+static void IntegratorFree(int threadcached, void *p)
+{
+    if (threadcached)
+        free(p);
+    else
+        XLALFree(p);
 }
 
-LALAdaptiveRungeKuttaIntegrator *XLALAdaptiveRungeKutta4InitEighthOrderInstead(int dim, int (*dydt) (double t, const double y[], double dydt[], void *params),   /* These are XLAL functions! */
-    int (*stop) (double t, const double y[], double dydt[], void *params), double eps_abs, double eps_rel)
+static LALAdaptiveRungeKuttaIntegrator *AdaptiveRungeKuttaCreate(const gsl_odeiv_step_type * T, int dim, int (*dydt) (double t, const double y[], double dydt[], void *params),
+    int (*stop) (double t, const double y[], double dydt[], void *params), double eps_abs, double eps_rel, int threadcached)
 {
     LALAdaptiveRungeKuttaIntegrator *integrator;
 
     /* allocate our custom integrator structure */
-    if (!(integrator = (LALAdaptiveRungeKuttaIntegrator *) LALCalloc(1, sizeof(LALAdaptiveRungeKuttaIntegrator)))) {
+    if (!(integrator = IntegratorCalloc(threadcached, 1, sizeof(LALAdaptiveRungeKuttaIntegrator)))) {
         XLAL_ERROR_NULL(XLAL_ENOMEM);
     }
+    integrator->threadcached = threadcached;
 
     /* allocate the GSL ODE components */
-    XLAL_CALLGSL(integrator->step = gsl_odeiv_step_alloc(gsl_odeiv_step_rk8pd, dim));
+    XLAL_CALLGSL(integrator->step = gsl_odeiv_step_alloc(T, dim));
     XLAL_CALLGSL(integrator->control = gsl_odeiv_control_y_new(eps_abs, eps_rel));
     XLAL_CALLGSL(integrator->evolve = gsl_odeiv_evolve_alloc(dim));
 
-    /* allocate the GSL system (functions, etc.) */
-    integrator->sys = (gsl_odeiv_system *) LALCalloc(1, sizeof(gsl_odeiv_system));
+    /* allocate the GSL system (functions, etc.) and the scratch space of the integration routines */
+    integrator->sys = IntegratorCalloc(threadcached, 1, sizeof(gsl_odeiv_system));
+    integrator->work = IntegratorCalloc(threadcached, 6 * dim, sizeof(REAL8));
 
     /* if something failed to be allocated, bail out */
-    if (!(integrator->step) || !(integrator->control) || !(integrator->evolve) || !(integrator->sys)) {
-        XLALAdaptiveRungeKuttaFree(integrator);
+    if (!(integrator->step) || !(integrator->control) || !(integrator->evolve) || !(integrator->sys) || !(integrator->work)) {
+        AdaptiveRungeKuttaDestroy(integrator);
         XLAL_ERROR_NULL(XLAL_ENOMEM);
     }
 
-    integrator->dydt = dydt;
-    integrator->stop = stop;
-
     integrator->sys->function = dydt;
     integrator->sys->jacobian = NULL;
     integrator->sys->dimension = dim;
-    integrator->sys->params = NULL;
 
-    integrator->retries = 6;
-    integrator->stopontestonly = 0;
+    XLALAdaptiveRungeKuttaReset(integrator, dydt, stop, eps_abs, eps_rel);
 
     return integrator;
 }
 
-void XLALAdaptiveRungeKuttaFree(LALAdaptiveRungeKuttaIntegrator * integrator)
+static void AdaptiveRungeKuttaDestroy(LALAdaptiveRungeKuttaIntegrator * integrator)
 {
-    if (!integrator)
-        return;
+    int threadcached = integrator->threadcached;
 
     if (integrator->evolve)
         XLAL_CALLGSL(gsl_odeiv_evolve_free(integrator->evolve));
@@ -117,70 +113,281 @@ void XLALAdaptiveRungeKuttaFree(LALAdaptiveRungeKuttaIntegrator * integrator)
     if (integrator->step)
         XLAL_CALLGSL(gsl_odeiv_step_free(integrator->step));
 
-    LALFree(integrator->sys);
-    LALFree(integrator);
+    IntegratorFree(threadcached, integrator->buffer);
+    IntegratorFree(threadcached, integrator->work);
+    IntegratorFree(threadcached, integrator->sys);
+    IntegratorFree(threadcached, integrator);
+}
 
-    return;
+LALAdaptiveRungeKuttaIntegrator *XLALAdaptiveRungeKutta4Init(int dim, int (*dydt) (double t, const double y[], double dydt[], void *params),   /* These are XLAL functions! */
+    int (*stop) (double t, const double y[], double dydt[], void *params), double eps_abs, double eps_rel)
+{
+    LALAdaptiveRungeKuttaIntegrator *integrator;
+    integrator = AdaptiveRungeKuttaCreate(gsl_odeiv_step_rkf45, dim, dydt, stop, eps_abs, eps_rel, 0);
+    //integrator = AdaptiveRungeKuttaCreate(gsl_odeiv_step_rk8pd, dim, dydt, stop, eps_abs, eps_rel, 0);
+    if (!integrator)
+        XLAL_ERROR_NULL(XLAL_EFUNC);
+    return integrator;
+}
+
+LALAdaptiveRungeKuttaIntegrator *XLALAdaptiveRungeKutta4InitEighthOrderInstead(int dim, int (*dydt) (double t, const double y[], double dydt[], void *params),   /* These are XLAL functions! */
+    int (*stop) (double t, const double y[], double dydt[], void *params), double eps_abs, double eps_rel)
+{
+    LALAdaptiveRungeKuttaIntegrator *integrator;
+    integrator = AdaptiveRungeKuttaCreate(gsl_odeiv_step_rk8pd, dim, dydt, stop, eps_abs, eps_rel, 0);
+    if (!integrator)
+        XLAL_ERROR_NULL(XLAL_EFUNC);
+    return integrator;
+}
+
+/*
+ * Integrator cache of each thread.  If code must be POSIX thread safe then
+ * the cache is kept in a thread-specific key, which frees it when the thread
+ * exits; otherwise it is a global variable.
+ */
+
+typedef struct tagAdaptiveRungeKuttaThreadCache {
+    LALAdaptiveRungeKuttaIntegrator *integrators[LAL_RK4_THREAD_CACHE_SIZE];
+} AdaptiveRungeKuttaThreadCache;
+
+#ifdef LAL_PTHREAD_LOCK
+
+#include <pthread.h>
+
+static pthread_key_t threadCacheKey;
+static pthread_once_t threadCacheKeyOnce = PTHREAD_ONCE_INIT;
+
+/* routine to free the integrator cache of a thread */
+static void DestroyThreadCache(void *ptr)
+{
+    AdaptiveRungeKuttaThreadCache *cache = ptr;
+    for (int i = 0; i < LAL_RK4_THREAD_CACHE_SIZE; i++)
+        if (cache->integrators[i])
+            AdaptiveRungeKuttaDestroy(cache->integrators[i]);
+    free(cache);
+}
+
+/* routine to create the integrator cache key */
+static void CreateThreadCacheKey(void)
+{
+    pthread_key_create(&threadCacheKey, DestroyThreadCache);
 }
 
-/* Local function to store interpolated step in output array */
-static int storeStateInOutput(REAL8Array ** output, REAL8 t, REAL8 * y, size_t dim, int *outputlen, int count)
+/* return the integrator cache of this thread, or NULL if it cannot be allocated */
+static AdaptiveRungeKuttaThreadCache *GetThreadCache(void)
 {
-    REAL8Array *out = *output;
-    int len = *outputlen;
-    size_t i;
+    AdaptiveRungeKuttaThreadCache *cache;
 
-    if (count > len) {
-        /* Resize array! Have to make a new array, and copy over. */
-        REAL8Array *new = XLALCreateREAL8ArrayL(2, dim + 1, 2 * len);
+    /* create key on the first call only */
+    pthread_once(&threadCacheKeyOnce, CreateThreadCacheKey);
 
-        if (!new) {
-            return XLAL_ENOMEM;
+    cache = pthread_getspecific(threadCacheKey);
+    if (!cache) {       /* haven't allocated cache yet... do it now */
+        cache = calloc(1, sizeof(*cache));
+        if (cache && pthread_setspecific(threadCacheKey, cache)) {
+            free(cache);
+            cache = NULL;
         }
+    }
+    return cache;
+}
 
-        for (i = 0; i < dim + 1; i++) {
-            memcpy(&(new->data[2 * i * len]), &(out->data[i * len]), len * sizeof(REAL8));
+#else /* non-pthread-safe code */
+
+static AdaptiveRungeKuttaThreadCache threadCache;
+
+static AdaptiveRungeKuttaThreadCache *GetThreadCache(void)
+{
+    return &threadCache;
+}
+
+#endif /* LAL_PTHREAD_LOCK */
+
+static LALAdaptiveRungeKuttaIntegrator *AdaptiveRungeKuttaThreadInit(const gsl_odeiv_step_type * T, int dim, int (*dydt) (double t, const double y[], double dydt[], void *params),
+    int (*stop) (double t, const double y[], double dydt[], void *params), double eps_abs, double eps_rel)
+{
+    AdaptiveRungeKuttaThreadCache *cache = GetThreadCache();
+    LALAdaptiveRungeKuttaIntegrator *integrator;
+    int i, spare = -1;
+
+    if (cache) {
+        /* reuse an idle integrator for the same stepper and dimension */
+        for (i = 0; i < LAL_RK4_THREAD_CACHE_SIZE; i++) {
+            integrator = cache->integrators[i];
+            if (!integrator) {
+                if (spare < 0 || cache->integrators[spare])
+                    spare = i;
+            } else if (!integrator->inuse) {
+                if (integrator->step->type == T && integrator->sys->dimension == (size_t) dim) {
+                    XLALAdaptiveRungeKuttaReset(integrator, dydt, stop, eps_abs, eps_rel);
+                    integrator->inuse = 1;
+                    return integrator;
+                }
+                if (spare < 0)
+                    spare = i;
+            }
         }
 
-        XLALDestroyREAL8Array(out);
-        out = new;
-        len *= 2;
+        /* otherwise make a new one in an empty slot, or in place of an idle one */
+        if (spare >= 0) {
+            if (cache->integrators[spare])
+                AdaptiveRungeKuttaDestroy(cache->integrators[spare]);
+            cache->integrators[spare] = integrator = AdaptiveRungeKuttaCreate(T, dim, dydt, stop, eps_abs, eps_rel, 1);
+            if (!integrator)
+                XLAL_ERROR_NULL(XLAL_EFUNC);
+            integrator->inuse = 1;
+            return integrator;
+        }
     }
 
-    /* Store the current step. */
-    out->data[count - 1] = t;
-    for (i = 1; i < dim + 1; i++) {
-        out->data[i * len + count - 1] = y[i - 1];
-    }
+    /* all cached integrators are in use: fall back to an integrator of the caller's own */
+    integrator = AdaptiveRungeKuttaCreate(T, dim, dydt, stop, eps_abs, eps_rel, 0);
+    if (!integrator)
+        XLAL_ERROR_NULL(XLAL_EFUNC);
+    return integrator;
+}
 
-    *output = out;
-    *outputlen = len;
-    return GSL_SUCCESS;
+/**
+ * Return an RKF45 integrator set up like XLALAdaptiveRungeKutta4Init() does,
+ * reusing one of the integrators, and their integration buffers, kept by the
+ * calling thread if possible.  The integrator must be returned with
+ * XLALAdaptiveRungeKuttaFree() as usual, which keeps it for later calls
+ * instead of freeing it.
+ */
+LALAdaptiveRungeKuttaIntegrator *XLALAdaptiveRungeKutta4ThreadInit(int dim, int (*dydt) (double t, const double y[], double dydt[], void *params),
+    int (*stop) (double t, const double y[], double dydt[], void *params), double eps_abs, double eps_rel)
+{
+    LALAdaptiveRungeKuttaIntegrator *integrator;
+    integrator = AdaptiveRungeKuttaThreadInit(gsl_odeiv_step_rkf45, dim, dydt, stop, eps_abs, eps_rel);
+    if (!integrator)
+        XLAL_ERROR_NULL(XLAL_EFUNC);
+    return integrator;
 }
 
-/* Local function to shrink output array to proper size before it's returned */
-static int shrinkOutput(REAL8Array ** output, int *outputlen, int count, size_t dim)
+/**
+ * Eighth-order version of XLALAdaptiveRungeKutta4ThreadInit(), which sets up
+ * integrators like XLALAdaptiveRungeKutta4InitEighthOrderInstead() does.
+ */
+LALAdaptiveRungeKuttaIntegrator *XLALAdaptiveRungeKutta4ThreadInitEighthOrderInstead(int dim, int (*dydt) (double t, const double y[], double dydt[], void *params),
+    int (*stop) (double t, const double y[], double dydt[], void *params), double eps_abs, double eps_rel)
+{
+    LALAdaptiveRungeKuttaIntegrator *integrator;
+    integrator = AdaptiveRungeKuttaThreadInit(gsl_odeiv_step_rk8pd, dim, dydt, stop, eps_abs, eps_rel);
+    if (!integrator)
+        XLAL_ERROR_NULL(XLAL_EFUNC);
+    return integrator;
+}
+
+/**
+ * Set up an integrator for a new system of the same dimension, with
+ * derivative function dydt, stopping test stop and the given tolerances.
+ * The retries, stopontestonly and returncode fields are restored to their
+ * initial values; the integration buffers are kept.
+ */
+int XLALAdaptiveRungeKuttaReset(LALAdaptiveRungeKuttaIntegrator * integrator, int (*dydt) (double t, const double y[], double dydt[], void *params),
+    int (*stop) (double t, const double y[], double dydt[], void *params), double eps_abs, double eps_rel)
 {
-    REAL8Array *out = *output;
-    int len = *outputlen;
+    XLAL_CHECK(integrator, XLAL_EFAULT);
+
+    XLAL_CALLGSL(gsl_odeiv_control_init(integrator->control, eps_abs, eps_rel, 1.0, 0.0));
+    XLAL_CALLGSL(gsl_odeiv_step_reset(integrator->step));
+    XLAL_CALLGSL(gsl_odeiv_evolve_reset(integrator->evolve));
 
-    REAL8Array *new = XLALCreateREAL8ArrayL(2, dim + 1, count);
+    integrator->dydt = dydt;
+    integrator->stop = stop;
+
+    integrator->sys->function = dydt;
+    integrator->sys->params = NULL;
+
+    integrator->retries = 6;
+    integrator->stopontestonly = 0;
+    integrator->returncode = 0;
 
-    if (!new) {
-        return XLAL_ENOMEM;
+    return XLAL_SUCCESS;
+}
+
+/* Local function to make the integration buffer hold at least rows x length elements; its contents are lost */
+static REAL8 *reserveBuffer(LALAdaptiveRungeKuttaIntegrator * integrator, size_t rows, size_t length)
+{
+    if (integrator->buffersize < rows * length) {
+        REAL8 *buffer = IntegratorRealloc(integrator->threadcached, integrator->buffer, rows * length * sizeof(REAL8));
+        if (!buffer)
+            return NULL;
+        integrator->buffer = buffer;
+        integrator->buffersize = rows * length;
     }
+    return integrator->buffer;
+}
 
-    size_t i;
-    for (i = 0; i < dim + 1; i++) {
-        memcpy(&(new->data[i * count]), &(out->data[i * len]), count * sizeof(REAL8));
+/* Local function to double the length of the rows x *length integration buffer, keeping the first count elements of each row */
+static REAL8 *growBuffer(LALAdaptiveRungeKuttaIntegrator * integrator, size_t rows, size_t * length, size_t count)
+{
+    size_t oldlength = *length;
+    size_t newlength = 2 * oldlength;
+    REAL8 *buffer;
+
+    if (integrator->buffersize < rows * newlength) {
+        buffer = IntegratorRealloc(integrator->threadcached, integrator->buffer, rows * newlength * sizeof(REAL8));
+        if (!buffer)
+            return NULL;
+        integrator->buffer = buffer;
+        integrator->buffersize = rows * newlength;
     }
+    buffer = integrator->buffer;
+
+    /* spread the rows out, starting from the last row so none is overwritten before it is moved */
+    for (size_t i = rows; i-- > 1;)
+        memmove(&buffer[i * newlength], &buffer[i * oldlength], count * sizeof(REAL8));
+
+    *length = newlength;
+    return buffer;
+}
+
+/* Local function to copy the first count elements of each row of the rows x length integration buffer into a new array */
+static REAL8Array *copyBuffer(const REAL8 * buffer, size_t rows, size_t length, size_t count)
+{
+    REAL8Array *output = XLALCreateREAL8ArrayL(2, rows, count);
+
+    if (!output)
+        return NULL;
 
-    *output = new;
-    *outputlen = count;
+    for (size_t i = 0; i < rows; i++)
+        memcpy(&output->data[i * count], &buffer[i * length], count * sizeof(REAL8));
 
-    XLALDestroyREAL8Array(out);
+    return output;
+}
 
-    return GSL_SUCCESS;
+/**
+ * Make the integration buffers of an integrator large enough for
+ * integrations of length steps, so that the integration routines do
+ * not need to grow them.
+ */
+int XLALAdaptiveRungeKuttaReserve(LALAdaptiveRungeKuttaIntegrator * integrator, size_t length)
+{
+    XLAL_CHECK(integrator, XLAL_EFAULT);
+    if (!reserveBuffer(integrator, LAL_RK4_MAX_BUFFER_ROWS(integrator->sys->dimension), length))
+        XLAL_ERROR(XLAL_ENOMEM);
+    return XLAL_SUCCESS;
+}
+
+/**
+ * Free an integrator.  Integrators obtained from the cache of a thread with
+ * XLALAdaptiveRungeKutta4ThreadInit() are returned to the cache instead.
+ */
+void XLALAdaptiveRungeKuttaFree(LALAdaptiveRungeKuttaIntegrator * integrator)
+{
+    if (!integrator)
+        return;
+
+    if (integrator->threadcached) {
+        integrator->sys->params = NULL;
+        integrator->inuse = 0;
+        return;
+    }
+
+    AdaptiveRungeKuttaDestroy(integrator);
+
+    return;
 }
 
 /* Copied from GSL rkf45.c */
@@ -229,8 +436,10 @@ int XLALAdaptiveRungeKutta4Hermite(LALAdaptiveRungeKuttaIntegrator * integrator,
     int status;
     size_t dim, retries, i;
     int outputlen = 0, count = 0;
+    size_t bufferlength;
 
     REAL8Array *output = NULL;
+    REAL8 *buffer;
 
     REAL8 t, tintp, h;
 
@@ -262,19 +471,16 @@ int XLALAdaptiveRungeKutta4Hermite(LALAdaptiveRungeKuttaIntegrator * integrator,
     }
     outputlen += 2;
 
-    output = XLALCreateREAL8ArrayL(2, (dim + 1), outputlen);
+    /* collect the output in the integration buffer, (dim+1) x bufferlength */
+    buffer = reserveBuffer(integrator, dim + 1, outputlen);
 
-    if (!output) {
+    if (!buffer) {
         errnum = XLAL_ENOMEM;
         goto bail_out;
     }
+    bufferlength = integrator->buffersize / (dim + 1);
 
-    ytemp = XLALCalloc(dim, sizeof(REAL8));
-
-    if (!ytemp) {
-        errnum = XLAL_ENOMEM;
-        goto bail_out;
-    }
+    ytemp = integrator->work;
 
     /* Setup. */
     integrator->sys->params = params;
@@ -285,9 +491,9 @@ int XLALAdaptiveRungeKutta4Hermite(LALAdaptiveRungeKuttaIntegrator * integrator,
     h = deltat;
 
     /* Copy over first step. */
-    output->data[0] = tinit;
+    buffer[0] = tinit;
     for (i = 1; i <= dim; i++)
-        output->data[i * outputlen] = yinit[i - 1];
+        buffer[i * bufferlength] = yinit[i - 1];
     count = 1;
 
     /* We are starting a fresh integration; clear GSL step and evolve
@@ -350,12 +556,15 @@ int XLALAdaptiveRungeKutta4Hermite(LALAdaptiveRungeKuttaIntegrator * integrator,
                 ytemp[i] = i0 * y0[i] + iend * yinit[i] + hUsed * i1 * k1[i] + hUsed * i6 * k6[i];
             }
 
-            /* Store the interpolated value in the output array. */
+            /* Store the interpolated value in the integration buffer. */
             count++;
-            if ((status = storeStateInOutput(&output, tintp, ytemp, dim, &outputlen, count)) == XLAL_ENOMEM) {
+            if ((size_t) count > bufferlength && !(buffer = growBuffer(integrator, dim + 1, &bufferlength, count - 1))) {
                 errnum = XLAL_ENOMEM;
                 goto bail_out;
             }
+            buffer[count - 1] = tintp;
+            for (i = 1; i <= dim; i++)
+                buffer[i * bufferlength + count - 1] = ytemp[i - 1];
         }
 
         /* Now that we have recorded the last interpolated step that we
@@ -373,9 +582,14 @@ int XLALAdaptiveRungeKutta4Hermite(LALAdaptiveRungeKuttaIntegrator * integrator,
         }
     }
 
-    /* Now that the interpolation is done, shrink the output array down
-     * to exactly count samples. */
-    shrinkOutput(&output, &outputlen, count, dim);
+    /* Now that the interpolation is done, copy exactly count samples
+     * into the output array. */
+    output = copyBuffer(buffer, dim + 1, bufferlength, count);
+    if (!output) {
+        errnum = XLAL_ENOMEM;
+        goto bail_out;
+    }
+    outputlen = count;
 
     /* Store the final *interpolated* sample in yinit. */
     for (i = 0; i < dim; i++) {
@@ -388,8 +602,6 @@ int XLALAdaptiveRungeKutta4Hermite(LALAdaptiveRungeKuttaIntegrator * integrator,
 
     /* If we have an error, then we should free allocated memory, and
      * then return. */
-    XLALFree(ytemp);
-
     if (errnum) {
         if (output)
             XLALDestroyREAL8Array(output);
@@ -464,12 +676,8 @@ int XLALAdaptiveRungeKutta4HermiteOnlyFinal(LALAdaptiveRungeKuttaIntegrator * in
         goto bail_out;
     }
 
-    ytemp = XLALCalloc(dim, sizeof(REAL8));
-
-    if (!ytemp) {
-        errnum = XLAL_ENOMEM;
-        goto bail_out;
-    }
+    ytemp = integrator->work;
+    memset(ytemp, 0, dim * sizeof(REAL8));
 
     /* Initialize ytemp[1] with the initial value of yinit[1] so that the initial check below is satisfied even if we are integrating backwards */
     ytemp[1] = yinit[1];
@@ -573,10 +781,7 @@ int XLALAdaptiveRungeKutta4HermiteOnlyFinal(LALAdaptiveRungeKuttaIntegrator * in
 
     XLAL_ENDGSL;
 
-    /* If we have an error, then we should free allocated memory, and
-     * then return. */
-    XLALFree(ytemp);
-
+    /* If we have an error, then return. */
     if (errnum) {
         XLAL_ERROR(errnum);
     }
@@ -595,15 +800,13 @@ int XLALAdaptiveRungeKutta4NoInterpolate(LALAdaptiveRungeKuttaIntegrator * integ
     /* needed for the integration */
     size_t dim, outputlength=0, bufferlength, retries;
     REAL8 t, tnew, h0, h0old;
-    REAL8Array *buffers = NULL;
+    REAL8 *buffers = NULL;
     REAL8 *temp = NULL, *y, *y0, *dydt_in, *dydt_in0, *dydt_out, *yerr; /* aliases */
 
     /* note: for speed, this replaces the single CALLGSL wrapper applied before each GSL call */
     XLAL_BEGINGSL;
 
-    /* allocate the buffers!
-     * note: REAL8Array has a field dimLength (UINT4Vector) with dimensions, and a field data that points to a single memory block;
-     * dimLength itself has fields length and data */
+    /* set up the buffers, which are kept by the integrator between integrations */
     dim = integrator->sys->dimension;
     bufferlength = (int)((tend - tinit) / deltat_or_h0) + 2;   /* allow for the initial value and possibly a final semi-step */
 
@@ -611,14 +814,15 @@ int XLALAdaptiveRungeKutta4NoInterpolate(LALAdaptiveRungeKuttaIntegrator * integ
     if(EOBversion==2) dimn = dim + 1;
     else dimn = dim + 4;//v3opt: Include three derivatives
 
-    buffers = XLALCreateREAL8ArrayL(2, dimn/*dim + 1*/, bufferlength); /* 2-dimensional array, ((dim+1)) x bufferlength */
+    buffers = reserveBuffer(integrator, dimn/*dim + 1*/, bufferlength); /* 2-dimensional array, ((dim+1)) x bufferlength */
 
-    temp = LALCalloc(6 * dim, sizeof(REAL8));
+    temp = integrator->work;
 
-    if (!buffers || !temp) {
+    if (!buffers) {
         errnum = XLAL_ENOMEM;
         goto bail_out;
     }
+    bufferlength = integrator->buffersize / dimn;
 
     y = temp;
     y0 = temp + dim;
@@ -640,9 +844,9 @@ int XLALAdaptiveRungeKutta4NoInterpolate(LALAdaptiveRungeKuttaIntegrator * integ
     memcpy(y, yinit, dim * sizeof(REAL8));
 
     /* store the first data point */
-    buffers->data[0] = t;
+    buffers[0] = t;
     for (unsigned int i = 1; i <= dim; i++)
-        buffers->data[i * bufferlength] = y[i - 1];
+        buffers[i * bufferlength] = y[i - 1];
 
     /* compute derivatives at the initial time (dydt_in), bail out if impossible */
     if ((status = integrator->dydt(t, y, dydt_in, params)) != GSL_SUCCESS) {
@@ -653,7 +857,7 @@ int XLALAdaptiveRungeKutta4NoInterpolate(LALAdaptiveRungeKuttaIntegrator * integ
 
     if(EOBversion==3){
       for (unsigned int i = 1; i <= 3; i++) //OPTV3: include the initial derivatives
-	buffers->data[(dim+i)*bufferlength] = dydt_in[i-1];
+	buffers[(dim+i)*bufferlength] = dydt_in[i-1];
     }
 
     UINT4 loop;/*variable for different loop indices below. */
@@ -732,29 +936,19 @@ int XLALAdaptiveRungeKutta4NoInterpolate(LALAdaptiveRungeKuttaIntegrator * integ
 
         /* check if interpolation buffers need to be extended */
         if (outputlength >= bufferlength) {
-            REAL8Array *rebuffers;
-
-            /* sadly, we cannot use ResizeREAL8Array, because it would only work if we extended the first array dimension,
-             * so we need to copy everything over and switch the buffers. Oh well. */
-            if (!(rebuffers = XLALCreateREAL8ArrayL(2, dimn, 2 * bufferlength))) {
+            if (!(buffers = growBuffer(integrator, dimn, &bufferlength, outputlength))) {
                 errnum = XLAL_ENOMEM;   /* ouch, that hurt */
                 goto bail_out;
-            } else {
-	      for (unsigned int i = 0; i <= loop /* dim */; i++)
-                    memcpy(&rebuffers->data[i * 2 * bufferlength], &buffers->data[i * bufferlength], outputlength * sizeof(REAL8));
-                XLALDestroyREAL8Array(buffers);
-                buffers = rebuffers;
-                bufferlength *= 2;
             }
         }
 
         /* copy time and state into output buffers */
-        buffers->data[outputlength] = t;
+        buffers[outputlength] = t;
         for (unsigned int i = 1; i <= loop; i++)
-            buffers->data[i * bufferlength + outputlength] = y[i - 1];   /* y does not have time */
+            buffers[i * bufferlength + outputlength] = y[i - 1];   /* y does not have time */
         if(EOBversion==3){
 	  for (unsigned int i = 1; i <= 3; i++)
-            buffers->data[(dim+i) * bufferlength + outputlength] = dydt_out[i - 1];  //OPTV3: Include 3 derivatives
+            buffers[(dim+i) * bufferlength + outputlength] = dydt_out[i - 1];  //OPTV3: Include 3 derivatives
 	}
     }
 
@@ -782,9 +976,9 @@ int XLALAdaptiveRungeKutta4NoInterpolate(LALAdaptiveRungeKuttaIntegrator * integ
     }
 
     for(UINT8 j=0;j<outputlength;j++) {
-      (*t_and_y_out)->data[j] = buffers->data[j];
+      (*t_and_y_out)->data[j] = buffers[j];
       for(UINT8 i=1;i<=loop;i++) {
-        (*t_and_y_out)->data[i*outputlength + j] = buffers->data[i*bufferlength + j];
+        (*t_and_y_out)->data[i*outputlength + j] = buffers[i*bufferlength + j];
       }
     }
     /* deallocate stuff and return */
@@ -792,11 +986,6 @@ int XLALAdaptiveRungeKutta4NoInterpolate(LALAdaptiveRungeKuttaIntegrator * integ
 
     XLAL_ENDGSL;
 
-    if (buffers)
-        XLALDestroyREAL8Array(buffers); /* let's be careful, although all these checks may not be needed */
-    if (temp)
-        LALFree(temp);
-
     if (errnum)
         XLAL_ERROR(errnum);
 
@@ -837,9 +1026,9 @@ int XLALAdaptiveRungeKuttaDenseandSparseOutput(LALAdaptiveRungeKuttaIntegrator *
 
     sparse_buffers = XLALCreateREAL8ArrayL(2, dimn, sparse_bufferlength);
     dense_buffers = XLALCreateREAL8ArrayL(2, dimn, dense_bufferlength);
-    temp = LALCalloc(6 * dim, sizeof(REAL8));
+    temp = integrator->work;
 
-    if (!sparse_buffers || !dense_buffers || !temp) {
+    if (!sparse_buffers || !dense_buffers) {
         errnum = XLAL_ENOMEM;
         goto bail_out;
     }
@@ -1063,8 +1252,6 @@ int XLALAdaptiveRungeKuttaDenseandSparseOutput(LALAdaptiveRungeKuttaIntegrator *
       XLALDestroyREAL8Array(sparse_buffers);
     if (dense_buffers)
       XLALDestroyREAL8Array(dense_buffers);
-    if (temp)
-      LALFree(temp);
     if (errnum)
       XLAL_ERROR(errnum);
 
@@ -1080,7 +1267,7 @@ int XLALAdaptiveRungeKutta4(LALAdaptiveRungeKuttaIntegrator * integrator,
     /* needed for the integration */
     size_t dim, bufferlength, cnt, retries;
     REAL8 t, tnew, h0;
-    REAL8Array *buffers = NULL;
+    REAL8 *buffers = NULL;
     REAL8 *temp = NULL, *y, *y0, *dydt_in, *dydt_in0, *dydt_out, *yerr; /* aliases */
 
     /* needed for the final interpolation */
@@ -1093,18 +1280,17 @@ int XLALAdaptiveRungeKutta4(LALAdaptiveRungeKuttaIntegrator * integrator,
     /* note: for speed, this replaces the single CALLGSL wrapper applied before each GSL call */
     XLAL_BEGINGSL;
 
-    /* allocate the buffers!
-     * note: REAL8Array has a field dimLength (UINT4Vector) with dimensions, and a field data that points to a single memory block;
-     * dimLength itself has fields length and data */
+    /* set up the buffers, which are kept by the integrator between integrations */
     dim = integrator->sys->dimension;
     bufferlength = (int)((tend - tinit) / deltat) + 2;  /* allow for the initial value and possibly a final semi-step */
-    buffers = XLALCreateREAL8ArrayL(2, dim + 1, bufferlength);  /* 2-dimensional array, (dim+1) x bufferlength */
-    temp = LALCalloc(6 * dim, sizeof(REAL8));
+    buffers = reserveBuffer(integrator, dim + 1, bufferlength);  /* 2-dimensional array, (dim+1) x bufferlength */
+    temp = integrator->work;
 
-    if (!buffers || !temp) {
+    if (!buffers) {
         errnum = XLAL_ENOMEM;
         goto bail_out;
     }
+    bufferlength = integrator->buffersize / (dim + 1);
 
     y = temp;
     y0 = temp + dim;
@@ -1126,9 +1312,9 @@ int XLALAdaptiveRungeKutta4(LALAdaptiveRungeKuttaIntegrator * integrator,
     memcpy(y, yinit, dim * sizeof(REAL8));
 
     /* store the first data point */
-    buffers->data[0] = t;
+    buffers[0] = t;
     for (unsigned int i = 1; i <= dim; i++)
-        buffers->data[i * bufferlength] = y[i - 1];
+        buffers[i * bufferlength] = y[i - 1];
 
     /* compute derivatives at the initial time (dydt_in), bail out if impossible */
     if ((status = integrator->dydt(t, y, dydt_in, params)) != GSL_SUCCESS) {
@@ -1200,26 +1386,16 @@ int XLALAdaptiveRungeKutta4(LALAdaptiveRungeKuttaIntegrator * integrator,
 
         /* check if interpolation buffers need to be extended */
         if (cnt >= bufferlength) {
-            REAL8Array *rebuffers;
-
-            /* sadly, we cannot use ResizeREAL8Array, because it would only work if we extended the first array dimension,
-             * so we need to copy everything over and switch the buffers. Oh well. */
-            if (!(rebuffers = XLALCreateREAL8ArrayL(2, dim + 1, 2 * bufferlength))) {
+            if (!(buffers = growBuffer(integrator, dim + 1, &bufferlength, cnt))) {
                 errnum = XLAL_ENOMEM;   /* ouch, that hurt */
                 goto bail_out;
-            } else {
-                for (unsigned int i = 0; i <= dim; i++)
-                    memcpy(&rebuffers->data[i * 2 * bufferlength], &buffers->data[i * bufferlength], cnt * sizeof(REAL8));
-                XLALDestroyREAL8Array(buffers);
-                buffers = rebuffers;
-                bufferlength *= 2;
             }
         }
 
         /* copy time and state into interpolation buffers */
-        buffers->data[cnt] = t;
+        buffers[cnt] = t;
         for (unsigned int i = 1; i <= dim; i++)
-            buffers->data[i * bufferlength + cnt] = y[i - 1];   /* y does not have time */
+            buffers[i * bufferlength + cnt] = y[i - 1];   /* y does not have time */
     }
 
     /* copy the final state into yinit */
@@ -1251,7 +1427,7 @@ int XLALAdaptiveRungeKutta4(LALAdaptiveRungeKuttaIntegrator * integrator,
 
     /* interpolate! */
     for (unsigned int i = 1; i <= dim; i++) {
-        gsl_spline_init(interp, &buffers->data[0], &buffers->data[bufferlength * i], cnt + 1);
+        gsl_spline_init(interp, &buffers[0], &buffers[bufferlength * i], cnt + 1);
 
         vector = output->data + outputlen * i;
         for (int j = 0; j < outputlen; j++) {
@@ -1264,11 +1440,6 @@ int XLALAdaptiveRungeKutta4(LALAdaptiveRungeKuttaIntegrator * integrator,
 
     XLAL_ENDGSL;
 
-    if (buffers)
-        XLALDestroyREAL8Array(buffers); /* let's be careful, although all these checks may not be needed */
-    if (temp)
-        LALFree(temp);
-
     if (interp)
         XLAL_CALLGSL(gsl_spline_free(interp));
     if (accel)
@@ -1304,21 +1475,17 @@ int XLALAdaptiveRungeKutta4IrregularIntervals(LALAdaptiveRungeKuttaIntegrator *
     REAL8Array ** yout                                                  /**< array holding the unevenly sampled output */
     )
 {
-    UINT4 MaxRK4Steps = 1000000;
     int errnum = 0;
     int status; /* used throughout */
     unsigned int i;
 
-    // if we integrate forward in time, we start at i=0, and if we integrate backwards, we start at i=MaxRK4Steps-1
-    unsigned int iStart, iCurrent;
-    int di;
-
     REAL8 tend = tend_in;
+    int backwards = (tend <= tinit);
 
     /* needed for the integration */
     size_t dim, bufferlength, cnt, retries;
     REAL8 t, tnew, h0;
-    REAL8Array *buffers = NULL;
+    REAL8 *buffers = NULL;
     REAL8 *temp = NULL, *y, *y0, *dydt_in, *dydt_in0, *dydt_out, *yerr; /* aliases */
 
     int outputlen = 0;
@@ -1327,18 +1494,18 @@ int XLALAdaptiveRungeKutta4IrregularIntervals(LALAdaptiveRungeKuttaIntegrator *
     /* note: for speed, this replaces the single CALLGSL wrapper applied before each GSL call */
     XLAL_BEGINGSL;
 
-    /* allocate the buffers!
-     * note: REAL8Array has a field dimLength (UINT4Vector) with dimensions, and a field data that points to a single memory block;
-     * dimLength itself has fields length and data */
+    /* set up the buffers, which are kept by the integrator between integrations;
+     * samples are always stored in the order they are computed, and reversed
+     * on output if we integrate backwards in time */
     dim = integrator->sys->dimension;
-    bufferlength = MaxRK4Steps;
-    buffers = XLALCreateREAL8ArrayL(2, dim + 2, bufferlength);  /* 2-dimensional array, (dim+2) x bufferlength */
-    temp = LALCalloc(6 * dim, sizeof(REAL8));
+    buffers = reserveBuffer(integrator, dim + 2, LAL_RK4_INITIAL_BUFFER_LENGTH);  /* 2-dimensional array, (dim+2) x bufferlength */
+    temp = integrator->work;
 
-    if (!buffers || !temp) {
+    if (!buffers) {
         errnum = XLAL_ENOMEM;
         goto bail_out;
     }
+    bufferlength = integrator->buffersize / (dim + 2);
 
     y = temp;
     y0 = temp + dim;
@@ -1356,28 +1523,17 @@ int XLALAdaptiveRungeKutta4IrregularIntervals(LALAdaptiveRungeKuttaIntegrator *
     retries = integrator->retries;
 
     t = tinit;
-    if (tend > tinit) {
-        h0 = 1.;
-    } else {
+    if (backwards) {
         h0 = -1.;
-    }
-    memcpy(y, yinit, dim * sizeof(REAL8));
-
-    // current index starts at iStart, and increases in steps of di. We've reached the memory limit if cnt == bufferlength.
-    if (h0 > 0.) {
-        iStart = 0;
-        di = 1;
     } else {
-        iStart = MaxRK4Steps - 1;
-        di = -1;
+        h0 = 1.;
     }
-
-    iCurrent = iStart;
+    memcpy(y, yinit, dim * sizeof(REAL8));
 
     /* store the first data point */
-    buffers->data[iCurrent] = t;
+    buffers[0] = t;
     for (i = 1; i <= dim; i++)
-        buffers->data[i * bufferlength + iCurrent] = y[i - 1];
+        buffers[i * bufferlength] = y[i - 1];
 
     /* compute derivatives at the initial time (dydt_in), bail out if impossible */
     if ((status = integrator->dydt(t, y, dydt_in, params)) != GSL_SUCCESS) {
@@ -1386,7 +1542,7 @@ int XLALAdaptiveRungeKutta4IrregularIntervals(LALAdaptiveRungeKuttaIntegrator *
         goto bail_out;
     }
 
-    buffers->data[i * bufferlength + iCurrent] = dydt_in[1];    /* add domega/dt. here i=dim+1 */
+    buffers[i * bufferlength] = dydt_in[1];    /* add domega/dt. here i=dim+1 */
 
     while (1) {
 
@@ -1447,35 +1603,21 @@ int XLALAdaptiveRungeKutta4IrregularIntervals(LALAdaptiveRungeKuttaIntegrator *
         t = tnew;
         memcpy(dydt_in, dydt_out, dim * sizeof(REAL8));
         cnt++;
-        iCurrent += di;
 
         /* check if interpolation buffers need to be extended */
         if (cnt >= bufferlength) {
-            REAL8Array *rebuffers;
-
-            /* sadly, we cannot use ResizeREAL8Array, because it would only work if we extended the first array dimension,
-             * so we need to copy everything over and switch the buffers. Oh well. */
-            if (!(rebuffers = XLALCreateREAL8ArrayL(2, dim + 1, 2 * bufferlength))) {
+            if (!(buffers = growBuffer(integrator, dim + 2, &bufferlength, cnt))) {
                 errnum = XLAL_ENOMEM;   /* ouch, that hurt */
                 goto bail_out;
-            } else {
-                for (i = 0; i <= dim; i++)
-                    memcpy(&rebuffers->data[i * 2 * bufferlength], &buffers->data[i * bufferlength], cnt * sizeof(REAL8));
-                XLALDestroyREAL8Array(buffers);
-                buffers = rebuffers;
-                bufferlength *= 2;
-                if (di < 0) {
-                    iCurrent += bufferlength;
-                }
             }
         }
 
         /* copy time and state into interpolation buffers */
-        buffers->data[iCurrent] = t;
+        buffers[cnt] = t;
         for (i = 1; i <= dim; i++)
-            buffers->data[i * bufferlength + iCurrent] = y[i - 1];      /* y does not have time */
+            buffers[i * bufferlength + cnt] = y[i - 1];      /* y does not have time */
 
-        buffers->data[i * bufferlength + iCurrent] = dydt_in[1];        /* add domega/dt. here i=dim+1 */
+        buffers[i * bufferlength + cnt] = dydt_in[1];        /* add domega/dt. here i=dim+1 */
     }
 
     /* copy the final state into yinit */
@@ -1489,23 +1631,20 @@ int XLALAdaptiveRungeKutta4IrregularIntervals(LALAdaptiveRungeKuttaIntegrator *
     outputlen = cnt + 1;
     output = XLALCreateREAL8ArrayL(2, dim + 2, outputlen);
 
-    // depending on the direction of integration, we copy starting from 0 or from the current index
-    if (di > 0) {
-        iStart = 0;
-    } else {
-        iStart = iCurrent;
-    }
-
     if (!output) {
         errnum = XLAL_ENOMEM;   /* ouch again, ran out of memory */
-        if (output)
-            XLALDestroyREAL8Array(output);
         outputlen = 0;
         goto bail_out;
     }
 
-    for (i = 0; i <= dim + 1; i++) {
-        memcpy(&(output->data[i * outputlen]), &(buffers->data[i * bufferlength + iStart]), outputlen * sizeof(REAL8));
+    // output is always in increasing time, so reverse the samples if we integrated backwards
+    if (!backwards) {
+        for (i = 0; i <= dim + 1; i++)
+            memcpy(&(output->data[i * outputlen]), &(buffers[i * bufferlength]), outputlen * sizeof(REAL8));
+    } else {
+        for (i = 0; i <= dim + 1; i++)
+            for (size_t j = 0; j < (size_t) outputlen; j++)
+                output->data[i * outputlen + j] = buffers[i * bufferlength + cnt - j];
     }
 
     /* deallocate stuff and return */
@@ -1513,11 +1652,6 @@ int XLALAdaptiveRungeKutta4IrregularIntervals(LALAdaptiveRungeKuttaIntegrator *
 
     XLAL_ENDGSL;
 
-    if (buffers)
-        XLALDestroyREAL8Array(buffers); /* let's be careful, although all these checks may not be needed */
-    if (temp)
-        LALFree(temp);
-
     if (errnum)
         XLAL_ERROR(errnum);
 
@@ -33,6 +33,15 @@ extern "C" {
  * Prior to evolving a system using <tt>XLALAdaptiveRungeKutta4()</tt>, it is necessary to create an integrator structure using
  * <tt>XLALAdaptiveRungeKuttaIntegratorInit()</tt>. Once you are done with the integrator, free it with <tt>XLALAdaptiveRungeKuttaIntegratorFree()</tt>.
  *
+ * An integrator can be used for any number of integrations of systems of the same dimension, and can be
+ * reconfigured for a new system with <tt>XLALAdaptiveRungeKuttaReset()</tt>. It keeps the buffers in which the
+ * integration routines collect the steps of the integration between integrations, so that repeated integrations
+ * do not reallocate them; <tt>XLALAdaptiveRungeKuttaReserve()</tt> sizes them in advance.
+ *
+ * Code which creates an integrator for every waveform can instead obtain one with
+ * <tt>XLALAdaptiveRungeKutta4ThreadInit()</tt>, which reuses integrators kept by the calling thread, and then
+ * return it with <tt>XLALAdaptiveRungeKuttaFree()</tt> as usual.
+ *
  * ### Algorithm ###
  *
  * TBF.
@@ -63,6 +72,12 @@ typedef struct tagLALAdaptiveRungeKuttaIntegrator
   int stopontestonly;	/* stop only on test, use tend to size buffers only */
 
   int returncode;
+
+  REAL8 *buffer;	/* storage for the steps of an integration, kept between integrations */
+  size_t buffersize;	/* number of REAL8 elements in buffer */
+  REAL8 *work;		/* scratch space for 6 * dim REAL8 elements */
+  int threadcached;	/* integrator belongs to the integrator cache of a thread */
+  int inuse;		/* cached integrator has been handed out by the cache */
 } LALAdaptiveRungeKuttaIntegrator;
 
 LALAdaptiveRungeKuttaIntegrator *XLALAdaptiveRungeKutta4Init( int dim,
@@ -85,6 +100,26 @@ LALAdaptiveRungeKuttaIntegrator *XLALAdaptiveRungeKutta4InitEighthOrderInstead(
                              );
 /* END OPTIMIZED */
 
+LALAdaptiveRungeKuttaIntegrator *XLALAdaptiveRungeKutta4ThreadInit( int dim,
+                             int (* dydt) (double t, const double y[], double dydt[], void * params),
+                             int (* stop) (double t, const double y[], double dydt[], void * params),
+                             double eps_abs, double eps_rel
+                             );
+
+LALAdaptiveRungeKuttaIntegrator *XLALAdaptiveRungeKutta4ThreadInitEighthOrderInstead( int dim,
+                             int (* dydt) (double t, const double y[], double dydt[], void * params),
+                             int (* stop) (double t, const double y[], double dydt[], void * params),
+                             double eps_abs, double eps_rel
+                             );
+
+int XLALAdaptiveRungeKuttaReset( LALAdaptiveRungeKuttaIntegrator *integrator,
+                             int (* dydt) (double t, const double y[], double dydt[], void * params),
+                             int (* stop) (double t, const double y[], double dydt[], void * params),
+                             double eps_abs, double eps_rel
+                             );
+
+int XLALAdaptiveRungeKuttaReserve( LALAdaptiveRungeKuttaIntegrator *integrator, size_t length );
+
 void XLALAdaptiveRungeKuttaFree( LALAdaptiveRungeKuttaIntegrator *integrator );
 
 int XLALAdaptiveRungeKutta4( LALAdaptiveRungeKuttaIntegrator *integrator,
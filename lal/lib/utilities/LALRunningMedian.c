@@ -25,6 +25,10 @@
 #include <lal/AVFactories.h>
 #include <lal/LALRunningMedian.h>
 
+#ifndef _OPENMP
+#define omp ignore
+#endif
+
 /*----------------------------------
   A structure to store values and indices
   of elements in an array
@@ -115,6 +119,293 @@ static int rngmed_qsortindex4(const void *elem1, const void *elem2){
 }
 
 
+/*----------------------------------
+  Double-heap running median: the smaller
+  (blocksize+1)/2 values of the current block
+  are kept in a max-heap and the larger
+  blocksize/2 values in a min-heap, so the
+  median is found at the top of the heaps.
+  Moving the block by one sample replaces the
+  oldest value by the new one and restores
+  the heaps in O(log(blocksize)) operations.
+  -----------------------------------*/
+struct rngmed_heap8 {
+  REAL8 *value;  /* values of the block, indexed by sample number modulo blocksize */
+  UINT4 *heap;   /* block indices: max-heap at [0,nlo), min-heap at [nlo,nlo+nhi) */
+  UINT4 *pos;    /* position of each block index in heap */
+  UINT4 nlo;     /* number of values in the max-heap */
+  UINT4 nhi;     /* number of values in the min-heap */
+};
+
+static void rngmed_heap_swap8(struct rngmed_heap8 *h, UINT4 i, UINT4 j){
+  const UINT4 t = h->heap[i];
+  h->heap[i] = h->heap[j];
+  h->heap[j] = t;
+  h->pos[h->heap[i]] = i;
+  h->pos[h->heap[j]] = j;
+}
+
+/* move element i of the max-heap towards the top or the bottom */
+static void rngmed_heap_lo_update8(struct rngmed_heap8 *h, UINT4 i){
+  const REAL8 *v = h->value;
+  const UINT4 *q = h->heap;
+  while (i > 0 && v[q[(i-1)/2]] < v[q[i]]) {
+    rngmed_heap_swap8(h, i, (i-1)/2);
+    i = (i-1)/2;
+  }
+  for (;;) {
+    UINT4 c = 2*i + 1;
+    if (c >= h->nlo)
+      break;
+    if (c + 1 < h->nlo && v[q[c+1]] > v[q[c]])
+      ++c;
+    if (!(v[q[c]] > v[q[i]]))
+      break;
+    rngmed_heap_swap8(h, i, c);
+    i = c;
+  }
+}
+
+/* move element i of the min-heap towards the top or the bottom */
+static void rngmed_heap_hi_update8(struct rngmed_heap8 *h, UINT4 i){
+  const REAL8 *v = h->value;
+  const UINT4 *q = h->heap + h->nlo;
+  while (i > 0 && v[q[(i-1)/2]] > v[q[i]]) {
+    rngmed_heap_swap8(h, h->nlo + i, h->nlo + (i-1)/2);
+    i = (i-1)/2;
+  }
+  for (;;) {
+    UINT4 c = 2*i + 1;
+    if (c >= h->nhi)
+      break;
+    if (c + 1 < h->nhi && v[q[c+1]] < v[q[c]])
+      ++c;
+    if (!(v[q[c]] < v[q[i]]))
+      break;
+    rngmed_heap_swap8(h, h->nlo + i, h->nlo + c);
+    i = c;
+  }
+}
+
+/* running median of input[0..inlength) over blocks of bsize samples */
+static int rngmed_double_heap8(REAL8 *medians, const REAL8 *input, UINT4 inlength, UINT4 bsize){
+  struct qsnode{
+    REAL8 value;
+    UINT4 index;
+  };
+  struct qsnode *qsnodes;
+  struct rngmed_heap8 h;
+  const BOOLEAN isodd = bsize&1;
+  const UINT4 nmedians = inlength - bsize + 1;
+  UINT4 i, nmedian;
+
+  h.nlo = (bsize + 1) / 2;
+  h.nhi = bsize / 2;
+  h.value = XLALMalloc(bsize * sizeof(*h.value));
+  h.heap = XLALMalloc(bsize * sizeof(*h.heap));
+  h.pos = XLALMalloc(bsize * sizeof(*h.pos));
+  qsnodes = XLALMalloc(bsize * sizeof(*qsnodes));
+  if (!h.value || !h.heap || !h.pos || !qsnodes) {
+    XLALFree(h.value);
+    XLALFree(h.heap);
+    XLALFree(h.pos);
+    XLALFree(qsnodes);
+    XLAL_ERROR(XLAL_ENOMEM);
+  }
+
+  /* sort the first block; in descending order the smaller values form a
+     valid max-heap and in ascending order the larger ones a min-heap */
+  for(i=0;i<bsize;i++) {
+    h.value[i] = qsnodes[i].value = input[i];
+    qsnodes[i].index = i;
+  }
+  qsort(qsnodes, bsize, sizeof(struct qsnode), rngmed_qsortindex8);
+  for(i=0;i<h.nlo;i++)
+    h.heap[i] = qsnodes[h.nlo-1-i].index;
+  for(i=h.nlo;i<bsize;i++)
+    h.heap[i] = qsnodes[i].index;
+  for(i=0;i<bsize;i++)
+    h.pos[h.heap[i]] = i;
+  XLALFree(qsnodes);
+
+  for(nmedian=0; nmedian < nmedians; nmedian++) {
+
+    if (nmedian > 0) {
+      /* replace the oldest value of the block by the new one */
+      const UINT4 oldest = (nmedian - 1) % bsize;
+      h.value[oldest] = input[nmedian + bsize - 1];
+      if (h.pos[oldest] < h.nlo)
+        rngmed_heap_lo_update8(&h, h.pos[oldest]);
+      else
+        rngmed_heap_hi_update8(&h, h.pos[oldest] - h.nlo);
+
+      /* exchange the tops if the new value ended up in the wrong heap */
+      if (h.nhi > 0 && h.value[h.heap[0]] > h.value[h.heap[h.nlo]]) {
+        rngmed_heap_swap8(&h, 0, h.nlo);
+        rngmed_heap_lo_update8(&h, 0);
+        rngmed_heap_hi_update8(&h, 0);
+      }
+    }
+
+    /* find median */
+    if(isodd)
+      medians[nmedian] = h.value[h.heap[0]];
+    else
+      medians[nmedian] = (h.value[h.heap[0]] + h.value[h.heap[h.nlo]]) / 2.0;
+
+  }
+
+  XLALFree(h.value);
+  XLALFree(h.heap);
+  XLALFree(h.pos);
+
+  return XLAL_SUCCESS;
+}
+
+/*----------------------------------
+  Double-heap running median: the smaller
+  (blocksize+1)/2 values of the current block
+  are kept in a max-heap and the larger
+  blocksize/2 values in a min-heap, so the
+  median is found at the top of the heaps.
+  Moving the block by one sample replaces the
+  oldest value by the new one and restores
+  the heaps in O(log(blocksize)) operations.
+  -----------------------------------*/
+struct rngmed_heap4 {
+  REAL4 *value;  /* values of the block, indexed by sample number modulo blocksize */
+  UINT4 *heap;   /* block indices: max-heap at [0,nlo), min-heap at [nlo,nlo+nhi) */
+  UINT4 *pos;    /* position of each block index in heap */
+  UINT4 nlo;     /* number of values in the max-heap */
+  UINT4 nhi;     /* number of values in the min-heap */
+};
+
+static void rngmed_heap_swap4(struct rngmed_heap4 *h, UINT4 i, UINT4 j){
+  const UINT4 t = h->heap[i];
+  h->heap[i] = h->heap[j];
+  h->heap[j] = t;
+  h->pos[h->heap[i]] = i;
+  h->pos[h->heap[j]] = j;
+}
+
+/* move element i of the max-heap towards the top or the bottom */
+static void rngmed_heap_lo_update4(struct rngmed_heap4 *h, UINT4 i){
+  const REAL4 *v = h->value;
+  const UINT4 *q = h->heap;
+  while (i > 0 && v[q[(i-1)/2]] < v[q[i]]) {
+    rngmed_heap_swap4(h, i, (i-1)/2);
+    i = (i-1)/2;
+  }
+  for (;;) {
+    UINT4 c = 2*i + 1;
+    if (c >= h->nlo)
+      break;
+    if (c + 1 < h->nlo && v[q[c+1]] > v[q[c]])
+      ++c;
+    if (!(v[q[c]] > v[q[i]]))
+      break;
+    rngmed_heap_swap4(h, i, c);
+    i = c;
+  }
+}
+
+/* move element i of the min-heap towards the top or the bottom */
+static void rngmed_heap_hi_update4(struct rngmed_heap4 *h, UINT4 i){
+  const REAL4 *v = h->value;
+  const UINT4 *q = h->heap + h->nlo;
+  while (i > 0 && v[q[(i-1)/2]] > v[q[i]]) {
+    rngmed_heap_swap4(h, h->nlo + i, h->nlo + (i-1)/2);
+    i = (i-1)/2;
+  }
+  for (;;) {
+    UINT4 c = 2*i + 1;
+    if (c >= h->nhi)
+      break;
+    if (c + 1 < h->nhi && v[q[c+1]] < v[q[c]])
+      ++c;
+    if (!(v[q[c]] < v[q[i]]))
+      break;
+    rngmed_heap_swap4(h, h->nlo + i, h->nlo + c);
+    i = c;
+  }
+}
+
+/* running median of input[0..inlength) over blocks of bsize samples */
+static int rngmed_double_heap4(REAL4 *medians, const REAL4 *input, UINT4 inlength, UINT4 bsize){
+  struct qsnode{
+    REAL4 value;
+    UINT4 index;
+  };
+  struct qsnode *qsnodes;
+  struct rngmed_heap4 h;
+  const BOOLEAN isodd = bsize&1;
+  const UINT4 nmedians = inlength - bsize + 1;
+  UINT4 i, nmedian;
+
+  h.nlo = (bsize + 1) / 2;
+  h.nhi = bsize / 2;
+  h.value = XLALMalloc(bsize * sizeof(*h.value));
+  h.heap = XLALMalloc(bsize * sizeof(*h.heap));
+  h.pos = XLALMalloc(bsize * sizeof(*h.pos));
+  qsnodes = XLALMalloc(bsize * sizeof(*qsnodes));
+  if (!h.value || !h.heap || !h.pos || !qsnodes) {
+    XLALFree(h.value);
+    XLALFree(h.heap);
+    XLALFree(h.pos);
+    XLALFree(qsnodes);
+    XLAL_ERROR(XLAL_ENOMEM);
+  }
+
+  /* sort the first block; in descending order the smaller values form a
+     valid max-heap and in ascending order the larger ones a min-heap */
+  for(i=0;i<bsize;i++) {
+    h.value[i] = qsnodes[i].value = input[i];
+    qsnodes[i].index = i;
+  }
+  qsort(qsnodes, bsize, sizeof(struct qsnode), rngmed_qsortindex4);
+  for(i=0;i<h.nlo;i++)
+    h.heap[i] = qsnodes[h.nlo-1-i].index;
+  for(i=h.nlo;i<bsize;i++)
+    h.heap[i] = qsnodes[i].index;
+  for(i=0;i<bsize;i++)
+    h.pos[h.heap[i]] = i;
+  XLALFree(qsnodes);
+
+  for(nmedian=0; nmedian < nmedians; nmedian++) {
+
+    if (nmedian > 0) {
+      /* replace the oldest value of the block by the new one */
+      const UINT4 oldest = (nmedian - 1) % bsize;
+      h.value[oldest] = input[nmedian + bsize - 1];
+      if (h.pos[oldest] < h.nlo)
+        rngmed_heap_lo_update4(&h, h.pos[oldest]);
+      else
+        rngmed_heap_hi_update4(&h, h.pos[oldest] - h.nlo);
+
+      /* exchange the tops if the new value ended up in the wrong heap */
+      if (h.nhi > 0 && h.value[h.heap[0]] > h.value[h.heap[h.nlo]]) {
+        rngmed_heap_swap4(&h, 0, h.nlo);
+        rngmed_heap_lo_update4(&h, 0);
+        rngmed_heap_hi_update4(&h, 0);
+      }
+    }
+
+    /* find median */
+    if(isodd)
+      medians[nmedian] = h.value[h.heap[0]];
+    else
+      medians[nmedian] = (h.value[h.heap[0]] + h.value[h.heap[h.nlo]]) / 2.0;
+
+  }
+
+  XLALFree(h.value);
+  XLALFree(h.heap);
+  XLALFree(h.pos);
+
+  return XLAL_SUCCESS;
+}
+
+
 void LALDRunningMedian( LALStatus *status,
 			REAL8Sequence *medians,
 			const REAL8Sequence *input,
@@ -939,44 +1230,6 @@ void LALDRunningMedian2( LALStatus *status,
 			 LALRunningMedianPar param)
 
 {
-  /* a single "node"
-   lesser  points to the next node with less or equal value
-   greater points to the next node with greater or equal value
-   an index == blocksize is an end marker
-  */
-  struct node{
-    REAL8 value;
-    UINT4 lesser;
-    UINT4 greater;
-  };
-
-  /* a node of the quicksort array */
-  struct qsnode{
-    REAL8 value;
-    UINT4 index;
-  };
-
-  const UINT4 bsize = param.blocksize; /* just an abbrevation */
-  const UINT4 nil = bsize;       /* invalid index used as end marker */
-  const BOOLEAN isodd = bsize&1; /* bsize is odd = median is a single element */
-
-  struct node* nodes;           /* array of nodes, will be of size blocksize */
-  struct qsnode* qsnodes;       /* array of indices for initial qsort */
-  UINT4* checkpts;              /* array of checkpoints */
-  UINT4  ncheckpts,stepchkpts;  /* checkpoints: number and distance between */
-  UINT4  oldestnode;            /* index of "oldest" node */
-  UINT4  i;                     /* loop counter (up to input length) */
-  INT4   j;                     /* loop counter (might get negative) */
-  UINT4  nmedian;               /* current median, outer loop counter */
-  UINT4  midpoint;              /* index of middle node in sorting order */
-  UINT4  mdnnearest;            /* checkpoint "nearest" to the median */
-  UINT4  nextnode;              /* node after an insertion point,
-			           also used to find a median */
-  UINT4  prevnode;              /* node before an insertion point */
-  UINT4  rightcheckpt;          /* checkpoint 'right' of an insertion point */
-  REAL8 oldvalue,newvalue;      /* old + new value of the node being replaced */
-  UINT4 oldlesser,oldgreater;   /* remember the pointers of the replaced node */
-
   INITSTATUS(status);
 
   /* check input parameters */
@@ -993,274 +1246,20 @@ void LALDRunningMedian2( LALStatus *status,
   ASSERT(medians->length == (input->length - param.blocksize + 1),
 	 status,LALRUNNINGMEDIANH_EIMED,LALRUNNINGMEDIANH_MSGEIMED);
 
-  ATTATCHSTATUSPTR( status );
-
-  /* create nodes array */
-  nodes = (struct node*)LALCalloc(bsize, sizeof(struct node));
-
-  /* determine checkpoint positions */
-  stepchkpts = sqrt(bsize);
-  /* the old form
-     ncheckpts = bsize/stepchkpts;
-     caused too less checkpoints at the end, leading to break the
-     cost calculation */
-  ncheckpts = ceil((REAL4)bsize/(REAL4)stepchkpts);
-
-  /* set checkpoint nearest to the median and offset of the median to it */
-  midpoint = (bsize+(bsize&1)) / 2 - 1;
-  /* this becomes the median checkpoint */
-  mdnnearest = ceil((REAL4)midpoint / (REAL4)stepchkpts);
-
-  /* add a checkpoint for the median if necessary */
-  if (ceil((REAL4)midpoint / (REAL4)stepchkpts) != (REAL4)midpoint / (REAL4)stepchkpts)
-    ncheckpts++;
-
-  /* create checkpoints array */
-  checkpts = (UINT4*)LALCalloc(ncheckpts,sizeof(UINT4));
-
-  /* create array for qsort */
-  qsnodes = (struct qsnode*)LALCalloc(bsize, sizeof(struct qsnode));
-
-  /* init qsort array
-   the nodes get their values from the input,
-   the indices are only identities qi[0]=0,qi[1]=1,... */
-  for(i=0;i<bsize;i++) {
-    qsnodes[i].value = input->data[i];
-    qsnodes[i].index = i;
-  }
-
-  /* sort qsnodes by value and index(!) */
-  qsort(qsnodes, bsize, sizeof(struct qsnode),rngmed_qsortindex8);
-
-  /* init nodes array */
-  for(i=0;i<bsize;i++)
-    nodes[i].value = input->data[i];
-  for(i=1;i<bsize-1;i++) {
-    nodes[qsnodes[i-1].index].greater = qsnodes[i].index;
-    nodes[qsnodes[i+1].index].lesser  = qsnodes[i].index;
-  }
-  nodes[qsnodes[0].index].lesser      = nil; /* end marker */
-  nodes[qsnodes[1].index].lesser      = qsnodes[0].index;
-  nodes[qsnodes[bsize-2].index].greater = qsnodes[bsize-1].index;
-  nodes[qsnodes[bsize-1].index].greater = nil; /* end marker */
-
-  /* setup checkpoints */
-  /* j is the current checkpoint
-     i is the stepping
-     they are out of sync after a median checkpoint has been added */
-  for(i=0,j=0; (UINT4)j<ncheckpts; i++,j++) {
-    if ((UINT4)j == mdnnearest) {
-      checkpts[j] = qsnodes[midpoint].index;
-      if (i*stepchkpts != midpoint)
-	j++;
-    }
-    checkpts[j] = qsnodes[i*stepchkpts].index;
+  if (rngmed_double_heap8(medians->data, input->data, input->length, param.blocksize) != XLAL_SUCCESS) {
+    XLALClearErrno();
+    ABORT(status,LALRUNNINGMEDIANH_EMALOC6,LALRUNNINGMEDIANH_MSGEMALOC6);
   }
 
-  /* don't need the qsnodes anymore */
-  LALFree(qsnodes);
-
-  /* find first median */
-  nextnode = checkpts[mdnnearest];
-  if(isodd)
-    medians->data[0] = nodes[nextnode].value;
-  else
-    medians->data[0] = (nodes[nextnode].value
-			+ nodes[nodes[nextnode].greater].value) / 2.0;
-
-  /* the "oldest" node (first in sequence) is the one with index 0 */
-  oldestnode = 0;
-
-  /* outer loop: find a median with each iteration */
-  for(nmedian=1; nmedian < medians->length; nmedian++) {
-
-    /* remember value of sample to be deleted */
-    oldvalue = nodes[oldestnode].value;
-
-    /* get next value to be inserted from input */
-    newvalue = input->data[nmedian+bsize-1];
-
-    /** find point of insertion: **/
-
-    /* find checkpoint greater or equal newvalue */
-    /* possible optimisation: use bisectional search instaed of linear */
-    for(rightcheckpt=0; rightcheckpt<ncheckpts; rightcheckpt++)
-      if(newvalue <= nodes[checkpts[rightcheckpt]].value)
-	break;
-
-    /* assume we are inserting at the beginning: */
-    prevnode = nil;
-    if (rightcheckpt == 0)
-      /* yes, we are */
-      nextnode = checkpts[0];
-    else {
-      /* we're beyond the first checkpoint, find the node we're inserting at: */
-      nextnode = checkpts[rightcheckpt-1]; /* this also works if we found no
-					      checkpoint > newvalue, as
-					      then rightcheckpt == ncheckpts */
-      /* the following loop is always ran at least once, as
-	 nodes[checkpts[rightcheckpt-1]].value < newvalue
-         after 'find checkpoint' loop */
-      while((nextnode != nil) && (newvalue > nodes[nextnode].value)) {
-	prevnode = nextnode;
-	nextnode = nodes[nextnode].greater;
-      }
-    }
-    /* ok, we have:
-       - case 1: insert at beginning: prevnode == nil, nextnode == smallest node
-       - case 2: insert at end: nextnode == nil (terminated loop),
-                 prevnode == last node
-       - case 3: ordinary insert: insert between prevnode and nextnode
-    */
-
-    /* insertion deletion and shifting are unnecessary if we are replacing
-       at the same pos */
-    if ((oldestnode != prevnode) && (oldestnode != nextnode)) {
-
-      /* delete oldest node from list */
-      if (nodes[oldestnode].lesser == nil) {
-	/* case 1: at beginning */
-	nodes[nodes[oldestnode].greater].lesser = nil;
-	/* this shouldn't be necessary, but doesn't harm */
-	checkpts[0] = nodes[oldestnode].greater;
-      } else if (nodes[oldestnode].greater == nil)
-	/* case 2: at end */
-	nodes[nodes[oldestnode].lesser].greater = nil;
-      else {
-	/* case 3: anywhere else */
-	nodes[nodes[oldestnode].lesser].greater = nodes[oldestnode].greater;
-	nodes[nodes[oldestnode].greater].lesser = nodes[oldestnode].lesser;
-      }
-      /* remember the old links for special case in shifting below */
-      oldgreater = nodes[oldestnode].greater;
-      oldlesser = nodes[oldestnode].lesser;
-
-
-      /* insert new node - actually we reuse the oldest one */
-      /* the value is set outside the outer "if" */
-      nodes[oldestnode].lesser = prevnode;
-      nodes[oldestnode].greater = nextnode;
-      if (prevnode != nil)
-	nodes[prevnode].greater = oldestnode;
-      if (nextnode != nil)
-	nodes[nextnode].lesser = oldestnode;
-
-
-      /* shift checkpoints */
-
-      /* if there is a sequence of identical values, new values are inserted
-	 always at the left end. Thus, the oldest value has to be the rightmost
-	 of such a sequence. This requires proper init.
-
-	 This makes shifting of the checkpoints rather easy:
-	 if (oldvalue < newvalue), all checkpoints with
-	     oldvalue <(=) chkptvalue < newvalue are shifted,
-	 if (newvalue <= oldvalue), all checkpoints with
-	     newvalue <= chkptvalue <= oldvalue are shifted.
-	 <(=) means that only a checkpoint at the deleted node must be
-	     shifted, no other accidently pointing to the same value.
-
-	 Care is needed if a checkpoint to shift is the node we just deleted
-
-	 We start at the checkpoint we know to be closest to the new node
-	 satifying the above condition:
-	 rightcheckpt-1 if (oldvalue < newvalue)
-	 rightcheckpt othewise
-	 and proceed in the direction towards the deleted node
-      */
-
-      if (oldvalue < newvalue) {
-	/* we shift towards larger values */
-	for(j=rightcheckpt-1; (j>0)&&(nodes[checkpts[j]].value >= oldvalue);j--)
-	  if (nodes[checkpts[j]].value > oldvalue)
-	    checkpts[j] = nodes[checkpts[j]].greater;
-	  else if (checkpts[j] == oldestnode)
-	    checkpts[j] = oldgreater;
-      } else /* newvalue <= oldvalue */
-	/* we shift towards smaller values */
-	for(i=rightcheckpt;
-	    (i<ncheckpts) && (nodes[checkpts[i]].value <= oldvalue); i++)
-	  if (checkpts[i] == oldestnode)
-	    checkpts[i] = oldlesser;
-	  else
-	    checkpts[i] = nodes[checkpts[i]].lesser;
-
-    } /* if ((oldestnode != prevnode) && (oldestnode != nextnode)) */
-
-    /* in any case set new value */
-    nodes[oldestnode].value = newvalue;
-
-
-    /* find median */
-    if (newvalue == oldvalue)
-      medians->data[nmedian] = medians->data[nmedian-1];
-    else {
-      nextnode = checkpts[mdnnearest];
-      if(isodd)
-	medians->data[nmedian] = nodes[nextnode].value;
-      else
-	medians->data[nmedian] = (nodes[nextnode].value
-				  + nodes[nodes[nextnode].greater].value) / 2.0;
-    }
-
-    /* next oldest node */
-    oldestnode = (oldestnode + 1) % bsize; /* wrap around */
-
-  } /* for (nmedian...) */
-
-  /* cleanup */
-  LALFree(checkpts);
-  LALFree(nodes);
-
-  DETATCHSTATUSPTR( status );
   RETURN( status );
 }
 
-
 void LALSRunningMedian2( LALStatus *status,
 			 REAL4Sequence *medians,
 			 const REAL4Sequence *input,
 			 LALRunningMedianPar param)
 
 {
-  /* a single "node"
-   lesser  points to the next node with less or equal value
-   greater points to the next node with greater or equal value
-   an index == blocksize is an end marker
-  */
-  struct node{
-    REAL4 value;
-    UINT4 lesser;
-    UINT4 greater;
-  };
-
-  /* a node of the quicksort array */
-  struct qsnode{
-    REAL4 value;
-    UINT4 index;
-  };
-
-  const UINT4 bsize = param.blocksize; /* just an abbrevation */
-  const UINT4 nil = bsize;       /* invalid index used as end marker */
-  const BOOLEAN isodd = bsize&1; /* bsize is odd = median is a single element */
-
-  struct node* nodes;           /* array of nodes, will be of size blocksize */
-  struct qsnode* qsnodes;       /* array of indices for initial qsort */
-  UINT4* checkpts;              /* array of checkpoints */
-  UINT4  ncheckpts,stepchkpts;  /* checkpoints: number and distance between */
-  UINT4  oldestnode;            /* index of "oldest" node */
-  UINT4  i;                     /* loop counter (up to input length) */
-  INT4   j;                     /* loop counter (might get negative) */
-  UINT4  nmedian;               /* current median, outer loop counter */
-  UINT4  midpoint;              /* index of middle node in sorting order */
-  UINT4  mdnnearest;            /* checkpoint "nearest" to the median */
-  UINT4  nextnode;              /* node after an insertion point,
-			           also used to find a median */
-  UINT4  prevnode;              /* node before an insertion point */
-  UINT4  rightcheckpt;          /* checkpoint 'right' of an insertion point */
-  REAL4 oldvalue,newvalue;      /* old + new value of the node being replaced */
-  UINT4 oldlesser,oldgreater;   /* remember the pointers of the replaced node */
-
   INITSTATUS(status);
 
   /* check input parameters */
@@ -1277,225 +1276,60 @@ void LALSRunningMedian2( LALStatus *status,
   ASSERT(medians->length == (input->length - param.blocksize + 1),
 	 status,LALRUNNINGMEDIANH_EIMED,LALRUNNINGMEDIANH_MSGEIMED);
 
-  ATTATCHSTATUSPTR( status );
-
-  /* create nodes array */
-  nodes = (struct node*)LALCalloc(bsize, sizeof(struct node));
-
-  /* determine checkpoint positions */
-  stepchkpts = sqrt(bsize);
-  /* the old form
-     ncheckpts = bsize/stepchkpts;
-     caused too less checkpoints at the end, leading to break the
-     cost calculation */
-  ncheckpts = ceil((REAL4)bsize/(REAL4)stepchkpts);
-
-  /* set checkpoint nearest to the median and offset of the median to it */
-  midpoint = (bsize+(bsize&1)) / 2 - 1;
-  /* this becomes the median checkpoint */
-  mdnnearest = ceil((REAL4)midpoint / (REAL4)stepchkpts);
-
-  /* add a checkpoint for the median if necessary */
-  if (ceil((REAL4)midpoint / (REAL4)stepchkpts) != (REAL4)midpoint / (REAL4)stepchkpts)
-    ncheckpts++;
-
-  /* create checkpoints array */
-  checkpts = (UINT4*)LALCalloc(ncheckpts,sizeof(UINT4));
-
-  /* create array for qsort */
-  qsnodes = (struct qsnode*)LALCalloc(bsize, sizeof(struct qsnode));
-
-  /* init qsort array
-   the nodes get their values from the input,
-   the indices are only identities qi[0]=0,qi[1]=1,... */
-  for(i=0;i<bsize;i++) {
-    qsnodes[i].value = input->data[i];
-    qsnodes[i].index = i;
+  if (rngmed_double_heap4(medians->data, input->data, input->length, param.blocksize) != XLAL_SUCCESS) {
+    XLALClearErrno();
+    ABORT(status,LALRUNNINGMEDIANH_EMALOC6,LALRUNNINGMEDIANH_MSGEMALOC6);
   }
 
-  /* sort qsnodes by value and index(!) */
-  qsort(qsnodes, bsize, sizeof(struct qsnode),rngmed_qsortindex4);
+  RETURN( status );
+}
 
-  /* init nodes array */
-  for(i=0;i<bsize;i++)
-    nodes[i].value = input->data[i];
-  for(i=1;i<bsize-1;i++) {
-    nodes[qsnodes[i-1].index].greater = qsnodes[i].index;
-    nodes[qsnodes[i+1].index].lesser  = qsnodes[i].index;
-  }
-  nodes[qsnodes[0].index].lesser      = nil; /* end marker */
-  nodes[qsnodes[1].index].lesser      = qsnodes[0].index;
-  nodes[qsnodes[bsize-2].index].greater = qsnodes[bsize-1].index;
-  nodes[qsnodes[bsize-1].index].greater = nil; /* end marker */
-
-  /* setup checkpoints */
-  /* j is the current checkpoint
-     i is the stepping
-     they are out of sync after a median checkpoint has been added */
-  for(i=0,j=0; (UINT4)j<ncheckpts; i++,j++) {
-    if ((UINT4)j == mdnnearest) {
-      checkpts[j] = qsnodes[midpoint].index;
-      if (i*stepchkpts != midpoint)
-	j++;
-    }
-    checkpts[j] = qsnodes[i*stepchkpts].index;
+int XLALDRunningMedianVectorSequence( REAL8VectorSequence *medians,
+				      const REAL8VectorSequence *input,
+				      UINT4 blocksize )
+{
+  int errnum = XLAL_SUCCESS;
+
+  XLAL_CHECK(medians != NULL && input != NULL, XLAL_EFAULT);
+  XLAL_CHECK(blocksize > 0, XLAL_EINVAL, "Block length must be >0");
+  XLAL_CHECK(blocksize <= input->vectorLength, XLAL_EBADLEN, "Block length %u larger than input length %u", blocksize, input->vectorLength);
+  XLAL_CHECK(medians->length == input->length && medians->vectorLength == input->vectorLength - blocksize + 1, XLAL_EBADLEN, "Wrong size of median array");
+
+  /* the rows are independent, so compute their running medians in parallel */
+#pragma omp parallel for
+  for (UINT4 i = 0; i < input->length; i++) {
+    if (XLALGetCollectedErrno(&errnum) != XLAL_SUCCESS)
+      continue;
+    XLALCollectErrno(&errnum, rngmed_double_heap8(medians->data + i * medians->vectorLength,
+						   input->data + i * input->vectorLength,
+						   input->vectorLength, blocksize));
   }
+  XLAL_CHECK(errnum == XLAL_SUCCESS, errnum);
 
-  /* don't need the qsnodes anymore */
-  LALFree(qsnodes);
-
-  /* find first median */
-  nextnode = checkpts[mdnnearest];
-  if(isodd)
-    medians->data[0] = nodes[nextnode].value;
-  else
-    medians->data[0] = (nodes[nextnode].value
-			+ nodes[nodes[nextnode].greater].value) / 2.0;
-
-  /* the "oldest" node (first in sequence) is the one with index 0 */
-  oldestnode = 0;
-
-  /* outer loop: find a median with each iteration */
-  for(nmedian=1; nmedian < medians->length; nmedian++) {
-
-    /* remember value of sample to be deleted */
-    oldvalue = nodes[oldestnode].value;
-
-    /* get next value to be inserted from input */
-    newvalue = input->data[nmedian+bsize-1];
-
-    /** find point of insertion: **/
-
-    /* find checkpoint greater or equal newvalue */
-    /* possible optimisation: use bisectional search instaed of linear */
-    for(rightcheckpt=0; rightcheckpt<ncheckpts; rightcheckpt++)
-      if(newvalue <= nodes[checkpts[rightcheckpt]].value)
-	break;
-
-    /* assume we are inserting at the beginning: */
-    prevnode = nil;
-    if (rightcheckpt == 0)
-      /* yes, we are */
-      nextnode = checkpts[0];
-    else {
-      /* we're beyond the first checkpoint, find the node we're inserting at: */
-      nextnode = checkpts[rightcheckpt-1]; /* this also works if we found no
-					      checkpoint > newvalue, as
-					      then rightcheckpt == ncheckpts */
-      /* the following loop is always ran at least once, as
-	 nodes[checkpts[rightcheckpt-1]].value < newvalue
-         after 'find checkpoint' loop */
-      while((nextnode != nil) && (newvalue > nodes[nextnode].value)) {
-	prevnode = nextnode;
-	nextnode = nodes[nextnode].greater;
-      }
-    }
-    /* ok, we have:
-       - case 1: insert at beginning: prevnode == nil, nextnode == smallest node
-       - case 2: insert at end: nextnode == nil (terminated loop),
-                 prevnode == last node
-       - case 3: ordinary insert: insert between prevnode and nextnode
-    */
-
-    /* insertion deletion and shifting are unnecessary if we are replacing
-       at the same pos */
-    if ((oldestnode != prevnode) && (oldestnode != nextnode)) {
-
-      /* delete oldest node from list */
-      if (nodes[oldestnode].lesser == nil) {
-	/* case 1: at beginning */
-	nodes[nodes[oldestnode].greater].lesser = nil;
-	/* this shouldn't be necessary, but doesn't harm */
-	checkpts[0] = nodes[oldestnode].greater;
-      } else if (nodes[oldestnode].greater == nil)
-	/* case 2: at end */
-	nodes[nodes[oldestnode].lesser].greater = nil;
-      else {
-	/* case 3: anywhere else */
-	nodes[nodes[oldestnode].lesser].greater = nodes[oldestnode].greater;
-	nodes[nodes[oldestnode].greater].lesser = nodes[oldestnode].lesser;
-      }
-      /* remember the old links for special case in shifting below */
-      oldgreater = nodes[oldestnode].greater;
-      oldlesser = nodes[oldestnode].lesser;
-
-
-      /* insert new node - actually we reuse the oldest one */
-      /* the value is set outside the outer "if" */
-      nodes[oldestnode].lesser = prevnode;
-      nodes[oldestnode].greater = nextnode;
-      if (prevnode != nil)
-	nodes[prevnode].greater = oldestnode;
-      if (nextnode != nil)
-	nodes[nextnode].lesser = oldestnode;
-
-
-      /* shift checkpoints */
-
-      /* if there is a sequence of identical values, new values are inserted
-	 always at the left end. Thus, the oldest value has to be the rightmost
-	 of such a sequence. This requires proper init.
-
-	 This makes shifting of the checkpoints rather easy:
-	 if (oldvalue < newvalue), all checkpoints with
-	     oldvalue <(=) chkptvalue < newvalue are shifted,
-	 if (newvalue <= oldvalue), all checkpoints with
-	     newvalue <= chkptvalue <= oldvalue are shifted.
-	 <(=) means that only a checkpoint at the deleted node must be
-	     shifted, no other accidently pointing to the same value.
-
-	 Care is needed if a checkpoint to shift is the node we just deleted
-
-	 We start at the checkpoint we know to be closest to the new node
-	 satifying the above condition:
-	 rightcheckpt-1 if (oldvalue < newvalue)
-	 rightcheckpt othewise
-	 and proceed in the direction towards the deleted node
-      */
-
-      if (oldvalue < newvalue) {
-	/* we shift towards larger values */
-	for(j=rightcheckpt-1; (j>0)&&(nodes[checkpts[j]].value >= oldvalue);j--)
-	  if (nodes[checkpts[j]].value > oldvalue)
-	    checkpts[j] = nodes[checkpts[j]].greater;
-	  else if (checkpts[j] == oldestnode)
-	    checkpts[j] = oldgreater;
-      } else /* newvalue <= oldvalue */
-	/* we shift towards smaller values */
-	for(i=rightcheckpt;
-	    (i<ncheckpts) && (nodes[checkpts[i]].value <= oldvalue); i++)
-	  if (checkpts[i] == oldestnode)
-	    checkpts[i] = oldlesser;
-	  else
-	    checkpts[i] = nodes[checkpts[i]].lesser;
-
-    } /* if ((oldestnode != prevnode) && (oldestnode != nextnode)) */
-
-    /* in any case set new value */
-    nodes[oldestnode].value = newvalue;
-
-
-    /* find median */
-    if (newvalue == oldvalue)
-      medians->data[nmedian] = medians->data[nmedian-1];
-    else {
-      nextnode = checkpts[mdnnearest];
-      if(isodd)
-	medians->data[nmedian] = nodes[nextnode].value;
-      else
-	medians->data[nmedian] = (nodes[nextnode].value
-				  + nodes[nodes[nextnode].greater].value) / 2.0;
-    }
-
-    /* next oldest node */
-    oldestnode = (oldestnode + 1) % bsize; /* wrap around */
-
-  } /* for (nmedian...) */
+  return XLAL_SUCCESS;
+}
 
-  /* cleanup */
-  LALFree(checkpts);
-  LALFree(nodes);
+int XLALSRunningMedianVectorSequence( REAL4VectorSequence *medians,
+				      const REAL4VectorSequence *input,
+				      UINT4 blocksize )
+{
+  int errnum = XLAL_SUCCESS;
+
+  XLAL_CHECK(medians != NULL && input != NULL, XLAL_EFAULT);
+  XLAL_CHECK(blocksize > 0, XLAL_EINVAL, "Block length must be >0");
+  XLAL_CHECK(blocksize <= input->vectorLength, XLAL_EBADLEN, "Block length %u larger than input length %u", blocksize, input->vectorLength);
+  XLAL_CHECK(medians->length == input->length && medians->vectorLength == input->vectorLength - blocksize + 1, XLAL_EBADLEN, "Wrong size of median array");
+
+  /* the rows are independent, so compute their running medians in parallel */
+#pragma omp parallel for
+  for (UINT4 i = 0; i < input->length; i++) {
+    if (XLALGetCollectedErrno(&errnum) != XLAL_SUCCESS)
+      continue;
+    XLALCollectErrno(&errnum, rngmed_double_heap4(medians->data + i * medians->vectorLength,
+						   input->data + i * input->vectorLength,
+						   input->vectorLength, blocksize));
+  }
+  XLAL_CHECK(errnum == XLAL_SUCCESS, errnum);
 
-  DETATCHSTATUSPTR( status );
-  RETURN( status );
+  return XLAL_SUCCESS;
 }
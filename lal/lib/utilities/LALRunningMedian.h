@@ -50,9 +50,16 @@ extern "C" {
  * With n being the lenght of the input array and b being the blocksize,
  * the medians array must be a REAL4/REAL8 sequence of length (n-b+1).
  * <tt>LALDRunningMedian2()</tt> and <tt>LALSRunningMedian2()</tt> are a
- * different implentation of the same algorithm. It should behave exactly like
- * <tt>LALDRunningMedian()</tt>, but has proven to be a
- * little faster and more stable. Check if it works for you.
+ * different implementation using a double heap. They behave exactly like
+ * <tt>LALDRunningMedian()</tt>, but each step costs O(log b) rather than
+ * O(sqrt b) operations, which makes them much faster for large block sizes.
+ *
+ * <tt>XLALDRunningMedianVectorSequence()</tt> and
+ * <tt>XLALSRunningMedianVectorSequence()</tt> compute the running medians
+ * of each vector of a REAL4/REAL8VectorSequence, e.g.\ the power in a set of
+ * SFTs, using the same double heap algorithm. The vectors are processed
+ * in parallel if LAL was built with OpenMP. The medians must be a sequence
+ * of the same number of vectors of length (n-b+1).
  *
  * ### Algorithm ###
  *
@@ -60,6 +67,11 @@ extern "C" {
  * LIGO document T-030168-00-D, Somya D. Mohanty:
  * Efficient Algorithm for computing a Running Median
  *
+ * The double heap algorithm keeps the smaller half of the values of a block
+ * in a max-heap and the larger half in a min-heap, so that the median is
+ * found at the top of the heaps. Replacing the oldest value of the block by
+ * the next one from the input only requires restoring the two heaps.
+ *
  */
 /** @{ */
 
@@ -137,6 +149,18 @@ LALSRunningMedian2( LALStatus *status,
 		    const REAL4Sequence *input,
 		    LALRunningMedianPar param);
 
+/** See LALRunningMedian_h for documentation */
+int
+XLALDRunningMedianVectorSequence( REAL8VectorSequence *medians,
+				  const REAL8VectorSequence *input,
+				  UINT4 blocksize );
+
+/** See LALRunningMedian_h for documentation */
+int
+XLALSRunningMedianVectorSequence( REAL4VectorSequence *medians,
+				  const REAL4VectorSequence *input,
+				  UINT4 blocksize );
+
 /** @} */
 
 #ifdef  __cplusplus
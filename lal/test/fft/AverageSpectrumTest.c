@@ -17,20 +17,109 @@
 *  MA  02110-1301  USA
 */
 
+#include <complex.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <lal/LALStdlib.h>
 #include <lal/AVFactories.h>
+#include <lal/SeqFactories.h>
+#include <lal/FrequencySeries.h>
+#include <lal/TimeSeries.h>
+#include <lal/Units.h>
 #include <lal/TimeFreqFFT.h>
 #include <lal/RealFFT.h>
 #include <lal/Window.h>
 #include <lal/Random.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #define TESTSTATUS( s ) \
   if ( (s)->statusCode ) { REPORTSTATUS( s ); exit( 1 ); } else \
 ((void)0)
 
+#ifdef _OPENMP
+
+typedef int ( *REAL4Estimator )( REAL4FrequencySeries *, const REAL4TimeSeries *, UINT4, UINT4, const REAL4Window *, const REAL4FFTPlan * );
+typedef int ( *REAL8Estimator )( REAL8FrequencySeries *, const REAL8TimeSeries *, UINT4, UINT4, const REAL8Window *, const REAL8FFTPlan * );
+
+/* the threaded estimators must give bit-identical results to a run on a
+ * single thread */
+static int check_threads( const REAL4TimeSeries *tseries, UINT4 seglen )
+{
+  static const struct { const char *name; REAL4Estimator f4; REAL8Estimator f8; int stride_div; } estimators[] = {
+    { "Welch", XLALREAL4AverageSpectrumWelch, XLALREAL8AverageSpectrumWelch, 2 },
+    { "median", XLALREAL4AverageSpectrumMedian, XLALREAL8AverageSpectrumMedian, 2 },
+    { "median-mean", XLALREAL4AverageSpectrumMedianMean, XLALREAL8AverageSpectrumMedianMean, 1 },
+  };
+  const int nthreads = omp_get_max_threads() > 4 ? omp_get_max_threads() : 4;
+  const int max_threads = omp_get_max_threads();
+  REAL8TimeSeries *tseries8;
+  REAL4FrequencySeries *spec4[2];
+  REAL8FrequencySeries *spec8[2];
+  REAL4Window *window4;
+  REAL8Window *window8;
+  REAL4FFTPlan *plan4;
+  REAL8FFTPlan *plan8;
+  UINT4 e, i, k;
+  int result = 0;
+
+  tseries8 = XLALCreateREAL8TimeSeries( "data", &tseries->epoch, 0.0, tseries->deltaT, &lalDimensionlessUnit, tseries->data->length );
+  for ( i = 0; i < 2; ++i )
+  {
+    spec4[i] = XLALCreateREAL4FrequencySeries( "spectrum", &tseries->epoch, 0.0, 0.0, &lalDimensionlessUnit, seglen / 2 + 1 );
+    spec8[i] = XLALCreateREAL8FrequencySeries( "spectrum", &tseries->epoch, 0.0, 0.0, &lalDimensionlessUnit, seglen / 2 + 1 );
+    if ( ! spec4[i] || ! spec8[i] )
+      return 1;
+  }
+  window4 = XLALCreateHannREAL4Window( seglen );
+  window8 = XLALCreateHannREAL8Window( seglen );
+  plan4 = XLALCreateForwardREAL4FFTPlan( seglen, 0 );
+  plan8 = XLALCreateForwardREAL8FFTPlan( seglen, 0 );
+  if ( ! tseries8 || ! window4 || ! window8 || ! plan4 || ! plan8 )
+    return 1;
+  for ( k = 0; k < tseries->data->length; ++k )
+    tseries8->data->data[k] = tseries->data->data[k];
+
+  for ( e = 0; e < sizeof( estimators ) / sizeof( *estimators ); ++e )
+  {
+    const UINT4 stride = seglen / estimators[e].stride_div;
+    for ( i = 0; i < 2; ++i )
+    {
+      omp_set_num_threads( i ? nthreads : 1 );
+      if ( estimators[e].f4( spec4[i], tseries, seglen, stride, window4, plan4 ) || estimators[e].f8( spec8[i], tseries8, seglen, stride, window8, plan8 ) )
+        return 1;
+    }
+    for ( k = 0; k < seglen / 2 + 1; ++k )
+      if ( spec4[1]->data->data[k] != spec4[0]->data->data[k] || spec8[1]->data->data[k] != spec8[0]->data->data[k] )
+      {
+        fprintf( stderr, "%s spectrum on %d threads differs from single thread in bin %u: %e != %e, %e != %e\n", estimators[e].name, nthreads, k, spec4[1]->data->data[k], spec4[0]->data->data[k], spec8[1]->data->data[k], spec8[0]->data->data[k] );
+        result = 1;
+        break;
+      }
+    if ( ! result )
+      fprintf( stdout, "%s spectrum on %d threads agrees with single thread\n", estimators[e].name, nthreads );
+  }
+  omp_set_num_threads( max_threads );
+
+  XLALDestroyREAL8FFTPlan( plan8 );
+  XLALDestroyREAL4FFTPlan( plan4 );
+  XLALDestroyREAL8Window( window8 );
+  XLALDestroyREAL4Window( window4 );
+  for ( i = 0; i < 2; ++i )
+  {
+    XLALDestroyREAL8FrequencySeries( spec8[i] );
+    XLALDestroyREAL4FrequencySeries( spec4[i] );
+  }
+  XLALDestroyREAL8TimeSeries( tseries8 );
+  return result;
+}
+
+#endif
+
 int main( void )
 {
   const UINT4 n = 65536;
@@ -93,6 +182,70 @@ int main( void )
   ave /= fseries.data->length - 2;
   fprintf( stdout, "mean:\t%e\terror:\t%f%%\n", ave, fabs( ave - 2.0 ) / 0.02 );
 
+  /* check that the multi-channel PSD regressor agrees with single-channel
+   * regressors fed with the same data */
+  {
+    enum { nchan = 3, nbin = 129, nupdate = 20 };
+    LALPSDRegressor *regressor[nchan];
+    LALPSDMultiRegressor *multiregressor;
+    COMPLEX16FrequencySeries *sample;
+    COMPLEX16VectorSequence *samples;
+    const REAL8VectorSequence *psds;
+    REAL8FrequencySeries *psd;
+    UINT4 j, k, u;
+
+    multiregressor = XLALPSDMultiRegressorNew( nchan, nbin, 0.5, 8, 5 );
+    samples = XLALCreateCOMPLEX16VectorSequence( nchan, nbin );
+    sample = XLALCreateCOMPLEX16FrequencySeries( "sample", &tseries.epoch, 0.0, 0.5, &lalDimensionlessUnit, nbin );
+    if ( ! multiregressor || ! samples || ! sample )
+      return 1;
+    for ( j = 0; j < nchan; ++j )
+      if ( ! ( regressor[j] = XLALPSDRegressorNew( 8, 5 ) ) )
+        return 1;
+
+    for ( u = 0; u < nupdate; ++u )
+    {
+      for ( k = 0; k < nchan * nbin; ++k )
+        samples->data[k] = crect( tseries.data->data[2 * (u * nchan * nbin + k)], tseries.data->data[2 * (u * nchan * nbin + k) + 1] );
+      if ( XLALPSDMultiRegressorAdd( multiregressor, samples ) )
+        return 1;
+      for ( j = 0; j < nchan; ++j )
+      {
+        memcpy( sample->data->data, samples->data + j * nbin, nbin * sizeof( *sample->data->data ) );
+        if ( XLALPSDRegressorAdd( regressor[j], sample ) )
+          return 1;
+      }
+    }
+
+    psds = XLALPSDMultiRegressorGetPSDs( multiregressor );
+    if ( ! psds )
+      return 1;
+    for ( j = 0; j < nchan; ++j )
+    {
+      psd = XLALPSDRegressorGetPSD( regressor[j] );
+      if ( ! psd )
+        return 1;
+      for ( k = 0; k < nbin; ++k )
+        if ( fabs( psd->data->data[k] - psds->data[j * nbin + k] ) > 1e-12 * psd->data->data[k] )
+        {
+          fprintf( stderr, "PSD regressor mismatch: channel %u bin %u: %e != %e\n", j, k, psds->data[j * nbin + k], psd->data->data[k] );
+          return 1;
+        }
+      XLALDestroyREAL8FrequencySeries( psd );
+      XLALPSDRegressorFree( regressor[j] );
+    }
+    fprintf( stdout, "multi-channel PSD regressor agrees with single-channel regressors\n" );
+
+    XLALDestroyCOMPLEX16FrequencySeries( sample );
+    XLALDestroyCOMPLEX16VectorSequence( samples );
+    XLALPSDMultiRegressorFree( multiregressor );
+  }
+
+#ifdef _OPENMP
+  /* check that the threaded estimators agree with a single-thread run */
+  if ( check_threads( &tseries, n / 16 ) )
+    return 1;
+#endif
 
   /* cleanup */
   XLALDestroyREAL4Window( window );
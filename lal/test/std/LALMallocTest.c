@@ -54,6 +54,7 @@
 #include <signal.h>
 #include <lal/LALStdio.h>
 #include <lal/LALStdlib.h>
+#include <lal/AVFactories.h>
 
 /* never use this... never! */
 void XLALClobberDebugLevel(int);
@@ -326,6 +327,63 @@ static int stressTestRealloc( void )
 }
 
 
+/* test memory regions, and that the vector factories never draw from them */
+static int testRegions( void )
+{
+  int keep = lalDebugLevel;
+  REAL8Vector *cached = NULL;
+  REAL8Vector *heap = NULL;
+  size_t *outer = NULL;
+  size_t *inner = NULL;
+
+  XLALClobberDebugLevel(lalDebugLevel | LALMEMDBGBIT | LALMEMPADBIT | LALMEMTRKBIT);
+
+  /* region allocations need an active region */
+  if ( XLALMemoryRegionDepth() != 0 ) die( wrong region depth );
+  if ( XLALRegionMalloc( 16 ) != NULL ) die( allocated without a region );
+  XLALClearErrno();
+  trial( heap = XLALCreateREAL8Vector( 16 ), 0, "" );
+
+  if ( XLALPushMemoryRegion( 256 ) != XLAL_SUCCESS ) die( could not push region );
+  if ( XLALMemoryRegionDepth() != 1 ) die( wrong region depth );
+  if ( XLALIsMemoryRegionPointer( heap->data ) ) die( heap memory in region );
+  trial( outer = XLALRegionMalloc( 1024 * sizeof( *outer ) ), 0, "" );
+  if ( !XLALIsMemoryRegionPointer( outer ) ) die( allocation not in region );
+  if ( ( (size_t) outer ) % LAL_MEM_REGION_ALIGNMENT ) die( region memory not aligned );
+  for ( i = 0; i < 1024; ++i ) outer[i] = i;
+
+  /* a vector created inside a region, e.g. one cached by library code, is on
+   * the heap and outlives the region */
+  trial( cached = XLALCreateREAL8Vector( 64 ), 0, "" );
+  if ( XLALIsMemoryRegionPointer( cached ) || XLALIsMemoryRegionPointer( cached->data ) ) die( vector in region );
+
+  /* nested region, with allocations larger than its blocks */
+  if ( XLALPushMemoryRegion( 0 ) != XLAL_SUCCESS ) die( could not push region );
+  for ( n = 0; n < 64; ++n )
+  {
+    trial( inner = XLALRegionMalloc( ( n + 1 ) * LAL_MEM_REGION_BLOCK_SIZE / 16 ), 0, "" );
+    if ( !XLALIsMemoryRegionPointer( inner ) ) die( allocation not in region );
+    if ( ( (size_t) inner ) % LAL_MEM_REGION_ALIGNMENT ) die( region memory not aligned );
+    memset( inner, 0xA5, ( n + 1 ) * LAL_MEM_REGION_BLOCK_SIZE / 16 );
+  }
+  if ( XLALPopMemoryRegion() != XLAL_SUCCESS ) die( could not pop region );
+  for ( i = 0; i < 1024; ++i ) if ( outer[i] != i ) die( outer region overwritten );
+  if ( XLALPopMemoryRegion() != XLAL_SUCCESS ) die( could not pop region );
+  if ( XLALMemoryRegionDepth() != 0 ) die( wrong region depth );
+
+  /* popping an empty region stack is an error */
+  if ( XLALPopMemoryRegion() != XLAL_FAILURE ) die( popped empty region stack );
+  XLALClearErrno();
+
+  for ( i = 0; i < cached->length; ++i ) cached->data[i] = i;
+  trial( XLALDestroyREAL8Vector( cached ), 0, "" );
+  trial( XLALDestroyREAL8Vector( heap ), 0, "" );
+  trial( LALCheckMemoryLeaks(), 0, "" );
+  XLALClobberDebugLevel(keep);
+  return 0;
+}
+
+
 int main( void )
 {
   XLALGetDebugLevel();
@@ -342,6 +400,7 @@ int main( void )
   if ( testPadding() ) return 1;
   if ( testAllocList() ) return 1;
   if ( stressTestRealloc() ) return 1;
+  if ( testRegions() ) return 1;
 
   trial( LALCheckMemoryLeaks(), 0, "" );
 
@@ -0,0 +1,191 @@
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with with program; see the file COPYING. If not, write to the
+ *  Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ *  MA  02110-1301  USA
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <lal/LALStdlib.h>
+#include <lal/LALAdaptiveRungeKuttaIntegrator.h>
+
+#ifdef __GNUC__
+#define UNUSED __attribute__ ((unused))
+#else
+#define UNUSED
+#endif
+
+/* harmonic oscillator y0'' = -omega^2 y0, with y1 = y0' */
+static int dydt_oscillator( double UNUSED t, const double y[], double dydt[], void *params )
+{
+  const double omega = *( ( const double * ) params );
+  dydt[0] = y[1];
+  dydt[1] = -omega * omega * y[0];
+  return GSL_SUCCESS;
+}
+
+/* exponential decay of both variables, y' = -y */
+static int dydt_decay( double UNUSED t, const double y[], double dydt[], void UNUSED *params )
+{
+  dydt[0] = -y[0];
+  dydt[1] = -y[1];
+  return GSL_SUCCESS;
+}
+
+/* stop once t has gone past the time stored in the static variable below */
+static double stop_time;
+static int stop_before( double t, const double UNUSED y[], double UNUSED dydt[], void UNUSED *params )
+{
+  return t < stop_time ? 1 : GSL_SUCCESS;
+}
+
+#define TOLERANCE 1e-6
+
+/* compare the samples of the output of two integrations */
+static int outputs_equal( const REAL8Array *a, const REAL8Array *b )
+{
+  if ( !a || !b || a->dimLength->length != 2 || b->dimLength->length != 2 ) {
+    return 0;
+  }
+  if ( a->dimLength->data[0] != b->dimLength->data[0] || a->dimLength->data[1] != b->dimLength->data[1] ) {
+    return 0;
+  }
+  return memcmp( a->data, b->data, a->dimLength->data[0] * a->dimLength->data[1] * sizeof( *a->data ) ) == 0;
+}
+
+/* integrate the oscillator with unit amplitude over [0, tend], sampled every deltat */
+static int integrate_oscillator( LALAdaptiveRungeKuttaIntegrator *integrator, double omega, double tend, double deltat, REAL8Array **yout )
+{
+  REAL8 y[2] = { 1.0, 0.0 };
+  int len = XLALAdaptiveRungeKutta4Hermite( integrator, &omega, y, 0.0, tend, deltat, yout );
+  XLAL_CHECK( len > 0, XLAL_EFUNC );
+  for ( int j = 0; j < len; ++j ) {
+    const REAL8 t = ( *yout )->data[j];
+    XLAL_CHECK( fabs( ( *yout )->data[len + j] - cos( omega * t ) ) < TOLERANCE, XLAL_ETOL, "y0(%g) = %.9f, expected %.9f", t, ( *yout )->data[len + j], cos( omega * t ) );
+    XLAL_CHECK( fabs( ( *yout )->data[2 * len + j] + omega * sin( omega * t ) ) < TOLERANCE, XLAL_ETOL, "y1(%g) = %.9f, expected %.9f", t, ( *yout )->data[2 * len + j], -omega * sin( omega * t ) );
+  }
+  return len;
+}
+
+int main( void )
+{
+  const double omega = 2.0, eps = 1e-10;
+  LALAdaptiveRungeKuttaIntegrator *integrator, *cached, *other;
+  REAL8Array *first = NULL, *second = NULL, *grown = NULL, *backward = NULL;
+  REAL8 *buffer;
+  size_t buffersize;
+
+  /* Turn off buffering to sync standard output and error printing */
+  setvbuf( stdout, NULL, _IONBF, 0 );
+  setvbuf( stderr, NULL, _IONBF, 0 );
+
+  integrator = XLALAdaptiveRungeKutta4Init( 2, dydt_oscillator, NULL, eps, eps );
+  XLAL_CHECK_MAIN( integrator != NULL, XLAL_EFUNC );
+
+  /* A second integration of the same system with the same integrator reuses its buffers and gives the same result */
+  XLAL_CHECK_MAIN( integrate_oscillator( integrator, omega, 10.0, 0.01, &first ) > 0, XLAL_EFUNC );
+  XLAL_CHECK_MAIN( integrator->buffer != NULL && integrator->work != NULL, XLAL_EFAILED );
+  buffer = integrator->buffer;
+  buffersize = integrator->buffersize;
+  XLAL_CHECK_MAIN( integrate_oscillator( integrator, omega, 10.0, 0.01, &second ) > 0, XLAL_EFUNC );
+  XLAL_CHECK_MAIN( integrator->buffer == buffer && integrator->buffersize == buffersize, XLAL_EFAILED, "Integration buffer was reallocated" );
+  XLAL_CHECK_MAIN( outputs_equal( first, second ), XLAL_EFAILED, "Repeated integration gave a different result" );
+  printf( "Repeated integrations reuse the integration buffer (%zu elements)\n", buffersize );
+  XLALDestroyREAL8Array( second );
+  second = NULL;
+
+  /* An integration longer than the buffer grows it; the result does not depend on how the buffer was grown */
+  XLAL_CHECK_MAIN( integrate_oscillator( integrator, omega, 100.0, 0.01, &grown ) > 0, XLAL_EFUNC );
+  XLAL_CHECK_MAIN( integrator->buffersize > buffersize, XLAL_EFAILED, "Integration buffer did not grow" );
+  printf( "Integration buffer grew from %zu to %zu elements\n", buffersize, integrator->buffersize );
+
+  /* Reserve grows the buffer, never shrinks it, and an integration which fits does not reallocate it */
+  buffersize = integrator->buffersize;
+  XLAL_CHECK_MAIN( XLALAdaptiveRungeKuttaReserve( integrator, 10 ) == XLAL_SUCCESS, XLAL_EFUNC );
+  XLAL_CHECK_MAIN( integrator->buffersize == buffersize, XLAL_EFAILED, "Reserve shrank the integration buffer" );
+  XLAL_CHECK_MAIN( XLALAdaptiveRungeKuttaReserve( integrator, 40000 ) == XLAL_SUCCESS, XLAL_EFUNC );
+  XLAL_CHECK_MAIN( integrator->buffersize >= 6 * 40000, XLAL_EFAILED, "Reserve did not grow the integration buffer" );
+  buffer = integrator->buffer;
+  buffersize = integrator->buffersize;
+  XLAL_CHECK_MAIN( integrate_oscillator( integrator, omega, 100.0, 0.01, &second ) > 0, XLAL_EFUNC );
+  XLAL_CHECK_MAIN( integrator->buffer == buffer && integrator->buffersize == buffersize, XLAL_EFAILED, "Reserved integration buffer was reallocated" );
+  XLAL_CHECK_MAIN( outputs_equal( grown, second ), XLAL_EFAILED, "Integration into a reserved buffer gave a different result" );
+  printf( "Reserved integration buffer of %zu elements was not reallocated\n", buffersize );
+  XLALDestroyREAL8Array( second );
+  second = NULL;
+
+  /* After a Reset for a different system, integrate backwards in time until the stopping test fires; the output is in increasing time */
+  XLAL_CHECK_MAIN( XLALAdaptiveRungeKuttaReset( integrator, dydt_decay, stop_before, eps, eps ) == XLAL_SUCCESS, XLAL_EFUNC );
+  integrator->stopontestonly = 1;
+  stop_time = -5.0;
+  {
+    REAL8 y[2] = { 1.0, 2.0 };
+    int len = XLALAdaptiveRungeKutta4IrregularIntervals( integrator, NULL, y, 0.0, stop_time, &backward );
+    XLAL_CHECK_MAIN( len > 1, XLAL_EFUNC );
+    XLAL_CHECK_MAIN( backward->dimLength->data[0] == 4, XLAL_EFAILED );
+    XLAL_CHECK_MAIN( backward->data[len - 1] == 0.0 && backward->data[0] < stop_time, XLAL_EFAILED, "Backward integration covers [%g, %g]", backward->data[0], backward->data[len - 1] );
+    for ( int j = 0; j < len; ++j ) {
+      const REAL8 t = backward->data[j];
+      XLAL_CHECK_MAIN( j == 0 || t > backward->data[j - 1], XLAL_EFAILED, "Backward integration output is not in increasing time" );
+      XLAL_CHECK_MAIN( fabs( backward->data[len + j] / exp( -t ) - 1.0 ) < TOLERANCE, XLAL_ETOL, "y0(%g) = %.9g, expected %.9g", t, backward->data[len + j], exp( -t ) );
+      XLAL_CHECK_MAIN( fabs( backward->data[2 * len + j] / ( 2.0 * exp( -t ) ) - 1.0 ) < TOLERANCE, XLAL_ETOL, "y1(%g) = %.9g, expected %.9g", t, backward->data[2 * len + j], 2.0 * exp( -t ) );
+    }
+    XLAL_CHECK_MAIN( y[0] == backward->data[len] && y[1] == backward->data[2 * len], XLAL_EFAILED, "Final state does not match the earliest sample" );
+    printf( "Backward integration after a reset gave %d samples in [%g, 0]\n", len, backward->data[0] );
+  }
+
+  /* The integrator of the caller's own gives the same results after a reset back to the original system */
+  XLAL_CHECK_MAIN( XLALAdaptiveRungeKuttaReset( integrator, dydt_oscillator, NULL, eps, eps ) == XLAL_SUCCESS, XLAL_EFUNC );
+  XLAL_CHECK_MAIN( integrator->stopontestonly == 0, XLAL_EFAILED );
+  XLAL_CHECK_MAIN( integrate_oscillator( integrator, omega, 10.0, 0.01, &second ) > 0, XLAL_EFUNC );
+  XLAL_CHECK_MAIN( outputs_equal( first, second ), XLAL_EFAILED, "Integration after a reset gave a different result" );
+  XLALDestroyREAL8Array( second );
+  second = NULL;
+  XLALAdaptiveRungeKuttaFree( integrator );
+
+  /* Integrators from the thread cache are handed out again once returned, with their buffers, and give the same results */
+  cached = XLALAdaptiveRungeKutta4ThreadInit( 2, dydt_oscillator, NULL, eps, eps );
+  XLAL_CHECK_MAIN( cached != NULL, XLAL_EFUNC );
+  XLAL_CHECK_MAIN( integrate_oscillator( cached, omega, 10.0, 0.01, &second ) > 0, XLAL_EFUNC );
+  XLAL_CHECK_MAIN( outputs_equal( first, second ), XLAL_EFAILED, "Cached integrator gave a different result" );
+  XLALDestroyREAL8Array( second );
+  second = NULL;
+  buffer = cached->buffer;
+  other = XLALAdaptiveRungeKutta4ThreadInit( 2, dydt_oscillator, NULL, eps, eps );
+  XLAL_CHECK_MAIN( other != NULL && other != cached, XLAL_EFAILED, "Cached integrator was handed out twice" );
+  XLALAdaptiveRungeKuttaFree( other );
+  XLALAdaptiveRungeKuttaFree( cached );
+  integrator = XLALAdaptiveRungeKutta4ThreadInit( 2, dydt_oscillator, NULL, eps, eps );
+  XLAL_CHECK_MAIN( integrator == cached || integrator == other, XLAL_EFAILED, "Returned integrator was not reused" );
+  if ( integrator == cached ) {
+    XLAL_CHECK_MAIN( integrator->buffer == buffer, XLAL_EFAILED, "Cached integrator lost its buffer" );
+  }
+  XLAL_CHECK_MAIN( integrate_oscillator( integrator, omega, 10.0, 0.01, &second ) > 0, XLAL_EFUNC );
+  XLAL_CHECK_MAIN( outputs_equal( first, second ), XLAL_EFAILED, "Reused cached integrator gave a different result" );
+  XLALAdaptiveRungeKuttaFree( integrator );
+  other = XLALAdaptiveRungeKutta4ThreadInit( 3, dydt_oscillator, NULL, eps, eps );
+  XLAL_CHECK_MAIN( other != NULL && other != cached && other->sys->dimension == 3, XLAL_EFAILED, "Cached integrator of the wrong dimension was handed out" );
+  XLALAdaptiveRungeKuttaFree( other );
+  printf( "Thread-cached integrators are reused and give the same results\n" );
+
+  XLALDestroyREAL8Array( first );
+  XLALDestroyREAL8Array( second );
+  XLALDestroyREAL8Array( grown );
+  XLALDestroyREAL8Array( backward );
+
+  LALCheckMemoryLeaks();
+
+  return EXIT_SUCCESS;
+}
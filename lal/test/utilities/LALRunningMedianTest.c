@@ -49,7 +49,8 @@
  * computes medians of all blocks with blocksize using the
  * LALRunningMedian functions and compares the results against
  * inividually calculated medians. The test is repeated with
- * blocksize - 1 (to check for even/odd errors).
+ * blocksize - 1 (to check for even/odd errors), for the
+ * vector sequence functions, and for input with many identical values.
  * The default values for array length and window
  * width are 1024 and 512.
  * If a value for lalDebugLevel is given, the program
@@ -113,6 +114,10 @@ int testDRunningMedian(LALStatus *stat, REAL8Sequence *input, UINT4 length,
 		       LALRunningMedianPar param, BOOLEAN verbose, BOOLEAN bmimpl);
 int testSRunningMedian(LALStatus *stat, REAL4Sequence *input, UINT4 length,
 		       LALRunningMedianPar param, BOOLEAN verbose, BOOLEAN bmimpl);
+int testDRunningMedianVectorSequence(LALStatus *stat, REAL8Sequence *input,
+				     LALRunningMedianPar param);
+int testSRunningMedianVectorSequence(LALStatus *stat, REAL4Sequence *input,
+				     LALRunningMedianPar param);
 
 
 struct rngmed_val_index {
@@ -346,6 +351,122 @@ int testSRunningMedian(LALStatus *stat, REAL4Sequence *input, UINT4 length,
 
 
 
+int testDRunningMedianVectorSequence(LALStatus *stat, REAL8Sequence *input,
+				     LALRunningMedianPar param) {
+/* Test XLALDRunningMedianVectorSequence() by comparing the medians of each
+   vector to the results of LALDRunningMedian2(). The vectors are the input,
+   the reversed input and the input rounded to give many identical values */
+
+  const UINT4 nvec = 3;
+  const UINT4 nmed = input->length - param.blocksize + 1;
+  REAL8VectorSequence *inputs=NULL;
+  REAL8VectorSequence *medians=NULL;
+  REAL8Sequence row;
+  REAL8Sequence *rowmedians=NULL;
+  UINT4 i,k;
+
+  inputs = XLALCreateREAL8VectorSequence( nvec, input->length );
+  medians = XLALCreateREAL8VectorSequence( nvec, nmed );
+  rowmedians = XLALCreateREAL8Vector( nmed );
+  if ( !inputs || !medians || !rowmedians ) {
+    EXIT( LALRUNNINGMEDIANTESTC_EALOC, argv0, LALRUNNINGMEDIANTESTC_MSGEALOC );
+  }
+  for(k=0;k<input->length;k++) {
+    inputs->data[k] = input->data[k];
+    inputs->data[input->length + k] = input->data[input->length - 1 - k];
+    inputs->data[2 * input->length + k] = floor(8.0 * input->data[k]) / 8.0;
+  }
+
+  /* call running median */
+  if ( XLALDRunningMedianVectorSequence( medians, inputs, param.blocksize ) != XLAL_SUCCESS ) {
+    printf("ERROR: XLALDRunningMedianVectorSequence failed with xlalErrno %d\n",xlalErrno);
+    EXIT( LALRUNNINGMEDIANTESTC_ESUB, argv0, LALRUNNINGMEDIANTESTC_MSGESUB );
+  }
+
+  /* compare all medians */
+  for(i=0;i<nvec;i++) {
+    row.length = input->length;
+    row.data = inputs->data + i * input->length;
+    LALDRunningMedian2( stat, rowmedians, &row, param );
+    if ( stat->statusCode ) {
+      printf("ERROR: LALDRunningMedian2 returned status %d\n",stat->statusCode);
+      EXIT( LALRUNNINGMEDIANTESTC_ESUB, argv0, LALRUNNINGMEDIANTESTC_MSGESUB );
+    }
+    for(k=0;k<nmed;k++)
+      if(compare_double(rowmedians->data[k],medians->data[i * nmed + k])) {
+	printf("ERROR: vector:%d index:%d median:% 22.15e running median:% 22.15e\n",
+	       i, k, rowmedians->data[k], medians->data[i * nmed + k]);
+	EXIT( LALRUNNINGMEDIANTESTC_EFALSE, argv0, LALRUNNINGMEDIANTESTC_MSGEFALSE );
+      }
+  }
+
+  XLALDestroyREAL8Vector(rowmedians);
+  XLALDestroyREAL8VectorSequence(medians);
+  XLALDestroyREAL8VectorSequence(inputs);
+  return(0);
+}
+
+
+
+
+int testSRunningMedianVectorSequence(LALStatus *stat, REAL4Sequence *input,
+				     LALRunningMedianPar param) {
+/* Test XLALSRunningMedianVectorSequence() by comparing the medians of each
+   vector to the results of LALSRunningMedian2(). The vectors are the input,
+   the reversed input and the input rounded to give many identical values */
+
+  const UINT4 nvec = 3;
+  const UINT4 nmed = input->length - param.blocksize + 1;
+  REAL4VectorSequence *inputs=NULL;
+  REAL4VectorSequence *medians=NULL;
+  REAL4Sequence row;
+  REAL4Sequence *rowmedians=NULL;
+  UINT4 i,k;
+
+  inputs = XLALCreateREAL4VectorSequence( nvec, input->length );
+  medians = XLALCreateREAL4VectorSequence( nvec, nmed );
+  rowmedians = XLALCreateREAL4Vector( nmed );
+  if ( !inputs || !medians || !rowmedians ) {
+    EXIT( LALRUNNINGMEDIANTESTC_EALOC, argv0, LALRUNNINGMEDIANTESTC_MSGEALOC );
+  }
+  for(k=0;k<input->length;k++) {
+    inputs->data[k] = input->data[k];
+    inputs->data[input->length + k] = input->data[input->length - 1 - k];
+    inputs->data[2 * input->length + k] = floorf(8.0f * input->data[k]) / 8.0f;
+  }
+
+  /* call running median */
+  if ( XLALSRunningMedianVectorSequence( medians, inputs, param.blocksize ) != XLAL_SUCCESS ) {
+    printf("ERROR: XLALSRunningMedianVectorSequence failed with xlalErrno %d\n",xlalErrno);
+    EXIT( LALRUNNINGMEDIANTESTC_ESUB, argv0, LALRUNNINGMEDIANTESTC_MSGESUB );
+  }
+
+  /* compare all medians */
+  for(i=0;i<nvec;i++) {
+    row.length = input->length;
+    row.data = inputs->data + i * input->length;
+    LALSRunningMedian2( stat, rowmedians, &row, param );
+    if ( stat->statusCode ) {
+      printf("ERROR: LALSRunningMedian2 returned status %d\n",stat->statusCode);
+      EXIT( LALRUNNINGMEDIANTESTC_ESUB, argv0, LALRUNNINGMEDIANTESTC_MSGESUB );
+    }
+    for(k=0;k<nmed;k++)
+      if(compare_single(rowmedians->data[k],medians->data[i * nmed + k])) {
+	printf("ERROR: vector:%d index:%d median:% 22.15e running median:% 22.15e\n",
+	       i, k, rowmedians->data[k], medians->data[i * nmed + k]);
+	EXIT( LALRUNNINGMEDIANTESTC_EFALSE, argv0, LALRUNNINGMEDIANTESTC_MSGEFALSE );
+      }
+  }
+
+  XLALDestroyREAL4Vector(rowmedians);
+  XLALDestroyREAL4VectorSequence(medians);
+  XLALDestroyREAL4VectorSequence(inputs);
+  return(0);
+}
+
+
+
+
 /**************
  **** MAIN ****
  **************/
@@ -671,6 +792,34 @@ int main( int argc, char **argv )
   }
 
 
+  if(testDRunningMedianVectorSequence(&stat,input8,param)) {
+    EXIT( LALRUNNINGMEDIANTESTC_EFALSE, argv0, LALRUNNINGMEDIANTESTC_MSGEFALSE );
+  } else {
+    printf("  PASS: XLALDRunningMedianVectorSequence(%d,%d)\n",length,param.blocksize);
+  }
+
+  if(testSRunningMedianVectorSequence(&stat,input4,param)) {
+    EXIT( LALRUNNINGMEDIANTESTC_EFALSE, argv0, LALRUNNINGMEDIANTESTC_MSGEFALSE );
+  } else {
+    printf("  PASS: XLALSRunningMedianVectorSequence(%d,%d)\n",length,param.blocksize);
+  }
+
+  /* round the input to check LALRunningMedian2 with many identical values */
+  for(i=0;i<length;i++)
+    input4->data[i] = (input8->data[i] = floor(8.0 * input8->data[i]) / 8.0);
+
+  if(testDRunningMedian(&stat,input8,length,param,verbose,1)) {
+    EXIT( LALRUNNINGMEDIANTESTC_EFALSE, argv0, LALRUNNINGMEDIANTESTC_MSGEFALSE );
+  } else {
+    printf("  PASS: LALDRunningMedian2(%d,%d) with identical values\n",length,param.blocksize);
+  }
+
+  if(testSRunningMedian(&stat,input4,length,param,verbose,1)) {
+    EXIT( LALRUNNINGMEDIANTESTC_EFALSE, argv0, LALRUNNINGMEDIANTESTC_MSGEFALSE );
+  } else {
+    printf("  PASS: LALSRunningMedian2(%d,%d) with identical values\n",length,param.blocksize);
+  }
+
   /* free dummy input memory */
   LALDDestroyVector(&stat,&input8);
   LALSDestroyVector(&stat,&input4);
@@ -37,6 +37,7 @@
 #include <lal/LALInferenceProposal.h>
 #include <lal/LALInferenceInit.h>
 #include <lal/LALInferenceCalibrationErrors.h>
+#include <lal/LALInferenceMultibanding.h>
 #include <lal/LALInferenceVCSInfo.h>
 
 /*************** MAIN **********************/
@@ -158,6 +159,8 @@ int main(int argc, char *argv[]){
   /* Call nested sampling algorithm */
   state->algorithm(state);
 
+  LALInferenceDestroyMultibandLikelihood(state);
+
   /* end */
   return(0);
 }
@@ -30,6 +30,7 @@
 #include <lal/LALInferenceReadData.h>
 #include <lal/LALInferenceInit.h>
 #include <lal/LALInferenceCalibrationErrors.h>
+#include <lal/LALInferenceMultibanding.h>
 
 #include <mpi.h>
 
@@ -432,6 +433,8 @@ int main(int argc, char *argv[]){
     /* Run the sampler to completion */
     run_state->algorithm(run_state);
 
+    LALInferenceDestroyMultibandLikelihood(run_state);
+
     if (mpi_rank == 0)
         printf(" ==========  sampling complete ==========\n");
 
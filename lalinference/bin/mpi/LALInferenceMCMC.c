@@ -38,6 +38,7 @@
 #include <lal/LALInferenceReadData.h>
 #include <lal/LALInferenceInit.h>
 #include <lal/LALInferenceCalibrationErrors.h>
+#include <lal/LALInferenceMultibanding.h>
 
 #include <mpi.h>
 
@@ -93,6 +94,8 @@ INT4 init_ptmcmc(LALInferenceRunState *runState) {
     (--adapt-tau)       Adaptation decay power, results in adapt length of 10^tau (5)\n\
     (--no-adapt)        Do not adapt run\n\
     (--randomseed seed) Random seed of sampling distribution (random)\n\
+    (--async-kde)       Rebuild the clustered-KDE proposal in the background, keeping\n\
+                            the previous one until the rebuild is done\n\
     \n\
     ----------------------------------------------\n\
     --- Parallel Tempering Algorithm Parameters --\n\
@@ -731,6 +734,8 @@ int main(int argc, char *argv[]){
     if (mpirank == 0) printf("sampling...\n");
     runState->algorithm(runState);
 
+    LALInferenceDestroyMultibandLikelihood(runState);
+
     if (mpirank == 0) printf(" ========== main(): finished. ==========\n");
     MPI_Finalize();
 
@@ -91,6 +91,8 @@ thinDifferentialEvolutionPoints(LALInferenceThreadState *thread) {
     thread->differentialPointsSize = 2*newSize;
     thread->differentialPointsLength = newSize;
     thread->differentialPointsSkip *= 2;
+
+    LALInferenceDEBufferThin(thread->deBuffer);
 }
 
 static void
@@ -112,6 +114,13 @@ accumulateDifferentialEvolutionSample(LALInferenceThreadState *thread, size_t bu
     LALInferenceCopyVariables(thread->currentParams, thread->differentialPoints[thread->differentialPointsLength]);
 
     thread->differentialPointsLength += 1;
+
+    /* Keep the matrix copy in step, or drop it and let the proposals use the variables */
+    if (thread->deBuffer && LALInferenceDEBufferAppend(thread->deBuffer, thread->currentParams) != XLAL_SUCCESS) {
+        LALInferenceDestroyDEBuffer(thread->deBuffer);
+        thread->deBuffer = NULL;
+        XLALClearErrno();
+    }
 }
 
 static void
@@ -128,6 +137,9 @@ resetDifferentialEvolutionBuffer(LALInferenceThreadState *thread) {
     thread->differentialPointsLength = 0;
     thread->differentialPointsSize = 1;
     thread->differentialPointsSkip = LALInferenceGetINT4Variable(thread->proposalArgs, "de_skip");
+
+    if (thread->deBuffer)
+        thread->deBuffer->length = 0;
 }
 
 /* This is checked by the main loop to determine when to checkpoint */
@@ -241,6 +253,7 @@ void PTMCMCAlgorithm(struct tagLALInferenceRunState *runState) {
 
     /* Clustered-KDE proposal updates */
     INT4 kde_update_start = 200;  // rough number of effective samples to start KDE updates
+    INT4 async_kde = (LALInferenceGetProcParamVal(runState->commandLine, "--async-kde") != NULL);  // rebuild KDEs in the background
 
     /* proposal will be updated 5 times per decade, so this interval will change */
     INT4 *kde_update_interval = XLALCalloc(n_local_threads, sizeof(INT4));
@@ -327,9 +340,20 @@ void PTMCMCAlgorithm(struct tagLALInferenceRunState *runState) {
 	{
         record_likelihoods(&runState->threads[t]);
 		LALInferenceSortVariablesByName(runState->threads[t].currentParams);
+        /* The parameter set is fixed from here on; copies to the proposed parameters inherit the layout */
+        if (LALInferenceCompileVariables(runState->threads[t].currentParams) != XLAL_SUCCESS)
+            XLALClearErrno();
     }
     LALInferenceNameOutputs(runState);
     LALInferenceResumeMCMC(runState);
+
+    /* Mirror the (possibly resumed) differential evolution buffers as matrices for the proposals */
+    if (diffEvo) {
+        for (t = 0; t < n_local_threads; t++) {
+            if (LALInferenceRebuildDEBuffer(&runState->threads[t]) != XLAL_SUCCESS)
+                XLALClearErrno();
+        }
+    }
     
     if (benchmark) {
         struct timeval start_tv;
@@ -398,12 +422,19 @@ void PTMCMCAlgorithm(struct tagLALInferenceRunState *runState) {
                     LALInferenceTrackProposalAcceptance(thread);
 
                 if ((thread->step % Nskip) == 0) {
+                    /* Swap in a clustered-KDE proposal once its background rebuild is done */
+                    if (async_kde)
+                        LALInferenceCollectClusteredKDEProposal(thread, 0);
+
                     /* Update clustered-KDE proposal every time the buffer is expanded */
                     if (LALInferenceGetProcParamVal(runState->commandLine, "--proposal-kde")
                         && (thread->effective_sample_size > kde_update_start)
                         && (((thread->effective_sample_size - last_kde_update[t]) > kde_update_interval[t]) ||
                           ((last_kde_update[t] - thread->effective_sample_size) > kde_update_interval[t]))) {
-                        LALInferenceSetupClusteredKDEProposalFromDEBuffer(thread);
+                        if (async_kde)
+                            LALInferenceSetupClusteredKDEProposalFromDEBufferAsync(thread);
+                        else
+                            LALInferenceSetupClusteredKDEProposalFromDEBuffer(thread);
 
                         /* Update 5 times each decade.  This keeps hot chains (with lower ACLs) under control */
                         kde_update_interval[t] = 2 * ((INT4) pow(10.0, floor(log10((REAL8) thread->effective_sample_size))));
@@ -562,7 +593,20 @@ void PTMCMCAlgorithm(struct tagLALInferenceRunState *runState) {
         /* Broadcast the root's decision on run completion */
         MPI_Bcast(&runComplete, 1, MPI_INT, 0, MPI_COMM_WORLD);
     }// while (!runComplete)
+
+    /* Don't leave any clustered-KDE rebuilds running */
+    if (async_kde)
+        for (t = 0; t < n_local_threads; t++)
+            LALInferenceCollectClusteredKDEProposal(&runState->threads[t], 1);
+
     LALInferenceWriteMCMCSamples(runState);
+
+    /* The matrix mirrors of the differential evolution buffers are no longer needed */
+    for (t = 0; t < n_local_threads; t++) {
+        LALInferenceDestroyDEBuffer(runState->threads[t].deBuffer);
+        runState->threads[t].deBuffer = NULL;
+    }
+
     MPI_Barrier(MPI_COMM_WORLD);
 }
 
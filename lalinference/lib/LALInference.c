@@ -40,6 +40,11 @@
 #include <gsl/gsl_interp.h>
 #include <lal/LALHashFunc.h>
 #include <lal/LALSimNeutronStar.h>
+#include <lal/LALConfig.h>
+
+#ifdef LAL_PTHREAD_LOCK
+#include <pthread.h>
+#endif
 
 #ifdef __GNUC__
 #define UNUSED __attribute__ ((unused))
@@ -130,6 +135,7 @@ LALInferenceThreadState *LALInferenceInitThread(LALInferenceThreadState *thread)
     thread->differentialPointsLength = 0;
     thread->differentialPointsSize = 1;
     thread->differentialPointsSkip = 1;
+    thread->deBuffer = NULL;
 
     return thread;
 }
@@ -156,6 +162,14 @@ static INT4 checkREAL8FrequencySeries(REAL8FrequencySeries *series);
 static INT4 checkCOMPLEX16FrequencySeries(COMPLEX16FrequencySeries *series);
 static INT4 matrix_equal(gsl_matrix *a, gsl_matrix *b);
 static LALInferenceVariableItem *LALInferenceGetItemSlow(const LALInferenceVariables *vars,const char *name);
+static int LALInferenceUncompileVariables(LALInferenceVariables *vars);
+static int LALInferenceCopyVariablesInPlace(LALInferenceVariables *origin, LALInferenceVariables *target);
+
+/* Return 1 if the value of item is stored in the compiled array of vars */
+static int item_is_compiled(const LALInferenceVariables *vars, const LALInferenceVariableItem *item)
+{
+  return vars->compiled && (const REAL8 *)item->value >= vars->compiled && (const REAL8 *)item->value < vars->compiled + vars->nslots;
+}
 
 /* This replaces gsl_matrix_equal which is only available with gsl 1.15+ */
 /* Return 1 if matrices are equal, 0 otherwise */
@@ -492,7 +506,9 @@ void LALInferenceRemoveVariable(LALInferenceVariables *vars,const char *name)
     break;
   }
 
-  XLALFree(this->value);
+  /* Compiled values live in the flat array, just retire the slot */
+  if(item_is_compiled(vars,this)) vars->slots[(REAL8 *)this->value - vars->compiled]=NULL;
+  else XLALFree(this->value);
   this->value=NULL;
   XLALFree(this);
   this=NULL;
@@ -542,7 +558,7 @@ void LALInferenceClearVariables(LALInferenceVariables *vars)
     if(this->type==LALINFERENCE_UINT4Vector_t) XLALDestroyUINT4Vector(*(UINT4Vector **)this->value);
     if(this->type==LALINFERENCE_REAL8Vector_t) XLALDestroyREAL8Vector(*(REAL8Vector **)this->value);
     if(this->type==LALINFERENCE_COMPLEX16Vector_t) XLALDestroyCOMPLEX16Vector(*(COMPLEX16Vector **)this->value);
-    XLALFree(this->value);
+    if(!item_is_compiled(vars,this)) XLALFree(this->value);
     XLALFree(this);
     this=next;
     if(this) next=this->next;
@@ -551,6 +567,11 @@ void LALInferenceClearVariables(LALInferenceVariables *vars)
   vars->dimension=0;
   if(vars->hash_table) XLALHashTblDestroy(vars->hash_table);
   vars->hash_table=NULL;
+  XLALFree(vars->compiled);
+  XLALFree(vars->slots);
+  vars->compiled=NULL;
+  vars->slots=NULL;
+  vars->nslots=0;
   
   return;
 }
@@ -572,6 +593,9 @@ void LALInferenceCopyVariables(LALInferenceVariables *origin, LALInferenceVariab
   /* Make sure the structure is initialised */
   if(!target) XLAL_ERROR_VOID(XLAL_EFAULT, "Unable to copy to uninitialised LALInferenceVariables structure.");
 
+  /* If target already holds the same variables, just overwrite the values */
+  if(LALInferenceCopyVariablesInPlace(origin,target)) return;
+
   /* First clear the target */
   LALInferenceClearVariables(target);
 
@@ -652,9 +676,158 @@ void LALInferenceCopyVariables(LALInferenceVariables *origin, LALInferenceVariab
     }
   }
 
+  /* Keep the compiled layout of origin */
+  if(origin->compiled && LALInferenceCompileVariables(target)!=XLAL_SUCCESS)
+    XLAL_ERROR_VOID(XLAL_EFUNC);
+
   return;
 }
 
+/* Copy origin into target without reallocating, if both hold the same
+ * variables in the same order and the vector and matrix sizes agree.
+ * Returns 1 on success, 0 if target has to be rebuilt. */
+static int LALInferenceCopyVariablesInPlace(LALInferenceVariables *origin, LALInferenceVariables *target)
+{
+  LALInferenceVariableItem *src,*dst;
+
+  if(origin->dimension!=target->dimension) return 0;
+
+  for(src=origin->head,dst=target->head; src&&dst; src=src->next,dst=dst->next)
+  {
+    if(src->type!=dst->type || strcmp(src->name,dst->name)) return 0;
+    switch(src->type)
+    {
+      case LALINFERENCE_gslMatrix_t:
+      {
+        gsl_matrix *old=*(gsl_matrix **)src->value,*new=*(gsl_matrix **)dst->value;
+        if(!old||!new||old->size1!=new->size1||old->size2!=new->size2) return 0;
+        gsl_matrix_memcpy(new,old);
+        break;
+      }
+      case LALINFERENCE_INT4Vector_t:
+      {
+        INT4Vector *old=*(INT4Vector **)src->value,*new=*(INT4Vector **)dst->value;
+        if(!old||!new||old->length!=new->length) return 0;
+        memcpy(new->data,old->data,new->length*sizeof(new->data[0]));
+        break;
+      }
+      case LALINFERENCE_UINT4Vector_t:
+      {
+        UINT4Vector *old=*(UINT4Vector **)src->value,*new=*(UINT4Vector **)dst->value;
+        if(!old||!new||old->length!=new->length) return 0;
+        memcpy(new->data,old->data,new->length*sizeof(new->data[0]));
+        break;
+      }
+      case LALINFERENCE_REAL8Vector_t:
+      {
+        REAL8Vector *old=*(REAL8Vector **)src->value,*new=*(REAL8Vector **)dst->value;
+        if(!old||!new||old->length!=new->length) return 0;
+        memcpy(new->data,old->data,new->length*sizeof(new->data[0]));
+        break;
+      }
+      case LALINFERENCE_COMPLEX16Vector_t:
+      {
+        COMPLEX16Vector *old=*(COMPLEX16Vector **)src->value,*new=*(COMPLEX16Vector **)dst->value;
+        if(!old||!new||old->length!=new->length) return 0;
+        memcpy(new->data,old->data,new->length*sizeof(new->data[0]));
+        break;
+      }
+      default:
+        memcpy(dst->value,src->value,LALInferenceTypeSize[src->type]);
+        break;
+    }
+    dst->vary=src->vary;
+  }
+
+  return 1;
+}
+
+int LALInferenceCompileVariables(LALInferenceVariables *vars)
+{
+  LALInferenceVariableItem *item;
+  INT4 n=0;
+
+  if(!vars) XLAL_ERROR(XLAL_EFAULT);
+  if(vars->compiled && LALInferenceUncompileVariables(vars)!=XLAL_SUCCESS) XLAL_ERROR(XLAL_EFUNC);
+
+  for(item=vars->head;item;item=item->next)
+    if(item->type==LALINFERENCE_REAL8_t) n++;
+  if(n==0) return XLAL_SUCCESS;
+
+  vars->compiled=XLALMalloc(n*sizeof(REAL8));
+  vars->slots=XLALMalloc(n*sizeof(LALInferenceVariableItem *));
+  if(!vars->compiled||!vars->slots)
+  {
+    XLALFree(vars->compiled);
+    XLALFree(vars->slots);
+    vars->compiled=NULL;
+    vars->slots=NULL;
+    XLAL_ERROR(XLAL_ENOMEM);
+  }
+
+  for(item=vars->head,n=0;item;item=item->next)
+  {
+    if(item->type!=LALINFERENCE_REAL8_t) continue;
+    vars->compiled[n]=*(REAL8 *)item->value;
+    XLALFree(item->value);
+    item->value=&vars->compiled[n];
+    vars->slots[n]=item;
+    n++;
+  }
+  vars->nslots=n;
+
+  return XLAL_SUCCESS;
+}
+
+/* Give each compiled variable its own storage again and drop the flat array */
+static int LALInferenceUncompileVariables(LALInferenceVariables *vars)
+{
+  INT4 i;
+
+  for(i=0;i<vars->nslots;i++)
+  {
+    if(!vars->slots[i]) continue;
+    REAL8 *value=XLALMalloc(sizeof(REAL8));
+    if(!value) XLAL_ERROR(XLAL_ENOMEM);
+    *value=vars->compiled[i];
+    vars->slots[i]->value=value;
+    vars->slots[i]=NULL;
+  }
+  XLALFree(vars->compiled);
+  XLALFree(vars->slots);
+  vars->compiled=NULL;
+  vars->slots=NULL;
+  vars->nslots=0;
+
+  return XLAL_SUCCESS;
+}
+
+INT4 LALInferenceGetVariableSlot(const LALInferenceVariables *vars, const char *name)
+{
+  LALInferenceVariableItem *item=LALInferenceGetItem(vars,name);
+  if(!item||!item_is_compiled(vars,item)) return -1;
+  return (INT4)((REAL8 *)item->value - vars->compiled);
+}
+
+REAL8 LALInferenceGetREAL8VariableBySlot(const LALInferenceVariables *vars, INT4 slot)
+{
+  if(slot<0||slot>=vars->nslots||!vars->slots[slot])
+    XLAL_ERROR_REAL8(XLAL_EINVAL, "No variable in slot %d.", slot);
+  return vars->compiled[slot];
+}
+
+void LALInferenceSetREAL8VariableBySlot(LALInferenceVariables *vars, INT4 slot, REAL8 value)
+{
+  if(slot<0||slot>=vars->nslots||!vars->slots[slot])
+    XLAL_ERROR_VOID(XLAL_EINVAL, "No variable in slot %d.", slot);
+  if(vars->slots[slot]->vary==LALINFERENCE_PARAM_FIXED)
+  {
+    XLALPrintWarning("Warning! Attempting to set variable %s which is fixed\n",vars->slots[slot]->name);
+    return;
+  }
+  vars->compiled[slot]=value;
+}
+
 
 void LALInferenceCopyUnsetREAL8Variables(LALInferenceVariables *origin, LALInferenceVariables *target, ProcessParamsTable *commandLine) {
 /*  Copy REAL8s from "origin" to "target" if they weren't set on the command line */
@@ -1593,6 +1766,13 @@ INT4 LALInferenceThinnedBufferToArray(LALInferenceThreadState *thread, REAL8** D
     INT4 i=0, p=0;
 
     INT4 nPoints = thread->differentialPointsLength;
+
+    if (LALInferenceDEBufferInSync(thread)) {
+        for (i = 0; i < nPoints; i+=step)
+            memcpy(DEarray[i/step], LALInferenceDEBufferRow(thread->deBuffer, i), thread->deBuffer->nPar*sizeof(REAL8));
+        return nPoints/step;
+    }
+
     for (i = 0; i < nPoints; i+=step) {
         ptr=thread->differentialPoints[i]->head;
         p=0;
@@ -1609,6 +1789,140 @@ INT4 LALInferenceThinnedBufferToArray(LALInferenceThreadState *thread, REAL8** D
 }
 
 
+/* Differential evolution buffer kept as a row-major matrix */
+LALInferenceDEBuffer *LALInferenceCreateDEBuffer(LALInferenceVariables *params) {
+    LALInferenceVariableItem *item;
+    LALInferenceDEBuffer *buffer;
+    UINT4 p;
+
+    if (!params) XLAL_ERROR_NULL(XLAL_EFAULT, "Null params");
+
+    buffer = XLALCalloc(1, sizeof(*buffer));
+    if (!buffer) XLAL_ERROR_NULL(XLAL_ENOMEM);
+
+    for (item = params->head; item; item = item->next)
+        if (LALInferenceCheckVariableNonFixed(params, item->name) && item->type == LALINFERENCE_REAL8_t)
+            buffer->nPar++;
+
+    buffer->names = XLALCalloc(buffer->nPar ? buffer->nPar : 1, sizeof(char *));
+    buffer->size = 1;
+    buffer->data = XLALCalloc(buffer->size * (buffer->nPar ? buffer->nPar : 1), sizeof(REAL8));
+    if (!buffer->names || !buffer->data) {
+        LALInferenceDestroyDEBuffer(buffer);
+        XLAL_ERROR_NULL(XLAL_ENOMEM);
+    }
+
+    for (item = params->head, p = 0; item; item = item->next)
+        if (LALInferenceCheckVariableNonFixed(params, item->name) && item->type == LALINFERENCE_REAL8_t) {
+            buffer->names[p] = XLALStringDuplicate(item->name);
+            if (!buffer->names[p]) {
+                LALInferenceDestroyDEBuffer(buffer);
+                XLAL_ERROR_NULL(XLAL_EFUNC);
+            }
+            p++;
+        }
+
+    return buffer;
+}
+
+
+void LALInferenceDestroyDEBuffer(LALInferenceDEBuffer *buffer) {
+    UINT4 p;
+
+    if (!buffer)
+        return;
+
+    if (buffer->names)
+        for (p = 0; p < buffer->nPar; p++)
+            XLALFree(buffer->names[p]);
+    XLALFree(buffer->names);
+    XLALFree(buffer->data);
+    XLALFree(buffer);
+}
+
+
+int LALInferenceDEBufferAppend(LALInferenceDEBuffer *buffer, LALInferenceVariables *params) {
+    LALInferenceVariableItem *item;
+    REAL8 *row;
+    UINT4 p;
+
+    if (!buffer || !params) XLAL_ERROR(XLAL_EFAULT, "Null buffer or params");
+
+    if (buffer->length == buffer->size) {
+        size_t newSize = 2*buffer->size;
+        REAL8 *data = XLALRealloc(buffer->data, newSize * (buffer->nPar ? buffer->nPar : 1) * sizeof(REAL8));
+        if (!data) XLAL_ERROR(XLAL_ENOMEM);
+        buffer->data = data;
+        buffer->size = newSize;
+    }
+
+    row = LALInferenceDEBufferRow(buffer, buffer->length);
+    for (p = 0; p < buffer->nPar; p++) {
+        item = LALInferenceGetItem(params, buffer->names[p]);
+        if (!item || item->type != LALINFERENCE_REAL8_t)
+            XLAL_ERROR(XLAL_EINVAL, "Parameter %s is not a REAL8 variable of the sample", buffer->names[p]);
+        row[p] = *(REAL8 *)item->value;
+    }
+
+    buffer->length++;
+    return XLAL_SUCCESS;
+}
+
+
+void LALInferenceDEBufferThin(LALInferenceDEBuffer *buffer) {
+    size_t i;
+
+    if (!buffer)
+        return;
+
+    for (i = 1; i < buffer->length; i += 2)
+        memcpy(LALInferenceDEBufferRow(buffer, i/2), LALInferenceDEBufferRow(buffer, i), buffer->nPar*sizeof(REAL8));
+
+    buffer->length /= 2;
+}
+
+
+REAL8 *LALInferenceDEBufferRow(const LALInferenceDEBuffer *buffer, size_t i) {
+    return buffer->data + i*buffer->nPar;
+}
+
+
+INT4 LALInferenceDEBufferColumn(const LALInferenceDEBuffer *buffer, const char *name) {
+    UINT4 p;
+
+    for (p = 0; p < buffer->nPar; p++)
+        if (!strcmp(buffer->names[p], name))
+            return (INT4) p;
+
+    return -1;
+}
+
+
+int LALInferenceRebuildDEBuffer(LALInferenceThreadState *thread) {
+    size_t i;
+
+    LALInferenceDestroyDEBuffer(thread->deBuffer);
+    thread->deBuffer = LALInferenceCreateDEBuffer(thread->currentParams);
+    if (!thread->deBuffer)
+        XLAL_ERROR(XLAL_EFUNC);
+
+    for (i = 0; i < thread->differentialPointsLength; i++)
+        if (LALInferenceDEBufferAppend(thread->deBuffer, thread->differentialPoints[i]) != XLAL_SUCCESS) {
+            LALInferenceDestroyDEBuffer(thread->deBuffer);
+            thread->deBuffer = NULL;
+            XLAL_ERROR(XLAL_EFUNC);
+        }
+
+    return XLAL_SUCCESS;
+}
+
+
+int LALInferenceDEBufferInSync(const LALInferenceThreadState *thread) {
+    return thread->deBuffer != NULL && thread->differentialPoints != NULL &&
+           thread->deBuffer->length == thread->differentialPointsLength;
+}
+
+
 /* Move the entire buffer to an array */
 INT4 LALInferenceBufferToArray(LALInferenceThreadState *thread, REAL8** DEarray) {
     INT4 step = 1;
@@ -2336,34 +2650,130 @@ void LALInferenceLambdaTsEta2Lambdas(REAL8 lambdaT, REAL8 dLambdaT, REAL8 eta, R
   return;
 }
 
-/* Find lambda1,2(m1,2|eos) for 4-piece polytrope EOS model */
-void LALInferenceLogp1GammasMasses2Lambdas(REAL8 logp1,REAL8 gamma1,REAL8 gamma2,REAL8 gamma3, REAL8 mass1, REAL8 mass2, REAL8 *lambda1, REAL8 *lambda2){
+/* Cache of recently used equations of state and their neutron star families,
+ * keyed by the EOS model and its parameters, so that the prior check and the
+ * template of a sample (and successive samples with the same EOS) do not
+ * repeat the TOV integrations.  The cache itself is not thread safe, and
+ * chains are evaluated in parallel, so every thread has a cache of its own:
+ * a family looked up by one thread can then only be evicted by a later
+ * insertion from that same thread.  The per-thread caches are held under a
+ * pthread key whose destructor frees a thread's cache when the thread exits.
+ * Without pthreads the cache is only used in builds without OpenMP. */
+#define LALINFERENCE_EOS_FAMILY_CACHE_SIZE 8
+enum { LALINFERENCE_EOS_PIECEWISE_POLYTROPE, LALINFERENCE_EOS_SPECTRAL_DECOMPOSITION };
+#if defined(LAL_PTHREAD_LOCK)
+static pthread_key_t eosFamilyCacheKey;
+static pthread_once_t eosFamilyCacheOnce = PTHREAD_ONCE_INIT;
+static int eosFamilyCacheKeyCreated = 0;
+
+static void LALInferenceDestroyEOSFamilyCache(void *cache){
+XLALDestroySimNeutronStarFamilyCache(cache);
+}
+
+static void LALInferenceCreateEOSFamilyCacheKey(void){
+eosFamilyCacheKeyCreated = pthread_key_create(&eosFamilyCacheKey, LALInferenceDestroyEOSFamilyCache) == 0;
+}
+
+/* The calling thread's cache, created on first use; NULL if there is none */
+static LALSimNeutronStarFamilyCache *LALInferenceEOSFamilyCache(void){
+LALSimNeutronStarFamilyCache *cache;
+pthread_once(&eosFamilyCacheOnce, LALInferenceCreateEOSFamilyCacheKey);
+if (!eosFamilyCacheKeyCreated)
+  return NULL;
+cache = pthread_getspecific(eosFamilyCacheKey);
+if (!cache) {
+  cache = XLALCreateSimNeutronStarFamilyCache(LALINFERENCE_EOS_FAMILY_CACHE_SIZE, 0.0);
+  if (cache && pthread_setspecific(eosFamilyCacheKey, cache) != 0) {
+    XLALDestroySimNeutronStarFamilyCache(cache);
+    cache = NULL;
+  }
+}
+return cache;
+}
+#elif defined(_OPENMP)
+static LALSimNeutronStarFamilyCache *LALInferenceEOSFamilyCache(void){
+return NULL;
+}
+#else
+static LALSimNeutronStarFamilyCache *eosFamilyCache = NULL;
+
+static LALSimNeutronStarFamilyCache *LALInferenceEOSFamilyCache(void){
+if (!eosFamilyCache)
+  eosFamilyCache = XLALCreateSimNeutronStarFamilyCache(LALINFERENCE_EOS_FAMILY_CACHE_SIZE, 0.0);
+return eosFamilyCache;
+}
+#endif
+
+/* Look up an EOS of the given model and parameters in the cache, creating
+ * (but not caching) it on a miss; *fam is the cached family or NULL. */
+static LALSimNeutronStarEOS *LALInferenceCachedEOS(LALSimNeutronStarFamily **fam, double *key, int model, double params[], int size){
+int i;
+LALSimNeutronStarEOS *eos = NULL;
+LALSimNeutronStarFamilyCache *cache = LALInferenceEOSFamilyCache();
+
+key[0] = model;
+for (i = 0; i < size; ++i)
+  key[i + 1] = params[i];
+
+*fam = NULL;
+if (cache)
+  *fam = XLALSimNeutronStarFamilyCacheLookup(&eos, cache, key, size + 1);
+if (*fam)
+  return eos;
+
+if (model == LALINFERENCE_EOS_PIECEWISE_POLYTROPE)
+  eos = XLALSimNeutronStarEOS4ParameterPiecewisePolytrope(params[0], params[1], params[2], params[3]);
+else
+  eos = XLALSimNeutronStarEOSSpectralDecomposition(params, size);
+return eos;
+}
+
+/* Build the family of an EOS returned uncached by LALInferenceCachedEOS and
+ * hand both to the cache; if they cannot be cached they are returned in
+ * *owned_eos and *owned_fam for the caller to destroy. */
+static LALSimNeutronStarFamily *LALInferenceCacheEOSFamily(LALSimNeutronStarEOS *eos, double *key, int size, LALSimNeutronStarEOS **owned_eos, LALSimNeutronStarFamily **owned_fam){
+LALSimNeutronStarFamily *fam = XLALCreateSimNeutronStarFamily(eos);
+LALSimNeutronStarFamilyCache *cache = LALInferenceEOSFamilyCache();
+*owned_eos = eos;
+*owned_fam = fam;
+if (fam && cache && XLALSimNeutronStarFamilyCacheInsert(cache, key, size + 1, eos, fam) == XLAL_SUCCESS)
+  *owned_eos = NULL, *owned_fam = NULL;
+return fam;
+}
+
+/* Find lambda1,2(m1,2|eos) for an EOS model */
+static void LALInferenceEOSMasses2Lambdas(int model, double params[], int size, REAL8 mass1, REAL8 mass2, REAL8 *lambda1, REAL8 *lambda2){
 // Convert to SI
-REAL8 logp1_si=logp1-1.0;
 double mass1_kg=mass1*LAL_MSUN_SI;
 double mass2_kg=mass2*LAL_MSUN_SI;
+double key[size + 1];
 
-// Make eos
+// Make eos, or find it in the cache
 LALSimNeutronStarEOS *eos = NULL;
 LALSimNeutronStarFamily *fam = NULL;
-eos = XLALSimNeutronStarEOS4ParameterPiecewisePolytrope(logp1_si, gamma1, gamma2, gamma3);
-fam = XLALCreateSimNeutronStarFamily(eos);
+LALSimNeutronStarEOS *owned_eos = NULL;
+LALSimNeutronStarFamily *owned_fam = NULL;
+eos = LALInferenceCachedEOS(&fam, key, model, params, size);
+if (!fam)
+  fam = LALInferenceCacheEOSFamily(eos, key, size, &owned_eos, &owned_fam);
 
-// Calculate lambda1(m1|eos)
-double r = XLALSimNeutronStarRadius(mass1_kg, fam);
-double k = XLALSimNeutronStarLoveNumberK2(mass1_kg, fam);
-double c = mass1 * LAL_MRSUN_SI / r;
-*lambda1= (2.0/3.0) * k / pow(c , 5.0);
+// Calculate lambda1,2(m1,2|eos)
+*lambda1 = XLALSimNeutronStarTidalDeformability(mass1_kg, fam);
+*lambda2 = XLALSimNeutronStarTidalDeformability(mass2_kg, fam);
 
-// Calculate lambda2(m2|eos)
-r = XLALSimNeutronStarRadius(mass2_kg, fam);
-k = XLALSimNeutronStarLoveNumberK2(mass2_kg, fam);
-c = mass2 * LAL_MRSUN_SI / r;
-*lambda2= (2.0/3.0) * k / pow(c , 5.0);
+// Clean up anything the cache did not take
+XLALDestroySimNeutronStarFamily(owned_fam);
+if (owned_eos)
+  XLALDestroySimNeutronStarEOS(owned_eos);
+}
 
-// Clean up
-XLALDestroySimNeutronStarFamily(fam);
-XLALDestroySimNeutronStarEOS(eos);
+/* Find lambda1,2(m1,2|eos) for 4-piece polytrope EOS model */
+void LALInferenceLogp1GammasMasses2Lambdas(REAL8 logp1,REAL8 gamma1,REAL8 gamma2,REAL8 gamma3, REAL8 mass1, REAL8 mass2, REAL8 *lambda1, REAL8 *lambda2){
+// Convert to SI
+REAL8 logp1_si=logp1-1.0;
+double params[] = {logp1_si, gamma1, gamma2, gamma3};
+
+LALInferenceEOSMasses2Lambdas(LALINFERENCE_EOS_PIECEWISE_POLYTROPE, params, 4, mass1, mass2, lambda1, lambda2);
 }
 
 /* Find lambda1,2(m1,2|eos) for spectral EOS model */
@@ -2376,31 +2786,7 @@ if(LALInferenceSDGammaCheck(gamma, 4) == XLAL_FAILURE){
 }
 // Else calculate lambdas
 else{
-  // Convert to SI
-  double mass1_kg=mass1*LAL_MSUN_SI;
-  double mass2_kg=mass2*LAL_MSUN_SI;
-
-  // Make eos
-  LALSimNeutronStarEOS *eos = NULL;
-  LALSimNeutronStarFamily *fam = NULL;
-  eos = XLALSimNeutronStarEOSSpectralDecomposition(gamma,size);
-  fam = XLALCreateSimNeutronStarFamily(eos);
-
-  // Calculate lambda1(m1|eos)
-  double r = XLALSimNeutronStarRadius(mass1_kg, fam);
-  double k = XLALSimNeutronStarLoveNumberK2(mass1_kg, fam);
-  double c = mass1 * LAL_MRSUN_SI / r;
-  *lambda1= (2.0/3.0) * k / pow(c , 5.0);
-
-  // Calculate lambda2(m1|eos)
-  r = XLALSimNeutronStarRadius(mass2_kg, fam);
-  k = XLALSimNeutronStarLoveNumberK2(mass2_kg, fam);
-  c = mass2 * LAL_MRSUN_SI / r;
-  *lambda2= (2.0/3.0) * k / pow(c , 5.0);
-
-  // Clean up
-  XLALDestroySimNeutronStarFamily(fam);
-  XLALDestroySimNeutronStarEOS(eos);
+  LALInferenceEOSMasses2Lambdas(LALINFERENCE_EOS_SPECTRAL_DECOMPOSITION, gamma, size, mass1, mass2, lambda1, lambda2);
 }
 
 }
@@ -2412,6 +2798,9 @@ int ret;
 
 LALSimNeutronStarEOS *eos=NULL;
 LALSimNeutronStarFamily *fam=NULL;
+LALSimNeutronStarEOS *owned_eos=NULL;
+LALSimNeutronStarFamily *owned_fam=NULL;
+double key[5];
 
 // If using 4-piece polytrope eos params...
 if(LALInferenceCheckVariable(params, "logp1") && LALInferenceCheckVariable(params, "gamma1") && LALInferenceCheckVariable(params, "gamma2") && LALInferenceCheckVariable(params, "gamma3"))
@@ -2425,8 +2814,9 @@ if(LALInferenceCheckVariable(params, "logp1") && LALInferenceCheckVariable(param
   // Convert to SI
   REAL8 logp1_si=logp1-1.0;
 
-  // Make 4-piece polytrope eos
-  eos = XLALSimNeutronStarEOS4ParameterPiecewisePolytrope(logp1_si,gamma1,gamma2,gamma3);
+  // Make 4-piece polytrope eos, or find it in the cache
+  double eosparams[]={logp1_si,gamma1,gamma2,gamma3};
+  eos = LALInferenceCachedEOS(&fam, key, LALINFERENCE_EOS_PIECEWISE_POLYTROPE, eosparams, 4);
 
 // Else if using 4-coeff spectral eos params...
 }
@@ -2442,8 +2832,8 @@ else if( LALInferenceCheckVariable(params,"SDgamma0") && LALInferenceCheckVariab
   if(LALInferenceSDGammaCheck(gamma, 4) == XLAL_FAILURE)
     return XLAL_FAILURE;
 
-  // Make 4-piece polytrope eos
-  eos = XLALSimNeutronStarEOSSpectralDecomposition(gamma,4);
+  // Make spectral eos, or find it in the cache
+  eos = LALInferenceCachedEOS(&fam, key, LALINFERENCE_EOS_SPECTRAL_DECOMPOSITION, gamma, 4);
 
 }
 // Else fail, since you need an eos
@@ -2451,6 +2841,8 @@ else {
   fprintf(stdout,"NO EOS PARAMETERS FOUND\n");
   return XLAL_FAILURE;
 }
+if(!fam)
+  owned_eos = eos;
 
 /* FIXME: This is a little clunky,
   Check to make sure family will contain
@@ -2486,16 +2878,17 @@ for (int i = 0; i < 4; ++i) {
         fprintf(stdout,"spectral: %f %f %f %f\n",SDgamma0,SDgamma1,SDgamma2,SDgamma3);
       }
       // Clean up
-      XLALDestroySimNeutronStarFamily(fam);
-      XLALDestroySimNeutronStarEOS(eos);
+      XLALDestroySimNeutronStarFamily(owned_fam);
+      if(owned_eos) XLALDestroySimNeutronStarEOS(owned_eos);
       return XLAL_FAILURE;
     }
     mdat_prev = mdat;
 }
 
 
-// Make family
-fam = XLALCreateSimNeutronStarFamily(eos);
+// Make family, unless it was cached
+if(!fam)
+  fam = LALInferenceCacheEOSFamily(eos, key, 4, &owned_eos, &owned_fam);
 
 // Determine which mass parameterization is used
 double mass1 = 0.;
@@ -2523,8 +2916,8 @@ else {
   // Else fail
   fprintf(stdout,"ERROR: NO MASS PARAMETERS FOUND\n");
   // Clean up
-  XLALDestroySimNeutronStarFamily(fam);
-  XLALDestroySimNeutronStarEOS(eos);
+  XLALDestroySimNeutronStarFamily(owned_fam);
+  if(owned_eos) XLALDestroySimNeutronStarEOS(owned_eos);
   return XLAL_FAILURE;
 }
 
@@ -2560,8 +2953,8 @@ if(mass1_kg <= max_mass_kg && mass2_kg <= max_mass_kg && mass1_kg >= min_mass_kg
 }
 
 // Clean up
-XLALDestroySimNeutronStarFamily(fam);
-XLALDestroySimNeutronStarEOS(eos);
+XLALDestroySimNeutronStarFamily(owned_fam);
+if(owned_eos) XLALDestroySimNeutronStarEOS(owned_eos);
 return ret;
 }
 
@@ -4039,14 +4432,14 @@ void LALInferenceAddREAL8Variable(LALInferenceVariables * vars, const char * nam
 REAL8 LALInferenceGetREAL8Variable(LALInferenceVariables * vars, const char * name)
 /* Typed version of LALInferenceGetVariable for REAL8 values.*/
 {
+  /* One lookup for both the type check and the value */
+  LALInferenceVariableItem *item=LALInferenceGetItem(vars,name);
 
-  if(LALInferenceGetVariableType(vars,name)!=LALINFERENCE_REAL8_t){
+  if(!item || item->type!=LALINFERENCE_REAL8_t){
     XLAL_ERROR_REAL8(XLAL_ETYPE, "Entry \"%s\" not found or of wrong type.", name);
   }
 
-  REAL8* rvalue=(REAL8*)LALInferenceGetVariable(vars,name);
-
-  return *rvalue;
+  return *(REAL8 *)item->value;
 }
 
 void LALInferenceSetREAL8Variable(LALInferenceVariables* vars,const char* name,REAL8 value){
@@ -4330,6 +4723,136 @@ int LALInferenceSplineCalibrationFactor(REAL8Vector *logfreqs,
   }
 }
 
+LALInferenceSplineCalibrationBasis *LALInferenceCreateSplineCalibrationBasis(const REAL8Vector *logfreqs, REAL8 deltaF, UINT4 first, UINT4 last)
+{
+  XLAL_CHECK_NULL(logfreqs != NULL, XLAL_EFAULT);
+  /* Same minimum as the GSL cubic spline */
+  XLAL_CHECK_NULL(logfreqs->length >= 3, XLAL_EINVAL, "Need at least 3 spline nodes, got %u", logfreqs->length);
+  XLAL_CHECK_NULL(last >= first && deltaF > 0.0, XLAL_EINVAL);
+
+  const UINT4 N = logfreqs->length;
+  const REAL8 *x = logfreqs->data;
+  for (UINT4 n = 1; n < N; n++)
+    XLAL_CHECK_NULL(x[n] > x[n-1], XLAL_EINVAL, "Spline nodes must be increasing");
+
+  LALInferenceSplineCalibrationBasis *basis = XLALCalloc(1, sizeof(*basis));
+  XLAL_CHECK_NULL(basis != NULL, XLAL_ENOMEM);
+  basis->nNodes = N;
+  basis->first = first;
+  basis->length = last - first + 1;
+  basis->deltaF = deltaF;
+  basis->logfreqs = XLALMalloc(N*sizeof(REAL8));
+  basis->secondDerivs = XLALCalloc(N*N, sizeof(REAL8));
+  basis->interval = XLALCalloc(basis->length, sizeof(UINT4));
+  basis->coeffs = XLALCalloc(4*basis->length, sizeof(REAL8));
+  REAL8 *diag = XLALMalloc(N*sizeof(REAL8));
+  REAL8 *rhs = XLALMalloc(N*sizeof(REAL8));
+  if (!basis->logfreqs || !basis->secondDerivs || !basis->interval || !basis->coeffs || !diag || !rhs) {
+    XLALFree(diag);
+    XLALFree(rhs);
+    LALInferenceDestroySplineCalibrationBasis(basis);
+    XLAL_ERROR_NULL(XLAL_ENOMEM);
+  }
+  memcpy(basis->logfreqs, x, N*sizeof(REAL8));
+
+  /* Natural spline: M_0 = M_{N-1} = 0 and, for the interior nodes,
+     h_{n-1} M_{n-1} + 2 (h_{n-1} + h_n) M_n + h_n M_{n+1} = 6 ((y_{n+1} - y_n)/h_n - (y_n - y_{n-1})/h_{n-1}).
+     Column m of secondDerivs is the solution for y = e_m. */
+  for (UINT4 m = 0; m < N; m++) {
+    for (UINT4 n = 1; n < N - 1; n++) {
+      REAL8 hl = x[n] - x[n-1], hr = x[n+1] - x[n];
+      rhs[n] = 6.0*(((n + 1 == m) - (n == m))/hr - ((n == m) - (n - 1 == m))/hl);
+      diag[n] = 2.0*(hl + hr);
+    }
+    /* Tridiagonal forward elimination and back substitution */
+    for (UINT4 n = 2; n < N - 1; n++) {
+      REAL8 w = (x[n] - x[n-1])/diag[n-1];
+      diag[n] -= w*(x[n] - x[n-1]);
+      rhs[n] -= w*rhs[n-1];
+    }
+    REAL8 next = 0.0;
+    for (UINT4 n = N - 2; n >= 1; n--) {
+      next = (rhs[n] - (x[n+1] - x[n])*next)/diag[n];
+      basis->secondDerivs[n*N + m] = next;
+    }
+  }
+  XLALFree(diag);
+  XLALFree(rhs);
+
+  /* Same coverage test as LALInferenceSplineCalibrationFactor() */
+  REAL8 lowf = exp(x[0]);
+  REAL8 highf = exp(x[N-1]);
+  UINT4 n = 0;
+  for (UINT4 i = 0; i < basis->length; i++) {
+    REAL8 f = deltaF*(first + i);
+    if (f < lowf || f > highf) continue;
+    REAL8 logf = log(f);
+    while (n < N - 2 && logf > x[n+1]) n++;
+    REAL8 h = x[n+1] - x[n];
+    REAL8 A = (x[n+1] - logf)/h, B = 1.0 - A;
+    basis->interval[i] = n;
+    basis->coeffs[4*i] = A;
+    basis->coeffs[4*i+1] = B;
+    basis->coeffs[4*i+2] = (A*A*A - A)*h*h/6.0;
+    basis->coeffs[4*i+3] = (B*B*B - B)*h*h/6.0;
+  }
+
+  return basis;
+}
+
+void LALInferenceDestroySplineCalibrationBasis(LALInferenceSplineCalibrationBasis *basis)
+{
+  if (!basis) return;
+  XLALFree(basis->logfreqs);
+  XLALFree(basis->secondDerivs);
+  XLALFree(basis->interval);
+  XLALFree(basis->coeffs);
+  XLALFree(basis);
+}
+
+int LALInferenceSplineCalibrationBasisMatches(const LALInferenceSplineCalibrationBasis *basis, const REAL8Vector *logfreqs, REAL8 deltaF, UINT4 first, UINT4 last)
+{
+  if (!basis || !logfreqs || basis->nNodes != logfreqs->length) return 0;
+  if (basis->deltaF != deltaF || basis->first != first || basis->length != last - first + 1) return 0;
+  return !memcmp(basis->logfreqs, logfreqs->data, basis->nNodes*sizeof(REAL8));
+}
+
+int LALInferenceSplineCalibrationNodeValues(const LALInferenceSplineCalibrationBasis *basis, const REAL8Vector *values, REAL8 *nodeValues)
+{
+  XLAL_CHECK(basis != NULL && values != NULL && nodeValues != NULL, XLAL_EFAULT);
+  XLAL_CHECK(values->length == basis->nNodes, XLAL_EINVAL, "input lengths differ");
+  const UINT4 N = basis->nNodes;
+  for (UINT4 n = 0; n < N; n++) {
+    REAL8 M = 0.0;
+    for (UINT4 m = 0; m < N; m++) M += basis->secondDerivs[n*N + m]*values->data[m];
+    nodeValues[n] = values->data[n];
+    nodeValues[N + n] = M;
+  }
+  return XLAL_SUCCESS;
+}
+
+int LALInferenceSplineCalibrationFactorFromBasis(const LALInferenceSplineCalibrationBasis *basis,
+					REAL8Vector *deltaAmps,
+					REAL8Vector *deltaPhases,
+					COMPLEX16FrequencySeries *calFactor)
+{
+  XLAL_CHECK(basis != NULL && calFactor != NULL, XLAL_EFAULT);
+  XLAL_CHECK(basis->first + basis->length <= calFactor->data->length, XLAL_EINVAL, "calibration factor series too short");
+  const UINT4 N = basis->nNodes;
+  REAL8 ampNodes[2*N], phaseNodes[2*N];
+  XLAL_CHECK(LALInferenceSplineCalibrationNodeValues(basis, deltaAmps, ampNodes) == XLAL_SUCCESS, XLAL_EFUNC);
+  XLAL_CHECK(LALInferenceSplineCalibrationNodeValues(basis, deltaPhases, phaseNodes) == XLAL_SUCCESS, XLAL_EFUNC);
+
+  for (UINT4 i = 0; i < basis->length; i++) {
+    const REAL8 *c = &(basis->coeffs[4*i]);
+    UINT4 n = basis->interval[i];
+    REAL8 dA = c[0]*ampNodes[n] + c[1]*ampNodes[n+1] + c[2]*ampNodes[N+n] + c[3]*ampNodes[N+n+1];
+    REAL8 dPhi = c[0]*phaseNodes[n] + c[1]*phaseNodes[n+1] + c[2]*phaseNodes[N+n] + c[3]*phaseNodes[N+n+1];
+    calFactor->data->data[basis->first + i] = (1.0 + dA)*((4.0 - dPhi*dPhi) + 4.0*I*dPhi)/(4.0 + dPhi*dPhi);
+  }
+  return XLAL_SUCCESS;
+}
+
 int LALInferenceSplineCalibrationFactorROQ(REAL8Vector *logfreqs,
 					REAL8Vector *deltaAmps,
 					REAL8Vector *deltaPhases,
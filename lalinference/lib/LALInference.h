@@ -164,6 +164,12 @@ tagVariableItem
  * The LALInferenceVariables structure to contain a set of parameters
  * Implemented as a linked list of LALInferenceVariableItems.
  * Should only be accessed using the accessor functions below
+ *
+ * Once the parameter set is fixed, LALInferenceCompileVariables() can move
+ * the REAL8 values into the flat array \c compiled, one slot per variable.
+ * The items then point into that array, so the name-based accessors keep
+ * working, while hot loops can resolve a name to a slot once with
+ * LALInferenceGetVariableSlot() and use the slot accessors afterwards.
  */
 typedef struct
 tagLALInferenceVariables
@@ -171,6 +177,9 @@ tagLALInferenceVariables
   LALInferenceVariableItem	*head;
   INT4 				dimension;
   LALHashTbl        *hash_table;
+  REAL8             *compiled; /** Flat storage of the REAL8 values, or NULL if not compiled */
+  LALInferenceVariableItem **slots; /** Item stored in each slot of compiled (NULL if removed) */
+  INT4              nslots; /** Number of slots in compiled */
 } LALInferenceVariables;
 
 /**
@@ -308,9 +317,31 @@ int LALInferenceCheckVariableToPrint(LALInferenceVariables *vars, const char *na
  */
 void LALInferenceClearVariables(LALInferenceVariables *vars);
 
-/** Deep copy the variables from one to another LALInferenceVariables structure */
+/**
+ * Deep copy the variables from one to another LALInferenceVariables structure.
+ * If \c target already holds the same variables, in the same order, the values
+ * are copied in place; otherwise it is rebuilt. A compiled \c origin gives a
+ * compiled \c target.
+ */
 void LALInferenceCopyVariables(LALInferenceVariables *origin, LALInferenceVariables *target);
 
+/**
+ * Move the REAL8 values of \c vars into one flat array, assigning each a slot
+ * in list order. Variables added later are stored as usual and get no slot;
+ * recompile after changing the parameter set. Returns XLAL_SUCCESS or an
+ * XLAL error code.
+ */
+int LALInferenceCompileVariables(LALInferenceVariables *vars);
+
+/** Slot of the REAL8 variable \c name in compiled \c vars, or -1 if it has none */
+INT4 LALInferenceGetVariableSlot(const LALInferenceVariables *vars, const char *name);
+
+/** Value in slot \c slot of compiled \c vars */
+REAL8 LALInferenceGetREAL8VariableBySlot(const LALInferenceVariables *vars, INT4 slot);
+
+/** Set the value in slot \c slot of compiled \c vars, unless that variable is fixed */
+void LALInferenceSetREAL8VariableBySlot(LALInferenceVariables *vars, INT4 slot, REAL8 value);
+
 /*  Copy REAL8s from "origin" to "target" if they weren't set on the command line */
 void LALInferenceCopyUnsetREAL8Variables(LALInferenceVariables *origin, LALInferenceVariables *target, ProcessParamsTable *commandLine);
 
@@ -366,6 +397,46 @@ int LALInferenceSplineCalibrationFactorROQ(REAL8Vector *logfreqs,
 					REAL8Sequence *freqNodesQuad,
 					COMPLEX16Sequence **calFactorROQQuad);
 
+/**
+ * Cubic spline calibration basis precomputed for a fixed set of spline
+ * nodes on a range of frequency bins.  The spline through values
+ * \f$y_n\f$ at the nodes is linear in \f$y_n\f$ and in the second
+ * derivatives \f$M_n = \sum_m G_{nm} y_m\f$, so at each bin it is
+ * a sum of four terms with fixed weights.  Evaluating the calibration
+ * factors then involves no spline construction, and can be done in
+ * the same pass as the template multiply.
+ */
+typedef struct tagLALInferenceSplineCalibrationBasis
+{
+  UINT4 nNodes;         /** Number of spline nodes */
+  REAL8 *logfreqs;      /** Log-frequencies of the nodes the basis was built for */
+  REAL8 *secondDerivs;  /** nNodes x nNodes matrix taking node values to the natural spline second derivatives */
+  UINT4 first;          /** First frequency bin covered */
+  UINT4 length;         /** Number of frequency bins covered */
+  REAL8 deltaF;         /** Frequency spacing of the bins */
+  UINT4 *interval;      /** Spline interval n of each bin */
+  REAL8 *coeffs;        /** Weights of y_n, y_{n+1}, M_n, M_{n+1} for each bin (zero outside the nodes) */
+} LALInferenceSplineCalibrationBasis;
+
+/** Build the spline calibration basis for nodes at logfreqs on bins first to last of spacing deltaF */
+LALInferenceSplineCalibrationBasis *LALInferenceCreateSplineCalibrationBasis(const REAL8Vector *logfreqs, REAL8 deltaF, UINT4 first, UINT4 last);
+
+/** Free a spline calibration basis */
+void LALInferenceDestroySplineCalibrationBasis(LALInferenceSplineCalibrationBasis *basis);
+
+/** Check whether basis was built for the nodes logfreqs and the bins first to last of spacing deltaF */
+int LALInferenceSplineCalibrationBasisMatches(const LALInferenceSplineCalibrationBasis *basis, const REAL8Vector *logfreqs, REAL8 deltaF, UINT4 first, UINT4 last);
+
+/** Fill nodeValues (length 2*nNodes) with the values followed by the spline second derivatives at the nodes */
+int LALInferenceSplineCalibrationNodeValues(const LALInferenceSplineCalibrationBasis *basis, const REAL8Vector *values, REAL8 *nodeValues);
+
+/** Calibration factors for bins first to last from a basis, equivalent to
+ * LALInferenceSplineCalibrationFactor() on those bins */
+int LALInferenceSplineCalibrationFactorFromBasis(const LALInferenceSplineCalibrationBasis *basis,
+					REAL8Vector *deltaAmps,
+					REAL8Vector *deltaPhases,
+					COMPLEX16FrequencySeries *calFactor);
+
 
 //Wrapper for template computation
 //(relies on LAL libraries for implementation) <- could be a #DEFINE ?
@@ -462,6 +533,8 @@ typedef struct tagLALInferenceModel
   REAL8                        padding; /** The padding of the above window */
   struct tagLALInferenceROQModel *roq; /** ROQ data */
   int roq_flag;               /** Is ROQ enabled */
+  struct tagLALInferenceMultibandModel *mb; /** Multibanded likelihood data */
+  int mb_flag;                /** Is the multibanded likelihood enabled */
   LALSimNeutronStarFamily     *eos_fam; /** Neutron Star equation of state family */
 
 } LALInferenceModel;
@@ -533,6 +606,23 @@ tagLALInferenceProposalCycle
     LALInferenceVariables *proposalArgs; /** Storage for arguments needed by proposal functions (e.g. number of detectors) */
 } LALInferenceProposalCycle;
 
+/**
+ * Struct-of-arrays copy of the differential evolution buffer.
+ * Row i holds the varying REAL8 parameters of differentialPoints[i], one
+ * column per entry of names, so that the differential evolution and ensemble
+ * proposals can work on contiguous rows instead of looking up each parameter
+ * by name in every buffered LALInferenceVariables.
+ */
+typedef struct
+tagLALInferenceDEBuffer
+{
+    UINT4 nPar; /** Number of columns */
+    char **names; /** Parameter name of each column */
+    REAL8 *data; /** Row-major matrix of size rows of nPar values */
+    size_t length; /** Number of rows in use */
+    size_t size; /** Number of rows allocated */
+} LALInferenceDEBuffer;
+
 /**
  * Structure containing chain-specific variables
  */
@@ -565,6 +655,8 @@ tagLALInferenceThreadState
                                         Can also be removed. */
     size_t differentialPointsSkip; /** When the DE buffer gets too long, start storing
                                        only every n-th output point; this counter stores n */
+    LALInferenceDEBuffer *deBuffer; /** Matrix copy of differentialPoints, used by the proposals
+                                        when its length matches differentialPointsLength */
     REAL8 *currentIFOSNRs; /** Array storing single-IFO SNRs of current sample */
     REAL8 *currentIFOLikelihoods; /** Array storing single-IFO likelihoods of current sample */
     REAL8 currentSNR; /** Array storing network SNR of current sample */
@@ -655,6 +747,8 @@ tagLALInferenceIFOData
   UINT4                     likeli_counter; /** counts how many time the likelihood has been calculated */
   UINT4                     templa_counter; /** counts how many time the template has been calculated */
   struct tagLALInferenceROQData *roq; /** ROQ data */
+  struct tagLALInferenceMultibandData *mb; /** Multibanded likelihood weights */
+  struct tagLALInferenceSplineCalibrationBasis *calBasis; /** Spline calibration basis on the likelihood bins */
 
   struct tagLALInferenceIFOData      *next;     /** A pointer to the next set of data for linked list */
 } LALInferenceIFOData;
@@ -730,6 +824,30 @@ tagLALInferenceROQModel
 
 } LALInferenceROQModel;
 
+/**
+ * Structure to contain model-related multibanded likelihood quantities
+ */
+typedef struct
+tagLALInferenceMultibandModel
+{
+  COMPLEX16FrequencySeries *hptilde; /** waveform at the band nodes */
+  COMPLEX16FrequencySeries *hctilde;
+  COMPLEX16Sequence *calFactor; /** calibration factors at the band nodes */
+  REAL8Sequence *frequencies; /** sorted union of the frequency nodes of all bands */
+  UINT4 nBands;
+} LALInferenceMultibandModel;
+
+/**
+ * Structure to contain data-related multibanded likelihood quantities
+ */
+typedef struct
+tagLALInferenceMultibandData
+{
+  COMPLEX16 *weightsLinear; /** weights for <d|h> at the band nodes, band windows included */
+  REAL8 *weightsQuadratic; /** weights for <h|h>, from linear interpolation of |h|^2 between the band nodes */
+  UINT4 length; /** number of band nodes */
+} LALInferenceMultibandData;
+
 /**
  * Structure to contain data-related Reduced Order Quadrature quantities
  */
@@ -841,6 +959,37 @@ void LALInferenceSortVariablesByName(LALInferenceVariables *vars);
 INT4 LALInferenceThinnedBufferToArray(LALInferenceThreadState *thread, REAL8** DEarray, INT4 step);
 INT4 LALInferenceBufferToArray(LALInferenceThreadState *thread, REAL8** DEarray);
 
+/**
+ * Create an empty differential evolution matrix whose columns are the varying
+ * REAL8 parameters of params, in the order they appear there.
+ */
+LALInferenceDEBuffer *LALInferenceCreateDEBuffer(LALInferenceVariables *params);
+
+/** Free a differential evolution matrix */
+void LALInferenceDestroyDEBuffer(LALInferenceDEBuffer *buffer);
+
+/** Append the column parameters of params as a new row. Fails if one is missing. */
+int LALInferenceDEBufferAppend(LALInferenceDEBuffer *buffer, LALInferenceVariables *params);
+
+/** Keep only the odd rows, matching the thinning of the differentialPoints array */
+void LALInferenceDEBufferThin(LALInferenceDEBuffer *buffer);
+
+/** Column index of the named parameter, or -1 if it is not a column */
+INT4 LALInferenceDEBufferColumn(const LALInferenceDEBuffer *buffer, const char *name);
+
+/** Row i of the matrix */
+REAL8 *LALInferenceDEBufferRow(const LALInferenceDEBuffer *buffer, size_t i);
+
+/**
+ * (Re)build thread->deBuffer from thread->currentParams and the points in
+ * thread->differentialPoints. On failure the matrix is dropped and the
+ * proposals fall back to the LALInferenceVariables buffer.
+ */
+int LALInferenceRebuildDEBuffer(LALInferenceThreadState *thread);
+
+/** Non-zero if thread->deBuffer mirrors the current differential evolution buffer */
+int LALInferenceDEBufferInSync(const LALInferenceThreadState *thread);
+
 /** LALInference variables to an array, and vica versa */
 void LALInferenceCopyVariablesToArray(LALInferenceVariables *origin, REAL8 *target);
 
@@ -611,7 +611,10 @@ LALInferenceKmeans *LALInferenceCreateKmeans(INT4 k,
 
 
 /**
- * A 'k-means++'-like seeded initialization of centroids for a kmeans run.
+ * A 'k-means++' seeded initialization of centroids for a kmeans run.
+ *
+ * Each new centroid is drawn from the data with probability proportional to
+ *  the distance to the closest centroid already chosen.
  * @param kmeans The kmeans to initialize the centroids of.
  */
 void LALInferenceKmeansSeededInitialize(LALInferenceKmeans *kmeans) {
@@ -620,8 +623,10 @@ void LALInferenceKmeansSeededInitialize(LALInferenceKmeans *kmeans) {
     REAL8 dist, norm, randomDraw;
     gsl_vector_view c, x;
 
-    gsl_vector *dists = gsl_vector_alloc(kmeans->npts);
-    gsl_permutation *p = gsl_permutation_alloc(kmeans->npts);
+    /* Distance from each point to its closest centroid so far */
+    REAL8 *dists = XLALMalloc(kmeans->npts * sizeof(REAL8));
+    for (i = 0; i < kmeans->npts; i++)
+        dists[i] = INFINITY;
 
     /* Choose first centroid randomly from data */
     i = gsl_rng_uniform_int(kmeans->rng, kmeans->npts);
@@ -632,37 +637,41 @@ void LALInferenceKmeansSeededInitialize(LALInferenceKmeans *kmeans) {
 
     u++;
     while (u < kmeans->k) {
-        /* Calculate distances from centroid */
+        /* Update distances with the newest centroid */
         norm = 0.0;
         c = gsl_matrix_row(kmeans->centroids, u-1);
         for (i = 0; i < kmeans->npts; i++) {
             x = gsl_matrix_row(kmeans->data, i);
             dist = kmeans->dist(&x.vector, &c.vector);
 
-            gsl_vector_set(dists, i, dist);
-            norm += dist;
+            if (dist < dists[i])
+                dists[i] = dist;
+            norm += dists[i];
         }
 
-        gsl_vector_scale(dists, 1.0/norm);
-        gsl_sort_vector_index(p, dists);
+        randomDraw = norm * gsl_rng_uniform(kmeans->rng);
 
-        randomDraw = gsl_rng_uniform(kmeans->rng);
-
-        i = 0;
-        dist = gsl_vector_get(dists, p->data[i]);
-        while (dist < randomDraw) {
-            i++;
-            dist += gsl_vector_get(dists, p->data[i]);
+        /* Walk the cumulative distribution, stopping at the last point
+         * with non-zero weight in case of round-off */
+        INT4 chosen = 0;
+        dist = 0.0;
+        for (i = 0; i < kmeans->npts; i++) {
+            if (dists[i] > 0.0) {
+                chosen = i;
+                dist += dists[i];
+                if (dist > randomDraw)
+                    break;
+            }
         }
 
         for (j = 0; j < kmeans->dim; j++)
             gsl_matrix_set(kmeans->centroids, u, j,
-                            gsl_matrix_get(kmeans->data, i, j));
+                            gsl_matrix_get(kmeans->data, chosen, j));
 
         u++;
     }
 
-    gsl_permutation_free(p);
+    XLALFree(dists);
 }
 
 
@@ -716,10 +725,15 @@ void LALInferenceKmeansRandomPartitionInitialize(LALInferenceKmeans *kmeans) {
  * @param kmeans The kmeans to perform the assignment step on.
  */
 void LALInferenceKmeansAssignment(LALInferenceKmeans *kmeans) {
-    INT4 i, j;
-
-    kmeans->error = 0.;
-
+    INT4 i;
+    REAL8 error = 0.;
+    INT4 changed = 0;
+    REAL8 *best_dists = XLALMalloc(kmeans->npts * sizeof(REAL8));
+
+    /* Points are independent, so assign them in parallel.  The error is
+     * summed afterwards in point order so it does not depend on the number
+     * of threads. */
+    #pragma omp parallel for schedule(static) reduction(+:changed)
     for (i = 0; i < kmeans->npts; i++) {
         gsl_vector_view x = gsl_matrix_row(kmeans->data, i);
         gsl_vector_view c;
@@ -727,6 +741,7 @@ void LALInferenceKmeansAssignment(LALInferenceKmeans *kmeans) {
         INT4 best_cluster = 0;
         REAL8 best_dist = INFINITY;
         REAL8 dist;
+        INT4 j;
 
         /* Find the closest centroid */
         for (j = 0; j < kmeans->k; j++) {
@@ -742,12 +757,20 @@ void LALInferenceKmeansAssignment(LALInferenceKmeans *kmeans) {
         /* Check if the point's assignment has changed */
         INT4 current_cluster = kmeans->assignments[i];
         if (best_cluster != current_cluster) {
-            kmeans->has_changed = 1;
+            changed++;
             kmeans->assignments[i] = best_cluster;
         }
-        kmeans->error += best_dist;
+        best_dists[i] = best_dist;
     }
 
+    for (i = 0; i < kmeans->npts; i++)
+        error += best_dists[i];
+    XLALFree(best_dists);
+
+    kmeans->error = error;
+    if (changed)
+        kmeans->has_changed = 1;
+
     /* Recalculate cluster sizes */
     for (i = 0; i < kmeans->k; i++)
         kmeans->sizes[i] = 0;
@@ -764,7 +787,30 @@ void LALInferenceKmeansAssignment(LALInferenceKmeans *kmeans) {
  * @param kmeans The kmeans to perform the update step on.
  */
 void LALInferenceKmeansUpdate(LALInferenceKmeans *kmeans) {
-    INT4 i;
+    INT4 i, j;
+
+    /* Euclidean centroids can be accumulated for every cluster in a single
+     * pass over the data, rather than one masked pass per cluster */
+    if (kmeans->centroid == &euclidean_centroid) {
+        INT4 *counts = XLALCalloc(kmeans->k, sizeof(INT4));
+
+        gsl_matrix_set_zero(kmeans->centroids);
+        for (i = 0; i < kmeans->npts; i++) {
+            INT4 cluster_id = kmeans->assignments[i];
+            for (j = 0; j < kmeans->dim; j++)
+                *gsl_matrix_ptr(kmeans->centroids, cluster_id, j) +=
+                    gsl_matrix_get(kmeans->data, i, j);
+            counts[cluster_id]++;
+        }
+
+        for (i = 0; i < kmeans->k; i++) {
+            gsl_vector_view c = gsl_matrix_row(kmeans->centroids, i);
+            gsl_vector_scale(&c.vector, 1./counts[i]);
+        }
+
+        XLALFree(counts);
+        return;
+    }
 
     for (i = 0; i < kmeans->k; i ++) {
         LALInferenceKmeansConstructMask(kmeans, kmeans->mask, i);
@@ -57,29 +57,26 @@ void complex_normalise_training_set(gsl_vector *weight, gsl_matrix_complex *TS);
 double normalisation(const gsl_vector *weight, gsl_vector *a);
 double complex_normalisation(const gsl_vector *weight, gsl_vector_complex *a);
 
-void modified_gs_complex(gsl_vector_complex *ru,
-                 gsl_vector_complex *ortho_basis,
-                 const gsl_matrix_complex *RB_space,
-                 const gsl_vector *wQuad,
-                 const int dim_RB);
-
-void iterated_modified_gm_complex(gsl_vector_complex *ru,
-                                  gsl_vector_complex *ortho_basis,
-                                  const gsl_matrix_complex *RB_space,
-                                  const gsl_vector *wQuad,
-                                  const int dim_RB);
-
-void modified_gs(gsl_vector *ru,
-                 gsl_vector *ortho_basis,
-                 const gsl_matrix *RB_space,
-                 const gsl_vector *wQuad,
-                 const int dim_RB);
-
-void iterated_modified_gm(gsl_vector *ru,
-                          gsl_vector *ortho_basis,
-                          const gsl_matrix *RB_space,
-                          const gsl_vector *wQuad,
-                          const int dim_RB);
+/* number of vectors processed together in the blocked BLAS calls */
+#define ROQ_BLOCK_SIZE 64
+
+/* a real or complex (with interleaved real and imaginary parts) training set held in
+ * single or double precision */
+typedef struct tagROQTrainingSet{
+  void *data;     /* the row-major training set */
+  size_t rows;    /* the number of training waveforms */
+  size_t cols;    /* the number of points in each waveform */
+  UINT4 ncomp;    /* 1 for real and 2 for complex waveforms */
+  UINT4 single;   /* non-zero if the training set is stored in single precision */
+} ROQTrainingSet;
+
+/* the greedy reduced basis generation used for all the training set types */
+static REAL8 roq_greedy_basis(ROQTrainingSet *ts,
+                              const REAL8Vector *delta,
+                              REAL8 tolerance,
+                              REAL8 **RBout,
+                              UINT4 *nRB,
+                              UINT4Vector **greedypoints);
 
 /* get the B_matrix */
 REAL8Array *B_matrix(gsl_matrix *V, gsl_matrix *RB);
@@ -504,347 +501,339 @@ int complex_vector_maxabs_index( gsl_vector_complex *c ){
 }
 
 
-/** \brief Modified Gram-Schmidt algorithm for complex data
+/** \brief Get a row of the training set as a double precision vector
  *
- * A modified Gram-Schmidt algorithm taken from the
- * <a href="https://bitbucket.org/sfield83/greedycpp">greedycpp</a> code.
- *
- * @param[out] ru A 1-by-(\c dim_RB + 1) complex vector returning a slice of the R matrix 
- * @param[out] ortho_basis A complex vector returning the orthogonal basis vector
- * @param[in] RB_space A complex matrix containing the existing set of orthonormal basis vectors
- * @param[in] wQuad A vector of weights for the inner products
- * @param[in] dim_RB The number of elements in the current \c RB_space
+ * @param[in] ts The training set
+ * @param[in] row The row to return
+ * @param[out] out A vector of length \c ncomp x \c cols to hold the row
  */
-void modified_gs_complex(gsl_vector_complex *ru,
-                         gsl_vector_complex *ortho_basis,
-                         const gsl_matrix_complex *RB_space,
-                         const gsl_vector *wQuad,
-                         const int dim_RB){
-  INT4 quad_num = RB_space->size2;
-  gsl_complex L2_proj;
-  gsl_vector_complex *basis;
-
-  basis = gsl_vector_complex_alloc(quad_num);
-
-  /* if not done, R matrix fills up below diagonal with .5 instead of 0 */
-  gsl_vector_complex_set_zero(ru); 
-
-  for(INT4 i = 0; i < dim_RB; i++){
-    gsl_matrix_complex_get_row(basis, RB_space, i);
-
-    /* ortho_basis = ortho_basis - L2_proj*basis; */
-    L2_proj = complex_weighted_dot_product(wQuad, basis, ortho_basis);
-    gsl_vector_complex_set(ru, i, L2_proj);
-    gsl_vector_complex_scale(basis, L2_proj); /* basis <- basis*L2_proj */
-    gsl_vector_complex_sub(ortho_basis, basis); /* ortho <- ortho - basis */
-  }
-
-  double nrm = complex_normalisation(wQuad, ortho_basis);
-  gsl_complex nrmc;
-  GSL_SET_COMPLEX(&nrmc, nrm, 0.0);
-  gsl_vector_complex_set(ru, dim_RB, nrmc);
-
-  complex_normalise(wQuad, ortho_basis);
+static void roq_training_set_row(const ROQTrainingSet *ts, size_t row, REAL8 *out){
+  size_t n = ts->ncomp*ts->cols;
 
-  gsl_vector_complex_free(basis);
+  if ( ts->single ){
+    const REAL4 *in = (const REAL4 *)ts->data + row*n;
+    for ( size_t j = 0; j < n; j++ ){ out[j] = (REAL8)in[j]; }
+  }
+  else{
+    memcpy(out, (const REAL8 *)ts->data + row*n, n*sizeof(REAL8));
+  }
 }
 
 
-/** \brief Modified Gram-Schmidt algorithm for real data
+/** \brief The weighted norm of a row of the training set
  *
- * A modified Gram-Schmidt algorithm taken from the
- * <a href="https://bitbucket.org/sfield83/greedycpp">greedycpp</a> code.
+ * @param[in] ts The training set
+ * @param[in] row The row of the training set
+ * @param[in] w The weight for each waveform point
  *
- * @param[out] ru A 1-by-(\c dim_RB + 1) vector returning a slice of the R matrix 
- * @param[out] ortho_basis A vector returning the orthogonal basis vector
- * @param[in] RB_space A matrix containing the existing set of orthonormal basis vectors
- * @param[in] wQuad A vector of weights for the inner products
- * @param[in] dim_RB The number of elements in the current \c RB_space
+ * @return The weighted norm of the row
  */
-void modified_gs(gsl_vector *ru,
-                 gsl_vector *ortho_basis,
-                 const gsl_matrix *RB_space,
-                 const gsl_vector *wQuad,
-                 const int dim_RB){
-  INT4 quad_num = RB_space->size2;
-  REAL8 L2_proj;
-  gsl_vector *basis;
-
-  basis = gsl_vector_alloc(quad_num);
-
-  /* if not done, R matrix fills up below diagonal with .5 instead of 0 */
-  gsl_vector_set_zero(ru); 
-
-  for(INT4 i = 0; i < dim_RB; i++){
-    gsl_matrix_get_row(basis, RB_space, i);
-
-    /* ortho_basis = ortho_basis - L2_proj*basis; */
-    L2_proj = weighted_dot_product(wQuad, basis, ortho_basis);
-    gsl_vector_set(ru, i, L2_proj);
-    gsl_vector_scale(basis, L2_proj); /* basis <- basis*L2_proj */
-    gsl_vector_sub(ortho_basis, basis); /* ortho <- ortho - basis */
+static REAL8 roq_training_set_row_norm(const ROQTrainingSet *ts, size_t row, const REAL8 *w){
+  size_t nc = ts->ncomp, n = nc*ts->cols;
+  REAL8 norm2 = 0.;
+
+  if ( ts->single ){
+    const REAL4 *t = (const REAL4 *)ts->data + row*n;
+    for ( size_t j = 0; j < ts->cols; j++ ){
+      for ( size_t c = 0; c < nc; c++ ){ norm2 += w[j]*(REAL8)t[nc*j+c]*(REAL8)t[nc*j+c]; }
+    }
+  }
+  else{
+    const REAL8 *t = (const REAL8 *)ts->data + row*n;
+    for ( size_t j = 0; j < ts->cols; j++ ){
+      for ( size_t c = 0; c < nc; c++ ){ norm2 += w[j]*t[nc*j+c]*t[nc*j+c]; }
+    }
   }
 
-  double nrm = normalisation(wQuad, ortho_basis);
-  gsl_vector_set(ru, dim_RB, nrm);
+  return sqrt(norm2);
+}
 
-  normalise(wQuad, ortho_basis);
 
-  gsl_vector_free(basis);
+/** \brief Scale a row of the training set
+ *
+ * @param[in] ts The training set
+ * @param[in] row The row of the training set to scale
+ * @param[in] scale The scale factor
+ */
+static void roq_training_set_row_scale(ROQTrainingSet *ts, size_t row, REAL8 scale){
+  size_t n = ts->ncomp*ts->cols;
+
+  if ( ts->single ){
+    REAL4 *t = (REAL4 *)ts->data + row*n;
+    for ( size_t j = 0; j < n; j++ ){ t[j] = (REAL4)(scale*(REAL8)t[j]); }
+  }
+  else{
+    REAL8 *t = (REAL8 *)ts->data + row*n;
+    for ( size_t j = 0; j < n; j++ ){ t[j] *= scale; }
+  }
 }
 
 
-/** \brief Iterated modified Gram-Schmidt algorithm for complex data
+/** \brief Project a row of the training set onto a basis vector
  *
- * An iterated modified Gram-Schmidt algorithm taken from the
- * <a href="https://bitbucket.org/sfield83/greedycpp">greedycpp</a> code. This uses the method
- * given in \cite Hoffmann1989
+ * The projection is accumulated in double precision whatever the precision of the training set.
  *
- * @param[out] ru A complex 1-by-(\c dim_RB + 1) vector returning a slice of the R matrix 
- * @param[out] ortho_basis A complex vector returning the orthogonal basis vector
- * @param[in] RB_space A complex matrix containing the existing set of orthonormal basis vectors
- * @param[in] wQuad A vector of weights for the inner products
- * @param[in] dim_RB The number of elements in the current \c RB_space
+ * @param[in] ts The training set
+ * @param[in] row The row of the training set
+ * @param[in] wb The complex conjugate of the basis vector multiplied by the weights
+ * @param[out] re The real part of the projection
+ * @param[out] im The imaginary part of the projection (zero for real training sets)
  */
-void iterated_modified_gm_complex(gsl_vector_complex *ru,
-                                  gsl_vector_complex *ortho_basis,
-                                  const gsl_matrix_complex *RB_space,
-                                  const gsl_vector *wQuad,
-                                  const int dim_RB){
-  REAL8 ortho_condition = .5; /* hard coded IMGS stopping condition */
-
-  INT4 quad_num = RB_space->size2;
-  INT4 r_size = ru->size;
-  REAL8 nrm_prev = complex_normalisation(wQuad, ortho_basis);
-  UINT4 flag = 0, iter = 0;
-  gsl_vector_complex *e,*r_last;
-  REAL8 nrm_current = 0.;
-  gsl_complex nrmc_current;
-
-  /* allocate memory */
-  e = gsl_vector_complex_alloc(quad_num);
-  r_last = gsl_vector_complex_alloc(r_size);
+static void roq_training_set_row_projection(const ROQTrainingSet *ts, size_t row, const REAL8 *wb, REAL8 *re, REAL8 *im){
+  size_t cols = ts->cols, n = ts->ncomp*cols;
+  REAL8 sre = 0., sim = 0.;
+
+  if ( ts->ncomp == 1 ){
+    if ( ts->single ){
+      const REAL4 *t = (const REAL4 *)ts->data + row*n;
+      for ( size_t j = 0; j < cols; j++ ){ sre += wb[j]*(REAL8)t[j]; }
+    }
+    else{
+      const REAL8 *t = (const REAL8 *)ts->data + row*n;
+      for ( size_t j = 0; j < cols; j++ ){ sre += wb[j]*t[j]; }
+    }
+  }
+  else{
+    if ( ts->single ){
+      const REAL4 *t = (const REAL4 *)ts->data + row*n;
+      for ( size_t j = 0; j < cols; j++ ){
+        sre += wb[2*j]*(REAL8)t[2*j] - wb[2*j+1]*(REAL8)t[2*j+1];
+        sim += wb[2*j]*(REAL8)t[2*j+1] + wb[2*j+1]*(REAL8)t[2*j];
+      }
+    }
+    else{
+      const REAL8 *t = (const REAL8 *)ts->data + row*n;
+      for ( size_t j = 0; j < cols; j++ ){
+        sre += wb[2*j]*t[2*j] - wb[2*j+1]*t[2*j+1];
+        sim += wb[2*j]*t[2*j+1] + wb[2*j+1]*t[2*j];
+      }
+    }
+  }
 
-  gsl_vector_complex_memcpy(e,ortho_basis);
-  complex_normalise(wQuad, e);
+  *re = sre;
+  *im = sim;
+}
 
-  /* if not done, R matrix fills up below diagonal with .5 instead of 0 */
-  gsl_vector_complex_set_zero(ru);  
 
-  while( !flag ){
-    gsl_vector_complex_memcpy(ortho_basis, e);
-    gsl_vector_complex_set_zero(r_last);
+/** \brief The weighted norm of a real or complex vector
+ *
+ * @param[in] v The vector (with interleaved real and imaginary parts if complex)
+ * @param[in] w The weight for each vector point
+ * @param[in] cols The number of points in the vector
+ * @param[in] ncomp 1 for a real vector and 2 for a complex vector
+ *
+ * @return The weighted norm of the vector
+ */
+static REAL8 roq_vector_norm(const REAL8 *v, const REAL8 *w, size_t cols, UINT4 ncomp){
+  REAL8 norm2 = 0.;
 
-    modified_gs_complex(r_last, ortho_basis, RB_space, wQuad, dim_RB);
+  for ( size_t j = 0; j < cols; j++ ){
+    for ( size_t c = 0; c < ncomp; c++ ){ norm2 += w[j]*v[ncomp*j+c]*v[ncomp*j+c]; }
+  }
 
-    gsl_vector_complex_add(ru, r_last);
-    nrmc_current = gsl_vector_complex_get(r_last, dim_RB);
-    nrm_current = GSL_REAL(nrmc_current);
+  return sqrt(norm2);
+}
 
-    gsl_vector_complex_scale(ortho_basis, nrmc_current);
 
-    if( nrm_current/nrm_prev <= ortho_condition ) {
-      nrm_prev = nrm_current;
-      iter = iter + 1;
-      gsl_vector_complex_memcpy(e, ortho_basis);
+/** \brief Orthogonalise a vector against a set of orthonormal basis vectors
+ *
+ * The basis is processed in blocks of \c ROQ_BLOCK_SIZE vectors: within a block the projections are
+ * computed and removed with a pair of BLAS matrix-vector products (classical Gram-Schmidt), while
+ * successive blocks are removed one after another (modified Gram-Schmidt). These are matrix-vector
+ * rather than matrix-matrix products because the greedy algorithm adds one vector at a time, and
+ * which training row comes next depends on the basis so far, so there is never more than one
+ * candidate to orthogonalise.
+ *
+ * @param[in,out] v The vector to orthogonalise
+ * @param[in] RB The row-major set of orthonormal basis vectors
+ * @param[in] dim_RB The number of basis vectors
+ * @param[in] w The weight for each vector point
+ * @param[in] cols The number of points in each vector
+ * @param[in] ncomp 1 for real vectors and 2 for complex vectors
+ * @param[in] wv Workspace of length \c ncomp x \c cols
+ * @param[in] coeffs Workspace of length 2 x \c ROQ_BLOCK_SIZE
+ */
+static void roq_orthogonalise(REAL8 *v,
+                              const REAL8 *RB,
+                              UINT4 dim_RB,
+                              const REAL8 *w,
+                              size_t cols,
+                              UINT4 ncomp,
+                              REAL8 *wv,
+                              REAL8 *coeffs){
+  size_t n = ncomp*cols;
+
+  for ( size_t b0 = 0; b0 < dim_RB; b0 += ROQ_BLOCK_SIZE ){
+    size_t nb = ( dim_RB - b0 < ROQ_BLOCK_SIZE ) ? dim_RB - b0 : ROQ_BLOCK_SIZE;
+
+    if ( ncomp == 1 ){
+      gsl_matrix_const_view RBblock = gsl_matrix_const_view_array(RB + b0*n, nb, cols);
+      gsl_vector_view vview = gsl_vector_view_array(v, cols), wvview = gsl_vector_view_array(wv, cols);
+      gsl_vector_view cview = gsl_vector_view_array(coeffs, nb);
+
+      for ( size_t j = 0; j < cols; j++ ){ wv[j] = w[j]*v[j]; }
+
+      /* v = v - RB^T (RB (w v)) */
+      XLAL_CALLGSL( gsl_blas_dgemv(CblasNoTrans, 1., &RBblock.matrix, &wvview.vector, 0., &cview.vector) );
+      XLAL_CALLGSL( gsl_blas_dgemv(CblasTrans, -1., &RBblock.matrix, &cview.vector, 1., &vview.vector) );
     }
-    else{ flag = 1; }
-
-    nrm_current = complex_normalisation(wQuad, ortho_basis);
-    GSL_SET_COMPLEX(&nrmc_current, nrm_current, 0.0);
-    gsl_vector_complex_set(ru, dim_RB, nrmc_current);
+    else{
+      gsl_matrix_complex_const_view RBblock = gsl_matrix_complex_const_view_array(RB + b0*n, nb, cols);
+      gsl_vector_complex_view vview = gsl_vector_complex_view_array(v, cols), wvview = gsl_vector_complex_view_array(wv, cols);
+      gsl_vector_complex_view cview = gsl_vector_complex_view_array(coeffs, nb);
+
+      /* complex conjugate of the weighted vector, so that RB (w v)^* gives the conjugate of the projections */
+      for ( size_t j = 0; j < cols; j++ ){
+        wv[2*j] = w[j]*v[2*j];
+        wv[2*j+1] = -w[j]*v[2*j+1];
+      }
 
-    complex_normalise(wQuad, ortho_basis);
+      XLAL_CALLGSL( gsl_blas_zgemv(CblasNoTrans, GSL_COMPLEX_ONE, &RBblock.matrix, &wvview.vector, GSL_COMPLEX_ZERO, &cview.vector) );
+      for ( size_t k = 0; k < nb; k++ ){ coeffs[2*k+1] = -coeffs[2*k+1]; }
+      XLAL_CALLGSL( gsl_blas_zgemv(CblasTrans, GSL_COMPLEX_NEGONE, &RBblock.matrix, &cview.vector, GSL_COMPLEX_ONE, &vview.vector) );
+    }
   }
-
-  gsl_vector_complex_free(e);
-  gsl_vector_complex_free(r_last);
 }
 
 
-/** \brief Iterated modified Gram-Schmidt algorithm for real data
+/** \brief Iterated Gram-Schmidt algorithm for real or complex data
  *
- * An iterated modified Gram-Schmidt algorithm taken from the
+ * An iterated Gram-Schmidt algorithm following the iterated modified Gram-Schmidt algorithm of the
  * <a href="https://bitbucket.org/sfield83/greedycpp">greedycpp</a> code. This uses the method
- * given in \cite Hoffmann1989
- *
- * @param[out] ru A 1-by-(\c dim_RB + 1) vector returning a slice of the R matrix 
- * @param[out] ortho_basis A vector returning the orthogonal basis vector
- * @param[in] RB_space A matrix containing the existing set of orthonormal basis vectors
- * @param[in] wQuad A vector of weights for the inner products
- * @param[in] dim_RB The number of elements in the current \c RB_space
+ * given in \cite Hoffmann1989, with the orthogonalisation performed by \c roq_orthogonalise.
+ *
+ * @param[in,out] ortho The vector to orthogonalise, which returns the new orthonormal basis vector
+ * @param[in] RB The row-major set of orthonormal basis vectors
+ * @param[in] dim_RB The number of basis vectors
+ * @param[in] w The weight for each vector point
+ * @param[in] cols The number of points in each vector
+ * @param[in] ncomp 1 for real vectors and 2 for complex vectors
+ * @param[in] e Workspace of length \c ncomp x \c cols
+ * @param[in] wv Workspace of length \c ncomp x \c cols
+ * @param[in] coeffs Workspace of length 2 x \c ROQ_BLOCK_SIZE
+ *
+ * @return The norm of the orthogonalised vector before its normalisation (this will be NaN or zero
+ * if the vector is already fully represented by the basis)
  */
-void iterated_modified_gm(gsl_vector *ru,
-                          gsl_vector *ortho_basis,
-                          const gsl_matrix *RB_space,
-                          const gsl_vector *wQuad,
-                          const int dim_RB){
+static REAL8 roq_iterated_orthogonalise(REAL8 *ortho,
+                                        const REAL8 *RB,
+                                        UINT4 dim_RB,
+                                        const REAL8 *w,
+                                        size_t cols,
+                                        UINT4 ncomp,
+                                        REAL8 *e,
+                                        REAL8 *wv,
+                                        REAL8 *coeffs){
   REAL8 ortho_condition = .5; /* hard coded IMGS stopping condition */
 
-  INT4 quad_num = RB_space->size2;
-  INT4 r_size = ru->size;
-  REAL8 nrm_prev = normalisation(wQuad, ortho_basis);
-  UINT4 flag = 0, iter = 0;
-  gsl_vector *e,*r_last;
+  size_t n = ncomp*cols;
+  REAL8 nrm_prev = roq_vector_norm(ortho, w, cols, ncomp);
   REAL8 nrm_current = 0.;
 
-  /* allocate memory */
-  e = gsl_vector_alloc(quad_num);
-  r_last = gsl_vector_alloc(r_size);
+  for ( size_t j = 0; j < n; j++ ){ e[j] = ortho[j]/nrm_prev; }
 
-  gsl_vector_memcpy(e,ortho_basis);
-  normalise(wQuad, e);
+  while ( 1 ){
+    memcpy(ortho, e, n*sizeof(REAL8));
 
-  /* if not done, R matrix fills up below diagonal with .5 instead of 0 */
-  gsl_vector_set_zero(ru);  
+    roq_orthogonalise(ortho, RB, dim_RB, w, cols, ncomp, wv, coeffs);
 
-  while( !flag ){
-    gsl_vector_memcpy(ortho_basis, e);
-    gsl_vector_set_zero(r_last);
-
-    modified_gs(r_last, ortho_basis, RB_space, wQuad, dim_RB);
-
-    gsl_vector_add(ru, r_last);
-    nrm_current = gsl_vector_get(r_last, dim_RB);
-
-    gsl_vector_scale(ortho_basis, nrm_current);
+    nrm_current = roq_vector_norm(ortho, w, cols, ncomp);
 
     if( nrm_current/nrm_prev <= ortho_condition ) {
       nrm_prev = nrm_current;
-      iter = iter + 1;
-      gsl_vector_memcpy(e, ortho_basis);
+      memcpy(e, ortho, n*sizeof(REAL8));
     }
-    else{ flag = 1; }
-
-    nrm_current = normalisation(wQuad, ortho_basis);
-    gsl_vector_set(ru, dim_RB, nrm_current);
-
-    normalise(wQuad, ortho_basis);
+    else{ break; }
   }
 
-  gsl_vector_free(e);
-  gsl_vector_free(r_last);
+  for ( size_t j = 0; j < n; j++ ){ ortho[j] /= nrm_current; }
+
+  return nrm_current;
 }
 
-/* main functions */
 
-/**
- * \brief Create a orthonormal basis set from a training set of real waveforms
+/** \brief Greedy reduced basis generation for real or complex training sets
  *
- * Given a \c gsl_matrix containing a training set of real waveforms (where the waveforms
- * are created at time or frequency steps seperated by \c delta) an orthonormal basis
- * will be generated using the greedy binning Algorithm 1 of \cite FGHKT2014 . The stopping
- * criteria for the algorithm is controlled by the \c tolerance value, which defined the
- * maximum residual between the current basis set (at a given iteration) and the training
- * set (and example tolerance is \f$10^{-12}\f$). In this function the training set will be
- * normalised, so the input \c TS will be modified.
- *
- * If the \c RBin value is \c NULL then a new reduced basis will be formed from the given
- * training set. However, if \c RBin already contains a previously produced basis, then this
- * basis will be enriched with bases if possible using the new training set.  <b>NOTE</b>: when
- * using  small tolerances enriching the basis in this way can lead to numerical precision issues,
- * so in general you should use \c LALInferenceEnrichREAL8Basis for enrichment.
+ * This implements the greedy binning Algorithm 1 of \cite FGHKT2014 for a training set held in
+ * either single or double precision (the reduced basis is always formed in double precision). The
+ * training set is normalised in place. At each iteration the projections of the whole training
+ * set onto the newest basis vector are computed in parallel over the training set rows (using
+ * OpenMP), and the worst represented row is orthogonalised against the current basis with
+ * \c roq_iterated_orthogonalise.
  *
- * @param[out] RBin A \c REAL8Array to return the reduced basis.
+ * @param[in] ts The training set
  * @param[in] delta The time/frequency step(s) in the training set used to normalise the models.
  * This can be a vector containing just one value.
  * @param[in] tolerance The tolerance used as a stopping criteria for the basis generation.
- * @param[in] TS A \c REAL8Array matrix containing the complex training set, where the number of
- * waveforms in the training set is given by the rows and the waveform points by the columns. This
- * will be modified by this function, as the training set will be normalised.
+ * @param[out] RBout A row-major array (allocated with \c XLALMalloc) returning the reduced basis
+ * @param[out] nRB The number of reduced basis vectors
  * @param[out] greedypoints A \c UINT4Vector to return the indices of the training set rows that
  * have been used to form the reduced basis.
  *
- * @return A \c REAL8 with the maximum projection error for the final reduced basis.
- *
- * \sa LALInferenceEnrichREAL8Basis
+ * @return The maximum projection error for the final reduced basis.
  */
-REAL8 LALInferenceGenerateREAL8OrthonormalBasis(REAL8Array **RBin,
-                                                const REAL8Vector *delta,
-                                                REAL8 tolerance,
-                                                REAL8Array **TS,
-                                                UINT4Vector **greedypoints){
-  REAL8Array *ts = NULL;
-  ts = *TS; // pointer to training set
-
-  size_t cols = ts->dimLength->data[1], rows = ts->dimLength->data[0];
-
-  /* view of training set */
-  gsl_matrix_view TSview;
-  XLAL_CALLGSL( TSview = gsl_matrix_view_array((double *)ts->data, rows, cols) );
+static REAL8 roq_greedy_basis(ROQTrainingSet *ts,
+                              const REAL8Vector *delta,
+                              REAL8 tolerance,
+                              REAL8 **RBout,
+                              UINT4 *nRB,
+                              UINT4Vector **greedypoints){
+  size_t rows = ts->rows, cols = ts->cols, n = ts->ncomp*cols;
+  size_t max_RB = rows, capacity = 0;
+
+  XLAL_CHECK_REAL8( delta != NULL, XLAL_EFUNC, "Vector of 'delta' values is NULL!" );
+  XLAL_CHECK_REAL8( delta->length == 1 || delta->length == cols, XLAL_EFUNC, "Vector of weights must either contain a single value, or be the same length as the other input vectors." );
+  XLAL_CHECK_REAL8( rows > 0 && cols > 0, XLAL_EFUNC, "Training set is empty!" );
+
+  REAL8 worst_err = 0.;     /* errors in greedy sweep */
+  UINT4 worst_app = 0;      /* worst error stored */
 
-  size_t max_RB = rows;
+  REAL8 *w = XLALMalloc(cols*sizeof(REAL8));
+  REAL8 *A_row_norms2 = XLALMalloc(rows*sizeof(REAL8));          // || A(i,:) ||^2
+  REAL8 *projection_norms2 = XLALCalloc(rows, sizeof(REAL8));
+  REAL8 *errors = XLALMalloc(rows*sizeof(REAL8));                 // approximation errors at i^{th} sweep
+  REAL8 *wb = XLALMalloc(n*sizeof(REAL8));
+  REAL8 *ortho_basis = XLALMalloc(n*sizeof(REAL8));
+  REAL8 *e = XLALMalloc(n*sizeof(REAL8));
+  REAL8 *wv = XLALMalloc(n*sizeof(REAL8));
+  REAL8 *coeffs = XLALMalloc(2*ROQ_BLOCK_SIZE*sizeof(REAL8));
+
+  for ( size_t j = 0; j < cols; j++ ){ w[j] = ( delta->length == 1 ) ? delta->data[0] : delta->data[j]; }
+
+  /* normalise the training set and compute norm of each training space element */
+  #pragma omp parallel for schedule(static)
+  for ( size_t i = 0; i < rows; i++ ){
+    roq_training_set_row_scale(ts, i, 1./roq_training_set_row_norm(ts, i, w));
+    REAL8 nrm = roq_training_set_row_norm(ts, i, w); /* not exactly one for single precision rows */
+    A_row_norms2[i] = nrm*nrm;
+  }
 
-  //REAL8 greedy_err[max_RB];           /* approximate error */
   UINT4Vector *gpts = NULL;
   gpts = XLALCreateUINT4Vector(max_RB); /* selected greedy points (row selection) */
-  *greedypoints = gpts;
-
-  REAL8 worst_err;          /* errors in greedy sweep */
-  UINT4 worst_app = 0;      /* worst error stored */
-  REAL8 tmpc;               /* worst error temp */
-
-  gsl_vector *ts_el, *last_rb, *ortho_basis, *ru;
-  gsl_matrix *R_matrix;
-  REAL8 A_row_norms2[rows];              // || A(i,:) ||^2
-  REAL8 projection_norms2[rows];
-  REAL8 errors[rows];                    // approximation errors at i^{th} sweep
-
-  REAL8Array *RB = NULL;
-  UINT4Vector *dims = NULL;
-  gsl_matrix_view RBview;
-
-  /* this memory should be freed here */
-  ts_el         = gsl_vector_alloc(cols);
-  last_rb       = gsl_vector_alloc(cols);
-  ortho_basis   = gsl_vector_alloc(cols);
-  ru            = gsl_vector_alloc(max_RB);
-
-  //project_coeff = gsl_matrix_alloc(max_RB,rows);
-  REAL8 projection_coeff;
-  R_matrix = gsl_matrix_alloc(max_RB, max_RB);
-
-  /* initialise projection norms with zeros */
-  for(size_t i=0; i<rows; ++i){ projection_norms2[i] = 0; }
-
-  gsl_vector_view deltaview;
-  XLAL_CALLGSL( deltaview = gsl_vector_view_array(delta->data, delta->length) );
-
-  /* normalise the training set */
-  normalise_training_set(&deltaview.vector, &TSview.matrix);
-
-  /* compute norm of each training space element */
-  for(size_t i=0; i<rows; ++i) {
-    gsl_matrix_get_row(ts_el, &TSview.matrix, i);
-    A_row_norms2[i] = normalisation(&deltaview.vector, ts_el);
-  }
 
   /* initialize algorithm with first training set value */
-  dims = XLALCreateUINT4Vector( 2 );
-  dims->data[0] = 1; /* one row */
-  dims->data[1] = cols;
-  RB = XLALCreateREAL8Array( dims );
-  *RBin = RB;
-
-  XLAL_CALLGSL( RBview = gsl_matrix_view_array((double*)RB->data, 1, cols) );
-  gsl_matrix_get_row(ts_el, &TSview.matrix, 0);
-  gsl_matrix_set_row(&RBview.matrix, 0, ts_el);
-  tmpc = 1.;
-  gsl_matrix_set(R_matrix, 0, 0, tmpc);  // assumes normalized solutions
+  capacity = ( max_RB < ROQ_BLOCK_SIZE ) ? max_RB : ROQ_BLOCK_SIZE;
+  REAL8 *RB = XLALMalloc(capacity*n*sizeof(REAL8));
+  roq_training_set_row(ts, 0, RB);
+  REAL8 nrm0 = roq_vector_norm(RB, w, cols, ts->ncomp);
+  for ( size_t j = 0; j < n; j++ ){ RB[j] /= nrm0; }
 
   gpts->data[0] = 0;
   UINT4 dim_RB          = 1;
-  //greedy_err[0]    = 1.0;
 
   /* loop to find reduced basis */
-  while( 1 ){
-    gsl_matrix_get_row(last_rb, &RBview.matrix, dim_RB-1); /* previous basis */
+  while ( dim_RB < max_RB ){
+    const REAL8 *last_rb = RB + (dim_RB-1)*n; /* previous basis */
+
+    /* weighted complex conjugate of the previous basis */
+    for ( size_t j = 0; j < n; j++ ){ wb[j] = ( j % ts->ncomp ? -1. : 1. )*w[j/ts->ncomp]*last_rb[j]; }
 
     /* Compute overlaps of pieces of training set with rb_new */
+    #pragma omp parallel for schedule(static)
     for(size_t i = 0; i < rows; i++){
-      gsl_matrix_get_row(ts_el, &TSview.matrix, i);
-      projection_coeff = weighted_dot_product(&deltaview.vector, last_rb, ts_el);
-      projection_norms2[i] += (projection_coeff*projection_coeff);
+      REAL8 re = 0., im = 0.;
+      roq_training_set_row_projection(ts, i, wb, &re, &im);
+      projection_norms2[i] += re*re + im*im;
       errors[i] = A_row_norms2[i] - projection_norms2[i];
     }
 
@@ -893,41 +882,195 @@ REAL8 LALInferenceGenerateREAL8OrthonormalBasis(REAL8Array **RBin,
     gpts->data[dim_RB] = worst_app;
 
     /* add worst approximated solution to basis set */
-    gsl_matrix_get_row(ortho_basis, &TSview.matrix, worst_app);
-    iterated_modified_gm(ru, ortho_basis, &RBview.matrix, &deltaview.vector, dim_RB); /* use IMGS */
+    roq_training_set_row(ts, worst_app, ortho_basis);
+    REAL8 nrm = roq_iterated_orthogonalise(ortho_basis, RB, dim_RB, w, cols, ts->ncomp, e, wv, coeffs);
 
     /* check normalisation of generated orthogonal basis is not NaN (cause by a new orthogonal basis
       having zero residual with the current basis) - if this is the case do not add the new basis. */
-    if ( gsl_isnan(gsl_vector_get(ru, dim_RB)) ){ break; }
-
-    /* add to reduced basis */
-    dims->data[0] = dim_RB+1; /* add row */
-    RB = XLALResizeREAL8Array( RB, dims );
+    if ( !(nrm > 0.) ){ break; }
 
     /* add on next basis */
-    XLAL_CALLGSL( RBview = gsl_matrix_view_array((double*)RB->data, dim_RB+1, cols) );
-
-    gsl_matrix_set_row(&RBview.matrix, dim_RB, ortho_basis);
-    gsl_matrix_set_row(R_matrix, dim_RB, ru);
+    if ( dim_RB == capacity ){
+      capacity = ( 2*capacity < max_RB ) ? 2*capacity : max_RB;
+      RB = XLALRealloc(RB, capacity*n*sizeof(REAL8));
+    }
+    memcpy(RB + dim_RB*n, ortho_basis, n*sizeof(REAL8));
 
     ++dim_RB;
 
     /* decide if another greedy sweep is needed */
-    if( (dim_RB == max_RB) || (worst_err < tolerance) || (rows == dim_RB) ){ break; }
+    if ( worst_err < tolerance ){ break; }
   }
 
-  gpts = XLALResizeUINT4Vector( gpts, dim_RB );
+  *greedypoints = XLALResizeUINT4Vector( gpts, dim_RB );
+  *RBout = RB;
+  *nRB = dim_RB;
 
-  XLALDestroyUINT4Vector(dims);
-  gsl_vector_free(ts_el);
-  gsl_vector_free(last_rb);
-  gsl_vector_free(ortho_basis);
-  gsl_vector_free(ru);
-  gsl_matrix_free(R_matrix);
+  XLALFree(w);
+  XLALFree(A_row_norms2);
+  XLALFree(projection_norms2);
+  XLALFree(errors);
+  XLALFree(wb);
+  XLALFree(ortho_basis);
+  XLALFree(e);
+  XLALFree(wv);
+  XLALFree(coeffs);
 
   return worst_err;
 }
 
+/** \brief Create a real reduced basis array from a training set
+ *
+ * @param[in] ts The (real) training set
+ * @param[out] RBin A \c REAL8Array to return the reduced basis.
+ * @param[in] delta The time/frequency step(s) in the training set
+ * @param[in] tolerance The tolerance used as a stopping criteria for the basis generation.
+ * @param[out] greedypoints A \c UINT4Vector to return the indices of the training set rows that
+ * have been used to form the reduced basis.
+ *
+ * @return The maximum projection error for the final reduced basis.
+ */
+static REAL8 roq_real_basis(ROQTrainingSet *ts,
+                            REAL8Array **RBin,
+                            const REAL8Vector *delta,
+                            REAL8 tolerance,
+                            UINT4Vector **greedypoints){
+  REAL8 *RBdata = NULL;
+  UINT4 nRB = 0;
+
+  REAL8 worst_err = roq_greedy_basis(ts, delta, tolerance, &RBdata, &nRB, greedypoints);
+  XLAL_CHECK_REAL8( RBdata != NULL, XLAL_EFUNC );
+
+  UINT4Vector *dims = XLALCreateUINT4Vector( 2 );
+  dims->data[0] = nRB;
+  dims->data[1] = ts->cols;
+  *RBin = XLALCreateREAL8Array( dims );
+  XLALDestroyUINT4Vector( dims );
+  memcpy((*RBin)->data, RBdata, nRB*ts->cols*sizeof(REAL8));
+  XLALFree( RBdata );
+
+  return worst_err;
+}
+
+
+/** \brief Create a complex reduced basis array from a training set
+ *
+ * @param[in] ts The (complex) training set
+ * @param[out] RBin A \c COMPLEX16Array to return the reduced basis.
+ * @param[in] delta The time/frequency step(s) in the training set
+ * @param[in] tolerance The tolerance used as a stopping criteria for the basis generation.
+ * @param[out] greedypoints A \c UINT4Vector to return the indices of the training set rows that
+ * have been used to form the reduced basis.
+ *
+ * @return The maximum projection error for the final reduced basis.
+ */
+static REAL8 roq_complex_basis(ROQTrainingSet *ts,
+                               COMPLEX16Array **RBin,
+                               const REAL8Vector *delta,
+                               REAL8 tolerance,
+                               UINT4Vector **greedypoints){
+  REAL8 *RBdata = NULL;
+  UINT4 nRB = 0;
+
+  REAL8 worst_err = roq_greedy_basis(ts, delta, tolerance, &RBdata, &nRB, greedypoints);
+  XLAL_CHECK_REAL8( RBdata != NULL, XLAL_EFUNC );
+
+  UINT4Vector *dims = XLALCreateUINT4Vector( 2 );
+  dims->data[0] = nRB;
+  dims->data[1] = ts->cols;
+  *RBin = XLALCreateCOMPLEX16Array( dims );
+  XLALDestroyUINT4Vector( dims );
+  memcpy((*RBin)->data, RBdata, nRB*ts->cols*sizeof(COMPLEX16));
+  XLALFree( RBdata );
+
+  return worst_err;
+}
+
+/* main functions */
+
+/**
+ * \brief Create a orthonormal basis set from a training set of real waveforms
+ *
+ * Given a \c gsl_matrix containing a training set of real waveforms (where the waveforms
+ * are created at time or frequency steps seperated by \c delta) an orthonormal basis
+ * will be generated using the greedy binning Algorithm 1 of \cite FGHKT2014 . The stopping
+ * criteria for the algorithm is controlled by the \c tolerance value, which defined the
+ * maximum residual between the current basis set (at a given iteration) and the training
+ * set (and example tolerance is \f$10^{-12}\f$). In this function the training set will be
+ * normalised, so the input \c TS will be modified.
+ *
+ * If the \c RBin value is \c NULL then a new reduced basis will be formed from the given
+ * training set. However, if \c RBin already contains a previously produced basis, then this
+ * basis will be enriched with bases if possible using the new training set.  <b>NOTE</b>: when
+ * using  small tolerances enriching the basis in this way can lead to numerical precision issues,
+ * so in general you should use \c LALInferenceEnrichREAL8Basis for enrichment.
+ *
+ * @param[out] RBin A \c REAL8Array to return the reduced basis.
+ * @param[in] delta The time/frequency step(s) in the training set used to normalise the models.
+ * This can be a vector containing just one value.
+ * @param[in] tolerance The tolerance used as a stopping criteria for the basis generation.
+ * @param[in] TS A \c REAL8Array matrix containing the complex training set, where the number of
+ * waveforms in the training set is given by the rows and the waveform points by the columns. This
+ * will be modified by this function, as the training set will be normalised.
+ * @param[out] greedypoints A \c UINT4Vector to return the indices of the training set rows that
+ * have been used to form the reduced basis.
+ *
+ * @return A \c REAL8 with the maximum projection error for the final reduced basis.
+ *
+ * \sa LALInferenceEnrichREAL8Basis
+ */
+REAL8 LALInferenceGenerateREAL8OrthonormalBasis(REAL8Array **RBin,
+                                                const REAL8Vector *delta,
+                                                REAL8 tolerance,
+                                                REAL8Array **TS,
+                                                UINT4Vector **greedypoints){
+  REAL8Array *ts = NULL;
+  ts = *TS; // pointer to training set
+
+  XLAL_CHECK_REAL8( ts != NULL && ts->dimLength->length == 2, XLAL_EFUNC, "Training set must be a two dimensional array" );
+
+  ROQTrainingSet tset = { ts->data, ts->dimLength->data[0], ts->dimLength->data[1], 1, 0 };
+
+  return roq_real_basis(&tset, RBin, delta, tolerance, greedypoints);
+}
+
+
+/**
+ * \brief Create a orthonormal basis set from a single precision training set of real waveforms
+ *
+ * This is equivalent to \c LALInferenceGenerateREAL8OrthonormalBasis, but with the training set
+ * held in single precision, which halves the memory (and memory bandwidth) required for large
+ * training sets. The projections are accumulated, and the reduced basis formed, in double precision.
+ * As the training set is only stored to single precision the achievable \c tolerance is limited to
+ * \f$\sim 10^{-12}\f$ (the square of the single precision machine epsilon).
+ *
+ * @param[out] RBin A \c REAL8Array to return the reduced basis.
+ * @param[in] delta The time/frequency step(s) in the training set used to normalise the models.
+ * This can be a vector containing just one value.
+ * @param[in] tolerance The tolerance used as a stopping criteria for the basis generation.
+ * @param[in] TS A \c REAL4Array matrix containing the real training set, where the number of
+ * waveforms in the training set is given by the rows and the waveform points by the columns. This
+ * will be modified by this function, as the training set will be normalised.
+ * @param[out] greedypoints A \c UINT4Vector to return the indices of the training set rows that
+ * have been used to form the reduced basis.
+ *
+ * @return A \c REAL8 with the maximum projection error for the final reduced basis.
+ */
+REAL8 LALInferenceGenerateREAL8OrthonormalBasisFromREAL4(REAL8Array **RBin,
+                                                         const REAL8Vector *delta,
+                                                         REAL8 tolerance,
+                                                         REAL4Array **TS,
+                                                         UINT4Vector **greedypoints){
+  REAL4Array *ts = NULL;
+  ts = *TS; // pointer to training set
+
+  XLAL_CHECK_REAL8( ts != NULL && ts->dimLength->length == 2, XLAL_EFUNC, "Training set must be a two dimensional array" );
+
+  ROQTrainingSet tset = { ts->data, ts->dimLength->data[0], ts->dimLength->data[1], 1, 1 };
+
+  return roq_real_basis(&tset, RBin, delta, tolerance, greedypoints);
+}
+
 
 /**
  * \brief Create a orthonormal basis set from a training set of complex waveforms
@@ -973,164 +1116,48 @@ REAL8 LALInferenceGenerateCOMPLEX16OrthonormalBasis(COMPLEX16Array **RBin,
   COMPLEX16Array *ts = NULL;
   ts = *TS; // pointer to training set
 
-  size_t cols = ts->dimLength->data[1], rows = ts->dimLength->data[0];
-
-  /* view of training set */
-  gsl_matrix_complex_view TSview;
-  XLAL_CALLGSL( TSview = gsl_matrix_complex_view_array((double *)ts->data, rows, cols) );
-
-  size_t max_RB = rows;
-
-  UINT4Vector *gpts = NULL;
-  gpts = XLALCreateUINT4Vector(max_RB); /* selected greedy points (row selection) */
-  *greedypoints = gpts;
-
-  REAL8 worst_err;          /* errors in greedy sweep */
-  UINT4 worst_app = 0;      /* worst error stored */
-  gsl_complex tmpc;         /* worst error temp */
-
-  gsl_vector_complex *ts_el, *last_rb, *ortho_basis, *ru;
-  gsl_matrix_complex *R_matrix;
-  REAL8 A_row_norms2[rows];              // || A(i,:) ||^2
-  REAL8 projection_norms2[rows];
-  REAL8 errors[rows];                    // approximation errors at i^{th} sweep
-
-  COMPLEX16Array *RB = NULL;
-  UINT4Vector *dims = NULL;
-  gsl_matrix_complex_view RBview;
-  
-  /* this memory should be freed here */
-  ts_el         = gsl_vector_complex_alloc(cols);
-  last_rb       = gsl_vector_complex_alloc(cols);
-  ortho_basis   = gsl_vector_complex_alloc(cols);
-  ru            = gsl_vector_complex_alloc(max_RB);
-
-  //project_coeff = gsl_matrix_complex_alloc(max_RB,rows);
-  gsl_complex projection_coeff;
-  R_matrix = gsl_matrix_complex_alloc(max_RB, max_RB);
-
-  /* initialise projection norms with zeros */
-  for(size_t i=0; i<rows; ++i){ projection_norms2[i] = 0; }
-
-  gsl_vector_view deltaview;
-  XLAL_CALLGSL( deltaview = gsl_vector_view_array(delta->data, delta->length) );
-  
-  /* normalise the training set */
-  complex_normalise_training_set(&deltaview.vector, &TSview.matrix);
-
-  /* compute norm of each training space element */
-  for(size_t i=0; i<rows; ++i) {
-    gsl_matrix_complex_get_row(ts_el, &TSview.matrix, i);
-    A_row_norms2[i] = complex_normalisation(&deltaview.vector, ts_el);
-  }
-
-  /* initialize algorithm with first training set value */
-  dims = XLALCreateUINT4Vector( 2 );
-  dims->data[0] = 1; /* one row */
-  dims->data[1] = cols;
-  RB = XLALCreateCOMPLEX16Array( dims );
-  *RBin = RB;
-
-  XLAL_CALLGSL( RBview = gsl_matrix_complex_view_array((double*)RB->data, 1, cols) );
-  gsl_matrix_complex_get_row(ts_el, &TSview.matrix, 0);
-  gsl_matrix_complex_set_row(&RBview.matrix, 0, ts_el);
-  GSL_SET_COMPLEX(&tmpc, 1.0, 0.0);
-  gsl_matrix_complex_set(R_matrix, 0, 0, tmpc);  // assumes normalized solutions
-
-  gpts->data[0] = 0;
-  UINT4 dim_RB          = 1;
-
-  /* loop to find reduced basis */
-  while( 1 ){
-    gsl_matrix_complex_get_row(last_rb, &RBview.matrix, dim_RB-1); /* previous basis */
-
-    /* Compute overlaps of pieces of training set with rb_new */
-    for(size_t i = 0; i < rows; i++){
-      gsl_matrix_complex_get_row(ts_el, &TSview.matrix, i);
-      projection_coeff = complex_weighted_dot_product(&deltaview.vector, last_rb, ts_el);
-      projection_norms2[i] += (GSL_REAL(projection_coeff)*GSL_REAL(projection_coeff) + GSL_IMAG(projection_coeff)*GSL_IMAG(projection_coeff));
-      errors[i] = A_row_norms2[i] - projection_norms2[i];
-    }
-
-    /* find worst represented training set element, and add to basis */
-    worst_err = 0.0;
-    for(size_t i = 0; i < rows; i++) {
-      if(worst_err < errors[i]) {
-        worst_err = errors[i];
-        worst_app = i;
-      }
-    }
-
-    // This block exists for cases when the reduced basis is being used during enrichment.
-    // It exists to make sure that all new training elements get added to the reduced basis
-    // even if their errors are very small.
-    if ( tolerance == 0. ){
-      // check if worst_app is already in gpts
-      UINT4 idxexists = 0;
-      for(size_t i = 0; i < dim_RB; i++) {
-        if ( worst_app == gpts->data[i] ){
-          idxexists = 1;
-          break;
-        }
-      }
-
-      // if it is, then just find the first index that is not in gpts already
-      if ( idxexists ){
-        UINT4 newidxexists = 0;
-        for (size_t i = 0; i < rows; i++){
-          newidxexists = 0;
-          for (size_t j = 0; j < dim_RB; j++){
-            if ( i == gpts->data[j] ){
-              newidxexists = 1;
-              break;
-            }
-          }
-          if ( !newidxexists ){
-            worst_app = i;
-            break;
-          }
-        }
-      }
-    }
-    //////////// end check ////////////
+  XLAL_CHECK_REAL8( ts != NULL && ts->dimLength->length == 2, XLAL_EFUNC, "Training set must be a two dimensional array" );
 
-    gpts->data[dim_RB] = worst_app;
+  ROQTrainingSet tset = { ts->data, ts->dimLength->data[0], ts->dimLength->data[1], 2, 0 };
 
-    /* add worst approximated solution to basis set */
-    gsl_matrix_complex_get_row(ortho_basis, &TSview.matrix, worst_app);
-    iterated_modified_gm_complex(ru, ortho_basis, &RBview.matrix, &deltaview.vector, dim_RB); /* use IMGS */
-
-    /* check normalisation of generated orthogonal basis is not NaN (cause by a new orthogonal basis
-      having zero residual with the current basis) - if this is the case do not add the new basis. */
-    gsl_complex norm = gsl_vector_complex_get(ru, dim_RB);
-    if ( gsl_isnan(GSL_REAL(norm)) ){ break; }
-
-    /* add to reduced basis */
-    dims->data[0] = dim_RB+1; /* add row */
-    RB = XLALResizeCOMPLEX16Array( RB, dims );
-
-    /* add on next basis */
-    XLAL_CALLGSL( RBview = gsl_matrix_complex_view_array((double*)RB->data, dim_RB+1, cols) );
+  return roq_complex_basis(&tset, RBin, delta, tolerance, greedypoints);
+}
 
-    gsl_matrix_complex_set_row(&RBview.matrix, dim_RB, ortho_basis);
-    gsl_matrix_complex_set_row(R_matrix, dim_RB, ru);
 
-    ++dim_RB;
-
-    /* decide if another greedy sweep is needed */
-    if( (dim_RB == max_RB) || (worst_err < tolerance) || (rows == dim_RB) ){ break; }
-  }
+/**
+ * \brief Create a orthonormal basis set from a single precision training set of complex waveforms
+ *
+ * This is equivalent to \c LALInferenceGenerateCOMPLEX16OrthonormalBasis, but with the training
+ * set held in single precision, which halves the memory (and memory bandwidth) required for large
+ * training sets. The projections are accumulated, and the reduced basis formed, in double precision.
+ * As the training set is only stored to single precision the achievable \c tolerance is limited to
+ * \f$\sim 10^{-12}\f$ (the square of the single precision machine epsilon).
+ *
+ * @param[out] RBin A \c COMPLEX16Array to return the reduced basis.
+ * @param[in] delta The time/frequency step(s) in the training set used to normalise the models.
+ * This can be a vector containing just one value.
+ * @param[in] tolerance The tolerance used as a stopping criteria for the basis generation.
+ * @param[in] TS A \c COMPLEX8Array matrix containing the complex training set, where the number
+ * of waveforms in the training set is given by the rows and the waveform points by the columns.
+ * This will be modified by this function, as the training set will be normalised.
+ * @param[out] greedypoints A \c UINT4Vector to return the indices of the training set rows that
+ * have been used to form the reduced basis.
+ *
+ * @return A \c REAL8 with the maximum projection error for the final reduced basis.
+ */
+REAL8 LALInferenceGenerateCOMPLEX16OrthonormalBasisFromCOMPLEX8(COMPLEX16Array **RBin,
+                                                                const REAL8Vector *delta,
+                                                                REAL8 tolerance,
+                                                                COMPLEX8Array **TS,
+                                                                UINT4Vector **greedypoints){
+  COMPLEX8Array *ts = NULL;
+  ts = *TS; // pointer to training set
 
-  gpts = XLALResizeUINT4Vector( gpts, dim_RB );
+  XLAL_CHECK_REAL8( ts != NULL && ts->dimLength->length == 2, XLAL_EFUNC, "Training set must be a two dimensional array" );
 
-  XLALDestroyUINT4Vector(dims);
-  gsl_vector_complex_free(ts_el);
-  gsl_vector_complex_free(last_rb);
-  gsl_vector_complex_free(ortho_basis);
-  gsl_vector_complex_free(ru);
-  gsl_matrix_complex_free(R_matrix);
+  ROQTrainingSet tset = { ts->data, ts->dimLength->data[0], ts->dimLength->data[1], 2, 1 };
 
-  return worst_err;
+  return roq_complex_basis(&tset, RBin, delta, tolerance, greedypoints);
 }
 
 
@@ -1167,9 +1194,10 @@ void LALInferenceValidateREAL8OrthonormalBasis(REAL8Vector **projerr,
   REAL8Array *tm = NULL;
   tm = *testmodels;
 
-  size_t dlength = RB->dimLength->data[1], nts = tm->dimLength->data[0];
-  size_t k = 0;
-  gsl_vector *r_tmp, *testrow;
+  size_t dlength = RB->dimLength->data[1], nts = tm->dimLength->data[0], nRB = RB->dimLength->data[0];
+  size_t k = 0, i = 0, j = 0;
+
+  XLAL_CHECK_VOID( delta->length == 1 || delta->length == dlength, XLAL_EFUNC, "Vector of weights must either contain a single value, or be the same length as the other input vectors." );
 
   /* normalise the test set */
   gsl_vector_view deltaview;
@@ -1178,46 +1206,51 @@ void LALInferenceValidateREAL8OrthonormalBasis(REAL8Vector **projerr,
   XLAL_CALLGSL( testmodelsview = gsl_matrix_view_array(tm->data, nts, dlength) );
   normalise_training_set(&deltaview.vector, &testmodelsview.matrix);
 
-  gsl_matrix_view RBview;
-  RBview = gsl_matrix_view_array(RB->data, RB->dimLength->data[0], dlength);
-
-  XLAL_CALLGSL( testrow = gsl_vector_alloc(dlength) );
-  XLAL_CALLGSL( r_tmp = gsl_vector_alloc(RB->dimLength->data[0]) );
+  gsl_matrix_const_view RBview;
+  RBview = gsl_matrix_const_view_array(RB->data, nRB, dlength);
 
   REAL8Vector *pe = NULL;
   pe = XLALCreateREAL8Vector( nts );
   *projerr = pe;
 
-  for ( k = 0; k < nts; k++ ){
-    pe->data[k] = 0.;
-    REAL8 r_tmp_nrm = 0.;
+  /* blocks of weighted test models and their projections onto the reduced basis */
+  REAL8 *testblock = XLALMalloc(ROQ_BLOCK_SIZE*dlength*sizeof(REAL8));
+  REAL8 *projblock = XLALMalloc(ROQ_BLOCK_SIZE*nRB*sizeof(REAL8));
 
-    XLAL_CALLGSL( gsl_matrix_get_row(testrow, &testmodelsview.matrix, k) );
+  for ( k = 0; k < nts; k += ROQ_BLOCK_SIZE ){
+    size_t nb = ( nts - k < ROQ_BLOCK_SIZE ) ? nts - k : ROQ_BLOCK_SIZE;
 
-    REAL8 nrm = normalisation(&deltaview.vector, testrow); // normalisation (should be 1 as test models are normalised)
+    #pragma omp parallel for private(j) schedule(static)
+    for ( i = 0; i < nb; i++ ){
+      const REAL8 *testrow = tm->data + (k + i)*dlength;
+      REAL8 nrm2 = 0.;
 
-    // un-scale testrow
-    if ( delta->length == 1 ){
-      XLAL_CALLGSL( gsl_vector_scale(testrow, delta->data[0]) );
-    }
-    else if ( testrow->size == deltaview.vector.size ){
-      XLAL_CALLGSL( gsl_vector_mul(testrow, &deltaview.vector) );
-    }
-    else{
-      XLAL_ERROR_VOID(XLAL_EFUNC, "Vector of weights must either contain a single value, or be the same length as the other input vectors.");
+      // scale testrow by the weights and get its normalisation (should be 1 as test models are normalised)
+      for ( j = 0; j < dlength; j++ ){
+        REAL8 wj = ( delta->length == 1 ) ? delta->data[0] : delta->data[j];
+        testblock[i*dlength + j] = wj*testrow[j];
+        nrm2 += wj*testrow[j]*testrow[j];
+      }
+      pe->data[k + i] = sqrt(nrm2);
     }
 
-    // get projections
-    XLAL_CALLGSL( gsl_blas_dgemv( CblasNoTrans, 1., &RBview.matrix, testrow, 0., r_tmp ) );
+    // get projections of the block of test models
+    gsl_matrix_view testview, projview;
+    testview = gsl_matrix_view_array(testblock, nb, dlength);
+    projview = gsl_matrix_view_array(projblock, nb, nRB);
+    XLAL_CALLGSL( gsl_blas_dgemm( CblasNoTrans, CblasTrans, 1., &testview.matrix, &RBview.matrix, 0., &projview.matrix ) );
 
-    r_tmp_nrm = gsl_blas_dnrm2( r_tmp );
-    pe->data[k] = nrm - r_tmp_nrm*r_tmp_nrm;
+    for ( i = 0; i < nb; i++ ){
+      REAL8 r_tmp_nrm2 = 0.;
+      for ( j = 0; j < nRB; j++ ){ r_tmp_nrm2 += projblock[i*nRB + j]*projblock[i*nRB + j]; }
+      pe->data[k + i] -= r_tmp_nrm2;
 
-    if ( pe->data[k] < 0. ) { pe->data[k] = 1.0e-16; } // floating point error can trigger this
+      if ( pe->data[k + i] < 0. ) { pe->data[k + i] = 1.0e-16; } // floating point error can trigger this
+    }
   }
 
-  XLAL_CALLGSL( gsl_vector_free( testrow ) );
-  XLAL_CALLGSL( gsl_vector_free( r_tmp ) );
+  XLALFree( testblock );
+  XLALFree( projblock );
 }
 
 
@@ -1424,9 +1457,10 @@ void LALInferenceValidateCOMPLEX16OrthonormalBasis(REAL8Vector **projerr,
   COMPLEX16Array *tm = NULL;
   tm = *testmodels;
 
-  size_t dlength = RB->dimLength->data[1], nts = tm->dimLength->data[0];
-  size_t k = 0, j = 0;
-  gsl_vector_complex *r_tmp, *testrow;
+  size_t dlength = RB->dimLength->data[1], nts = tm->dimLength->data[0], nRB = RB->dimLength->data[0];
+  size_t k = 0, i = 0, j = 0;
+
+  XLAL_CHECK_VOID( delta->length == 1 || delta->length == dlength, XLAL_EFUNC, "Vector of weights must either contain a single value, or be the same length as the other input vectors." );
 
   /* normalise the test set */
   gsl_vector_view deltaview;
@@ -1435,57 +1469,54 @@ void LALInferenceValidateCOMPLEX16OrthonormalBasis(REAL8Vector **projerr,
   XLAL_CALLGSL( testmodelsview = gsl_matrix_complex_view_array((double *)tm->data, nts, dlength) );
   complex_normalise_training_set(&deltaview.vector, &testmodelsview.matrix);
 
-  gsl_matrix_complex_view RBview;
-  RBview = gsl_matrix_complex_view_array((double *)RB->data, RB->dimLength->data[0], dlength);
-
-  XLAL_CALLGSL( testrow = gsl_vector_complex_alloc(dlength) );
-  XLAL_CALLGSL( r_tmp = gsl_vector_complex_alloc(RB->dimLength->data[0]) );
+  gsl_matrix_complex_const_view RBview;
+  RBview = gsl_matrix_complex_const_view_array((const double *)RB->data, nRB, dlength);
 
   REAL8Vector *pe = NULL;
   pe = XLALCreateREAL8Vector( nts );
   *projerr = pe;
 
-  /* get projection errors for each test model */
-  for ( k = 0; k < nts; k++ ){
-    pe->data[k] = 0.;
-    REAL8 r_tmp_nrm = 0.;
+  /* blocks of weighted (complex conjugate) test models and their projections onto the reduced basis */
+  COMPLEX16 *testblock = XLALMalloc(ROQ_BLOCK_SIZE*dlength*sizeof(COMPLEX16));
+  COMPLEX16 *projblock = XLALMalloc(ROQ_BLOCK_SIZE*nRB*sizeof(COMPLEX16));
 
-    XLAL_CALLGSL( gsl_matrix_complex_get_row(testrow, &testmodelsview.matrix, k) );
+  /* get projection errors for each test model */
+  for ( k = 0; k < nts; k += ROQ_BLOCK_SIZE ){
+    size_t nb = ( nts - k < ROQ_BLOCK_SIZE ) ? nts - k : ROQ_BLOCK_SIZE;
 
-    REAL8 nrm = complex_normalisation(&deltaview.vector, testrow); // normalisation (should be 1 as test models are normalised)
+    #pragma omp parallel for private(j) schedule(static)
+    for ( i = 0; i < nb; i++ ){
+      const COMPLEX16 *testrow = tm->data + (k + i)*dlength;
+      REAL8 nrm2 = 0.;
 
-    // un-scale testrow (gsl_vector_complex_mul doesn't work when delta is a real vector)
-    if ( delta->length == 1 || testrow->size == deltaview.vector.size ){
+      // scale the complex conjugate of testrow by the weights and get its normalisation (should be 1 as test models are normalised)
       for ( j = 0; j < dlength; j++ ){
-        gsl_complex ctmp;
-        XLAL_CALLGSL( ctmp = gsl_vector_complex_get( testrow, j ) );
-        if ( delta->length == 1 ){
-          XLAL_CALLGSL( ctmp = gsl_complex_mul_real( ctmp, delta->data[0] ) );
-        }
-        else{
-          XLAL_CALLGSL( ctmp = gsl_complex_mul_real( ctmp, delta->data[j] ) );
-        }
-        XLAL_CALLGSL( gsl_vector_complex_set( testrow, j, ctmp ) );
+        REAL8 wj = ( delta->length == 1 ) ? delta->data[0] : delta->data[j];
+        testblock[i*dlength + j] = wj*conj(testrow[j]);
+        nrm2 += wj*(creal(testrow[j])*creal(testrow[j]) + cimag(testrow[j])*cimag(testrow[j]));
       }
+      pe->data[k + i] = sqrt(nrm2);
     }
-    else{
-      XLAL_ERROR_VOID( XLAL_EFUNC, "Vector of weights must either contain a single value, or be the same length as the other input vectors." );
-    }
-    
-    // get complex conjugate
-    for ( j = 0; j < testrow->size; j++ ){ testrow->data[2*j+1] = -testrow->data[2*j+1]; }
 
-    // get projections
-    XLAL_CALLGSL( gsl_blas_zgemv( CblasNoTrans, GSL_COMPLEX_ONE, &RBview.matrix, testrow, GSL_COMPLEX_ZERO, r_tmp ) );
+    // get projections of the block of test models
+    gsl_matrix_complex_view testview, projview;
+    testview = gsl_matrix_complex_view_array((double *)testblock, nb, dlength);
+    projview = gsl_matrix_complex_view_array((double *)projblock, nb, nRB);
+    XLAL_CALLGSL( gsl_blas_zgemm( CblasNoTrans, CblasTrans, GSL_COMPLEX_ONE, &testview.matrix, &RBview.matrix, GSL_COMPLEX_ZERO, &projview.matrix ) );
 
-    r_tmp_nrm = gsl_blas_dznrm2(r_tmp);
-    pe->data[k] = nrm - r_tmp_nrm*r_tmp_nrm;
+    for ( i = 0; i < nb; i++ ){
+      REAL8 r_tmp_nrm2 = 0.;
+      for ( j = 0; j < nRB; j++ ){
+        r_tmp_nrm2 += creal(projblock[i*nRB + j])*creal(projblock[i*nRB + j]) + cimag(projblock[i*nRB + j])*cimag(projblock[i*nRB + j]);
+      }
+      pe->data[k + i] -= r_tmp_nrm2;
 
-    if ( pe->data[k] < 0. ) { pe->data[k] = 1.0e-16; } // floating point error can trigger this
+      if ( pe->data[k + i] < 0. ) { pe->data[k + i] = 1.0e-16; } // floating point error can trigger this
+    }
   }
 
-  XLAL_CALLGSL( gsl_vector_complex_free( testrow ) );
-  XLAL_CALLGSL( gsl_vector_complex_free( r_tmp ) );
+  XLALFree( testblock );
+  XLALFree( projblock );
 }
 
 
@@ -1672,6 +1703,11 @@ REAL8 LALInferenceEnrichCOMPLEX16Basis(const REAL8Vector *delta,
  * empirical intopolant, and set of interpolation points, using Algorithm 2 of
  * \cite FGHKT2014 .
  *
+ * The interpolation nodes are found incrementally: the residual of the interpolant of each new basis
+ * vanishes at all the previous nodes, so the matrix of residuals evaluated at the nodes is lower
+ * triangular and each new node only requires a triangular solve and a matrix-vector product,
+ * rather than the inversion of the full interpolation matrix at every step.
+ *
  * @param[in] RB The set of basis functions
  *
  * @return A \c LALInferenceREALROQInterpolant structure containing the interpolant and its nodes
@@ -1682,65 +1718,55 @@ LALInferenceREALROQInterpolant *LALInferenceGenerateREALROQInterpolant(REAL8Arra
   size_t RBsize = RB->dimLength->data[0];  /* reduced basis size (no. of reduced bases) */
   size_t dlength = RB->dimLength->data[1]; /* length of each base */
   size_t i=1, j=0, k=0;
-  REAL8 *V = XLALMalloc(sizeof(REAL8));
-  gsl_matrix_view Vview;
 
   LALInferenceREALROQInterpolant *interp = XLALMalloc(sizeof(LALInferenceREALROQInterpolant));
-  int idmax = 0, newidx = 0;
 
-  /* get index of maximum absolute value of first basis */
+  /* residuals of the empirical interpolant for each basis (the first being the first basis), and the
+   * lower triangular matrix containing the residuals evaluated at the interpolation nodes */
+  REAL8 *U = XLALMalloc(RBsize*dlength*sizeof(REAL8));
+  REAL8 *PTU = XLALCalloc(RBsize*RBsize, sizeof(REAL8));
+  REAL8 *c = XLALMalloc(RBsize*sizeof(REAL8));
+
   gsl_matrix_view RBview;
   RBview = gsl_matrix_view_array( RB->data, RBsize, dlength );
-  gsl_vector_view firstbasis = gsl_matrix_row(&RBview.matrix, 0);
-  XLAL_CALLGSL( idmax = (int)gsl_blas_idamax(&firstbasis.vector) ); /* function gets index of maximum absolute value */
+
+  /* get index of maximum absolute value of first basis */
+  memcpy(U, RB->data, dlength*sizeof(REAL8));
+  gsl_vector_view firstbasis = gsl_vector_view_array(U, dlength);
 
   interp->nodes = XLALMalloc(RBsize*sizeof(UINT4));
-  interp->nodes[0] = idmax;
+  XLAL_CALLGSL( interp->nodes[0] = (UINT4)gsl_blas_idamax(&firstbasis.vector) ); /* function gets index of maximum absolute value */
 
   for ( i=1; i<RBsize; i++ ){
-    gsl_vector *interpolant, *subbasis;
-    gsl_vector_view subview;
-
-    Vview = gsl_matrix_view_array(V, i, i);
+    gsl_matrix_view PTUview, Uview;
+    gsl_vector_view cview, residual;
 
-    for ( j=0; j<i; j++ ){
-      for ( k=0; k<i; k++ ){
-        XLAL_CALLGSL( gsl_matrix_set(&Vview.matrix, k, j, gsl_matrix_get(&RBview.matrix, j, interp->nodes[k])) );
-      }
-    }
+    /* add the previous residual at the interpolation nodes */
+    for ( j=0; j<i; j++ ){ PTU[(i-1)*RBsize + j] = U[j*dlength + interp->nodes[i-1]]; }
 
-    /* get B matrix */
-    REAL8Array *B = B_matrix(&Vview.matrix, &RBview.matrix);
-    gsl_matrix_view Bview;
-    Bview = gsl_matrix_view_array(B->data, B->dimLength->data[0], B->dimLength->data[1]);
+    /* get the coefficients of the empirical interpolant of the basis at the current nodes */
+    for ( k=0; k<i; k++ ){ c[k] = RB->data[i*dlength + interp->nodes[k]]; }
 
-    /* make empirical interpolant of basis */
-    XLAL_CALLGSL( interpolant = gsl_vector_calloc(dlength) );
-    XLAL_CALLGSL( subbasis = gsl_vector_calloc(i) );
-    XLAL_CALLGSL( subview = gsl_matrix_row(&RBview.matrix, i) );
-
-    for ( k=0; k<i; k++ ){
-      XLAL_CALLGSL( gsl_vector_set(subbasis, k, gsl_vector_get(&subview.vector, interp->nodes[k])) );
-    }
-
-    XLAL_CALLGSL( gsl_blas_dgemv(CblasTrans, 1.0, &Bview.matrix, subbasis, 0., interpolant) );
+    PTUview = gsl_matrix_view_array_with_tda(PTU, i, i, RBsize);
+    cview = gsl_vector_view_array(c, i);
+    XLAL_CALLGSL( gsl_blas_dtrsv(CblasLower, CblasNoTrans, CblasNonUnit, &PTUview.matrix, &cview.vector) );
 
     /* get residuals of interpolant */
-    XLAL_CALLGSL( gsl_vector_sub(interpolant, &subview.vector) );
-
-    XLAL_CALLGSL( newidx = (int)gsl_blas_idamax(interpolant) );
-
-    interp->nodes[i] = newidx;
-
-    XLAL_CALLGSL( gsl_vector_free(subbasis) );
-    XLALDestroyREAL8Array( B );
-    XLAL_CALLGSL( gsl_vector_free(interpolant) );
+    memcpy(U + i*dlength, RB->data + i*dlength, dlength*sizeof(REAL8));
+    Uview = gsl_matrix_view_array(U, i, dlength);
+    residual = gsl_vector_view_array(U + i*dlength, dlength);
+    XLAL_CALLGSL( gsl_blas_dgemv(CblasTrans, -1.0, &Uview.matrix, &cview.vector, 1., &residual.vector) );
 
-    /* reallocate memory for V */
-    V = XLALRealloc(V, (i+1)*(i+1)*sizeof(REAL8));
+    XLAL_CALLGSL( interp->nodes[i] = (UINT4)gsl_blas_idamax(&residual.vector) );
   }
 
+  XLALFree(U);
+  XLALFree(PTU);
+  XLALFree(c);
+
   /* get final B vector with all the indices */
+  REAL8 *V = XLALMalloc(RBsize*RBsize*sizeof(REAL8));
+  gsl_matrix_view Vview;
   Vview = gsl_matrix_view_array(V, RBsize, RBsize);
   for( j=0; j<RBsize; j++ ){
     for( k=0; k<RBsize; k++ ){
@@ -1764,6 +1790,11 @@ LALInferenceREALROQInterpolant *LALInferenceGenerateREALROQInterpolant(REAL8Arra
  * empirical intopolant, and set of interpolation points, using Algorithm 2 of
  * \cite FGHKT2014 .
  *
+ * The interpolation nodes are found incrementally: the residual of the interpolant of each new basis
+ * vanishes at all the previous nodes, so the matrix of residuals evaluated at the nodes is lower
+ * triangular and each new node only requires a triangular solve and a matrix-vector product,
+ * rather than the inversion of the full interpolation matrix at every step.
+ *
  * @param[in] RB The set of basis functions
  *
  * @return A \c LALInferenceCOMPLEXROQInterpolant structure containing the interpolant and its nodes
@@ -1774,65 +1805,55 @@ LALInferenceCOMPLEXROQInterpolant *LALInferenceGenerateCOMPLEXROQInterpolant(COM
   size_t RBsize = RB->dimLength->data[0]; /* reduced basis size (no. of reduced bases) */
   size_t dlength = RB->dimLength->data[1]; /* length of each base */
   size_t i=1, j=0, k=0;
-  REAL8 *V = XLALMalloc(sizeof(COMPLEX16));
-  gsl_matrix_complex_view Vview;
 
   LALInferenceCOMPLEXROQInterpolant *interp = XLALMalloc(sizeof(LALInferenceCOMPLEXROQInterpolant));
-  int idmax = 0, newidx = 0;
 
-  /* get index of maximum absolute value of first basis */
+  /* residuals of the empirical interpolant for each basis (the first being the first basis), and the
+   * lower triangular matrix containing the residuals evaluated at the interpolation nodes */
+  COMPLEX16 *U = XLALMalloc(RBsize*dlength*sizeof(COMPLEX16));
+  COMPLEX16 *PTU = XLALCalloc(RBsize*RBsize, sizeof(COMPLEX16));
+  COMPLEX16 *c = XLALMalloc(RBsize*sizeof(COMPLEX16));
+
   gsl_matrix_complex_view RBview;
   RBview = gsl_matrix_complex_view_array((double *)RB->data, RBsize, dlength);
-  gsl_vector_complex_view firstbasis = gsl_matrix_complex_row(&RBview.matrix, 0);
-  idmax = complex_vector_maxabs_index(&firstbasis.vector);
+
+  /* get index of maximum absolute value of first basis */
+  memcpy(U, RB->data, dlength*sizeof(COMPLEX16));
+  gsl_vector_complex_view firstbasis = gsl_vector_complex_view_array((double *)U, dlength);
 
   interp->nodes = XLALMalloc(RBsize*sizeof(UINT4));
-  interp->nodes[0] = idmax;
+  interp->nodes[0] = complex_vector_maxabs_index(&firstbasis.vector);
 
   for ( i=1; i<RBsize; i++ ){
-    gsl_vector_complex *interpolant, *subbasis;
-    gsl_vector_complex_view subview;
-
-    Vview = gsl_matrix_complex_view_array(V, i, i);
-
-    for ( j=0; j<i; j++ ){
-      for ( k=0; k<i; k++ ){
-        XLAL_CALLGSL( gsl_matrix_complex_set(&Vview.matrix, k, j, gsl_matrix_complex_get(&RBview.matrix, j, interp->nodes[k])) );
-      }
-    }
+    gsl_matrix_complex_view PTUview, Uview;
+    gsl_vector_complex_view cview, residual;
 
-    /* get B matrix */
-    COMPLEX16Array *B = complex_B_matrix(&Vview.matrix, &RBview.matrix);
-    gsl_matrix_complex_view Bview;
-    Bview = gsl_matrix_complex_view_array((double *)B->data, B->dimLength->data[0], B->dimLength->data[1]);
+    /* add the previous residual at the interpolation nodes */
+    for ( j=0; j<i; j++ ){ PTU[(i-1)*RBsize + j] = U[j*dlength + interp->nodes[i-1]]; }
 
-    /* make empirical interpolant of basis */
-    XLAL_CALLGSL( interpolant = gsl_vector_complex_calloc(dlength) );
-    XLAL_CALLGSL( subbasis = gsl_vector_complex_calloc(i) );
-    XLAL_CALLGSL( subview = gsl_matrix_complex_row(&RBview.matrix, i) );
-
-    for ( k=0; k<i; k++ ){
-      XLAL_CALLGSL( gsl_vector_complex_set(subbasis, k, gsl_vector_complex_get(&subview.vector, interp->nodes[k])) );
-    }
+    /* get the coefficients of the empirical interpolant of the basis at the current nodes */
+    for ( k=0; k<i; k++ ){ c[k] = RB->data[i*dlength + interp->nodes[k]]; }
 
-    XLAL_CALLGSL( gsl_blas_zgemv(CblasTrans, GSL_COMPLEX_ONE, &Bview.matrix, subbasis, GSL_COMPLEX_ZERO, interpolant) );
+    PTUview = gsl_matrix_complex_view_array_with_tda((double *)PTU, i, i, RBsize);
+    cview = gsl_vector_complex_view_array((double *)c, i);
+    XLAL_CALLGSL( gsl_blas_ztrsv(CblasLower, CblasNoTrans, CblasNonUnit, &PTUview.matrix, &cview.vector) );
 
     /* get residuals of interpolant */
-    XLAL_CALLGSL( gsl_vector_complex_sub(interpolant, &subview.vector) );
-
-    newidx = complex_vector_maxabs_index(interpolant);
-
-    interp->nodes[i] = newidx;
-
-    XLAL_CALLGSL( gsl_vector_complex_free(subbasis) );
-    XLALDestroyCOMPLEX16Array( B );
-    XLAL_CALLGSL( gsl_vector_complex_free(interpolant) );
+    memcpy(U + i*dlength, RB->data + i*dlength, dlength*sizeof(COMPLEX16));
+    Uview = gsl_matrix_complex_view_array((double *)U, i, dlength);
+    residual = gsl_vector_complex_view_array((double *)(U + i*dlength), dlength);
+    XLAL_CALLGSL( gsl_blas_zgemv(CblasTrans, GSL_COMPLEX_NEGONE, &Uview.matrix, &cview.vector, GSL_COMPLEX_ONE, &residual.vector) );
 
-    /* reallocate memory for V */
-    V = XLALRealloc(V, (i+1)*(i+1)*sizeof(COMPLEX16));
+    interp->nodes[i] = complex_vector_maxabs_index(&residual.vector);
   }
 
+  XLALFree(U);
+  XLALFree(PTU);
+  XLALFree(c);
+
   /* get final B vector with all the indices */
+  COMPLEX16 *V = XLALMalloc(RBsize*RBsize*sizeof(COMPLEX16));
+  gsl_matrix_complex_view Vview;
   Vview = gsl_matrix_complex_view_array((double*)V, RBsize, RBsize);
   for( j=0; j<RBsize; j++ ){
     for( k=0; k<RBsize; k++ ){
@@ -1968,6 +1989,324 @@ COMPLEX16Vector *LALInferenceGenerateCOMPLEX16LinearWeights(COMPLEX16Array *B, C
 }
 
 
+/** \brief Get the first frequency bin of the data corresponding to the first interpolant point
+ *
+ * @param[out] kmin The index of the data frequency bin at \c fmin
+ * @param[in] fmin The frequency of the first interpolant point
+ * @param[in] deltaF The frequency resolution of the data
+ * @param[in] dlength The number of interpolant points
+ * @param[in] datalength The number of frequency bins in the data
+ * @param[in] psd The noise power spectral density of the data
+ *
+ * @return \c XLAL_SUCCESS if the interpolant frequency range is covered by the data and PSD
+ */
+static INT4 roq_first_frequency_bin(size_t *kmin,
+                                    REAL8 fmin,
+                                    REAL8 deltaF,
+                                    size_t dlength,
+                                    size_t datalength,
+                                    const REAL8FrequencySeries *psd){
+  XLAL_CHECK( fmin >= 0. && deltaF > 0., XLAL_EINVAL, "Minimum frequency and frequency step must be positive" );
+  XLAL_CHECK( fabs(psd->deltaF - deltaF) <= 1e-6*deltaF, XLAL_EINVAL, "Data and PSD have different frequency resolutions" );
+
+  *kmin = (size_t)floor(fmin/deltaF + 0.5);
+
+  XLAL_CHECK( *kmin + dlength <= datalength && *kmin + dlength <= psd->data->length, XLAL_EINVAL, "Interpolant frequency range extends beyond the data" );
+
+  return XLAL_SUCCESS;
+}
+
+
+/** \brief Create the time shifted ROQ weights for the linear data and model term <d|h> from detector data
+ *
+ * The weights are calculated for each interpolation node \f$i\f$ and each time shift \f$t_c\f$ as
+ * \f[
+ * w_i(t_c) = 4\Delta f \sum_k \frac{\tilde{d}(f_k)}{S_n(f_k)} B^*_{ik} e^{2\pi i f_k t_c},
+ * \f]
+ * where the \f$f_k = f_{\rm min} + k\Delta f\f$ are the frequencies of the interpolant points. These
+ * are the weights expected for the <tt>--<ifo>-roqweightsLinear</tt> file read by
+ * \c LALInferenceSetupROQdata. The time shifted data is formed in blocks of time shifts and multiplied
+ * by the interpolant with a (threaded) BLAS matrix-matrix product. Frequency bins with non-finite data
+ * or a non-positive or non-finite PSD are given zero weight.
+ *
+ * @param[in] B The complex interpolant matrix (with a row for each node)
+ * @param[in] data The frequency domain data
+ * @param[in] psd The one-sided noise power spectral density of the data
+ * @param[in] fmin The frequency of the first interpolant point
+ * @param[in] tcs The time shifts at which to calculate the weights
+ *
+ * @return A \c COMPLEX16Array of weights with a row for each node and a column for each time shift
+ */
+COMPLEX16Array *LALInferenceGenerateROQLinearWeightsFromData(const COMPLEX16Array *B,
+                                                             const COMPLEX16FrequencySeries *data,
+                                                             const REAL8FrequencySeries *psd,
+                                                             REAL8 fmin,
+                                                             const REAL8Vector *tcs){
+  XLAL_CHECK_NULL( B != NULL && data != NULL && psd != NULL && tcs != NULL, XLAL_EFAULT, "Input is NULL!" );
+  XLAL_CHECK_NULL( B->dimLength->length == 2, XLAL_EFUNC, "Interpolant matrix must have two dimensions" );
+
+  size_t nnodes = B->dimLength->data[0], dlength = B->dimLength->data[1], ntcs = tcs->length;
+  size_t kmin = 0, k = 0, t = 0, i = 0;
+  REAL8 deltaF = data->deltaF;
+
+  XLAL_CHECK_NULL( roq_first_frequency_bin(&kmin, fmin, deltaF, dlength, data->data->length, psd) == XLAL_SUCCESS, XLAL_EFUNC );
+
+  /* data weighted by the inverse PSD, including the factor of 4 deltaF for the inner product */
+  COMPLEX16 *wdata = XLALMalloc(dlength*sizeof(COMPLEX16));
+  for ( k = 0; k < dlength; k++ ){
+    COMPLEX16 d = data->data->data[kmin + k];
+    REAL8 S = psd->data->data[kmin + k];
+
+    if ( isfinite(creal(d)) && isfinite(cimag(d)) && isfinite(S) && S > 0. ){ wdata[k] = 4.*deltaF*d/S; }
+    else{ wdata[k] = 0.; }
+  }
+
+  UINT4Vector *dims = XLALCreateUINT4Vector( 2 );
+  dims->data[0] = nnodes;
+  dims->data[1] = ntcs;
+  COMPLEX16Array *weights = XLALCreateCOMPLEX16Array( dims );
+  XLALDestroyUINT4Vector( dims );
+
+  COMPLEX16 *shifted = XLALMalloc(ROQ_BLOCK_SIZE*dlength*sizeof(COMPLEX16));
+  COMPLEX16 *wblock = XLALMalloc(ROQ_BLOCK_SIZE*nnodes*sizeof(COMPLEX16));
+
+  gsl_matrix_complex_const_view Bview;
+  Bview = gsl_matrix_complex_const_view_array((const double *)B->data, nnodes, dlength);
+
+  for ( size_t t0 = 0; t0 < ntcs; t0 += ROQ_BLOCK_SIZE ){
+    size_t nb = ( ntcs - t0 < ROQ_BLOCK_SIZE ) ? ntcs - t0 : ROQ_BLOCK_SIZE;
+
+    /* time shift the data for this block of time shifts */
+    #pragma omp parallel for private(k) schedule(static)
+    for ( t = 0; t < nb; t++ ){
+      REAL8 twopitc = LAL_TWOPI*tcs->data[t0 + t];
+      for ( k = 0; k < dlength; k++ ){
+        shifted[t*dlength + k] = wdata[k]*cexp(I*twopitc*(kmin + k)*deltaF);
+      }
+    }
+
+    /* weights are the time shifted data multiplied by the Hermitian conjugate of the interpolant */
+    gsl_matrix_complex_view shiftedview, wview;
+    shiftedview = gsl_matrix_complex_view_array((double *)shifted, nb, dlength);
+    wview = gsl_matrix_complex_view_array((double *)wblock, nb, nnodes);
+    XLAL_CALLGSL( gsl_blas_zgemm(CblasNoTrans, CblasConjTrans, GSL_COMPLEX_ONE, &shiftedview.matrix, &Bview.matrix, GSL_COMPLEX_ZERO, &wview.matrix) );
+
+    for ( t = 0; t < nb; t++ ){
+      for ( i = 0; i < nnodes; i++ ){ weights->data[i*ntcs + t0 + t] = wblock[t*nnodes + i]; }
+    }
+  }
+
+  XLALFree( wdata );
+  XLALFree( shifted );
+  XLALFree( wblock );
+
+  return weights;
+}
+
+
+/** \brief Create the ROQ weights for the quadratic model term real(<h|h>) from a noise PSD
+ *
+ * The weights are calculated for each interpolation node \f$i\f$ as
+ * \f[
+ * w_i = 4\Delta f \sum_k \frac{B_{ik}}{S_n(f_k)},
+ * \f]
+ * where the \f$f_k = f_{\rm min} + k\Delta f\f$ are the frequencies of the interpolant points. These
+ * are the weights expected for the <tt>--<ifo>-roqweightsQuadratic</tt> file read by
+ * \c LALInferenceSetupROQdata. Frequency bins with a non-positive or non-finite PSD are given zero
+ * weight.
+ *
+ * @param[in] B The real interpolant matrix (with a row for each node)
+ * @param[in] psd The one-sided noise power spectral density
+ * @param[in] fmin The frequency of the first interpolant point
+ *
+ * @return The vector of weights
+ */
+REAL8Vector *LALInferenceGenerateROQQuadraticWeightsFromPSD(const REAL8Array *B,
+                                                            const REAL8FrequencySeries *psd,
+                                                            REAL8 fmin){
+  XLAL_CHECK_NULL( B != NULL && psd != NULL, XLAL_EFAULT, "Input is NULL!" );
+  XLAL_CHECK_NULL( B->dimLength->length == 2, XLAL_EFUNC, "Interpolant matrix must have two dimensions" );
+
+  size_t nnodes = B->dimLength->data[0], dlength = B->dimLength->data[1];
+  size_t kmin = 0, k = 0;
+
+  XLAL_CHECK_NULL( roq_first_frequency_bin(&kmin, fmin, psd->deltaF, dlength, psd->data->length, psd) == XLAL_SUCCESS, XLAL_EFUNC );
+
+  /* inverse PSD, including the factor of 4 deltaF for the inner product */
+  gsl_vector *invpsd;
+  XLAL_CALLGSL( invpsd = gsl_vector_alloc(dlength) );
+  for ( k = 0; k < dlength; k++ ){
+    REAL8 S = psd->data->data[kmin + k];
+    gsl_vector_set(invpsd, k, ( isfinite(S) && S > 0. ) ? 4.*psd->deltaF/S : 0.);
+  }
+
+  /* create weights */
+  REAL8Vector *weights = XLALCreateREAL8Vector( nnodes );
+  gsl_matrix_const_view Bview;
+  gsl_vector_view weightsview;
+  Bview = gsl_matrix_const_view_array(B->data, nnodes, dlength);
+  weightsview = gsl_vector_view_array(weights->data, weights->length);
+  XLAL_CALLGSL( gsl_blas_dgemv(CblasNoTrans, 1.0, &Bview.matrix, invpsd, 0., &weightsview.vector) );
+  XLAL_CALLGSL( gsl_vector_free( invpsd ) );
+
+  return weights;
+}
+
+
+/** \brief Free ROQ data built by \c LALInferenceSetupROQDataFromInterpolants
+ *
+ * @param[in] roq The ROQ data (can be \c NULL or partially filled)
+ * @param[in] nlinear The number of linear interpolant nodes (splined weights)
+ */
+static void roq_destroy_data(LALInferenceROQData *roq, size_t nlinear){
+  if ( roq == NULL ){ return; }
+
+  if ( roq->weights_linear != NULL ){
+    for ( size_t i = 0; i < nlinear; i++ ){
+      if ( roq->weights_linear[i].spline_real_weight_linear ){ gsl_spline_free( roq->weights_linear[i].spline_real_weight_linear ); }
+      if ( roq->weights_linear[i].spline_imag_weight_linear ){ gsl_spline_free( roq->weights_linear[i].spline_imag_weight_linear ); }
+    }
+    XLALFree( roq->weights_linear );
+  }
+  XLALFree( roq->weightsLinear );
+  XLALFree( roq->weightsQuadratic );
+  XLALFree( roq );
+}
+
+
+/** \brief Set up the ROQ likelihood data for a set of detectors from a pair of interpolants
+ *
+ * This does in-process what \c lalinference_compute_roq_weights.py followed by
+ * \c LALInferenceSetupROQdata and \c LALInferenceSetupROQmodel do through files: for each detector
+ * the linear weights (at each time shift in \c tcs) and quadratic weights are computed from its
+ * frequency domain data and PSD, and the linear weights are splined as a function of time shift. If
+ * a \c model is given its ROQ structure is allocated (if needed) and filled with the frequency nodes
+ * of the two interpolants.
+ *
+ * The time shifts must be in increasing order and cover the range of time shifts that will be
+ * explored by the likelihood (the time prior width plus the maximum light travel time between
+ * detectors).
+ *
+ * @param[in] IFOdata The linked list of detector data (the ROQ data for each must not already be set)
+ * @param[in] model The model to hold the frequency nodes (can be \c NULL)
+ * @param[in] linear The interpolant for the linear data and model term
+ * @param[in] quadratic The interpolant for the quadratic model term
+ * @param[in] fmin The frequency of the first interpolant point
+ * @param[in] tcs The time shifts at which to calculate the linear weights
+ *
+ * @return \c XLAL_SUCCESS on success
+ */
+INT4 LALInferenceSetupROQDataFromInterpolants(LALInferenceIFOData *IFOdata,
+                                              LALInferenceModel *model,
+                                              const LALInferenceCOMPLEXROQInterpolant *linear,
+                                              const LALInferenceREALROQInterpolant *quadratic,
+                                              REAL8 fmin,
+                                              const REAL8Vector *tcs){
+  XLAL_CHECK( IFOdata != NULL && linear != NULL && quadratic != NULL && tcs != NULL, XLAL_EFAULT, "Input is NULL!" );
+  XLAL_CHECK( tcs->length >= 3, XLAL_EINVAL, "At least three time shifts are required to spline the linear weights" );
+  XLAL_CHECK( IFOdata->freqData != NULL, XLAL_EFAULT, "Detector %s has no frequency domain data", IFOdata->name );
+
+  size_t nlinear = linear->B->dimLength->data[0], nquadratic = quadratic->B->dimLength->data[0];
+  size_t ntcs = tcs->length, i = 0, t = 0;
+  REAL8 deltaF = IFOdata->freqData->deltaF;
+
+  for ( LALInferenceIFOData *ifo = IFOdata; ifo != NULL; ifo = ifo->next ){
+    XLAL_CHECK( ifo->freqData != NULL && ifo->oneSidedNoisePowerSpectrum != NULL, XLAL_EFAULT, "Detector %s has no frequency domain data or PSD", ifo->name );
+    XLAL_CHECK( fabs(ifo->freqData->deltaF - deltaF) <= 1e-6*deltaF, XLAL_EINVAL, "All detectors must have the same frequency resolution" );
+    XLAL_CHECK( ifo->roq == NULL, XLAL_EINVAL, "ROQ data for %s has already been set up", ifo->name );
+  }
+
+  COMPLEX16Array *wlinear = NULL;
+  REAL8Vector *wquadratic = NULL;
+  REAL8 *realweight = XLALMalloc(ntcs*sizeof(REAL8));
+  REAL8 *imagweight = XLALMalloc(ntcs*sizeof(REAL8));
+  XLAL_CHECK_FAIL( realweight != NULL && imagweight != NULL, XLAL_ENOMEM );
+
+  for ( LALInferenceIFOData *ifo = IFOdata; ifo != NULL; ifo = ifo->next ){
+    wlinear = LALInferenceGenerateROQLinearWeightsFromData(linear->B, ifo->freqData, ifo->oneSidedNoisePowerSpectrum, fmin, tcs);
+    XLAL_CHECK_FAIL( wlinear != NULL, XLAL_EFUNC, "Could not create linear ROQ weights for %s", ifo->name );
+    wquadratic = LALInferenceGenerateROQQuadraticWeightsFromPSD(quadratic->B, ifo->oneSidedNoisePowerSpectrum, fmin);
+    XLAL_CHECK_FAIL( wquadratic != NULL, XLAL_EFUNC, "Could not create quadratic ROQ weights for %s", ifo->name );
+
+    ifo->roq = XLALCalloc(1, sizeof(LALInferenceROQData));
+    XLAL_CHECK_FAIL( ifo->roq != NULL, XLAL_ENOMEM );
+
+    ifo->roq->weightsLinear = XLALMalloc(nlinear*ntcs*sizeof(COMPLEX16));
+    ifo->roq->weightsQuadratic = XLALMalloc(nquadratic*sizeof(REAL8));
+    ifo->roq->weights_linear = XLALCalloc(nlinear, sizeof(LALInferenceROQSplineWeights));
+    XLAL_CHECK_FAIL( ifo->roq->weightsLinear != NULL && ifo->roq->weightsQuadratic != NULL && ifo->roq->weights_linear != NULL, XLAL_ENOMEM );
+    memcpy(ifo->roq->weightsLinear, wlinear->data, nlinear*ntcs*sizeof(COMPLEX16));
+    memcpy(ifo->roq->weightsQuadratic, wquadratic->data, nquadratic*sizeof(REAL8));
+
+    ifo->roq->time_weights_width = tcs->data[ntcs-1] - tcs->data[0];
+    ifo->roq->time_step_size = ifo->roq->time_weights_width/ntcs;
+    ifo->roq->n_time_steps = ntcs;
+
+    /* spline the linear weights as a function of time shift */
+    for ( i = 0; i < nlinear; i++ ){
+      for ( t = 0; t < ntcs; t++ ){
+        realweight[t] = creal(ifo->roq->weightsLinear[i*ntcs + t]);
+        imagweight[t] = cimag(ifo->roq->weightsLinear[i*ntcs + t]);
+      }
+
+      //gsl_interp_accel is not thread-safe, and each OpenMP thread will need its
+      //own gsl_interp_accel object.
+      ifo->roq->weights_linear[i].acc_real_weight_linear = NULL;
+      ifo->roq->weights_linear[i].acc_imag_weight_linear = NULL;
+
+      XLAL_CALLGSL( ifo->roq->weights_linear[i].spline_real_weight_linear = gsl_spline_alloc(gsl_interp_cspline, ntcs) );
+      XLAL_CALLGSL( ifo->roq->weights_linear[i].spline_imag_weight_linear = gsl_spline_alloc(gsl_interp_cspline, ntcs) );
+      XLAL_CHECK_FAIL( ifo->roq->weights_linear[i].spline_real_weight_linear != NULL && ifo->roq->weights_linear[i].spline_imag_weight_linear != NULL, XLAL_ENOMEM );
+      XLAL_CALLGSL( gsl_spline_init(ifo->roq->weights_linear[i].spline_real_weight_linear, tcs->data, realweight, ntcs) );
+      XLAL_CALLGSL( gsl_spline_init(ifo->roq->weights_linear[i].spline_imag_weight_linear, tcs->data, imagweight, ntcs) );
+    }
+
+    XLALDestroyCOMPLEX16Array( wlinear );
+    wlinear = NULL;
+    XLALDestroyREAL8Vector( wquadratic );
+    wquadratic = NULL;
+  }
+
+  XLALFree( realweight );
+  XLALFree( imagweight );
+
+  if ( model != NULL ){
+    size_t kmin = (size_t)floor(fmin/deltaF + 0.5);
+
+    if ( model->roq == NULL ){ model->roq = XLALCalloc(1, sizeof(LALInferenceROQModel)); }
+    model->roq_flag = 1;
+
+    if ( model->roq->frequencyNodesLinear ){ XLALDestroyREAL8Sequence( model->roq->frequencyNodesLinear ); }
+    if ( model->roq->frequencyNodesQuadratic ){ XLALDestroyREAL8Sequence( model->roq->frequencyNodesQuadratic ); }
+    if ( model->roq->calFactorLinear ){ XLALDestroyCOMPLEX16Sequence( model->roq->calFactorLinear ); }
+    if ( model->roq->calFactorQuadratic ){ XLALDestroyCOMPLEX16Sequence( model->roq->calFactorQuadratic ); }
+
+    /* the frequency nodes are in the same order as the interpolant (and therefore weights) rows */
+    model->roq->frequencyNodesLinear = XLALCreateREAL8Sequence( nlinear );
+    for ( i = 0; i < nlinear; i++ ){ model->roq->frequencyNodesLinear->data[i] = (kmin + linear->nodes[i])*deltaF; }
+    model->roq->frequencyNodesQuadratic = XLALCreateREAL8Sequence( nquadratic );
+    for ( i = 0; i < nquadratic; i++ ){ model->roq->frequencyNodesQuadratic->data[i] = (kmin + quadratic->nodes[i])*deltaF; }
+
+    model->roq->calFactorLinear = XLALCreateCOMPLEX16Sequence( nlinear );
+    model->roq->calFactorQuadratic = XLALCreateCOMPLEX16Sequence( nquadratic );
+  }
+
+  return XLAL_SUCCESS;
+
+XLAL_FAIL:
+  /* none of the detectors had ROQ data on entry, so free whatever has been set up */
+  for ( LALInferenceIFOData *ifo = IFOdata; ifo != NULL; ifo = ifo->next ){
+    roq_destroy_data( ifo->roq, nlinear );
+    ifo->roq = NULL;
+  }
+  XLALDestroyCOMPLEX16Array( wlinear );
+  XLALDestroyREAL8Vector( wquadratic );
+  XLALFree( realweight );
+  XLALFree( imagweight );
+  return XLAL_FAILURE;
+}
+
+
 /** \brief Calculate the dot product of two vectors using the ROQ iterpolant
  *
  * This function calculates the dot product of two real vectors using the ROQ
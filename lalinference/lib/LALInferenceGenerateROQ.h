@@ -65,6 +65,19 @@ REAL8 LALInferenceGenerateCOMPLEX16OrthonormalBasis(COMPLEX16Array **RB,
                                                     COMPLEX16Array **TS,
                                                     UINT4Vector **greedypoints);
 
+/* functions to create a basis set from a single precision training set of models */
+REAL8 LALInferenceGenerateREAL8OrthonormalBasisFromREAL4(REAL8Array **RB,
+                                                         const REAL8Vector *delta,
+                                                         REAL8 tolerance,
+                                                         REAL4Array **TS,
+                                                         UINT4Vector **greedypoints);
+
+REAL8 LALInferenceGenerateCOMPLEX16OrthonormalBasisFromCOMPLEX8(COMPLEX16Array **RB,
+                                                                const REAL8Vector *delta,
+                                                                REAL8 tolerance,
+                                                                COMPLEX8Array **TS,
+                                                                UINT4Vector **greedypoints);
+
 /* functions to test the basis */
 void LALInferenceValidateREAL8OrthonormalBasis(REAL8Vector **projerr,
                                                const REAL8Vector *delta,
@@ -115,6 +128,26 @@ REAL8Vector *LALInferenceGenerateQuadraticWeights(REAL8Array *B, REAL8Vector *va
 /* create ROQ weights for interpolant to calculate the data dot model terms */
 COMPLEX16Vector *LALInferenceGenerateCOMPLEX16LinearWeights(COMPLEX16Array *B, COMPLEX16Vector *data, REAL8Vector *vars);
 
+/* create time shifted ROQ weights for the linear <d|h> terms directly from detector data and PSD */
+COMPLEX16Array *LALInferenceGenerateROQLinearWeightsFromData(const COMPLEX16Array *B,
+                                                             const COMPLEX16FrequencySeries *data,
+                                                             const REAL8FrequencySeries *psd,
+                                                             REAL8 fmin,
+                                                             const REAL8Vector *tcs);
+
+/* create ROQ weights for the quadratic model terms real(<h|h>) directly from a PSD */
+REAL8Vector *LALInferenceGenerateROQQuadraticWeightsFromPSD(const REAL8Array *B,
+                                                            const REAL8FrequencySeries *psd,
+                                                            REAL8 fmin);
+
+/* set up the ROQ likelihood weights and frequency nodes from a pair of interpolants */
+INT4 LALInferenceSetupROQDataFromInterpolants(LALInferenceIFOData *IFOdata,
+                                              LALInferenceModel *model,
+                                              const LALInferenceCOMPLEXROQInterpolant *linear,
+                                              const LALInferenceREALROQInterpolant *quadratic,
+                                              REAL8 fmin,
+                                              const REAL8Vector *tcs);
+
 /* calculate ROQ version of the dot product (where the model vector is the model just computed at the interpolant points) */
 REAL8 LALInferenceROQREAL8DotProduct(REAL8Vector *weights, REAL8Vector *model);
 COMPLEX16 LALInferenceROQCOMPLEX16DotProduct(COMPLEX16Vector *weights, COMPLEX16Vector *model);
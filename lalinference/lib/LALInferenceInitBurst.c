@@ -240,6 +240,8 @@ LALInferenceModel * LALInferenceInitBurstModel(LALInferenceRunState *state)
   model->params = XLALCalloc(1, sizeof(LALInferenceVariables));
   memset(model->params, 0, sizeof(LALInferenceVariables));
   LALInferenceVariables *currentParams=model->params;
+  model->mb = NULL;
+  model->mb_flag = 0;
 
   UINT4 signal_flag=1;
   ppt = LALInferenceGetProcParamVal(commandLine, "--noiseonly");
@@ -37,6 +37,7 @@
 #include <lal/LALInferenceReadData.h>
 #include <lal/LALInferenceInit.h>
 #include <lal/LALInferenceCalibrationErrors.h>
+#include <lal/LALInferenceMultibanding.h>
 #include <lal/LALSimNeutronStar.h>
 
 static int checkParamInList(const char *list, const char *param);
@@ -244,6 +245,33 @@ void LALInferenceInitCBCThreads(LALInferenceRunState *run_state, INT4 nthreads)
       thread->model->roq_flag=0;
     }
 
+    /* Setup multibanded likelihood */
+    if (LALInferenceGetProcParamVal(commandLine, "--multiband-likelihood")){
+      if (thread->model->roq_flag) {
+        fprintf(stderr, "ERROR: cannot use --multiband-likelihood together with ROQ\n");
+        exit(1);
+      }
+      REAL8 mcMin=0.0, mcMax=0.0, timeMin=0.0, timeMax=0.0;
+      ProcessParamsTable *ppt=LALInferenceGetProcParamVal(commandLine, "--multiband-mc-min");
+      if (ppt)
+        mcMin=atof(ppt->value);
+      else if (LALInferenceCheckMinMaxPrior(run_state->priorArgs, "chirpmass"))
+        LALInferenceGetMinMaxPrior(run_state->priorArgs, "chirpmass", &mcMin, &mcMax);
+      else {
+        fprintf(stderr, "ERROR: --multiband-likelihood needs a chirp mass prior or --multiband-mc-min\n");
+        exit(1);
+      }
+      if (!LALInferenceCheckMinMaxPrior(run_state->priorArgs, "time")) {
+        fprintf(stderr, "ERROR: --multiband-likelihood needs a prior on the arrival time\n");
+        exit(1);
+      }
+      LALInferenceGetMinMaxPrior(run_state->priorArgs, "time", &timeMin, &timeMax);
+      if (LALInferenceSetupMultibandLikelihood(thread->model, run_state->data, mcMin, timeMin, timeMax) != XLAL_SUCCESS) {
+        fprintf(stderr, "ERROR: unable to set up the multibanded likelihood\n");
+        exit(1);
+      }
+    }
+
     LALInferenceCopyVariables(thread->model->params, thread->currentParams);
     LALInferenceCopyVariables(run_state->proposalArgs, thread->proposalArgs);
 
@@ -298,7 +326,7 @@ LALInferenceTemplateFunction LALInferenceInitCBCTemplate(LALInferenceRunState *r
                     --template LALGenerateInspiral (for time-domain templates)\n\
                     --template LAL (for frequency-domain templates)\n");
   }
-  else if(LALInferenceGetProcParamVal(commandLine,"--roqtime_steps")){
+  else if(LALInferenceGetProcParamVal(commandLine,"--roqtime_steps") || LALInferenceGetProcParamVal(commandLine,"--multiband-likelihood")){
   templt=&LALInferenceROQWrapperForXLALSimInspiralChooseFDWaveformSequence;
         fprintf(stderr, "template is \"LALInferenceROQWrapperForXLALSimInspiralChooseFDWaveformSequence\"\n");
   }
@@ -573,6 +601,24 @@ void LALInferenceInitCalibrationVariables(LALInferenceRunState *runState, LALInf
 			  LALInferenceRegisterGaussianVariableREAL8(runState, currentParams, phaseVarName, 0, phase_mean, phase_std, LALINFERENCE_PARAM_LINEAR);
 	  } /* End loop over spline nodes */
 
+	  /* Precompute the spline basis on the likelihood frequency bins, shared by all threads */
+	  REAL8Vector *logFreqs = XLALCreateREAL8Vector(ncal);
+	  for(i=0;i<ncal;i++) logFreqs->data[i] = logFMin + i*dLogF;
+	  REAL8 deltaF = 1.0/(ifo->timeData->data->length*ifo->timeData->deltaT);
+	  UINT4 lower = (UINT4)ceil(ifo->fLow/deltaF);
+	  UINT4 upper = (UINT4)floor(ifo->fHigh/deltaF);
+	  if(!LALInferenceSplineCalibrationBasisMatches(ifo->calBasis, logFreqs, deltaF, lower, upper))
+	  {
+			  LALInferenceDestroySplineCalibrationBasis(ifo->calBasis);
+			  ifo->calBasis = LALInferenceCreateSplineCalibrationBasis(logFreqs, deltaF, lower, upper);
+			  if(!ifo->calBasis)
+			  {
+					  fprintf(stderr,"ERROR: unable to precompute the spline calibration basis for %s\n",ifo->name);
+					  exit(1);
+			  }
+	  }
+	  XLALDestroyREAL8Vector(logFreqs);
+
 	  if(env) destroyCalibrationEnvelope(env);
 	} /* End loop over IFOs */
   } /* End case of spline calibration error */
@@ -951,6 +997,8 @@ LALInferenceModel *LALInferenceInitCBCModel(LALInferenceRunState *state) {
   model->params = XLALCalloc(1, sizeof(LALInferenceVariables));
   memset(model->params, 0, sizeof(LALInferenceVariables));
   model->eos_fam = NULL;
+  model->mb = NULL;
+  model->mb_flag = 0;
 
   UINT4 signal_flag=1;
   ppt = LALInferenceGetProcParamVal(commandLine, "--noiseonly");
@@ -41,6 +41,44 @@
 #define omp ignore
 #endif
 
+/* Maximum number of points held in a leaf of the KDE tree */
+#define KDE_TREE_LEAF_SIZE 16
+
+/* Sets smaller than this are evaluated by brute force, without a tree */
+#define KDE_TREE_MIN_POINTS 64
+
+/* Relative error allowed when truncating the kernel sum at large distances */
+#define KDE_TREE_TOLERANCE 1e-10
+
+/**
+ * A node of the KDE tree, covering points \a start to \a end - 1 of the
+ * (reordered) whitened data set.
+ */
+typedef struct tagKDETreeNode {
+    INT4 start;
+    INT4 end;
+    INT4 left;   /* Index of the child nodes, or -1 for leaves */
+    INT4 right;
+} KDETreeNode;
+
+/**
+ * A kd-tree over the whitened samples of a KDE, split at the median of the
+ * widest dimension of each node, with the bounding box of every node stored
+ * to prune distant nodes while evaluating the kernel sum.
+ */
+struct tagLALInferenceKDETree {
+    INT4 nnodes;
+    INT4 dim;
+    KDETreeNode *nodes;
+    REAL8 *lower;  /* nnodes x dim lower corners of node bounding boxes */
+    REAL8 *upper;  /* nnodes x dim upper corners of node bounding boxes */
+};
+
+static void kde_whiten(const gsl_matrix *L, const REAL8 *x, REAL8 *y, INT4 dim);
+static struct tagLALInferenceKDETree *kde_tree_build(REAL8 *x, INT4 npts, INT4 dim);
+static void kde_tree_destroy(struct tagLALInferenceKDETree *tree);
+static REAL8 kde_log_kernel_sum(LALInferenceKDE *kde, const REAL8 *y);
+
 
 
 /**
@@ -195,6 +233,9 @@ void LALInferenceDestroyKDE(LALInferenceKDE *kde) {
 
         if (kde->npts > 0) gsl_matrix_free(kde->data);
 
+        kde_tree_destroy(kde->tree);
+        XLALFree(kde->whitened_data);
+
         XLALFree(kde->lower_bound_types);
         XLALFree(kde->upper_bound_types);
         XLALFree(kde->lower_bounds);
@@ -250,6 +291,12 @@ void LALInferenceSetKDEBandwidth(LALInferenceKDE *kde) {
     INT4 i, j;
     INT4 status;
 
+    /* Drop any whitened copy of the data from a previous call */
+    kde_tree_destroy(kde->tree);
+    kde->tree = NULL;
+    XLALFree(kde->whitened_data);
+    kde->whitened_data = NULL;
+
     /* If data set is empty, set the normalization to infinity */
     if (kde->npts == 0) {
         kde->log_norm_factor = INFINITY;
@@ -284,6 +331,17 @@ void LALInferenceSetKDEBandwidth(LALInferenceKDE *kde) {
     kde->log_norm_factor =
         log(kde->npts * sqrt(pow(2*LAL_PI, kde->dim) * det_cov));
 
+    /* Whiten the data once, so each kernel is a unit Gaussian in the new
+     * coordinates, and index large sets with a tree */
+    kde->whitened_data = XLALMalloc(kde->npts * kde->dim * sizeof(REAL8));
+    for (i = 0; i < kde->npts; i++)
+        kde_whiten(kde->cholesky_decomp_cov_lower,
+                   gsl_matrix_const_ptr(kde->data, i, 0),
+                   &kde->whitened_data[i*kde->dim], kde->dim);
+
+    if (kde->npts >= KDE_TREE_MIN_POINTS)
+        kde->tree = kde_tree_build(kde->whitened_data, kde->npts, kde->dim);
+
     return;
 }
 
@@ -299,8 +357,7 @@ void LALInferenceSetKDEBandwidth(LALInferenceKDE *kde) {
  */
 REAL8 LALInferenceKDEEvaluatePoint(LALInferenceKDE *kde, REAL8 *point) {
     INT4 dim = kde->dim;
-    INT4 npts = kde->npts;
-    INT4 i, j, p;
+    INT4 i, p;
     INT4 n_evals = 1;  // Number of evaluations to be done
     REAL8 min, max, width, val;
 
@@ -368,51 +425,27 @@ REAL8 LALInferenceKDEEvaluatePoint(LALInferenceKDE *kde, REAL8 *point) {
         }
     }
 
-    /* Loop over list of reflected and cycled points */
-    REAL8* results = XLALMalloc(npts * sizeof(REAL8));
     REAL8* eval_results = XLALMalloc(n_evals * sizeof(REAL8));
+    REAL8* y = XLALMalloc(dim * sizeof(REAL8));
 
-    /* Loop over reflected and cycled set of points */
+    /* Loop over reflected and cycled set of points.  Each is mapped through
+     * the inverse Cholesky factor of the covariance, where the kernel
+     * energy is half the squared euclidean distance to each whitened sample */
     for (i = 0; i < n_evals; i++) {
         gsl_vector_view pt = gsl_matrix_row(points, i);
-
-        /* Loop over points in KDE dataset, using the Cholesky decomposition
-         * of the covariance to avoid ever inverting the covariance matrix */
-        #pragma omp parallel
-        {
-            /* Vectors that will hold the difference and transformed distance */
-            gsl_vector *diff = gsl_vector_alloc(dim);
-            gsl_vector *tdiff = gsl_vector_alloc(dim);
-
-            #pragma omp for schedule(static)
-            for (j = 0; j < npts; j++) {
-                gsl_vector_view d = gsl_matrix_row(kde->data, j);
-                gsl_vector_memcpy(diff, &d.vector);
-
-                gsl_vector_sub(diff, &pt.vector);
-                gsl_linalg_cholesky_solve(kde->cholesky_decomp_cov, diff, tdiff);
-                gsl_vector_mul(diff, tdiff);
-
-                REAL8 energy = 0.;
-                for (INT4 k=0; k<dim; k++)
-                    energy += gsl_vector_get(diff, k);
-                results[j] = -energy/2.;
-            }
-
-            gsl_vector_free(diff);
-            gsl_vector_free(tdiff);
-        }
+        kde_whiten(kde->cholesky_decomp_cov_lower,
+                   gsl_vector_ptr(&pt.vector, 0), y, dim);
 
         /* Normalize the result */
-        eval_results[i] = log_add_exps(results, npts) - kde->log_norm_factor;
+        eval_results[i] = kde_log_kernel_sum(kde, y) - kde->log_norm_factor;
     }
 
     /* Accumulate probability after accounting for all boundaries */
     REAL8 result = log_add_exps(eval_results, n_evals);
 
     gsl_matrix_free(points);
-    XLALFree(results);
     XLALFree(eval_results);
+    XLALFree(y);
 
     return result;
 }
@@ -614,3 +647,252 @@ REAL8 log_add_exps(REAL8 *vals, INT4 size) {
 
     return result;
 }
+
+
+/* Solve L y = x for y by forward substitution, with L lower-triangular.
+ * x and y may alias. */
+static void kde_whiten(const gsl_matrix *L, const REAL8 *x, REAL8 *y, INT4 dim) {
+    INT4 i, j;
+
+    for (i = 0; i < dim; i++) {
+        REAL8 sum = x[i];
+        for (j = 0; j < i; j++)
+            sum -= gsl_matrix_get(L, i, j) * y[j];
+        y[i] = sum / gsl_matrix_get(L, i, i);
+    }
+}
+
+
+static void kde_tree_swap_rows(REAL8 *x, INT4 dim, INT4 a, INT4 b) {
+    INT4 k;
+
+    for (k = 0; k < dim; k++) {
+        REAL8 tmp = x[a*dim + k];
+        x[a*dim + k] = x[b*dim + k];
+        x[b*dim + k] = tmp;
+    }
+}
+
+
+/* Partially sort rows start to end - 1 of x on coordinate d, so that row k
+ * holds the value it would in a full sort */
+static void kde_tree_select(REAL8 *x, INT4 dim, INT4 d,
+                            INT4 start, INT4 end, INT4 k) {
+    while (end - start > 1) {
+        REAL8 pivot = x[((start + end)/2)*dim + d];
+        INT4 lt = start, i = start, gt = end;
+
+        /* Three-way partition, so repeated values can't stall the search */
+        while (i < gt) {
+            REAL8 v = x[i*dim + d];
+            if (v < pivot)
+                kde_tree_swap_rows(x, dim, lt++, i++);
+            else if (v > pivot)
+                kde_tree_swap_rows(x, dim, i, --gt);
+            else
+                i++;
+        }
+
+        if (k < lt)
+            end = lt;
+        else if (k >= gt)
+            start = gt;
+        else
+            return;
+    }
+}
+
+
+static INT4 kde_tree_build_node(struct tagLALInferenceKDETree *tree,
+                                REAL8 *x, INT4 start, INT4 end) {
+    INT4 dim = tree->dim;
+    INT4 node = tree->nnodes++;
+    REAL8 *lower = &tree->lower[node*dim];
+    REAL8 *upper = &tree->upper[node*dim];
+    INT4 i, k;
+
+    for (k = 0; k < dim; k++) {
+        lower[k] = upper[k] = x[start*dim + k];
+        for (i = start + 1; i < end; i++) {
+            if (x[i*dim + k] < lower[k]) lower[k] = x[i*dim + k];
+            if (x[i*dim + k] > upper[k]) upper[k] = x[i*dim + k];
+        }
+    }
+
+    /* Split along the widest dimension */
+    INT4 split = 0;
+    for (k = 1; k < dim; k++) {
+        if (upper[k] - lower[k] > upper[split] - lower[split])
+            split = k;
+    }
+
+    tree->nodes[node].start = start;
+    tree->nodes[node].end = end;
+    tree->nodes[node].left = -1;
+    tree->nodes[node].right = -1;
+
+    if (end - start <= KDE_TREE_LEAF_SIZE || upper[split] == lower[split])
+        return node;
+
+    INT4 mid = (start + end) / 2;
+    kde_tree_select(x, dim, split, start, end, mid);
+
+    INT4 left = kde_tree_build_node(tree, x, start, mid);
+    INT4 right = kde_tree_build_node(tree, x, mid, end);
+    tree->nodes[node].left = left;
+    tree->nodes[node].right = right;
+
+    return node;
+}
+
+
+/* Build a tree over the rows of x, which are reordered in place */
+static struct tagLALInferenceKDETree *kde_tree_build(REAL8 *x, INT4 npts, INT4 dim) {
+    struct tagLALInferenceKDETree *tree = XLALCalloc(1, sizeof(*tree));
+
+    /* Every node holds at least one point, so there are fewer than 2*npts */
+    tree->dim = dim;
+    tree->nodes = XLALMalloc(2 * npts * sizeof(KDETreeNode));
+    tree->lower = XLALMalloc(2 * npts * dim * sizeof(REAL8));
+    tree->upper = XLALMalloc(2 * npts * dim * sizeof(REAL8));
+
+    kde_tree_build_node(tree, x, 0, npts);
+
+    return tree;
+}
+
+
+static void kde_tree_destroy(struct tagLALInferenceKDETree *tree) {
+    if (tree) {
+        XLALFree(tree->nodes);
+        XLALFree(tree->lower);
+        XLALFree(tree->upper);
+        XLALFree(tree);
+    }
+}
+
+
+static REAL8 kde_dist2(const REAL8 *a, const REAL8 *b, INT4 dim) {
+    REAL8 r2 = 0.;
+    INT4 k;
+
+    for (k = 0; k < dim; k++) {
+        REAL8 d = a[k] - b[k];
+        r2 += d*d;
+    }
+    return r2;
+}
+
+
+/* Squared distance from y to the bounding box of a node */
+static REAL8 kde_tree_box_dist2(struct tagLALInferenceKDETree *tree,
+                                INT4 node, const REAL8 *y) {
+    const REAL8 *lower = &tree->lower[node*tree->dim];
+    const REAL8 *upper = &tree->upper[node*tree->dim];
+    REAL8 r2 = 0.;
+    INT4 k;
+
+    for (k = 0; k < tree->dim; k++) {
+        REAL8 d = 0.;
+        if (y[k] < lower[k])
+            d = lower[k] - y[k];
+        else if (y[k] > upper[k])
+            d = y[k] - upper[k];
+        r2 += d*d;
+    }
+    return r2;
+}
+
+
+static void kde_tree_nearest(struct tagLALInferenceKDETree *tree,
+                             const REAL8 *x, INT4 node,
+                             const REAL8 *y, REAL8 *best) {
+    KDETreeNode *n = &tree->nodes[node];
+    INT4 i;
+
+    if (n->left < 0) {
+        for (i = n->start; i < n->end; i++) {
+            REAL8 r2 = kde_dist2(&x[i*tree->dim], y, tree->dim);
+            if (r2 < *best)
+                *best = r2;
+        }
+        return;
+    }
+
+    /* Descend into the closer child first to tighten the bound early */
+    REAL8 dl = kde_tree_box_dist2(tree, n->left, y);
+    REAL8 dr = kde_tree_box_dist2(tree, n->right, y);
+    INT4 first = dl <= dr ? n->left : n->right;
+    INT4 second = dl <= dr ? n->right : n->left;
+    REAL8 dsecond = dl <= dr ? dr : dl;
+
+    if ((dl <= dr ? dl : dr) < *best)
+        kde_tree_nearest(tree, x, first, y, best);
+    if (dsecond < *best)
+        kde_tree_nearest(tree, x, second, y, best);
+}
+
+
+/* Sum exp(-(r2 - r2min)/2) over all points within r2 <= cut2 of y */
+static REAL8 kde_tree_sum(struct tagLALInferenceKDETree *tree,
+                          const REAL8 *x, INT4 node, const REAL8 *y,
+                          REAL8 r2min, REAL8 cut2) {
+    KDETreeNode *n = &tree->nodes[node];
+    REAL8 sum = 0.;
+    INT4 i;
+
+    if (kde_tree_box_dist2(tree, node, y) > cut2)
+        return 0.;
+
+    if (n->left < 0) {
+        for (i = n->start; i < n->end; i++) {
+            REAL8 r2 = kde_dist2(&x[i*tree->dim], y, tree->dim);
+            if (r2 <= cut2)
+                sum += exp(-(r2 - r2min)/2.);
+        }
+        return sum;
+    }
+
+    sum += kde_tree_sum(tree, x, n->left, y, r2min, cut2);
+    sum += kde_tree_sum(tree, x, n->right, y, r2min, cut2);
+    return sum;
+}
+
+
+/**
+ * Log of the sum of unit Gaussian kernels centred on the whitened samples,
+ * evaluated at the whitened point \a y.
+ *
+ * With a tree, the nearest sample is found first; samples further than
+ * sqrt(r2min + 2 ln(npts/tol)) contribute less than tol/npts of the nearest
+ * kernel each, so they are skipped with a total relative error below tol.
+ */
+static REAL8 kde_log_kernel_sum(LALInferenceKDE *kde, const REAL8 *y) {
+    INT4 dim = kde->dim;
+    INT4 npts = kde->npts;
+    REAL8 r2min = INFINITY;
+    REAL8 sum = 0.;
+    INT4 j;
+
+    if (kde->tree) {
+        kde_tree_nearest(kde->tree, kde->whitened_data, 0, y, &r2min);
+        REAL8 cut2 = r2min + 2.*log(npts/KDE_TREE_TOLERANCE);
+        sum = kde_tree_sum(kde->tree, kde->whitened_data, 0, y, r2min, cut2);
+    } else {
+        REAL8 *r2 = XLALMalloc(npts * sizeof(REAL8));
+
+        #pragma omp parallel for schedule(static)
+        for (j = 0; j < npts; j++)
+            r2[j] = kde_dist2(&kde->whitened_data[j*dim], y, dim);
+
+        for (j = 0; j < npts; j++)
+            if (r2[j] < r2min)
+                r2min = r2[j];
+        for (j = 0; j < npts; j++)
+            sum += exp(-(r2[j] - r2min)/2.);
+
+        XLALFree(r2);
+    }
+
+    return -r2min/2. + log(sum);
+}
@@ -28,6 +28,7 @@
 #include <lal/LALInference.h>
 
 struct tagkmeans;
+struct tagLALInferenceKDETree;
 
 /**
  * Structure containing the Guassian kernel density of a set of samples.
@@ -51,6 +52,12 @@ tagKDE
     LALInferenceParamVaryType * upper_bound_types; /**< Array of param boundary types */
     REAL8 * lower_bounds;              /**< Lower param bounds */
     REAL8 * upper_bounds;              /**< Upper param bounds */
+
+    REAL8 * whitened_data;             /**< \a data mapped through the inverse of
+                                            \a cholesky_decomp_cov_lower, row-major and
+                                            in the order used by \a tree. */
+    struct tagLALInferenceKDETree * tree; /**< Space-partitioning tree over
+                                               \a whitened_data, NULL for small sets. */
 } LALInferenceKDE;
 
 /* Allocate, fill, and tune a Gaussian kernel density estimate given an array of points. */
@@ -39,6 +39,7 @@
 #include <gsl/gsl_sf_erf.h>
 #include <gsl/gsl_complex_math.h>
 #include <lal/LALInferenceTemplate.h>
+#include <lal/LALInferenceMultibanding.h>
 
 #include "logaddexp.h"
 
@@ -99,6 +100,9 @@ static int get_calib_spline(LALInferenceVariables *vars, const char *ifoname, RE
   return(XLAL_SUCCESS);
 }
 
+/* File the distance marginalisation lookup table is cached in, if any */
+static char *marginal_distance_table = NULL;
+
 void LALInferenceInitLikelihood(LALInferenceRunState *runState)
 {
     char help[]="\
@@ -116,6 +120,9 @@ void LALInferenceInitLikelihood(LALInferenceRunState *runState)
     (--margtimephi)                  Using marginalised in time and phase likelihood\n\
     (--margdist)                     Using marginalisation in distance with d^2 prior (compatible with --margphi and --margtimephi)\n\
     (--margdist-comoving)            Using marginalisation in distance with uniform-in-comoving-volume prior (compatible with --margphi and --margtimephi)\n\
+    (--margdist-table FILE)          Read the distance marginalisation lookup table from FILE, or compute it in full and save it there\n\
+    (--multiband-likelihood)         Evaluate the CBC likelihood with the waveform on frequency bands of decreasing resolution\n\
+    (--multiband-mc-min MC)          Lowest chirp mass the bands must accommodate (default: chirp mass prior minimum)\n\
     \n";
 
     /* Print command line arguments if help requested */
@@ -136,6 +143,10 @@ void LALInferenceInitLikelihood(LALInferenceRunState *runState)
     ProcessParamsTable *commandLine=runState->commandLine;
     ifo=runState->data;
 
+    ProcessParamsTable *ppt = LALInferenceGetProcParamVal(commandLine, "--margdist-table");
+    if (ppt)
+        marginal_distance_table = XLALStringDuplicate(ppt->value);
+
     LALInferenceThreadState *thread = &(runState->threads[0]);
 
     REAL8 nullLikelihood = 0.0; // Populated if such a thing exists
@@ -244,8 +255,7 @@ LALInferenceVariables LALInferenceGetInstrinsicParams(LALInferenceVariables *cur
     LALInferenceVariables intrinsicParams;
     const char **non_intrinsic_param = non_intrinsic_params;
 
-    intrinsicParams.head      = NULL;
-    intrinsicParams.dimension = 0;
+    memset(&intrinsicParams, 0, sizeof(intrinsicParams));
     LALInferenceCopyVariables(currentParams, &intrinsicParams);
 
     while (*non_intrinsic_param) {
@@ -358,6 +368,7 @@ static REAL8 LALInferenceFusedFreqDomainLogLikelihood(LALInferenceVariables *cur
 
   COMPLEX16FrequencySeries *calFactor = NULL;
   COMPLEX16 calF = 0.0;
+  LALInferenceSplineCalibrationBasis *calBasis = NULL;
 
   REAL8Vector *logfreqs = NULL;
   REAL8Vector *amps = NULL;
@@ -393,6 +404,10 @@ static REAL8 LALInferenceFusedFreqDomainLogLikelihood(LALInferenceVariables *cur
   if (LALInferenceCheckVariable(currentParams, "constantcal_active") && (*(UINT4 *)LALInferenceGetVariable(currentParams, "constantcal_active"))) {
    constantcal_active = 1;
   }
+  /* Spline calibration values and second derivatives at the nodes, for use with a precomputed basis */
+  UINT4 spcal_npts = spcal_active ? LALInferenceGetUINT4Variable(currentParams, "spcal_npts") : 0;
+  REAL8 calAmpNodes[2*spcal_npts+1], calPhaseNodes[2*spcal_npts+1];
+
   if (spcal_active && constantcal_active){
     fprintf(stderr,"ERROR: cannot use spline and constant calibration error marginalization together. Exiting...\n");
     exit(1);
@@ -401,6 +416,10 @@ static REAL8 LALInferenceFusedFreqDomainLogLikelihood(LALInferenceVariables *cur
     fprintf(stderr,"ERROR: cannot use ROQ likelihood and constant calibration error marginalization together. Exiting...\n");
     exit(1);
   }
+  if (model->mb_flag && constantcal_active){
+    fprintf(stderr,"ERROR: cannot use multibanded likelihood and constant calibration error marginalization together. Exiting...\n");
+    exit(1);
+  }
 
   REAL8 degreesOfFreedom=2.0;
   REAL8 chisq=0.0;
@@ -417,6 +436,7 @@ static REAL8 LALInferenceFusedFreqDomainLogLikelihood(LALInferenceVariables *cur
     margtime=1;
 
   if(model->roq_flag && margtime) XLAL_ERROR_REAL8(XLAL_EINVAL,"ROQ does not support time marginalisation");
+  if(model->mb_flag && margtime) XLAL_ERROR_REAL8(XLAL_EINVAL,"Multibanded likelihood does not support time marginalisation");
 
   
   LALStatus status;
@@ -475,6 +495,8 @@ static REAL8 LALInferenceFusedFreqDomainLogLikelihood(LALInferenceVariables *cur
   if(LALInferenceCheckVariable(currentParams, "signalModelFlag"))
     signalFlag = *((INT4 *)LALInferenceGetVariable(currentParams, "signalModelFlag"));
 
+  if(model->mb_flag && (psdFlag || glitchFlag)) XLAL_ERROR_REAL8(XLAL_EINVAL,"Multibanded likelihood does not support PSD or glitch fitting");
+
   int freq_length=0,time_length=0;
   COMPLEX16Vector * dh_S_tilde=NULL;
   COMPLEX16Vector * dh_S_phase_tilde = NULL;
@@ -659,6 +681,13 @@ static REAL8 LALInferenceFusedFreqDomainLogLikelihood(LALInferenceVariables *cur
                 if ( model->roq->hptildeQuadratic ) XLALDestroyCOMPLEX16FrequencySeries(model->roq->hptildeQuadratic);
                 if ( model->roq->hctildeQuadratic ) XLALDestroyCOMPLEX16FrequencySeries(model->roq->hctildeQuadratic);
               }
+              if(model->mb_flag)
+              {
+                if ( model->mb->hptilde ) XLALDestroyCOMPLEX16FrequencySeries(model->mb->hptilde);
+                if ( model->mb->hctilde ) XLALDestroyCOMPLEX16FrequencySeries(model->mb->hctilde);
+                model->mb->hptilde = NULL;
+                model->mb->hctilde = NULL;
+              }
               return (-INFINITY);
               break;
             default: /* Panic! */
@@ -694,8 +723,26 @@ static REAL8 LALInferenceFusedFreqDomainLogLikelihood(LALInferenceVariables *cur
 						model->roq->frequencyNodesQuadratic,
 						&(model->roq->calFactorQuadratic));
 	  }
+	  else if (model->mb_flag) {
+	    /* the same nodes serve both inner products */
+	    LALInferenceSplineCalibrationFactorROQ(logfreqs, amps, phases,
+						model->mb->frequencies,
+						&(model->mb->calFactor),
+						model->mb->frequencies,
+						&(model->mb->calFactor));
+	  }
 
 	  else{
+	    /* Evaluate the spline in the template loop if the basis covers this IFO's bins */
+	    REAL8 calDeltaF = 1.0 / (((double)dataPtr->timeData->data->length) * dataPtr->timeData->deltaT);
+	    calBasis = dataPtr->calBasis;
+	    if (!LALInferenceSplineCalibrationBasisMatches(calBasis, logfreqs, calDeltaF, (UINT4)ceil(dataPtr->fLow / calDeltaF), (UINT4)floor(dataPtr->fHigh / calDeltaF)))
+	      calBasis = NULL;
+	    if (calBasis) {
+	      LALInferenceSplineCalibrationNodeValues(calBasis, amps, calAmpNodes);
+	      LALInferenceSplineCalibrationNodeValues(calBasis, phases, calPhaseNodes);
+	    }
+	    else {
 	    if (calFactor == NULL) {
 	      calFactor = XLALCreateCOMPLEX16FrequencySeries("calibration factors",
                        &(dataPtr->freqData->epoch),
@@ -704,6 +751,7 @@ static REAL8 LALInferenceFusedFreqDomainLogLikelihood(LALInferenceVariables *cur
                        dataPtr->freqData->data->length);
 	    }
           LALInferenceSplineCalibrationFactor(logfreqs, amps, phases, calFactor);
+	    }
 	}
 	if(logfreqs) XLALDestroyREAL8Vector(logfreqs);
 	if(amps) XLALDestroyREAL8Vector(amps);
@@ -796,7 +844,13 @@ static REAL8 LALInferenceFusedFreqDomainLogLikelihood(LALInferenceVariables *cur
       }
     }
 
-    if (model->roq_flag) {
+    if (model->roq_flag || model->mb_flag) {
+
+	if (model->mb_flag) {
+	    LALInferenceMultibandInnerProducts(dataPtr->mb, model->mb, dataPtr->fPlus, dataPtr->fCross, timeshift, spcal_active, &this_ifo_d_inner_h, &this_ifo_s);
+	}
+
+	else {
 
 	double complex weight_iii;
 
@@ -835,6 +889,7 @@ static REAL8 LALInferenceFusedFreqDomainLogLikelihood(LALInferenceVariables *cur
 			this_ifo_s += dataPtr->roq->weightsQuadratic[jjj] * creal( conj(template_EI) * (template_EI) );
 					}
 	}
+	}
 
     d_inner_h += creal(this_ifo_d_inner_h);
     // D gets the factor of 2 inside nullloglikelihood
@@ -947,7 +1002,16 @@ static REAL8 LALInferenceFusedFreqDomainLogLikelihood(LALInferenceVariables *cur
       template = plainTemplate * (re + I*im);
 
       if (spcal_active) {
-          calF = calFactor->data->data[i];
+          if (calBasis) {
+            const REAL8 *c = &(calBasis->coeffs[4*(i - lower)]);
+            UINT4 n = calBasis->interval[i - lower];
+            REAL8 dA = c[0]*calAmpNodes[n] + c[1]*calAmpNodes[n+1] + c[2]*calAmpNodes[spcal_npts+n] + c[3]*calAmpNodes[spcal_npts+n+1];
+            REAL8 dPhi = c[0]*calPhaseNodes[n] + c[1]*calPhaseNodes[n+1] + c[2]*calPhaseNodes[spcal_npts+n] + c[3]*calPhaseNodes[spcal_npts+n+1];
+            /* (1 + dA)(2 + i dPhi)/(2 - i dPhi), as in LALInferenceSplineCalibrationFactor() */
+            calF = (1.0 + dA)*((4.0 - dPhi*dPhi) + 4.0*I*dPhi)/(4.0 + dPhi*dPhi);
+          }
+          else
+            calF = calFactor->data->data[i];
           template = template*calF;
       }
 
@@ -1140,6 +1204,19 @@ static REAL8 LALInferenceFusedFreqDomainLogLikelihood(LALInferenceVariables *cur
 
   }
 
+  if (model->mb_flag){
+    REAL8 OptimalSNR=sqrt(S);
+    REAL8 MatchedFilterSNR = d_inner_h/OptimalSNR;
+    LALInferenceAddVariable(currentParams,"optimal_snr",&OptimalSNR,LALINFERENCE_REAL8_t,LALINFERENCE_PARAM_OUTPUT);
+    LALInferenceAddVariable(currentParams,"matched_filter_snr",&MatchedFilterSNR,LALINFERENCE_REAL8_t,LALINFERENCE_PARAM_OUTPUT);
+    model->SNR = OptimalSNR;
+
+    if ( model->mb->hptilde ) XLALDestroyCOMPLEX16FrequencySeries(model->mb->hptilde);
+    if ( model->mb->hctilde ) XLALDestroyCOMPLEX16FrequencySeries(model->mb->hctilde);
+    model->mb->hptilde = NULL;
+    model->mb->hctilde = NULL;
+  }
+
   // for models which are non-factorising
   switch(marginalisationflags)
   {
@@ -1252,22 +1329,8 @@ static REAL8 LALInferenceFusedFreqDomainLogLikelihood(LALInferenceVariables *cur
               
               if(margdist)
               {
-                XLAL_TRY(dh_S->data[i]=LALInferenceMarginalDistanceLogLikelihood(dist_min, dist_max, sqrt(S), x, cosmology, margphi) + S, errnum);
-	        errnum&=~XLAL_EFUNC;
-        	if(errnum!=XLAL_SUCCESS)
-	        {
-        	    switch(errnum)
-	            {
-                        case XLAL_ERANGE: /* The SNR input was outside the interpolation range */
-                            dh_S->data[i] = -INFINITY;
-                            break;
-                        default: /* Panic! */
-                            fprintf(stderr,"Unhandled error in marginal distance likelihood - exiting!\n");
-                            fprintf(stderr,"XLALError: %d, %s\n",errnum,XLALErrorString(errnum));
-                            exit(1);
-                            break;
-                    }
-                }
+                /* Keep the match, to marginalise over distance for all times at once below */
+                dh_S->data[i] = x;
               }
               else
               {
@@ -1276,30 +1339,30 @@ static REAL8 LALInferenceFusedFreqDomainLogLikelihood(LALInferenceVariables *cur
               }
           }
       }
-      else
+      if(margdist)
       {
-          if(margdist)
-            {
-                for (i = istart; i < iend; i++)
-                {
-                    XLAL_TRY(dh_S->data[i]=LALInferenceMarginalDistanceLogLikelihood(dist_min, dist_max, sqrt(S), dh_S->data[i], cosmology, margphi) + S, errnum);
-                    errnum&=~XLAL_EFUNC;
-                    if(errnum!=XLAL_SUCCESS)
-                    {
-                        switch(errnum)
-                        {
-                            case XLAL_ERANGE: /* The SNR input was outside the interpolation range */
-                                dh_S->data[i] = -INFINITY;
-                                break;
-                            default: /* Panic! */
-                                fprintf(stderr,"Unhandled error in marginal distance likelihood - exiting!\n");
-                                fprintf(stderr,"XLALError: %d, %s\n",errnum,XLALErrorString(errnum));
-                                exit(1);
-                                break;
-                        }
-                    }
-                }
-            }
+          XLAL_TRY(LALInferenceMarginalDistanceLogLikelihoodSeries(dist_min, dist_max, sqrt(S), dh_S->data + istart, n, cosmology, margphi), errnum);
+          errnum&=~XLAL_EFUNC;
+          if(errnum!=XLAL_SUCCESS)
+          {
+              switch(errnum)
+              {
+                  case XLAL_ERANGE: /* The SNR input was outside the interpolation range */
+                      for (i = istart; i < iend; i++)
+                          dh_S->data[i] = -INFINITY;
+                      break;
+                  default: /* Panic! */
+                      fprintf(stderr,"Unhandled error in marginal distance likelihood - exiting!\n");
+                      fprintf(stderr,"XLALError: %d, %s\n",errnum,XLALErrorString(errnum));
+                      exit(1);
+                      break;
+              }
+          }
+          else
+          {
+              for (i = istart; i < iend; i++)
+                  dh_S->data[i] += S;
+          }
       }
       size_t imax;
       REAL8 imean;
@@ -1405,33 +1468,64 @@ static REAL8 LALInferenceFusedFreqDomainLogLikelihood(LALInferenceVariables *cur
   return(loglikelihood);
 }
 
-double LALInferenceMarginalDistanceLogLikelihood(double dist_min, double dist_max, double OptimalSNR, double d_inner_h, int cosmology, int margphi)
+/* Maximum optimal SNR covered by the distance marginalisation lookup table */
+static const double marginal_distance_pmax = 100000; /* CHECKME: Max SNR allowed ? */
+
+/* Get the distance marginalisation lookup table, setting it up on first use */
+static log_radial_integrator *marginal_distance_integrator(double dist_min, double dist_max, int cosmology, int margphi, double *log_norm)
 {
         static const size_t default_log_radial_integrator_size = 400;
-        double loglikelihood=0;
-        static double log_norm = 0;
         static log_radial_integrator *integrator;
+        static double norm = 0;
 
-        double pmax = 100000; /* CHECKME: Max SNR allowed ? */
         #pragma omp critical
         {
             if (integrator == NULL)
             {
-                printf("Initialising distance integration lookup table\n");
-                /* Initialise the integrator for the first time */
-                integrator = log_radial_integrator_init(
-                                dist_min,
-                                dist_max,
-                                2, /* Power of distance in prior */
-                                cosmology,
-                                pmax,
-                                default_log_radial_integrator_size * 5, /* CHECKME: fudge factor of 5 compared to bayestar */
-                                !margphi);
+                /* CHECKME: fudge factor of 5 compared to bayestar */
+                const size_t size = default_log_radial_integrator_size * 5;
+                const int k = 2; /* Power of distance in prior */
+                if (marginal_distance_table)
+                {
+                    integrator = log_radial_integrator_load(marginal_distance_table, dist_min, dist_max, k,
+                                    cosmology, marginal_distance_pmax, size, !margphi);
+                    if (integrator)
+                        printf("Read distance integration lookup table from %s\n", marginal_distance_table);
+                    else
+                    {
+                        printf("Initialising distance integration lookup table\n");
+                        integrator = log_radial_integrator_init(dist_min, dist_max, k, cosmology,
+                                        marginal_distance_pmax, size, !margphi);
+                        if (integrator && log_radial_integrator_save(integrator, marginal_distance_table) != XLAL_SUCCESS)
+                        {
+                            XLAL_PRINT_WARNING("Could not save distance integration lookup table to %s", marginal_distance_table);
+                            XLALClearErrno();
+                        }
+                    }
+                }
+                else
+                {
+                    /* Only the parts of the table the sampler visits get computed */
+                    printf("Initialising distance integration lookup table on demand\n");
+                    integrator = log_radial_integrator_init_lazy(dist_min, dist_max, k, cosmology,
+                                    marginal_distance_pmax, size, !margphi);
+                }
                 /* distance prior normalisation */
-                log_norm = log_radial_integrator_eval(integrator, 0, 0, -INFINITY, -INFINITY);
+                if (integrator)
+                    norm = log_radial_integrator_eval(integrator, 0, 0, -INFINITY, -INFINITY);
             }
         }
         #pragma omp barrier
+        *log_norm = norm;
+        return integrator;
+}
+
+double LALInferenceMarginalDistanceLogLikelihood(double dist_min, double dist_max, double OptimalSNR, double d_inner_h, int cosmology, int margphi)
+{
+        double loglikelihood=0;
+        double log_norm = 0;
+        double pmax = marginal_distance_pmax;
+        log_radial_integrator *integrator = marginal_distance_integrator(dist_min, dist_max, cosmology, margphi, &log_norm);
         if (!integrator) XLAL_ERROR(XLAL_EFUNC, "Unable to initialise distance marginalisation integrator");
         
         if (isnan(OptimalSNR) || isnan(d_inner_h) || pmax<OptimalSNR)
@@ -1447,6 +1541,40 @@ double LALInferenceMarginalDistanceLogLikelihood(double dist_min, double dist_ma
         return (loglikelihood);
 }
 
+int LALInferenceMarginalDistanceLogLikelihoodSeries(double dist_min, double dist_max, double OptimalSNR, double *d_inner_h, size_t n, int cosmology, int margphi)
+{
+        double log_norm = 0;
+        double pmax = marginal_distance_pmax;
+        size_t i;
+        log_radial_integrator *integrator = marginal_distance_integrator(dist_min, dist_max, cosmology, margphi, &log_norm);
+        if (!integrator) XLAL_ERROR(XLAL_EFUNC, "Unable to initialise distance marginalisation integrator");
+
+        if (isnan(OptimalSNR) || pmax<OptimalSNR)
+        {
+            for (i = 0; i < n; i++)
+                d_inner_h[i] = -INFINITY;
+            XLAL_ERROR(XLAL_ERANGE,"warning: Optimal SNR %lf exceeded pmax %lf\n",OptimalSNR, pmax);
+        }
+
+        /* NaN matches are out of range, as in LALInferenceMarginalDistanceLogLikelihood() */
+        for (i = 0; i < n; i++)
+            if (isnan(d_inner_h[i]))
+                break;
+
+        if (i < n)
+        {
+            for (i = 0; i < n; i++)
+                d_inner_h[i] = isnan(d_inner_h[i]) ? -INFINITY :
+                    log_radial_integrator_eval(integrator, OptimalSNR, d_inner_h[i], log(OptimalSNR), log(d_inner_h[i]));
+        }
+        else
+            log_radial_integrator_eval_n(integrator, OptimalSNR, log(OptimalSNR), n, d_inner_h, d_inner_h);
+
+        for (i = 0; i < n; i++)
+            d_inner_h[i] -= log_norm; /* Normalise prior */
+        return XLAL_SUCCESS;
+}
+
 /***************************************************************/
 /* Student-t (log-) likelihood function                        */
 /* as described in Roever/Meyer/Christensen (2011):            */
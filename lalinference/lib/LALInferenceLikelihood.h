@@ -184,6 +184,10 @@ REAL8 LALInferenceMarginalisedTimePhaseLogLikelihood(LALInferenceVariables *curr
     margphi: 0 = use gaussian likelihood, 1 = phase-marginalised bessel likelihood */
 double LALInferenceMarginalDistanceLogLikelihood(double dist_min, double dist_max, double OptimalSNR, double d_inner_h, int cosmology, int margphi);
 
+/** Compute LALInferenceMarginalDistanceLogLikelihood() for a series of n values of d_inner_h sharing one OptimalSNR,
+  * replacing each d_inner_h by its delta-log-likelihood.  NaN inputs give -INFINITY rather than an error. */
+int LALInferenceMarginalDistanceLogLikelihoodSeries(double dist_min, double dist_max, double OptimalSNR, double *d_inner_h, size_t n, int cosmology, int margphi);
+
 
 /**
  * Returns the log-likelihood marginalised over the time dimension
@@ -7,6 +7,9 @@
 //
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <complex.h>
 #include <lal/Date.h>
 #include <lal/GenerateInspiral.h>
 #include <lal/LALInference.h>
@@ -16,6 +19,7 @@
 #include <lal/TimeSeries.h>
 #include <lal/LALDatatypes.h>
 #include <lal/Sequence.h>
+#include <lal/ComplexFFT.h>
 #include <lal/LALInferenceMultibanding.h>
 
 
@@ -136,3 +140,414 @@ REAL8Sequence *LALInferenceMultibandFrequencies(int NBands, double f_min, double
     return(Frequencies);
     
 }
+
+
+/* Multibanded likelihood.
+ *
+ * For the part g = w_b h of the template that falls in band b (w_b being a smooth window, the windows
+ * of all bands summing to one) the sum over the full-resolution bins
+ *   <d|g> = 4 deltaF sum_k d_k conj(g_k) / S_k
+ * only involves the time-domain inverse transform of d/S over the duration of g.  If the time
+ * support of g fits in L = N/M samples, the full-resolution g_k are fixed by the L coarse samples
+ * g_{jM}, so <d|g> is exactly a sum over the coarse nodes jM with weights obtained by folding the
+ * inverse transform of d/S over that window and transforming it back at length L.  The duration of
+ * g is bounded by the Newtonian chirp time from the lowest frequency of the band for the lightest
+ * allowed chirp mass, plus the width of the arrival time prior and some padding.
+ * <h|h> only needs the smooth |h|^2, so it is computed by quadratic interpolation between the nodes,
+ * again folded into weights at the nodes.  The weights of all bands are accumulated onto the union
+ * of the band nodes, and the likelihood is two weighted sums over that union.
+ */
+
+/* Padding either side of the arrival time prior, covering detector delays, merger and ringdown and
+   the spread of the band windows in time (s) */
+#define MULTIBAND_TIME_PAD 1.0
+/* Width of the transition between neighbouring bands (Hz) */
+#define MULTIBAND_TAPER_WIDTH 4.0
+#define MULTIBAND_MAX_BANDS 32
+
+typedef struct tagMultibandLayout
+{
+    UINT4 nBands;
+    UINT4 decimation[MULTIBAND_MAX_BANDS]; /* node spacing of the band, in full-resolution bins */
+    UINT4 kStart[MULTIBAND_MAX_BANDS]; /* bin where the band window starts rising */
+    UINT4 kmin, kmax, nTaper;
+} MultibandLayout;
+
+/* Window of band b at full-resolution bin k */
+static REAL8 multiband_window(const MultibandLayout *lay, UINT4 b, UINT4 k)
+{
+    if (k < lay->kmin || k > lay->kmax) return 0.0;
+    if (b > 0) {
+        if (k <= lay->kStart[b]) return 0.0;
+        if (k < lay->kStart[b] + lay->nTaper)
+            return 0.5*(1.0 - cos(LAL_PI*(k - lay->kStart[b])/lay->nTaper));
+    }
+    if (b + 1 < lay->nBands) {
+        if (k >= lay->kStart[b+1] + lay->nTaper) return 0.0;
+        if (k > lay->kStart[b+1])
+            return 0.5*(1.0 + cos(LAL_PI*(k - lay->kStart[b+1])/lay->nTaper));
+    }
+    return 1.0;
+}
+
+/* First and last bin where the window of band b is non-zero */
+static void multiband_band_range(const MultibandLayout *lay, UINT4 b, UINT4 *klo, UINT4 *khi)
+{
+    *klo = b == 0 ? lay->kmin : lay->kStart[b] + 1;
+    *khi = b + 1 < lay->nBands ? lay->kStart[b+1] + lay->nTaper - 1 : lay->kmax;
+}
+
+/* Lowest bin a band with node spacing M may start at, or 0 if no signal fits in T/M */
+static UINT4 multiband_lowest_bin(UINT4 M, REAL8 T, REAL8 deltaF, REAL8 fixedDuration, REAL8 mc_sec)
+{
+    REAL8 tchirp = T/M - fixedDuration;
+    if (tchirp <= 0.0) return 0;
+    /* undo the safety factor applied in the time of a given frequency */
+    REAL8 f = 1.1*LALInferenceTimeFrequencyRelation(mc_sec, -tchirp, 1);
+    return (UINT4) ceil(f/deltaF);
+}
+
+static void multiband_layout(MultibandLayout *lay, UINT4 N, REAL8 deltaT, REAL8 f_min, REAL8 f_max, REAL8 mc_sec, REAL8 fixedDuration)
+{
+    REAL8 T = N*deltaT;
+    REAL8 deltaF = 1.0/T;
+
+    lay->kmin = (UINT4) ceil(f_min/deltaF);
+    lay->kmax = (UINT4) floor(f_max/deltaF);
+    if (lay->kmax > N/2) lay->kmax = N/2;
+    lay->nTaper = (UINT4) ceil(MULTIBAND_TAPER_WIDTH/deltaF);
+    if (lay->nTaper < 1) lay->nTaper = 1;
+
+    /* The lowest band is kept at full resolution, which needs no assumption on the signal */
+    lay->nBands = 1;
+    lay->decimation[0] = 1;
+    lay->kStart[0] = lay->kmin;
+
+    UINT4 M = 1;
+    while (lay->nBands < MULTIBAND_MAX_BANDS) {
+        UINT4 Mnext = 2*M;
+        if (N % (2*Mnext)) break;
+        UINT4 k = multiband_lowest_bin(Mnext, T, deltaF, fixedDuration, mc_sec);
+        if (!k) break;
+        /* the transition from the previous band must be complete before this one */
+        if (k < lay->kStart[lay->nBands-1] + lay->nTaper) k = lay->kStart[lay->nBands-1] + lay->nTaper;
+        /* go straight to a coarser spacing if it is allowed from the same bin */
+        while (!(N % (4*Mnext))) {
+            UINT4 kc = multiband_lowest_bin(2*Mnext, T, deltaF, fixedDuration, mc_sec);
+            if (!kc || kc > k) break;
+            Mnext *= 2;
+        }
+        if (k + lay->nTaper >= lay->kmax) break;
+        lay->decimation[lay->nBands] = Mnext;
+        lay->kStart[lay->nBands] = k;
+        lay->nBands++;
+        M = Mnext;
+    }
+}
+
+static int multiband_compare_bins(const void *a, const void *b)
+{
+    UINT4 x = *(const UINT4 *)a, y = *(const UINT4 *)b;
+    return (x > y) - (x < y);
+}
+
+/* Index of bin k in the sorted node list */
+static UINT4 multiband_node_index(const UINT4 *bins, UINT4 n, UINT4 k)
+{
+    UINT4 lo = 0, hi = n;
+    while (lo < hi) {
+        UINT4 mid = lo + (hi - lo)/2;
+        if (bins[mid] < k) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* Sorted union of the nodes of all bands, as full-resolution bins */
+static UINT4 *multiband_nodes(const MultibandLayout *lay, UINT4 *nNodes)
+{
+    UINT4 total = 0;
+    for (UINT4 b = 0; b < lay->nBands; b++) {
+        UINT4 klo, khi, M = lay->decimation[b];
+        multiband_band_range(lay, b, &klo, &khi);
+        total += (khi + M - 1)/M - klo/M + 1;
+    }
+    UINT4 *bins = XLALMalloc(total*sizeof(*bins));
+    if (!bins) XLAL_ERROR_NULL(XLAL_ENOMEM);
+
+    UINT4 n = 0;
+    for (UINT4 b = 0; b < lay->nBands; b++) {
+        UINT4 klo, khi, M = lay->decimation[b];
+        multiband_band_range(lay, b, &klo, &khi);
+        for (UINT4 j = klo/M; j <= (khi + M - 1)/M; j++) bins[n++] = j*M;
+    }
+    qsort(bins, n, sizeof(*bins), multiband_compare_bins);
+    UINT4 u = 0;
+    for (UINT4 i = 0; i < n; i++)
+        if (u == 0 || bins[i] != bins[u-1]) bins[u++] = bins[i];
+
+    *nNodes = u;
+    return bins;
+}
+
+/* Fill in the <d|h> and <h|h> node weights of one IFO */
+static int multiband_weights(const MultibandLayout *lay, LALInferenceIFOData *ifo, const UINT4 *bins, UINT4 nNodes, INT8 nEnd)
+{
+    int status = XLAL_SUCCESS;
+    UINT4 N = ifo->timeData->data->length;
+    REAL8 deltaF = 1.0/(N*ifo->timeData->deltaT);
+    UINT4 lower = (UINT4) ceil(ifo->fLow/deltaF);
+    UINT4 upper = (UINT4) floor(ifo->fHigh/deltaF);
+    const REAL8 *psd = ifo->oneSidedNoisePowerSpectrum->data->data;
+    const COMPLEX16 *dtilde = ifo->freqData->data->data;
+    if (upper > N/2) upper = N/2;
+
+    COMPLEX16Vector *A = NULL, *Ahat = NULL, *B = NULL, *W = NULL;
+    COMPLEX16FFTPlan *plan = NULL;
+    LALInferenceMultibandData *mb = XLALCalloc(1, sizeof(*mb));
+    if (!mb) XLAL_ERROR(XLAL_ENOMEM);
+    mb->length = nNodes;
+    mb->weightsLinear = XLALCalloc(nNodes, sizeof(*mb->weightsLinear));
+    mb->weightsQuadratic = XLALCalloc(nNodes, sizeof(*mb->weightsQuadratic));
+    A = XLALCreateCOMPLEX16Vector(N);
+    if (!mb->weightsLinear || !mb->weightsQuadratic || !A) {
+        status = XLAL_ENOMEM;
+        goto cleanup;
+    }
+
+    /* 4 deltaF d / S, the data weights of the full-resolution likelihood */
+    memset(A->data, 0, N*sizeof(*A->data));
+    for (UINT4 k = lower; k <= upper; k++)
+        A->data[k] = 4.0*deltaF*dtilde[k]/psd[k];
+
+    for (UINT4 b = 0; b < lay->nBands; b++) {
+        UINT4 klo, khi, M = lay->decimation[b];
+        multiband_band_range(lay, b, &klo, &khi);
+
+        /* <h|h>: quadratic interpolation of |h|^2 through the three nodes of the band nearest each
+           bin, or linear interpolation in a band of fewer than three nodes */
+        UINT4 jlo = klo/M, jhi = (khi + M - 1)/M;
+        for (UINT4 k = klo > lower ? klo : lower; k <= khi && k <= upper; k++) {
+            REAL8 q = 4.0*deltaF*multiband_window(lay, b, k)/psd[k];
+            UINT4 j = k/M, r = k%M;
+            REAL8 x = (REAL8) r/M;
+            if (!r)
+                mb->weightsQuadratic[multiband_node_index(bins, nNodes, j*M)] += q;
+            else if (jhi - jlo < 2) {
+                mb->weightsQuadratic[multiband_node_index(bins, nNodes, j*M)] += q*(1.0 - x);
+                mb->weightsQuadratic[multiband_node_index(bins, nNodes, (j + 1)*M)] += q*x;
+            }
+            else if ((2*r < M && j > jlo) || j + 2 > jhi) {
+                mb->weightsQuadratic[multiband_node_index(bins, nNodes, (j - 1)*M)] += q*0.5*x*(x - 1.0);
+                mb->weightsQuadratic[multiband_node_index(bins, nNodes, j*M)] += q*(1.0 - x*x);
+                mb->weightsQuadratic[multiband_node_index(bins, nNodes, (j + 1)*M)] += q*0.5*x*(x + 1.0);
+            }
+            else {
+                mb->weightsQuadratic[multiband_node_index(bins, nNodes, j*M)] += q*0.5*(x - 1.0)*(x - 2.0);
+                mb->weightsQuadratic[multiband_node_index(bins, nNodes, (j + 1)*M)] += q*x*(2.0 - x);
+                mb->weightsQuadratic[multiband_node_index(bins, nNodes, (j + 2)*M)] += q*0.5*x*(x - 1.0);
+            }
+        }
+
+        /* <d|h>: the full-resolution band needs no folding */
+        if (M == 1) {
+            for (UINT4 k = klo; k <= khi; k++)
+                mb->weightsLinear[multiband_node_index(bins, nNodes, k)] += multiband_window(lay, b, k)*A->data[k];
+            continue;
+        }
+
+        if (!Ahat) {
+            /* inverse transform of the data weights, shared by all decimated bands */
+            Ahat = XLALCreateCOMPLEX16Vector(N);
+            plan = XLALCreateReverseCOMPLEX16FFTPlan(N, 0);
+            if (!Ahat || !plan || XLALCOMPLEX16VectorFFT(Ahat, A, plan)) {
+                status = XLAL_EFUNC;
+                goto cleanup;
+            }
+            XLALDestroyCOMPLEX16FFTPlan(plan);
+            plan = NULL;
+        }
+
+        /* fold the L samples of the signal window ending at nEnd and transform back at length L */
+        UINT4 L = N/M;
+        B = XLALCreateCOMPLEX16Vector(L);
+        W = XLALCreateCOMPLEX16Vector(L);
+        plan = XLALCreateForwardCOMPLEX16FFTPlan(L, 0);
+        if (!B || !W || !plan) {
+            status = XLAL_ENOMEM;
+            goto cleanup;
+        }
+        for (UINT4 s = 0; s < L; s++) {
+            INT8 n = ((nEnd - (INT8) s) % (INT8) N + N) % N;
+            B->data[n % L] = Ahat->data[n];
+        }
+        if (XLALCOMPLEX16VectorFFT(W, B, plan)) {
+            status = XLAL_EFUNC;
+            goto cleanup;
+        }
+        for (UINT4 j = klo/M; j <= (khi + M - 1)/M; j++)
+            mb->weightsLinear[multiband_node_index(bins, nNodes, j*M)] += multiband_window(lay, b, j*M)*W->data[j % L]/L;
+
+        XLALDestroyCOMPLEX16FFTPlan(plan);
+        XLALDestroyCOMPLEX16Vector(B);
+        XLALDestroyCOMPLEX16Vector(W);
+        plan = NULL;
+        B = W = NULL;
+    }
+
+cleanup:
+    if (plan) XLALDestroyCOMPLEX16FFTPlan(plan);
+    if (A) XLALDestroyCOMPLEX16Vector(A);
+    if (Ahat) XLALDestroyCOMPLEX16Vector(Ahat);
+    if (B) XLALDestroyCOMPLEX16Vector(B);
+    if (W) XLALDestroyCOMPLEX16Vector(W);
+    if (status != XLAL_SUCCESS) {
+        if (mb->weightsLinear) XLALFree(mb->weightsLinear);
+        if (mb->weightsQuadratic) XLALFree(mb->weightsQuadratic);
+        XLALFree(mb);
+        XLAL_ERROR(status);
+    }
+    ifo->mb = mb;
+    return XLAL_SUCCESS;
+}
+
+int LALInferenceSetupMultibandLikelihood(LALInferenceModel *model, LALInferenceIFOData *data, REAL8 mc_min, REAL8 t_min, REAL8 t_max)
+{
+    XLAL_CHECK(model != NULL && data != NULL, XLAL_EFAULT);
+    XLAL_CHECK(mc_min > 0.0, XLAL_EDOM, "Minimum chirp mass must be positive, got %g", mc_min);
+    XLAL_CHECK(t_max >= t_min, XLAL_EDOM, "Empty arrival time range [%f, %f]", t_min, t_max);
+
+    UINT4 N = data->timeData->data->length;
+    REAL8 deltaT = data->timeData->deltaT;
+    REAL8 epoch = XLALGPSGetREAL8(&(data->freqData->epoch));
+    REAL8 f_min = data->fLow, f_max = data->fHigh;
+    for (LALInferenceIFOData *ifo = data->next; ifo; ifo = ifo->next) {
+        XLAL_CHECK(ifo->timeData->data->length == N && ifo->timeData->deltaT == deltaT, XLAL_EINVAL, "Multibanding needs the same segment length and sampling rate in all IFOs");
+        XLAL_CHECK(XLALGPSGetREAL8(&(ifo->freqData->epoch)) == epoch, XLAL_EINVAL, "Multibanding needs the same segment start in all IFOs");
+        if (ifo->fLow < f_min) f_min = ifo->fLow;
+        if (ifo->fHigh > f_max) f_max = ifo->fHigh;
+    }
+
+    /* the signal lies within [t_min - pad - chirp time, t_max + pad] of the segment */
+    REAL8 fixedDuration = t_max - t_min + 2.0*MULTIBAND_TIME_PAD;
+    INT8 nEnd = (INT8) ceil((t_max + MULTIBAND_TIME_PAD - epoch)/deltaT);
+
+    MultibandLayout lay;
+    multiband_layout(&lay, N, deltaT, f_min, f_max, mc_min*LAL_MTSUN_SI, fixedDuration);
+    XLAL_CHECK(lay.kmax > lay.kmin, XLAL_EINVAL, "Empty frequency range for multibanding");
+
+    UINT4 nNodes = 0;
+    UINT4 *bins = multiband_nodes(&lay, &nNodes);
+    XLAL_CHECK(bins != NULL, XLAL_EFUNC);
+
+    /* data weights are shared between the models of all threads */
+    for (LALInferenceIFOData *ifo = data; ifo; ifo = ifo->next) {
+        if (ifo->mb) {
+            if (ifo->mb->length == nNodes) continue;
+            XLALFree(bins);
+            XLAL_ERROR(XLAL_EINVAL, "Multibanding weights of %s were computed for a different layout", ifo->name);
+        }
+        if (multiband_weights(&lay, ifo, bins, nNodes, nEnd)) {
+            XLALFree(bins);
+            XLAL_ERROR(XLAL_EFUNC);
+        }
+    }
+
+    LALInferenceMultibandModel *mb = XLALCalloc(1, sizeof(*mb));
+    if (mb) {
+        mb->frequencies = XLALCreateREAL8Sequence(nNodes);
+        mb->calFactor = XLALCreateCOMPLEX16Sequence(nNodes);
+    }
+    if (!mb || !mb->frequencies || !mb->calFactor) {
+        LALInferenceDestroyMultibandModel(mb);
+        XLALFree(bins);
+        XLAL_ERROR(XLAL_ENOMEM);
+    }
+    REAL8 deltaF = 1.0/(N*deltaT);
+    for (UINT4 i = 0; i < nNodes; i++) mb->frequencies->data[i] = bins[i]*deltaF;
+    mb->nBands = lay.nBands;
+    XLALFree(bins);
+
+    model->mb = mb;
+    model->mb_flag = 1;
+
+    fprintf(stdout, "Multibanded likelihood: %u bands, %u frequency nodes for %u full-resolution bins\n", lay.nBands, nNodes, lay.kmax - lay.kmin + 1);
+    for (UINT4 b = 0; b < lay.nBands; b++)
+        fprintf(stdout, "  band %u from %f Hz, deltaF %g Hz\n", b, lay.kStart[b]*deltaF, lay.decimation[b]*deltaF);
+
+    return XLAL_SUCCESS;
+}
+
+void LALInferenceMultibandInnerProducts(const LALInferenceMultibandData *weights, const LALInferenceMultibandModel *mb, REAL8 Fplus, REAL8 Fcross, REAL8 timeshift, int spcal_active, COMPLEX16 *d_inner_h, REAL8 *h_inner_h)
+{
+    const UINT4 n = weights->length;
+    const REAL8 *f = mb->frequencies->data;
+    const COMPLEX16 *hp = mb->hptilde->data->data;
+    const COMPLEX16 *hc = mb->hctilde->data->data;
+    const COMPLEX16 *cal = spcal_active ? mb->calFactor->data : NULL;
+    const COMPLEX16 *wl = weights->weightsLinear;
+    const REAL8 *wq = weights->weightsQuadratic;
+    const REAL8 twopit = LAL_TWOPI*timeshift;
+    REAL8 dh_re = 0.0, dh_im = 0.0, hh = 0.0;
+    REAL8 c = 1.0, s = 0.0, dre = 0.0, dim = 0.0, step = -1.0;
+
+    for (UINT4 i = 0; i < n; i++) {
+        /* exp(i twopit f) by the same recurrence as the full-resolution likelihood, restarted
+           wherever the node spacing changes */
+        REAL8 df = i ? f[i] - f[i-1] : -1.0;
+        if (fabs(df - step) > 1e-9*df) {
+            c = cos(twopit*f[i]);
+            s = sin(twopit*f[i]);
+            step = df;
+            dim = sin(twopit*step);
+            dre = -2.0*sin(0.5*twopit*step)*sin(0.5*twopit*step);
+        }
+        else {
+            REAL8 cnew = c + c*dre - s*dim;
+            s = s + c*dim + s*dre;
+            c = cnew;
+        }
+
+        COMPLEX16 h = Fplus*hp[i] + Fcross*hc[i];
+        if (cal) h *= cal[i];
+        REAL8 hre = creal(h), him = cimag(h);
+        hh += wq[i]*(hre*hre + him*him);
+        /* weight * conj(h exp(-i twopit f)) */
+        REAL8 tre = hre*c + him*s, tim = hre*s - him*c;
+        dh_re += creal(wl[i])*tre - cimag(wl[i])*tim;
+        dh_im += creal(wl[i])*tim + cimag(wl[i])*tre;
+    }
+
+    *d_inner_h = crect(dh_re, dh_im);
+    *h_inner_h = hh;
+}
+
+void LALInferenceDestroyMultibandModel(LALInferenceMultibandModel *mb)
+{
+    if (!mb) return;
+    if (mb->hptilde) XLALDestroyCOMPLEX16FrequencySeries(mb->hptilde);
+    if (mb->hctilde) XLALDestroyCOMPLEX16FrequencySeries(mb->hctilde);
+    if (mb->calFactor) XLALDestroyCOMPLEX16Sequence(mb->calFactor);
+    if (mb->frequencies) XLALDestroyREAL8Sequence(mb->frequencies);
+    XLALFree(mb);
+}
+
+void LALInferenceDestroyMultibandLikelihood(LALInferenceRunState *runState)
+{
+    if (!runState) return;
+    for (INT4 t = 0; t < runState->nthreads; t++) {
+        LALInferenceModel *model = runState->threads[t].model;
+        if (!model) continue;
+        LALInferenceDestroyMultibandModel(model->mb);
+        model->mb = NULL;
+        model->mb_flag = 0;
+    }
+    /* the data weights are shared between threads, so free them once */
+    for (LALInferenceIFOData *ifo = runState->data; ifo; ifo = ifo->next) {
+        if (!ifo->mb) continue;
+        if (ifo->mb->weightsLinear) XLALFree(ifo->mb->weightsLinear);
+        if (ifo->mb->weightsQuadratic) XLALFree(ifo->mb->weightsQuadratic);
+        XLALFree(ifo->mb);
+        ifo->mb = NULL;
+    }
+}
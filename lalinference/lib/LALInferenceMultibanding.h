@@ -9,8 +9,28 @@
 #ifndef _LALInferenceFVectorMultiBanding_Flat_h
 #define _LALInferenceFVectorMultiBanding_Flat_h
 
+#include <lal/LALInference.h>
+
 /** Create a list of frequencies to use in multiband template generation, between f_min and f_max
  mc is minimum allowable chirp mass (sets freq evolution assumption ) */
 REAL8Sequence *LALInferenceMultibandFrequencies(int NBands, double f_min, double f_max, double deltaF0, double mc);
 
+/** Set up the multibanded likelihood. The frequency range of data is split into bands whose
+ frequency resolution is as coarse as the duration of the longest allowed signal in the band permits,
+ given the minimum chirp mass mc_min and the prior range [t_min, t_max] of the GPS arrival time.
+ The <d|h> and <h|h> weights at the band nodes are computed once for every IFO in data (they are
+ shared between threads), and the node frequencies and waveform buffers are attached to model. */
+int LALInferenceSetupMultibandLikelihood(LALInferenceModel *model, LALInferenceIFOData *data, REAL8 mc_min, REAL8 t_min, REAL8 t_max);
+
+/** Compute <d|h> and <h|h> for one IFO from the waveform at the band nodes in model->mb,
+ for antenna response (Fplus, Fcross) and template time shift timeshift relative to the data epoch.
+ The complex <d|h> follows the convention of the ROQ likelihood, sum of weight * conj(template). */
+void LALInferenceMultibandInnerProducts(const LALInferenceMultibandData *weights, const LALInferenceMultibandModel *mb, REAL8 Fplus, REAL8 Fcross, REAL8 timeshift, int spcal_active, COMPLEX16 *d_inner_h, REAL8 *h_inner_h);
+
+/** Free the model-side multibanding buffers */
+void LALInferenceDestroyMultibandModel(LALInferenceMultibandModel *mb);
+
+/** Free the multibanding buffers of the models of all threads of runState and the weights of its data */
+void LALInferenceDestroyMultibandLikelihood(LALInferenceRunState *runState);
+
 #endif
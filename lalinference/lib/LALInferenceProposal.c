@@ -47,6 +47,11 @@
 #include <lal/LALStdlib.h>
 #include <lal/LALInferenceClusteredKDE.h>
 #include <lal/LALInferenceNestedSampler.h>
+#include <lal/LALConfig.h>
+
+#ifdef LAL_PTHREAD_LOCK
+#include <pthread.h>
+#endif
 
 #ifdef __GNUC__
 #define UNUSED __attribute__ ((unused))
@@ -91,6 +96,7 @@ const char *const ensembleWalkFullName = "EnsembleWalkFull";
 const char *const ensembleWalkIntrinsicName = "EnsembleWalkIntrinsic";
 const char *const ensembleWalkExtrinsicName = "EnsembleWalkExtrinsic";
 const char *const clusteredKDEProposalName = "ClusteredKDEProposal";
+const char *const clusteredKDEJobName = "ClusteredKDEJob";
 const char *const splineCalibrationProposalName = "SplineCalibration";
 const char *const distanceLikelihoodProposalName = "DistanceLikelihood";
 
@@ -862,6 +868,54 @@ REAL8 LALInferenceEnsembleStretchExtrinsic(LALInferenceThreadState *thread,
     return logPropRatio;
 }
 
+/* Find the values in params of the columns of the differential evolution
+ * matrix, and select the columns named in names (all of them if names is
+ * NULL).  Returns the number of selected columns, whose indices are put in
+ * cols; values[c] points to the REAL8 value of column c in params, or is NULL
+ * if params does not vary that parameter. */
+static UINT4 de_buffer_select(const LALInferenceDEBuffer *buffer,
+                              LALInferenceVariables *params,
+                              const char **names,
+                              INT4 *cols, REAL8 **values) {
+    LALInferenceVariableItem *item;
+    UINT4 c, k, n = 0;
+    INT4 col;
+
+    for (c = 0; c < buffer->nPar; c++)
+        values[c] = NULL;
+
+    /* The columns were taken from variables with the same ordering, so
+     * usually the next column is the one we want */
+    c = 0;
+    for (item = params->head; item; item = item->next) {
+        if (item->type != LALINFERENCE_REAL8_t ||
+            (item->vary != LALINFERENCE_PARAM_LINEAR && item->vary != LALINFERENCE_PARAM_CIRCULAR))
+            continue;
+        if (c < buffer->nPar && !strcmp(item->name, buffer->names[c]))
+            col = (INT4) c;
+        else
+            col = LALInferenceDEBufferColumn(buffer, item->name);
+        if (col >= 0) {
+            values[col] = (REAL8 *) item->value;
+            c = col + 1;
+        }
+    }
+
+    if (names == NULL) {
+        for (c = 0; c < buffer->nPar; c++)
+            if (values[c])
+                cols[n++] = (INT4) c;
+    } else {
+        for (k = 0; names[k] != NULL; k++) {
+            col = LALInferenceDEBufferColumn(buffer, names[k]);
+            if (col >= 0 && values[col])
+                cols[n++] = col;
+        }
+    }
+
+    return n;
+}
+
 /* This jump uses the current sample 'A' and another randomly
  * drawn 'B' from the ensemble of live points, and proposes
  * C = B+Z(A-B) where Z is a scale factor */
@@ -916,10 +970,40 @@ REAL8 LALInferenceEnsembleStretchNames(LALInferenceThreadState *thread,
         return logPropRatio; /* Quit now, since we don't have any points to use. */
     }
 
+    LALInferenceDEBuffer *buffer = LALInferenceDEBufferInSync(thread) ? thread->deBuffer : NULL;
+    UINT4 nCols = buffer && buffer->nPar > 0 ? buffer->nPar : 1;
+    INT4 cols[nCols];
+    REAL8 *values[nCols];
+    const REAL8 *current[nCols];
+    const REAL8 *row = NULL;
+    UINT4 c, n = 0, same;
+
     /* Choose a different sample */
-    do {
-        i = gsl_rng_uniform_int(thread->GSLrandom, nPts);
-    } while (!LALInferenceCompareVariables(currentParams, dePts[i]));
+    if (buffer) {
+        n = de_buffer_select(buffer, proposedParams, names, cols, values);
+        /* every column takes part in the comparison, including those the
+         * current sample no longer varies; a column missing from the
+         * sample makes every row differ */
+        for (c = 0; c < buffer->nPar; c++) {
+            current[c] = values[c];
+            if (!current[c]) {
+                item = LALInferenceGetItem(proposedParams, buffer->names[c]);
+                if (item && item->type == LALINFERENCE_REAL8_t)
+                    current[c] = (const REAL8 *) item->value;
+            }
+        }
+        do {
+            i = gsl_rng_uniform_int(thread->GSLrandom, nPts);
+            row = LALInferenceDEBufferRow(buffer, i);
+            for (same = 1, c = 0; same && c < buffer->nPar; c++)
+                if (!current[c] || *current[c] != row[c])
+                    same = 0;
+        } while (same);
+    } else {
+        do {
+            i = gsl_rng_uniform_int(thread->GSLrandom, nPts);
+        } while (!LALInferenceCompareVariables(currentParams, dePts[i]));
+    }
 
     ptI = dePts[i];
 
@@ -935,15 +1019,23 @@ REAL8 LALInferenceEnsembleStretchNames(LALInferenceThreadState *thread,
     X = 2.0*logmax*Y - logmax;
     scale = exp(X);
 
-    for (i = 0; names[i] != NULL; i++) {
-        /* Ignore variable if it's not in each of the params. */
-        if (LALInferenceCheckVariableNonFixed(proposedParams, names[i]) &&
-            LALInferenceCheckVariableNonFixed(ptI, names[i])) {
-                cur = LALInferenceGetREAL8Variable(proposedParams, names[i]);
-                other= LALInferenceGetREAL8Variable(ptI, names[i]);
-                x = other + scale*(cur-other);
-
-                LALInferenceSetVariable(proposedParams, names[i], &x);
+    if (buffer) {
+        for (c = 0; c < n; c++) {
+            cur = *values[cols[c]];
+            other = row[cols[c]];
+            *values[cols[c]] = other + scale*(cur-other);
+        }
+    } else {
+        for (i = 0; names[i] != NULL; i++) {
+            /* Ignore variable if it's not in each of the params. */
+            if (LALInferenceCheckVariableNonFixed(proposedParams, names[i]) &&
+                LALInferenceCheckVariableNonFixed(ptI, names[i])) {
+                    cur = LALInferenceGetREAL8Variable(proposedParams, names[i]);
+                    other= LALInferenceGetREAL8Variable(ptI, names[i]);
+                    x = other + scale*(cur-other);
+
+                    LALInferenceSetVariable(proposedParams, names[i], &x);
+            }
         }
     }
 
@@ -1037,6 +1129,29 @@ REAL8 LALInferenceEnsembleWalkNames(LALInferenceThreadState *thread,
   double univariate_normals[sample_size];
   for(i=0;i<sample_size;i++) univariate_normals[i] = gsl_ran_ugaussian(thread->GSLrandom);
 
+  if (LALInferenceDEBufferInSync(thread))
+  {
+    LALInferenceDEBuffer *buffer = thread->deBuffer;
+    INT4 cols[buffer->nPar > 0 ? buffer->nPar : 1];
+    REAL8 *values[buffer->nPar > 0 ? buffer->nPar : 1];
+    const REAL8 *rows[sample_size];
+    UINT4 c, n;
+
+    n = de_buffer_select(buffer, proposedParams, names, cols, values);
+    for(i=0;i<sample_size;i++) rows[i] = LALInferenceDEBufferRow(buffer, indices[i]);
+
+    for(c=0;c<n;c++)
+    {
+      INT4 col = cols[c];
+      REAL8 centre_of_mass=0.0;
+      for(i=0;i<sample_size;i++) centre_of_mass+=rows[i][col]/((REAL8)sample_size);
+      for(i=0,w=0.0;i<sample_size;i++) w+= univariate_normals[i] * (rows[i][col] - centre_of_mass);
+      *values[col] += w;
+    }
+
+    return logPropRatio;
+  }
+
   /* Note: Simplified this loop on master 2015-08-12, take this version when rebasing */
   for(k=0;names[k]!=NULL;k++)
   {
@@ -1069,6 +1184,7 @@ REAL8 LALInferenceDifferentialEvolutionNames(LALInferenceThreadState *thread,
     LALInferenceVariableItem *item;
     LALInferenceVariables **dePts;
     LALInferenceVariables *ptI, *ptJ;
+    const REAL8 *rowI, *rowJ;
     REAL8 logPropRatio = 0.0;
     REAL8 scale, x;
     N = LALInferenceGetVariableDimension(currentParams) + 1; /* More names than we need. */
@@ -1113,6 +1229,11 @@ REAL8 LALInferenceDifferentialEvolutionNames(LALInferenceThreadState *thread,
 
     ptI = dePts[i];
     ptJ = dePts[j];
+    rowI = rowJ = NULL;
+    if (LALInferenceDEBufferInSync(thread)) {
+        rowI = LALInferenceDEBufferRow(thread->deBuffer, i);
+        rowJ = LALInferenceDEBufferRow(thread->deBuffer, j);
+    }
 
     const REAL8 modeHoppingFrac = 0.5;
     /* Some fraction of the time, we do a "mode hopping" jump,
@@ -1125,6 +1246,23 @@ REAL8 LALInferenceDifferentialEvolutionNames(LALInferenceThreadState *thread,
         scale = 2.38/sqrt(Ndim) * exp(log(0.1) + log(100.0) * gsl_rng_uniform(rng));
     }
 
+    if (rowI) {
+        LALInferenceDEBuffer *buffer = thread->deBuffer;
+        INT4 cols[buffer->nPar > 0 ? buffer->nPar : 1];
+        REAL8 *values[buffer->nPar > 0 ? buffer->nPar : 1];
+        UINT4 c, n;
+
+        n = de_buffer_select(buffer, proposedParams, names, cols, values);
+        for (c = 0; c < n; c++) {
+            x = *values[cols[c]];
+            x += scale * rowJ[cols[c]];
+            x -= scale * rowI[cols[c]];
+            *values[cols[c]] = x;
+        }
+
+        return logPropRatio;
+    }
+
     for (i = 0; names[i] != NULL; i++) {
         if (!LALInferenceCheckVariableNonFixed(currentParams, names[i]) ||
             !LALInferenceCheckVariable(ptJ, names[i]) ||
@@ -3079,6 +3217,10 @@ void LALInferenceSetupClusteredKDEProposalsFromASCII(LALInferenceThreadState *th
 }
 
 
+static void build_clustered_kde(LALInferenceClusteredKDE *kde, REAL8 *array, INT4 nSamps, LALInferenceVariables *params, const char *name, REAL8 weight, LALInferenceKmeans* (*cluster_method)(gsl_matrix*, INT4, gsl_rng*), INT4 cyclic_reflective, INT4 ntrials, gsl_rng *rng, LALInferenceVariables *priorArgs);
+static void dump_clustered_kde(LALInferenceThreadState *thread, LALInferenceClusteredKDE *kde, REAL8 *array);
+
+
 /**
  * Initialize a clustered-KDE proposal.
  *
@@ -3105,11 +3247,32 @@ void LALInferenceInitClusteredKDEProposal(LALInferenceThreadState *thread,
                                           LALInferenceKmeans* (*cluster_method)(gsl_matrix*, INT4, gsl_rng*),
                                           INT4 cyclic_reflective,
                                           INT4 ntrials) {
+    build_clustered_kde(kde, array, nSamps, params, name, weight, cluster_method,
+                        cyclic_reflective, ntrials, thread->GSLrandom, thread->priorArgs);
+
+    /* Return if kmeans setup failed */
+    if (!kde->kmeans)
+        return;
+
+    dump_clustered_kde(thread, kde, array);
+}
+
+
+/* Cluster and estimate the distribution of \a array, without touching any
+ * thread state, so it can be run away from the sampling thread. */
+static void build_clustered_kde(LALInferenceClusteredKDE *kde,
+                                REAL8 *array,
+                                INT4 nSamps,
+                                LALInferenceVariables *params,
+                                const char *name,
+                                REAL8 weight,
+                                LALInferenceKmeans* (*cluster_method)(gsl_matrix*, INT4, gsl_rng*),
+                                INT4 cyclic_reflective,
+                                INT4 ntrials,
+                                gsl_rng *rng,
+                                LALInferenceVariables *priorArgs) {
     INT4 dim;
-    INT4 ndraws = 1000;
     gsl_matrix_view mview;
-    char outp_name[256];
-    char outp_draws_name[256];
 
     strcpy(kde->name, name);
     dim = LALInferenceGetVariableDimensionNonFixed(params);
@@ -3117,7 +3280,7 @@ void LALInferenceInitClusteredKDEProposal(LALInferenceThreadState *thread,
     /* If kmeans is already assigned, assume it was calculated elsewhere */
     if (!kde->kmeans) {
         mview = gsl_matrix_view_array(array, nSamps, dim);
-        kde->kmeans = (*cluster_method)(&mview.matrix, ntrials, thread->GSLrandom);
+        kde->kmeans = (*cluster_method)(&mview.matrix, ntrials, rng);
     }
 
     /* Return if kmeans setup failed */
@@ -3131,9 +3294,16 @@ void LALInferenceInitClusteredKDEProposal(LALInferenceThreadState *thread,
     kde->next = NULL;
 
     /* Selectivey impose bounds on KDEs */
-    LALInferenceKmeansImposeBounds(kde->kmeans, params, thread->priorArgs, cyclic_reflective);
+    LALInferenceKmeansImposeBounds(kde->kmeans, params, priorArgs, cyclic_reflective);
+}
+
+
+/* Print out clustered samples, assignments, and PDF values if requested */
+static void dump_clustered_kde(LALInferenceThreadState *thread, LALInferenceClusteredKDE *kde, REAL8 *array) {
+    INT4 ndraws = 1000;
+    char outp_name[256];
+    char outp_draws_name[256];
 
-    /* Print out clustered samples, assignments, and PDF values if requested */
     if (LALInferenceGetINT4Variable(thread->proposalArgs, "verbose")) {
         printf("Thread %i found %i clusters.\n", thread->id, kde->kmeans->k);
 
@@ -3268,6 +3438,13 @@ void LALInferenceDestroyClusteredKDEProposal(LALInferenceClusteredKDE *proposal)
 }
 
 
+static REAL8 *clustered_kde_samples_from_de_buffer(LALInferenceThreadState *thread, INT4 *nPoints);
+static LALInferenceVariables *clustered_kde_params(LALInferenceThreadState *thread);
+
+/* Weight of a clustered-KDE proposal built from the run itself */
+static const REAL8 clusteredKDEProposalWeight = 2.;
+
+
 /**
  * Setup a clustered-KDE proposal from the differential evolution buffer.
  *
@@ -3276,6 +3453,23 @@ void LALInferenceDestroyClusteredKDEProposal(LALInferenceClusteredKDE *proposal)
  * @param thread The LALInferenceThreadState to get the buffer from and add the proposal to.
  */
 void LALInferenceSetupClusteredKDEProposalFromDEBuffer(LALInferenceThreadState *thread) {
+    INT4 nPoints;
+    REAL8 *samples = clustered_kde_samples_from_de_buffer(thread, &nPoints);
+
+    /* Check if imposing cyclic reflective bounds */
+    INT4 cyclic_reflective = LALInferenceGetINT4Variable(thread->proposalArgs, "cyclic_reflective_kde");
+
+    INT4 ntrials = 5;
+    LALInferenceSetupClusteredKDEProposalFromRun(thread, samples, nPoints, cyclic_reflective, ntrials);
+
+    /* The proposal copies the data, so the local array can be freed */
+    XLALFree(samples);
+}
+
+
+/* Copy the independent samples of the differential evolution buffer into a
+ * new row-major array, returning the number of rows in \a nPoints. */
+static REAL8 *clustered_kde_samples_from_de_buffer(LALInferenceThreadState *thread, INT4 *nPoints) {
     INT4 i;
 
     /* If ACL can be estimated, thin DE buffer to only have independent samples */
@@ -3290,27 +3484,176 @@ void LALInferenceSetupClusteredKDEProposalFromDEBuffer(LALInferenceThreadState *
 
     if (step == 0)
         step = 1;
-    INT4 nPoints = (INT4) ceil(bufferSize/(REAL8)step);
+    *nPoints = (INT4) ceil(bufferSize/(REAL8)step);
 
     /* Get points to be clustered from the differential evolution buffer. */
     INT4 nPar = LALInferenceGetVariableDimensionNonFixed(thread->currentParams);
-    REAL8** DEsamples = (REAL8**) XLALCalloc(nPoints, sizeof(REAL8*));
-    REAL8*  temp = (REAL8*) XLALCalloc(nPoints * nPar, sizeof(REAL8));
-    for (i=0; i < nPoints; i++)
+    REAL8** DEsamples = (REAL8**) XLALCalloc(*nPoints, sizeof(REAL8*));
+    REAL8*  temp = (REAL8*) XLALCalloc(*nPoints * nPar, sizeof(REAL8));
+    for (i=0; i < *nPoints; i++)
       DEsamples[i] = temp + (i*nPar);
 
     LALInferenceThinnedBufferToArray(thread, DEsamples, step);
 
-    /* Check if imposing cyclic reflective bounds */
-    INT4 cyclic_reflective = LALInferenceGetINT4Variable(thread->proposalArgs, "cyclic_reflective_kde");
+    XLALFree(DEsamples);
+    return temp;
+}
 
-    INT4 ntrials = 5;
-    LALInferenceSetupClusteredKDEProposalFromRun(thread, DEsamples[0], nPoints, cyclic_reflective, ntrials);
 
-    /* The proposal copies the data, so the local array can be freed */
-    XLALFree(temp);
-    XLALFree(DEsamples);
+/* Collect the names, in order, of the parameters being clustered */
+static LALInferenceVariables *clustered_kde_params(LALInferenceThreadState *thread) {
+    LALInferenceVariables *backwardClusterParams = XLALCalloc(1, sizeof(LALInferenceVariables));
+    LALInferenceVariables *clusterParams = XLALCalloc(1, sizeof(LALInferenceVariables));
+    LALInferenceVariableItem *item;
+    for (item = thread->currentParams->head; item; item = item->next)
+        if (LALInferenceCheckVariableNonFixed(thread->currentParams, item->name))
+            LALInferenceAddVariable(backwardClusterParams, item->name, item->value, item->type, item->vary);
+    for (item = backwardClusterParams->head; item; item = item->next)
+        LALInferenceAddVariable(clusterParams, item->name, item->value, item->type, item->vary);
+
+    LALInferenceClearVariables(backwardClusterParams);
+    XLALFree(backwardClusterParams);
+
+    return clusterParams;
+}
+
+
+#ifdef LAL_PTHREAD_LOCK
+/** A clustered-KDE proposal being built on a background thread. */
+typedef struct tagClusteredKDEJob {
+    pthread_t tid;
+    pthread_mutex_t lock;
+    INT4 done;                            /* Set by the worker when finished */
+    REAL8 *samples;                       /* Snapshot of the DE buffer */
+    INT4 nSamps;
+    INT4 cyclic_reflective;
+    INT4 ntrials;
+    LALInferenceVariables *params;        /* Handed to the proposal */
+    LALInferenceVariables *priorArgs;     /* Private copy of the prior bounds */
+    gsl_rng *rng;                         /* Private generator for clustering */
+    LALInferenceClusteredKDE *proposal;
+} ClusteredKDEJob;
+
+
+static void *clustered_kde_job_run(void *arg) {
+    ClusteredKDEJob *job = arg;
+
+    job->proposal = XLALCalloc(1, sizeof(LALInferenceClusteredKDE));
+    build_clustered_kde(job->proposal, job->samples, job->nSamps, job->params,
+                        clusteredKDEProposalName, clusteredKDEProposalWeight,
+                        LALInferenceOptimizedKmeans, job->cyclic_reflective,
+                        job->ntrials, job->rng, job->priorArgs);
+
+    pthread_mutex_lock(&job->lock);
+    job->done = 1;
+    pthread_mutex_unlock(&job->lock);
+
+    return NULL;
 }
+#endif
+
+
+/**
+ * Start rebuilding the clustered-KDE proposal on a background thread.
+ *
+ * The independent samples of the differential evolution buffer are copied,
+ * and clustered on a new thread while the chain keeps using its current
+ * proposal.  The result is installed by
+ * LALInferenceCollectClusteredKDEProposal().  Nothing is started while a
+ * previous rebuild is still pending.  Without thread support the proposal
+ * is rebuilt immediately, as in LALInferenceSetupClusteredKDEProposalFromDEBuffer().
+ * @param thread The LALInferenceThreadState to get the buffer from.
+ */
+void LALInferenceSetupClusteredKDEProposalFromDEBufferAsync(LALInferenceThreadState *thread) {
+#ifdef LAL_PTHREAD_LOCK
+    if (LALInferenceCheckVariable(thread->proposalArgs, clusteredKDEJobName))
+        return;
+
+    ClusteredKDEJob *job = XLALCalloc(1, sizeof(ClusteredKDEJob));
+    job->samples = clustered_kde_samples_from_de_buffer(thread, &job->nSamps);
+    job->params = clustered_kde_params(thread);
+    job->cyclic_reflective = LALInferenceGetINT4Variable(thread->proposalArgs, "cyclic_reflective_kde");
+    job->ntrials = 5;
+
+    job->priorArgs = XLALCalloc(1, sizeof(LALInferenceVariables));
+    LALInferenceCopyVariables(thread->priorArgs, job->priorArgs);
+
+    /* Seed from the chain's generator, so runs stay reproducible */
+    job->rng = gsl_rng_alloc(gsl_rng_mt19937);
+    gsl_rng_set(job->rng, gsl_rng_get(thread->GSLrandom));
+
+    pthread_mutex_init(&job->lock, NULL);
+    if (pthread_create(&job->tid, NULL, clustered_kde_job_run, job)) {
+        /* Couldn't start a worker, so build in the foreground instead */
+        clustered_kde_job_run(job);
+        job->tid = pthread_self();
+    }
+
+    LALInferenceAddVariable(thread->proposalArgs, clusteredKDEJobName, (void *)&job, LALINFERENCE_void_ptr_t, LALINFERENCE_PARAM_FIXED);
+#else
+    LALInferenceSetupClusteredKDEProposalFromDEBuffer(thread);
+#endif
+}
+
+
+/**
+ * Install a clustered-KDE proposal built in the background.
+ *
+ * Checks for a rebuild started by LALInferenceSetupClusteredKDEProposalFromDEBufferAsync()
+ * and, once it has finished, adds the new proposal to the set in place of the old one.
+ * @param thread The LALInferenceThreadState that started the rebuild.
+ * @param wait   If non-zero, block until a pending rebuild finishes.
+ * @return 1 if a new proposal was installed, 0 otherwise.
+ */
+INT4 LALInferenceCollectClusteredKDEProposal(LALInferenceThreadState *thread, INT4 wait) {
+#ifdef LAL_PTHREAD_LOCK
+    INT4 installed = 0;
+
+    if (!LALInferenceCheckVariable(thread->proposalArgs, clusteredKDEJobName))
+        return 0;
+
+    ClusteredKDEJob *job = *(ClusteredKDEJob **)LALInferenceGetVariable(thread->proposalArgs, clusteredKDEJobName);
+
+    if (!wait) {
+        pthread_mutex_lock(&job->lock);
+        INT4 done = job->done;
+        pthread_mutex_unlock(&job->lock);
+        if (!done)
+            return 0;
+    }
+
+    if (!pthread_equal(job->tid, pthread_self()))
+        pthread_join(job->tid, NULL);
+    LALInferenceRemoveVariable(thread->proposalArgs, clusteredKDEJobName);
+
+    if (job->proposal->kmeans) {
+        /* Draws from the proposal come from the chain's generator from now on */
+        job->proposal->kmeans->rng = thread->GSLrandom;
+
+        dump_clustered_kde(thread, job->proposal, job->samples);
+        LALInferenceAddClusteredKDEProposalToSet(thread->proposalArgs, job->proposal);
+        installed = 1;
+    } else {
+        LALInferenceClearVariables(job->params);
+        XLALFree(job->params);
+        XLALFree(job->proposal);
+    }
+
+    LALInferenceClearVariables(job->priorArgs);
+    XLALFree(job->priorArgs);
+    XLALFree(job->samples);
+    gsl_rng_free(job->rng);
+    pthread_mutex_destroy(&job->lock);
+    XLALFree(job);
+
+    return installed;
+#else
+    (void)thread;
+    (void)wait;
+    return 0;
+#endif
+}
+
 
 /**
  * Setup a clustered-KDE proposal from the parameters in a run.
@@ -3325,17 +3668,10 @@ void LALInferenceSetupClusteredKDEProposalFromDEBuffer(LALInferenceThreadState *
  * @param ntrials  Number of tirals at fixed-k to find optimal BIC
  */
 void LALInferenceSetupClusteredKDEProposalFromRun(LALInferenceThreadState *thread, REAL8 *samples, INT4 size, INT4 cyclic_reflective, INT4 ntrials) {
-    REAL8 weight=2.;
+    REAL8 weight=clusteredKDEProposalWeight;
 
     /* Keep track of clustered parameter names */
-    LALInferenceVariables *backwardClusterParams = XLALCalloc(1, sizeof(LALInferenceVariables));
-    LALInferenceVariables *clusterParams = XLALCalloc(1, sizeof(LALInferenceVariables));
-    LALInferenceVariableItem *item;
-    for (item = thread->currentParams->head; item; item = item->next)
-        if (LALInferenceCheckVariableNonFixed(thread->currentParams, item->name))
-            LALInferenceAddVariable(backwardClusterParams, item->name, item->value, item->type, item->vary);
-    for (item = backwardClusterParams->head; item; item = item->next)
-        LALInferenceAddVariable(clusterParams, item->name, item->value, item->type, item->vary);
+    LALInferenceVariables *clusterParams = clustered_kde_params(thread);
 
     /* Build the proposal */
     LALInferenceClusteredKDE *proposal = XLALCalloc(1, sizeof(LALInferenceClusteredKDE));
@@ -3349,9 +3685,6 @@ void LALInferenceSetupClusteredKDEProposalFromRun(LALInferenceThreadState *threa
         XLALFree(clusterParams);
         XLALFree(proposal);
     }
-
-    LALInferenceClearVariables(backwardClusterParams);
-    XLALFree(backwardClusterParams);
 }
 
 
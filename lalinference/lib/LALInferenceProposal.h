@@ -295,6 +295,12 @@ void LALInferenceDestroyClusteredKDEProposal(LALInferenceClusteredKDE *proposal)
 /* Setup a clustered-KDE proposal from the differential evolution buffer. */
 void LALInferenceSetupClusteredKDEProposalFromDEBuffer(LALInferenceThreadState *thread);
 
+/* Start rebuilding the clustered-KDE proposal from the differential evolution buffer on a background thread. */
+void LALInferenceSetupClusteredKDEProposalFromDEBufferAsync(LALInferenceThreadState *thread);
+
+/* Install a clustered-KDE proposal built in the background. */
+INT4 LALInferenceCollectClusteredKDEProposal(LALInferenceThreadState *thread, INT4 wait);
+
 /* Setup a clustered-KDE proposal from the parameters in a run. */
 void LALInferenceSetupClusteredKDEProposalFromRun(LALInferenceThreadState *thread, REAL8 *samples, INT4 size, INT4 cyclic_reflective, INT4 ntrials);
 
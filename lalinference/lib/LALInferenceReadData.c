@@ -75,6 +75,7 @@
 #include <lal/LALInferenceLikelihood.h>
 #include <lal/LALInferenceTemplate.h>
 #include <lal/LALInferenceInit.h>
+#include <lal/LALInferenceGenerateROQ.h>
 #include <lal/LALSimNoise.h>
 #include <LALInferenceRemoveLines.h>
 /* LIB deps */
@@ -2728,6 +2729,65 @@ void LALInferenceSetupROQmodel(LALInferenceModel *model, ProcessParamsTable *com
 	  }
 }
 
+/* read n values of the given size from a binary ROQ file named by a command line option */
+static void readROQFile(ProcessParamsTable *commandLine, const char *option, void *data, size_t size, size_t n){
+  ProcessParamsTable *ppt=LALInferenceGetProcParamVal(commandLine,option);
+  FILE *fp=NULL;
+  int errsave;
+
+  if (ppt == NULL){
+    fprintf(stderr, "Error: %s must be given\n", option);
+    exit(1);
+  }
+  fp = fopen(ppt->value, "rb");
+  if (fp == NULL){
+    errsave = errno;
+    fprintf(stderr, "Error: cannot find file %s \n", ppt->value);
+    fprintf(stderr, "Error code %i: %s\n", errsave, strerror(errsave));
+    exit(errsave);
+  }
+  if (fread(data, size, n, fp) != n){
+    fprintf(stderr, "Error: file %s is too short, expected %zu values\n", ppt->value, n);
+    exit(1);
+  }
+  fclose(fp);
+}
+
+/* Build the ROQ weights for every detector from the interpolant matrices
+ * (B_linear and B_quadratic, written as raw row-major binary files) instead
+ * of reading weight files computed offline by lalinference_compute_roq_weights.py */
+static void LALInferenceSetupROQdataFromBasis(LALInferenceIFOData *IFOdata, ProcessParamsTable *commandLine, UINT4 n_basis_linear, UINT4 n_basis_quadratic, UINT4 n_samples, UINT4 time_steps){
+  LALInferenceCOMPLEXROQInterpolant linear;
+  LALInferenceREALROQInterpolant quadratic;
+  UINT4Vector *dims = XLALCreateUINT4Vector(2);
+  REAL8Vector *tcs = XLALCreateREAL8Vector(time_steps);
+
+  /* the interpolation nodes are only needed by the model, which reads them from --roqnodesLinear/Quadratic */
+  dims->data[0] = n_basis_linear;
+  dims->data[1] = n_samples;
+  linear.B = XLALCreateCOMPLEX16Array(dims);
+  linear.nodes = NULL;
+  dims->data[0] = n_basis_quadratic;
+  quadratic.B = XLALCreateREAL8Array(dims);
+  quadratic.nodes = NULL;
+  XLALDestroyUINT4Vector(dims);
+
+  readROQFile(commandLine, "--roqBLinear", linear.B->data, sizeof(COMPLEX16), (size_t)n_basis_linear*n_samples);
+  readROQFile(commandLine, "--roqBQuadratic", quadratic.B->data, sizeof(REAL8), (size_t)n_basis_quadratic*n_samples);
+  readROQFile(commandLine, "--roq-times", tcs->data, sizeof(REAL8), time_steps);
+
+  /* the interpolant frequencies start at the lower frequency cut-off */
+  if (LALInferenceSetupROQDataFromInterpolants(IFOdata, NULL, &linear, &quadratic, IFOdata->fLow, tcs) != XLAL_SUCCESS){
+    fprintf(stderr, "Error: could not build the ROQ weights from the interpolants\n");
+    exit(1);
+  }
+  fprintf(stderr, "built ROQ weights from --roqBLinear and --roqBQuadratic\n");
+
+  XLALDestroyCOMPLEX16Array(linear.B);
+  XLALDestroyREAL8Array(quadratic.B);
+  XLALDestroyREAL8Vector(tcs);
+}
+
 void LALInferenceSetupROQdata(LALInferenceIFOData *IFOdata, ProcessParamsTable *commandLine){
   LALStatus status;
   memset(&status,0,sizeof(status));
@@ -2794,6 +2854,10 @@ void LALInferenceSetupROQdata(LALInferenceIFOData *IFOdata, ProcessParamsTable *
     fprintf(stderr, "loaded --roqtime_steps\n");
   }
 
+  if (LALInferenceGetProcParamVal(commandLine,"--roqBLinear")) {
+    LALInferenceSetupROQdataFromBasis(IFOdata, commandLine, n_basis_linear, n_basis_quadratic, n_samples, time_steps);
+    return;
+  }
 
   thisData=IFOdata;
     while (thisData) {
@@ -238,8 +238,13 @@ void LALInferenceROQWrapperForXLALSimInspiralChooseFDWaveformSequence(LALInferen
   int ret=0;
   INT4 errnum=0;
 
-  model->roq->hptildeLinear=NULL, model->roq->hctildeLinear=NULL;
-  model->roq->hptildeQuadratic=NULL, model->roq->hctildeQuadratic=NULL;
+  if (model->mb_flag) {
+    model->mb->hptilde=NULL, model->mb->hctilde=NULL;
+  }
+  else {
+    model->roq->hptildeLinear=NULL, model->roq->hctildeLinear=NULL;
+    model->roq->hptildeQuadratic=NULL, model->roq->hctildeQuadratic=NULL;
+  }
   REAL8 mc;
   REAL8 phi0, m1, m2, distance, inclination;
 
@@ -476,11 +481,28 @@ void LALInferenceROQWrapperForXLALSimInspiralChooseFDWaveformSequence(LALInferen
   /* ==== Call the waveform generator ==== */
     /* Correct distance to account for renormalisation of data due to window RMS */
     double corrected_distance = distance * sqrt(model->window->sumofsquares/model->window->data->length);
+  if (model->mb_flag) {
+    /* Multibanded likelihood: a single waveform at the nodes of all bands */
+    XLAL_TRY(ret=XLALSimInspiralChooseFDWaveformSequence (&(model->mb->hptilde), &(model->mb->hctilde), phi0, m1*LAL_MSUN_SI, m2*LAL_MSUN_SI,
+                spin1x, spin1y, spin1z, spin2x, spin2y, spin2z, f_ref, corrected_distance, inclination, model->LALpars, approximant, model->mb->frequencies), errnum);
+    if(ret!=XLAL_SUCCESS){
+      if ( model->mb->hptilde ) XLALDestroyCOMPLEX16FrequencySeries(model->mb->hptilde);
+      if ( model->mb->hctilde ) XLALDestroyCOMPLEX16FrequencySeries(model->mb->hctilde);
+      model->mb->hptilde=NULL, model->mb->hctilde=NULL;
+      errnum&=~XLAL_EFUNC; /* Mask out the internal function failure bit */
+      if (errnum == XLAL_EDOM)
+        /* The waveform was called outside its domain, the likelihood returns -inf */
+        XLAL_ERROR_VOID(XLAL_EUSR0);
+      XLAL_ERROR_VOID(errnum, "Error generating waveform at the multiband nodes");
+    }
+  }
+  else {
     XLAL_TRY(ret=XLALSimInspiralChooseFDWaveformSequence (&(model->roq->hptildeLinear), &(model->roq->hctildeLinear), phi0, m1*LAL_MSUN_SI, m2*LAL_MSUN_SI,
                 spin1x, spin1y, spin1z, spin2x, spin2y, spin2z, f_ref, corrected_distance, inclination, model->LALpars, approximant, (model->roq->frequencyNodesLinear)), errnum);
 
     XLAL_TRY(ret=XLALSimInspiralChooseFDWaveformSequence (&(model->roq->hptildeQuadratic), &(model->roq->hctildeQuadratic), phi0, m1*LAL_MSUN_SI, m2*LAL_MSUN_SI,
 							spin1x, spin1y, spin1z, spin2x, spin2y, spin2z, f_ref, corrected_distance, inclination, model->LALpars, approximant, (model->roq->frequencyNodesQuadratic)), errnum);
+  }
 
     REAL8 instant = model->freqhPlus->epoch.gpsSeconds + 1e-9*model->freqhPlus->epoch.gpsNanoSeconds;
     LALInferenceSetVariable(model->params, "time", &instant);
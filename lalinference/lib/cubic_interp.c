@@ -88,7 +88,7 @@ static double cubic_eval(const double *a, double t)
 static void cubic_interp_index(
     double f, double t0, double length, double *t, double *i)
 {
-    *t = modf(clip_double(*t * f + t0, 0, length), i);
+    *t = modf(clip_double(*t * f + t0, 0, length - 1), i);
 }
 
 
@@ -133,9 +133,8 @@ double cubic_interp_eval(const cubic_interp *interp, double t)
 }
 
 
-bicubic_interp *bicubic_interp_init(
-    const double *data, int ns, int nt,
-    double smin, double tmin, double ds, double dt)
+bicubic_interp *bicubic_interp_alloc(
+    int ns, int nt, double smin, double tmin, double ds, double dt)
 {
     bicubic_interp *interp;
     const int slength = ns + 6;
@@ -149,37 +148,57 @@ bicubic_interp *bicubic_interp_init(
         interp->t0 = 3 - interp->ft * tmin;
         interp->slength = slength;
         interp->tlength = tlength;
-        for (int is = 0; is < slength; is ++)
+    }
+    return interp;
+}
+
+
+void bicubic_interp_init_block(
+    bicubic_interp *interp, const double *data, int ns, int nt,
+    int is_begin, int is_end, int it_begin, int it_end)
+{
+    const int tlength = interp->tlength;
+    for (int is = is_begin; is < is_end; is ++)
+    {
+        for (int it = it_begin; it < it_end; it ++)
         {
-            for (int it = 0; it < tlength; it ++)
+            double a[4][4], a1[4][4];
+            for (int js = 0; js < 4; js ++)
             {
-                double a[4][4], a1[4][4];
-                for (int js = 0; js < 4; js ++)
-                {
-                    double z[4];
-                    int ks = clip_int(is + js - 4, 0, ns - 1);
-                    for (int jt = 0; jt < 4; jt ++)
-                    {
-                        int kt = clip_int(it + jt - 4, 0, nt - 1);
-                        z[jt] = data[ks * ns + kt];
-                    }
-                    cubic_interp_init_coefficients(a[js], z, z);
-                }
-                for (int js = 0; js < 4; js ++)
+                double z[4];
+                int ks = clip_int(is + js - 4, 0, ns - 1);
+                for (int jt = 0; jt < 4; jt ++)
                 {
-                    for (int jt = 0; jt < 4; jt ++)
-                    {
-                        a1[js][jt] = a[jt][js];
-                    }
+                    int kt = clip_int(it + jt - 4, 0, nt - 1);
+                    z[jt] = data[ks * nt + kt];
                 }
-                for (int js = 0; js < 4; js ++)
+                cubic_interp_init_coefficients(a[js], z, z);
+            }
+            for (int js = 0; js < 4; js ++)
+            {
+                for (int jt = 0; jt < 4; jt ++)
                 {
-                    cubic_interp_init_coefficients(a[js], a1[js], a1[3]);
+                    a1[js][jt] = a[jt][js];
                 }
-                memcpy(interp->a[is * slength + it], a, sizeof(a));
             }
+            for (int js = 0; js < 4; js ++)
+            {
+                cubic_interp_init_coefficients(a[js], a1[js], a1[3]);
+            }
+            memcpy(interp->a[is * tlength + it], a, sizeof(a));
         }
     }
+}
+
+
+bicubic_interp *bicubic_interp_init(
+    const double *data, int ns, int nt,
+    double smin, double tmin, double ds, double dt)
+{
+    bicubic_interp *interp = bicubic_interp_alloc(ns, nt, smin, tmin, ds, dt);
+    if (interp)
+        bicubic_interp_init_block(
+            interp, data, ns, nt, 0, interp->slength, 0, interp->tlength);
     return interp;
 }
 
@@ -200,8 +219,75 @@ double bicubic_interp_eval(const bicubic_interp *interp, double s, double t)
         return s + t;
     cubic_interp_index(interp->fs, interp->s0, interp->slength, &s, &is);
     cubic_interp_index(interp->ft, interp->t0, interp->tlength, &t, &it);
-    a = interp->a[(int) (is * interp->slength + it)];
+    a = interp->a[(int) (is * interp->tlength + it)];
     for (int i = 0; i < 4; i ++)
         b[i] = cubic_eval(a[i], s);
     return cubic_eval(b, t);
 }
+
+
+void bicubic_interp_cell(
+    const bicubic_interp *interp, double s, double t, int *is, int *it)
+{
+    double i;
+    cubic_interp_index(interp->fs, interp->s0, interp->slength, &s, &i);
+    *is = clip_int((int) i, 0, interp->slength - 1);
+    cubic_interp_index(interp->ft, interp->t0, interp->tlength, &t, &i);
+    *it = clip_int((int) i, 0, interp->tlength - 1);
+}
+
+
+/* Number of points handled per pass of bicubic_interp_eval_n() */
+#define BICUBIC_INTERP_BLOCK 64
+
+void bicubic_interp_eval_n(
+    const bicubic_interp *interp, int n,
+    const double *s, const double *t, double *result)
+{
+    const double fs = interp->fs, s0 = interp->s0;
+    const double ft = interp->ft, t0 = interp->t0;
+    const double smax = interp->slength - 1, tmax = interp->tlength - 1;
+    const int tlength = interp->tlength;
+
+    for (int begin = 0; begin < n; begin += BICUBIC_INTERP_BLOCK)
+    {
+        const int m = n - begin < BICUBIC_INTERP_BLOCK ?
+            n - begin : BICUBIC_INTERP_BLOCK;
+        double u[BICUBIC_INTERP_BLOCK], v[BICUBIC_INTERP_BLOCK];
+        int cell[BICUBIC_INTERP_BLOCK];
+
+        /* First find the cells and offsets within them.  This loop has no
+         * branches or calls besides floor(), so it vectorizes. */
+        for (int i = 0; i < m; i ++)
+        {
+            double x = s[begin + i] * fs + s0;
+            double y = t[begin + i] * ft + t0;
+            /* Written so that NaNs also land in the first cell */
+            x = x >= 0 ? x : 0;
+            y = y >= 0 ? y : 0;
+            double ix = floor(x), iy = floor(y);
+            ix = ix > smax ? smax : ix;
+            iy = iy > tmax ? tmax : iy;
+            u[i] = x - ix;
+            v[i] = y - iy;
+            cell[i] = (int) ix * tlength + (int) iy;
+        }
+
+        /* Then evaluate each interpolating polynomial */
+        for (int i = 0; i < m; i ++)
+        {
+            const double (*a)[4] = interp->a[cell[i]];
+            const double x = u[i] > 1 ? 1 : u[i];
+            const double y = v[i] > 1 ? 1 : v[i];
+            double b[4];
+            for (int j = 0; j < 4; j ++)
+                b[j] = cubic_eval(a[j], x);
+            result[begin + i] = cubic_eval(b, y);
+        }
+
+        /* Propagate NaNs as bicubic_interp_eval() does */
+        for (int i = 0; i < m; i ++)
+            if (isnan(s[begin + i]) || isnan(t[begin + i]))
+                result[begin + i] = s[begin + i] + t[begin + i];
+    }
+}
@@ -61,6 +61,26 @@ void bicubic_interp_free(bicubic_interp *interp);
 
 double bicubic_interp_eval(const bicubic_interp *interp, double s, double t);
 
+/* Allocate a bicubic interpolant without filling in any coefficients */
+bicubic_interp *bicubic_interp_alloc(
+    int ns, int nt, double smin, double tmin, double ds, double dt);
+
+/* Fill in the coefficients of cells [is_begin, is_end) x [it_begin, it_end).
+ * Cell (is, it) depends on samples is - 4 to is - 1 and it - 4 to it - 1
+ * of data, clipped to the grid. */
+void bicubic_interp_init_block(
+    bicubic_interp *interp, const double *data, int ns, int nt,
+    int is_begin, int is_end, int it_begin, int it_end);
+
+/* Find the cell used to evaluate the interpolant at (s, t) */
+void bicubic_interp_cell(
+    const bicubic_interp *interp, double s, double t, int *is, int *it);
+
+/* Evaluate the interpolant at n points */
+void bicubic_interp_eval_n(
+    const bicubic_interp *interp, int n,
+    const double *s, const double *t, double *result);
+
 #endif /* !defined(SWIG) && !defined(__cplusplus) */
 
 #endif /* CUBIC_INTEPR_H */
@@ -17,6 +17,8 @@
  * MA  02110-1301  USA
  */
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include "bayestar_cosmology.h"
 #include "omp_interruptible.h"
 
@@ -264,41 +266,172 @@ double log_radial_integral(double r1, double r2, double p, double b, int k,
 }
 
 
-log_radial_integrator *log_radial_integrator_init(double r1, double r2, int k, int cosmology,
-                                                  double pmax, size_t size, int gaussian)
+/* Width, in cells of region0, of the tiles computed on demand */
+#define LOG_RADIAL_INTEGRATOR_TILE 32
+
+/* Number of matches handled per pass of log_radial_integrator_eval_n() */
+#define LOG_RADIAL_INTEGRATOR_BLOCK 256
+
+static const char log_radial_integrator_magic[8] = {'L', 'A', 'L', 'D', 'M', 'A', 'R', 'G'};
+
+
+/* Allocate an integrator and lay out its grid, without computing anything */
+static log_radial_integrator *log_radial_integrator_alloc(
+    double r1, double r2, int k, int cosmology, double pmax, size_t size,
+    int gaussian)
 {
-    log_radial_integrator *integrator = NULL;
-    bicubic_interp *region0 = NULL;
-    cubic_interp *region1 = NULL, *region2 = NULL;
     const double alpha = 4;
     const double p0 = 0.5 * (k >= 0 ? r2 : r1);
     const double xmax = log(pmax);
     const double x0 = GSL_MIN_DBL(log(p0), xmax);
     const double xmin = x0 - (1 + M_SQRT2) * alpha;
-    const double ymax = x0 + alpha;
-    const double ymin = 2 * x0 - M_SQRT2 * alpha - xmax;
-    const double d = (xmax - xmin) / (size - 1); /* dx = dy = du */
+    const size_t side = (size + 6 + LOG_RADIAL_INTEGRATOR_TILE - 1) / LOG_RADIAL_INTEGRATOR_TILE;
+    log_radial_integrator *integrator = calloc(1, sizeof(*integrator));
+    if (!integrator)
+        return NULL;
+
+    integrator->xmax = xmax;
+    integrator->ymax = x0 + alpha;
+    integrator->vmax = x0 - M_SQRT1_2 * alpha;
+    integrator->r1 = r1;
+    integrator->r2 = r2;
+    integrator->k = k;
+    integrator->size = size;
+    integrator->ntiles = side * side;
+    integrator->xmin = xmin;
+    integrator->ymin = 2 * x0 - M_SQRT2 * alpha - xmax;
+    integrator->d = (xmax - xmin) / (size - 1); /* dx = dy = du */
+    integrator->pmax = pmax;
+    integrator->cosmology = cosmology;
+    integrator->gaussian = gaussian;
+
+    integrator->z0 = calloc(size * size, sizeof(*integrator->z0));
+    integrator->z0_done = calloc(size * size, sizeof(*integrator->z0_done));
+    integrator->tile_done = calloc(integrator->ntiles, sizeof(*integrator->tile_done));
+    integrator->region0 = bicubic_interp_alloc(size, size,
+        integrator->xmin, integrator->ymin, integrator->d, integrator->d);
+    if (!(integrator->z0 && integrator->z0_done && integrator->tile_done && integrator->region0))
+    {
+        log_radial_integrator_free(integrator);
+        return NULL;
+    }
+
+    if(cosmology) dVC_dVL_init();
+
+    return integrator;
+}
+
+
+/* Compute sample (ix, iy) of the lookup table */
+static void log_radial_integrator_point(const log_radial_integrator *integrator, size_t ix, size_t iy)
+{
+    const size_t size = integrator->size;
+    const double x = integrator->xmin + ix * integrator->d;
+    const double y = integrator->ymin + iy * integrator->d;
+    const double p = exp(x);
+    const double r0 = exp(y);
+    const double b = 2 * gsl_pow_2(p) / r0;
+    /* Note: using this where p > r0; could reduce evaluations by half */
+    integrator->z0[ix*size + iy] = log_radial_integral(integrator->r1, integrator->r2, p, b,
+        integrator->k, integrator->cosmology, integrator->gaussian);
+    integrator->z0_done[ix*size + iy] = 1;
+}
+
+
+/* Build the 1D interpolants along the edges of the table, which must be computed */
+static int log_radial_integrator_edges(log_radial_integrator *integrator)
+{
+    const size_t size = integrator->size;
+    const double alpha = 4;
     const double umin = - (1 + M_SQRT1_2) * alpha;
-    const double vmax = x0 - M_SQRT1_2 * alpha;
-    
     double *z1=calloc(size,sizeof(*z1));
     double *z2=calloc(size,sizeof(*z2));
-    double *z0=calloc(size*size,sizeof(*z0));
-    XLAL_CHECK_ABORT(z0 && z1 && z2);
-    /*
-    for (size_t i=0;i<size;i++)
+    if (z1 && z2)
     {
-        z0[i]=calloc(size,sizeof(*z0[i]));
-        XLAL_CHECK_ABORT(z0[i]);
+        for (size_t i = 0; i < size; i ++)
+            z1[i] = integrator->z0[i*size + (size - 1)];
+        integrator->region1 = cubic_interp_init(z1, size, integrator->xmin, integrator->d);
+
+        for (size_t i = 0; i < size; i ++)
+            z2[i] = integrator->z0[i*size + (size - 1 - i)];
+        integrator->region2 = cubic_interp_init(z2, size, umin, integrator->d);
     }
-    */
-    /* const double umax = xmax - vmax; */ /* unused */
+    free(z2); free(z1);
+    return (integrator->region1 && integrator->region2) ? 0 : -1;
+}
+
+
+/* Compute the samples needed by one tile of region0, and its coefficients */
+static void log_radial_integrator_fill_tile(const log_radial_integrator *integrator, size_t tile)
+{
+    const int size = integrator->size;
+    const int length = size + 6;
+    const size_t side = (length + LOG_RADIAL_INTEGRATOR_TILE - 1) / LOG_RADIAL_INTEGRATOR_TILE;
+    const int is0 = (tile / side) * LOG_RADIAL_INTEGRATOR_TILE;
+    const int it0 = (tile % side) * LOG_RADIAL_INTEGRATOR_TILE;
+    const int is1 = GSL_MIN_INT(is0 + LOG_RADIAL_INTEGRATOR_TILE, length);
+    const int it1 = GSL_MIN_INT(it0 + LOG_RADIAL_INTEGRATOR_TILE, length);
+
+    /* Cell i of the interpolant depends on samples i - 4 to i - 1 */
+    const int ks0 = GSL_MAX_INT(is0 - 4, 0), ks1 = GSL_MIN_INT(is1 - 2, size - 1);
+    const int kt0 = GSL_MAX_INT(it0 - 4, 0), kt1 = GSL_MIN_INT(it1 - 2, size - 1);
+
+    gsl_error_handler_t *old_handler = gsl_set_error_handler_off();
+    for (int ks = ks0; ks <= ks1; ks ++)
+        for (int kt = kt0; kt <= kt1; kt ++)
+            if (!integrator->z0_done[ks*size + kt])
+                log_radial_integrator_point(integrator, ks, kt);
+    gsl_set_error_handler(old_handler);
+
+    bicubic_interp_init_block(integrator->region0, integrator->z0, size, size,
+                              is0, is1, it0, it1);
+}
+
+
+/* Make sure the coefficients used to evaluate region0 at (x, y) are ready.
+ * The integrator is logically const: only the tables behind its pointers
+ * are filled in.  A tile's flag is written after its coefficients and read
+ * before they are used with seq_cst atomics, which flush like a release and
+ * an acquire, so threads that see the flag also see the coefficients. */
+static void log_radial_integrator_need(const log_radial_integrator *integrator, double x, double y)
+{
+    const size_t side = (integrator->size + 6 + LOG_RADIAL_INTEGRATOR_TILE - 1) / LOG_RADIAL_INTEGRATOR_TILE;
+    unsigned char done;
+    int is, it;
+
+    if (isnan(x) || isnan(y))
+        return;
+
+    bicubic_interp_cell(integrator->region0, x, y, &is, &it);
+    const size_t tile = (is / LOG_RADIAL_INTEGRATOR_TILE) * side + it / LOG_RADIAL_INTEGRATOR_TILE;
+
+    #pragma omp atomic read seq_cst
+    done = integrator->tile_done[tile];
+
+    if (!done)
+    {
+        #pragma omp critical (log_radial_integrator_tile)
+        {
+            if (!integrator->tile_done[tile])
+            {
+                log_radial_integrator_fill_tile(integrator, tile);
+                #pragma omp atomic write seq_cst
+                integrator->tile_done[tile] = 1;
+            }
+        }
+    }
+}
+
+
+log_radial_integrator *log_radial_integrator_init(double r1, double r2, int k, int cosmology,
+                                                  double pmax, size_t size, int gaussian)
+{
+    log_radial_integrator *integrator = log_radial_integrator_alloc(r1, r2, k, cosmology, pmax, size, gaussian);
+    if (!integrator)
+        XLAL_ERROR_NULL(XLAL_ENOMEM, "not enough memory to allocate integrator");
 
-    if(cosmology) dVC_dVL_init();
-    
     int interrupted=0;
     OMP_BEGIN_INTERRUPTIBLE
-    integrator = malloc(sizeof(*integrator));
     /* Temporarily turn off gsl_error handler which isn't thread safe. */
     gsl_error_handler_t *old_handler = gsl_set_error_handler_off();
 
@@ -309,58 +442,131 @@ log_radial_integrator *log_radial_integrator_init(double r1, double r2, int k, i
         if (OMP_WAS_INTERRUPTED)
             OMP_EXIT_LOOP_EARLY;
 
-        const size_t ix = i / size;
-        const size_t iy = i % size;
-        const double x = xmin + ix * d;
-        const double y = ymin + iy * d;
-        const double p = exp(x);
-        const double r0 = exp(y);
-        const double b = 2 * gsl_pow_2(p) / r0;
-        /* Note: using this where p > r0; could reduce evaluations by half */
-        z0[ix*size + iy] = log_radial_integral(r1, r2, p, b, k, cosmology, gaussian);
+        log_radial_integrator_point(integrator, i / size, i % size);
     }
     gsl_set_error_handler(old_handler);
-    
-	if (OMP_WAS_INTERRUPTED)
-        goto done;
 
-    region0 = bicubic_interp_init(z0, size, size, xmin, ymin, d, d);
+    interrupted = OMP_WAS_INTERRUPTED;
+    OMP_END_INTERRUPTIBLE
 
-    for (size_t i = 0; i < size; i ++)
-        z1[i] = z0[i*size + (size - 1)];
-    region1 = cubic_interp_init(z1, size, xmin, d);
+    if (interrupted || log_radial_integrator_edges(integrator))
+    {
+        log_radial_integrator_free(integrator);
+        XLAL_ERROR_NULL(XLAL_ENOMEM, "not enough memory to allocate integrator");
+    }
 
-    for (size_t i = 0; i < size; i ++)
-        z2[i] = z0[i*size + (size - 1 - i)];
-    region2 = cubic_interp_init(z2, size, umin, d);
+    bicubic_interp_init_block(integrator->region0, integrator->z0, size, size,
+                              0, size + 6, 0, size + 6);
+    memset(integrator->tile_done, 1, integrator->ntiles);
+    return integrator;
+}
 
-done:
-    interrupted = OMP_WAS_INTERRUPTED;
-    OMP_END_INTERRUPTIBLE
-    
-    free(z2); free(z1); free(z0);
-    if (interrupted || !(integrator && region0 && region1 && region2))
+
+log_radial_integrator *log_radial_integrator_init_lazy(double r1, double r2, int k, int cosmology,
+                                                       double pmax, size_t size, int gaussian)
+{
+    log_radial_integrator *integrator = log_radial_integrator_alloc(r1, r2, k, cosmology, pmax, size, gaussian);
+    if (!integrator)
+        XLAL_ERROR_NULL(XLAL_ENOMEM, "not enough memory to allocate integrator");
+
+    /* Only the last column and the anti-diagonal are needed up front */
+    gsl_error_handler_t *old_handler = gsl_set_error_handler_off();
+    #pragma omp parallel for
+    for (size_t i = 0; i < 2 * size; i ++)
+    {
+        if (i < size)
+            log_radial_integrator_point(integrator, i, size - 1);
+        else if (i != size) /* sample (0, size - 1) is on the last column */
+            log_radial_integrator_point(integrator, i - size, 2 * size - 1 - i);
+    }
+    gsl_set_error_handler(old_handler);
+
+    if (log_radial_integrator_edges(integrator))
     {
-        free(integrator);
-        free(region0);
-        free(region1);
-        free(region2);
+        log_radial_integrator_free(integrator);
         XLAL_ERROR_NULL(XLAL_ENOMEM, "not enough memory to allocate integrator");
     }
 
-    integrator->region0 = region0;
-    integrator->region1 = region1;
-    integrator->region2 = region2;
-    integrator->xmax = xmax;
-    integrator->ymax = ymax;
-    integrator->vmax = vmax;
-    integrator->r1 = r1;
-    integrator->r2 = r2;
-    integrator->k = k;
     return integrator;
 }
 
 
+log_radial_integrator *log_radial_integrator_load(const char *filename, double r1, double r2, int k, int cosmology,
+                                                  double pmax, size_t size, int gaussian)
+{
+    char magic[sizeof(log_radial_integrator_magic)];
+    double header_dbl[3];
+    int header_int[3];
+    uint64_t header_size;
+    log_radial_integrator *integrator = NULL;
+
+    FILE *fp = fopen(filename, "rb");
+    if (!fp)
+        return NULL;
+
+    if (fread(magic, sizeof(magic), 1, fp) != 1
+        || fread(header_dbl, sizeof(header_dbl), 1, fp) != 1
+        || fread(header_int, sizeof(header_int), 1, fp) != 1
+        || fread(&header_size, sizeof(header_size), 1, fp) != 1
+        || memcmp(magic, log_radial_integrator_magic, sizeof(magic))
+        || header_dbl[0] != r1 || header_dbl[1] != r2 || header_dbl[2] != pmax
+        || header_int[0] != k || header_int[1] != cosmology || header_int[2] != gaussian
+        || header_size != size)
+    {
+        XLAL_PRINT_WARNING("Distance integration lookup table %s does not match this run", filename);
+        goto done;
+    }
+
+    integrator = log_radial_integrator_alloc(r1, r2, k, cosmology, pmax, size, gaussian);
+    if (!integrator)
+        goto done;
+
+    if (fread(integrator->z0, sizeof(*integrator->z0), size * size, fp) != size * size
+        || log_radial_integrator_edges(integrator))
+    {
+        XLAL_PRINT_WARNING("Could not read distance integration lookup table %s", filename);
+        log_radial_integrator_free(integrator);
+        integrator = NULL;
+        goto done;
+    }
+
+    /* All of the samples are known, but region0 is still only filled in
+     * when needed, which is cheap without any integrals to do */
+    memset(integrator->z0_done, 1, size * size);
+
+done:
+    fclose(fp);
+    return integrator;
+}
+
+
+int log_radial_integrator_save(const log_radial_integrator *integrator, const char *filename)
+{
+    const size_t size = integrator->size;
+    const double header_dbl[3] = {integrator->r1, integrator->r2, integrator->pmax};
+    const int header_int[3] = {integrator->k, integrator->cosmology, integrator->gaussian};
+    const uint64_t header_size = size;
+
+    if (memchr(integrator->z0_done, 0, size * size))
+        XLAL_ERROR(XLAL_EINVAL, "Distance integration lookup table is not complete");
+
+    FILE *fp = fopen(filename, "wb");
+    if (!fp)
+        XLAL_ERROR(XLAL_EIO, "Could not open %s for writing", filename);
+
+    int ok = fwrite(log_radial_integrator_magic, sizeof(log_radial_integrator_magic), 1, fp) == 1
+        && fwrite(header_dbl, sizeof(header_dbl), 1, fp) == 1
+        && fwrite(header_int, sizeof(header_int), 1, fp) == 1
+        && fwrite(&header_size, sizeof(header_size), 1, fp) == 1
+        && fwrite(integrator->z0, sizeof(*integrator->z0), size * size, fp) == size * size;
+    ok = (fclose(fp) == 0) && ok;
+
+    if (!ok)
+        XLAL_ERROR(XLAL_EIO, "Could not write %s", filename);
+    return XLAL_SUCCESS;
+}
+
+
 void log_radial_integrator_free(log_radial_integrator *integrator)
 {
     if (integrator)
@@ -371,6 +577,9 @@ void log_radial_integrator_free(log_radial_integrator *integrator)
         integrator->region1 = NULL;
         cubic_interp_free(integrator->region2);
         integrator->region2 = NULL;
+        free(integrator->z0);
+        free(integrator->z0_done);
+        free(integrator->tile_done);
     }
     free(integrator);
 }
@@ -404,6 +613,7 @@ double log_radial_integrator_eval(const log_radial_integrator *integrator, doubl
                 const double u = 0.5 * (x - y);
                 result = cubic_interp_eval(integrator->region2, u);
             } else {
+                log_radial_integrator_need(integrator, x, y);
                 result = bicubic_interp_eval(integrator->region0, x, y);
             }
         }
@@ -414,3 +624,49 @@ double log_radial_integrator_eval(const log_radial_integrator *integrator, doubl
 }
 
 
+void log_radial_integrator_eval_n(const log_radial_integrator *integrator, double p, double log_p, size_t n, const double *b, double *result)
+{
+    const double x = log_p;
+    double s[LOG_RADIAL_INTEGRATOR_BLOCK], t[LOG_RADIAL_INTEGRATOR_BLOCK];
+    double z[LOG_RADIAL_INTEGRATOR_BLOCK], out[LOG_RADIAL_INTEGRATOR_BLOCK];
+    size_t idx[LOG_RADIAL_INTEGRATOR_BLOCK];
+
+    if (p == 0) {
+        for (size_t i = 0; i < n; i ++)
+            result[i] = log_radial_integrator_eval(integrator, p, b[i], log_p, log(b[i]));
+        return;
+    }
+    XLAL_CHECK_ABORT(x <= integrator->xmax);
+
+    for (size_t begin = 0; begin < n; begin += LOG_RADIAL_INTEGRATOR_BLOCK)
+    {
+        const size_t m = GSL_MIN(n - begin, LOG_RADIAL_INTEGRATOR_BLOCK);
+        size_t m0 = 0;
+
+        /* Handle the 1D regions directly, and gather the points in region0
+         * to be evaluated together */
+        for (size_t i = 0; i < m; i ++)
+        {
+            const double bi = b[begin + i];
+            const double y = M_LN2 + 2 * log_p - log(bi);
+            const double v = 0.5 * (x + y);
+            out[i] = gsl_pow_2(0.5 * bi / p);
+            if (y >= integrator->ymax) {
+                out[i] += cubic_interp_eval(integrator->region1, x);
+            } else if (v <= integrator->vmax) {
+                out[i] += cubic_interp_eval(integrator->region2, 0.5 * (x - y));
+            } else {
+                log_radial_integrator_need(integrator, x, y);
+                s[m0] = x;
+                t[m0] = y;
+                idx[m0++] = i;
+            }
+        }
+
+        bicubic_interp_eval_n(integrator->region0, m0, s, t, z);
+        for (size_t j = 0; j < m0; j ++)
+            out[idx[j]] += z[j];
+
+        memcpy(&result[begin], out, m * sizeof(*out));
+    }
+}
@@ -14,6 +14,13 @@ typedef struct taglog_radial_integrator {
 		cubic_interp *region2;
 		double xmax, ymax, vmax, r1, r2;
 		int k;
+		/* Samples behind region0, which may be filled in on demand */
+		double *z0;                /* size x size samples of the log integral */
+		unsigned char *z0_done;    /* Which samples of z0 have been computed */
+		unsigned char *tile_done;  /* Which tiles of region0 have coefficients */
+		size_t size, ntiles;
+		double xmin, ymin, d, pmax;
+		int cosmology, gaussian;
 } log_radial_integrator;
 
 typedef struct tagradial_integrand_params {
@@ -43,6 +50,26 @@ double log_radial_integral(double r1, double r2, double p, double b, int k,
  */
 log_radial_integrator *log_radial_integrator_init(double r1, double r2, int k, int cosmology, double pmax, size_t size, int gaussian);
 
+/**
+ * Distance integrator for marginalisation, filled in on demand.
+ * Takes the same arguments as log_radial_integrator_init(), but only the
+ * edges of the lookup table are computed up front.  The rest is computed a
+ * tile at a time, the first time log_radial_integrator_eval() needs it.
+ */
+log_radial_integrator *log_radial_integrator_init_lazy(double r1, double r2, int k, int cosmology, double pmax, size_t size, int gaussian);
+
+/**
+ * Read a lookup table saved by log_radial_integrator_save().
+ * Returns NULL if the file can't be read or was made with different arguments.
+ */
+log_radial_integrator *log_radial_integrator_load(const char *filename, double r1, double r2, int k, int cosmology, double pmax, size_t size, int gaussian);
+
+/**
+ * Save the lookup table of a fully computed integrator to a file.
+ * The file is in native byte order, and is meant as a cache for later runs on similar machines.
+ */
+int log_radial_integrator_save(const log_radial_integrator *integrator, const char *filename);
+
 /**
  * Free an integrator
  */
@@ -60,6 +87,19 @@ void log_radial_integrator_free(log_radial_integrator *integrator);
  */
 double log_radial_integrator_eval(const log_radial_integrator *integrator, double p, double b, double log_p, double log_b);
 
+/**
+ * Evaluate the log distance integrator for one optimal SNR and n matches.
+ * Equivalent to calling log_radial_integrator_eval() for each element of
+ * \f$ b \f$, but faster.  \f$ b \f$ and result may point to the same array.
+ * @param integrator a log_radial_integrator
+ * @param p The optimal SNR \f$ p = sqrt(<h|h>) \f$
+ * @param log_p log(p)
+ * @param n Number of matches
+ * @param b n matches \f$ b = <h|d> \f$
+ * @param result n log integrals
+ */
+void log_radial_integrator_eval_n(const log_radial_integrator *integrator, double p, double log_p, size_t n, const double *b, double *result);
+
 #endif /* !defined(SWIG) && !defined(__cplusplus) */
 
 #endif /* DISTANCE_INTEGRATOR_H */
@@ -1,10 +1,12 @@
 #include <lal/LALInferenceGenerateROQ.h>
 #include <lal/LALConstants.h>
 #include <lal/XLALGSL.h>
+#include <lal/FrequencySeries.h>
 #include <gsl/gsl_randist.h>
 
 #include <time.h>
 #include <math.h>
+#include <string.h>
 
 /* check whether to include omp.h for use of multiple cores */
 #ifdef HAVE_OPENMP
@@ -22,6 +24,9 @@
 /* tolerance allow for fractional percentage log likelihood difference */
 #define LTOL 0.1
 
+/* tolerance for the fractional difference of the weights made from detector data */
+#define WTOL 1e-12
+
 /* simple inspiral phase model */
 double calc_phase(double frequency, double Mchirp);
 
@@ -43,9 +48,177 @@ COMPLEX16 imag_model(double frequency, double Mchirp, double modperiod){
   return ( pow(frequency, -7./6.) * pow(Mchirp*LAL_MTSUN_SI,5./6.) * cexp(I*calc_phase(frequency,Mchirp)) )*sin(LAL_TWOPI*frequency/modperiod);
 }
 
+/* Check the weights made from a data frequency series and PSD (at a time shift of zero) against
+ * those made from the same data and PSD (as variances) over the interpolant points */
+int test_weights_from_data(LALInferenceCOMPLEXROQInterpolant *cinterp, LALInferenceREALROQInterpolant *interpQuad, gsl_rng *r);
+
+int test_weights_from_data(LALInferenceCOMPLEXROQInterpolant *cinterp, LALInferenceREALROQInterpolant *interpQuad, gsl_rng *r){
+  size_t wl = cinterp->B->dimLength->data[1], kmin = 80, i = 0;
+  REAL8 deltaF = 0.25, fmin = kmin*deltaF, maxw = 0., maxdiff = 0.;
+  LIGOTimeGPS epoch = LIGOTIMEGPSZERO;
+
+  /* data and PSD extending past the interpolant frequency range */
+  COMPLEX16FrequencySeries *data = XLALCreateCOMPLEX16FrequencySeries("data", &epoch, 0., deltaF, NULL, kmin + wl + 10);
+  REAL8FrequencySeries *psd = XLALCreateREAL8FrequencySeries("psd", &epoch, 0., deltaF, NULL, kmin + wl + 10);
+  for ( i=0; i<data->data->length; i++ ){
+    data->data->data[i] = gsl_ran_gaussian(r, 1.0) + I*gsl_ran_gaussian(r, 1.0);
+    psd->data->data[i] = 1. + 0.5*sin(0.01*i);
+  }
+
+  COMPLEX16Vector *cdata = XLALCreateCOMPLEX16Vector( wl );
+  REAL8Vector *vars = XLALCreateREAL8Vector( wl );
+  for ( i=0; i<wl; i++ ){
+    cdata->data[i] = data->data->data[kmin + i];
+    vars->data[i] = psd->data->data[kmin + i];
+  }
+
+  REAL8Vector *tcs = XLALCreateREAL8Vector( 1 );
+  tcs->data[0] = 0.;
+
+  /* the linear weights are 4 deltaF times the conjugate of those from the variances */
+  COMPLEX16Vector *cdmw = LALInferenceGenerateCOMPLEX16LinearWeights(cinterp->B, cdata, vars);
+  COMPLEX16Array *cdmwdata = LALInferenceGenerateROQLinearWeightsFromData(cinterp->B, data, psd, fmin, tcs);
+  if ( cdmw == NULL || cdmwdata == NULL ) { return 1; }
+  if ( cdmwdata->dimLength->data[0] != cdmw->length || cdmwdata->dimLength->data[1] != 1 ) { return 1; }
+  for ( i=0; i<cdmw->length; i++ ){
+    COMPLEX16 expected = 4.*deltaF*conj(cdmw->data[i]);
+    maxw = fmax(maxw, cabs(expected));
+    maxdiff = fmax(maxdiff, cabs(cdmwdata->data[i] - expected));
+  }
+  fprintf(stderr, "Linear weights from data: maximum fractional difference = %le\n", maxdiff/maxw);
+  if ( maxdiff > WTOL*maxw ) { return 1; }
+
+  /* the quadratic weights are 4 deltaF times those from the variances */
+  REAL8Vector *mmw = LALInferenceGenerateQuadraticWeights(interpQuad->B, vars);
+  REAL8Vector *mmwpsd = LALInferenceGenerateROQQuadraticWeightsFromPSD(interpQuad->B, psd, fmin);
+  if ( mmw == NULL || mmwpsd == NULL ) { return 1; }
+  if ( mmwpsd->length != mmw->length ) { return 1; }
+  maxw = maxdiff = 0.;
+  for ( i=0; i<mmw->length; i++ ){
+    maxw = fmax(maxw, fabs(4.*deltaF*mmw->data[i]));
+    maxdiff = fmax(maxdiff, fabs(mmwpsd->data[i] - 4.*deltaF*mmw->data[i]));
+  }
+  fprintf(stderr, "Quadratic weights from PSD: maximum fractional difference = %le\n", maxdiff/maxw);
+  if ( maxdiff > WTOL*maxw ) { return 1; }
+
+  XLALDestroyCOMPLEX16FrequencySeries( data );
+  XLALDestroyREAL8FrequencySeries( psd );
+  XLALDestroyCOMPLEX16Vector( cdata );
+  XLALDestroyREAL8Vector( vars );
+  XLALDestroyREAL8Vector( tcs );
+  XLALDestroyCOMPLEX16Vector( cdmw );
+  XLALDestroyCOMPLEX16Array( cdmwdata );
+  XLALDestroyREAL8Vector( mmw );
+  XLALDestroyREAL8Vector( mmwpsd );
+
+  return 0;
+}
+
+/* Check that the ROQ likelihood data set up from the interpolants for a pair of detectors
+ * matches the weights made directly, that the linear weight splines pass through those weights
+ * and that the model gets the frequency nodes of the interpolants */
+int test_setup_roq_data(LALInferenceCOMPLEXROQInterpolant *cinterp, LALInferenceREALROQInterpolant *interpQuad, gsl_rng *r);
+
+int test_setup_roq_data(LALInferenceCOMPLEXROQInterpolant *cinterp, LALInferenceREALROQInterpolant *interpQuad, gsl_rng *r){
+  size_t wl = cinterp->B->dimLength->data[1], kmin = 80, ntcs = 5, i = 0, t = 0;
+  size_t nlinear = cinterp->B->dimLength->data[0], nquadratic = interpQuad->B->dimLength->data[0];
+  REAL8 deltaF = 0.25, fmin = kmin*deltaF, maxw = 0., maxdiff = 0.;
+  LIGOTimeGPS epoch = LIGOTIMEGPSZERO;
+  LALInferenceIFOData ifos[2];
+  LALInferenceModel model;
+  LALInferenceIFOData *ifo = NULL;
+
+  memset(ifos, 0, sizeof(ifos));
+  memset(&model, 0, sizeof(model));
+  ifos[0].next = &ifos[1];
+  snprintf(ifos[0].name, sizeof(ifos[0].name), "H1");
+  snprintf(ifos[1].name, sizeof(ifos[1].name), "L1");
+
+  for ( ifo = ifos; ifo != NULL; ifo = ifo->next ){
+    ifo->freqData = XLALCreateCOMPLEX16FrequencySeries("data", &epoch, 0., deltaF, NULL, kmin + wl + 10);
+    ifo->oneSidedNoisePowerSpectrum = XLALCreateREAL8FrequencySeries("psd", &epoch, 0., deltaF, NULL, kmin + wl + 10);
+    for ( i=0; i<ifo->freqData->data->length; i++ ){
+      ifo->freqData->data->data[i] = gsl_ran_gaussian(r, 1.0) + I*gsl_ran_gaussian(r, 1.0);
+      ifo->oneSidedNoisePowerSpectrum->data->data[i] = 1. + 0.5*sin(0.01*i) + gsl_ran_flat(r, 0., 0.1);
+    }
+  }
+
+  REAL8Vector *tcs = XLALCreateREAL8Vector( ntcs );
+  for ( t=0; t<ntcs; t++ ){ tcs->data[t] = -0.1 + 0.05*t; }
+
+  if ( LALInferenceSetupROQDataFromInterpolants(ifos, &model, cinterp, interpQuad, fmin, tcs) != XLAL_SUCCESS ){ return 1; }
+
+  for ( ifo = ifos; ifo != NULL; ifo = ifo->next ){
+    COMPLEX16Array *cdmw = LALInferenceGenerateROQLinearWeightsFromData(cinterp->B, ifo->freqData, ifo->oneSidedNoisePowerSpectrum, fmin, tcs);
+    REAL8Vector *mmw = LALInferenceGenerateROQQuadraticWeightsFromPSD(interpQuad->B, ifo->oneSidedNoisePowerSpectrum, fmin);
+    if ( cdmw == NULL || mmw == NULL || ifo->roq == NULL ) { return 1; }
+    if ( ifo->roq->n_time_steps != ntcs || ifo->roq->time_weights_width != tcs->data[ntcs-1] - tcs->data[0] ) { return 1; }
+
+    /* the weights, and the splines of the linear weights at the time shifts */
+    maxw = maxdiff = 0.;
+    for ( i=0; i<nlinear; i++ ){
+      for ( t=0; t<ntcs; t++ ){
+        COMPLEX16 expected = cdmw->data[i*ntcs + t];
+        COMPLEX16 splined = gsl_spline_eval(ifo->roq->weights_linear[i].spline_real_weight_linear, tcs->data[t], NULL) + I*gsl_spline_eval(ifo->roq->weights_linear[i].spline_imag_weight_linear, tcs->data[t], NULL);
+        maxw = fmax(maxw, cabs(expected));
+        maxdiff = fmax(maxdiff, cabs(ifo->roq->weightsLinear[i*ntcs + t] - expected));
+        maxdiff = fmax(maxdiff, cabs(splined - expected));
+      }
+    }
+    for ( i=0; i<nquadratic; i++ ){
+      maxw = fmax(maxw, fabs(mmw->data[i]));
+      maxdiff = fmax(maxdiff, fabs(ifo->roq->weightsQuadratic[i] - mmw->data[i]));
+    }
+    fprintf(stderr, "ROQ data for %s set up from interpolants: maximum fractional difference = %le\n", ifo->name, maxdiff/maxw);
+    if ( maxdiff > WTOL*maxw ) { return 1; }
+
+    XLALDestroyCOMPLEX16Array( cdmw );
+    XLALDestroyREAL8Vector( mmw );
+  }
+
+  /* the model frequency nodes */
+  if ( model.roq_flag != 1 || model.roq == NULL ) { return 1; }
+  if ( model.roq->frequencyNodesLinear->length != nlinear || model.roq->frequencyNodesQuadratic->length != nquadratic ) { return 1; }
+  if ( model.roq->calFactorLinear->length != nlinear || model.roq->calFactorQuadratic->length != nquadratic ) { return 1; }
+  for ( i=0; i<nlinear; i++ ){
+    if ( model.roq->frequencyNodesLinear->data[i] != (kmin + cinterp->nodes[i])*deltaF ) { return 1; }
+  }
+  for ( i=0; i<nquadratic; i++ ){
+    if ( model.roq->frequencyNodesQuadratic->data[i] != (kmin + interpQuad->nodes[i])*deltaF ) { return 1; }
+  }
+
+  /* setting the data up a second time is an error */
+  INT4 errnum = 0;
+  XLAL_TRY_SILENT( LALInferenceSetupROQDataFromInterpolants(ifos, NULL, cinterp, interpQuad, fmin, tcs), errnum );
+  if ( errnum != XLAL_EINVAL ) { return 1; }
+
+  for ( ifo = ifos; ifo != NULL; ifo = ifo->next ){
+    for ( i=0; i<nlinear; i++ ){
+      gsl_spline_free( ifo->roq->weights_linear[i].spline_real_weight_linear );
+      gsl_spline_free( ifo->roq->weights_linear[i].spline_imag_weight_linear );
+    }
+    XLALFree( ifo->roq->weights_linear );
+    XLALFree( ifo->roq->weightsLinear );
+    XLALFree( ifo->roq->weightsQuadratic );
+    XLALFree( ifo->roq );
+    XLALDestroyCOMPLEX16FrequencySeries( ifo->freqData );
+    XLALDestroyREAL8FrequencySeries( ifo->oneSidedNoisePowerSpectrum );
+  }
+  XLALDestroyREAL8Sequence( model.roq->frequencyNodesLinear );
+  XLALDestroyREAL8Sequence( model.roq->frequencyNodesQuadratic );
+  XLALDestroyCOMPLEX16Sequence( model.roq->calFactorLinear );
+  XLALDestroyCOMPLEX16Sequence( model.roq->calFactorQuadratic );
+  XLALFree( model.roq );
+  XLALDestroyREAL8Vector( tcs );
+
+  return 0;
+}
+
 int main(void) {
   REAL8Array *TS = NULL, *TSquad = NULL, *cTSquad = NULL;  /* the training set of real waveforms (and quadratic model) */
+  REAL4Array *TSsingle = NULL;             /* single precision version of the real training set */
   COMPLEX16Array *cTS = NULL;              /* the training set of complex waveforms */
+  COMPLEX8Array *cTSsingle = NULL;         /* single precision version of the complex training set */
   UINT4Vector *gdpts = NULL;               /* the greedy points used for the reduced basis generation */
 
   size_t TSsize;  /* the size of the training set (number of waveforms) */
@@ -53,7 +226,10 @@ int main(void) {
   size_t k = 0, j = 0, i = 0;
 
   REAL8Array *RBlinear = NULL, *RBquad = NULL, *cRBquad = NULL;       /* the real reduced basis set */
+  REAL8Array *RBsingle = NULL;        /* the real reduced basis set from the single precision training set */
   COMPLEX16Array *cRBlinear = NULL;   /* the complex reduced basis set */
+  COMPLEX16Array *cRBsingle = NULL;   /* the complex reduced basis set from the single precision training set */
+  REAL8Vector *projerr = NULL;        /* squared projection errors of the training set onto a basis */
 
   LALInferenceREALROQInterpolant *interp = NULL, *interpQuad = NULL, *cinterpQuad = NULL;
   LALInferenceCOMPLEXROQInterpolant *cinterp = NULL;
@@ -71,6 +247,8 @@ int main(void) {
   TSquad = XLALCreateREAL8Array( TSdims );
   cTS = XLALCreateCOMPLEX16Array( TSdims );
   cTSquad = XLALCreateREAL8Array( TSdims );
+  TSsingle = XLALCreateREAL4Array( TSdims );
+  cTSsingle = XLALCreateCOMPLEX8Array( TSdims );
 
   gsl_matrix_view TSview, TSviewquad, cTSviewquad;
   TSview = gsl_matrix_view_array( TS->data, TSdims->data[0], TSdims->data[1] );
@@ -114,8 +292,10 @@ int main(void) {
       GSL_SET_COMPLEX(&gctmp, creal(ctmp), cimag(ctmp));
       freqs->data[j] = f0;
       gsl_matrix_set(&TSview.matrix, k, j, m0);
+      TSsingle->data[k*wl + j] = (REAL4)m0;
       gsl_matrix_set(&TSviewquad.matrix, k, j, m0*m0);
       gsl_matrix_complex_set(&cTSview.matrix, k, j, gctmp);
+      cTSsingle->data[k*wl + j] = (COMPLEX8)ctmp;
       gsl_matrix_set(&cTSviewquad.matrix, k, j, creal(ctmp*conj(ctmp)));
     }
   }
@@ -125,9 +305,39 @@ int main(void) {
   maxprojerr = LALInferenceGenerateREAL8OrthonormalBasis(&RBlinear, fweights, tolerance, &TS, &gdpts);
   XLALDestroyUINT4Vector( gdpts );
   fprintf(stderr, "No. linear nodes (real) = %d, %d x %d; Maximum projection err. = %le\n", RBlinear->dimLength->data[0], RBlinear->dimLength->data[0], RBlinear->dimLength->data[1], maxprojerr);
+  maxprojerr = LALInferenceGenerateREAL8OrthonormalBasisFromREAL4(&RBsingle, fweights, tolerance, &TSsingle, &gdpts);
+  XLALDestroyUINT4Vector( gdpts );
+  fprintf(stderr, "No. linear nodes (real, single precision training set) = %d, %d x %d; Maximum projection err. = %le\n", RBsingle->dimLength->data[0], RBsingle->dimLength->data[0], RBsingle->dimLength->data[1], maxprojerr);
+
+  /* the basis from the single precision training set should still represent the double precision
+   * training set (already normalised by the basis generation) to within the tolerance */
+  LALInferenceValidateREAL8OrthonormalBasis(&projerr, fweights, RBsingle, &TS);
+  if ( projerr == NULL ) { return 1; }
+  maxprojerr = 0.;
+  for ( k=0; k < projerr->length; k++ ){ maxprojerr = fmax(maxprojerr, projerr->data[k]); }
+  fprintf(stderr, " - Maximum projection err. of the double precision training set = %le\n", maxprojerr);
+  if ( maxprojerr > tolerance ) { return 1; }
+  XLALDestroyREAL8Vector( projerr );
+  XLALDestroyREAL8Array( RBsingle );
+  XLALDestroyREAL4Array( TSsingle );
+
   maxprojerr = LALInferenceGenerateCOMPLEX16OrthonormalBasis(&cRBlinear, fweights, tolerance, &cTS, &gdpts);
   XLALDestroyUINT4Vector( gdpts );
   fprintf(stderr, "No. linear nodes (complex) = %d, %d x %d; Maximum projection err. = %le\n", cRBlinear->dimLength->data[0], cRBlinear->dimLength->data[0], cRBlinear->dimLength->data[1], maxprojerr);
+  maxprojerr = LALInferenceGenerateCOMPLEX16OrthonormalBasisFromCOMPLEX8(&cRBsingle, fweights, tolerance, &cTSsingle, &gdpts);
+  XLALDestroyUINT4Vector( gdpts );
+  fprintf(stderr, "No. linear nodes (complex, single precision training set) = %d, %d x %d; Maximum projection err. = %le\n", cRBsingle->dimLength->data[0], cRBsingle->dimLength->data[0], cRBsingle->dimLength->data[1], maxprojerr);
+
+  LALInferenceValidateCOMPLEX16OrthonormalBasis(&projerr, fweights, cRBsingle, &cTS);
+  if ( projerr == NULL ) { return 1; }
+  maxprojerr = 0.;
+  for ( k=0; k < projerr->length; k++ ){ maxprojerr = fmax(maxprojerr, projerr->data[k]); }
+  fprintf(stderr, " - Maximum projection err. of the double precision training set = %le\n", maxprojerr);
+  if ( maxprojerr > tolerance ) { return 1; }
+  XLALDestroyREAL8Vector( projerr );
+  XLALDestroyCOMPLEX16Array( cRBsingle );
+  XLALDestroyCOMPLEX8Array( cTSsingle );
+
   maxprojerr = LALInferenceGenerateREAL8OrthonormalBasis(&RBquad, fweights, tolerance, &TSquad, &gdpts);
   XLALDestroyUINT4Vector( gdpts );
   fprintf(stderr, "No. quadratic nodes (real)  = %d, %d x %d; Maximum projection err. = %le\n", RBquad->dimLength->data[0], RBquad->dimLength->data[0], RBquad->dimLength->data[1], maxprojerr);
@@ -323,6 +533,11 @@ int main(void) {
   XLALDestroyREAL8Vector(cmmw);
   XLALDestroyCOMPLEX16Vector(cdmw);
 
+  /* check the weights made directly from detector data */
+  if ( test_weights_from_data(cinterp, cinterpQuad, r) ) { return 1; }
+  if ( test_setup_roq_data(cinterp, cinterpQuad, r) ) { return 1; }
+  gsl_rng_free( r );
+
   LALInferenceRemoveREALROQInterpolant( interp );
   LALInferenceRemoveCOMPLEXROQInterpolant( cinterp );
   LALInferenceRemoveREALROQInterpolant( interpQuad );
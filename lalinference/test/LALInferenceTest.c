@@ -21,6 +21,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 #include <lal/LALInference.h>
 #include <lal/Units.h>
 #include <lal/FrequencySeries.h>
@@ -37,9 +38,16 @@
 #include <lal/LALInferenceLikelihood.h>
 #include <lal/LALInferenceTemplate.h>
 #include <lal/LALInferencePrior.h>
+#include <lal/LALInferenceProposal.h>
+#include <lal/LALInferenceKDE.h>
+#include <lal/LALInferenceClusteredKDE.h>
 
 #include "LALInferenceTest.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifdef __GNUC__
 #define UNUSED __attribute__ ((unused))
 #else
@@ -59,6 +67,19 @@ int LALInferenceProcessParamLine_TEST_CHARFILE(void);
 /*  LALInferenceExecuteFT tests */
 int LALInferenceExecuteFTTEST_NULLPLAN(void);
 
+/*  LALInferenceCompileVariables tests */
+int LALInferenceCompileVariables_TEST(void);
+
+/*  LALInferenceSplineCalibrationBasis tests */
+int LALInferenceSplineCalibrationBasis_TEST(void);
+
+/*  LALInferenceDEBuffer tests */
+int LALInferenceDEBufferProposal_TEST(void);
+
+/*  LALInferenceKDE and LALInferenceKmeans tests */
+int LALInferenceKDETree_TEST(void);
+int LALInferenceKmeansSeeded_TEST(void);
+
 int main(void){
     
 	int failureCount = 0;
@@ -77,6 +98,16 @@ int main(void){
 	printf("\n");
 	failureCount += LALInferenceExecuteFTTEST_NULLPLAN();
 	printf("\n");
+	failureCount += LALInferenceCompileVariables_TEST();
+	printf("\n");
+	failureCount += LALInferenceSplineCalibrationBasis_TEST();
+	printf("\n");
+	failureCount += LALInferenceDEBufferProposal_TEST();
+	printf("\n");
+	failureCount += LALInferenceKDETree_TEST();
+	printf("\n");
+	failureCount += LALInferenceKmeansSeeded_TEST();
+	printf("\n");
 	printf("Test results: %i failure(s).\n", failureCount);
 
 	return failureCount;
@@ -357,6 +388,392 @@ int LALInferenceExecuteFTTEST_NULLPLAN(void){
 }
 
 
+/*****************     TEST CODE for LALInferenceCompileVariables     *****************/
+
+/* this function checks that compiled variables agree between the name and slot accessors,
+   and that copies and removals keep them consistent. Expect pass. */
+int LALInferenceCompileVariables_TEST(void){
+    TEST_HEADER();
+    LALInferenceVariables vars, copy;
+    INT4 slot, fixedSlot;
+    INT4 small = 3;
+
+    memset(&vars, 0, sizeof(vars));
+    memset(&copy, 0, sizeof(copy));
+
+    LALInferenceAddREAL8Variable(&vars, "mass1", 1.4, LALINFERENCE_PARAM_LINEAR);
+    LALInferenceAddINT4Variable(&vars, "small", small, LALINFERENCE_PARAM_FIXED);
+    LALInferenceAddREAL8Variable(&vars, "distance", 100.0, LALINFERENCE_PARAM_LINEAR);
+    LALInferenceAddREAL8Variable(&vars, "phase", 0.5, LALINFERENCE_PARAM_FIXED);
+
+    if (LALInferenceCompileVariables(&vars) != XLAL_SUCCESS || vars.nslots != 3)
+        TEST_FAIL("Expected three compiled slots, got %i.", vars.nslots);
+
+    slot = LALInferenceGetVariableSlot(&vars, "distance");
+    fixedSlot = LALInferenceGetVariableSlot(&vars, "phase");
+    if (slot < 0 || fixedSlot < 0 || LALInferenceGetVariableSlot(&vars, "small") != -1)
+        TEST_FAIL("Unexpected slots: distance %i, phase %i.", slot, fixedSlot);
+
+    LALInferenceSetREAL8VariableBySlot(&vars, slot, 200.0);
+    if (LALInferenceGetREAL8Variable(&vars, "distance") != 200.0)
+        TEST_FAIL("Slot write not seen by the name accessor.");
+    LALInferenceSetREAL8Variable(&vars, "distance", 300.0);
+    if (LALInferenceGetREAL8VariableBySlot(&vars, slot) != 300.0)
+        TEST_FAIL("Name write not seen by the slot accessor.");
+    LALInferenceSetREAL8VariableBySlot(&vars, fixedSlot, 1.0);
+    if (LALInferenceGetREAL8VariableBySlot(&vars, fixedSlot) != 0.5)
+        TEST_FAIL("Fixed variable was changed through its slot.");
+
+    /* The first copy builds a compiled target, the second one is done in place */
+    LALInferenceCopyVariables(&vars, &copy);
+    if (!copy.compiled || LALInferenceGetVariableSlot(&copy, "distance") != slot)
+        TEST_FAIL("Copy did not keep the compiled layout.");
+    LALInferenceSetREAL8VariableBySlot(&vars, slot, 400.0);
+    LALInferenceCopyVariables(&vars, &copy);
+    if (LALInferenceGetREAL8VariableBySlot(&copy, slot) != 400.0 || LALInferenceCompareVariables(&vars, &copy))
+        TEST_FAIL("In-place copy does not match the origin.");
+
+    LALInferenceRemoveVariable(&vars, "distance");
+    if (LALInferenceCheckVariable(&vars, "distance") || LALInferenceGetVariableSlot(&vars, "mass1") < 0)
+        TEST_FAIL("Removing a compiled variable broke the others.");
+    if (LALInferenceGetREAL8Variable(&vars, "mass1") != 1.4)
+        TEST_FAIL("Wrong mass1 after removal.");
+
+    LALInferenceClearVariables(&vars);
+    LALInferenceClearVariables(&copy);
+    if (vars.compiled || copy.compiled)
+        TEST_FAIL("Clearing did not release the compiled storage.");
+
+    TEST_FOOTER();
+}
+
+/*****************     TEST CODE for LALInferenceSplineCalibrationBasis     *****************/
+
+/* The precomputed basis must reproduce LALInferenceSplineCalibrationFactor(), including the bins outside the nodes. Expect pass. */
+int LALInferenceSplineCalibrationBasis_TEST(void){
+    TEST_HEADER();
+    const UINT4 nNodes = 8;
+    const REAL8 deltaF = 0.25;
+    const REAL8 fMin = 20.0, fMax = 512.0;
+    LIGOTimeGPS epoch = {0, 0};
+    UINT4 i, first, last;
+    REAL8 maxErr = 0.0;
+
+    REAL8Vector *logfreqs = XLALCreateREAL8Vector(nNodes);
+    REAL8Vector *amps = XLALCreateREAL8Vector(nNodes);
+    REAL8Vector *phases = XLALCreateREAL8Vector(nNodes);
+    for (i = 0; i < nNodes; i++) {
+        logfreqs->data[i] = log(fMin) + i*(log(fMax) - log(fMin))/(nNodes - 1);
+        amps->data[i] = 0.1*sin(1.3*i);
+        phases->data[i] = 0.05*cos(2.1*i + 0.3);
+    }
+    first = (UINT4)(0.5*fMin/deltaF);
+    last = (UINT4)(1.5*fMax/deltaF);
+
+    COMPLEX16FrequencySeries *reference = XLALCreateCOMPLEX16FrequencySeries("reference", &epoch, 0.0, deltaF, &lalDimensionlessUnit, last + 1);
+    COMPLEX16FrequencySeries *fromBasis = XLALCreateCOMPLEX16FrequencySeries("from basis", &epoch, 0.0, deltaF, &lalDimensionlessUnit, last + 1);
+    LALInferenceSplineCalibrationFactor(logfreqs, amps, phases, reference);
+
+    LALInferenceSplineCalibrationBasis *basis = LALInferenceCreateSplineCalibrationBasis(logfreqs, deltaF, first, last);
+    if (basis == NULL)
+        TEST_FAIL("Could not build the spline calibration basis.");
+    if (!LALInferenceSplineCalibrationBasisMatches(basis, logfreqs, deltaF, first, last) || LALInferenceSplineCalibrationBasisMatches(basis, logfreqs, deltaF, first + 1, last))
+        TEST_FAIL("Basis does not match the nodes and bins it was built for.");
+    if (LALInferenceSplineCalibrationBasisMatches(basis, logfreqs, 2.0*deltaF, first, last))
+        TEST_FAIL("Basis matches bins of a different frequency spacing.");
+
+    if (LALInferenceSplineCalibrationFactorFromBasis(basis, amps, phases, fromBasis) != XLAL_SUCCESS)
+        TEST_FAIL("Could not evaluate the calibration factors from the basis.");
+    for (i = first; i <= last; i++) {
+        REAL8 err = cabs(fromBasis->data->data[i] - reference->data->data[i]);
+        if (err > maxErr) maxErr = err;
+    }
+    if (maxErr > 1e-12)
+        TEST_FAIL("Calibration factors differ from LALInferenceSplineCalibrationFactor by %g.", maxErr);
+
+    LALInferenceDestroySplineCalibrationBasis(basis);
+    XLALDestroyCOMPLEX16FrequencySeries(reference);
+    XLALDestroyCOMPLEX16FrequencySeries(fromBasis);
+    XLALDestroyREAL8Vector(logfreqs);
+    XLALDestroyREAL8Vector(amps);
+    XLALDestroyREAL8Vector(phases);
+
+    TEST_FOOTER();
+}
+
+
+/*****************     TEST CODE for LALInferenceDEBuffer     *****************/
+
+/* Runs the differential evolution and ensemble proposals from the same random
+   numbers with and without the matrix copy of the differential evolution
+   buffer, and returns the number of jumps that differ. */
+static int compareDEBufferProposals(LALInferenceThreadState *thread, unsigned long int seed)
+{
+    typedef REAL8 (*DEProposal)(LALInferenceThreadState *, LALInferenceVariables *, LALInferenceVariables *, const char **);
+    const DEProposal proposals[] = {LALInferenceDifferentialEvolutionNames, LALInferenceEnsembleStretchNames, LALInferenceEnsembleWalkNames};
+    const char *proposalNames[] = {"DifferentialEvolutionNames", "EnsembleStretchNames", "EnsembleWalkNames"};
+    const char *someNames[] = {"chirpmass", "phase", "distance", NULL};
+    const char **namesList[] = {NULL, someNames};
+    LALInferenceDEBuffer *buffer = thread->deBuffer;
+    LALInferenceVariables withMatrix, withoutMatrix;
+    LALInferenceVariableItem *item;
+    REAL8 logPropWith, logPropWithout;
+    UINT4 k, p, trial;
+    int errors = 0;
+
+    memset(&withMatrix, 0, sizeof(withMatrix));
+    memset(&withoutMatrix, 0, sizeof(withoutMatrix));
+    for (p = 0; p < sizeof(proposals)/sizeof(*proposals); p++)
+        for (k = 0; k < sizeof(namesList)/sizeof(*namesList); k++)
+            for (trial = 0; trial < 20; trial++) {
+                thread->deBuffer = buffer;
+                gsl_rng_set(thread->GSLrandom, seed + trial);
+                logPropWith = proposals[p](thread, thread->currentParams, &withMatrix, namesList[k]);
+
+                thread->deBuffer = NULL;
+                gsl_rng_set(thread->GSLrandom, seed + trial);
+                logPropWithout = proposals[p](thread, thread->currentParams, &withoutMatrix, namesList[k]);
+
+                if (logPropWith != logPropWithout) {
+                    fprintf(stderr, "%s: log proposal ratio %g with the matrix, %g without\n", proposalNames[p], logPropWith, logPropWithout);
+                    errors++;
+                }
+                for (item = withoutMatrix.head; item; item = item->next) {
+                    REAL8 a, b;
+                    if (item->type != LALINFERENCE_REAL8_t)
+                        continue;
+                    a = LALInferenceGetREAL8Variable(&withMatrix, item->name);
+                    b = *(REAL8 *)item->value;
+                    if (fabs(a - b) > 1e-12*fabs(b)) {
+                        fprintf(stderr, "%s: %s = %.16g with the matrix, %.16g without\n", proposalNames[p], item->name, a, b);
+                        errors++;
+                    }
+                }
+            }
+    thread->deBuffer = buffer;
+
+    LALInferenceClearVariables(&withMatrix);
+    LALInferenceClearVariables(&withoutMatrix);
+    return errors;
+}
+
+/* The matrix copy of the differential evolution buffer must not change the jumps of the
+   differential evolution and ensemble proposals, for all parameters and for a subset of
+   names, also when the current sample has stopped varying one of the matrix columns. Expect pass. */
+int LALInferenceDEBufferProposal_TEST(void){
+    TEST_HEADER();
+    const UINT4 NDE = 50;
+    const unsigned long int seed = 20240101;
+    LALInferenceThreadState *thread = LALInferenceInitThread(NULL);
+    LALInferenceVariableItem *item;
+    INT4 approx = TaylorF2;
+    UINT4 i;
+    int errors;
+
+    thread->GSLrandom = gsl_rng_alloc(gsl_rng_mt19937);
+    gsl_rng_set(thread->GSLrandom, seed);
+
+    /* Varying parameters interleaved with fixed and output ones */
+    LALInferenceAddINT4Variable(thread->currentParams, "LAL_APPROXIMANT", approx, LALINFERENCE_PARAM_FIXED);
+    LALInferenceAddREAL8Variable(thread->currentParams, "chirpmass", 10.0, LALINFERENCE_PARAM_LINEAR);
+    LALInferenceAddREAL8Variable(thread->currentParams, "q", 0.5, LALINFERENCE_PARAM_LINEAR);
+    LALInferenceAddREAL8Variable(thread->currentParams, "phase", 1.0, LALINFERENCE_PARAM_CIRCULAR);
+    LALInferenceAddREAL8Variable(thread->currentParams, "logL", 0.0, LALINFERENCE_PARAM_OUTPUT);
+    LALInferenceAddREAL8Variable(thread->currentParams, "distance", 50.0, LALINFERENCE_PARAM_LINEAR);
+    LALInferenceAddREAL8Variable(thread->currentParams, "declination", 0.3, LALINFERENCE_PARAM_LINEAR);
+
+    /* Scatter the differential evolution points */
+    thread->differentialPoints = XLALRealloc(thread->differentialPoints, NDE * sizeof(LALInferenceVariables *));
+    thread->differentialPointsSize = NDE;
+    for (i = 0; i < NDE; i++) {
+        thread->differentialPoints[i] = XLALCalloc(1, sizeof(LALInferenceVariables));
+        LALInferenceCopyVariables(thread->currentParams, thread->differentialPoints[i]);
+        for (item = thread->differentialPoints[i]->head; item; item = item->next)
+            if (item->type == LALINFERENCE_REAL8_t && item->vary != LALINFERENCE_PARAM_FIXED)
+                *(REAL8 *)item->value *= 1.0 + 0.2*(gsl_rng_uniform(thread->GSLrandom) - 0.5);
+    }
+    thread->differentialPointsLength = NDE;
+
+    if (LALInferenceRebuildDEBuffer(thread) != XLAL_SUCCESS || !LALInferenceDEBufferInSync(thread))
+        TEST_FAIL("Could not build the differential evolution matrix.");
+
+    errors = compareDEBufferProposals(thread, seed);
+    if (errors)
+        TEST_FAIL("%i jump(s) differ with the matrix.", errors);
+
+    /* Sit on one of three buffered points, apart from a column that no longer
+       varies: the stretch move must still tell that point apart from the current
+       sample, or it draws again and the random numbers get out of step */
+    thread->differentialPointsLength = 3;
+    LALInferenceCopyVariables(thread->differentialPoints[0], thread->currentParams);
+    LALInferenceSetREAL8Variable(thread->currentParams, "declination", 0.0);
+    if (LALInferenceRebuildDEBuffer(thread) != XLAL_SUCCESS)
+        TEST_FAIL("Could not rebuild the differential evolution matrix.");
+    LALInferenceSetParamVaryType(thread->currentParams, "declination", LALINFERENCE_PARAM_FIXED);
+    errors = compareDEBufferProposals(thread, seed);
+    if (errors)
+        TEST_FAIL("%i jump(s) differ with the matrix when a column is fixed.", errors);
+
+    LALInferenceDestroyDEBuffer(thread->deBuffer);
+    thread->deBuffer = NULL;
+    for (i = 0; i < NDE; i++) {
+        LALInferenceClearVariables(thread->differentialPoints[i]);
+        XLALFree(thread->differentialPoints[i]);
+    }
+    gsl_rng_free(thread->GSLrandom);
+
+    TEST_FOOTER();
+}
+
+/*****************     TEST CODE for LALInferenceKDE     *****************/
+
+/* The tree-pruned kernel sum must agree with the sum over every sample, near the samples
+   and far out in the tails between them. Expect pass. */
+int LALInferenceKDETree_TEST(void){
+    TEST_HEADER();
+    const INT4 npts = 500, dim = 3, neval = 200;
+    const REAL8 tolerance = 1e-9;
+    gsl_rng *rng = gsl_rng_alloc(gsl_rng_mt19937);
+    REAL8 *pts = XLALMalloc(npts*dim*sizeof(REAL8));
+    REAL8 point[3], lower[3], upper[3], maxErr = 0.0;
+    INT4 i, j;
+
+    /* Two correlated, differently scaled blobs */
+    gsl_rng_set(rng, 314159);
+    for (i = 0; i < npts; i++) {
+        REAL8 a = gsl_ran_ugaussian(rng), b = gsl_ran_ugaussian(rng), c = gsl_ran_ugaussian(rng);
+        REAL8 offset = (i % 3 == 0) ? 8.0 : 0.0;
+        pts[i*dim + 0] = 10.0 + offset + a;
+        pts[i*dim + 1] = -3.0 + 0.01*(a + 0.5*b);
+        pts[i*dim + 2] = 100.0*offset + 50.0*c;
+    }
+    for (j = 0; j < dim; j++) {
+        lower[j] = upper[j] = pts[j];
+        for (i = 1; i < npts; i++) {
+            lower[j] = fmin(lower[j], pts[i*dim + j]);
+            upper[j] = fmax(upper[j], pts[i*dim + j]);
+        }
+    }
+
+    LALInferenceKDE *kde = LALInferenceNewKDE(pts, npts, dim, NULL);
+    if (kde == NULL || kde->tree == NULL)
+        TEST_FAIL("Expected a tree for a KDE of %i points.", npts);
+
+    for (i = 0; i < neval && kde && kde->tree; i++) {
+        /* Points near the samples, then anywhere in the bounding box, including the
+           sparse gaps between the blobs */
+        for (j = 0; j < dim; j++) {
+            if (i < neval/2)
+                point[j] = pts[i*dim + j] + 0.1*gsl_ran_ugaussian(rng)*sqrt(gsl_matrix_get(kde->cov, j, j));
+            else
+                point[j] = lower[j] + gsl_rng_uniform(rng)*(upper[j] - lower[j]);
+        }
+
+        REAL8 withTree = LALInferenceKDEEvaluatePoint(kde, point);
+        struct tagLALInferenceKDETree *tree = kde->tree;
+        kde->tree = NULL;
+        REAL8 bruteForce = LALInferenceKDEEvaluatePoint(kde, point);
+        kde->tree = tree;
+
+        /* Far enough out both sums underflow */
+        if (withTree == bruteForce)
+            continue;
+        if (!isfinite(withTree) || !isfinite(bruteForce)) {
+            TEST_FAIL("Log-density %g with the tree, %g over all samples.", withTree, bruteForce);
+            continue;
+        }
+        if (fabs(withTree - bruteForce) > maxErr)
+            maxErr = fabs(withTree - bruteForce);
+    }
+    if (maxErr > tolerance)
+        TEST_FAIL("Tree and full log-densities differ by up to %g.", maxErr);
+    printf("Largest log-density difference with the tree: %g\n", maxErr);
+
+    LALInferenceDestroyKDE(kde);
+    XLALFree(pts);
+    gsl_rng_free(rng);
+
+    TEST_FOOTER();
+}
+
+/*****************     TEST CODE for LALInferenceKmeans     *****************/
+
+/* Runs a k-means from the k-means++ initialisation with the generator set to seed.  The
+   caller destroys the result. */
+static LALInferenceKmeans *seededKmeans(gsl_matrix *data, INT4 k, gsl_rng *rng, unsigned long int seed)
+{
+    gsl_rng_set(rng, seed);
+    LALInferenceKmeans *kmeans = LALInferenceCreateKmeans(k, data, rng);
+    if (kmeans) {
+        LALInferenceKmeansSeededInitialize(kmeans);
+        LALInferenceKmeansRun(kmeans);
+    }
+    return kmeans;
+}
+
+/* The k-means++ initialisation and the clustering must be reproducible for a given seed,
+   whatever the number of threads, and must separate well separated blobs. Expect pass. */
+int LALInferenceKmeansSeeded_TEST(void){
+    TEST_HEADER();
+    const INT4 nblob = 3, nper = 200, dim = 2;
+    const unsigned long int seed = 271828;
+    gsl_rng *rng = gsl_rng_alloc(gsl_rng_mt19937);
+    gsl_matrix *data = gsl_matrix_alloc(nblob*nper, dim);
+    LALInferenceKmeans *first, *second;
+    INT4 i, j, c;
+
+    gsl_rng_set(rng, 1);
+    for (i = 0; i < nblob*nper; i++)
+        for (j = 0; j < dim; j++)
+            gsl_matrix_set(data, i, j, 100.0*((i/nper) == j) + gsl_ran_ugaussian(rng));
+
+#ifdef _OPENMP
+    INT4 nthreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+#endif
+    first = seededKmeans(data, nblob, rng, seed);
+#ifdef _OPENMP
+    omp_set_num_threads(nthreads > 4 ? nthreads : 4);
+#endif
+    second = seededKmeans(data, nblob, rng, seed);
+#ifdef _OPENMP
+    omp_set_num_threads(nthreads);
+#endif
+
+    if (first == NULL || second == NULL) {
+        TEST_FAIL("Could not run the k-means.");
+    } else {
+        for (c = 0; c < nblob; c++)
+            for (j = 0; j < dim; j++)
+                if (gsl_matrix_get(first->centroids, c, j) != gsl_matrix_get(second->centroids, c, j))
+                    TEST_FAIL("Centroid %i differs between runs with the same seed.", c);
+        for (i = 0; i < nblob*nper; i++)
+            if (first->assignments[i] != second->assignments[i]) {
+                TEST_FAIL("Assignment of point %i differs between runs with the same seed.", i);
+                break;
+            }
+        if (first->error != second->error)
+            TEST_FAIL("Clustering error %.17g differs from %.17g with the same seed.", first->error, second->error);
+
+        /* k-means++ starts from one point in each blob, so each blob ends up in a cluster */
+        for (i = 0; i < nblob*nper; i++)
+            if (first->assignments[i] != first->assignments[(i/nper)*nper]) {
+                TEST_FAIL("Point %i is not clustered with the rest of its blob.", i);
+                break;
+            }
+        for (c = 0; c < nblob; c++)
+            if (first->sizes[c] != nper)
+                TEST_FAIL("Cluster %i has %i points instead of %i.", c, first->sizes[c], nper);
+    }
+
+    LALInferenceKmeansDestroy(first);
+    LALInferenceKmeansDestroy(second);
+    gsl_matrix_free(data);
+    gsl_rng_free(rng);
+
+    TEST_FOOTER();
+}
+
 /******************************************
  * 
  * Old tests
@@ -369,5 +369,48 @@ int main(int UNUSED argc, char UNUSED **argv)
         }
     }
 
+    {
+        /* Interpolants filled in blocks, and evaluated in batches, should
+         * agree with the one-shot scalar interpolant */
+        enum {ns = 7, nt = 5, npts = 150};
+        double data[ns][nt];
+        for (int i = 0; i < ns; i ++)
+            for (int j = 0; j < nt; j ++)
+                data[i][j] = sin(i + 0.3 * j * j) + (i == 2 && j == 3 ? NAN : 0);
+        bicubic_interp *interp = bicubic_interp_init(
+            *data, ns, nt, -1, 2, 0.5, 0.25);
+        bicubic_interp *blocked = bicubic_interp_alloc(
+            ns, nt, -1, 2, 0.5, 0.25);
+        XLAL_CHECK_EXIT(interp && blocked);
+        for (int is = 0; is < ns + 6; is += 4)
+            for (int it = 0; it < nt + 6; it += 3)
+                bicubic_interp_init_block(blocked, *data, ns, nt,
+                    is, GSL_MIN_INT(is + 4, ns + 6),
+                    it, GSL_MIN_INT(it + 3, nt + 6));
+
+        double s[npts], t[npts], result[npts];
+        for (int i = 0; i < npts; i ++)
+        {
+            s[i] = -3 + 0.041 * i;
+            t[i] = 1 + 0.0233 * ((i * 37) % npts);
+        }
+        s[17] = NAN;
+        bicubic_interp_eval_n(blocked, npts, s, t, result);
+        for (int i = 0; i < npts; i ++)
+        {
+            const double expected = bicubic_interp_eval(interp, s[i], t[i]);
+            if (isnan(expected))
+                gsl_test(!isnan(result[i]),
+                    "testing batched bicubic interpolant at (%g, %g)",
+                    s[i], t[i]);
+            else
+                gsl_test_abs(result[i], expected, 10 * GSL_DBL_EPSILON,
+                    "testing batched bicubic interpolant at (%g, %g)",
+                    s[i], t[i]);
+        }
+        bicubic_interp_free(interp);
+        bicubic_interp_free(blocked);
+    }
+
     return gsl_test_summary();
 }
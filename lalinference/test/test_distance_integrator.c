@@ -0,0 +1,157 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with with program; see the file COPYING. If not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301  USA
+ */
+
+
+#include <stdio.h>
+#include <math.h>
+#include <lal/distance_integrator.h>
+#include <gsl/gsl_test.h>
+
+#include <lal/XLALError.h>
+
+#ifdef __GNUC__
+#define UNUSED __attribute__ ((unused))
+#else
+#define UNUSED
+#endif
+
+/* A small table, with several tiles along each side, spanning the same
+ * kind of prior as the likelihood uses */
+#define R1 10.0
+#define R2 1000.0
+#define K 2
+#define PMAX 1000.0
+#define SIZE 100
+
+#define NP 12
+#define NB 50
+#define TABLE_FILE "test_distance_integrator.dat"
+
+
+/* Optimal SNRs and matches covering all three regions of the table */
+static void fill_points(double p[NP], double b[NP][NB])
+{
+    for (int i = 0; i < NP; i ++)
+    {
+        p[i] = 0.5 * pow(1.8, i);
+        for (int j = 0; j < NB; j ++)
+            b[i][j] = p[i] * p[i] * pow(10, -3 + 5.0 * j / (NB - 1));
+    }
+}
+
+
+int main(int UNUSED argc, char UNUSED **argv)
+{
+    double p[NP], b[NP][NB];
+    double eager[NP][NB], lazy[NP][NB];
+    fill_points(p, b);
+
+    log_radial_integrator *integrator = log_radial_integrator_init(
+        R1, R2, K, 0, PMAX, SIZE, 0);
+    XLAL_CHECK_EXIT(integrator);
+    log_radial_integrator *lazy_integrator = log_radial_integrator_init_lazy(
+        R1, R2, K, 0, PMAX, SIZE, 0);
+    XLAL_CHECK_EXIT(lazy_integrator);
+
+    for (int i = 0; i < NP; i ++)
+        for (int j = 0; j < NB; j ++)
+            eager[i][j] = log_radial_integrator_eval(
+                integrator, p[i], b[i][j], log(p[i]), log(b[i][j]));
+
+    /* Fill in the lazy table from several threads at once, in an order
+     * that has neighbouring threads asking for the same tiles */
+    #pragma omp parallel for schedule(dynamic)
+    for (int n = 0; n < NP * NB; n ++)
+    {
+        const int i = n % NP, j = n / NP;
+        lazy[i][j] = log_radial_integrator_eval(
+            lazy_integrator, p[i], b[i][j], log(p[i]), log(b[i][j]));
+    }
+
+    for (int i = 0; i < NP; i ++)
+        for (int j = 0; j < NB; j ++)
+            gsl_test_abs(lazy[i][j], eager[i][j], 0,
+                "testing table filled on demand for p=%g, b=%g", p[i], b[i][j]);
+
+    gsl_test_abs(
+        log_radial_integrator_eval(lazy_integrator, 0, 0, -INFINITY, -INFINITY),
+        log_radial_integrator_eval(integrator, 0, 0, -INFINITY, -INFINITY), 0,
+        "testing table filled on demand for p=0");
+
+    /* One optimal SNR with many matches at once, filling in a fresh table */
+    log_radial_integrator *series_integrator = log_radial_integrator_init_lazy(
+        R1, R2, K, 0, PMAX, SIZE, 0);
+    XLAL_CHECK_EXIT(series_integrator);
+    for (int i = 0; i < NP; i ++)
+    {
+        double result[NB];
+        log_radial_integrator_eval_n(series_integrator, p[i], log(p[i]), NB, b[i], result);
+        for (int j = 0; j < NB; j ++)
+            gsl_test_abs(result[j], eager[i][j], 0,
+                "testing series evaluation for p=%g, b=%g", p[i], b[i][j]);
+
+        double inplace[NB];
+        for (int j = 0; j < NB; j ++)
+            inplace[j] = b[i][j];
+        log_radial_integrator_eval_n(integrator, p[i], log(p[i]), NB, inplace, inplace);
+        for (int j = 0; j < NB; j ++)
+            gsl_test_abs(inplace[j], eager[i][j], 0,
+                "testing series evaluation in place for p=%g, b=%g", p[i], b[i][j]);
+    }
+
+    /* Saving and loading the table */
+    {
+        log_radial_integrator *incomplete = log_radial_integrator_init_lazy(
+            R1, R2, K, 0, PMAX, SIZE, 0);
+        XLAL_CHECK_EXIT(incomplete);
+        gsl_test_int(log_radial_integrator_save(incomplete, TABLE_FILE), XLAL_FAILURE,
+            "testing that an incomplete table is not saved");
+        XLALClearErrno();
+        log_radial_integrator_free(incomplete);
+
+        gsl_test_int(log_radial_integrator_save(integrator, TABLE_FILE), XLAL_SUCCESS,
+            "testing saving the table");
+
+        log_radial_integrator *loaded = log_radial_integrator_load(
+            TABLE_FILE, R1, R2, K, 0, PMAX, SIZE, 0);
+        gsl_test(!loaded, "testing loading the table");
+        if (loaded)
+        {
+            for (int i = 0; i < NP; i ++)
+                for (int j = 0; j < NB; j ++)
+                    gsl_test_abs(
+                        log_radial_integrator_eval(loaded, p[i], b[i][j], log(p[i]), log(b[i][j])),
+                        eager[i][j], 0,
+                        "testing loaded table for p=%g, b=%g", p[i], b[i][j]);
+            log_radial_integrator_free(loaded);
+        }
+
+        loaded = log_radial_integrator_load(TABLE_FILE, R1, 2 * R2, K, 0, PMAX, SIZE, 0);
+        gsl_test(loaded != NULL, "testing that a table for another prior is not loaded");
+        log_radial_integrator_free(loaded);
+        loaded = log_radial_integrator_load(TABLE_FILE, R1, R2, K, 0, PMAX, SIZE + 1, 0);
+        gsl_test(loaded != NULL, "testing that a table of another size is not loaded");
+        log_radial_integrator_free(loaded);
+        remove(TABLE_FILE);
+    }
+
+    log_radial_integrator_free(series_integrator);
+    log_radial_integrator_free(lazy_integrator);
+    log_radial_integrator_free(integrator);
+
+    return gsl_test_summary();
+}
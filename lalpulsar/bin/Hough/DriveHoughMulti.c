@@ -96,6 +96,15 @@
 #include "MCInjectHoughMulti.h"
 #include "FstatToplist.h"
 
+/* the Hough maps of the spin-downs at one frequency are built together,
+   in blocks of at most one map per OpenMP thread */
+#ifdef _OPENMP
+#include <omp.h>
+#define HOUGH_MAX_MAPS_IN_FLIGHT omp_get_max_threads()
+#else
+#define HOUGH_MAX_MAPS_IN_FLIGHT 1
+#endif
+
 /* globals, constants and defaults */
 
 /* boolean global variables for controlling output */
@@ -272,13 +281,14 @@ int main( int argc, char *argv[] )
   static HOUGHPeakGramVector pgV;  /* vector of peakgrams */
   static UCHARPeakGramVector upgV;  /* vector of expanded peakgrams */
   static PHMDVectorSequence  phmdVS;  /* the partial Hough map derivatives */
-  static UINT8FrequencyIndexVector freqInd; /* for trajectory in time-freq plane */
+  static UINT8FrequencyIndexVectorSequence freqIndVS; /* trajectories in time-freq plane, one per spin-down */
   static HOUGHResolutionPar parRes;   /* patch grid information */
   static HOUGHPatchGrid  patch;   /* Patch description */
   static HOUGHParamPLUT  parLut;  /* parameters needed to build lut  */
   static HOUGHDemodPar   parDem;  /* demodulation parameters or  */
   static HOUGHSizePar    parSize;
   static HOUGHMapTotal   ht;   /* the total Hough map */
+  static HOUGHMapTotalVector htV; /* the total Hough maps of a block of spin-downs at one frequency */
   static UINT8Vector     *hist; /* histogram of number counts for a single map */
   static UINT8Vector     *histTotal; /* number count histogram for all maps */
   static HoughStats      stats;  /* statistical information about a Hough map */
@@ -300,7 +310,8 @@ int main( int argc, char *argv[] )
   static HoughSignificantEventVector nStarEventVec;
 
   /* miscellaneous */
-  INT4   iHmap, nSpin1Max ;
+  INT4   iHmap, nSpin1Max, nSpinUpJumps ;
+  UINT4  iSpin, nSpins, nMapsMax, iBlock;
   UINT4  mObsCoh, mObsCohBest;
   INT8   f0Bin, fLastBin, fBin;
   REAL8  alpha, delta, timeBase, deltaF, f1jump;
@@ -823,7 +834,25 @@ int main( int argc, char *argv[] )
     LAL_CALL( LALHOUGHCreatePHMDVS( &status, &phmdVS, mObsCohBest, uvar_nfSizeCylinder ), &status );
     phmdVS.deltaF  = deltaF;
 
-    LAL_CALL( LALHOUGHCreateFreqIndVector( &status, &freqInd, mObsCohBest, deltaF ), &status );
+    /* ***** for spin-down case ****/
+    nSpin1Max = uvar_nfSizeCylinder - 1 - uvar_nSpinUp;
+    /* nSpin1Max = floor(uvar_nfSizeCylinder/2.0) ;*/
+    nSpinUpJumps = floor( uvar_nSpinUp / uvar_spindownJump );
+
+    /* one trajectory and one map for each spin-down value of a block */
+    nSpins = nSpinUpJumps + floor( nSpin1Max / uvar_spindownJump ) + 1;
+    nMapsMax = nSpins;
+    if ( nMapsMax > ( UINT4 )HOUGH_MAX_MAPS_IN_FLIGHT ) {
+      nMapsMax = HOUGH_MAX_MAPS_IN_FLIGHT;
+    }
+    freqIndVS.length = nMapsMax;
+    freqIndVS.vectorLength = mObsCohBest;
+    freqIndVS.freqIndV = ( UINT8FrequencyIndexVector * )LALCalloc( freqIndVS.length, sizeof( UINT8FrequencyIndexVector ) );
+    for ( iSpin = 0; iSpin < freqIndVS.length; ++iSpin ) {
+      LAL_CALL( LALHOUGHCreateFreqIndVector( &status, &( freqIndVS.freqIndV[iSpin] ), mObsCohBest, deltaF ), &status );
+    }
+    htV.length = nMapsMax;
+    htV.ht = ( HOUGHMapTotal * )LALCalloc( htV.length, sizeof( HOUGHMapTotal ) );
 
     /* allocating histogram of the number-counts in the Hough maps */
     if ( uvar_EnableExtraInfo ) {
@@ -864,10 +893,6 @@ int main( int argc, char *argv[] )
     fBin = f0Bin;
     iHmap = 0;
 
-    /* ***** for spin-down case ****/
-    nSpin1Max = uvar_nfSizeCylinder - 1 - uvar_nSpinUp;
-    /* nSpin1Max = floor(uvar_nfSizeCylinder/2.0) ;*/
-
 
     if ( XLALUserVarWasSet( &uvar_deltaF1dot ) ) {
       f1jump = uvar_deltaF1dot * uvar_spindownJump;
@@ -936,7 +961,11 @@ int main( int argc, char *argv[] )
 
       /* ************ initializing the Total Hough map space *********** */
 
-      LAL_CALL( LALHOUGHCreateHT( &status, &ht, xSide, ySide ), &status );
+      for ( j = 0; j < nMapsMax; ++j ) {
+        LAL_CALL( LALHOUGHCreateHT( &status, &( htV.ht[j] ), xSide, ySide ), &status );
+      }
+      ht.xSide = xSide;
+      ht.ySide = ySide;
       ht.mObsCoh = mObsCohBest;
       ht.deltaF = deltaF;
 
@@ -960,57 +989,70 @@ int main( int argc, char *argv[] )
         ht.spinRes.length = 1;
         ht.spinRes.data = NULL;
         ht.spinRes.data = ( REAL8 * )LALCalloc( ht.spinRes.length, sizeof( REAL8 ) );
-        for ( n = floor( uvar_nSpinUp / uvar_spindownJump ); n >= - floor( nSpin1Max / uvar_spindownJump ); --n ) {
-          /*for ( n = 0; n <= floor(nSpin1Max/uvar_spindownJump); ++n) {*/
-          /* f1dis = - n * f1jump; */
-          /*loop over all spindown values */
+        /* loop over blocks of spindown values, from the largest spin-up down */
+        for ( iBlock = 0; iBlock < nSpins; iBlock += nMapsMax ) {
 
-          f1dis = + n * f1jump;
-          ht.spinRes.data[0] =  f1dis * deltaF;
-
-          /* construct path in time-freq plane */
-          for ( j = 0 ; j < mObsCohBest; ++j ) {
-            freqInd.data[j] = fBinSearch + floor( best.timeDiffV->data[j] * f1dis + 0.5 );
+          /* construct paths in time-freq plane for the spindown values of this block */
+          htV.length = freqIndVS.length = nMapsMax;
+          if ( iBlock + nMapsMax > nSpins ) {
+            htV.length = freqIndVS.length = nSpins - iBlock;
           }
-
-          if ( uvar_weighAM || uvar_weighNoise ) {
-            LAL_CALL( LALHOUGHConstructHMT_W( &status, &ht, &freqInd, &phmdVS ), &status );
-          } else {
-            LAL_CALL( LALHOUGHConstructHMT( &status, &ht, &freqInd, &phmdVS ), &status );
+          for ( iSpin = 0; iSpin < htV.length; ++iSpin ) {
+            UINT8 *freqInd = freqIndVS.freqIndV[iSpin].data;
+            n = nSpinUpJumps - ( INT4 )( iBlock + iSpin );
+            f1dis = + n * f1jump;
+            for ( j = 0 ; j < mObsCohBest; ++j ) {
+              freqInd[j] = fBinSearch + floor( best.timeDiffV->data[j] * f1dis + 0.5 );
+            }
           }
 
+          /* the maps only share the PHMDs, so they are constructed together (in parallel with OpenMP) */
+          LAL_CALL( LALHOUGHConstructHMTVector( &status, &htV, &freqIndVS, &phmdVS, uvar_weighAM || uvar_weighNoise ), &status );
+
+          for ( iSpin = 0; iSpin < htV.length; ++iSpin ) {
+            /*for ( n = 0; n <= floor(nSpin1Max/uvar_spindownJump); ++n) {*/
+            /* f1dis = - n * f1jump; */
+            /*loop over the spindown values of this block */
+
+            n = nSpinUpJumps - ( INT4 )( iBlock + iSpin );
+            f1dis = + n * f1jump;
+            ht.spinRes.data[0] =  f1dis * deltaF;
+            ht.map = htV.ht[iSpin].map;
+
 
-          /* ********************* perfom stat. analysis on the maps ****************** */
+            /* ********************* perfom stat. analysis on the maps ****************** */
 
-          if ( uvar_EnableExtraInfo ) {
+            if ( uvar_EnableExtraInfo ) {
 
-            LAL_CALL( LALHoughStatistics( &status, &stats, &ht ), &status );
-            LAL_CALL( LALStereo2SkyLocation( &status, &sourceLocation,
-                                             stats.maxIndex[0], stats.maxIndex[1], &patch, &parDem ), &status );
+              LAL_CALL( LALHoughStatistics( &status, &stats, &ht ), &status );
+              LAL_CALL( LALStereo2SkyLocation( &status, &sourceLocation,
+                                               stats.maxIndex[0], stats.maxIndex[1], &patch, &parDem ), &status );
 
-            /*LAL_CALL( LALHoughHistogram ( &status, &hist, &ht), &status);*/
-            LAL_CALL( LALHoughHistogramSignificance( &status, hist, &ht, meanN, sigmaN,
-                      minSignificance, maxSignificance ), &status );
+              /*LAL_CALL( LALHoughHistogram ( &status, &hist, &ht), &status);*/
+              LAL_CALL( LALHoughHistogramSignificance( &status, hist, &ht, meanN, sigmaN,
+                        minSignificance, maxSignificance ), &status );
 
-            for ( j = 0; j < histTotal->length; j++ ) {
-              histTotal->data[j] += hist->data[j];
+              for ( j = 0; j < histTotal->length; j++ ) {
+                histTotal->data[j] += hist->data[j];
+              }
             }
-          }
 
-          /* select candidates from hough maps */
-          LAL_CALL( GetToplistFromHoughmap( &status, toplist, &ht, &patch, &parDem, meanN, sigmaN ), &status );
+            /* select candidates from hough maps */
+            LAL_CALL( GetToplistFromHoughmap( &status, toplist, &ht, &patch, &parDem, meanN, sigmaN ), &status );
 
 
-          /* ***** print results *********************** */
+            /* ***** print results *********************** */
 
-          if ( uvar_EnableExtraInfo ) {
-            if ( PrintExtraInfo( fileMaps, &fp1, iHmap, &ht, &sourceLocation, &stats, fBinSearch, deltaF ) ) {
-              return DRIVEHOUGHCOLOR_EFILE;
+            if ( uvar_EnableExtraInfo ) {
+              if ( PrintExtraInfo( fileMaps, &fp1, iHmap, &ht, &sourceLocation, &stats, fBinSearch, deltaF ) ) {
+                return DRIVEHOUGHCOLOR_EFILE;
+              }
             }
-          }
 
-          ++iHmap;
-        } /* end loop over spindown values */
+            ++iHmap;
+          } /* end loop over spindown values */
+
+        } /* end loop over blocks of spindown values */
 
         LALFree( ht.spinRes.data );
 
@@ -1031,7 +1073,9 @@ int main( int argc, char *argv[] )
       /* ********************  Free partial memory ******************* */
       LALFree( patch.xCoor );
       LALFree( patch.yCoor );
-      LALFree( ht.map );
+      for ( j = 0; j < nMapsMax; ++j ) {
+        LALFree( htV.ht[j].map );
+      }
 
       LALHOUGHDestroyLUTs( &status, &lutV );
 
@@ -1071,8 +1115,13 @@ int main( int argc, char *argv[] )
     LALFree( phmdVS.phmd );
     phmdVS.phmd = NULL;
 
-    LALFree( freqInd.data );
-    freqInd.data = NULL;
+    for ( iSpin = 0; iSpin < nMapsMax; ++iSpin ) {
+      LALFree( freqIndVS.freqIndV[iSpin].data );
+    }
+    LALFree( freqIndVS.freqIndV );
+    freqIndVS.freqIndV = NULL;
+    LALFree( htV.ht );
+    htV.ht = NULL;
 
     if ( uvar_EnableExtraInfo ) {
       XLALDestroyUINT8Vector( hist );
@@ -1498,7 +1498,9 @@ void ComputeFstatHoughMap(LALStatus *status,		/**< pointer to LALStatus structur
   HOUGHMapTotal ht;
   HOUGHptfLUTVector   lutV; /* the Look Up Table vector*/
   PHMDVectorSequence  phmdVS;  /* the partial Hough map derivatives */
-  UINT8FrequencyIndexVector freqInd; /* for trajectory in time-freq plane */
+  UINT8FrequencyIndexVectorSequence freqIndVS; /* trajectories in time-freq plane, one per residual spindown in a block */
+  HOUGHMapTotalVector htV; /* hough maps for a block of residual spindowns at one frequency */
+  UINT4 nMapsMax; /* number of hough maps in a block */
   HOUGHResolutionPar parRes;   /* patch grid information */
   HOUGHPatchGrid  patch;   /* Patch description */
   HOUGHParamPLUT  parLut;  /* parameters needed to build lut  */
@@ -1623,11 +1625,32 @@ void ComputeFstatHoughMap(LALStatus *status,		/**< pointer to LALStatus structur
     ABORT ( status, HIERARCHICALSEARCH_EMEM, HIERARCHICALSEARCH_MSGEMEM );
   }
 
-  /* residual spindown trajectory */
-  freqInd.deltaF = deltaF;
-  freqInd.length = nStacks;
-  freqInd.data = LALCalloc(1, alloc_len = nStacks*sizeof(UINT8));
-  if ( freqInd.data == NULL ) {
+  /* residual spindown trajectories, for at most one map per thread at a time */
+  nMapsMax = 2*(nfdot/2) + 1;
+  if ( nMapsMax > (UINT4)HOUGH_MAX_MAPS_IN_FLIGHT ) {
+    nMapsMax = HOUGH_MAX_MAPS_IN_FLIGHT;
+  }
+  freqIndVS.length = nMapsMax;
+  freqIndVS.vectorLength = nStacks;
+  freqIndVS.freqIndV = LALCalloc(1, alloc_len = freqIndVS.length*sizeof(UINT8FrequencyIndexVector));
+  if ( freqIndVS.freqIndV == NULL ) {
+    XLALPrintError ("Failed to LALCalloc(1,%d)\n", alloc_len );
+    ABORT ( status, HIERARCHICALSEARCH_EMEM, HIERARCHICALSEARCH_MSGEMEM );
+  }
+  for (k=0; k<freqIndVS.length; k++) {
+    freqIndVS.freqIndV[k].deltaF = deltaF;
+    freqIndVS.freqIndV[k].length = nStacks;
+    freqIndVS.freqIndV[k].data = LALCalloc(1, alloc_len = nStacks*sizeof(UINT8));
+    if ( freqIndVS.freqIndV[k].data == NULL ) {
+      XLALPrintError ("Failed to LALCalloc(1,%d)\n", alloc_len );
+      ABORT ( status, HIERARCHICALSEARCH_EMEM, HIERARCHICALSEARCH_MSGEMEM );
+    }
+  }
+
+  /* the hough maps of one block of residual spindowns */
+  htV.length = nMapsMax;
+  htV.ht = LALCalloc(1, alloc_len = htV.length*sizeof(HOUGHMapTotal));
+  if ( htV.ht == NULL ) {
     XLALPrintError ("Failed to LALCalloc(1,%d)\n", alloc_len );
     ABORT ( status, HIERARCHICALSEARCH_EMEM, HIERARCHICALSEARCH_MSGEMEM );
   }
@@ -1885,7 +1908,7 @@ void ComputeFstatHoughMap(LALStatus *status,		/**< pointer to LALStatus structur
     ht.patchSizeX = patchSizeX;
     ht.patchSizeY = patchSizeY;
     ht.dFdot.data[0] = dfdot;
-    ht.map   = LALCalloc(1, alloc_len = xSide*ySide*sizeof(HoughTT));
+    ht.map   = LALCalloc(1, alloc_len = nMapsMax*xSide*ySide*sizeof(HoughTT));
     if ( ht.map == NULL ) {
       XLALPrintError ("Failed to LALCalloc( 1, %d)\n", alloc_len );
       ABORT ( status, HIERARCHICALSEARCH_EMEM, HIERARCHICALSEARCH_MSGEMEM );
@@ -1893,6 +1916,12 @@ void ComputeFstatHoughMap(LALStatus *status,		/**< pointer to LALStatus structur
 
     TRY( LALHOUGHInitializeHT( status->statusPtr, &ht, &patch), status); /*not needed */
 
+    /* one map per residual spindown of a block, in consecutive parts of ht.map */
+    for (k=0; k<nMapsMax; k++) {
+      htV.ht[k] = ht;
+      htV.ht[k].map = ht.map + k*xSide*ySide;
+    }
+
     /*  Search frequency interval possible using the same LUTs */
     fBinSearch = fBin;
     fBinSearchMax = fBin + parSize.nFreqValid - 1;
@@ -1902,63 +1931,79 @@ void ComputeFstatHoughMap(LALStatus *status,		/**< pointer to LALStatus structur
 
       /* finally we can construct the hough maps and select candidates */
       {
-	INT4   n, nfdotBy2;
+	INT4   n, nBlock, nfdotBy2;
 
 	nfdotBy2 = nfdot/2;
 	ht.f0Bin = fBinSearch;
 
-	/*loop over all values of residual spindown */
-	/* check limits of loop */
-	for( n = -nfdotBy2; n <= nfdotBy2 ; n++ ){
-
-	  ht.spinRes.data[0] =  n*dfdot;
+	/*loop over blocks of residual spindown values */
+	for( nBlock = -nfdotBy2; nBlock <= nfdotBy2 ; nBlock += (INT4)nMapsMax ){
 
-	  for (j=0; j < (UINT4)nStacks; j++) {
-	    freqInd.data[j] = fBinSearch + floor( (REAL4)(timeDiffV->data[j]*n*dfdot/deltaF) + 0.5f);
+	  /* trajectories of the residual spindowns of this block */
+	  htV.length = freqIndVS.length = nMapsMax;
+	  if ( nBlock + (INT4)nMapsMax > nfdotBy2 + 1 ) {
+	    htV.length = freqIndVS.length = nfdotBy2 - nBlock + 1;
+	  }
+	  for (k=0; k<htV.length; k++) {
+	    UINT8 *freqInd = freqIndVS.freqIndV[k].data;
+	    n = nBlock + (INT4)k;
+	    for (j=0; j < (UINT4)nStacks; j++) {
+	      freqInd[j] = fBinSearch + floor( (REAL4)(timeDiffV->data[j]*n*dfdot/deltaF) + 0.5f);
+	    }
 	  }
 
-	  TRY( LALHOUGHConstructHMT_W(status->statusPtr, &ht, &freqInd, &phmdVS),status );
+	  /* the maps only share the PHMDs, so they are constructed together (in parallel with OpenMP) */
+	  TRY( LALHOUGHConstructHMTVector(status->statusPtr, &htV, &freqIndVS, &phmdVS, 1), status );
 
-	  /* get candidates */
-	  if ( params->useToplist ) {
-	    TRY(GetHoughCandidates_toplist( status->statusPtr, houghToplist, &ht, &patch, &parDem), status);
-	  }
-	  else {
-	    TRY(GetHoughCandidates_threshold( status->statusPtr, out, &ht, &patch, &parDem, params->threshold), status);
-	  }
+	  /*loop over the residual spindowns of this block, in order */
+	  for (k=0; k<htV.length; k++) {
 
-	  /* calculate statistics and histogram */
-	  if ( uvar_printStats && (fpStats != NULL) ) {
-	    TRY( LALHoughStatistics ( status->statusPtr, &stats, &ht), status );
-	    TRY( LALStereo2SkyLocation ( status->statusPtr, &sourceLocation,
-					stats.maxIndex[0], stats.maxIndex[1],
-					&patch, &parDem), status);
+	    n = nBlock + (INT4)k;
+	    ht.spinRes.data[0] =  n*dfdot;
+	    ht.map = htV.ht[k].map;
 
-	    fprintf(fpStats, "%d %f %f %f %f %f %f %f %g \n", iHmap, sourceLocation.alpha, sourceLocation.delta,
-		    (REAL4)stats.maxCount, (REAL4)stats.minCount, (REAL4)stats.avgCount, (REAL4)stats.stdDev,
-		    fBinSearch*deltaF,  ht.spinRes.data[0] );
+	    /* get candidates */
+	    if ( params->useToplist ) {
+	      TRY(GetHoughCandidates_toplist( status->statusPtr, houghToplist, &ht, &patch, &parDem), status);
+	    }
+	    else {
+	      TRY(GetHoughCandidates_threshold( status->statusPtr, out, &ht, &patch, &parDem, params->threshold), status);
+	    }
 
-	    TRY( LALHoughHistogram ( status->statusPtr, &hist, &ht), status);
-	    for(j=0; j< histTotal.length; ++j)
-	      histTotal.data[j]+=hist.data[j];
-	  }
+	    /* calculate statistics and histogram */
+	    if ( uvar_printStats && (fpStats != NULL) ) {
+	      TRY( LALHoughStatistics ( status->statusPtr, &stats, &ht), status );
+	      TRY( LALStereo2SkyLocation ( status->statusPtr, &sourceLocation,
+					  stats.maxIndex[0], stats.maxIndex[1],
+					  &patch, &parDem), status);
 
-	  /* print hough map */
-	  if ( uvar_printMaps ) {
-	    TRY( PrintHmap2file( status->statusPtr, &ht, params->outBaseName, iHmap), status);
-	  }
+	      fprintf(fpStats, "%d %f %f %f %f %f %f %f %g \n", iHmap, sourceLocation.alpha, sourceLocation.delta,
+		      (REAL4)stats.maxCount, (REAL4)stats.minCount, (REAL4)stats.avgCount, (REAL4)stats.stdDev,
+		      fBinSearch*deltaF,  ht.spinRes.data[0] );
 
-	  if ( uvar_printGrid ) {
-	    /* just print one grid */
-	    if ( iHmap == 0 ) {
-	      TRY( PrintHoughGrid( status->statusPtr, &patch, &parDem, params->outBaseName, iHmap), status);
+	      TRY( LALHoughHistogram ( status->statusPtr, &hist, &ht), status);
+	      for(j=0; j< histTotal.length; ++j)
+		histTotal.data[j]+=hist.data[j];
+	    }
+
+	    /* print hough map */
+	    if ( uvar_printMaps ) {
+	      TRY( PrintHmap2file( status->statusPtr, &ht, params->outBaseName, iHmap), status);
 	    }
-	  }
 
-	  /* increment hough map index */
-	  ++iHmap;
+	    if ( uvar_printGrid ) {
+	      /* just print one grid */
+	      if ( iHmap == 0 ) {
+		TRY( PrintHoughGrid( status->statusPtr, &patch, &parDem, params->outBaseName, iHmap), status);
+	      }
+	    }
 
-	} /* end loop over spindown trajectories */
+	    /* increment hough map index */
+	    ++iHmap;
+
+	  } /* end loop over spindown trajectories */
+
+	} /* end loop over blocks of spindowns */
 
       } /* end of block for calculating total hough maps */
 
@@ -1980,7 +2025,7 @@ void ComputeFstatHoughMap(LALStatus *status,		/**< pointer to LALStatus structur
     /*--------------  Free partial memory -----------------*/
     LALFree(patch.xCoor);
     LALFree(patch.yCoor);
-    LALFree(ht.map);
+    LALFree(htV.ht[0].map);
 
     for (j=0; j<lutV.length ; ++j){
       for (i=0; i<maxNBorders; ++i){
@@ -2004,7 +2049,11 @@ void ComputeFstatHoughMap(LALStatus *status,		/**< pointer to LALStatus structur
   LALFree(ht.dFdot.data);
   LALFree(lutV.lut);
   LALFree(phmdVS.phmd);
-  LALFree(freqInd.data);
+  for (k=0; k<nMapsMax; k++) {
+    LALFree(freqIndVS.freqIndV[k].data);
+  }
+  LALFree(freqIndVS.freqIndV);
+  LALFree(htV.ht);
   LALFree(parDem.spin.data);
 
   TRY( LALDDestroyVector( status->statusPtr, &timeDiffV), status);
@@ -68,6 +68,15 @@
 /* more efficient toplist using heaps */
 #include "HoughFstatToplist.h"
 
+/* the Hough maps of the residual spindowns at one frequency are built
+   together, in blocks of at most one map per OpenMP thread */
+#ifdef _OPENMP
+#include <omp.h>
+#define HOUGH_MAX_MAPS_IN_FLIGHT omp_get_max_threads()
+#else
+#define HOUGH_MAX_MAPS_IN_FLIGHT 1
+#endif
+
 /******************************************************
  *   Protection against C++ name mangling
  */
@@ -91,6 +91,12 @@ LocalHOUGHConstructHMT_W  (LALStatus                  *status,
 			   UINT8FrequencyIndexVector  *freqInd, /**< time-frequency trajectory */ 
 			   PHMDVectorSequence         *phmdVS); /**< set of partial hough map derivatives */
 
+static void
+LocalHOUGHConstructHMTVector_W (LALStatus                         *status,
+				HOUGHMapTotalVector               *htV,       /**< The output hough maps */
+				UINT8FrequencyIndexVectorSequence *freqIndVS, /**< time-frequency trajectories */
+				PHMDVectorSequence                *phmdVS);   /**< set of partial hough map derivatives */
+
 static void
 LocalHOUGHAddPHMD2HD_W    (LALStatus      *status, /**< the status pointer */
 			   HOUGHMapDeriv  *hd,     /**< the Hough map derivative */
@@ -120,7 +126,9 @@ LocalComputeFstatHoughMap (LALStatus            *status,
   HOUGHMapTotal ht;
   HOUGHptfLUTVector   lutV; /* the Look Up Table vector*/
   PHMDVectorSequence  phmdVS;  /* the partial Hough map derivatives */
-  UINT8FrequencyIndexVector freqInd; /* for trajectory in time-freq plane */
+  UINT8FrequencyIndexVectorSequence freqIndVS; /* trajectories in time-freq plane, one per residual spindown in a block */
+  HOUGHMapTotalVector htV; /* hough maps for a block of residual spindowns at one frequency */
+  UINT4 nMapsMax; /* number of hough maps in a block */
   HOUGHResolutionPar parRes;   /* patch grid information */
   HOUGHPatchGrid  patch;   /* Patch description */ 
   HOUGHParamPLUT  parLut;  /* parameters needed to build lut  */
@@ -240,14 +248,32 @@ LocalComputeFstatHoughMap (LALStatus            *status,
     ABORT ( status, HIERARCHICALSEARCH_ENULL, HIERARCHICALSEARCH_MSGENULL );
   }    
 
-  /* residual spindown trajectory */
-  freqInd.deltaF = deltaF;
-  freqInd.length = nStacks;
-  freqInd.data = NULL;
-  freqInd.data =  ( UINT8 *)LALCalloc(1,nStacks*sizeof(UINT8));
-  if ( freqInd.data == NULL ) {
+  /* residual spindown trajectories, for at most one map per thread at a time */
+  nMapsMax = 2*(nfdot/2) + 1;
+  if ( nMapsMax > (UINT4)HOUGH_MAX_MAPS_IN_FLIGHT ) {
+    nMapsMax = HOUGH_MAX_MAPS_IN_FLIGHT;
+  }
+  freqIndVS.length = nMapsMax;
+  freqIndVS.vectorLength = nStacks;
+  freqIndVS.freqIndV = (UINT8FrequencyIndexVector *)LALCalloc(1,freqIndVS.length*sizeof(UINT8FrequencyIndexVector));
+  if ( freqIndVS.freqIndV == NULL ) {
     ABORT ( status, HIERARCHICALSEARCH_ENULL, HIERARCHICALSEARCH_MSGENULL );
-  }  
+  }
+  for (k=0; k<freqIndVS.length; k++) {
+    freqIndVS.freqIndV[k].deltaF = deltaF;
+    freqIndVS.freqIndV[k].length = nStacks;
+    freqIndVS.freqIndV[k].data = (UINT8 *)LALCalloc(1,nStacks*sizeof(UINT8));
+    if ( freqIndVS.freqIndV[k].data == NULL ) {
+      ABORT ( status, HIERARCHICALSEARCH_ENULL, HIERARCHICALSEARCH_MSGENULL );
+    }
+  }
+
+  /* the hough maps of one block of residual spindowns */
+  htV.length = nMapsMax;
+  htV.ht = (HOUGHMapTotal *)LALCalloc(1,htV.length*sizeof(HOUGHMapTotal));
+  if ( htV.ht == NULL ) {
+    ABORT ( status, HIERARCHICALSEARCH_ENULL, HIERARCHICALSEARCH_MSGENULL );
+  }
    
   /* resolution in space of residual spindowns */
   ht.dFdot.length = 1;
@@ -439,12 +465,18 @@ LocalComputeFstatHoughMap (LALStatus            *status,
     ht.patchSizeY = patchSizeY;
     ht.dFdot.data[0] = dfdot;
     ht.map   = NULL;
-    ht.map   = (HoughTT *)LALCalloc(1,xSide*ySide*sizeof(HoughTT));
+    ht.map   = (HoughTT *)LALCalloc(1,nMapsMax*xSide*ySide*sizeof(HoughTT));
     if ( ht.map == NULL ) {
       ABORT ( status, HIERARCHICALSEARCH_ENULL, HIERARCHICALSEARCH_MSGENULL );
     }  
 
     TRY( LocalHOUGHInitializeHT( status->statusPtr, &ht, &patch), status); /*not needed */
+
+    /* one map per residual spindown of a block, in consecutive parts of ht.map */
+    for (k=0; k<nMapsMax; k++) {
+      htV.ht[k] = ht;
+      htV.ht[k].map = ht.map + k*xSide*ySide;
+    }
     
     /*  Search frequency interval possible using the same LUTs */
     fBinSearch = fBin;
@@ -455,32 +487,47 @@ LocalComputeFstatHoughMap (LALStatus            *status,
 
       /* finally we can construct the hough maps and select candidates */
       {
-	INT4   n, nfdotBy2;
+	INT4   n, nBlock, nfdotBy2;
 
 	nfdotBy2 = nfdot/2;
 	ht.f0Bin = fBinSearch;
 
-	/*loop over all values of residual spindown */
-	/* check limits of loop */
-	for( n = -nfdotBy2; n <= nfdotBy2 ; n++ ){ 
+	/*loop over blocks of residual spindown values */
+	for( nBlock = -nfdotBy2; nBlock <= nfdotBy2 ; nBlock += (INT4)nMapsMax ){
 
-	  ht.spinRes.data[0] =  n*dfdot; 
-	  
-	  for (j=0; j < (UINT4)nStacks; j++) {
-	    freqInd.data[j] = fBinSearch + floor( (REAL4)(timeDiffV->data[j]*n*dfdot/deltaF) + 0.5f);
+	  /* trajectories of the residual spindowns of this block */
+	  htV.length = freqIndVS.length = nMapsMax;
+	  if ( nBlock + (INT4)nMapsMax > nfdotBy2 + 1 ) {
+	    htV.length = freqIndVS.length = nfdotBy2 - nBlock + 1;
+	  }
+	  for (k=0; k<htV.length; k++) {
+	    UINT8 *freqInd = freqIndVS.freqIndV[k].data;
+	    n = nBlock + (INT4)k;
+	    for (j=0; j < (UINT4)nStacks; j++) {
+	      freqInd[j] = fBinSearch + floor( (REAL4)(timeDiffV->data[j]*n*dfdot/deltaF) + 0.5f);
+	    }
 	  }
 
-	  TRY( LocalHOUGHConstructHMT_W(status->statusPtr, &ht, &freqInd, &phmdVS),status );
+	  TRY( LocalHOUGHConstructHMTVector_W(status->statusPtr, &htV, &freqIndVS, &phmdVS), status );
 
-	  /* get candidates */
-	  if ( params->useToplist ) {
-	    TRY(GetHoughCandidates_toplist( status->statusPtr, houghToplist, &ht, &patch, &parDem), status);
-	  }
-	  else {
-	    TRY(GetHoughCandidates_threshold( status->statusPtr, out, &ht, &patch, &parDem, params->threshold), status);
-	  }
-	  
-	} /* end loop over spindown trajectories */
+	  /*loop over the residual spindowns of this block, in order */
+	  for (k=0; k<htV.length; k++) {
+
+	    n = nBlock + (INT4)k;
+	    ht.spinRes.data[0] =  n*dfdot; 
+	    ht.map = htV.ht[k].map;
+
+	    /* get candidates */
+	    if ( params->useToplist ) {
+	      TRY(GetHoughCandidates_toplist( status->statusPtr, houghToplist, &ht, &patch, &parDem), status);
+	    }
+	    else {
+	      TRY(GetHoughCandidates_threshold( status->statusPtr, out, &ht, &patch, &parDem, params->threshold), status);
+	    }
+
+	  } /* end loop over spindown trajectories */
+
+	} /* end loop over blocks of spindowns */
 
       } /* end of block for calculating total hough maps */
       
@@ -502,7 +549,7 @@ LocalComputeFstatHoughMap (LALStatus            *status,
     /*--------------  Free partial memory -----------------*/
     LALFree(patch.xCoor);
     LALFree(patch.yCoor);
-    LALFree(ht.map);
+    LALFree(htV.ht[0].map);
 
     for (j=0; j<lutV.length ; ++j){
       for (i=0; i<maxNBorders; ++i){
@@ -526,7 +573,11 @@ LocalComputeFstatHoughMap (LALStatus            *status,
   LALFree(ht.dFdot.data);
   LALFree(lutV.lut);
   LALFree(phmdVS.phmd);
-  LALFree(freqInd.data);
+  for (k=0; k<nMapsMax; k++) {
+    LALFree(freqIndVS.freqIndV[k].data);
+  }
+  LALFree(freqIndVS.freqIndV);
+  LALFree(htV.ht);
   LALFree(parDem.spin.data);
 
   TRY( LALDDestroyVector( status->statusPtr, &timeDiffV), status);
@@ -651,6 +702,52 @@ LocalHOUGHConstructHMT_W (LALStatus                  *status, /**< LAL status po
 
 
 
+/* this function is identical to LALHOUGHConstructHMTVector in DriveHough.c
+   with weights, except for that it calls LocalHOUGHConstructHMT_W
+*/
+static void
+LocalHOUGHConstructHMTVector_W (LALStatus                         *status,    /**< LAL status pointer */
+				HOUGHMapTotalVector               *htV,       /**< The output hough maps */
+				UINT8FrequencyIndexVectorSequence *freqIndVS, /**< time-frequency trajectories */
+				PHMDVectorSequence                *phmdVS)    /**< set of partial hough map derivatives */
+{
+  INT4 n, nMaps;
+  INT4 nFailed = 0;
+
+  INITSTATUS(status);
+  ATTATCHSTATUSPTR (status);
+
+  ASSERT (htV,       status, LALHOUGHH_ENULL, LALHOUGHH_MSGENULL);
+  ASSERT (freqIndVS, status, LALHOUGHH_ENULL, LALHOUGHH_MSGENULL);
+  ASSERT (htV->length == freqIndVS->length, status,
+	  LALHOUGHH_ESZMM, LALHOUGHH_MSGESZMM);
+
+  nMaps = htV->length;
+
+#pragma omp parallel for schedule(dynamic)
+  for ( n=0; n<nMaps; ++n ){
+    LALStatus threadStatus;
+    memset(&threadStatus, 0, sizeof(threadStatus));
+    LocalHOUGHConstructHMT_W(&threadStatus, &(htV->ht[n]), &(freqIndVS->freqIndV[n]), phmdVS);
+    if ( threadStatus.statusCode ) {
+#pragma omp atomic
+      ++nFailed;
+      if ( threadStatus.statusPtr ) {
+	FREESTATUSPTR(&threadStatus);
+      }
+    }
+  }
+
+  if ( nFailed ) {
+    ABORT( status, LALHOUGHH_EVAL, LALHOUGHH_MSGEVAL);
+  }
+
+  DETATCHSTATUSPTR (status);
+  RETURN (status);
+}
+
+
+
 /* this function is derived from LALHOUGHAddPHMD2HD_W in HoughMap.c.
    The two originally almost identical loops were put into the inline function
    LocalHOUGHAddPHMD2HD_Wlr() that is augmented with prefetching code to
@@ -45,6 +45,7 @@
 #include "antenna.h"
 #include "templates.h"
 #include "TwoSpect.h"
+#include "secondFFT.h"
 #include "statistics.h"
 #include "upperlimits.h"
 #include "vectormath.h"
@@ -485,9 +486,12 @@ int main( int argc, char *argv[] )
   XLAL_CHECK( ( ihsCandidates = createcandidateVector( 100 ) ) != NULL, XLAL_EFUNC, "createCandidateVector(%d) failed\n", 100 );
   XLAL_CHECK( ( upperlimits = createUpperLimitVector( 1 ) ) != NULL, XLAL_EFUNC, "createUpperLimitVector(%d) failed.\n", 1 );
 
-  //Initialize second FFT plan
+  //Initialize second FFT plans: single transforms for templates and noise estimates, and all frequency bins of the TF plane at once
+  //These are shared by the IHS, candidate and upper limit stages for every sky location
   REAL4FFTPlan *secondFFTplan = NULL;
+  secondFFTBatchPlan *secondFFTbatch = NULL;
   XLAL_CHECK( ( secondFFTplan = XLALCreateForwardREAL4FFTPlan( ffdata->numffts, uvar.FFTplanFlag ) ) != NULL, XLAL_EFUNC );
+  XLAL_CHECK( ( secondFFTbatch = createSecondFFTBatchPlan( ffdata, uvar.FFTplanFlag ) ) != NULL, XLAL_EFUNC );
 
   //Initialize aveNoise and binshifts vectors
   REAL4VectorAligned *aveNoise = NULL;
@@ -800,7 +804,7 @@ int main( int argc, char *argv[] )
     XLALDestroyREAL4VectorAligned( backgroundScaling_slided );
 
     //Do the second FFT
-    XLAL_CHECK( makeSecondFFT( ffdata, TFdata_weighted, secondFFTplan ) == XLAL_SUCCESS, XLAL_EFUNC );
+    XLAL_CHECK( makeSecondFFT( ffdata, TFdata_weighted, secondFFTbatch ) == XLAL_SUCCESS, XLAL_EFUNC );
     //Normalize according to LAL PSD spec (also done in ffPlaneNoise() so this doesn't change anything)
     //There is a secret divide by numffts in the weighting of the TF data (sumofweights), so we don't need to do it here;
     //the numffts divisor gets squared when taking the PSD, so it is not applied here
@@ -964,7 +968,7 @@ int main( int argc, char *argv[] )
     //Search the candidates further if the number of candidates passing the first Gaussian template test is greater than 0
     if ( gaussCandidates1->numofcandidates > 0 ) {
       //Start clustering! Note that the clustering algorithm takes care of the period range of parameter space
-      XLAL_CHECK( clusterCandidates( &gaussCandidates2, gaussCandidates1, ffdata, &uvar, aveNoise, aveTFnoisePerFbinRatio, rng, 0 ) == XLAL_SUCCESS, XLAL_EFUNC );
+      XLAL_CHECK( clusterCandidates( &gaussCandidates2, gaussCandidates1, ffdata, &uvar, aveNoise, aveTFnoisePerFbinRatio, secondFFTplan, rng, 0 ) == XLAL_SUCCESS, XLAL_EFUNC );
 
       for ( ii = 0; ii < ( INT4 )gaussCandidates2->numofcandidates; ii++ ) {
         fprintf( stderr, "Candidate %d: f0=%g, P=%g, df=%g\n", ii, gaussCandidates2->data[ii].fsig, gaussCandidates2->data[ii].period, gaussCandidates2->data[ii].moddepth );
@@ -997,7 +1001,7 @@ int main( int argc, char *argv[] )
       gaussCandidates2->numofcandidates = 0;
 
       //Start clustering!
-      XLAL_CHECK( clusterCandidates( &gaussCandidates4, gaussCandidates3, ffdata, &uvar, aveNoise, aveTFnoisePerFbinRatio, rng, 0 ) == XLAL_SUCCESS, XLAL_EFUNC );
+      XLAL_CHECK( clusterCandidates( &gaussCandidates4, gaussCandidates3, ffdata, &uvar, aveNoise, aveTFnoisePerFbinRatio, secondFFTplan, rng, 0 ) == XLAL_SUCCESS, XLAL_EFUNC );
 
       for ( ii = 0; ii < ( INT4 )gaussCandidates4->numofcandidates; ii++ ) {
         fprintf( stderr, "Candidate %d: f0=%g, P=%g, df=%g\n", ii, gaussCandidates4->data[ii].fsig, gaussCandidates4->data[ii].period, gaussCandidates4->data[ii].moddepth );
@@ -1145,6 +1149,7 @@ int main( int argc, char *argv[] )
   destroyihsfarStruct( ihsfarstruct );
   destroyihsMaxima( ihsmaxima );
   XLALDestroyREAL4FFTPlan( secondFFTplan );
+  destroySecondFFTBatchPlan( secondFFTbatch );
   XLALDestroyEphemerisData( edat );
   XLALDestroyUserVars();
   XLALDestroyCHARVector( ULFILENAME );
@@ -1425,76 +1430,6 @@ REAL4VectorAligned *calcAveTFnoisePerFbinRatio( const REAL4VectorAligned *backgr
   return aveTFnoisePerFbinRatio;
 }
 
-/**
- * Compute the second Fourier transform for TwoSpect
- * \param [out] output Pointer to the ffdataStruct to the containers for the second FFT
- * \param [in]  tfdata Pointer REAL4VectorAligned of mean subtracted and weighted data
- * \param [in]  plan   Pointer to REAL4FFTPlan
- * \return Status value
- */
-INT4 makeSecondFFT( ffdataStruct *output, REAL4VectorAligned *tfdata, const REAL4FFTPlan *plan )
-{
-
-  XLAL_CHECK( output != NULL && tfdata != NULL && plan != NULL, XLAL_EINVAL );
-
-  fprintf( stderr, "Computing second FFT over SFTs... " );
-
-  REAL8 winFactor = 8.0 / 3.0;
-
-  //Do the second FFT
-  REAL4VectorAligned *x = NULL, *psd = NULL, *windowData = NULL;
-  REAL4Window *win = NULL;
-  XLAL_CHECK( ( x = XLALCreateREAL4VectorAligned( output->numffts, 32 ) ) != NULL, XLAL_EFUNC );
-  XLAL_CHECK( ( psd = XLALCreateREAL4VectorAligned( ( UINT4 )floor( x->length * 0.5 ) + 1, 32 ) ) != NULL, XLAL_EFUNC );
-  XLAL_CHECK( ( win = XLALCreateHannREAL4Window( x->length ) ) != NULL, XLAL_EFUNC );
-  XLAL_CHECK( ( windowData = XLALCreateREAL4VectorAligned( win->data->length, 32 ) ) != NULL, XLAL_EFUNC );
-  memcpy( windowData->data, win->data->data, sizeof( REAL4 )*windowData->length );
-
-  for ( INT4 ii = 0; ii < output->numfbins; ii++ ) {
-
-    //Next, loop over times and pick the right frequency bin for each FFT and window
-    //for (UINT4 jj=0; jj<x->length; jj++) x->data[jj] = tfdata->data[ii + jj*output->numfbins] * win->data->data[jj];
-    //fastSSVectorMultiply_with_stride_and_offset(x, tfdata, windowData, output->numfbins, 1, ii, 0);
-    for ( UINT4 jj = 0; jj < x->length; jj++ ) {
-      x->data[jj] = tfdata->data[ii + jj * output->numfbins];
-    }
-    XLAL_CHECK( XLALVectorMultiplyREAL4( x->data, x->data, windowData->data, x->length ) == XLAL_SUCCESS, XLAL_EFUNC );
-
-    //Make the FFT
-    XLAL_CHECK( XLALREAL4PowerSpectrum( ( REAL4Vector * )psd, ( REAL4Vector * )x, plan ) == XLAL_SUCCESS, XLAL_EFUNC );
-
-    //Fix beginning and end values if even, otherwise just the beginning if odd
-    if ( GSL_IS_EVEN( x->length ) == 1 ) {
-      psd->data[0] *= 2.0;
-      psd->data[psd->length - 1] *= 2.0;
-    } else {
-      psd->data[0] *= 2.0;
-    }
-
-    //Scale the data points by 1/N and window factor and (1/fs)
-    //Order of vector is by second frequency then first frequency
-    //It is possible that when dealing with very loud signals, lines, injections, etc. (e.g., far above the background)
-    //then the output power here can be "rounded" because of the cast to nearby integer values.
-    //For high (but not too high) power values, this may not be noticed because the cast can round to nearby decimal values.
-    for ( UINT4 jj = 0; jj < psd->length; jj++ ) {
-      output->ffdata->data[psd->length * ii + jj] = ( REAL4 )( psd->data[jj] * winFactor * output->ffnormalization );
-    }
-
-  } /* for ii < numfbins */
-
-  //Destroy stuff
-  XLALDestroyREAL4VectorAligned( x );
-  XLALDestroyREAL4VectorAligned( psd );
-  XLALDestroyREAL4VectorAligned( windowData );
-  XLALDestroyREAL4Window( win );
-
-  fprintf( stderr, "done\n" );
-
-  return XLAL_SUCCESS;
-
-} /* makeSecondFFT() */
-
-
 /**
  * Determine the average of the noise power in each frequency bin across the band
  * \param [in] backgrnd Pointer to REAL4VectorAligned of the running mean values
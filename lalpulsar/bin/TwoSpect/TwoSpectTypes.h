@@ -28,6 +28,8 @@
 
 #include <gsl/gsl_rng.h>
 
+#include <fftw3.h>
+
 extern FILE *LOG;
 
 typedef struct {
@@ -155,6 +157,15 @@ typedef struct {
   INT4 numfprbins;
 } ffdataStruct;
 
+typedef struct {
+  fftwf_plan plan;                //Single FFTW plan transforming every frequency bin of the TF plane at once
+  REAL4VectorAligned *windowData; //Hann window in time
+  REAL4VectorAligned *tfdata;     //Windowed TF data, same layout as the weighted TF plane (time-major)
+  REAL4VectorAligned *hcdata;     //Half-complex transforms, numffts values per frequency bin
+  INT4 numffts;
+  INT4 numfbins;
+} secondFFTBatchPlan;
+
 typedef struct {
   REAL8 fsig; /* 0 value means candidate not valid */
   REAL8 period;
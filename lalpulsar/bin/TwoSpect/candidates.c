@@ -24,6 +24,9 @@
 #include "falsealarm.h"
 #include "templates.h"
 
+//Number of templates made and evaluated together by several threads before their significance is computed
+#define TEMPLATEBLOCKSIZE 64
+
 /**
  * Allocate a candidateVector
  * \param [in] length Length of the candidateVector
@@ -237,6 +240,57 @@ INT4 analyzeCandidatesTemplateFromVector( candidateVector *output, const candida
   return XLAL_SUCCESS;
 }
 
+/**
+ * Make the templates for a block of trial points and compute their R statistic values
+ *
+ * The templates are made and evaluated by several threads at once; the FFT plan is only executed, never
+ * modified, so it can be shared. Random numbers are not used here, so the significance of each template can
+ * afterwards be computed in the original order.
+ * \param [out] R                      Pointer to array of numcands R statistic values
+ * \param [out] templates              Pointer to array of numcands TwoSpectTemplate pointers (allocated by the caller)
+ * \param [in]  cands                  Pointer to array of numcands trial candidates
+ * \param [in]  numcands               Number of trial candidates in the block
+ * \param [in]  params                 Pointer to UserInput_t
+ * \param [in]  ffdata                 Pointer to REAL4VectorAligned of the 2nd FFT data
+ * \param [in]  aveNoise               Pointer to REAL4VectorAligned of 2nd FFT background powers
+ * \param [in]  aveTFnoisePerFbinRatio Pointer to REAL4VectorAligned of normalized power across the frequency band
+ * \param [in]  plan                   Pointer to REAL4FFTPlan (may be NULL for Gaussian templates)
+ * \param [in]  useExactTemplates      Boolean of 0 (use Gaussian templates) or 1 (use exact templates)
+ * \return Status value
+ */
+INT4 calculateRForTemplateBlock( REAL8 *R, TwoSpectTemplate **templates, const candidate *cands, const UINT4 numcands, const UserInput_t *params, const REAL4VectorAligned *ffdata, const REAL4VectorAligned *aveNoise, const REAL4VectorAligned *aveTFnoisePerFbinRatio, const REAL4FFTPlan *plan, const BOOLEAN useExactTemplates )
+{
+
+  XLAL_CHECK( R != NULL && templates != NULL && cands != NULL && params != NULL && ffdata != NULL && aveNoise != NULL && aveTFnoisePerFbinRatio != NULL && ( plan != NULL || !useExactTemplates ), XLAL_EINVAL );
+
+  INT4 numfailed = 0;
+  #pragma omp parallel for schedule(dynamic)
+  for ( INT4 ii = 0; ii < ( INT4 )numcands; ii++ ) {
+    INT4 status;
+    resetTwoSpectTemplate( templates[ii] );
+    if ( useExactTemplates ) {
+      status = makeTemplate( templates[ii], cands[ii], params, plan );
+    } else {
+      status = makeTemplateGaussians( templates[ii], cands[ii], params );
+    }
+    if ( status == XLAL_SUCCESS ) {
+      R[ii] = calculateR( ffdata, templates[ii], aveNoise, aveTFnoisePerFbinRatio );
+      if ( xlalErrno != 0 ) {
+        status = XLAL_FAILURE;
+      }
+    }
+    if ( status != XLAL_SUCCESS ) {
+      #pragma omp atomic
+      numfailed++;
+    }
+  } /* for ii < numcands */
+  XLAL_CHECK( numfailed == 0, XLAL_EFUNC, "Failed to make or evaluate %d of %u templates\n", numfailed, numcands );
+
+  return XLAL_SUCCESS;
+
+} /* calculateRForTemplateBlock() */
+
+
 /**
  * A brute force template search to find the most significant template around a candidate
  * \param [out] output                 Pointer to candidate structure
@@ -304,16 +358,9 @@ INT4 bruteForceTemplateSearch( candidate *output, const candidate input, const T
   XLAL_CHECK( ( trialp = XLALCreateREAL8Vector( search.numperiodslonger + search.numperiodsshorter + 1 ) ) != NULL, XLAL_EFUNC );
 
   //Now search over the parameter space. Frequency, then modulation depth, then period
-  //Initialze best values as the initial point we are searching around
-  INT4 bestproberrcode = 0;
-  REAL8 bestf = 0.0, bestp = 0.0, bestdf = 0.0, bestR = 0.0, besth0 = 0.0, bestProb = 0.0;
-  candidate cand;
-  TwoSpectTemplate *template = NULL;
-  XLAL_CHECK( ( template = createTwoSpectTemplate( params->maxTemplateLength ) ) != NULL, XLAL_EFUNC );
-  farStruct *farval = NULL;
-  if ( params->calcRthreshold ) {
-    XLAL_CHECK( ( farval = createfarStruct() ) != NULL, XLAL_EFUNC );
-  }
+  //First collect the trial points within the boundaries, in search order
+  candidateVector *trials = NULL;
+  XLAL_CHECK( ( trials = createcandidateVector( 100 ) ) != NULL, XLAL_EFUNC );
 
   INT4 startposition = search.numperiodsshorter, proberrcode = 0;
   //Search over frequency
@@ -348,51 +395,16 @@ INT4 bruteForceTemplateSearch( candidate *output, const candidate input, const T
              trialp->data[kk] <= params->Pmax &&
              trialp->data[kk] >= params->Pmin ) {
 
-          loadCandidateData( &cand, trialf->data[ii], trialp->data[kk], trialb->data[jj], input.ra, input.dec, 0, 0, 0.0, 0, 0.0, -1, 0 );
-
-          resetTwoSpectTemplate( template );
-
-          if ( useExactTemplates ) {
-            XLAL_CHECK( makeTemplate( template, cand, params, secondFFTplan ) == XLAL_SUCCESS, XLAL_EFUNC );
-          } else {
-            XLAL_CHECK( makeTemplateGaussians( template, cand, params ) == XLAL_SUCCESS, XLAL_EFUNC );
-          }
-
-          if ( params->calcRthreshold && bestProb == 0.0 ) {
-            XLAL_CHECK( numericFAR( farval, template, params->tmplfar, aveNoise, aveTFnoisePerFbinRatio, params, rng, params->BrentsMethod ) == XLAL_SUCCESS, XLAL_EFUNC );
-          }
-
-          REAL8 R = calculateR( ffdata, template, aveNoise, aveTFnoisePerFbinRatio );
-          XLAL_CHECK( xlalErrno == 0, XLAL_EFUNC );
-          REAL8 prob = probR( template, aveNoise, aveTFnoisePerFbinRatio, R, params, rng, &proberrcode );
-          XLAL_CHECK( xlalErrno == 0, XLAL_EFUNC );
-          REAL8 h0 = 0.0;
-          if ( R > 0.0 ) {
-            h0 = 2.7426 * pow( R / ( params->Tsft * params->Tobs ), 0.25 );
-          }
-
-          //fprintf(stderr, "%.8g %.9g %g %.14g\n", trialf->data[ii], trialp->data[kk], trialb->data[jj], R);
-
-          if ( ( bestProb != 0.0 && prob < bestProb ) || ( bestProb == 0.0 && !params->calcRthreshold && prob < log10templatefar ) || ( bestProb == 0.0 && params->calcRthreshold && R > farval->far ) ) {
-            bestf = trialf->data[ii];
-            bestp = trialp->data[kk];
-            bestdf = trialb->data[jj];
-            bestR = R;
-            besth0 = h0;
-            bestProb = prob;
-            bestproberrcode = proberrcode;
+          if ( trials->numofcandidates == trials->length - 1 ) {
+            XLAL_CHECK( ( trials = resizecandidateVector( trials, 2 * trials->length ) ) != NULL, XLAL_EFUNC );
           }
+          loadCandidateData( &( trials->data[trials->numofcandidates] ), trialf->data[ii], trialp->data[kk], trialb->data[jj], input.ra, input.dec, 0, 0, 0.0, 0, 0.0, -1, 0 );
+          trials->numofcandidates++;
 
         } /* if within boundaries */
       } /* for kk < trialp */
     } /* for jj < trialb */
   } /* for ii < trialf */
-  destroyTwoSpectTemplate( template );
-  template = NULL;
-  if ( params->calcRthreshold ) {
-    destroyfarStruct( farval );
-    farval = NULL;
-  }
   XLALDestroyREAL8Vector( trialf );
   XLALDestroyREAL8Vector( trialb );
   XLALDestroyREAL8Vector( trialp );
@@ -400,6 +412,63 @@ INT4 bruteForceTemplateSearch( candidate *output, const candidate input, const T
   trialb = NULL;
   trialp = NULL;
 
+  //Initialze best values as the initial point we are searching around
+  INT4 bestproberrcode = 0;
+  REAL8 bestf = 0.0, bestp = 0.0, bestdf = 0.0, bestR = 0.0, besth0 = 0.0, bestProb = 0.0;
+  TwoSpectTemplate *templates[TEMPLATEBLOCKSIZE];
+  REAL8 Rvals[TEMPLATEBLOCKSIZE];
+  for ( UINT4 ii = 0; ii < TEMPLATEBLOCKSIZE; ii++ ) {
+    XLAL_CHECK( ( templates[ii] = createTwoSpectTemplate( params->maxTemplateLength ) ) != NULL, XLAL_EFUNC );
+  }
+  farStruct *farval = NULL;
+  if ( params->calcRthreshold ) {
+    XLAL_CHECK( ( farval = createfarStruct() ) != NULL, XLAL_EFUNC );
+  }
+
+  //Templates and R values are computed a block at a time by several threads, then the significance and the best template
+  //are determined in the original search order so that the random number sequence is the same as for a serial search
+  for ( UINT4 first = 0; first < trials->numofcandidates; first += TEMPLATEBLOCKSIZE ) {
+    UINT4 blocklength = trials->numofcandidates - first;
+    if ( blocklength > TEMPLATEBLOCKSIZE ) {
+      blocklength = TEMPLATEBLOCKSIZE;
+    }
+    XLAL_CHECK( calculateRForTemplateBlock( Rvals, templates, &( trials->data[first] ), blocklength, params, ffdata, aveNoise, aveTFnoisePerFbinRatio, secondFFTplan, useExactTemplates ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+    for ( UINT4 ii = 0; ii < blocklength; ii++ ) {
+      const candidate *cand = &( trials->data[first + ii] );
+
+      if ( params->calcRthreshold && bestProb == 0.0 ) {
+        XLAL_CHECK( numericFAR( farval, templates[ii], params->tmplfar, aveNoise, aveTFnoisePerFbinRatio, params, rng, params->BrentsMethod ) == XLAL_SUCCESS, XLAL_EFUNC );
+      }
+
+      REAL8 R = Rvals[ii];
+      REAL8 prob = probR( templates[ii], aveNoise, aveTFnoisePerFbinRatio, R, params, rng, &proberrcode );
+      XLAL_CHECK( xlalErrno == 0, XLAL_EFUNC );
+      REAL8 h0 = 0.0;
+      if ( R > 0.0 ) {
+        h0 = 2.7426 * pow( R / ( params->Tsft * params->Tobs ), 0.25 );
+      }
+
+      if ( ( bestProb != 0.0 && prob < bestProb ) || ( bestProb == 0.0 && !params->calcRthreshold && prob < log10templatefar ) || ( bestProb == 0.0 && params->calcRthreshold && R > farval->far ) ) {
+        bestf = cand->fsig;
+        bestp = cand->period;
+        bestdf = cand->moddepth;
+        bestR = R;
+        besth0 = h0;
+        bestProb = prob;
+        bestproberrcode = proberrcode;
+      }
+    } /* for ii < blocklength */
+  } /* for first < trials->numofcandidates */
+  for ( UINT4 ii = 0; ii < TEMPLATEBLOCKSIZE; ii++ ) {
+    destroyTwoSpectTemplate( templates[ii] );
+  }
+  if ( params->calcRthreshold ) {
+    destroyfarStruct( farval );
+    farval = NULL;
+  }
+  destroycandidateVector( trials );
+
   if ( bestProb == 0.0 ) {
     loadCandidateData( output, input.fsig, input.period, input.moddepth, input.ra, input.dec, input.stat, input.h0, input.prob, input.proberrcode, input.normalization, input.templateVectorIndex, input.lineContamination );
   } else {
@@ -475,9 +544,9 @@ INT4 bruteForceTemplateTest( candidateVector **output, const candidate input, co
   XLAL_CHECK( ( trialp = XLALCreateREAL8Vector( search.numperiodslonger + search.numperiodsshorter + 1 ) ) != NULL, XLAL_EFUNC );
 
   //Now search over the parameter space. Frequency, then modulation depth, then period
-  candidate cand;
-  TwoSpectTemplate *template = NULL;
-  XLAL_CHECK( ( template = createTwoSpectTemplate( params->maxTemplateLength ) ) != NULL, XLAL_EFUNC );
+  //First collect the trial points within the boundaries, in search order
+  candidateVector *trials = NULL;
+  XLAL_CHECK( ( trials = createcandidateVector( 100 ) ) != NULL, XLAL_EFUNC );
 
   INT4 startposition = search.numperiodsshorter, proberrcode = 0;
   //Search over frequency
@@ -512,42 +581,60 @@ INT4 bruteForceTemplateTest( candidateVector **output, const candidate input, co
              trialp->data[kk] <= params->Pmax &&
              trialp->data[kk] >= params->Pmin ) {
 
-          loadCandidateData( &cand, trialf->data[ii], trialp->data[kk], trialb->data[jj], input.ra, input.dec, 0, 0, 0.0, 0, 0.0, -1, 0 );
-
-          resetTwoSpectTemplate( template );
-
-          if ( useExactTemplates ) {
-            XLAL_CHECK( makeTemplate( template, cand, params, secondFFTplan ) == XLAL_SUCCESS, XLAL_EFUNC );
-          } else {
-            XLAL_CHECK( makeTemplateGaussians( template, cand, params ) == XLAL_SUCCESS, XLAL_EFUNC );
+          if ( trials->numofcandidates == trials->length - 1 ) {
+            XLAL_CHECK( ( trials = resizecandidateVector( trials, 2 * trials->length ) ) != NULL, XLAL_EFUNC );
           }
-
-          REAL8 R = calculateR( ffdata, template, aveNoise, aveTFnoisePerFbinRatio );
-          XLAL_CHECK( xlalErrno == 0, XLAL_EFUNC );
-          REAL8 prob = probR( template, aveNoise, aveTFnoisePerFbinRatio, R, params, rng, &proberrcode );
-          XLAL_CHECK( xlalErrno == 0, XLAL_EFUNC );
-          REAL8 h0 = 0.0;
-          if ( R > 0.0 ) {
-            h0 = 2.7426 * pow( R / ( params->Tsft * params->Tobs ), 0.25 );
-          }
-
-          //Resize the output candidate vector if necessary
-          if ( ( *output )->numofcandidates == ( *output )->length - 1 ) {
-            XLAL_CHECK( ( *output = resizecandidateVector( *output, 2 * ( *output )->length ) ) != NULL, XLAL_EFUNC );
-          }
-
-          loadCandidateData( &( ( *output )->data[( *output )->numofcandidates] ), trialf->data[ii], trialp->data[kk], trialb->data[jj], input.ra, input.dec, R, h0, prob, proberrcode, input.normalization, input.templateVectorIndex, input.lineContamination );
-          ( *output )->numofcandidates++;
+          loadCandidateData( &( trials->data[trials->numofcandidates] ), trialf->data[ii], trialp->data[kk], trialb->data[jj], input.ra, input.dec, 0, 0, 0.0, 0, 0.0, -1, 0 );
+          trials->numofcandidates++;
 
         } /* if within boundaries */
       } /* for kk < trialp */
     } /* for jj < trialb */
   } /* for ii < trialf */
-  destroyTwoSpectTemplate( template );
   XLALDestroyREAL8Vector( trialf );
   XLALDestroyREAL8Vector( trialb );
   XLALDestroyREAL8Vector( trialp );
 
+  TwoSpectTemplate *templates[TEMPLATEBLOCKSIZE];
+  REAL8 Rvals[TEMPLATEBLOCKSIZE];
+  for ( UINT4 ii = 0; ii < TEMPLATEBLOCKSIZE; ii++ ) {
+    XLAL_CHECK( ( templates[ii] = createTwoSpectTemplate( params->maxTemplateLength ) ) != NULL, XLAL_EFUNC );
+  }
+
+  //Templates and R values are computed a block at a time by several threads, then the significance is computed
+  //in the original search order so that the random number sequence is the same as for a serial search
+  for ( UINT4 first = 0; first < trials->numofcandidates; first += TEMPLATEBLOCKSIZE ) {
+    UINT4 blocklength = trials->numofcandidates - first;
+    if ( blocklength > TEMPLATEBLOCKSIZE ) {
+      blocklength = TEMPLATEBLOCKSIZE;
+    }
+    XLAL_CHECK( calculateRForTemplateBlock( Rvals, templates, &( trials->data[first] ), blocklength, params, ffdata, aveNoise, aveTFnoisePerFbinRatio, secondFFTplan, useExactTemplates ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+    for ( UINT4 ii = 0; ii < blocklength; ii++ ) {
+      const candidate *cand = &( trials->data[first + ii] );
+
+      REAL8 R = Rvals[ii];
+      REAL8 prob = probR( templates[ii], aveNoise, aveTFnoisePerFbinRatio, R, params, rng, &proberrcode );
+      XLAL_CHECK( xlalErrno == 0, XLAL_EFUNC );
+      REAL8 h0 = 0.0;
+      if ( R > 0.0 ) {
+        h0 = 2.7426 * pow( R / ( params->Tsft * params->Tobs ), 0.25 );
+      }
+
+      //Resize the output candidate vector if necessary
+      if ( ( *output )->numofcandidates == ( *output )->length - 1 ) {
+        XLAL_CHECK( ( *output = resizecandidateVector( *output, 2 * ( *output )->length ) ) != NULL, XLAL_EFUNC );
+      }
+
+      loadCandidateData( &( ( *output )->data[( *output )->numofcandidates] ), cand->fsig, cand->period, cand->moddepth, input.ra, input.dec, R, h0, prob, proberrcode, input.normalization, input.templateVectorIndex, input.lineContamination );
+      ( *output )->numofcandidates++;
+    } /* for ii < blocklength */
+  } /* for first < trials->numofcandidates */
+  for ( UINT4 ii = 0; ii < TEMPLATEBLOCKSIZE; ii++ ) {
+    destroyTwoSpectTemplate( templates[ii] );
+  }
+  destroycandidateVector( trials );
+
   return XLAL_SUCCESS;
 
 }
@@ -591,10 +678,9 @@ INT4 templateSearch_scox1Style( candidateVector **output, const REAL8 fminimum,
   }
 
   //Now search over the frequencies
-  INT4 proberrcode = 0;
-  candidate cand;
-  TwoSpectTemplate *template = NULL;
-  XLAL_CHECK( ( template = createTwoSpectTemplate( params->maxTemplateLength ) ) != NULL, XLAL_EFUNC );
+  //First collect the trial points and their line contamination, in search order
+  candidateVector *trials = NULL;
+  XLAL_CHECK( ( trials = createcandidateVector( 100 ) ) != NULL, XLAL_EFUNC );
 
   //Search over frequency
   for ( UINT4 ii = 0; ii < trialf->length; ii++ ) {
@@ -638,27 +724,6 @@ INT4 templateSearch_scox1Style( candidateVector **output, const REAL8 fminimum,
       //Determine modulation depth
       //REAL8 moddepth = 0.8727*(trialf->data[ii]/1000.0)*(7200.0/period)*asini;
 
-      //load candidate
-      //printf(stderr,"Loading candidate. Remember to get the RA and dec from outside in production run\n");
-      loadCandidateData( &cand, trialf->data[ii], period, trialdf->data[jj], skypos.longitude, skypos.latitude, 0, 0, 0.0, 0, 0.0, -1, 0 );
-
-      //Make the template
-      resetTwoSpectTemplate( template );
-      if ( useExactTemplates != 0 ) {
-        XLAL_CHECK( makeTemplate( template, cand, params, secondFFTplan ) == XLAL_SUCCESS, XLAL_EFUNC );
-      } else {
-        XLAL_CHECK( makeTemplateGaussians( template, cand, params ) == XLAL_SUCCESS, XLAL_EFUNC );
-      }
-
-      REAL8 R = calculateR( ffdata, template, aveNoise, aveTFnoisePerFbinRatio );
-      XLAL_CHECK( xlalErrno == 0, XLAL_EFUNC );
-      REAL8 prob = probR( template, aveNoise, aveTFnoisePerFbinRatio, R, params, rng, &proberrcode );
-      XLAL_CHECK( xlalErrno == 0, XLAL_EFUNC );
-      REAL8 h0 = 0.0;
-      if ( R > 0.0 ) {
-        h0 = 2.7426 * pow( R / ( params->Tsft * params->Tobs ), 0.25 );
-      }
-
       //Line contamination?
       BOOLEAN lineContamination = 0;
       if ( trackedlines != NULL ) {
@@ -680,23 +745,62 @@ INT4 templateSearch_scox1Style( candidateVector **output, const REAL8 fminimum,
         } // while kk < trackedlines->length && lineContamination==0
       } // if trackedlines != NULL
 
-      //Resize the output candidate vector if necessary
-      if ( ( *output )->numofcandidates == ( *output )->length - 1 ) {
-        *output = resizecandidateVector( *output, 2 * ( ( *output )->length ) );
-        XLAL_CHECK( *output != NULL, XLAL_EFUNC );
+      //load candidate
+      //printf(stderr,"Loading candidate. Remember to get the RA and dec from outside in production run\n");
+      if ( trials->numofcandidates == trials->length - 1 ) {
+        XLAL_CHECK( ( trials = resizecandidateVector( trials, 2 * trials->length ) ) != NULL, XLAL_EFUNC );
       }
-
-      loadCandidateData( &( ( *output )->data[( *output )->numofcandidates] ), trialf->data[ii], period, trialdf->data[jj], skypos.longitude, skypos.latitude, R, h0, prob, proberrcode, 0.0, -1, lineContamination );
-      ( *output )->numofcandidates++;
+      loadCandidateData( &( trials->data[trials->numofcandidates] ), trialf->data[ii], period, trialdf->data[jj], skypos.longitude, skypos.latitude, 0, 0, 0.0, 0, 0.0, -1, lineContamination );
+      trials->numofcandidates++;
     } /* for jj < trialdf */
     XLALDestroyREAL8Vector( trialdf );
     trialdf = NULL;
   } /* for ii < trialf */
-  destroyTwoSpectTemplate( template );
-  template = NULL;
   XLALDestroyREAL8Vector( trialf );
   trialf = NULL;
 
+  TwoSpectTemplate *templates[TEMPLATEBLOCKSIZE];
+  REAL8 Rvals[TEMPLATEBLOCKSIZE];
+  for ( UINT4 ii = 0; ii < TEMPLATEBLOCKSIZE; ii++ ) {
+    XLAL_CHECK( ( templates[ii] = createTwoSpectTemplate( params->maxTemplateLength ) ) != NULL, XLAL_EFUNC );
+  }
+
+  //Templates and R values are computed a block at a time by several threads, then the significance is computed
+  //in the original search order so that the random number sequence is the same as for a serial search
+  INT4 proberrcode = 0;
+  for ( UINT4 first = 0; first < trials->numofcandidates; first += TEMPLATEBLOCKSIZE ) {
+    UINT4 blocklength = trials->numofcandidates - first;
+    if ( blocklength > TEMPLATEBLOCKSIZE ) {
+      blocklength = TEMPLATEBLOCKSIZE;
+    }
+    XLAL_CHECK( calculateRForTemplateBlock( Rvals, templates, &( trials->data[first] ), blocklength, params, ffdata, aveNoise, aveTFnoisePerFbinRatio, secondFFTplan, useExactTemplates ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+    for ( UINT4 ii = 0; ii < blocklength; ii++ ) {
+      const candidate *cand = &( trials->data[first + ii] );
+
+      REAL8 R = Rvals[ii];
+      REAL8 prob = probR( templates[ii], aveNoise, aveTFnoisePerFbinRatio, R, params, rng, &proberrcode );
+      XLAL_CHECK( xlalErrno == 0, XLAL_EFUNC );
+      REAL8 h0 = 0.0;
+      if ( R > 0.0 ) {
+        h0 = 2.7426 * pow( R / ( params->Tsft * params->Tobs ), 0.25 );
+      }
+
+      //Resize the output candidate vector if necessary
+      if ( ( *output )->numofcandidates == ( *output )->length - 1 ) {
+        *output = resizecandidateVector( *output, 2 * ( ( *output )->length ) );
+        XLAL_CHECK( *output != NULL, XLAL_EFUNC );
+      }
+
+      loadCandidateData( &( ( *output )->data[( *output )->numofcandidates] ), cand->fsig, period, cand->moddepth, skypos.longitude, skypos.latitude, R, h0, prob, proberrcode, 0.0, -1, cand->lineContamination );
+      ( *output )->numofcandidates++;
+    } /* for ii < blocklength */
+  } /* for first < trials->numofcandidates */
+  for ( UINT4 ii = 0; ii < TEMPLATEBLOCKSIZE; ii++ ) {
+    destroyTwoSpectTemplate( templates[ii] );
+  }
+  destroycandidateVector( trials );
+
   return XLAL_SUCCESS;
 
 }
@@ -748,10 +852,9 @@ INT4 templateSearch_fixedDf( candidateVector **output, const LALStringVector *df
   }
 
   //Now search over the frequencies
-  INT4 proberrcode = 0;
-  candidate cand;
-  TwoSpectTemplate *template = NULL;
-  XLAL_CHECK( ( template = createTwoSpectTemplate( params->maxTemplateLength ) ) != NULL, XLAL_EFUNC );
+  //First collect the trial points and their line contamination, in search order
+  candidateVector *trials = NULL;
+  XLAL_CHECK( ( trials = createcandidateVector( 100 ) ) != NULL, XLAL_EFUNC );
 
   // loop over dfs
   for ( UINT4 jj = 0; jj < trialdf->length; jj++ ) {
@@ -759,25 +862,6 @@ INT4 templateSearch_fixedDf( candidateVector **output, const LALStringVector *df
     //Search over frequency
     for ( UINT4 ii = 0; ii < trialf->length; ii++ ) {
 
-      loadCandidateData( &cand, trialf->data[ii], period, trialdf->data[jj], skypos.longitude, skypos.latitude, 0, 0, 0.0, 0, 0.0, -1, 0 );
-
-      //Make the template
-      resetTwoSpectTemplate( template );
-      if ( useExactTemplates != 0 ) {
-        XLAL_CHECK( makeTemplate( template, cand, params, secondFFTplan ) == XLAL_SUCCESS, XLAL_EFUNC );
-      } else {
-        XLAL_CHECK( makeTemplateGaussians( template, cand, params ) == XLAL_SUCCESS, XLAL_EFUNC );
-      }
-
-      REAL8 R = calculateR( ffdata, template, aveNoise, aveTFnoisePerFbinRatio );
-      XLAL_CHECK( xlalErrno == 0, XLAL_EFUNC );
-      REAL8 prob = probR( template, aveNoise, aveTFnoisePerFbinRatio, R, params, rng, &proberrcode );
-      XLAL_CHECK( xlalErrno == 0, XLAL_EFUNC );
-      REAL8 h0 = 0.0;
-      if ( R > 0.0 ) {
-        h0 = 2.7426 * pow( R / ( params->Tsft * params->Tobs ), 0.25 );
-      }
-
       //Line contamination?
       BOOLEAN lineContamination = 0;
       if ( trackedlines != NULL ) {
@@ -799,25 +883,62 @@ INT4 templateSearch_fixedDf( candidateVector **output, const LALStringVector *df
         } // while kk < trackedlines->length && lineContamination==0
       } // if trackedlines != NULL
 
-      //Resize the output candidate vector if necessary
-      if ( ( *output )->numofcandidates == ( *output )->length - 1 ) {
-        *output = resizecandidateVector( *output, 2 * ( ( *output )->length ) );
-        XLAL_CHECK( *output != NULL, XLAL_EFUNC );
+      if ( trials->numofcandidates == trials->length - 1 ) {
+        XLAL_CHECK( ( trials = resizecandidateVector( trials, 2 * trials->length ) ) != NULL, XLAL_EFUNC );
       }
-
-      loadCandidateData( &( ( *output )->data[( *output )->numofcandidates] ), trialf->data[ii], period, trialdf->data[jj], skypos.longitude, skypos.latitude, R, h0, prob, proberrcode, 0.0, -1, lineContamination );
-      ( *output )->numofcandidates++;
+      loadCandidateData( &( trials->data[trials->numofcandidates] ), trialf->data[ii], period, trialdf->data[jj], skypos.longitude, skypos.latitude, 0, 0, 0.0, 0, 0.0, -1, lineContamination );
+      trials->numofcandidates++;
 
     } /* for ii < trialf */
   } /* for jj < trialdf */
 
   XLALDestroyREAL8Vector( trialdf );
   trialdf = NULL;
-  destroyTwoSpectTemplate( template );
-  template = NULL;
   XLALDestroyREAL8Vector( trialf );
   trialf = NULL;
 
+  TwoSpectTemplate *templates[TEMPLATEBLOCKSIZE];
+  REAL8 Rvals[TEMPLATEBLOCKSIZE];
+  for ( UINT4 ii = 0; ii < TEMPLATEBLOCKSIZE; ii++ ) {
+    XLAL_CHECK( ( templates[ii] = createTwoSpectTemplate( params->maxTemplateLength ) ) != NULL, XLAL_EFUNC );
+  }
+
+  //Templates and R values are computed a block at a time by several threads, then the significance is computed
+  //in the original search order so that the random number sequence is the same as for a serial search
+  INT4 proberrcode = 0;
+  for ( UINT4 first = 0; first < trials->numofcandidates; first += TEMPLATEBLOCKSIZE ) {
+    UINT4 blocklength = trials->numofcandidates - first;
+    if ( blocklength > TEMPLATEBLOCKSIZE ) {
+      blocklength = TEMPLATEBLOCKSIZE;
+    }
+    XLAL_CHECK( calculateRForTemplateBlock( Rvals, templates, &( trials->data[first] ), blocklength, params, ffdata, aveNoise, aveTFnoisePerFbinRatio, secondFFTplan, useExactTemplates ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+    for ( UINT4 ii = 0; ii < blocklength; ii++ ) {
+      const candidate *cand = &( trials->data[first + ii] );
+
+      REAL8 R = Rvals[ii];
+      REAL8 prob = probR( templates[ii], aveNoise, aveTFnoisePerFbinRatio, R, params, rng, &proberrcode );
+      XLAL_CHECK( xlalErrno == 0, XLAL_EFUNC );
+      REAL8 h0 = 0.0;
+      if ( R > 0.0 ) {
+        h0 = 2.7426 * pow( R / ( params->Tsft * params->Tobs ), 0.25 );
+      }
+
+      //Resize the output candidate vector if necessary
+      if ( ( *output )->numofcandidates == ( *output )->length - 1 ) {
+        *output = resizecandidateVector( *output, 2 * ( ( *output )->length ) );
+        XLAL_CHECK( *output != NULL, XLAL_EFUNC );
+      }
+
+      loadCandidateData( &( ( *output )->data[( *output )->numofcandidates] ), cand->fsig, period, cand->moddepth, skypos.longitude, skypos.latitude, R, h0, prob, proberrcode, 0.0, -1, cand->lineContamination );
+      ( *output )->numofcandidates++;
+    } /* for ii < blocklength */
+  } /* for first < trials->numofcandidates */
+  for ( UINT4 ii = 0; ii < TEMPLATEBLOCKSIZE; ii++ ) {
+    destroyTwoSpectTemplate( templates[ii] );
+  }
+  destroycandidateVector( trials );
+
   return XLAL_SUCCESS;
 
 }
@@ -830,14 +951,15 @@ INT4 templateSearch_fixedDf( candidateVector **output, const LALStringVector *df
  * \param [in]  params        Pointer to UserInput_t
  * \param [in]  ffplanenoise  Pointer to REAL4VectorAligned of 2nd FFT background powers
  * \param [in]  fbinaveratios Pointer to REAL4VectorAligned of normalized SFT background
+ * \param [in]  plan          Pointer to REAL4FFTPlan (may be NULL if exactflag is 0)
  * \param [in]  rng           Pointer to gsl_rng
  * \param [in]  exactflag     Flag to use Gaussian templates (0) or exact templates (1)
  * \return Status value
  */
-INT4 clusterCandidates( candidateVector **output, const candidateVector *input, const ffdataStruct *ffdata, const UserInput_t *params, const REAL4VectorAligned *ffplanenoise, const REAL4VectorAligned *fbinaveratios, const gsl_rng *rng, const BOOLEAN exactflag )
+INT4 clusterCandidates( candidateVector **output, const candidateVector *input, const ffdataStruct *ffdata, const UserInput_t *params, const REAL4VectorAligned *ffplanenoise, const REAL4VectorAligned *fbinaveratios, const REAL4FFTPlan *plan, const gsl_rng *rng, const BOOLEAN exactflag )
 {
 
-  XLAL_CHECK( *output != NULL && input != NULL && ffdata != NULL && params != NULL && ffplanenoise != NULL && fbinaveratios != NULL && rng != NULL, XLAL_EINVAL );
+  XLAL_CHECK( *output != NULL && input != NULL && ffdata != NULL && params != NULL && ffplanenoise != NULL && fbinaveratios != NULL && ( plan != NULL || exactflag != 1 ) && rng != NULL, XLAL_EINVAL );
 
   UINT4 loc, loc2;
   REAL8 avefsig, aveperiod, mindf, maxdf;
@@ -855,12 +977,6 @@ INT4 clusterCandidates( candidateVector **output, const candidateVector *input,
     usedcandidate->data[ii] = 0;
   }
 
-  //Make FFT plan if exactflag is given
-  REAL4FFTPlan *plan = NULL;
-  if ( exactflag == 1 ) {
-    XLAL_CHECK( ( plan = XLALCreateForwardREAL4FFTPlan( ffdata->numffts, 1 ) ) != NULL, XLAL_EFUNC );
-  }
-
   for ( UINT4 ii = 0; ii < input->numofcandidates; ii++ ) {
 
     //Make note of first candidate available
@@ -1035,9 +1151,6 @@ INT4 clusterCandidates( candidateVector **output, const candidateVector *input,
   XLALDestroyINT4Vector( locs );
   XLALDestroyINT4Vector( locs2 );
   XLALDestroyINT4Vector( usedcandidate );
-  if ( exactflag == 1 ) {
-    XLALDestroyREAL4FFTPlan( plan );
-  }
 
   fprintf( stderr, "Clustering done with candidates = %d\n", ( *output )->numofcandidates );
   fprintf( LOG, "Clustering done with candidates = %d\n", ( *output )->numofcandidates );
@@ -1226,8 +1339,11 @@ INT4 testTwoSpectTemplateVector( candidateVector *output, const TwoSpectTemplate
 
   fprintf( stderr, "Testing TwoSpectTemplateVector... " );
 
-  TwoSpectTemplate *template = NULL;
-  XLAL_CHECK( ( template = createTwoSpectTemplate( templateLen ) ) != NULL, XLAL_EFUNC );
+  TwoSpectTemplate *templates[TEMPLATEBLOCKSIZE];
+  REAL8 Rvals[TEMPLATEBLOCKSIZE];
+  for ( UINT4 ii = 0; ii < TEMPLATEBLOCKSIZE; ii++ ) {
+    XLAL_CHECK( ( templates[ii] = createTwoSpectTemplate( templateLen ) ) != NULL, XLAL_EFUNC );
+  }
 
   INT4 proberrcode = 0;
 
@@ -1236,46 +1352,73 @@ INT4 testTwoSpectTemplateVector( candidateVector *output, const TwoSpectTemplate
     XLAL_CHECK( ( RVALS = fopen( params->saveRvalues, "w" ) ) != NULL, XLAL_EIO, "Couldn't open %s for writing", params->saveRvalues );
   }
 
+  //The template vector ends at the first empty template
+  UINT4 numtemplates = 0;
+  while ( numtemplates < templateVec->length && templateVec->data[numtemplates]->templatedata->data[0] != 0.0 ) {
+    numtemplates++;
+  }
+
   UINT4 numfbins = ( UINT4 )round( params->fspan * params->Tsft );
   for ( UINT4 ii = 0; ii < numfbins; ii++ ) {
     REAL8 freq = params->fmin + ii / params->Tsft;
-    for ( UINT4 jj = 0; jj < templateVec->length; jj++ ) {
-      if ( templateVec->data[jj]->templatedata->data[0] == 0.0 ) {
-        break;
+    for ( UINT4 first = 0; first < numtemplates; first += TEMPLATEBLOCKSIZE ) {
+      UINT4 blocklength = numtemplates - first;
+      if ( blocklength > TEMPLATEBLOCKSIZE ) {
+        blocklength = TEMPLATEBLOCKSIZE;
       }
 
-      XLAL_CHECK( convertTemplateForSpecificFbin( template, templateVec->data[jj], freq, params ) == XLAL_SUCCESS, XLAL_EFUNC );
-
-      REAL8 R = calculateR( ffdata->ffdata, template, aveNoise, aveTFnoisePerFbinRatio );
-      XLAL_CHECK( xlalErrno == 0, XLAL_EFUNC );
-      REAL8 prob = 0.0, h0 = 0.0;
-      if ( R > 0.0 ) {
-        prob = probR( template, aveNoise, aveTFnoisePerFbinRatio, R, params, rng, &proberrcode );
-        XLAL_CHECK( xlalErrno == 0, XLAL_EFUNC );
-        h0 = 2.7426 * pow( R / ( params->Tsft * params->Tobs ), 0.25 );
-      }
-
-      if ( XLALUserVarWasSet( &params->saveRvalues ) ) {
-        fprintf( RVALS, "%g\n", R );
+      //Convert a block of templates and compute their R values with several threads
+      INT4 numfailed = 0;
+      #pragma omp parallel for schedule(dynamic)
+      for ( INT4 jj = 0; jj < ( INT4 )blocklength; jj++ ) {
+        if ( convertTemplateForSpecificFbin( templates[jj], templateVec->data[first + jj], freq, params ) != XLAL_SUCCESS ) {
+          #pragma omp atomic
+          numfailed++;
+          continue;
+        }
+        Rvals[jj] = calculateR( ffdata->ffdata, templates[jj], aveNoise, aveTFnoisePerFbinRatio );
+        if ( xlalErrno != 0 ) {
+          #pragma omp atomic
+          numfailed++;
+        }
       }
-
-      if ( prob < output->data[output->length - 1].prob ) {
-        UINT4 insertionPoint = output->length - 1;
-        while ( insertionPoint > 0 && prob < output->data[insertionPoint - 1].prob ) {
-          insertionPoint--;
+      XLAL_CHECK( numfailed == 0, XLAL_EFUNC );
+
+      //Then the significance, in template order so that the random number sequence is unchanged
+      for ( UINT4 jj = 0; jj < blocklength; jj++ ) {
+        const TwoSpectTemplate *template = templates[jj];
+        REAL8 R = Rvals[jj];
+        REAL8 prob = 0.0, h0 = 0.0;
+        if ( R > 0.0 ) {
+          prob = probR( template, aveNoise, aveTFnoisePerFbinRatio, R, params, rng, &proberrcode );
+          XLAL_CHECK( xlalErrno == 0, XLAL_EFUNC );
+          h0 = 2.7426 * pow( R / ( params->Tsft * params->Tobs ), 0.25 );
         }
-        for ( INT4 kk = ( INT4 )output->length - 2; kk >= ( INT4 )insertionPoint; kk-- ) {
-          loadCandidateData( &( output->data[kk + 1] ), output->data[kk].fsig, output->data[kk].period, output->data[kk].moddepth, output->data[kk].ra, output->data[kk].dec, output->data[kk].stat, output->data[kk].h0, output->data[kk].prob, output->data[kk].proberrcode, output->data[kk].normalization, output->data[kk].templateVectorIndex, output->data[kk].lineContamination );
+
+        if ( XLALUserVarWasSet( &params->saveRvalues ) ) {
+          fprintf( RVALS, "%g\n", R );
         }
-        loadCandidateData( &( output->data[insertionPoint] ), template->f0, template->period, template->moddepth, skypos.longitude, skypos.latitude, R, h0, prob, proberrcode, ffdata->tfnormalization, jj, 0 );
-        if ( output->numofcandidates < output->length ) {
-          output->numofcandidates++;
+
+        if ( prob < output->data[output->length - 1].prob ) {
+          UINT4 insertionPoint = output->length - 1;
+          while ( insertionPoint > 0 && prob < output->data[insertionPoint - 1].prob ) {
+            insertionPoint--;
+          }
+          for ( INT4 kk = ( INT4 )output->length - 2; kk >= ( INT4 )insertionPoint; kk-- ) {
+            loadCandidateData( &( output->data[kk + 1] ), output->data[kk].fsig, output->data[kk].period, output->data[kk].moddepth, output->data[kk].ra, output->data[kk].dec, output->data[kk].stat, output->data[kk].h0, output->data[kk].prob, output->data[kk].proberrcode, output->data[kk].normalization, output->data[kk].templateVectorIndex, output->data[kk].lineContamination );
+          }
+          loadCandidateData( &( output->data[insertionPoint] ), template->f0, template->period, template->moddepth, skypos.longitude, skypos.latitude, R, h0, prob, proberrcode, ffdata->tfnormalization, first + jj, 0 );
+          if ( output->numofcandidates < output->length ) {
+            output->numofcandidates++;
+          }
         }
-      }
-    }
-  }
+      } /* for jj < blocklength */
+    } /* for first < numtemplates */
+  } /* for ii < numfbins */
 
-  destroyTwoSpectTemplate( template );
+  for ( UINT4 ii = 0; ii < TEMPLATEBLOCKSIZE; ii++ ) {
+    destroyTwoSpectTemplate( templates[ii] );
+  }
 
   if ( XLALUserVarWasSet( &params->saveRvalues ) ) {
     fclose( RVALS );
@@ -51,6 +51,16 @@ INT4 analyzeOneTemplate( candidate *output,
                          const REAL4FFTPlan *plan,
                          const gsl_rng *rng,
                          const BOOLEAN exactflag );
+INT4 calculateRForTemplateBlock( REAL8 *R,
+                                 TwoSpectTemplate **templates,
+                                 const candidate *cands,
+                                 const UINT4 numcands,
+                                 const UserInput_t *params,
+                                 const REAL4VectorAligned *ffdata,
+                                 const REAL4VectorAligned *aveNoise,
+                                 const REAL4VectorAligned *aveTFnoisePerFbinRatio,
+                                 const REAL4FFTPlan *plan,
+                                 const BOOLEAN useExactTemplates );
 INT4 bruteForceTemplateSearch( candidate *output,
                                const candidate input,
                                const TwoSpectParamSpaceSearchVals *paramspace,
@@ -106,6 +116,7 @@ INT4 clusterCandidates( candidateVector **output,
                         const UserInput_t *params,
                         const REAL4VectorAligned *ffplanenoise,
                         const REAL4VectorAligned *fbinaveratios,
+                        const REAL4FFTPlan *plan,
                         const gsl_rng *rng,
                         const BOOLEAN exactflag );
 INT4 testIHScandidates( candidateVector **output,
@@ -0,0 +1,161 @@
+/*
+*  This program is free software; you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 2 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with with program; see the file COPYING. If not, write to the
+*  Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+*  MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+
+#include <lal/LALStdlib.h>
+#include <lal/RealFFT.h>
+#include <lal/Window.h>
+
+#include <gsl/gsl_math.h>
+
+#include "../secondFFT.h"
+
+//Compares the batched second FFT with a transform of one frequency bin at a time by XLALREAL4PowerSpectrum(),
+//which is how makeSecondFFT() computed it before
+
+#define TOLERANCE 1.0e-5
+
+static INT4 makeSecondFFTPerBin( ffdataStruct *output, const REAL4VectorAligned *tfdata, const REAL4FFTPlan *plan )
+{
+
+  REAL8 winFactor = 8.0 / 3.0;
+
+  REAL4VectorAligned *x = NULL, *psd = NULL, *windowData = NULL;
+  REAL4Window *win = NULL;
+  XLAL_CHECK( ( x = XLALCreateREAL4VectorAligned( output->numffts, 32 ) ) != NULL, XLAL_EFUNC );
+  XLAL_CHECK( ( psd = XLALCreateREAL4VectorAligned( ( UINT4 )floor( x->length * 0.5 ) + 1, 32 ) ) != NULL, XLAL_EFUNC );
+  XLAL_CHECK( ( win = XLALCreateHannREAL4Window( x->length ) ) != NULL, XLAL_EFUNC );
+  XLAL_CHECK( ( windowData = XLALCreateREAL4VectorAligned( win->data->length, 32 ) ) != NULL, XLAL_EFUNC );
+  memcpy( windowData->data, win->data->data, sizeof( REAL4 )*windowData->length );
+
+  for ( INT4 ii = 0; ii < output->numfbins; ii++ ) {
+    for ( UINT4 jj = 0; jj < x->length; jj++ ) {
+      x->data[jj] = tfdata->data[ii + jj * output->numfbins];
+    }
+    XLAL_CHECK( XLALVectorMultiplyREAL4( x->data, x->data, windowData->data, x->length ) == XLAL_SUCCESS, XLAL_EFUNC );
+    XLAL_CHECK( XLALREAL4PowerSpectrum( ( REAL4Vector * )psd, ( REAL4Vector * )x, plan ) == XLAL_SUCCESS, XLAL_EFUNC );
+    if ( GSL_IS_EVEN( x->length ) == 1 ) {
+      psd->data[0] *= 2.0;
+      psd->data[psd->length - 1] *= 2.0;
+    } else {
+      psd->data[0] *= 2.0;
+    }
+    for ( UINT4 jj = 0; jj < psd->length; jj++ ) {
+      output->ffdata->data[psd->length * ii + jj] = ( REAL4 )( psd->data[jj] * winFactor * output->ffnormalization );
+    }
+  }
+
+  XLALDestroyREAL4VectorAligned( x );
+  XLALDestroyREAL4VectorAligned( psd );
+  XLALDestroyREAL4VectorAligned( windowData );
+  XLALDestroyREAL4Window( win );
+
+  return XLAL_SUCCESS;
+
+}
+
+static ffdataStruct *createTestffdata( const INT4 numffts, const INT4 numfbins )
+{
+  ffdataStruct *ffdata = NULL;
+  XLAL_CHECK_NULL( ( ffdata = XLALCalloc( 1, sizeof( *ffdata ) ) ) != NULL, XLAL_ENOMEM );
+  ffdata->numffts = numffts;
+  ffdata->numfbins = numfbins;
+  ffdata->numfprbins = ( INT4 )floor( numffts * 0.5 ) + 1;
+  ffdata->ffnormalization = 1.7;
+  XLAL_CHECK_NULL( ( ffdata->ffdata = XLALCreateREAL4VectorAligned( ffdata->numfbins * ffdata->numfprbins, 32 ) ) != NULL, XLAL_EFUNC );
+  return ffdata;
+}
+
+static void destroyTestffdata( ffdataStruct *ffdata )
+{
+  XLALDestroyREAL4VectorAligned( ffdata->ffdata );
+  XLALFree( ffdata );
+}
+
+static INT4 compareSecondFFT( const INT4 numffts, const INT4 numfbins )
+{
+
+  ffdataStruct *batchffdata = NULL, *refffdata = NULL;
+  XLAL_CHECK( ( batchffdata = createTestffdata( numffts, numfbins ) ) != NULL, XLAL_EFUNC );
+  XLAL_CHECK( ( refffdata = createTestffdata( numffts, numfbins ) ) != NULL, XLAL_EFUNC );
+
+  //Mean subtracted and weighted TF data, time-major, with a periodic signal in some frequency bins
+  REAL4VectorAligned *tfdata = NULL;
+  XLAL_CHECK( ( tfdata = XLALCreateREAL4VectorAligned( numffts * numfbins, 32 ) ) != NULL, XLAL_EFUNC );
+  for ( INT4 jj = 0; jj < numffts; jj++ ) {
+    for ( INT4 ii = 0; ii < numfbins; ii++ ) {
+      REAL8 noise = sin( 12.9898 * ( jj * numfbins + ii ) ) * 43758.5453;
+      tfdata->data[ii + jj * numfbins] = ( REAL4 )( noise - floor( noise ) - 0.5 );
+      if ( ii % 3 == 0 ) {
+        tfdata->data[ii + jj * numfbins] += ( REAL4 )( 2.0 * cos( LAL_TWOPI * ( ii + 1 ) * jj / numffts ) );
+      }
+    }
+  }
+
+  secondFFTBatchPlan *batch = NULL;
+  REAL4FFTPlan *plan = NULL;
+  XLAL_CHECK( ( batch = createSecondFFTBatchPlan( batchffdata, 0 ) ) != NULL, XLAL_EFUNC );
+  XLAL_CHECK( ( plan = XLALCreateForwardREAL4FFTPlan( numffts, 0 ) ) != NULL, XLAL_EFUNC );
+
+  //Run the batch twice, to check that the plan and buffers can be reused
+  XLAL_CHECK( makeSecondFFT( batchffdata, tfdata, batch ) == XLAL_SUCCESS, XLAL_EFUNC );
+  memset( batchffdata->ffdata->data, 0, sizeof( REAL4 )*batchffdata->ffdata->length );
+  XLAL_CHECK( makeSecondFFT( batchffdata, tfdata, batch ) == XLAL_SUCCESS, XLAL_EFUNC );
+  XLAL_CHECK( makeSecondFFTPerBin( refffdata, tfdata, plan ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+  REAL4 maxpower = 0.0, maxerr = 0.0;
+  for ( UINT4 ii = 0; ii < refffdata->ffdata->length; ii++ ) {
+    maxpower = fmaxf( maxpower, fabsf( refffdata->ffdata->data[ii] ) );
+  }
+  for ( UINT4 ii = 0; ii < refffdata->ffdata->length; ii++ ) {
+    maxerr = fmaxf( maxerr, fabsf( batchffdata->ffdata->data[ii] - refffdata->ffdata->data[ii] ) / maxpower );
+  }
+  fprintf( stderr, "numffts = %d, numfbins = %d: maximum difference relative to the peak power = %g\n", numffts, numfbins, maxerr );
+  XLAL_CHECK( maxerr <= TOLERANCE, XLAL_ETOL, "Batched second FFT differs from the per-bin second FFT by %g > %g\n", maxerr, TOLERANCE );
+
+  //A TF plane of the wrong size is rejected
+  XLALDestroyREAL4VectorAligned( tfdata );
+  XLAL_CHECK( ( tfdata = XLALCreateREAL4VectorAligned( numffts * ( numfbins - 1 ), 32 ) ) != NULL, XLAL_EFUNC );
+  INT4 status;
+  XLAL_TRY_SILENT( status = makeSecondFFT( batchffdata, tfdata, batch ), status );
+  XLAL_CHECK( status == XLAL_EBADLEN, XLAL_EFAILED, "makeSecondFFT() accepted a TF plane of the wrong size\n" );
+
+  XLALDestroyREAL4VectorAligned( tfdata );
+  XLALDestroyREAL4FFTPlan( plan );
+  destroySecondFFTBatchPlan( batch );
+  destroyTestffdata( batchffdata );
+  destroyTestffdata( refffdata );
+
+  return XLAL_SUCCESS;
+
+}
+
+int main( void )
+{
+
+  //Even and odd numbers of SFTs
+  XLAL_CHECK( compareSecondFFT( 64, 21 ) == XLAL_SUCCESS, XLAL_EFUNC );
+  XLAL_CHECK( compareSecondFFT( 45, 17 ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+  LALCheckMemoryLeaks();
+
+  return 0;
+
+}
@@ -0,0 +1,233 @@
+/*
+*  This program is free software; you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 2 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with with program; see the file COPYING. If not, write to the
+*  Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+*  MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <lal/LALStdlib.h>
+#include <lal/LALString.h>
+#include <lal/RealFFT.h>
+
+#include <gsl/gsl_rng.h>
+
+#include "../candidates.h"
+
+//Checks that the template searches, which make and evaluate their templates a block at a time on several threads,
+//give exactly the same candidates with one thread as with several threads
+
+FILE *LOG = NULL;
+
+#define NUMTHREADS 4
+
+typedef struct {
+  UserInput_t params;
+  REAL4VectorAligned *ffdata;
+  REAL4VectorAligned *aveNoise;
+  REAL4VectorAligned *aveTFnoisePerFbinRatio;
+  REAL4FFTPlan *plan;
+  candidate input;
+  TwoSpectParamSpaceSearchVals paramspace;
+  LALStringVector *dffixed;
+  SkyPosition skypos;
+} testSearchData;
+
+typedef struct {
+  candidate bruteForceSearch;
+  candidateVector *bruteForceTest;
+  candidateVector *scox1Style;
+  candidateVector *fixedDf;
+} testSearchResults;
+
+static INT4 setupTestSearch( testSearchData *data )
+{
+
+  memset( data, 0, sizeof( *data ) );
+
+  UserInput_t *params = &( data->params );
+  params->Tsft = 360.0;
+  params->SFToverlap = 180.0;
+  params->Tobs = 5.0 * 86400.0;
+  params->fmin = 100.0;
+  params->fspan = 0.25;
+  params->Pmin = 4.0 * params->Tsft;
+  params->Pmax = 0.2 * params->Tobs;
+  params->dfmin = 0.5 / params->Tsft;
+  params->dfmax = 0.05;
+  params->tmplfar = 1.0;
+  params->minTemplateLength = 1;
+  params->maxTemplateLength = 500;
+  params->vectorMath = 0;
+
+  INT4 numffts = ( INT4 )floor( params->Tobs / ( params->Tsft - params->SFToverlap ) - 1 );
+  INT4 numfprbins = ( INT4 )floorf( numffts * 0.5 ) + 1;
+  INT4 numfbins = ( INT4 )( round( params->fspan * params->Tsft + 2.0 * params->dfmax * params->Tsft ) + 12 + 1 );
+
+  //Background close to unity, and 2nd FFT data of exponentially distributed noise on that background
+  XLAL_CHECK( ( data->aveNoise = XLALCreateREAL4VectorAligned( numfprbins, 32 ) ) != NULL, XLAL_EFUNC );
+  XLAL_CHECK( ( data->aveTFnoisePerFbinRatio = XLALCreateREAL4VectorAligned( numfbins, 32 ) ) != NULL, XLAL_EFUNC );
+  XLAL_CHECK( ( data->ffdata = XLALCreateREAL4VectorAligned( numfbins * numfprbins, 32 ) ) != NULL, XLAL_EFUNC );
+  for ( INT4 ii = 0; ii < numfprbins; ii++ ) {
+    data->aveNoise->data[ii] = ( REAL4 )( 1.0 + 0.2 * exp( -0.01 * ii ) );
+  }
+  for ( INT4 ii = 0; ii < numfbins; ii++ ) {
+    data->aveTFnoisePerFbinRatio->data[ii] = ( REAL4 )( 1.0 + 0.05 * sin( 0.3 * ii ) );
+  }
+  gsl_rng *rng = NULL;
+  XLAL_CHECK( ( rng = gsl_rng_alloc( gsl_rng_mt19937 ) ) != NULL, XLAL_EFUNC );
+  gsl_rng_set( rng, 1234 );
+  for ( INT4 ii = 0; ii < numfbins; ii++ ) {
+    for ( INT4 jj = 0; jj < numfprbins; jj++ ) {
+      data->ffdata->data[ii * numfprbins + jj] = ( REAL4 )( -log( 1.0 - gsl_rng_uniform( rng ) ) * data->aveNoise->data[jj] * data->aveTFnoisePerFbinRatio->data[ii] );
+    }
+  }
+  gsl_rng_free( rng );
+
+  XLAL_CHECK( ( data->plan = XLALCreateForwardREAL4FFTPlan( numffts, 0 ) ) != NULL, XLAL_EFUNC );
+
+  //Enough trial points around the candidate for several blocks of templates
+  loadCandidateData( &( data->input ), 100.1, 20000.0, 0.01, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0.0, -1, 0 );
+  TwoSpectParamSpaceSearchVals paramspace = {data->input.fsig - 2.0 / params->Tsft, data->input.fsig + 2.0 / params->Tsft, 5, 3, 3, 1.0, data->input.moddepth - 2.0 / params->Tsft, data->input.moddepth + 2.0 / params->Tsft, 5};
+  data->paramspace = paramspace;
+
+  XLAL_CHECK( ( data->dffixed = XLALCreateStringVector( "0.004", "0.01", "0.02", NULL ) ) != NULL, XLAL_EFUNC );
+  data->skypos.longitude = 1.1;
+  data->skypos.latitude = -0.3;
+
+  return XLAL_SUCCESS;
+
+}
+
+static void destroyTestSearch( testSearchData *data )
+{
+  XLALDestroyREAL4VectorAligned( data->ffdata );
+  XLALDestroyREAL4VectorAligned( data->aveNoise );
+  XLALDestroyREAL4VectorAligned( data->aveTFnoisePerFbinRatio );
+  XLALDestroyREAL4FFTPlan( data->plan );
+  XLALDestroyStringVector( data->dffixed );
+}
+
+static void destroyTestResults( testSearchResults *results )
+{
+  destroycandidateVector( results->bruteForceTest );
+  destroycandidateVector( results->scox1Style );
+  destroycandidateVector( results->fixedDf );
+}
+
+//Run all of the template searches, each with a freshly seeded random number generator
+static INT4 runTestSearches( testSearchResults *results, const testSearchData *data, const BOOLEAN useExactTemplates )
+{
+
+  memset( results, 0, sizeof( *results ) );
+  XLAL_CHECK( ( results->bruteForceTest = createcandidateVector( 10 ) ) != NULL, XLAL_EFUNC );
+  XLAL_CHECK( ( results->scox1Style = createcandidateVector( 10 ) ) != NULL, XLAL_EFUNC );
+  XLAL_CHECK( ( results->fixedDf = createcandidateVector( 10 ) ) != NULL, XLAL_EFUNC );
+
+  gsl_rng *rng = NULL;
+  XLAL_CHECK( ( rng = gsl_rng_alloc( gsl_rng_mt19937 ) ) != NULL, XLAL_EFUNC );
+
+  gsl_rng_set( rng, 42 );
+  XLAL_CHECK( bruteForceTemplateSearch( &( results->bruteForceSearch ), data->input, &( data->paramspace ), &( data->params ), data->ffdata, data->aveNoise, data->aveTFnoisePerFbinRatio, data->plan, rng, useExactTemplates ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+  gsl_rng_set( rng, 42 );
+  XLAL_CHECK( bruteForceTemplateTest( &( results->bruteForceTest ), data->input, &( data->paramspace ), &( data->params ), data->ffdata, data->aveNoise, data->aveTFnoisePerFbinRatio, data->plan, rng, useExactTemplates ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+  gsl_rng_set( rng, 42 );
+  XLAL_CHECK( templateSearch_scox1Style( &( results->scox1Style ), 100.05, 0.1, 68023.0, 1.44, 0.18, data->skypos, &( data->params ), data->ffdata, data->aveNoise, data->aveTFnoisePerFbinRatio, NULL, data->plan, rng, useExactTemplates ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+  gsl_rng_set( rng, 42 );
+  XLAL_CHECK( templateSearch_fixedDf( &( results->fixedDf ), data->dffixed, 100.05, 0.1, 20000.0, data->skypos, &( data->params ), data->ffdata, data->aveNoise, data->aveTFnoisePerFbinRatio, NULL, data->plan, rng, useExactTemplates ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+  gsl_rng_free( rng );
+
+  return XLAL_SUCCESS;
+
+}
+
+static INT4 compareCandidate( const CHAR *name, const UINT4 index, const candidate *a, const candidate *b )
+{
+  XLAL_CHECK( a->fsig == b->fsig && a->period == b->period && a->moddepth == b->moddepth && a->ra == b->ra && a->dec == b->dec &&
+              a->stat == b->stat && a->h0 == b->h0 && a->prob == b->prob && a->proberrcode == b->proberrcode && a->normalization == b->normalization &&
+              a->templateVectorIndex == b->templateVectorIndex && a->lineContamination == b->lineContamination, XLAL_ETOL,
+              "%s candidate %u differs: f = %.12g/%.12g, P = %.12g/%.12g, df = %.12g/%.12g, R = %.17g/%.17g, prob = %.17g/%.17g\n",
+              name, index, a->fsig, b->fsig, a->period, b->period, a->moddepth, b->moddepth, a->stat, b->stat, a->prob, b->prob );
+  return XLAL_SUCCESS;
+}
+
+static INT4 compareCandidateVectors( const CHAR *name, const candidateVector *a, const candidateVector *b )
+{
+  XLAL_CHECK( a->numofcandidates == b->numofcandidates, XLAL_ETOL, "%s found %u candidates with one thread, %u with several\n", name, a->numofcandidates, b->numofcandidates );
+  XLAL_CHECK( a->numofcandidates > 0, XLAL_EFAILED, "%s found no candidates\n", name );
+  for ( UINT4 ii = 0; ii < a->numofcandidates; ii++ ) {
+    XLAL_CHECK( compareCandidate( name, ii, &( a->data[ii] ), &( b->data[ii] ) ) == XLAL_SUCCESS, XLAL_EFUNC );
+  }
+  return XLAL_SUCCESS;
+}
+
+static INT4 compareThreads( const testSearchData *data, const BOOLEAN useExactTemplates )
+{
+
+  testSearchResults serial, threaded;
+
+#ifdef _OPENMP
+  omp_set_num_threads( 1 );
+#endif
+  XLAL_CHECK( runTestSearches( &serial, data, useExactTemplates ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+#ifdef _OPENMP
+  omp_set_num_threads( NUMTHREADS );
+#endif
+  XLAL_CHECK( runTestSearches( &threaded, data, useExactTemplates ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+  XLAL_CHECK( serial.bruteForceSearch.fsig != 0.0, XLAL_EFAILED, "bruteForceTemplateSearch() found no candidate\n" );
+  XLAL_CHECK( compareCandidate( "bruteForceTemplateSearch()", 0, &( serial.bruteForceSearch ), &( threaded.bruteForceSearch ) ) == XLAL_SUCCESS, XLAL_EFUNC );
+  XLAL_CHECK( compareCandidateVectors( "bruteForceTemplateTest()", serial.bruteForceTest, threaded.bruteForceTest ) == XLAL_SUCCESS, XLAL_EFUNC );
+  XLAL_CHECK( compareCandidateVectors( "templateSearch_scox1Style()", serial.scox1Style, threaded.scox1Style ) == XLAL_SUCCESS, XLAL_EFUNC );
+  XLAL_CHECK( compareCandidateVectors( "templateSearch_fixedDf()", serial.fixedDf, threaded.fixedDf ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+  fprintf( stderr, "%s templates: %u, %u and %u candidates agree between 1 and %d threads\n", useExactTemplates ? "Exact" : "Gaussian",
+           serial.bruteForceTest->numofcandidates, serial.scox1Style->numofcandidates, serial.fixedDf->numofcandidates, NUMTHREADS );
+
+  destroyTestResults( &serial );
+  destroyTestResults( &threaded );
+
+  return XLAL_SUCCESS;
+
+}
+
+int main( void )
+{
+
+  LOG = stderr;
+
+  testSearchData data;
+  XLAL_CHECK( setupTestSearch( &data ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+  XLAL_CHECK( compareThreads( &data, 0 ) == XLAL_SUCCESS, XLAL_EFUNC );
+  XLAL_CHECK( compareThreads( &data, 1 ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+  destroyTestSearch( &data );
+
+  LALCheckMemoryLeaks();
+
+  return 0;
+
+}
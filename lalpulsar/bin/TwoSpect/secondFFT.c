@@ -0,0 +1,158 @@
+/*
+*  This program is free software; you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 2 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with with program; see the file COPYING. If not, write to the
+*  Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+*  MA  02110-1301  USA
+*/
+
+#include <lal/Window.h>
+#include <lal/VectorMath.h>
+#include <lal/FFTWMutex.h>
+
+#include <gsl/gsl_math.h>
+
+#include "secondFFT.h"
+
+/**
+ * Create the batched second FFT plan and its buffers
+ *
+ * The second FFT is taken along time for every first-FFT frequency bin of the weighted TF plane.
+ * Instead of copying out and transforming one frequency bin at a time, a single FFTW plan performs
+ * all numfbins transforms directly on the strided (time-major) TF plane. The plan and buffers are
+ * created once and reused for every sky location.
+ * \param [in] ffdata   Pointer to ffdataStruct
+ * \param [in] planFlag FFT plan flag (0=Estimate, 1=Measure, 2=Patient, 3=Exhaustive)
+ * \return Pointer to secondFFTBatchPlan
+ */
+secondFFTBatchPlan *createSecondFFTBatchPlan( const ffdataStruct *ffdata, const INT4 planFlag )
+{
+
+  XLAL_CHECK_NULL( ffdata != NULL, XLAL_EINVAL );
+
+  secondFFTBatchPlan *batch = NULL;
+  XLAL_CHECK_NULL( ( batch = XLALCalloc( 1, sizeof( *batch ) ) ) != NULL, XLAL_ENOMEM );
+  batch->numffts = ffdata->numffts;
+  batch->numfbins = ffdata->numfbins;
+
+  REAL4Window *win = NULL;
+  XLAL_CHECK_NULL( ( win = XLALCreateHannREAL4Window( batch->numffts ) ) != NULL, XLAL_EFUNC );
+  XLAL_CHECK_NULL( ( batch->windowData = XLALCreateREAL4VectorAligned( win->data->length, 32 ) ) != NULL, XLAL_EFUNC );
+  memcpy( batch->windowData->data, win->data->data, sizeof( REAL4 )*batch->windowData->length );
+  XLALDestroyREAL4Window( win );
+
+  XLAL_CHECK_NULL( ( batch->tfdata = XLALCreateREAL4VectorAligned( batch->numffts * batch->numfbins, 32 ) ) != NULL, XLAL_EFUNC );
+  XLAL_CHECK_NULL( ( batch->hcdata = XLALCreateREAL4VectorAligned( batch->numffts * batch->numfbins, 32 ) ) != NULL, XLAL_EFUNC );
+
+  unsigned flags;
+  switch ( planFlag ) {
+  case 0:
+    flags = FFTW_ESTIMATE;
+    break;
+  case 1:
+    flags = FFTW_MEASURE;
+    break;
+  case 2:
+    flags = FFTW_PATIENT;
+    break;
+  default:
+    flags = FFTW_EXHAUSTIVE;
+    break;
+  }
+
+  //Input: frequency bin ii at time jj is tfdata[ii + jj*numfbins]; output: transform of bin ii is hcdata[ii*numffts ...]
+  int n = batch->numffts;
+  fftwf_r2r_kind kind = FFTW_R2HC;
+  LAL_FFTW_WISDOM_LOCK;
+  batch->plan = fftwf_plan_many_r2r( 1, &n, batch->numfbins, batch->tfdata->data, NULL, batch->numfbins, 1, batch->hcdata->data, NULL, 1, batch->numffts, &kind, flags );
+  LAL_FFTW_WISDOM_UNLOCK;
+  XLAL_CHECK_NULL( batch->plan != NULL, XLAL_EFAILED, "fftwf_plan_many_r2r() failed\n" );
+
+  return batch;
+
+} // createSecondFFTBatchPlan()
+
+
+/**
+ * Free the batched second FFT plan and its buffers
+ * \param [in] batch Pointer to secondFFTBatchPlan
+ */
+void destroySecondFFTBatchPlan( secondFFTBatchPlan *batch )
+{
+  if ( batch ) {
+    if ( batch->plan ) {
+      LAL_FFTW_WISDOM_LOCK;
+      fftwf_destroy_plan( batch->plan );
+      LAL_FFTW_WISDOM_UNLOCK;
+    }
+    XLALDestroyREAL4VectorAligned( batch->windowData );
+    XLALDestroyREAL4VectorAligned( batch->tfdata );
+    XLALDestroyREAL4VectorAligned( batch->hcdata );
+    XLALFree( batch );
+  }
+} // destroySecondFFTBatchPlan()
+
+
+/**
+ * Compute the second Fourier transform for TwoSpect
+ * \param [out] output Pointer to the ffdataStruct to the containers for the second FFT
+ * \param [in]  tfdata Pointer REAL4VectorAligned of mean subtracted and weighted data
+ * \param [in]  batch  Pointer to secondFFTBatchPlan
+ * \return Status value
+ */
+INT4 makeSecondFFT( ffdataStruct *output, REAL4VectorAligned *tfdata, secondFFTBatchPlan *batch )
+{
+
+  XLAL_CHECK( output != NULL && tfdata != NULL && batch != NULL, XLAL_EINVAL );
+  XLAL_CHECK( batch->numffts == output->numffts && batch->numfbins == output->numfbins && tfdata->length == batch->tfdata->length, XLAL_EBADLEN );
+
+  fprintf( stderr, "Computing second FFT over SFTs... " );
+
+  REAL8 winFactor = 8.0 / 3.0;
+  UINT4 numffts = output->numffts, numfbins = output->numfbins, numfprbins = output->numfprbins;
+
+  //Window each time step of the whole TF plane
+  for ( UINT4 jj = 0; jj < numffts; jj++ ) {
+    XLAL_CHECK( XLALVectorScaleREAL4( &( batch->tfdata->data[jj * numfbins] ), batch->windowData->data[jj], &( tfdata->data[jj * numfbins] ), numfbins ) == XLAL_SUCCESS, XLAL_EFUNC );
+  }
+
+  //Make all the FFTs at once
+  fftwf_execute( batch->plan );
+
+  for ( UINT4 ii = 0; ii < numfbins; ii++ ) {
+    const REAL4 *hc = &( batch->hcdata->data[ii * numffts] );
+    REAL4 *psd = &( output->ffdata->data[numfprbins * ii] );
+
+    //Power spectrum as in XLALREAL4PowerSpectrum(), with the beginning (and end, if even) values doubled.
+    //Scale the data points by 1/N and window factor and (1/fs)
+    //Order of vector is by second frequency then first frequency
+    //It is possible that when dealing with very loud signals, lines, injections, etc. (e.g., far above the background)
+    //then the output power here can be "rounded" because of the cast to nearby integer values.
+    //For high (but not too high) power values, this may not be noticed because the cast can round to nearby decimal values.
+    REAL4 power = hc[0] * hc[0];
+    psd[0] = ( REAL4 )( 2.0 * power * winFactor * output->ffnormalization );
+    for ( UINT4 jj = 1; jj < ( numffts + 1 ) / 2; jj++ ) {
+      power = hc[jj] * hc[jj] + hc[numffts - jj] * hc[numffts - jj];
+      psd[jj] = ( REAL4 )( 2.0 * power * winFactor * output->ffnormalization );
+    }
+    if ( GSL_IS_EVEN( numffts ) == 1 ) {
+      power = hc[numffts / 2] * hc[numffts / 2];
+      psd[numffts / 2] = ( REAL4 )( 2.0 * power * winFactor * output->ffnormalization );
+    }
+
+  } /* for ii < numfbins */
+
+  fprintf( stderr, "done\n" );
+
+  return XLAL_SUCCESS;
+
+} /* makeSecondFFT() */
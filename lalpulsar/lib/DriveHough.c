@@ -572,6 +572,80 @@ void LALHOUGHConstructHMT_W (LALStatus                  *status,	/**< pointer to
 
 
 
+/**
+ * Constructs a set of total Hough maps <tt>HOUGHMapTotalVector *htV</tt> from
+ * the same set of partial Hough map derivatives, one for each time-frequency
+ * trajectory in <tt>freqIndVS</tt> (e.g.\ one for each residual spin-down
+ * at a given search frequency). The maps only read <tt>phmdVS</tt>, so they
+ * are independent of each other and are constructed in parallel when LALPulsar
+ * is built with OpenMP. Each map is computed as by LALHOUGHConstructHMT_W() if
+ * \c weighted is true, or by LALHOUGHConstructHMT() otherwise; only
+ * <tt>htV->ht[n].map</tt> is written, and all maps must already be allocated.
+ * All maps are held in memory at once, so callers with many trajectories
+ * should pass them in blocks of about one map per thread.
+ */
+void LALHOUGHConstructHMTVector (LALStatus                         *status,	/**< pointer to LALStatus structure */
+				 HOUGHMapTotalVector               *htV,	/**< The output hough maps */
+				 UINT8FrequencyIndexVectorSequence *freqIndVS,	/**< time-frequency trajectories, one per map */
+				 PHMDVectorSequence                *phmdVS,	/**< set of partial hough map derivatives */
+				 BOOLEAN                           weighted	/**< use the weights of the partial hough map derivatives */)
+{
+
+  INT4    n, nMaps;
+  INT4    nFailed = 0;
+
+  /* --------------------------------------------- */
+  INITSTATUS(status);
+  ATTATCHSTATUSPTR (status);
+
+  /*   Make sure the arguments are not NULL: */
+  ASSERT (htV,       status, LALHOUGHH_ENULL, LALHOUGHH_MSGENULL);
+  ASSERT (freqIndVS, status, LALHOUGHH_ENULL, LALHOUGHH_MSGENULL);
+  ASSERT (phmdVS,    status, LALHOUGHH_ENULL, LALHOUGHH_MSGENULL);
+  ASSERT (htV->ht,   status, LALHOUGHH_ENULL, LALHOUGHH_MSGENULL);
+  ASSERT (freqIndVS->freqIndV, status, LALHOUGHH_ENULL, LALHOUGHH_MSGENULL);
+  /* -------------------------------------------   */
+
+  /* Make sure there is one trajectory per map */
+  ASSERT (htV->length == freqIndVS->length, status,
+	  LALHOUGHH_ESZMM, LALHOUGHH_MSGESZMM);
+  /* -------------------------------------------   */
+
+  nMaps = htV->length;
+
+#pragma omp parallel for schedule(dynamic)
+  for ( n=0; n<nMaps; ++n ){
+    /* each thread reports through its own status structure */
+    LALStatus threadStatus;
+    memset(&threadStatus, 0, sizeof(threadStatus));
+
+    if ( weighted ) {
+      LALHOUGHConstructHMT_W(&threadStatus, &(htV->ht[n]), &(freqIndVS->freqIndV[n]), phmdVS);
+    } else {
+      LALHOUGHConstructHMT(&threadStatus, &(htV->ht[n]), &(freqIndVS->freqIndV[n]), phmdVS);
+    }
+
+    if ( threadStatus.statusCode ) {
+#pragma omp atomic
+      ++nFailed;
+      if ( threadStatus.statusPtr ) {
+        FREESTATUSPTR(&threadStatus);
+      }
+    }
+  }
+
+  /* the errors have already been reported by the failing calls */
+  if ( nFailed ) {
+    ABORT( status, LALHOUGHH_EVAL, LALHOUGHH_MSGEVAL);
+  }
+
+  DETATCHSTATUSPTR (status);
+  /* normal exit */
+  RETURN (status);
+}
+
+
+
 /**
  * Adds weight factors for set of partial hough map derivatives -- the
  * weights must be calculated outside this function.
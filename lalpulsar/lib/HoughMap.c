@@ -17,7 +17,14 @@
  *  MA  02110-1301  USA
  */
 
+#include <config.h>
+
 #include <lal/HoughMap.h>
+#include <lal/LALSIMD.h>
+
+#ifdef HAVE_AVX2_COMPILER
+int XLALHOUGHAddPHMD2HDBorders_AVX2(HoughDT *map, HOUGHBorder **pBorderP, INT4 length, HoughDT weight, INT4 xSide, INT4 ySide);
+#endif
 
 /*
  * The functions that make up the guts of this module
@@ -226,7 +233,9 @@ void LALHOUGHAddPHMD2HD (LALStatus      *status, 	/**< the status pointer */
 
 /**
  * Adds a hough map derivative into a total hough map derivative taking into
- * account the weight of the partial hough map
+ * account the weight of the partial hough map.
+ * If the CPU supports AVX2 the borders are accumulated with a vectorised
+ * kernel; the resulting map is identical.
  */
 void LALHOUGHAddPHMD2HD_W (LALStatus      *status, 	/**< the status pointer */
 			   HOUGHMapDeriv  *hd,  	/**< the Hough map derivative */
@@ -266,6 +275,18 @@ void LALHOUGHAddPHMD2HD_W (LALStatus      *status, 	/**< the status pointer */
   lengthLeft = phmd->lengthLeft;
   lengthRight= phmd->lengthRight;
 
+#ifdef HAVE_AVX2_COMPILER
+  if ( LAL_HAVE_AVX2_RUNTIME() ) {
+    /* left borders => increase, right borders => decrease according to weight */
+    if ( XLALHOUGHAddPHMD2HDBorders_AVX2( hd->map, phmd->leftBorderP, lengthLeft, weight, xSide, ySide ) != XLAL_SUCCESS ||
+         XLALHOUGHAddPHMD2HDBorders_AVX2( hd->map, phmd->rightBorderP, lengthRight, -weight, xSide, ySide ) != XLAL_SUCCESS ) {
+      ABORT(status, HOUGHMAPH_ESIZE, HOUGHMAPH_MSGESIZE);
+    }
+    DETATCHSTATUSPTR (status);
+    RETURN (status);
+  }
+#endif
+
   /* left borders =>  increase according to weight*/
   for (k=0; k< lengthLeft; ++k){
 
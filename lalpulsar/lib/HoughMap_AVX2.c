@@ -0,0 +1,112 @@
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with with program; see the file COPYING. If not, write to the
+ *  Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ *  MA  02110-1301  USA
+ */
+
+#include <immintrin.h>
+
+#include <lal/HoughMap.h>
+
+/*
+ * AVX2 accumulation of weighted partial Hough map derivative borders,
+ * used by LALHOUGHAddPHMD2HD_W() when the CPU supports it.  This file
+ * is compiled with AVX2 code generation enabled.
+ *
+ * Within one border every row j is marked at most once, so the map
+ * indices j*(xSide+1) + xPixel[j] of a batch of rows are all distinct:
+ * they are computed and range checked eight at a time, the map values
+ * are gathered and incremented in vector registers, and only the final
+ * stores are done element by element (AVX2 has no scatter).  Each map
+ * element sees exactly the same additions, in the same order, as in the
+ * scalar loop, so the result is bit-for-bit identical.
+ */
+
+int XLALHOUGHAddPHMD2HDBorders_AVX2(HoughDT *map, HOUGHBorder **pBorderP, INT4 length, HoughDT weight, INT4 xSide, INT4 ySide);
+
+int XLALHOUGHAddPHMD2HDBorders_AVX2(HoughDT *map,		/**< the Hough map derivative */
+				    HOUGHBorder **pBorderP,	/**< the borders to add */
+				    INT4 length,		/**< number of borders */
+				    HoughDT weight,		/**< signed weight of the borders */
+				    INT4 xSide,
+				    INT4 ySide)
+{
+  const INT4 xSideP1 = xSide + 1;
+  const INT4 mapLength = ySide * xSideP1;
+  const __m256i rowOffsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(xSideP1));
+  const __m256i batchStride = _mm256_set1_epi32(8 * xSideP1);
+  const __m256i minusOne = _mm256_set1_epi32(-1);
+  const __m256i mapEnd = _mm256_set1_epi32(mapLength);
+  const __m256d w = _mm256_set1_pd(weight);
+  INT4 idx[8] __attribute__ ((aligned (32)));
+  HoughDT val[8] __attribute__ ((aligned (32)));
+
+  for (INT4 k = 0; k < length; ++k) {
+    HOUGHBorder *borderP = pBorderP[k];
+    COORType *xPixel = &(borderP->xPixel[0]);
+    INT4 yLower = borderP->yLower;
+    INT4 yUpper = borderP->yUpper;
+    INT4 j;
+
+    if (k < length - 1)
+      __builtin_prefetch(&(pBorderP[k+1]->xPixel[pBorderP[k+1]->yLower]));
+
+    if (yLower < 0) {
+      fprintf(stderr,"WARNING: Fixing yLower (%d -> 0) [HoughMap_AVX2.c %d]\n",
+	      yLower, __LINE__);
+      yLower = 0;
+    }
+    if (yUpper >= ySide) {
+      fprintf(stderr,"WARNING: Fixing yUpper (%d -> %d) [HoughMap_AVX2.c %d]\n",
+	      yUpper, ySide-1, __LINE__);
+      yUpper = ySide - 1;
+    }
+
+    __m256i rowBase = _mm256_add_epi32(_mm256_set1_epi32(yLower * xSideP1), rowOffsets);
+    for (j = yLower; j + 7 <= yUpper; j += 8) {
+      __m256i sidx = _mm256_add_epi32(rowBase, _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) &(xPixel[j]))));
+      __m256i inside = _mm256_and_si256(_mm256_cmpgt_epi32(sidx, minusOne), _mm256_cmpgt_epi32(mapEnd, sidx));
+      if (_mm256_movemask_epi8(inside) != -1) {
+        /* leave the error report to the scalar loop below */
+        break;
+      }
+      __m256d m0 = _mm256_i32gather_pd(map, _mm256_castsi256_si128(sidx), sizeof(HoughDT));
+      __m256d m1 = _mm256_i32gather_pd(map, _mm256_extracti128_si256(sidx, 1), sizeof(HoughDT));
+      _mm256_store_si256((__m256i *) idx, sidx);
+      _mm256_store_pd(val, _mm256_add_pd(m0, w));
+      _mm256_store_pd(val + 4, _mm256_add_pd(m1, w));
+      map[idx[0]] = val[0];
+      map[idx[1]] = val[1];
+      map[idx[2]] = val[2];
+      map[idx[3]] = val[3];
+      map[idx[4]] = val[4];
+      map[idx[5]] = val[5];
+      map[idx[6]] = val[6];
+      map[idx[7]] = val[7];
+      rowBase = _mm256_add_epi32(rowBase, batchStride);
+    }
+
+    for (; j <= yUpper; ++j) {
+      INT4 sidx = j * xSideP1 + xPixel[j];
+      if ((sidx < 0) || (sidx >= mapLength)) {
+	fprintf(stderr,"\nERROR: %s %d: map index out of bounds: %d [0..%d] j:%d xp[j]:%d\n",
+		__FILE__,__LINE__,sidx,mapLength,j,xPixel[j] );
+	return XLAL_EDOM;
+      }
+      map[sidx] += weight;
+    }
+  }
+
+  return XLAL_SUCCESS;
+}
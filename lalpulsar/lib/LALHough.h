@@ -246,6 +246,13 @@ void LALHOUGHConstructHMT_W  (LALStatus                  *status,
 			      PHMDVectorSequence         *phmdVS
 			      );
 
+void LALHOUGHConstructHMTVector  (LALStatus                         *status,
+				  HOUGHMapTotalVector               *htV,
+				  UINT8FrequencyIndexVectorSequence *freqIndVS,
+				  PHMDVectorSequence                *phmdVS,
+				  BOOLEAN                           weighted
+				  );
+
 void LALHOUGHWeighSpacePHMD  (LALStatus            *status,
 			      PHMDVectorSequence   *phmdVS,
 			      REAL8Vector *weightV
@@ -22,6 +22,16 @@
 
 #include <lal/PulsarCrossCorr_v2.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#define CROSSCORR_MAX_THREADS omp_get_max_threads()
+#define CROSSCORR_THREAD_NUM omp_get_thread_num()
+#else
+#define omp ignore
+#define CROSSCORR_MAX_THREADS 1
+#define CROSSCORR_THREAD_NUM 0
+#endif
+
 #define SQUARE(x) ((x)*(x))
 #define QUAD(x) ((x)*(x)*(x)*(x))
 #define GPSDIFF(x,y) (1.0*((x).gpsSeconds - (y).gpsSeconds) + ((x).gpsNanoSeconds - (y).gpsNanoSeconds)*1e-9)
@@ -48,7 +58,8 @@ XLALApplyCrossCorrFreqShiftResamp
 
 static int
 XLALComputeFaFb_CrossCorrResamp(
-  ResampCrossCorrWorkspace                *restrict ws2L,
+  const ResampCrossCorrWorkspace          *restrict ws,
+  ResampCrossCorrThreadBuffers            *restrict buf,
   COMPLEX8                                *restrict wsFaX_k,
   COMPLEX8                                *restrict wsFbX_k,
   const MultiResampSFTPairMultiIndexList  *restrict resampMultiPairs,
@@ -1076,6 +1087,42 @@ int XLALCalculatePulsarCrossCorrStatistic
     XLALPrintError( "Lengths of pair-indexed lists don't match!" );
     XLAL_ERROR( XLAL_EBADLEN );
   }
+  /* The double sum over bins j, k of each pair factorises: the sinc
+   * factors depend on one SFT each, and the alternating sign is
+   * (-1)**(k1-k2) * (-1)**j * (-1)**k. So precompute, for each SFT, the
+   * sinc-weighted alternating sum of its data and the sum of its squared
+   * sinc factors; each pair then only needs a product of the two.
+   * SFTs whose indices are out of range are skipped here and reported
+   * below if a pair refers to them. */
+  COMPLEX16 *sincWeightedData = NULL;
+  REAL8 *sincSqrSum = NULL;
+  XLAL_CHECK( ( sincWeightedData = XLALMalloc( numSFTs * sizeof( *sincWeightedData ) ) ) != NULL, XLAL_ENOMEM );
+  XLAL_CHECK_FAIL( ( sincSqrSum = XLALMalloc( numSFTs * sizeof( *sincSqrSum ) ) ) != NULL, XLAL_ENOMEM );
+  for ( UINT4 sftNum = 0; sftNum < numSFTs; sftNum++ ) {
+    UINT4 detInd = sftIndices->data[sftNum].detInd;
+    UINT4 sftInd = sftIndices->data[sftNum].sftInd;
+    UINT4 lowestBin = lowestBins->data[sftNum];
+    sincWeightedData[sftNum] = 0;
+    sincSqrSum[sftNum] = 0;
+    if ( detInd >= inputSFTs->length
+         || sftInd >= inputSFTs->data[detInd]->length
+         || ( lowestBin + numBins - 1 ) >= inputSFTs->data[detInd]->data[sftInd].data->length ) {
+      continue;
+    }
+    const COMPLEX8 *dataArray = inputSFTs->data[detInd]->data[sftInd].data->data;
+    const REAL8 *sincFactors = &( sincList->data[sftNum * numBins] );
+    COMPLEX16 weightedData = 0;
+    REAL8 sqrSum = 0;
+    INT4 sign = 1;
+    for ( UINT4 j = 0; j < numBins; j++ ) {
+      weightedData += sign * sincFactors[j] * dataArray[lowestBin + j];
+      sqrSum += SQUARE( sincFactors[j] );
+      sign *= -1;
+    }
+    sincWeightedData[sftNum] = weightedData;
+    sincSqrSum[sftNum] = sqrSum;
+  }
+
   REAL8 nume = 0;
   REAL8 curlyGSqr = 0;
   *ccStat = 0.0;
@@ -1084,73 +1131,59 @@ int XLALCalculatePulsarCrossCorrStatistic
     UINT4 sftNum1 = sftPairs->data[alpha].sftNum[0];
     UINT4 sftNum2 = sftPairs->data[alpha].sftNum[1];
 
-    XLAL_CHECK( ( sftNum1 < numSFTs ) && ( sftNum2 < numSFTs ),
-                XLAL_EINVAL,
-                "SFT pair asked for SFT index off end of list:\n alpha=%"LAL_UINT4_FORMAT", sftNum1=%"LAL_UINT4_FORMAT", sftNum2=%"LAL_UINT4_FORMAT", numSFTs=%"LAL_UINT4_FORMAT"\n",
-                alpha,  sftNum1, sftNum2, numSFTs );
+    XLAL_CHECK_FAIL( ( sftNum1 < numSFTs ) && ( sftNum2 < numSFTs ),
+                     XLAL_EINVAL,
+                     "SFT pair asked for SFT index off end of list:\n alpha=%"LAL_UINT4_FORMAT", sftNum1=%"LAL_UINT4_FORMAT", sftNum2=%"LAL_UINT4_FORMAT", numSFTs=%"LAL_UINT4_FORMAT"\n",
+                     alpha,  sftNum1, sftNum2, numSFTs );
 
     UINT4 detInd1 = sftIndices->data[sftNum1].detInd;
     UINT4 detInd2 = sftIndices->data[sftNum2].detInd;
 
-    XLAL_CHECK( ( detInd1 < inputSFTs->length )
-                && ( detInd2 < inputSFTs->length ),
-                XLAL_EINVAL,
-                "SFT asked for detector index off end of list:\n sftNum1=%"LAL_UINT4_FORMAT", sftNum2=%"LAL_UINT4_FORMAT", detInd1=%"LAL_UINT4_FORMAT", detInd2=%"LAL_UINT4_FORMAT", inputSFTs->length=%d\n",
-                sftNum1, sftNum2, detInd1, detInd2, inputSFTs->length );
+    XLAL_CHECK_FAIL( ( detInd1 < inputSFTs->length )
+                     && ( detInd2 < inputSFTs->length ),
+                     XLAL_EINVAL,
+                     "SFT asked for detector index off end of list:\n sftNum1=%"LAL_UINT4_FORMAT", sftNum2=%"LAL_UINT4_FORMAT", detInd1=%"LAL_UINT4_FORMAT", detInd2=%"LAL_UINT4_FORMAT", inputSFTs->length=%d\n",
+                     sftNum1, sftNum2, detInd1, detInd2, inputSFTs->length );
 
     UINT4 sftInd1 = sftIndices->data[sftNum1].sftInd;
     UINT4 sftInd2 = sftIndices->data[sftNum2].sftInd;
 
-    XLAL_CHECK( ( sftInd1 < inputSFTs->data[detInd1]->length )
-                && ( sftInd2 < inputSFTs->data[detInd2]->length ),
-                XLAL_EINVAL,
-                "SFT asked for SFT index off end of list:\n sftNum1=%"LAL_UINT4_FORMAT", sftNum2=%"LAL_UINT4_FORMAT", detInd1=%"LAL_UINT4_FORMAT", detInd2=%"LAL_UINT4_FORMAT", sftInd1=%"LAL_UINT4_FORMAT", sftInd2=%"LAL_UINT4_FORMAT", inputSFTs->data[detInd1]->length=%d, inputSFTs->data[detInd2]->length=%d\n",
-                sftNum1, sftNum2, detInd1, detInd2, sftInd1, sftInd2,
-                inputSFTs->data[detInd1]->length,
-                inputSFTs->data[detInd2]->length );
+    XLAL_CHECK_FAIL( ( sftInd1 < inputSFTs->data[detInd1]->length )
+                     && ( sftInd2 < inputSFTs->data[detInd2]->length ),
+                     XLAL_EINVAL,
+                     "SFT asked for SFT index off end of list:\n sftNum1=%"LAL_UINT4_FORMAT", sftNum2=%"LAL_UINT4_FORMAT", detInd1=%"LAL_UINT4_FORMAT", detInd2=%"LAL_UINT4_FORMAT", sftInd1=%"LAL_UINT4_FORMAT", sftInd2=%"LAL_UINT4_FORMAT", inputSFTs->data[detInd1]->length=%d, inputSFTs->data[detInd2]->length=%d\n",
+                     sftNum1, sftNum2, detInd1, detInd2, sftInd1, sftInd2,
+                     inputSFTs->data[detInd1]->length,
+                     inputSFTs->data[detInd2]->length );
 
-    COMPLEX8 *dataArray1 = inputSFTs->data[detInd1]->data[sftInd1].data->data;
-    COMPLEX8 *dataArray2 = inputSFTs->data[detInd2]->data[sftInd2].data->data;
     UINT4 lenDataArray1 = inputSFTs->data[detInd1]->data[sftInd1].data->length;
     UINT4 lenDataArray2 = inputSFTs->data[detInd2]->data[sftInd2].data->length;
+    UINT4 lowestBin1 = lowestBins->data[sftNum1];
+    UINT4 lowestBin2 = lowestBins->data[sftNum2];
+    XLAL_CHECK_FAIL( ( ( lowestBin1 + numBins - 1 ) < lenDataArray1 ),
+                     XLAL_EINVAL,
+                     "Loop would run off end of array:\n lowestBin1=%d, numBins=%d, len(dataArray1)=%d\n",
+                     lowestBin1, numBins, lenDataArray1 );
+    XLAL_CHECK_FAIL( ( ( lowestBin2 + numBins - 1 ) < lenDataArray2 ),
+                     XLAL_EINVAL,
+                     "Loop would run off end of array:\n lowestBin2=%d, numBins=%d, len(dataArray2)=%d\n",
+                     lowestBin2, numBins, lenDataArray2 );
+
     COMPLEX8 GalphaCC = curlyGAmp->data[alpha]
                         * expSignalPhases->data[sftNum1]
                         * conj( expSignalPhases->data[sftNum2] );
     INT4 baseCCSign = 1; /* Alternating sign is (-1)**(k1-k2) */
-    if ( ( ( lowestBins->data[sftNum1] - lowestBins->data[sftNum2] ) % 2 ) != 0 ) {
+    if ( ( ( lowestBin1 - lowestBin2 ) % 2 ) != 0 ) {
       baseCCSign = -1;
     }
 
-    UINT4 lowestBin1 = lowestBins->data[sftNum1];
-    XLAL_CHECK( ( ( lowestBin1 + numBins - 1 ) < lenDataArray1 ),
-                XLAL_EINVAL,
-                "Loop would run off end of array:\n lowestBin1=%d, numBins=%d, len(dataArray1)=%d\n",
-                lowestBin1, numBins, lenDataArray1 );
-    for ( UINT4 j = 0; j < numBins; j++ ) {
-      COMPLEX8 data1 = dataArray1[lowestBin1 + j];
-
-      INT4 ccSign = baseCCSign;
-      UINT4 lowestBin2 = lowestBins->data[sftNum2];
-      XLAL_CHECK( ( ( lowestBin2 + numBins - 1 ) < lenDataArray2 ),
-                  XLAL_EINVAL,
-                  "Loop would run off end of array:\n lowestBin2=%d, numBins=%d, len(dataArray2)=%d\n",
-                  lowestBin2, numBins, lenDataArray2 );
-      for ( UINT4 k = 0; k < numBins; k++ ) {
-        COMPLEX8 data2 = dataArray2[lowestBins->data[sftNum2] + k];
-        REAL8 sincFactor = 1;
-
-        sincFactor = sincList->data[sftNum1 * numBins + j] * sincList->data[sftNum2 * numBins + k];
-        nume +=  ccSign * sincFactor * creal( GalphaCC * conj( data1 ) * data2 );
-        /*nume += creal ( GalphaCC * ccSign * sincFactor * conj(data1) * data2 );=> abs(GalphaCC)*abs(data1)*abs(data2) * cos(arg(GalphaCC)-arg(data1)+arg(data2))*/
-        /*multiWeights->data[detInd1]->data[sftNum1] *  multiWeights->data[detInd2]->data[sftNum2] **/
-        REAL8 GalphaAmp = curlyGAmp->data[alpha] * sincFactor ;
-        /** multiWeights->data[detInd1]->data[sftNum1] *  multiWeights->data[detInd2]->data[sftNum2]*/
-        curlyGSqr += SQUARE( GalphaAmp );
-        ccSign *= -1;
-      }
-      baseCCSign *= -1;
-    }
+    nume += baseCCSign * creal( GalphaCC * conj( sincWeightedData[sftNum1] ) * sincWeightedData[sftNum2] );
+    /*multiWeights->data[detInd1]->data[sftNum1] *  multiWeights->data[detInd2]->data[sftNum2] **/
+    curlyGSqr += SQUARE( curlyGAmp->data[alpha] ) * sincSqrSum[sftNum1] * sincSqrSum[sftNum2];
   }
+  XLALFree( sincWeightedData );
+  XLALFree( sincSqrSum );
+
   if ( curlyGSqr == 0.0 ) {
     *evSquared = 0.0;
     *ccStat = 0.0;
@@ -1159,6 +1192,11 @@ int XLALCalculatePulsarCrossCorrStatistic
     *ccStat = 4 * multiWeights->Sinv_Tsft * nume / sqrt( *evSquared );
   }
   return XLAL_SUCCESS;
+
+XLAL_FAIL:
+  XLALFree( sincWeightedData );
+  XLALFree( sincSqrSum );
+  return XLAL_FAILURE;
 }
 
 /** Calculate multi-bin cross-correlation statistic using resampling */
@@ -1201,28 +1239,65 @@ int XLALCalculatePulsarCrossCorrStatisticResamp
   const REAL8 dt_SRC = multiTimeSeries_SRC_b->data[0]->deltaT;
   const REAL8 SRCsampPerTcoh = resampMultiPairs->Tshort / dt_SRC;
 
+  /* The sin/cos lookup table is set up on first use; do that before
+   * entering the threaded loop */
+  XLALSinCosLUTInit();
+
   /* MAIN LOOP (RESAMPLING) */
+  /* The pairs are partitioned over threads by their first SFT K: each
+   * thread works in its own scratch buffers and accumulates its own
+   * partial numeEquivAve, and the partial sums are added up in thread
+   * order afterwards. The static schedule keeps the assignment of K to
+   * threads, and therefore the result, reproducible between runs */
+  const UINT4 numThreads = ws->numThreads;
+  ws->threadBuffers[0].KFaX_k = ws1KFaX_k;
+  ws->threadBuffers[0].KFbX_k = ws1KFbX_k;
+  ws->threadBuffers[0].LFaX_k = ws2LFaX_k;
+  ws->threadBuffers[0].LFbX_k = ws2LFbX_k;
+  for ( UINT4 t = 1; t < numThreads; t++ ) {
+    memset( ws->threadBuffers[t].numeEquivAve, 0, ws->numFreqBinsOut * sizeof( REAL8 ) );
+  }
+  int failures = 0;
   for ( UINT4 detX = 0; detX < resampMultiPairs->length; detX++ ) {
-    for ( UINT4 sftK = 0; sftK <  resampMultiPairs->data[detX].length; sftK++ ) {
-      if ( ( XLALComputeFaFb_CrossCorrResamp( ws, ws1KFaX_k, ws1KFbX_k, resampMultiPairs, multiTimeSeries_SRC_a, multiTimeSeries_SRC_b, dopplerpos, binaryTemplateSpacings, SRCsampPerTcoh, detX, sftK, 0, FALSE ) ) != XLAL_SUCCESS ) {
-        LogPrintf( LOG_CRITICAL, "%s: XLALComputeFaFb_CrossCorrResamp() failed with errno=%d\n", __func__, xlalErrno );
-        XLAL_ERROR( XLAL_EFUNC );
-      }
-      for ( UINT4 detY = 0; detY < resampMultiPairs->data[detX].data[sftK].length; detY++ ) {
-        if ( ( XLALComputeFaFb_CrossCorrResamp( ws, ws2LFaX_k, ws2LFbX_k, resampMultiPairs, multiTimeSeries_SRC_a, multiTimeSeries_SRC_b, dopplerpos, binaryTemplateSpacings, SRCsampPerTcoh, detX, sftK, detY, TRUE ) ) != XLAL_SUCCESS ) {
-          LogPrintf( LOG_CRITICAL, "%s: XLALComputeFaFb_CrossCorrResamp() failed with errno=%d\n", __func__, xlalErrno );
-          XLAL_ERROR( XLAL_EFUNC );
-        }
-        /* -...-...-...- NEW CORE -...-...-...- */
-        for ( UINT8 j = 0; j < ws->numFreqBinsOut; j++ ) {
-          numeEquivAve->data[j]  += creal( 0.1 * ( conj( ws1KFaX_k[j] ) * ws2LFaX_k[j] + conj( ws1KFbX_k[j] ) * ws2LFbX_k[j] ) );
-          /* Can use for circular polarization:
-           * numeEquivCirc->data[j] += creal(0.1 * (  conj(ws1KFaX_k[j]) * ws2LFbX_k[j] - conj(ws1KFbX_k[j]) * ws2LFaX_k[j]  ) ); */
+    const INT4 numSFTsK = resampMultiPairs->data[detX].length;
+    #pragma omp parallel num_threads(numThreads)
+    {
+      const UINT4 t = CROSSCORR_THREAD_NUM;
+      ResampCrossCorrThreadBuffers *restrict buf = &( ws->threadBuffers[t] );
+      REAL8 *restrict numeEquivAveT = ( t == 0 ) ? numeEquivAve->data : buf->numeEquivAve;
+      #pragma omp for schedule(static)
+      for ( INT4 sftK = 0; sftK < numSFTsK; sftK++ ) {
+        if ( ( XLALComputeFaFb_CrossCorrResamp( ws, buf, buf->KFaX_k, buf->KFbX_k, resampMultiPairs, multiTimeSeries_SRC_a, multiTimeSeries_SRC_b, dopplerpos, binaryTemplateSpacings, SRCsampPerTcoh, detX, sftK, 0, FALSE ) ) != XLAL_SUCCESS ) {
+          #pragma omp atomic
+          failures++;
+          continue;
         }
-        /* -...-...-...- END NEW CORE -...-...-...- */
-      } /* detY */
-    } /* sftK */
+        for ( UINT4 detY = 0; detY < resampMultiPairs->data[detX].data[sftK].length; detY++ ) {
+          if ( ( XLALComputeFaFb_CrossCorrResamp( ws, buf, buf->LFaX_k, buf->LFbX_k, resampMultiPairs, multiTimeSeries_SRC_a, multiTimeSeries_SRC_b, dopplerpos, binaryTemplateSpacings, SRCsampPerTcoh, detX, sftK, detY, TRUE ) ) != XLAL_SUCCESS ) {
+            #pragma omp atomic
+            failures++;
+            break;
+          }
+          /* -...-...-...- NEW CORE -...-...-...- */
+          for ( UINT8 j = 0; j < ws->numFreqBinsOut; j++ ) {
+            numeEquivAveT[j]  += creal( 0.1 * ( conj( buf->KFaX_k[j] ) * buf->LFaX_k[j] + conj( buf->KFbX_k[j] ) * buf->LFbX_k[j] ) );
+            /* Can use for circular polarization:
+             * numeEquivCirc->data[j] += creal(0.1 * (  conj(buf->KFaX_k[j]) * buf->LFbX_k[j] - conj(buf->KFbX_k[j]) * buf->LFaX_k[j]  ) ); */
+          }
+          /* -...-...-...- END NEW CORE -...-...-...- */
+        } /* detY */
+      } /* sftK */
+    }
+    if ( failures > 0 ) {
+      LogPrintf( LOG_CRITICAL, "%s: XLALComputeFaFb_CrossCorrResamp() failed for %d SFT(s) of detector %u\n", __func__, failures, detX );
+      XLAL_ERROR( XLAL_EFUNC );
+    }
   } /* detX */ /* end main loop (NOW WITH RESAMPLING) */
+  for ( UINT4 t = 1; t < numThreads; t++ ) {
+    for ( UINT4 j = 0; j < ws->numFreqBinsOut; j++ ) {
+      numeEquivAve->data[j] += ws->threadBuffers[t].numeEquivAve[j];
+    }
+  }
 
   /* ENDING RESAMPLING SECTION */
 
@@ -3090,6 +3165,34 @@ XLALCreateCrossCorrWorkspace(
   XLAL_CHECK( ( ws1KFbX_k = fftw_malloc( numFreqBins * sizeof( COMPLEX8 ) ) ) != NULL, XLAL_ENOMEM );
   XLAL_CHECK( ( ws2LFaX_k = fftw_malloc( numFreqBins * sizeof( COMPLEX8 ) ) ) != NULL, XLAL_ENOMEM );
   XLAL_CHECK( ( ws2LFbX_k = fftw_malloc( numFreqBins * sizeof( COMPLEX8 ) ) ) != NULL, XLAL_ENOMEM );
+
+  /* Scratch space for the threaded loop over SFT pairs: the first thread
+   * uses the buffers above, every other thread gets its own copies, which
+   * are all allocated with fftw_malloc() so that they share the alignment
+   * of the arrays the plan was created with */
+  ws->numThreads = CROSSCORR_MAX_THREADS;
+  XLAL_CHECK( ( ws->threadBuffers = XLALCalloc( ws->numThreads, sizeof( ws->threadBuffers[0] ) ) ) != NULL, XLAL_ENOMEM );
+  ws->threadBuffers[0].TS_FFT = ws->TS_FFT;
+  ws->threadBuffers[0].FabX_Raw = ws->FabX_Raw;
+  ws->threadBuffers[0].FaX_k = ws->FaX_k;
+  ws->threadBuffers[0].FbX_k = ws->FbX_k;
+  ws->threadBuffers[0].KFaX_k = ws1KFaX_k;
+  ws->threadBuffers[0].KFbX_k = ws1KFbX_k;
+  ws->threadBuffers[0].LFaX_k = ws2LFaX_k;
+  ws->threadBuffers[0].LFbX_k = ws2LFbX_k;
+  for ( UINT4 t = 1; t < ws->numThreads; t++ ) {
+    ResampCrossCorrThreadBuffers *buf = &( ws->threadBuffers[t] );
+    XLAL_CHECK( ( buf->TS_FFT = fftw_malloc( numSamplesFFT * sizeof( COMPLEX8 ) ) ) != NULL, XLAL_ENOMEM );
+    XLAL_CHECK( ( buf->FabX_Raw = fftw_malloc( numSamplesFFT * sizeof( COMPLEX8 ) ) ) != NULL, XLAL_ENOMEM );
+    XLAL_CHECK( ( buf->FaX_k = fftw_malloc( numFreqBins * sizeof( COMPLEX8 ) ) ) != NULL, XLAL_ENOMEM );
+    XLAL_CHECK( ( buf->FbX_k = fftw_malloc( numFreqBins * sizeof( COMPLEX8 ) ) ) != NULL, XLAL_ENOMEM );
+    XLAL_CHECK( ( buf->KFaX_k = fftw_malloc( numFreqBins * sizeof( COMPLEX8 ) ) ) != NULL, XLAL_ENOMEM );
+    XLAL_CHECK( ( buf->KFbX_k = fftw_malloc( numFreqBins * sizeof( COMPLEX8 ) ) ) != NULL, XLAL_ENOMEM );
+    XLAL_CHECK( ( buf->LFaX_k = fftw_malloc( numFreqBins * sizeof( COMPLEX8 ) ) ) != NULL, XLAL_ENOMEM );
+    XLAL_CHECK( ( buf->LFbX_k = fftw_malloc( numFreqBins * sizeof( COMPLEX8 ) ) ) != NULL, XLAL_ENOMEM );
+    XLAL_CHECK( ( buf->numeEquivAve = XLALMalloc( numFreqBins * sizeof( REAL8 ) ) ) != NULL, XLAL_ENOMEM );
+  }
+
   ( *ws1KFaX_kOut ) = ws1KFaX_k;
   ( *ws1KFbX_kOut ) = ws1KFbX_k;
   ( *ws2LFaX_kOut ) = ws2LFaX_k;
@@ -3268,8 +3371,25 @@ XLALDestroyResampCrossCorrWorkspace( void *workspace )
   fftw_free( ws->FabX_Raw );
   fftw_free( ws->TS_FFT );
 
-  XLALFree( ws->FaX_k );
-  XLALFree( ws->FbX_k );
+  /* the first thread's buffers are owned elsewhere */
+  if ( ws->threadBuffers ) {
+    for ( UINT4 t = 1; t < ws->numThreads; t++ ) {
+      ResampCrossCorrThreadBuffers *buf = &( ws->threadBuffers[t] );
+      fftw_free( buf->TS_FFT );
+      fftw_free( buf->FabX_Raw );
+      fftw_free( buf->FaX_k );
+      fftw_free( buf->FbX_k );
+      fftw_free( buf->KFaX_k );
+      fftw_free( buf->KFbX_k );
+      fftw_free( buf->LFaX_k );
+      fftw_free( buf->LFbX_k );
+      XLALFree( buf->numeEquivAve );
+    }
+    XLALFree( ws->threadBuffers );
+  }
+
+  fftw_free( ws->FaX_k );
+  fftw_free( ws->FbX_k );
   XLALFree( ws->Fa_k );
   XLALFree( ws->Fb_k );
 
@@ -3360,7 +3480,8 @@ XLALApplyCrossCorrFreqShiftResamp
 static int
 XLALComputeFaFb_CrossCorrResamp
 (
-  ResampCrossCorrWorkspace                *restrict ws,                     /**< [out] contains modified Fa and Fb for cross-correlation */
+  const ResampCrossCorrWorkspace          *restrict ws,                     /**< [in] workspace holding the FFT plan and sizes */
+  ResampCrossCorrThreadBuffers            *restrict buf,                    /**< [out] calling thread's buffers, contains modified Fa and Fb for cross-correlation */
   COMPLEX8                                *restrict wsFaX_k,                /**< [out] contains modified and normalized Fa for cross-correlation statistic */
   COMPLEX8                                *restrict wsFbX_k,                /**< [out] contains modified and normalized Fb for cross-correlation statistic */
   const MultiResampSFTPairMultiIndexList  *restrict resampMultiPairs,       /**< [in] resamp multi list of SFT pairs */
@@ -3376,6 +3497,7 @@ XLALComputeFaFb_CrossCorrResamp
 )
 {
   XLAL_CHECK( ws != NULL, XLAL_EINVAL );
+  XLAL_CHECK( buf != NULL, XLAL_EINVAL );
   XLAL_CHECK( wsFaX_k != NULL, XLAL_EINVAL );
   XLAL_CHECK( wsFbX_k != NULL, XLAL_EINVAL );
   const REAL8 FreqOut0 = dopplerpos->fkdot[0];
@@ -3524,7 +3646,7 @@ XLALComputeFaFb_CrossCorrResamp
     startFirstInd = resampDataArrayA->data->length;
   }
 
-  memset( ws->TS_FFT, 0, ws->numSamplesFFT * sizeof( ws->TS_FFT[0] ) );
+  memset( buf->TS_FFT, 0, ws->numSamplesFFT * sizeof( buf->TS_FFT[0] ) );
   UINT4 sftLength = 0;
   if ( isL == TRUE ) {
     sftLength = resampMultiPairsDetXsftK->data[detY].length;
@@ -3552,17 +3674,17 @@ XLALComputeFaFb_CrossCorrResamp
       startInd = endInd;
     }
     UINT4 headOfSliceIndex = startInd - startFirstInd;
-    XLAL_CHECK( XLALApplyCrossCorrFreqShiftResamp( ws->TS_FFT, resampDataArrayA, dopplerpos, freqShiftInFFT, startInd, endInd, ws->numSamplesFFT, headOfSliceIndex ) == XLAL_SUCCESS, XLAL_EFUNC );
+    XLAL_CHECK( XLALApplyCrossCorrFreqShiftResamp( buf->TS_FFT, resampDataArrayA, dopplerpos, freqShiftInFFT, startInd, endInd, ws->numSamplesFFT, headOfSliceIndex ) == XLAL_SUCCESS, XLAL_EFUNC );
     //}
   }
-  fftwf_execute( ws->fftplan );
+  fftwf_execute_dft( ws->fftplan, buf->TS_FFT, buf->FabX_Raw );
   for ( UINT4 k = 0; k < ws->numFreqBinsOut; k++ ) {
-    ws->FaX_k[k] = ws->FabX_Raw [ offset_bins + ( UINT4 )floor( k * RedecimateFFT )  ];
+    buf->FaX_k[k] = buf->FabX_Raw [ offset_bins + ( UINT4 )floor( k * RedecimateFFT )  ];
   }
   // END load and FFT A time series
 
   // Load and FFT B time series
-  memset( ws->TS_FFT, 0, ws->numSamplesFFT * sizeof( ws->TS_FFT[0] ) );
+  memset( buf->TS_FFT, 0, ws->numSamplesFFT * sizeof( buf->TS_FFT[0] ) );
   for ( UINT4 sft = 0; sft < sftLength; sft++ ) {
     //if (resampMultiPairsDetXsftK->data[detY].data[sft].sciFlag > 0){
     if ( isL == TRUE ) {
@@ -3582,12 +3704,12 @@ XLALComputeFaFb_CrossCorrResamp
       startInd = endInd;
     }
     UINT4 headOfSliceIndex = startInd - startFirstInd;
-    XLAL_CHECK( XLALApplyCrossCorrFreqShiftResamp( ws->TS_FFT, resampDataArrayB, dopplerpos, freqShiftInFFT, startInd, endInd, ws->numSamplesFFT, headOfSliceIndex ) == XLAL_SUCCESS, XLAL_EFUNC );
+    XLAL_CHECK( XLALApplyCrossCorrFreqShiftResamp( buf->TS_FFT, resampDataArrayB, dopplerpos, freqShiftInFFT, startInd, endInd, ws->numSamplesFFT, headOfSliceIndex ) == XLAL_SUCCESS, XLAL_EFUNC );
     //}
   }
-  fftwf_execute( ws->fftplan );
+  fftwf_execute_dft( ws->fftplan, buf->TS_FFT, buf->FabX_Raw );
   for ( UINT4 k = 0; k < ws->numFreqBinsOut; k++ ) {
-    ws->FbX_k[k] = ws->FabX_Raw [ offset_bins + ( UINT4 )floor( k * RedecimateFFT )  ];
+    buf->FbX_k[k] = buf->FabX_Raw [ offset_bins + ( UINT4 )floor( k * RedecimateFFT )  ];
   }
   // End load and FFT B time series
 
@@ -3608,8 +3730,8 @@ XLALComputeFaFb_CrossCorrResamp
     cycles = cyclesOut + cyclesIn;
     XLALSinCos2PiLUT( &sinphase, &cosphase, cycles );
     normX_k = dt_SRC * crectf( cosphase, sinphase );
-    wsFaX_k[k] = normX_k * ws->FaX_k[k];
-    wsFbX_k[k] = normX_k * ws->FbX_k[k];
+    wsFaX_k[k] = normX_k * buf->FaX_k[k];
+    wsFbX_k[k] = normX_k * buf->FbX_k[k];
   } // for k < numFreqBinsOut
 
   return XLAL_SUCCESS;
@@ -246,6 +246,19 @@ typedef struct tagResampCrossCorrTimingInfo {
 
 // ----- workspace ----------
 
+/** Per-thread scratch buffers for the threaded loop over SFT pairs in XLALCalculatePulsarCrossCorrStatisticResamp() */
+typedef struct tagResampCrossCorrThreadBuffers {
+  COMPLEX8 *TS_FFT;             //!< zero-padded, spindown-corr SRC-frame TS
+  COMPLEX8 *FabX_Raw;           //!< raw full-band FFT result Fa,Fb
+  COMPLEX8 *FaX_k;              //!< F_a^X(f_k) over output bins, before normalization
+  COMPLEX8 *FbX_k;              //!< F_b^X(f_k) over output bins, before normalization
+  COMPLEX8 *KFaX_k;             //!< holder for detector 1 Fa
+  COMPLEX8 *KFbX_k;             //!< holder for detector 1 Fb
+  COMPLEX8 *LFaX_k;             //!< holder for detector 2 Fa
+  COMPLEX8 *LFbX_k;             //!< holder for detector 2 Fb
+  REAL8 *numeEquivAve;          //!< partial sums of the average statistic over this thread's pairs
+} ResampCrossCorrThreadBuffers;
+
 typedef struct tagResampCrossCorrWorkspace {
   // intermediate quantities to interpolate and operate on SRC-frame timeseries
   COMPLEX8Vector *TStmp1_SRC;   //!< can hold a single-detector SRC-frame spindown-corrected timeseries [without zero-padding]
@@ -267,6 +280,10 @@ typedef struct tagResampCrossCorrWorkspace {
   COMPLEX8 *Fb_k;               //!< properly normalized F_b(f_k) over output bins
   UINT4 numFreqBinsAlloc;       //!< internal: keep track of allocated length of frequency-arrays
 
+  // scratch space for each thread; entry 0 points at the buffers above and the caller's Fa/Fb holders
+  UINT4 numThreads;             //!< number of threads scratch space is allocated for
+  ResampCrossCorrThreadBuffers *threadBuffers; //!< array of per-thread scratch buffers
+
   ResampCrossCorrTimingInfo *timingInfo; //!< pointer to storage for collecting timing data (which lives in ResampMethodData)
 } ResampCrossCorrWorkspace;
 
@@ -71,6 +71,11 @@
  * constructs the total Hough map \c ht by integrating the \c hd,
  * and outputs the \c ht into a file.
  *
+ * It then adds several weighted \c phmd into a Hough map derivative with
+ * LALHOUGHAddPHMD2HD_W(), which uses an AVX2 kernel on CPUs that support
+ * it, and checks that the result is bit-for-bit identical to a plain
+ * scalar accumulation of the same \c phmd.
+ *
  * By default, running this program with no arguments simply tests the subroutines,
  * producing an output file called <tt>OutHough.asc</tt>.  All default parameters are set from
  * <tt>\#define</tt>d constants.
@@ -91,6 +96,7 @@
  * LALHOUGHInitializeHT()
  * LALHOUGHInitializeHD()
  * LALHOUGHAddPHMD2HD()
+ * LALHOUGHAddPHMD2HD_W()
  * LALHOUGHIntegrHD2HT()
  * LALPrintError()
  * LALMalloc()
@@ -100,7 +106,16 @@
  *
  */
 
+#include <config.h>
+
+#include <string.h>
+
 #include <lal/HoughMap.h>
+#include <lal/LALSIMD.h>
+
+#ifdef HAVE_AVX2_COMPILER
+int XLALHOUGHAddPHMD2HDBorders_AVX2(HoughDT *map, HOUGHBorder **pBorderP, INT4 length, HoughDT weight, INT4 xSide, INT4 ySide);
+#endif
 
 /**\name Error Codes */ /** @{ */
 #define TESTHOUGHMAPC_ENORM 0
@@ -130,6 +145,7 @@
 #define MWR 1             /*.minWidthRatio */
 #define FILEOUT "OutHough.asc"      /* file output */
 #define PIXELFACTOR 2
+#define NPHMD 8           /* number of weighted phmd to accumulate */
 /* Usage format string. */
 
 #define USAGE "Usage: %s [-d debuglevel] [-o outfile] [-f f0] [-p alpha delta] [-s patchSizeX patchSizeY]\n"
@@ -165,6 +181,32 @@ do {                                                                 \
 } while (0)
 /******************************************************************/
 
+/* Reference accumulation of a weighted phmd, as in the scalar loop of
+   LALHOUGHAddPHMD2HD_W() */
+static int AddPHMD2HDReference( HoughDT *map, HOUGHphmd *phmd, UINT2 xSide, UINT2 ySide )
+{
+  INT4 k, j, sidx;
+
+  for ( k = 0; k < ySide; ++k ) {
+    map[k * ( xSide + 1 )] += phmd->firstColumn[k] * phmd->weight;
+  }
+  for ( k = 0; k < phmd->lengthLeft + phmd->lengthRight; ++k ) {
+    HOUGHBorder *borderP = ( k < phmd->lengthLeft ) ? phmd->leftBorderP[k] : phmd->rightBorderP[k - phmd->lengthLeft];
+    HoughDT weight = ( k < phmd->lengthLeft ) ? phmd->weight : -phmd->weight;
+    INT4 yLower = borderP->yLower < 0 ? 0 : borderP->yLower;
+    INT4 yUpper = borderP->yUpper >= ySide ? ySide - 1 : borderP->yUpper;
+    for ( j = yLower; j <= yUpper; ++j ) {
+      sidx = j * ( xSide + 1 ) + borderP->xPixel[j];
+      if ( ( sidx < 0 ) || ( sidx >= ySide * ( xSide + 1 ) ) ) {
+        return 1;
+      }
+      map[sidx] += weight;
+    }
+  }
+
+  return 0;
+}
+
 /* >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>><<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<< */
 /* vvvvvvvvvvvvvvvvvvvvvvvvvvvvvv------------------------------------ */
 int main( int argc, char *argv[] )
@@ -195,6 +237,9 @@ int main( int argc, char *argv[] )
   INT4 i, j;                      /* Index counter, etc */
   UINT4 k;
 
+  HoughDT *mapRef = NULL;           /* scalar reference Hough map derivative */
+  UINT4 mapLength, maxBorderRows = 0;
+
   REAL8 f0, alpha, delta, veloMod;
   REAL8 patchSizeX, patchSizeY;
 
@@ -471,6 +516,67 @@ int main( int argc, char *argv[] )
   fclose( fp );
 
 
+  /******************************************************************/
+  /* add weighted PHMDs with LALHOUGHAddPHMD2HD_W() and compare     */
+  /* bit for bit with a scalar accumulation                         */
+  /******************************************************************/
+
+  mapLength = ( xSide + 1 ) * ySide;
+  mapRef = ( HoughDT * )LALMalloc( mapLength * sizeof( HoughDT ) );
+
+  SUB( LALHOUGHInitializeHD( &status, &hd ), &status );
+  memset( mapRef, 0, mapLength * sizeof( HoughDT ) );
+
+  for ( k = 0; k < NPHMD; ++k ) {
+    phmd.fBin = f0Bin + 21 + k;
+    phmd.weight = 0.1 + 0.37 * k;   /* not exactly representable */
+    SUB( LALHOUGHPeak2PHMD( &status, &phmd, &lut, &pg ), &status );
+    for ( i = 0; i < phmd.lengthLeft; ++i ) {
+      if ( phmd.leftBorderP[i]->yUpper - phmd.leftBorderP[i]->yLower + 1 > ( INT4 )maxBorderRows ) {
+        maxBorderRows = phmd.leftBorderP[i]->yUpper - phmd.leftBorderP[i]->yLower + 1;
+      }
+    }
+    SUB( LALHOUGHAddPHMD2HD_W( &status, &hd, &phmd ), &status );
+    if ( AddPHMD2HDReference( mapRef, &phmd, xSide, ySide ) != 0 ) {
+      ERROR( TESTHOUGHMAPC_EBAD, TESTHOUGHMAPC_MSGEBAD, "reference map index out of bounds:" );
+      return TESTHOUGHMAPC_EBAD;
+    }
+  }
+
+  /* the vectorised kernel works on eight rows of a border at a time */
+  if ( maxBorderRows < 8 ) {
+    ERROR( TESTHOUGHMAPC_EBAD, TESTHOUGHMAPC_MSGEBAD, "borders too short to test:" );
+    return TESTHOUGHMAPC_EBAD;
+  }
+
+  if ( memcmp( hd.map, mapRef, mapLength * sizeof( HoughDT ) ) != 0 ) {
+    ERROR( TESTHOUGHMAPC_EBAD, TESTHOUGHMAPC_MSGEBAD, "LALHOUGHAddPHMD2HD_W() differs from scalar accumulation:" );
+    return TESTHOUGHMAPC_EBAD;
+  }
+
+#ifdef HAVE_AVX2_COMPILER
+  /* call the AVX2 kernel directly on the borders of the last PHMD */
+  if ( LAL_HAVE_AVX2_RUNTIME() ) {
+    memcpy( hd.map, mapRef, mapLength * sizeof( HoughDT ) );
+    for ( k = 0; k < ySide; ++k ) {
+      hd.map[k * ( xSide + 1 )] += phmd.firstColumn[k] * phmd.weight;
+    }
+    if ( XLALHOUGHAddPHMD2HDBorders_AVX2( hd.map, phmd.leftBorderP, phmd.lengthLeft, phmd.weight, xSide, ySide ) != XLAL_SUCCESS ||
+         XLALHOUGHAddPHMD2HDBorders_AVX2( hd.map, phmd.rightBorderP, phmd.lengthRight, -phmd.weight, xSide, ySide ) != XLAL_SUCCESS ) {
+      ERROR( TESTHOUGHMAPC_ESUB, TESTHOUGHMAPC_MSGESUB, "XLALHOUGHAddPHMD2HDBorders_AVX2() failed:" );
+      return TESTHOUGHMAPC_ESUB;
+    }
+    if ( AddPHMD2HDReference( mapRef, &phmd, xSide, ySide ) != 0 ||
+         memcmp( hd.map, mapRef, mapLength * sizeof( HoughDT ) ) != 0 ) {
+      ERROR( TESTHOUGHMAPC_EBAD, TESTHOUGHMAPC_MSGEBAD, "XLALHOUGHAddPHMD2HDBorders_AVX2() differs from scalar accumulation:" );
+      return TESTHOUGHMAPC_EBAD;
+    }
+  }
+#endif
+
+  LALFree( mapRef );
+
+
   /******************************************************************/
   /* Free memory and exit */
   /******************************************************************/
@@ -0,0 +1,374 @@
+/*
+*  This program is free software; you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 2 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with with program; see the file COPYING. If not, write to the
+*  Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+*  MA  02110-1301  USA
+*/
+
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <lal/XLALError.h>
+#include <lal/LALConstants.h>
+#include <lal/LALString.h>
+#include <lal/LALInitBarycenter.h>
+#include <lal/Random.h>
+#include <lal/ComputeFstat.h>
+#include <lal/GeneratePulsarSignal.h>
+#include <lal/PulsarCrossCorr_v2.h>
+
+#define TRUE (1==1)
+#define FALSE (1==0)
+
+// consistency checks of the CrossCorr v2 statistics:
+// - the multi-bin statistic, which sums over the bins of each SFT once,
+//   against the double sum over the bins of both SFTs of every pair
+// - the resampling statistic computed by several threads against one thread
+
+static int test_multibin_statistic( void );
+static int test_resamp_statistic_threads( void );
+static int pairwise_statistic( REAL8 *ccStat, REAL8 *evSquared, const REAL8Vector *curlyGAmp, const COMPLEX8Vector *expSignalPhases, const UINT4Vector *lowestBins, const REAL8VectorSequence *sincList, const SFTPairIndexList *sftPairs, const SFTIndexList *sftIndices, const MultiSFTVector *inputSFTs, const MultiNoiseWeights *multiWeights, UINT4 numBins );
+
+// ---------- main ----------
+int
+main( int argc, char *argv[] )
+{
+  XLAL_CHECK( argc == 1, XLAL_EINVAL, "No input arguments allowed.\n" );
+  XLAL_CHECK( argv != NULL, XLAL_EINVAL );
+
+  XLAL_CHECK( test_multibin_statistic() == XLAL_SUCCESS, XLAL_EFUNC );
+  XLAL_CHECK( test_resamp_statistic_threads() == XLAL_SUCCESS, XLAL_EFUNC );
+
+  LALCheckMemoryLeaks();
+
+  return XLAL_SUCCESS;
+
+} // main()
+
+static int
+test_multibin_statistic( void )
+{
+  const UINT4 numDetectors = 2;
+  const UINT4 numSFTsPerDet = 5;
+  const UINT4 sftLength = 16;
+  const REAL8 Tsft = 1800;
+  const REAL8 maxLag = 2 * Tsft;
+  const REAL8 tol = 1e-10;
+
+  RandomParams *randParams = NULL;
+  XLAL_CHECK( ( randParams = XLALCreateRandomParams( 4321 ) ) != NULL, XLAL_EFUNC );
+
+  // ----- random SFT data for two detectors
+  UINT4Vector *numSFTs = NULL;
+  XLAL_CHECK( ( numSFTs = XLALCreateUINT4Vector( numDetectors ) ) != NULL, XLAL_EFUNC );
+  for ( UINT4 X = 0; X < numDetectors; X ++ ) {
+    numSFTs->data[X] = numSFTsPerDet;
+  }
+  MultiSFTVector *inputSFTs = NULL;
+  XLAL_CHECK( ( inputSFTs = XLALCreateMultiSFTVector( sftLength, numSFTs ) ) != NULL, XLAL_EFUNC );
+  for ( UINT4 X = 0; X < numDetectors; X ++ ) {
+    for ( UINT4 n = 0; n < numSFTsPerDet; n ++ ) {
+      SFTtype *sft = &( inputSFTs->data[X]->data[n] );
+      XLALStringCopy( sft->name, ( X == 0 ) ? "H1" : "L1", sizeof( sft->name ) );
+      sft->epoch.gpsSeconds = 711595934 + n * Tsft + X * 0.5 * Tsft;
+      sft->f0 = 100.0;
+      sft->deltaF = 1.0 / Tsft;
+      for ( UINT4 k = 0; k < sftLength; k ++ ) {
+        sft->data->data[k] = crectf( 2.0 * XLALUniformDeviate( randParams ) - 1.0, 2.0 * XLALUniformDeviate( randParams ) - 1.0 );
+      }
+    }
+  }
+
+  SFTIndexList *sftIndices = NULL;
+  XLAL_CHECK( XLALCreateSFTIndexListFromMultiSFTVect( &sftIndices, inputSFTs ) == XLAL_SUCCESS, XLAL_EFUNC );
+  SFTPairIndexList *sftPairs = NULL;
+  XLAL_CHECK( XLALCreateSFTPairIndexList( &sftPairs, sftIndices, inputSFTs, maxLag, TRUE ) == XLAL_SUCCESS, XLAL_EFUNC );
+  const UINT4 numSFTsTotal = sftIndices->length;
+  const UINT4 numPairs = sftPairs->length;
+  XLAL_CHECK( numPairs > numSFTsTotal, XLAL_EFAILED, "Expected pairs between different SFTs, got %u pairs for %u SFTs\n", numPairs, numSFTsTotal );
+
+  // ----- random signal amplitudes and phases, common to all numbers of bins
+  REAL8Vector *curlyGAmp = NULL;
+  XLAL_CHECK( ( curlyGAmp = XLALCreateREAL8Vector( numPairs ) ) != NULL, XLAL_EFUNC );
+  for ( UINT4 alpha = 0; alpha < numPairs; alpha ++ ) {
+    curlyGAmp->data[alpha] = 0.1 + XLALUniformDeviate( randParams );
+  }
+  COMPLEX8Vector *expSignalPhases = NULL;
+  XLAL_CHECK( ( expSignalPhases = XLALCreateCOMPLEX8Vector( numSFTsTotal ) ) != NULL, XLAL_EFUNC );
+  for ( UINT4 sftNum = 0; sftNum < numSFTsTotal; sftNum ++ ) {
+    expSignalPhases->data[sftNum] = cexpf( crectf( 0, LAL_TWOPI * XLALUniformDeviate( randParams ) ) );
+  }
+  UINT4Vector *lowestBins = NULL;
+  XLAL_CHECK( ( lowestBins = XLALCreateUINT4Vector( numSFTsTotal ) ) != NULL, XLAL_EFUNC );
+
+  MultiNoiseWeights XLAL_INIT_DECL( multiWeights );
+  multiWeights.Sinv_Tsft = 2.5;
+
+  const UINT4 numBinsList[] = { 1, 2, 3, 4 };
+  for ( UINT4 i = 0; i < XLAL_NUM_ELEM( numBinsList ); i ++ ) {
+    const UINT4 numBins = numBinsList[i];
+
+    // lowest bins are random, so that pairs have both even and odd bin offsets
+    for ( UINT4 sftNum = 0; sftNum < numSFTsTotal; sftNum ++ ) {
+      lowestBins->data[sftNum] = ( UINT4 ) floor( ( sftLength - numBins + 1 ) * XLALUniformDeviate( randParams ) );
+    }
+    REAL8VectorSequence *sincList = NULL;
+    XLAL_CHECK( ( sincList = XLALCreateREAL8VectorSequence( numSFTsTotal, numBins ) ) != NULL, XLAL_EFUNC );
+    for ( UINT4 j = 0; j < numSFTsTotal * numBins; j ++ ) {
+      sincList->data[j] = 2.0 * XLALUniformDeviate( randParams ) - 1.0;
+    }
+
+    REAL8 ccStat = 0, evSquared = 0;
+    XLAL_CHECK( XLALCalculatePulsarCrossCorrStatistic( &ccStat, &evSquared, curlyGAmp, expSignalPhases, lowestBins, sincList, sftPairs, sftIndices, inputSFTs, &multiWeights, numBins ) == XLAL_SUCCESS, XLAL_EFUNC );
+    REAL8 ccStatRef = 0, evSquaredRef = 0;
+    XLAL_CHECK( pairwise_statistic( &ccStatRef, &evSquaredRef, curlyGAmp, expSignalPhases, lowestBins, sincList, sftPairs, sftIndices, inputSFTs, &multiWeights, numBins ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+    // ccStat is normalised to unit variance, so compare it absolutely
+    const REAL8 errCCStat = fabs( ccStat - ccStatRef );
+    const REAL8 errEvSquared = fabs( evSquared - evSquaredRef ) / evSquaredRef;
+    XLALPrintInfo( "numBins=%u: ccStat=%.12g (pairwise %.12g), evSquared=%.12g (pairwise %.12g)\n", numBins, ccStat, ccStatRef, evSquared, evSquaredRef );
+    XLAL_CHECK( errCCStat <= tol, XLAL_ETOL, "numBins=%u: ccStat=%.12g differs from pairwise sum %.12g by %g > %g\n", numBins, ccStat, ccStatRef, errCCStat, tol );
+    XLAL_CHECK( errEvSquared <= tol, XLAL_ETOL, "numBins=%u: evSquared=%.12g differs from pairwise sum %.12g by relative %g > %g\n", numBins, evSquared, evSquaredRef, errEvSquared, tol );
+
+    // a bin range running off the end of an SFT must still be caught
+    const UINT4 savedLowestBin = lowestBins->data[numSFTsTotal - 1];
+    lowestBins->data[numSFTsTotal - 1] = sftLength - numBins + 1;
+    int errnum;
+    int retn;
+    XLAL_TRY( retn = XLALCalculatePulsarCrossCorrStatistic( &ccStat, &evSquared, curlyGAmp, expSignalPhases, lowestBins, sincList, sftPairs, sftIndices, inputSFTs, &multiWeights, numBins ), errnum );
+    XLAL_CHECK( retn == XLAL_FAILURE && errnum == XLAL_EINVAL, XLAL_EFAILED, "numBins=%u: bins off the end of an SFT were not rejected\n", numBins );
+    lowestBins->data[numSFTsTotal - 1] = savedLowestBin;
+
+    XLALDestroyREAL8VectorSequence( sincList );
+  }
+
+  XLALDestroyUINT4Vector( lowestBins );
+  XLALDestroyCOMPLEX8Vector( expSignalPhases );
+  XLALDestroyREAL8Vector( curlyGAmp );
+  XLALDestroySFTPairIndexList( sftPairs );
+  XLALDestroySFTIndexList( sftIndices );
+  XLALDestroyMultiSFTVector( inputSFTs );
+  XLALDestroyUINT4Vector( numSFTs );
+  XLALDestroyRandomParams( randParams );
+
+  return XLAL_SUCCESS;
+
+} // test_multibin_statistic()
+
+/* Direct double sum over the bins j, k of both SFTs of every pair, as the
+ * multi-bin statistic was computed before it was factorised per SFT */
+static int
+pairwise_statistic( REAL8 *ccStat, REAL8 *evSquared, const REAL8Vector *curlyGAmp, const COMPLEX8Vector *expSignalPhases, const UINT4Vector *lowestBins, const REAL8VectorSequence *sincList, const SFTPairIndexList *sftPairs, const SFTIndexList *sftIndices, const MultiSFTVector *inputSFTs, const MultiNoiseWeights *multiWeights, UINT4 numBins )
+{
+  REAL8 nume = 0;
+  REAL8 curlyGSqr = 0;
+  for ( UINT4 alpha = 0; alpha < sftPairs->length; alpha ++ ) {
+    const UINT4 sftNum1 = sftPairs->data[alpha].sftNum[0];
+    const UINT4 sftNum2 = sftPairs->data[alpha].sftNum[1];
+    const SFTIndex *idx1 = &( sftIndices->data[sftNum1] );
+    const SFTIndex *idx2 = &( sftIndices->data[sftNum2] );
+    const COMPLEX8 *dataArray1 = inputSFTs->data[idx1->detInd]->data[idx1->sftInd].data->data;
+    const COMPLEX8 *dataArray2 = inputSFTs->data[idx2->detInd]->data[idx2->sftInd].data->data;
+    const UINT4 lowestBin1 = lowestBins->data[sftNum1];
+    const UINT4 lowestBin2 = lowestBins->data[sftNum2];
+    const COMPLEX8 GalphaCC = curlyGAmp->data[alpha]
+                              * expSignalPhases->data[sftNum1]
+                              * conj( expSignalPhases->data[sftNum2] );
+    for ( UINT4 j = 0; j < numBins; j ++ ) {
+      for ( UINT4 k = 0; k < numBins; k ++ ) {
+        const INT4 ccSign = ( ( lowestBin1 + j + lowestBin2 + k ) % 2 == 0 ) ? 1 : -1;
+        const REAL8 sincFactor = sincList->data[sftNum1 * numBins + j] * sincList->data[sftNum2 * numBins + k];
+        const COMPLEX16 data1 = dataArray1[lowestBin1 + j];
+        const COMPLEX16 data2 = dataArray2[lowestBin2 + k];
+        nume += ccSign * sincFactor * creal( GalphaCC * conj( data1 ) * data2 );
+        curlyGSqr += pow( curlyGAmp->data[alpha] * sincFactor, 2 );
+      }
+    }
+  }
+  XLAL_CHECK( curlyGSqr > 0, XLAL_EFAILED );
+  *evSquared = 8 * pow( multiWeights->Sinv_Tsft, 2 ) * curlyGSqr;
+  *ccStat = 4 * multiWeights->Sinv_Tsft * nume / sqrt( *evSquared );
+
+  return XLAL_SUCCESS;
+
+} // pairwise_statistic()
+
+static int
+test_resamp_statistic_threads( void )
+{
+  const REAL8 tol = 1e-10;
+
+  // ----- load ephemeris
+  EphemerisData *ephem;
+  XLAL_CHECK( ( ephem = XLALInitBarycenter( TEST_PKG_DATA_DIR "earth00-40-DE405.dat.gz", TEST_PKG_DATA_DIR "sun00-40-DE405.dat.gz" ) ) != NULL, XLAL_EFUNC );
+
+  // ----- setup data parameters
+  LALStringVector *detNames = NULL;
+  XLAL_CHECK( ( detNames = XLALCreateStringVector( "H1", "L1", NULL ) ) != NULL, XLAL_EFUNC );
+  const UINT4 numDetectors = detNames->length;
+
+  const LIGOTimeGPS startTime = {711595934, 0};
+  const REAL8 Tsft = 1800;
+  const REAL8 Tspan = 20 * Tsft;
+  const REAL8 tShort = Tsft;
+  const REAL8 maxLag = 2 * Tsft;
+  const REAL8 Tcoh = 2 * maxLag + tShort;
+
+  MultiLIGOTimeGPSVector *multiTimes = NULL;
+  XLAL_CHECK( ( multiTimes = XLALMakeMultiTimestamps( startTime, Tspan, Tsft, 0, numDetectors ) ) != NULL, XLAL_EFUNC );
+  SFTCatalog *catalog = NULL;
+  XLAL_CHECK( ( catalog = XLALMultiAddToFakeSFTCatalog( NULL, detNames, multiTimes ) ) != NULL, XLAL_EFUNC );
+
+  // ----- a binary CW source in Gaussian noise
+  const REAL8 Freq = 100.0;
+  const REAL8 h0 = 1.0;
+  const REAL8 cosi = 0.5;
+  PulsarDopplerParams XLAL_INIT_DECL( Doppler );
+  Doppler.Alpha = 0.5;
+  Doppler.Delta = -0.5;
+  Doppler.fkdot[0] = Freq;
+  Doppler.refTime = startTime;
+  Doppler.asini = 0.1;
+  Doppler.period = 19 * 3600;
+  Doppler.tp = startTime;
+
+  PulsarParamsVector *injectSources;
+  XLAL_CHECK( ( injectSources = XLALCreatePulsarParamsVector( 1 ) ) != NULL, XLAL_EFUNC );
+  injectSources->data[0].Amp.aPlus  = 0.5 * h0 * ( 1.0 + cosi * cosi );
+  injectSources->data[0].Amp.aCross = h0 * cosi;
+  injectSources->data[0].Amp.psi  = 0.1;
+  injectSources->data[0].Amp.phi0 = 1.2;
+  injectSources->data[0].Doppler = Doppler;
+
+  MultiNoiseFloor XLAL_INIT_DECL( injectSqrtSX );
+  injectSqrtSX.length = numDetectors;
+  for ( UINT4 X = 0; X < numDetectors; X ++ ) {
+    injectSqrtSX.sqrtSn[X] = 1.0;
+  }
+
+  // ----- resampling F-stat input covering the Doppler wings of the band searched, as in pulsar_crosscorr_v2
+  PulsarDopplerParams XLAL_INIT_DECL( binaryTemplateSpacings );
+  binaryTemplateSpacings.fkdot[0] = 0.5 / Tcoh;
+  const UINT4 numFreqBins = 16;
+  REAL8 extraPerFreq = 1.05 * LAL_TWOPI / LAL_C_SI * ( ( LAL_AU_SI / LAL_YRSID_SI ) + ( LAL_REARTH_SI / LAL_DAYSID_SI ) );
+  extraPerFreq += LAL_TWOPI / Doppler.period * Doppler.asini;
+  const REAL8 fCoverMin = Freq * ( 1.0 - extraPerFreq );
+  const REAL8 fCoverMax = ( Freq + numFreqBins * binaryTemplateSpacings.fkdot[0] ) * ( 1.0 + extraPerFreq );
+
+  FstatOptionalArgs optionalArgs = FstatOptionalArgsDefaults;
+  optionalArgs.FstatMethod = FMETHOD_RESAMP_BEST;
+  optionalArgs.resampFFTPowerOf2 = FALSE;
+  optionalArgs.injectSources = injectSources;
+  optionalArgs.injectSqrtSX = &injectSqrtSX;
+  optionalArgs.randSeed = 1234;
+  XLAL_CHECK( setenv( "LAL_FSTAT_FFT_PLAN_MODE", "ESTIMATE", 1 ) == XLAL_SUCCESS, XLAL_ESYS );
+  FstatInput *resampFstatInput = NULL;
+  XLAL_CHECK( ( resampFstatInput = XLALCreateFstatInput( catalog, fCoverMin, fCoverMax, 1.0 / Tspan, ephem, &optionalArgs ) ) != NULL, XLAL_EFUNC );
+
+  // ----- pairs of short segments
+  const UINT4 numShortPerDet = XLALCrossCorrNumShortPerDetector( tShort, startTime.gpsSeconds, startTime.gpsSeconds + Tspan );
+  XLAL_CHECK( numShortPerDet > 0, XLAL_EFUNC );
+  MultiREAL8TimeSeries *scienceFlagVect = NULL;
+  MultiLIGOTimeGPSVector *resampMultiTimes = NULL;
+  XLAL_CHECK( ( resampMultiTimes = XLALModifyMultiTimestampsFromSFTs( &scienceFlagVect, multiTimes, tShort, numShortPerDet ) ) != NULL, XLAL_EFUNC );
+  MultiResampSFTPairMultiIndexList *resampMultiPairs = NULL;
+  XLAL_CHECK( XLALCreateSFTPairIndexListShortResamp( &resampMultiPairs, maxLag, FALSE, TRUE, Tsft, resampMultiTimes ) == XLAL_SUCCESS, XLAL_EFUNC );
+  XLAL_CHECK( XLALEquipCrossCorrPairsWithScienceFlags( resampMultiPairs, scienceFlagVect ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+  REAL8Vector *resampGammaAve = NULL;
+  XLAL_CHECK( ( resampGammaAve = XLALCreateREAL8Vector( resampMultiPairs->allPairCount ) ) != NULL, XLAL_EFUNC );
+  for ( UINT4 alpha = 0; alpha < resampGammaAve->length; alpha ++ ) {
+    resampGammaAve->data[alpha] = 0.1 * ( 1.0 + cos( alpha ) );
+  }
+  MultiNoiseWeights XLAL_INIT_DECL( multiWeights );
+  multiWeights.Sinv_Tsft = 2.5;
+
+  // ----- resampled time series for a template offset from the source
+  PulsarDopplerParams dopplerpos = Doppler;
+  dopplerpos.fkdot[0] = Freq - 0.5 * numFreqBins * binaryTemplateSpacings.fkdot[0];
+  FstatResults *Fstats = NULL;
+  XLAL_CHECK( XLALComputeFstat( &Fstats, resampFstatInput, &dopplerpos, numFreqBins, FSTATQ_NONE ) == XLAL_SUCCESS, XLAL_EFUNC );
+  MultiCOMPLEX8TimeSeries *multiTimeSeries_SRC_a = NULL;
+  MultiCOMPLEX8TimeSeries *multiTimeSeries_SRC_b = NULL;
+  XLAL_CHECK( XLALExtractResampledTimeseries( &multiTimeSeries_SRC_a, &multiTimeSeries_SRC_b, resampFstatInput ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+  // ----- the statistic computed by one thread, then by several
+  REAL8Vector *ccStat[2], *evSquared[2], *numeEquivAve[2], *numeEquivCirc[2];
+  const int numThreadsList[2] = { 1, 3 };
+  for ( UINT4 i = 0; i < 2; i ++ ) {
+#ifdef _OPENMP
+    omp_set_num_threads( numThreadsList[i] );
+#endif
+    ResampCrossCorrWorkspace *ws = NULL;
+    COMPLEX8 *ws1KFaX_k = NULL;
+    COMPLEX8 *ws1KFbX_k = NULL;
+    COMPLEX8 *ws2LFaX_k = NULL;
+    COMPLEX8 *ws2LFbX_k = NULL;
+    XLAL_CHECK( XLALCreateCrossCorrWorkspace( &ws, &ws1KFaX_k, &ws1KFbX_k, &ws2LFaX_k, &ws2LFbX_k, &multiTimeSeries_SRC_a, &multiTimeSeries_SRC_b, binaryTemplateSpacings, resampFstatInput, numFreqBins, Tcoh, TRUE ) == XLAL_SUCCESS, XLAL_EFUNC );
+#ifdef _OPENMP
+    XLAL_CHECK( ws->numThreads == ( UINT4 ) numThreadsList[i], XLAL_EFAILED, "Workspace set up for %u threads, expected %d\n", ws->numThreads, numThreadsList[i] );
+#endif
+
+    XLAL_CHECK( ( ccStat[i] = XLALCreateREAL8Vector( numFreqBins ) ) != NULL, XLAL_EFUNC );
+    XLAL_CHECK( ( evSquared[i] = XLALCreateREAL8Vector( numFreqBins ) ) != NULL, XLAL_EFUNC );
+    XLAL_CHECK( ( numeEquivAve[i] = XLALCreateREAL8Vector( numFreqBins ) ) != NULL, XLAL_EFUNC );
+    XLAL_CHECK( ( numeEquivCirc[i] = XLALCreateREAL8Vector( numFreqBins ) ) != NULL, XLAL_EFUNC );
+    XLAL_CHECK( XLALCalculatePulsarCrossCorrStatisticResamp( ccStat[i], evSquared[i], numeEquivAve[i], numeEquivCirc[i], resampGammaAve, resampMultiPairs, &multiWeights, &binaryTemplateSpacings, &dopplerpos, multiTimeSeries_SRC_a, multiTimeSeries_SRC_b, ws, ws1KFaX_k, ws1KFbX_k, ws2LFaX_k, ws2LFbX_k ) == XLAL_SUCCESS, XLAL_EFUNC );
+
+    XLALDestroyResampCrossCorrWorkspace( ws );
+    fftw_free( ws1KFaX_k );
+    fftw_free( ws1KFbX_k );
+    fftw_free( ws2LFaX_k );
+    fftw_free( ws2LFbX_k );
+  }
+
+  // ----- partial sums are added in a different order, so compare to rounding
+  REAL8 maxCCStat = 0;
+  for ( UINT4 j = 0; j < numFreqBins; j ++ ) {
+    maxCCStat = fmax( maxCCStat, fabs( ccStat[0]->data[j] ) );
+  }
+  XLAL_CHECK( maxCCStat > 0, XLAL_EFAILED, "Statistic vanishes in all %u bins\n", numFreqBins );
+  for ( UINT4 j = 0; j < numFreqBins; j ++ ) {
+    XLALPrintInfo( "bin %u: ccStat=%.12g (%d threads), %.12g (%d threads)\n", j, ccStat[0]->data[j], numThreadsList[0], ccStat[1]->data[j], numThreadsList[1] );
+    const REAL8 errCCStat = fabs( ccStat[1]->data[j] - ccStat[0]->data[j] ) / maxCCStat;
+    XLAL_CHECK( errCCStat <= tol, XLAL_ETOL, "bin %u: ccStat=%.12g with %d threads differs from %.12g with %d threads by relative %g > %g\n", j, ccStat[1]->data[j], numThreadsList[1], ccStat[0]->data[j], numThreadsList[0], errCCStat, tol );
+    XLAL_CHECK( evSquared[1]->data[j] == evSquared[0]->data[j], XLAL_ETOL, "bin %u: evSquared=%.12g with %d threads differs from %.12g with %d threads\n", j, evSquared[1]->data[j], numThreadsList[1], evSquared[0]->data[j], numThreadsList[0] );
+  }
+
+  for ( UINT4 i = 0; i < 2; i ++ ) {
+    XLALDestroyREAL8Vector( ccStat[i] );
+    XLALDestroyREAL8Vector( evSquared[i] );
+    XLALDestroyREAL8Vector( numeEquivAve[i] );
+    XLALDestroyREAL8Vector( numeEquivCirc[i] );
+  }
+  XLALDestroyFstatResults( Fstats );
+  XLALDestroyREAL8Vector( resampGammaAve );
+  // the flat SFT and pair lists are not owned by the multi-list
+  XLALDestroySFTIndexList( resampMultiPairs->indexList );
+  XLALDestroySFTPairIndexList( resampMultiPairs->pairIndexList );
+  XLALDestroyMultiResampSFTPairMultiIndexList( resampMultiPairs );
+  XLALDestroyMultiTimestamps( resampMultiTimes );
+  XLALDestroyMultiREAL8TimeSeries( scienceFlagVect );
+  XLALDestroyFstatInput( resampFstatInput );
+  XLALDestroyPulsarParamsVector( injectSources );
+  XLALDestroySFTCatalog( catalog );
+  XLALDestroyMultiTimestamps( multiTimes );
+  XLALDestroyStringVector( detNames );
+  XLALDestroyEphemerisData( ephem );
+
+  return XLAL_SUCCESS;
+
+} // test_resamp_statistic_threads()
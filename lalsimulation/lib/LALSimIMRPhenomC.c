@@ -362,16 +362,10 @@ static int IMRPhenomCGenerateFD(
     REAL8 aPhenomC = 0.0;
     REAL8 f = i * deltaF;
 
-    int per_thread_errcode;
-    #pragma omp flush(errcode)
-    if (errcode != XLAL_SUCCESS)
+    if (XLALGetCollectedErrno(&errcode) != XLAL_SUCCESS)
       goto skip;
 
-    per_thread_errcode = IMRPhenomCGenerateAmpPhase( &aPhenomC, &phPhenomC, f, eta, params );
-    if (per_thread_errcode != XLAL_SUCCESS) {
-      errcode = per_thread_errcode;
-      #pragma omp flush(errcode)
-    }
+    XLALCollectErrno(&errcode, IMRPhenomCGenerateAmpPhase( &aPhenomC, &phPhenomC, f, eta, params ));
 
     phPhenomC -= 2.*phi0; // factor of 2 b/c phi0 is orbital phase
 
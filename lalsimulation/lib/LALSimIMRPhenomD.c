@@ -37,9 +37,12 @@ UsefulPowers powers_of_pi;	// declared in LALSimIMRPhenomD_internals.c
  *
  */
 
+static int IMRPhenomDFrequencySequence(COMPLEX16FrequencySeries **htilde, const REAL8Sequence *freqs, const LALSimInspiralFrequencyGrid *grid, const REAL8 phi0, const REAL8 fRef_in, const REAL8 m1_SI, const REAL8 m2_SI, const REAL8 chi1, const REAL8 chi2, const REAL8 distance, LALDict *extraParams, NRTidal_version_type NRTidal_version);
+
 static int IMRPhenomDGenerateFD(
     COMPLEX16FrequencySeries **htilde, /**< [out] FD waveform */
     const REAL8Sequence *freqs_in,     /**< Frequency points at which to evaluate the waveform (Hz) */
+    const LALSimInspiralFrequencyGrid *grid, /**< cached powers of freqs_in, or NULL; only used if deltaF <= 0 */
     double deltaF,                     /**< If deltaF > 0, the frequency points given in freqs are uniformly spaced with
                                         * spacing deltaF. Otherwise, the frequency points are spaced non-uniformly.
                                         * Then we will use deltaF = 0 to create the frequency series we return. */
@@ -163,7 +166,7 @@ int XLALSimIMRPhenomDGenerateFD(
   REAL8Sequence *freqs = XLALCreateREAL8Sequence(2);
   freqs->data[0] = f_min;
   freqs->data[1] = f_max_prime;
-  int status = IMRPhenomDGenerateFD(htilde, freqs, deltaF, phi0, fRef,
+  int status = IMRPhenomDGenerateFD(htilde, freqs, NULL, deltaF, phi0, fRef,
                                     m1, m2, chi1, chi2,
                                     distance, extraParams, NRTidal_version);
   XLAL_CHECK(XLAL_SUCCESS == status, status, "Failed to generate IMRPhenomD waveform.");
@@ -209,6 +212,59 @@ int XLALSimIMRPhenomDFrequencySequence(
     const REAL8 distance,                        /**< Distance of source (m) */
     LALDict *extraParams, /**< linked list containing the extra testing GR parameters */
     NRTidal_version_type NRTidal_version /**< NRTidal version; either NRTidal_V or NRTidalv2_V or NoNRT_V in case of BBH baseline */
+) {
+  return IMRPhenomDFrequencySequence(htilde, freqs, NULL, phi0, fRef_in, m1_SI, m2_SI,
+                                     chi1, chi2, distance, extraParams, NRTidal_version);
+}
+
+/**
+ * As XLALSimIMRPhenomDFrequencySequence(), but evaluated on a frequency grid
+ * created with XLALCreateSimInspiralFrequencyGrid().  The cached powers of the
+ * frequencies replace the per-bin pow() call, which makes repeated calls on
+ * the same grid cheaper.  The result agrees with
+ * XLALSimIMRPhenomDFrequencySequence() up to rounding.
+ */
+int XLALSimIMRPhenomDFrequencyGrid(
+    COMPLEX16FrequencySeries **htilde,           /**< [out] FD waveform */
+    const LALSimInspiralFrequencyGrid *grid,     /**< Frequency grid at which to evaluate the waveform */
+    const REAL8 phi0,                            /**< Orbital phase at fRef (rad) */
+    const REAL8 fRef_in,                         /**< reference frequency (Hz) */
+    const REAL8 m1_SI,                           /**< Mass of companion 1 (kg) */
+    const REAL8 m2_SI,                           /**< Mass of companion 2 (kg) */
+    const REAL8 chi1,                            /**< Aligned-spin parameter of companion 1 */
+    const REAL8 chi2,                            /**< Aligned-spin parameter of companion 2 */
+    const REAL8 distance,                        /**< Distance of source (m) */
+    LALDict *extraParams, /**< linked list containing the extra testing GR parameters */
+    NRTidal_version_type NRTidal_version /**< NRTidal version; either NRTidal_V or NRTidalv2_V or NoNRT_V in case of BBH baseline */
+) {
+  XLAL_CHECK(grid, XLAL_EFAULT, "grid is null");
+  return IMRPhenomDFrequencySequence(htilde, grid->freqs, grid, phi0, fRef_in, m1_SI, m2_SI,
+                                     chi1, chi2, distance, extraParams, NRTidal_version);
+}
+
+/** @} */
+
+/** @} */
+
+/* *********************************************************************************/
+/* The following private function generates IMRPhenomD frequency-domain waveforms  */
+/* given coefficients */
+/* *********************************************************************************/
+
+/* Implementation of XLALSimIMRPhenomDFrequencySequence() and XLALSimIMRPhenomDFrequencyGrid() */
+static int IMRPhenomDFrequencySequence(
+    COMPLEX16FrequencySeries **htilde,           /**< [out] FD waveform */
+    const REAL8Sequence *freqs,                  /**< Frequency points at which to evaluate the waveform (Hz) */
+    const LALSimInspiralFrequencyGrid *grid,     /**< cached powers of freqs, or NULL */
+    const REAL8 phi0,                            /**< Orbital phase at fRef (rad) */
+    const REAL8 fRef_in,                         /**< reference frequency (Hz) */
+    const REAL8 m1_SI,                           /**< Mass of companion 1 (kg) */
+    const REAL8 m2_SI,                           /**< Mass of companion 2 (kg) */
+    const REAL8 chi1,                            /**< Aligned-spin parameter of companion 1 */
+    const REAL8 chi2,                            /**< Aligned-spin parameter of companion 2 */
+    const REAL8 distance,                        /**< Distance of source (m) */
+    LALDict *extraParams, /**< linked list containing the extra testing GR parameters */
+    NRTidal_version_type NRTidal_version /**< NRTidal version; either NRTidal_V or NRTidalv2_V or NoNRT_V in case of BBH baseline */
 ) {
   /* external: SI; internal: solar masses */
   const REAL8 m1 = m1_SI / LAL_MSUN_SI;
@@ -234,7 +290,7 @@ int XLALSimIMRPhenomDFrequencySequence(
   // if no reference frequency given, set it to the starting GW frequency
   REAL8 fRef = (fRef_in == 0.0) ? freqs->data[0] : fRef_in;
 
-  int status = IMRPhenomDGenerateFD(htilde, freqs, 0, phi0, fRef,
+  int status = IMRPhenomDGenerateFD(htilde, freqs, grid, 0, phi0, fRef,
                                     m1, m2, chi1, chi2,
                                     distance, extraParams, NRTidal_version);
   XLAL_CHECK(XLAL_SUCCESS == status, status, "Failed to generate IMRPhenomD waveform.");
@@ -243,18 +299,10 @@ int XLALSimIMRPhenomDFrequencySequence(
 }
 
 
-/** @} */
-
-/** @} */
-
-/* *********************************************************************************/
-/* The following private function generates IMRPhenomD frequency-domain waveforms  */
-/* given coefficients */
-/* *********************************************************************************/
-
 static int IMRPhenomDGenerateFD(
     COMPLEX16FrequencySeries **htilde, /**< [out] FD waveform */
     const REAL8Sequence *freqs_in,     /**< Frequency points at which to evaluate the waveform (Hz) */
+    const LALSimInspiralFrequencyGrid *grid, /**< cached powers of freqs_in, or NULL; only used if deltaF <= 0 */
     double deltaF,                     /* If deltaF > 0, the frequency points given in freqs are uniformly spaced with
                                         * spacing deltaF. Otherwise, the frequency points are spaced non-uniformly.
                                         * Then we will use deltaF = 0 to create the frequency series we return. */
@@ -327,6 +375,7 @@ static int IMRPhenomDGenerateFD(
       XLAL_ERROR(XLAL_EDOM, "Unphysical eta. Must be between 0. and 0.25\n");
 
   const REAL8 M_sec = M * LAL_MTSUN_SI;
+  const REAL8 M_sec_sixth = pow(M_sec, 1.0 / 6.0);
 
   /* Compute the amplitude pre-factor */
   const REAL8 amp0 = 2. * sqrt(5. / (64.*LAL_PI)) * M * LAL_MRSUN_SI * M * LAL_MTSUN_SI / distance;
@@ -422,7 +471,6 @@ static int IMRPhenomDGenerateFD(
   // factor of 2 b/c phi0 is orbital phase
   const REAL8 phi_precalc = 2.*phi0 + phifRef;
 
-  int status_in_for = XLAL_SUCCESS;
   int ret = XLAL_SUCCESS;
   /* Now generate the waveform */
   if (NRTidal_version == NRTidalv2_V) {
@@ -438,11 +486,12 @@ static int IMRPhenomDGenerateFD(
       int j = i + offset; // shift index for frequency series if needed
 
       UsefulPowers powers_of_f;
-      status_in_for = init_useful_powers(&powers_of_f, Mf);
+      int status_in_for = grid ? init_useful_powers_from_sixth(&powers_of_f, Mf, M_sec_sixth * grid->sixth->data[i])
+                               : init_useful_powers(&powers_of_f, Mf);
       if (XLAL_SUCCESS != status_in_for)
       {
         XLALPrintError("init_useful_powers failed for Mf, status_in_for=%d", status_in_for);
-        status = status_in_for;
+        XLALCollectErrno(&status, status_in_for);
       }
       else {
         REAL8 amp = IMRPhenDAmplitude(Mf, pAmp, &powers_of_f, &amp_prefactors);
@@ -459,11 +508,12 @@ static int IMRPhenomDGenerateFD(
       int j = i + offset; // shift index for frequency series if needed
 
       UsefulPowers powers_of_f;
-      status_in_for = init_useful_powers(&powers_of_f, Mf);
+      int status_in_for = grid ? init_useful_powers_from_sixth(&powers_of_f, Mf, M_sec_sixth * grid->sixth->data[i])
+                               : init_useful_powers(&powers_of_f, Mf);
       if (XLAL_SUCCESS != status_in_for)
       {
         XLALPrintError("init_useful_powers failed for Mf, status_in_for=%d", status_in_for);
-        status = status_in_for;
+        XLALCollectErrno(&status, status_in_for);
       }
       else {
         REAL8 amp = IMRPhenDAmplitude(Mf, pAmp, &powers_of_f, &amp_prefactors);
@@ -784,7 +834,7 @@ int IMRPhenomDPhaseFrequencySequence(
     XLAL_ERROR(XLAL_EDOM);
   }
 
-  int status_in_for = XLAL_SUCCESS;
+  retcode = XLAL_SUCCESS;
   /* Now generate the waveform */
   #pragma omp parallel for
   for (size_t i = ind_min; i < ind_max; i++)
@@ -792,11 +842,11 @@ int IMRPhenomDPhaseFrequencySequence(
     REAL8 Mf = freqs->data[i]; // geometric frequency
 
     UsefulPowers powers_of_f;
-    status_in_for = init_useful_powers(&powers_of_f, Mf);
+    int status_in_for = init_useful_powers(&powers_of_f, Mf);
     if (XLAL_SUCCESS != status_in_for)
     {
       XLALPrintError("init_useful_powers failed for Mf, status_in_for=%d\n", status_in_for);
-      retcode = status_in_for;
+      XLALCollectErrno(&retcode, status_in_for);
     }
     else
     {
@@ -808,6 +858,7 @@ int IMRPhenomDPhaseFrequencySequence(
   // LALFree(pPhi);
   // LALFree(pn);
 
+  XLAL_CHECK(XLAL_SUCCESS == retcode, retcode, "Failed to evaluate IMRPhenomD phase.");
   return XLAL_SUCCESS;
 }
 
@@ -868,7 +919,6 @@ int IMRPhenomDAmpFrequencySequence(
   retcode = init_amp_ins_prefactors(&amp_prefactors, pAmp);
   XLAL_CHECK(XLAL_SUCCESS == retcode, retcode, "init_amp_ins_prefactors failed");
 
-  int status_in_for = XLAL_SUCCESS;
 /* Now generate the waveform */
 #pragma omp parallel for
   for (size_t i = ind_min; i < ind_max; i++)
@@ -876,11 +926,11 @@ int IMRPhenomDAmpFrequencySequence(
     REAL8 Mf = freqs->data[i]; // geometric frequency
 
     UsefulPowers powers_of_f;
-    status_in_for = init_useful_powers(&powers_of_f, Mf);
+    int status_in_for = init_useful_powers(&powers_of_f, Mf);
     if (XLAL_SUCCESS != status_in_for)
     {
       XLALPrintError("init_useful_powers failed for Mf, status_in_for=%d", status_in_for);
-      retcode = status_in_for;
+      XLALCollectErrno(&retcode, status_in_for);
     }
     else
     {
@@ -890,6 +940,7 @@ int IMRPhenomDAmpFrequencySequence(
 
   LALFree(pAmp);
 
+  XLAL_CHECK(XLAL_SUCCESS == retcode, retcode, "Failed to evaluate IMRPhenomD amplitude.");
   return XLAL_SUCCESS;
 }
 
@@ -212,11 +212,18 @@ static double fdamp(double eta, double chi1, double chi2, double finspin) {
 
 static int init_useful_powers(UsefulPowers *p, REAL8 number)
 {
-  XLAL_CHECK(0 != p, XLAL_EFAULT, "p is NULL");
   XLAL_CHECK(number >= 0, XLAL_EDOM, "number must be non-negative");
 
   // consider changing pow(x,1/6.0) to cbrt(x) and sqrt(x) - might be faster
   double sixth = pow(number, 1.0 / 6.0);
+  return init_useful_powers_from_sixth(p, number, sixth);
+}
+
+static int init_useful_powers_from_sixth(UsefulPowers *p, REAL8 number, REAL8 sixth)
+{
+  XLAL_CHECK(0 != p, XLAL_EFAULT, "p is NULL");
+  XLAL_CHECK(number >= 0, XLAL_EDOM, "number must be non-negative");
+
   p->third = sixth * sixth;
   //p->third = cbrt(number);
   p->two_thirds = p->third * p->third;
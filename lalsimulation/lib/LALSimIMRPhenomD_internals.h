@@ -264,6 +264,12 @@ typedef struct tagUsefulPowers
  */
 static int init_useful_powers(UsefulPowers * p, REAL8 number);
 
+/**
+ * as init_useful_powers(), with number^(1/6) already known,
+ * e.g. from a LALSimInspiralFrequencyGrid
+ */
+static int init_useful_powers_from_sixth(UsefulPowers * p, REAL8 number, REAL8 sixth);
+
 /**
  * useful powers of LAL_PI, calculated once and kept constant - to be initied with a call to
  * init_useful_powers(&powers_of_pi, LAL_PI);
@@ -984,8 +984,8 @@ static int PhenomPCore(
 
   /*
     We can't call XLAL_ERROR() directly with OpenMP on.
-    Keep track of return codes for each thread and in addition use flush to get out of
-    the parallel for loop as soon as possible if something went wrong in any thread.
+    Collect the first error raised by any thread, and skip the remaining
+    iterations of the parallel for loop as soon as something went wrong.
   */
   #pragma omp parallel for
   for (UINT4 i=0; i<L_fCut; i++) { // loop over frequency points in sequence
@@ -998,8 +998,7 @@ static int PhenomPCore(
 
     int per_thread_errcode=0;
 
-    #pragma omp flush(errcode)
-    if (errcode != XLAL_SUCCESS)
+    if (XLALGetCollectedErrno(&errcode) != XLAL_SUCCESS)
       goto skip;
 
     /* Generate the waveform */
@@ -1031,19 +1030,14 @@ static int PhenomPCore(
                               &hPhenom, &phasing, IMRPhenomP_version, &amp_prefactors, &phi_prefactors);
      }
 
-    if (per_thread_errcode != XLAL_SUCCESS) {
-      errcode = per_thread_errcode;
-     }
+    XLALCollectErrno(&errcode, per_thread_errcode);
 
     per_thread_errcode = PhenomPCoreTwistUp(f, hPhenom, eta, chi1_l, chi2_l, chip, M,
                               &angcoeffs, &Y2m,
                               alphaNNLOoffset - alpha0, epsilonNNLOoffset,
                               &hp_val, &hc_val, IMRPhenomP_version);
 
-    if (per_thread_errcode != XLAL_SUCCESS) {
-      errcode = per_thread_errcode;
-      #pragma omp flush(errcode)
-    }
+    XLALCollectErrno(&errcode, per_thread_errcode);
 
     ((*hptilde)->data->data)[j] = hp_val;
     ((*hctilde)->data->data)[j] = hc_val;
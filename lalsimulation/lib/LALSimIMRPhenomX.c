@@ -66,6 +66,9 @@
 /* Note: This is declared in LALSimIMRPhenomX_internals.c and avoids namespace clashes */
 IMRPhenomX_UsefulPowers powers_of_lalpi;
 
+static int IMRPhenomXASFrequencySequence(COMPLEX16FrequencySeries **htilde22, const REAL8Sequence *freqs, const LALSimInspiralFrequencyGrid *grid, REAL8 m1_SI, REAL8 m2_SI, REAL8 chi1L, REAL8 chi2L, REAL8 distance, REAL8 phi0, REAL8 fRef_In, LALDict *lalParams);
+static int IMRPhenomXASGenerateFDGrid(COMPLEX16FrequencySeries **htilde22, const REAL8Sequence *freqs_In, const LALSimInspiralFrequencyGrid *grid, IMRPhenomXWaveformStruct *pWF, LALDict *lalParams);
+
 #ifndef _OPENMP
 #define omp ignore
 #endif
@@ -331,72 +334,31 @@ int XLALSimIMRPhenomXASGenerateFD(
      LALDict *lalParams                   /**< LAL Dictionary */
  )
  {
-   INT4 return_code = 0;
-
-   /* Sanity checks */
-   if(*htilde22)       { XLAL_CHECK(NULL != htilde22, XLAL_EFAULT);                                   }
-   if(fRef_In  <  0.0) { XLAL_ERROR(XLAL_EDOM, "fRef_In must be positive or set to 0 to ignore.\n");  }
-   if(m1_SI    <= 0.0) { XLAL_ERROR(XLAL_EDOM, "m1 must be positive.\n");                             }
-   if(m2_SI    <= 0.0) { XLAL_ERROR(XLAL_EDOM, "m2 must be positive.\n");                             }
-   if(distance <  0.0) { XLAL_ERROR(XLAL_EDOM, "Distance must be positive and greater than 0.\n");    }
-
-   /*
-	Perform a basic sanity check on the region of the parameter space in which model is evaluated. Behaviour is as follows:
-		- For mass ratios <= 20.0 and spins <= 0.99: no warning messages.
-		- For 1000 > mass ratio > 20 and spins <= 0.99: print a warning message that we are extrapolating outside of *NR* calibration domain.
-		- For mass ratios > 1000: throw a hard error that model is not valid.
-		- For spins > 0.99: throw a warning that we are extrapolating the model to extremal
-
-   */
-   REAL8 mass_ratio;
-   if(m1_SI > m2_SI)
-   {
-	mass_ratio = m1_SI / m2_SI;
-   }
-   else
-   {
-	mass_ratio = m2_SI / m1_SI;
-   }
-   if(mass_ratio > 20.0  ) { XLAL_PRINT_INFO("Warning: Extrapolating outside of Numerical Relativity calibration domain."); }
-
-   // Check on the mass-ratio with a 1e-12 tolerance to avoid rounding errors
-   if(mass_ratio > 1000. && fabs(mass_ratio - 1000) > 1e-12) { XLAL_ERROR(XLAL_EDOM, "ERROR: Model not valid at mass ratios beyond 1000."); }
-   if(fabs(chi1L) > 0.99 || fabs(chi2L) > 0.99) { XLAL_PRINT_INFO("Warning: Extrapolating to extremal spins, model is not trusted."); }
-
-   // If fRef is not provided, then set fRef to be the starting GW Frequency
-   REAL8 fRef = (fRef_In == 0.0) ? freqs->data[0] : fRef_In;
-
-   UINT4 status = IMRPhenomX_Initialize_Powers(&powers_of_lalpi, LAL_PI);
-   XLAL_CHECK(XLAL_SUCCESS == status, status, "Failed to initialize useful powers of LAL_PI.");
-
-   /*
-      This routine automatically performs sanity checks on the masses, spins, etc.
-   */
-   REAL8 f_min_In  = freqs->data[0];
-   REAL8 f_max_In  = freqs->data[freqs->length - 1];
-
-   /*
-      Passing deltaF = 0 implies that freqs is a frequency grid with non-uniform spacing.
-      The function waveform then start at lowest given frequency.
-   */
-
-   /* Initialize IMRPhenomX waveform struct and perform sanity check. */
-   IMRPhenomXWaveformStruct *pWF;
-   pWF = XLALMalloc(sizeof(IMRPhenomXWaveformStruct));
-   return_code = IMRPhenomXSetWaveformVariables(pWF,m1_SI, m2_SI, chi1L, chi2L, 0.0, fRef, phi0, f_min_In, f_max_In, distance, 0.0, lalParams, 0);
-   XLAL_CHECK(XLAL_SUCCESS == return_code, XLAL_EFUNC, "Error: IMRPhenomXSetWaveformVariables failed.\n");
-
-   /* Now call the core IMRPhenomX waveform generator */
-   return_code = IMRPhenomXASGenerateFD(
-     htilde22,
-     freqs,
-     pWF,
-     lalParams
-   );
-   XLAL_CHECK(return_code == XLAL_SUCCESS, XLAL_EFUNC, "IMRPhenomXASFDCore failed to generate IMRPhenomX waveform.");
-   LALFree(pWF);
+   return IMRPhenomXASFrequencySequence(htilde22, freqs, NULL, m1_SI, m2_SI, chi1L, chi2L, distance, phi0, fRef_In, lalParams);
+ }
 
-   return XLAL_SUCCESS;
+ /**
+  * As XLALSimIMRPhenomXASFrequencySequence(), but evaluated on a frequency grid
+  * created with XLALCreateSimInspiralFrequencyGrid(). The cached powers and
+  * logarithms of the frequencies replace the per-bin pow() and log() calls,
+  * which makes repeated calls on the same grid cheaper. The result agrees with
+  * XLALSimIMRPhenomXASFrequencySequence() up to rounding.
+  */
+ int XLALSimIMRPhenomXASFrequencyGrid(
+     COMPLEX16FrequencySeries **htilde22, /**< [out] FD waveform */
+     const LALSimInspiralFrequencyGrid *grid, /**< Frequency grid */
+     REAL8 m1_SI,                         /**< Mass of companion 1 (kg) */
+     REAL8 m2_SI,                         /**< Mass of companion 2 (kg) */
+     REAL8 chi1L,                         /**< Dimensionless aligned spin of companion 1 */
+     REAL8 chi2L,                         /**< Dimensionless aligned spin of companion 2 */
+     REAL8 distance,                      /**< Luminosity distance (m) */
+     REAL8 phi0,                          /**< Phase at reference frequency */
+     REAL8 fRef_In,                       /**< Reference frequency (Hz) */
+     LALDict *lalParams                   /**< LAL Dictionary */
+ )
+ {
+   XLAL_CHECK(NULL != grid, XLAL_EFAULT);
+   return IMRPhenomXASFrequencySequence(htilde22, grid->freqs, grid, m1_SI, m2_SI, chi1L, chi2L, distance, phi0, fRef_In, lalParams);
  }
 
  /**
@@ -512,6 +474,102 @@ int IMRPhenomXASGenerateFD(
   IMRPhenomXWaveformStruct *pWF,       /**< IMRPhenomX Waveform Struct  */
   LALDict *lalParams                   /**< LAL Dictionary Structure    */
 )
+{
+  return IMRPhenomXASGenerateFDGrid(htilde22, freqs_In, NULL, pWF, lalParams);
+}
+
+/* Implementation of XLALSimIMRPhenomXASFrequencySequence() and XLALSimIMRPhenomXASFrequencyGrid() */
+static int IMRPhenomXASFrequencySequence(
+     COMPLEX16FrequencySeries **htilde22, /**< [out] FD waveform */
+     const REAL8Sequence *freqs,          /**< [out] Frequency series [Hz] */
+     const LALSimInspiralFrequencyGrid *grid, /**< cached powers of freqs, or NULL */
+     REAL8 m1_SI,                         /**< Mass of companion 1 (kg) */
+     REAL8 m2_SI,                         /**< Mass of companion 2 (kg) */
+     REAL8 chi1L,                         /**< Dimensionless aligned spin of companion 1 */
+     REAL8 chi2L,                         /**< Dimensionless aligned spin of companion 2 */
+     REAL8 distance,                      /**< Luminosity distance (m) */
+     REAL8 phi0,                          /**< Phase at reference frequency */
+     REAL8 fRef_In,                       /**< Reference frequency (Hz) */
+     LALDict *lalParams                   /**< LAL Dictionary */
+ )
+ {
+   INT4 return_code = 0;
+
+   /* Sanity checks */
+   if(*htilde22)       { XLAL_CHECK(NULL != htilde22, XLAL_EFAULT);                                   }
+   if(fRef_In  <  0.0) { XLAL_ERROR(XLAL_EDOM, "fRef_In must be positive or set to 0 to ignore.\n");  }
+   if(m1_SI    <= 0.0) { XLAL_ERROR(XLAL_EDOM, "m1 must be positive.\n");                             }
+   if(m2_SI    <= 0.0) { XLAL_ERROR(XLAL_EDOM, "m2 must be positive.\n");                             }
+   if(distance <  0.0) { XLAL_ERROR(XLAL_EDOM, "Distance must be positive and greater than 0.\n");    }
+
+   /*
+	Perform a basic sanity check on the region of the parameter space in which model is evaluated. Behaviour is as follows:
+		- For mass ratios <= 20.0 and spins <= 0.99: no warning messages.
+		- For 1000 > mass ratio > 20 and spins <= 0.99: print a warning message that we are extrapolating outside of *NR* calibration domain.
+		- For mass ratios > 1000: throw a hard error that model is not valid.
+		- For spins > 0.99: throw a warning that we are extrapolating the model to extremal
+
+   */
+   REAL8 mass_ratio;
+   if(m1_SI > m2_SI)
+   {
+	mass_ratio = m1_SI / m2_SI;
+   }
+   else
+   {
+	mass_ratio = m2_SI / m1_SI;
+   }
+   if(mass_ratio > 20.0  ) { XLAL_PRINT_INFO("Warning: Extrapolating outside of Numerical Relativity calibration domain."); }
+
+   // Check on the mass-ratio with a 1e-12 tolerance to avoid rounding errors
+   if(mass_ratio > 1000. && fabs(mass_ratio - 1000) > 1e-12) { XLAL_ERROR(XLAL_EDOM, "ERROR: Model not valid at mass ratios beyond 1000."); }
+   if(fabs(chi1L) > 0.99 || fabs(chi2L) > 0.99) { XLAL_PRINT_INFO("Warning: Extrapolating to extremal spins, model is not trusted."); }
+
+   // If fRef is not provided, then set fRef to be the starting GW Frequency
+   REAL8 fRef = (fRef_In == 0.0) ? freqs->data[0] : fRef_In;
+
+   UINT4 status = IMRPhenomX_Initialize_Powers(&powers_of_lalpi, LAL_PI);
+   XLAL_CHECK(XLAL_SUCCESS == status, status, "Failed to initialize useful powers of LAL_PI.");
+
+   /*
+      This routine automatically performs sanity checks on the masses, spins, etc.
+   */
+   REAL8 f_min_In  = freqs->data[0];
+   REAL8 f_max_In  = freqs->data[freqs->length - 1];
+
+   /*
+      Passing deltaF = 0 implies that freqs is a frequency grid with non-uniform spacing.
+      The function waveform then start at lowest given frequency.
+   */
+
+   /* Initialize IMRPhenomX waveform struct and perform sanity check. */
+   IMRPhenomXWaveformStruct *pWF;
+   pWF = XLALMalloc(sizeof(IMRPhenomXWaveformStruct));
+   return_code = IMRPhenomXSetWaveformVariables(pWF,m1_SI, m2_SI, chi1L, chi2L, 0.0, fRef, phi0, f_min_In, f_max_In, distance, 0.0, lalParams, 0);
+   XLAL_CHECK(XLAL_SUCCESS == return_code, XLAL_EFUNC, "Error: IMRPhenomXSetWaveformVariables failed.\n");
+
+   /* Now call the core IMRPhenomX waveform generator */
+   return_code = IMRPhenomXASGenerateFDGrid(
+     htilde22,
+     freqs,
+     grid,
+     pWF,
+     lalParams
+   );
+   XLAL_CHECK(return_code == XLAL_SUCCESS, XLAL_EFUNC, "IMRPhenomXASFDCore failed to generate IMRPhenomX waveform.");
+   LALFree(pWF);
+
+   return XLAL_SUCCESS;
+ }
+
+/* As IMRPhenomXASGenerateFD, using the cached powers in grid if it is not NULL and the frequencies are non-uniform */
+static int IMRPhenomXASGenerateFDGrid(
+  COMPLEX16FrequencySeries **htilde22, /**< [out] FD waveform           */
+  const REAL8Sequence *freqs_In,       /**< Input frequency grid        */
+  const LALSimInspiralFrequencyGrid *grid, /**< cached powers of freqs_In, or NULL */
+  IMRPhenomXWaveformStruct *pWF,       /**< IMRPhenomX Waveform Struct  */
+  LALDict *lalParams                   /**< LAL Dictionary Structure    */
+)
 {
   /* Inherits debug flag from waveform struct */
   UINT4 debug = PHENOMXDEBUG;
@@ -759,6 +817,14 @@ int IMRPhenomXASGenerateFD(
   //REAL8 MfRef     = pWF->MfRef;
   REAL8 Msec      = pWF->M_sec;
 
+  /* The cached powers are only valid for the input frequencies, not for a uniform grid built here */
+  if(pWF->deltaF > 0)
+  {
+    grid = NULL;
+  }
+  const REAL8 Msec_sixth = grid ? pow(Msec, 1.0 / 6.0) : 0.0;
+  const REAL8 logMsec    = grid ? log(Msec) : 0.0;
+
   REAL8 C1IM      = pPhase22->C1Int;
   REAL8 C2IM      = pPhase22->C2Int;
   REAL8 C1RD      = pPhase22->C1MRD;
@@ -809,7 +875,10 @@ int IMRPhenomXASGenerateFD(
 
     /* Initialize a struct containing useful powers of Mf */
     IMRPhenomX_UsefulPowers powers_of_Mf;
-    initial_status     = IMRPhenomX_Initialize_Powers(&powers_of_Mf,Mf);
+    if(grid)
+      initial_status   = IMRPhenomX_Initialize_Powers_Cached(&powers_of_Mf,Mf,Msec_sixth*grid->sixth->data[idx],logMsec+grid->logf->data[idx]);
+    else
+      initial_status   = IMRPhenomX_Initialize_Powers(&powers_of_Mf,Mf);
     if(initial_status != XLAL_SUCCESS)
     {
       status = initial_status;
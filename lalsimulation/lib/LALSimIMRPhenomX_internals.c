@@ -52,11 +52,18 @@
 
 /* This struct is used to pre-cache useful powers of frequency, avoiding numerous expensive operations */
 int IMRPhenomX_Initialize_Powers(IMRPhenomX_UsefulPowers *p, REAL8 number)
+{
+	XLAL_CHECK(number >= 0, XLAL_EDOM, "number must be non-negative");
+
+	return IMRPhenomX_Initialize_Powers_Cached(p, number, pow(number, 1.0 / 6.0), log(number));
+}
+
+/* As IMRPhenomX_Initialize_Powers, with number^(1/6) and log(number) already known, e.g. from a LALSimInspiralFrequencyGrid */
+int IMRPhenomX_Initialize_Powers_Cached(IMRPhenomX_UsefulPowers *p, REAL8 number, REAL8 sixth, REAL8 log_number)
 {
 	XLAL_CHECK(0 != p, XLAL_EFAULT, "p is NULL");
 	XLAL_CHECK(number >= 0, XLAL_EDOM, "number must be non-negative");
 
-	double sixth      = pow(number, 1.0 / 6.0);
 	double m_sixth    = 1.0 / sixth;
 
 	p->one_sixth      = sixth;
@@ -96,7 +103,7 @@ int IMRPhenomX_Initialize_Powers(IMRPhenomX_UsefulPowers *p, REAL8 number)
 	p->seven_sixths   = p->one_sixth   * p->itself;
 	p->m_seven_sixths = p->m_one_sixth * p->m_one;
 
-	p->log            = log(number);
+	p->log            = log_number;
 	p->sqrt           = p->one_sixth*p->one_sixth*p->one_sixth;
 
 	return XLAL_SUCCESS;
@@ -419,6 +419,7 @@ typedef struct tagIMRPhenomXAmpCoefficients
 
 ///////////////////////////// Useful Numerical Routines /////////////////////////////
 int IMRPhenomX_Initialize_Powers(IMRPhenomX_UsefulPowers *p, REAL8 number);
+int IMRPhenomX_Initialize_Powers_Cached(IMRPhenomX_UsefulPowers *p, REAL8 number, REAL8 sixth, REAL8 log_number);
 int IMRPhenomX_Initialize_Powers_Light(IMRPhenomX_UsefulPowers *p, REAL8 number);
 
 int IMRPhenomXSetWaveformVariables(
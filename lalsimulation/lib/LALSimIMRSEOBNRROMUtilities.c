@@ -75,6 +75,47 @@ UNUSED static int ROM_check_version_number(LALH5File *file, INT4 version_major_i
 UNUSED static int ROM_check_canonical_file_basename(LALH5File *file, const char file_name[], const char attribute[]);
 #endif
 
+// Nonzero cubic B-spline basis functions of a 2d or 3d tensor product spline
+// at one point in parameter space. The coefficients of the spline which
+// multiply them lie in nrun runs of 4 contiguous elements of a coefficient
+// table, starting at offset[r], which are weighted with B[4*r], ..., B[4*r+3].
+typedef struct tagROMTensorSplineBasis {
+  int nrun;                 // Number of runs: 4 in 2d, 16 in 3d
+  size_t offset[16];        // Offset of each run in a coefficient table
+  double B[64];             // Products of the basis functions for each coefficient
+} ROMTensorSplineBasis;
+
+UNUSED static void ROM_TP_Spline_basis_3d(
+  ROMTensorSplineBasis *basis,
+  REAL8 x,
+  REAL8 y,
+  REAL8 z,
+  int ncy,
+  int ncz,
+  gsl_bspline_workspace *bwx,
+  gsl_bspline_workspace *bwy,
+  gsl_bspline_workspace *bwz
+);
+
+UNUSED static void ROM_TP_Spline_basis_2d(
+  ROMTensorSplineBasis *basis,
+  REAL8 x,
+  REAL8 y,
+  int ncy,
+  gsl_bspline_workspace *bwx,
+  gsl_bspline_workspace *bwy
+);
+
+UNUSED static REAL8 ROM_TP_Spline_eval(const ROMTensorSplineBasis *basis, const double *c);
+
+UNUSED static int ROM_TP_Spline_eval_tables(
+  const ROMTensorSplineBasis *basis,
+  const gsl_vector *cvec,
+  size_t N,
+  size_t nk,
+  gsl_vector *c_out
+);
+
 UNUSED static REAL8 Interpolate_Coefficent_Tensor(
   gsl_vector *v,
   REAL8 eta,
@@ -427,96 +468,165 @@ static int ROM_check_canonical_file_basename(LALH5File *file, const char file_na
 }
 #endif
 
-// Helper function to perform tensor product spline interpolation with gsl
-// The gsl_vector v contains the ncx x ncy x ncz dimensional coefficient tensor in vector form
-// that should be interpolated and evaluated at position (eta,chi1,chi2).
-static REAL8 Interpolate_Coefficent_Tensor(
-  gsl_vector *v,
-  REAL8 eta,
-  REAL8 chi1,
-  REAL8 chi2,
+// Evaluate the nonzero cubic (order k=4) B-spline basis functions of a 3d
+// tensor product spline at position (x,y,z), for coefficient tables holding
+// an ncx x ncy x ncz dimensional coefficient tensor in vector form.
+// The basis can then be contracted with any number of coefficient tables
+// with ROM_TP_Spline_eval() or ROM_TP_Spline_eval_tables().
+static void ROM_TP_Spline_basis_3d(
+  ROMTensorSplineBasis *basis,
+  REAL8 x,
+  REAL8 y,
+  REAL8 z,
   int ncy,
   int ncz,
   gsl_bspline_workspace *bwx,
   gsl_bspline_workspace *bwy,
   gsl_bspline_workspace *bwz
 ) {
-  // Store nonzero cubic (order k=4) B-spline basis functions in the eta and chi directions.
-  gsl_vector *Bx4 = gsl_vector_alloc(4);
-  gsl_vector *By4 = gsl_vector_alloc(4);
-  gsl_vector *Bz4 = gsl_vector_alloc(4);
+  double Bx4[4], By4[4], Bz4[4];
+  gsl_vector_view Bx = gsl_vector_view_array(Bx4, 4);
+  gsl_vector_view By = gsl_vector_view_array(By4, 4);
+  gsl_vector_view Bz = gsl_vector_view_array(Bz4, 4);
 
   size_t isx, isy, isz; // first non-zero spline
-  // Evaluate all potentially nonzero cubic B-spline basis functions for
-  // positions (eta,chi) and store them in the vectors Bx4, By4, Bz4.
   // Since the B-splines are of compact support we only need to store a small
   // number of basis functions to avoid computing terms that would be zero anyway.
   // https://www.gnu.org/software/gsl/manual/html_node/Overview-of-B_002dsplines.html#Overview-of-B_002dsplines
-  gsl_bspline_basis(eta,  Bx4, &isx, bwx);
-  gsl_bspline_basis(chi1, By4, &isy, bwy);
-  gsl_bspline_basis(chi2, Bz4, &isz, bwz);
+  gsl_bspline_basis(x, &Bx.vector, &isx, bwx);
+  gsl_bspline_basis(y, &By.vector, &isy, bwy);
+  gsl_bspline_basis(z, &Bz.vector, &isz, bwz);
 
-  // Now compute coefficient at desired parameters (q,chi1,chi2)
-  // from C(eta,chi1,chi2) = c_ijk * Beta_i * Bchi1_j * Bchi2_k
-  // while summing over indices i,j,k where the B-splines are nonzero.
-  // Note: in the 2D case we were able to use gsl_matrix c = gsl_matrix_view_vector(&v, ncx, ncy).matrix
-  // to convert vector view of the coefficient matrix to a matrix view.
-  // However, since tensors are not supported in gsl, we have to do the indexing explicitly.
-  double sum = 0;
+  // The coefficient c_ijk is stored at (i*ncy + j)*ncz + k, so for fixed i, j
+  // the four coefficients multiplying the nonzero splines in z are contiguous.
+  basis->nrun = 16;
   for (int i=0; i<4; i++)
+    for (int j=0; j<4; j++) {
+      int r = 4*i + j;
+      basis->offset[r] = ((isx + i)*ncy + isy + j)*ncz + isz;
+      for (int k=0; k<4; k++)
+        basis->B[4*r + k] = Bx4[i] * By4[j] * Bz4[k];
+    }
+}
+
+// Evaluate the nonzero cubic (order k=4) B-spline basis functions of a 2d
+// tensor product spline at position (x,y), for coefficient tables holding
+// an ncx x ncy dimensional coefficient matrix in vector form.
+static void ROM_TP_Spline_basis_2d(
+  ROMTensorSplineBasis *basis,
+  REAL8 x,
+  REAL8 y,
+  int ncy,
+  gsl_bspline_workspace *bwx,
+  gsl_bspline_workspace *bwy
+) {
+  double Bx4[4], By4[4];
+  gsl_vector_view Bx = gsl_vector_view_array(Bx4, 4);
+  gsl_vector_view By = gsl_vector_view_array(By4, 4);
+
+  size_t isx, isy; // first non-zero spline
+  gsl_bspline_basis(x, &Bx.vector, &isx, bwx);
+  gsl_bspline_basis(y, &By.vector, &isy, bwy);
+
+  // The coefficient c_ij is stored at i*ncy + j
+  basis->nrun = 4;
+  for (int i=0; i<4; i++) {
+    basis->offset[i] = (isx + i)*ncy + isy;
     for (int j=0; j<4; j++)
-      for (int k=0; k<4; k++) {
-        int ii = isx + i;
-        int jj = isy + j;
-        int kk = isz + k;
-        double cijk = gsl_vector_get(v, (ii*ncy + jj)*ncz + kk);
-        sum += cijk * gsl_vector_get(Bx4, i) * gsl_vector_get(By4, j) * gsl_vector_get(Bz4, k);
-      }
-
-  gsl_vector_free(Bx4);
-  gsl_vector_free(By4);
-  gsl_vector_free(Bz4);
+      basis->B[4*i + j] = Bx4[i] * By4[j];
+  }
+}
 
+// Contract the spline basis with the contiguous coefficient table c.
+static REAL8 ROM_TP_Spline_eval(const ROMTensorSplineBasis *basis, const double *c) {
+  double sum = 0;
+  for (int r=0; r<basis->nrun; r++) {
+    const double *cr = c + basis->offset[r];
+    const double *Br = basis->B + 4*r;
+    sum += cr[0]*Br[0] + cr[1]*Br[1] + cr[2]*Br[2] + cr[3]*Br[3];
+  }
   return sum;
 }
 
+// Interpolate the first nk of the coefficient tables of size N stored one
+// after another in cvec, e.g. the tables for each SVD mode of a ROM, at the
+// point of the spline basis, and store the results in c_out.
+static int ROM_TP_Spline_eval_tables(
+  const ROMTensorSplineBasis *basis,
+  const gsl_vector *cvec,
+  size_t N,
+  size_t nk,
+  gsl_vector *c_out
+) {
+  XLAL_CHECK(cvec->stride == 1, XLAL_EINVAL, "Coefficient tables must be contiguous");
+  XLAL_CHECK(nk * N <= cvec->size, XLAL_EBADLEN, "Coefficient vector holds fewer than %zu tables of size %zu", nk, N);
+  XLAL_CHECK(nk <= c_out->size, XLAL_EBADLEN, "Output vector is shorter than the number of tables %zu", nk);
+
+  for (size_t k=0; k<nk; k++)
+    gsl_vector_set(c_out, k, ROM_TP_Spline_eval(basis, cvec->data + k*N));
+
+  return XLAL_SUCCESS;
+}
+
+// Helper function to perform tensor product spline interpolation with gsl
+// The gsl_vector v contains the ncx x ncy x ncz dimensional coefficient tensor in vector form
+// that should be interpolated and evaluated at position (eta,chi1,chi2).
+// To interpolate many coefficient tensors at the same position, compute the
+// spline basis once with ROM_TP_Spline_basis_3d() instead.
+static REAL8 Interpolate_Coefficent_Tensor(
+  gsl_vector *v,
+  REAL8 eta,
+  REAL8 chi1,
+  REAL8 chi2,
+  int ncy,
+  int ncz,
+  gsl_bspline_workspace *bwx,
+  gsl_bspline_workspace *bwy,
+  gsl_bspline_workspace *bwz
+) {
+  // Compute coefficient at desired parameters (eta,chi1,chi2)
+  // from C(eta,chi1,chi2) = c_ijk * Beta_i * Bchi1_j * Bchi2_k
+  // while summing over indices i,j,k where the B-splines are nonzero.
+  ROMTensorSplineBasis basis;
+  ROM_TP_Spline_basis_3d(&basis, eta, chi1, chi2, ncy, ncz, bwx, bwy, bwz);
+
+  if (v->stride != 1) {
+    double sum = 0;
+    for (int r=0; r<basis.nrun; r++)
+      for (int k=0; k<4; k++)
+        sum += gsl_vector_get(v, basis.offset[r] + k) * basis.B[4*r + k];
+    return sum;
+  }
+  return ROM_TP_Spline_eval(&basis, v->data);
+}
+
 // Helper function to perform tensor product spline interpolation with gsl
 // The gsl_vector v contains the ncx x ncy dimensional coefficient matrix in vector form
 // that should be interpolated and evaluated at position (eta,chi).
+// To interpolate many coefficient matrices at the same position, compute the
+// spline basis once with ROM_TP_Spline_basis_2d() instead.
 static REAL8 Interpolate_Coefficent_Matrix(
   gsl_vector *v,
   REAL8 eta,
   REAL8 chi,
-  int ncx,
+  UNUSED int ncx,
   int ncy,
   gsl_bspline_workspace *bwx,
   gsl_bspline_workspace *bwy
 ) {
-  gsl_matrix c = gsl_matrix_view_vector(v, ncx, ncy).matrix;   // Convert coefficient matrix from vector view to matrix view c_ij.
-
-  // Store nonzero cubic (order k=4) B-spline basis functions in the eta and chi directions.
-  gsl_vector *Bx4 = gsl_vector_alloc(4);
-  gsl_vector *By4 = gsl_vector_alloc(4);
-
-  REAL8 sum = 0;
-  size_t isx, isy; // first non-zero spline
-  // Evaluate all potentially nonzero cubic B-spline basis functions for positions (eta,chi) and stores them in the vectors Bx4, By4.
-  // Since the B-splines are of compact support we only need to store a small number of basis functions
-  // to avoid computing terms that would be zero anyway.
-  // https://www.gnu.org/software/gsl/manual/html_node/Overview-of-B_002dsplines.html#Overview-of-B_002dsplines
-  gsl_bspline_basis(eta, Bx4, &isx, bwx);
-  gsl_bspline_basis(chi, By4, &isy, bwy);
-
-  // Now compute coefficient at desired parameters (eta,chi) from C(eta,chi) = c_ij * Beta_i * Bchi_j
+  // Compute coefficient at desired parameters (eta,chi) from C(eta,chi) = c_ij * Beta_i * Bchi_j
   // summing over indices i,j where the B-splines are nonzero.
-  for (int i=0; i<4; i++)
-    for (int j=0; j<4; j++)
-      sum += gsl_matrix_get(&c, isx + i, isy + j) * gsl_vector_get(Bx4, i) * gsl_vector_get(By4, j);
-
-  gsl_vector_free(Bx4);
-  gsl_vector_free(By4);
-
-  return sum;
+  ROMTensorSplineBasis basis;
+  ROM_TP_Spline_basis_2d(&basis, eta, chi, ncy, bwx, bwy);
+
+  if (v->stride != 1) {
+    double sum = 0;
+    for (int r=0; r<basis.nrun; r++)
+      for (int k=0; k<4; k++)
+        sum += gsl_vector_get(v, basis.offset[r] + k) * basis.B[4*r + k];
+    return sum;
+  }
+  return ROM_TP_Spline_eval(&basis, v->data);
 }
 
 // Returns fitting coefficients for cubic y = c[0] + c[1]*x + c[2]*x**2 + c[3]*x**3
@@ -986,3 +1096,341 @@ static UINT4 unwrap_phase(
 
 	return XLAL_SUCCESS;
 }
+
+/*
+ * Memory-mapped ROM data stores
+ *
+ * The datasets of a ROM can be saved to a flat binary file, a "store",
+ * whose datasets are aligned so that they can be used in place once the
+ * file is mapped into memory read-only.  The mapped pages are shared by
+ * all processes that use the same store, and loading the ROM from a store
+ * costs no more than mapping the file, rather than reading and copying the
+ * whole HDF5 file into the private memory of each process.
+ *
+ * Stores are only used if the environment variable LAL_ROM_MMAP_DIR names
+ * a directory.  A ROM looks for its store in that directory and, if it is
+ * missing or was made from a different ROM data file, loads the ROM from
+ * the HDF5 file as usual and then writes the store for the processes that
+ * come after it.  Stores record the size and modification time of the ROM
+ * data file they were made from, and are only valid on the machine
+ * architecture that made them.
+ */
+
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_UNISTD_H)
+#define ROM_MMAP_STORE_ENABLED
+#endif
+
+#define ROM_MMAP_STORE_ALIGNMENT 64
+#define ROM_MMAP_STORE_NAME_LENGTH 64
+
+/* Reference to the gsl vector or matrix holding a dataset of a ROM */
+typedef struct tagROMDatasetRef {
+  char name[ROM_MMAP_STORE_NAME_LENGTH]; // Unique name of the dataset
+  gsl_vector **vector;                   // Either the vector holding the dataset
+  gsl_matrix **matrix;                   // or the matrix holding the dataset
+} ROMDatasetRef;
+
+/* A ROM data store mapped into memory */
+typedef struct tagROMMappedStore {
+  void *base;                            // Start of the mapping
+  size_t size;                           // Size of the mapping
+} ROMMappedStore;
+
+/* Header of a ROM data store file */
+typedef struct tagROMMappedStoreHeader {
+  char magic[8];                         // "LALROM\0\1"
+  UINT8 byte_order;                      // ROM_MMAP_STORE_BYTE_ORDER as written
+  UINT8 n_datasets;                      // Number of datasets in the store
+  UINT8 source_size;                     // Size of the ROM data file
+  INT8 source_mtime;                     // Modification time of the ROM data file
+} ROMMappedStoreHeader;
+
+/* Location of a dataset in a ROM data store file */
+typedef struct tagROMMappedStoreEntry {
+  char name[ROM_MMAP_STORE_NAME_LENGTH]; // Name of the dataset
+  UINT8 size1;                           // Number of elements, or rows of a matrix
+  UINT8 size2;                           // Number of columns of a matrix, 0 for a vector
+  UINT8 offset;                          // Offset of the data from the start of the file
+} ROMMappedStoreEntry;
+
+static const char ROM_MMAP_STORE_MAGIC[8] = {'L', 'A', 'L', 'R', 'O', 'M', '\0', '\1'};
+#define ROM_MMAP_STORE_BYTE_ORDER 0x0102030405060708ULL
+
+UNUSED static char *ROM_mmap_store_path(const char data_file[], const char tag[]);
+UNUSED static int ROM_mmap_store_load(ROMMappedStore **store, const char path[], const char data_file[], ROMDatasetRef *refs, size_t n_refs);
+UNUSED static int ROM_mmap_store_save(const char path[], const char data_file[], const ROMDatasetRef *refs, size_t n_refs);
+UNUSED static void ROM_mmap_store_unmap(ROMMappedStore *store);
+UNUSED static void ROM_dataset_ref(ROMDatasetRef *ref, const char group[], const char name[], gsl_vector **vector, gsl_matrix **matrix);
+
+#ifdef ROM_MMAP_STORE_ENABLED
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Offset of the data of the datasets in a store with n datasets */
+static size_t ROM_mmap_store_data_offset(size_t n) {
+  size_t offset = sizeof(ROMMappedStoreHeader) + n * sizeof(ROMMappedStoreEntry);
+  return (offset + ROM_MMAP_STORE_ALIGNMENT - 1) / ROM_MMAP_STORE_ALIGNMENT * ROM_MMAP_STORE_ALIGNMENT;
+}
+
+/* Size of the data of a dataset in a store, including the alignment padding */
+static size_t ROM_mmap_store_data_size(size_t size1, size_t size2) {
+  size_t size = size1 * (size2 ? size2 : 1) * sizeof(double);
+  return (size + ROM_MMAP_STORE_ALIGNMENT - 1) / ROM_MMAP_STORE_ALIGNMENT * ROM_MMAP_STORE_ALIGNMENT;
+}
+#endif
+
+/**
+ * Return the path of the store for the ROM data file data_file, and
+ * optional tag, in the directory given by LAL_ROM_MMAP_DIR, or NULL if
+ * ROM data stores are not in use.  The path must be freed with XLALFree().
+ */
+static char *ROM_mmap_store_path(UNUSED const char data_file[], UNUSED const char tag[]) {
+#ifdef ROM_MMAP_STORE_ENABLED
+  const char *dir = getenv("LAL_ROM_MMAP_DIR");
+  if (dir == NULL || *dir == '\0')
+    return NULL;
+
+  const char *base = strrchr(data_file, '/');
+  base = base ? base + 1 : data_file;
+
+  size_t size = strlen(dir) + strlen(base) + (tag ? strlen(tag) + 1 : 0) + sizeof("/.lalrom");
+  char *path = XLALMalloc(size);
+  if (path == NULL)
+    return NULL;
+  if (tag)
+    snprintf(path, size, "%s/%s.%s.lalrom", dir, base, tag);
+  else
+    snprintf(path, size, "%s/%s.lalrom", dir, base);
+  return path;
+#else
+  return NULL;
+#endif
+}
+
+/**
+ * Map the store at path into memory and point the vectors and matrices
+ * referenced by refs to their datasets in the store.  The datasets must
+ * be stored in the same order and with the same names as in refs, and the
+ * store must have been made from the ROM data file data_file.
+ *
+ * The vectors and matrices do not own their data, and are read-only: they
+ * can be freed with gsl_vector_free() and gsl_matrix_free() as usual, after
+ * which the store must be released with ROM_mmap_store_unmap().
+ *
+ * Returns XLAL_FAILURE, without raising an XLAL error, if the store does
+ * not exist or cannot be used, so that the caller can load the ROM from
+ * its data file instead.
+ */
+static int ROM_mmap_store_load(UNUSED ROMMappedStore **store, UNUSED const char path[], UNUSED const char data_file[], UNUSED ROMDatasetRef *refs, UNUSED size_t n_refs) {
+#ifdef ROM_MMAP_STORE_ENABLED
+  struct stat source_stat, store_stat;
+  const ROMMappedStoreHeader *header;
+  const ROMMappedStoreEntry *entries;
+  void *base;
+  size_t i;
+  int fd;
+
+  if (stat(data_file, &source_stat) != 0)
+    return XLAL_FAILURE;
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return XLAL_FAILURE;
+  if (fstat(fd, &store_stat) != 0 || (size_t) store_stat.st_size < ROM_mmap_store_data_offset(n_refs)) {
+    close(fd);
+    return XLAL_FAILURE;
+  }
+  base = mmap(NULL, store_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED)
+    return XLAL_FAILURE;
+
+  /* check that the store is complete, and made from this data file */
+  header = base;
+  entries = (const ROMMappedStoreEntry *) (header + 1);
+  if (memcmp(header->magic, ROM_MMAP_STORE_MAGIC, sizeof(header->magic)) != 0
+      || header->byte_order != ROM_MMAP_STORE_BYTE_ORDER
+      || header->n_datasets != n_refs
+      || header->source_size != (UINT8) source_stat.st_size
+      || header->source_mtime != (INT8) source_stat.st_mtime)
+    goto invalid;
+  for (i = 0; i < n_refs; i++) {
+    const ROMMappedStoreEntry *e = &entries[i];
+    if (strncmp(e->name, refs[i].name, sizeof(e->name)) != 0
+        || (refs[i].matrix != NULL) != (e->size2 != 0)
+        || e->size1 == 0
+        || e->offset % ROM_MMAP_STORE_ALIGNMENT != 0
+        || e->offset + ROM_mmap_store_data_size(e->size1, e->size2) > (UINT8) store_stat.st_size)
+      goto invalid;
+  }
+
+  /* point the vectors and matrices to the data in the store */
+  for (i = 0; i < n_refs; i++) {
+    const ROMMappedStoreEntry *e = &entries[i];
+    double *data = (double *) ((char *) base + e->offset);
+    if (refs[i].matrix) {
+      gsl_matrix *m = malloc(sizeof(*m));
+      if (m == NULL)
+        goto nomem;
+      m->size1 = e->size1;
+      m->size2 = e->size2;
+      m->tda = e->size2;
+      m->data = data;
+      m->block = NULL;
+      m->owner = 0;
+      *refs[i].matrix = m;
+    } else {
+      gsl_vector *v = malloc(sizeof(*v));
+      if (v == NULL)
+        goto nomem;
+      v->size = e->size1;
+      v->stride = 1;
+      v->data = data;
+      v->block = NULL;
+      v->owner = 0;
+      *refs[i].vector = v;
+    }
+  }
+
+  *store = XLALMalloc(sizeof(**store));
+  if (*store == NULL)
+    goto nomem;
+  (*store)->base = base;
+  (*store)->size = store_stat.st_size;
+  XLALPrintInfo("%s: mapped ROM data store `%s'\n", __func__, path);
+  return XLAL_SUCCESS;
+
+nomem:
+  while (i--) {
+    if (refs[i].matrix) {
+      free(*refs[i].matrix);
+      *refs[i].matrix = NULL;
+    } else {
+      free(*refs[i].vector);
+      *refs[i].vector = NULL;
+    }
+  }
+invalid:
+  XLALPrintInfo("%s: ignoring ROM data store `%s'\n", __func__, path);
+  munmap(base, store_stat.st_size);
+  return XLAL_FAILURE;
+#else
+  return XLAL_FAILURE;
+#endif
+}
+
+/**
+ * Save the vectors and matrices referenced by refs, loaded from the ROM
+ * data file data_file, to a store at path.  The store is written to a
+ * temporary file which is then renamed, so processes that load the store
+ * never see a partially written one, and processes which save the same
+ * store at the same time do not interfere.
+ */
+static int ROM_mmap_store_save(UNUSED const char path[], UNUSED const char data_file[], UNUSED const ROMDatasetRef *refs, UNUSED size_t n_refs) {
+#ifdef ROM_MMAP_STORE_ENABLED
+  static const char padding[ROM_MMAP_STORE_ALIGNMENT];
+  ROMMappedStoreHeader header;
+  ROMMappedStoreEntry *entries;
+  struct stat source_stat;
+  size_t offset, i;
+  char *tmppath;
+  FILE *fp;
+  int ok = 1;
+
+  for (i = 0; i < n_refs; i++)
+    XLAL_CHECK(refs[i].matrix ? *refs[i].matrix != NULL : *refs[i].vector != NULL, XLAL_EFAULT, "Dataset `%s' is not loaded", refs[i].name);
+  if (stat(data_file, &source_stat) != 0)
+    XLAL_ERROR(XLAL_EIO, "Could not stat ROM data file `%s'", data_file);
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, ROM_MMAP_STORE_MAGIC, sizeof(header.magic));
+  header.byte_order = ROM_MMAP_STORE_BYTE_ORDER;
+  header.n_datasets = n_refs;
+  header.source_size = source_stat.st_size;
+  header.source_mtime = source_stat.st_mtime;
+
+  entries = XLALCalloc(n_refs, sizeof(*entries));
+  if (entries == NULL)
+    XLAL_ERROR(XLAL_ENOMEM);
+  offset = ROM_mmap_store_data_offset(n_refs);
+  for (i = 0; i < n_refs; i++) {
+    strncpy(entries[i].name, refs[i].name, sizeof(entries[i].name) - 1);
+    entries[i].size1 = refs[i].matrix ? (*refs[i].matrix)->size1 : (*refs[i].vector)->size;
+    entries[i].size2 = refs[i].matrix ? (*refs[i].matrix)->size2 : 0;
+    entries[i].offset = offset;
+    offset += ROM_mmap_store_data_size(entries[i].size1, entries[i].size2);
+  }
+
+  size_t size = strlen(path) + 32;
+  tmppath = XLALMalloc(size);
+  if (tmppath == NULL) {
+    XLALFree(entries);
+    XLAL_ERROR(XLAL_ENOMEM);
+  }
+  snprintf(tmppath, size, "%s.%ld.tmp", path, (long) getpid());
+  fp = fopen(tmppath, "wb");
+  if (fp == NULL) {
+    XLALFree(entries);
+    XLALFree(tmppath);
+    XLAL_ERROR(XLAL_EIO, "Could not create ROM data store `%s'", path);
+  }
+
+  ok &= fwrite(&header, sizeof(header), 1, fp) == 1;
+  ok &= fwrite(entries, sizeof(*entries), n_refs, fp) == n_refs;
+  offset = sizeof(header) + n_refs * sizeof(*entries);
+  for (i = 0; ok && i < n_refs; i++) {
+    size_t n1 = entries[i].size1, n2 = entries[i].size2;
+    ok &= fwrite(padding, 1, entries[i].offset - offset, fp) == entries[i].offset - offset;
+    if (refs[i].matrix) {
+      /* rows of a matrix need not be contiguous */
+      for (size_t r = 0; ok && r < n1; r++)
+        ok &= fwrite((*refs[i].matrix)->data + r * (*refs[i].matrix)->tda, sizeof(double), n2, fp) == n2;
+    } else {
+      const gsl_vector *v = *refs[i].vector;
+      for (size_t k = 0; ok && k < n1; k++)
+        ok &= fwrite(v->data + k * v->stride, sizeof(double), 1, fp) == 1;
+    }
+    offset = entries[i].offset + n1 * (n2 ? n2 : 1) * sizeof(double);
+  }
+  if (ok && n_refs > 0) {
+    /* pad the last dataset so that every dataset has its full aligned size */
+    size_t end = entries[n_refs - 1].offset + ROM_mmap_store_data_size(entries[n_refs - 1].size1, entries[n_refs - 1].size2);
+    ok &= fwrite(padding, 1, end - offset, fp) == end - offset;
+  }
+  ok &= fclose(fp) == 0;
+  XLALFree(entries);
+
+  if (!ok || rename(tmppath, path) != 0) {
+    remove(tmppath);
+    XLALFree(tmppath);
+    XLAL_ERROR(XLAL_EIO, "Could not write ROM data store `%s'", path);
+  }
+  XLALFree(tmppath);
+  XLALPrintInfo("%s: saved ROM data store `%s'\n", __func__, path);
+  return XLAL_SUCCESS;
+#else
+  XLAL_ERROR(XLAL_EFAILED, "ROM data stores are not supported on this platform");
+#endif
+}
+
+/**
+ * Release a store mapped by ROM_mmap_store_load(), after the vectors and
+ * matrices pointing into it have been freed.
+ */
+static void ROM_mmap_store_unmap(UNUSED ROMMappedStore *store) {
+#ifdef ROM_MMAP_STORE_ENABLED
+  if (store) {
+    munmap(store->base, store->size);
+    XLALFree(store);
+  }
+#endif
+}
+
+/* Set up a reference to the vector or matrix holding dataset name in group */
+static void ROM_dataset_ref(ROMDatasetRef *ref, const char group[], const char name[], gsl_vector **vector, gsl_matrix **matrix) {
+  snprintf(ref->name, sizeof(ref->name), "%s/%s", group, name);
+  ref->vector = vector;
+  ref->matrix = matrix;
+}
@@ -323,33 +323,25 @@ static int TP_Spline_interpolation_3d(
 
   SplineData *splinedata=NULL;
   SplineData_Init(&splinedata);
-  gsl_bspline_workspace *bwx=splinedata->bwx;
-  gsl_bspline_workspace *bwy=splinedata->bwy;
-  gsl_bspline_workspace *bwz=splinedata->bwz;
-
   int ncx = splinedata->ncx; // points in q
   int ncy = splinedata->ncy; // points in chi1
   int ncz = splinedata->ncz; // points in chi2
+
+  // Evaluate the nonzero B-spline basis functions once for all SVD modes
+  ROMTensorSplineBasis basis;
+  ROM_TP_Spline_basis_3d(&basis, q, chi1, chi2, ncy, ncz, splinedata->bwx, splinedata->bwy, splinedata->bwz);
+  SplineData_Destroy(splinedata);
+
   int N = ncx*ncy*ncz;  // size of the data matrix for one SVD-mode
 
   // Evaluate the TP spline for all SVD modes - amplitude
-  for (int k=0; k<nk_amp; k++) { // For each SVD mode
-    gsl_vector v = gsl_vector_subvector(cvec_amp, k*N, N).vector; // Pick out the coefficient matrix corresponding to the k-th SVD mode.
-    REAL8 csum = Interpolate_Coefficent_Tensor(&v, q, chi1, chi2, ncy, ncz, bwx, bwy, bwz);
-    gsl_vector_set(c_amp, k, csum);
-  }
+  XLAL_CHECK(ROM_TP_Spline_eval_tables(&basis, cvec_amp, N, nk_amp, c_amp) == XLAL_SUCCESS, XLAL_EFUNC);
 
   // Evaluate the TP spline for all SVD modes - phase
-  for (int k=0; k<nk_phi; k++) {  // For each SVD mode
-    gsl_vector v = gsl_vector_subvector(cvec_phi, k*N, N).vector; // Pick out the coefficient matrix corresponding to the k-th SVD mode.
-    REAL8 csum = Interpolate_Coefficent_Tensor(&v, q, chi1, chi2, ncy, ncz, bwx, bwy, bwz);
-    gsl_vector_set(c_phi, k, csum);
-  }
+  XLAL_CHECK(ROM_TP_Spline_eval_tables(&basis, cvec_phi, N, nk_phi, c_phi) == XLAL_SUCCESS, XLAL_EFUNC);
 
   // Evaluate the TP spline for the amplitude prefactor
-  *amp_pre = Interpolate_Coefficent_Tensor(cvec_amp_pre, q, chi1, chi2, ncy, ncz, bwx, bwy, bwz);
-
-  SplineData_Destroy(splinedata);
+  *amp_pre = ROM_TP_Spline_eval(&basis, cvec_amp_pre->data);
 
   return(0);
 }
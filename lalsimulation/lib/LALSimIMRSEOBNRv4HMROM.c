@@ -597,19 +597,14 @@ static int TP_Spline_interpolation_3d(
   SplineData *splinedata=NULL;
   SplineData_Init(&splinedata, ncx, ncy, ncz, qvec, chi1vec, chi2vec);
 
-  gsl_bspline_workspace *bwx=splinedata->bwx;
-  gsl_bspline_workspace *bwy=splinedata->bwy;
-  gsl_bspline_workspace *bwz=splinedata->bwz;
+  // Evaluate the nonzero B-spline basis functions once for all SVD modes
+  ROMTensorSplineBasis basis;
+  ROM_TP_Spline_basis_3d(&basis, q, chi1, chi2, ncy, ncz, splinedata->bwx, splinedata->bwy, splinedata->bwz);
+  SplineData_Destroy(splinedata);
 
   int N = ncx*ncy*ncz;  // Size of the data matrix for one SVD-mode
   // Evaluate the TP spline for all SVD modes - amplitude
-  for (int k=0; k<nk; k++) { // For each SVD mode
-    gsl_vector v = gsl_vector_subvector(cvec, k*N, N).vector; // Pick out the coefficient matrix corresponding to the k-th SVD mode.
-    REAL8 csum = Interpolate_Coefficent_Tensor(&v, q, chi1, chi2, ncy, ncz, bwx, bwy, bwz);
-    gsl_vector_set(c_out, k, csum);
-  }
-  SplineData_Destroy(splinedata);
-
+  XLAL_CHECK(ROM_TP_Spline_eval_tables(&basis, cvec, N, nk, c_out) == XLAL_SUCCESS, XLAL_EFUNC);
   return(0);
 }
 
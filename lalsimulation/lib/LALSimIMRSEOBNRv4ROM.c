@@ -24,6 +24,7 @@
 #define UNUSED
 #endif
 
+#include <config.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
@@ -110,6 +111,7 @@ struct tagSEOBNRROMdataDS
   SEOBNRROMdataDS_submodel* sub1;
   SEOBNRROMdataDS_submodel* sub2;
   SEOBNRROMdataDS_submodel* sub3;
+  ROMMappedStore *store;     // ROM data store the submodels point into, if any
 };
 typedef struct tagSEOBNRROMdataDS SEOBNRROMdataDS;
 
@@ -161,6 +163,9 @@ UNUSED static int SEOBNRROMdataDS_Init_submodel(
 );
 
 UNUSED static void SEOBNRROMdataDS_Cleanup_submodel(SEOBNRROMdataDS_submodel *submodel);
+UNUSED static void SEOBNRROMdataDS_Setup_submodel(SEOBNRROMdataDS_submodel *submodel);
+UNUSED static size_t SEOBNRROMdataDS_Datasets(SEOBNRROMdataDS *romdata, ROMDatasetRef refs[]);
+UNUSED static int SEOBNRROMdataDS_Init_mmap(SEOBNRROMdataDS *romdata, const char store_path[], const char data_file[]);
 
 /**
  * Core function for computing the ROM waveform.
@@ -373,26 +378,17 @@ static int TP_Spline_interpolation_3d(
   SplineData *splinedata=NULL;
   SplineData_Init(&splinedata, ncx, ncy, ncz, etavec, chi1vec, chi2vec);
 
-  gsl_bspline_workspace *bwx=splinedata->bwx;
-  gsl_bspline_workspace *bwy=splinedata->bwy;
-  gsl_bspline_workspace *bwz=splinedata->bwz;
+  // Evaluate the nonzero B-spline basis functions once for all SVD modes
+  ROMTensorSplineBasis basis;
+  ROM_TP_Spline_basis_3d(&basis, eta, chi1, chi2, ncy, ncz, splinedata->bwx, splinedata->bwy, splinedata->bwz);
+  SplineData_Destroy(splinedata);
 
   int N = ncx*ncy*ncz;  // Size of the data matrix for one SVD-mode
   // Evaluate the TP spline for all SVD modes - amplitude
-  for (int k=0; k<nk_amp; k++) { // For each SVD mode
-    gsl_vector v = gsl_vector_subvector(cvec_amp, k*N, N).vector; // Pick out the coefficient matrix corresponding to the k-th SVD mode.
-    REAL8 csum = Interpolate_Coefficent_Tensor(&v, eta, chi1, chi2, ncy, ncz, bwx, bwy, bwz);
-    gsl_vector_set(c_amp, k, csum);
-  }
+  XLAL_CHECK(ROM_TP_Spline_eval_tables(&basis, cvec_amp, N, nk_amp, c_amp) == XLAL_SUCCESS, XLAL_EFUNC);
 
   // Evaluate the TP spline for all SVD modes - phase
-  for (int k=0; k<nk_phi; k++) {  // For each SVD mode
-    gsl_vector v = gsl_vector_subvector(cvec_phi, k*N, N).vector; // Pick out the coefficient matrix corresponding to the k-th SVD mode.
-    REAL8 csum = Interpolate_Coefficent_Tensor(&v, eta, chi1, chi2, ncy, ncz, bwx, bwy, bwz);
-    gsl_vector_set(c_phi, k, csum);
-  }
-
-  SplineData_Destroy(splinedata);
+  XLAL_CHECK(ROM_TP_Spline_eval_tables(&basis, cvec_phi, N, nk_phi, c_phi) == XLAL_SUCCESS, XLAL_EFUNC);
 
   return(0);
 }
@@ -438,19 +434,7 @@ UNUSED static int SEOBNRROMdataDS_Init_submodel(
   ReadHDF5RealVectorDataset(sub, "chi2vec", & (*submodel)->chi2vec);
 
   // Initialize other members
-  (*submodel)->nk_amp = (*submodel)->gA->size;
-  (*submodel)->nk_phi = (*submodel)->gPhi->size;
-  (*submodel)->ncx = (*submodel)->etavec->size + 2;
-  (*submodel)->ncy = (*submodel)->chi1vec->size + 2;
-  (*submodel)->ncz = (*submodel)->chi2vec->size + 2;
-
-  // Domain of definition of submodel
-  (*submodel)->eta_bounds[0] = gsl_vector_get((*submodel)->etavec, 0);
-  (*submodel)->eta_bounds[1] = gsl_vector_get((*submodel)->etavec, (*submodel)->etavec->size - 1);
-  (*submodel)->chi1_bounds[0] = gsl_vector_get((*submodel)->chi1vec, 0);
-  (*submodel)->chi1_bounds[1] = gsl_vector_get((*submodel)->chi1vec, (*submodel)->chi1vec->size - 1);
-  (*submodel)->chi2_bounds[0] = gsl_vector_get((*submodel)->chi2vec, 0);
-  (*submodel)->chi2_bounds[1] = gsl_vector_get((*submodel)->chi2vec, (*submodel)->chi2vec->size - 1);
+  SEOBNRROMdataDS_Setup_submodel(*submodel);
 
   XLALFree(path);
   XLALH5FileClose(file);
@@ -462,6 +446,23 @@ UNUSED static int SEOBNRROMdataDS_Init_submodel(
   return ret;
 }
 
+/* Initialize the members of a submodel which are derived from its datasets */
+static void SEOBNRROMdataDS_Setup_submodel(SEOBNRROMdataDS_submodel *submodel) {
+  submodel->nk_amp = submodel->gA->size;
+  submodel->nk_phi = submodel->gPhi->size;
+  submodel->ncx = submodel->etavec->size + 2;
+  submodel->ncy = submodel->chi1vec->size + 2;
+  submodel->ncz = submodel->chi2vec->size + 2;
+
+  // Domain of definition of submodel
+  submodel->eta_bounds[0] = gsl_vector_get(submodel->etavec, 0);
+  submodel->eta_bounds[1] = gsl_vector_get(submodel->etavec, submodel->etavec->size - 1);
+  submodel->chi1_bounds[0] = gsl_vector_get(submodel->chi1vec, 0);
+  submodel->chi1_bounds[1] = gsl_vector_get(submodel->chi1vec, submodel->chi1vec->size - 1);
+  submodel->chi2_bounds[0] = gsl_vector_get(submodel->chi2vec, 0);
+  submodel->chi2_bounds[1] = gsl_vector_get(submodel->chi2vec, submodel->chi2vec->size - 1);
+}
+
 /* Deallocate contents of the given SEOBNRROMdataDS_submodel structure */
 static void SEOBNRROMdataDS_Cleanup_submodel(SEOBNRROMdataDS_submodel *submodel) {
   if(submodel->cvec_amp) gsl_vector_free(submodel->cvec_amp);
@@ -475,6 +476,51 @@ static void SEOBNRROMdataDS_Cleanup_submodel(SEOBNRROMdataDS_submodel *submodel)
   if(submodel->chi2vec) gsl_vector_free(submodel->chi2vec);
 }
 
+/* List the datasets of all submodels, for ROM data stores; refs must have
+ * room for SEOBNRv4ROM_NUM_DATASETS references */
+#define SEOBNRv4ROM_NUM_DATASETS 27
+static size_t SEOBNRROMdataDS_Datasets(SEOBNRROMdataDS *romdata, ROMDatasetRef refs[]) {
+  SEOBNRROMdataDS_submodel *submodels[3] = {romdata->sub1, romdata->sub2, romdata->sub3};
+  const char *grp_names[3] = {"sub1", "sub2", "sub3"};
+  size_t n = 0;
+  for (int i = 0; i < 3; i++) {
+    SEOBNRROMdataDS_submodel *submodel = submodels[i];
+    ROM_dataset_ref(&refs[n++], grp_names[i], "Amp_ciall", &submodel->cvec_amp, NULL);
+    ROM_dataset_ref(&refs[n++], grp_names[i], "Phase_ciall", &submodel->cvec_phi, NULL);
+    ROM_dataset_ref(&refs[n++], grp_names[i], "Bamp", NULL, &submodel->Bamp);
+    ROM_dataset_ref(&refs[n++], grp_names[i], "Bphase", NULL, &submodel->Bphi);
+    ROM_dataset_ref(&refs[n++], grp_names[i], "Mf_grid_Amp", &submodel->gA, NULL);
+    ROM_dataset_ref(&refs[n++], grp_names[i], "Mf_grid_Phi", &submodel->gPhi, NULL);
+    ROM_dataset_ref(&refs[n++], grp_names[i], "etavec", &submodel->etavec, NULL);
+    ROM_dataset_ref(&refs[n++], grp_names[i], "chi1vec", &submodel->chi1vec, NULL);
+    ROM_dataset_ref(&refs[n++], grp_names[i], "chi2vec", &submodel->chi2vec, NULL);
+  }
+  return n;
+}
+
+/* Set up a new ROM model from the ROM data store at store_path, which must
+ * have been made from data_file; fails quietly if the store is unusable */
+static int SEOBNRROMdataDS_Init_mmap(SEOBNRROMdataDS *romdata, const char store_path[], const char data_file[]) {
+  ROMDatasetRef refs[SEOBNRv4ROM_NUM_DATASETS];
+  SEOBNRROMdataDS_submodel **submodels[3] = {&romdata->sub1, &romdata->sub2, &romdata->sub3};
+
+  for (int i = 0; i < 3; i++) {
+    if (!*submodels[i])
+      *submodels[i] = XLALCalloc(1, sizeof(SEOBNRROMdataDS_submodel));
+    if (!*submodels[i])
+      return XLAL_FAILURE;
+  }
+
+  size_t n = SEOBNRROMdataDS_Datasets(romdata, refs);
+  if (ROM_mmap_store_load(&romdata->store, store_path, data_file, refs, n) != XLAL_SUCCESS)
+    return XLAL_FAILURE;
+
+  for (int i = 0; i < 3; i++)
+    SEOBNRROMdataDS_Setup_submodel(*submodels[i]);
+
+  return XLAL_SUCCESS;
+}
+
 /* Set up a new ROM model, using data contained in dir */
 int SEOBNRROMdataDS_Init(
   UNUSED SEOBNRROMdataDS *romdata,
@@ -489,10 +535,20 @@ int SEOBNRROMdataDS_Init(
   }
 
 #ifdef LAL_HDF5_ENABLED
-  // First, check we got the correct version number
   size_t size = strlen(dir) + strlen(ROMDataHDF5) + 2;
   char *path = XLALMalloc(size);
   snprintf(path, size, "%s/%s", dir, ROMDataHDF5);
+
+  // Map the ROM data store made from this data file, if there is one
+  char *store_path = ROM_mmap_store_path(path, NULL);
+  if (store_path && SEOBNRROMdataDS_Init_mmap(romdata, store_path, path) == XLAL_SUCCESS) {
+    XLALFree(store_path);
+    XLALFree(path);
+    romdata->setup = 1;
+    return XLAL_SUCCESS;
+  }
+
+  // First, check we got the correct version number
   LALH5File *file = XLALH5FileOpen(path, "r");
 
   XLALPrintInfo("ROM metadata\n============\n");
@@ -502,7 +558,6 @@ int SEOBNRROMdataDS_Init(
                                  ROMDataHDF5_VERSION_MINOR,
                                  ROMDataHDF5_VERSION_MICRO);
 
-  XLALFree(path);
   XLALH5FileClose(file);
 
   ret |= SEOBNRROMdataDS_Init_submodel(&(romdata)->sub1, dir, "sub1");
@@ -514,10 +569,24 @@ int SEOBNRROMdataDS_Init(
   ret |= SEOBNRROMdataDS_Init_submodel(&(romdata)->sub3, dir, "sub3");
   if (ret==XLAL_SUCCESS) XLALPrintInfo("%s : submodel 3 loaded successfully.\n", __func__);
 
-  if(XLAL_SUCCESS==ret)
+  if(XLAL_SUCCESS==ret) {
     romdata->setup=1;
+
+    // Save the ROM data store for other processes; failing to do so is harmless
+    if (store_path) {
+      ROMDatasetRef refs[SEOBNRv4ROM_NUM_DATASETS];
+      size_t n = SEOBNRROMdataDS_Datasets(romdata, refs);
+      if (ROM_mmap_store_save(store_path, path, refs, n) != XLAL_SUCCESS) {
+        XLALPrintWarning("%s: could not save ROM data store `%s'\n", __func__, store_path);
+        XLALClearErrno();
+      }
+    }
+  }
   else
     SEOBNRROMdataDS_Cleanup(romdata);
+
+  XLALFree(store_path);
+  XLALFree(path);
 #else
   XLAL_ERROR(XLAL_EFAILED, "HDF5 support not enabled");
 #endif
@@ -536,6 +605,8 @@ static void SEOBNRROMdataDS_Cleanup(SEOBNRROMdataDS *romdata) {
   SEOBNRROMdataDS_Cleanup_submodel((romdata)->sub3);
   XLALFree((romdata)->sub3);
   (romdata)->sub3 = NULL;
+  ROM_mmap_store_unmap(romdata->store);
+  romdata->store = NULL;
   romdata->setup=0;
 }
 
@@ -27,6 +27,7 @@
 #define UNUSED
 #endif
 
+#include <config.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
@@ -170,6 +171,7 @@ struct tagSEOBNRROMdataDS
   UINT4 setup;
   SEOBNRROMdataDS_submodel* highf;
   SEOBNRROMdataDS_submodel* lowf;
+  ROMMappedStore *store;     // ROM data store the submodels point into, if any
 };
 typedef struct tagSEOBNRROMdataDS SEOBNRROMdataDS;
 
@@ -211,6 +213,9 @@ UNUSED static int SEOBNRROMdataDS_Init_submodel(
   UNUSED bool use_hm
 );
 UNUSED static void SEOBNRROMdataDS_Cleanup_submodel(SEOBNRROMdataDS_submodel *submodel);
+UNUSED static void SEOBNRROMdataDS_Setup_submodel(SEOBNRROMdataDS_submodel *submodel, UINT4 index_mode);
+UNUSED static size_t SEOBNRROMdataDS_Datasets(SEOBNRROMdataDS *romdata, UINT4 index_mode, ROMDatasetRef refs[]);
+UNUSED static int SEOBNRROMdataDS_Init_mmap(SEOBNRROMdataDS *romdata, UINT4 index_mode, const char store_path[], const char data_file[]);
 UNUSED static void SplineData_Destroy(SplineData *splinedata);
 UNUSED static void SplineData_Init(
   SplineData **splinedata,
@@ -660,19 +665,14 @@ static int TP_Spline_interpolation_3d(
   SplineData *splinedata=NULL;
   SplineData_Init(&splinedata, ncx, ncy, ncz, qvec, chi1vec, chi2vec);
 
-  gsl_bspline_workspace *bwx=splinedata->bwx;
-  gsl_bspline_workspace *bwy=splinedata->bwy;
-  gsl_bspline_workspace *bwz=splinedata->bwz;
+  // Evaluate the nonzero B-spline basis functions once for all SVD modes
+  ROMTensorSplineBasis basis;
+  ROM_TP_Spline_basis_3d(&basis, q, chi1, chi2, ncy, ncz, splinedata->bwx, splinedata->bwy, splinedata->bwz);
+  SplineData_Destroy(splinedata);
 
   int N = ncx*ncy*ncz;  // Size of the data matrix for one SVD-mode
   // Evaluate the TP spline for all SVD modes - amplitude
-  for (int k=0; k<nk; k++) { // For each SVD mode
-    gsl_vector v = gsl_vector_subvector(cvec, k*N, N).vector; // Pick out the coefficient matrix corresponding to the k-th SVD mode.
-    REAL8 csum = Interpolate_Coefficent_Tensor(&v, q, chi1, chi2, ncy, ncz, bwx, bwy, bwz);
-    gsl_vector_set(c_out, k, csum);
-  }
-  SplineData_Destroy(splinedata);
-
+  XLAL_CHECK(ROM_TP_Spline_eval_tables(&basis, cvec, N, nk, c_out) == XLAL_SUCCESS, XLAL_EFUNC);
   return(0);
 }
 
@@ -694,6 +694,62 @@ static int SEOBNRv5HMROM_Init(const char dir[],UINT4 index_mode, bool use_hm, SE
   return(XLAL_SUCCESS);
 }
 
+/* List the datasets of both submodels of a mode, for ROM data stores; refs
+ * must have room for SEOBNRv5HMROM_MAX_DATASETS references */
+#define SEOBNRv5HMROM_MAX_DATASETS 22
+static size_t SEOBNRROMdataDS_Datasets(SEOBNRROMdataDS *romdata, UINT4 index_mode, ROMDatasetRef refs[]) {
+  SEOBNRROMdataDS_submodel *submodels[2] = {romdata->highf, romdata->lowf};
+  const char *grp_names[2] = {"highf", "lowf"};
+  char name[ROM_MMAP_STORE_NAME_LENGTH];
+  size_t n = 0;
+  for (int i = 0; i < 2; i++) {
+    SEOBNRROMdataDS_submodel *submodel = submodels[i];
+    snprintf(name, sizeof(name), "CF_modes/%s/coeff_re_flattened", mode_array_v5hm[index_mode]);
+    ROM_dataset_ref(&refs[n++], grp_names[i], name, &submodel->cvec_real, NULL);
+    snprintf(name, sizeof(name), "CF_modes/%s/coeff_im_flattened", mode_array_v5hm[index_mode]);
+    ROM_dataset_ref(&refs[n++], grp_names[i], name, &submodel->cvec_imag, NULL);
+    snprintf(name, sizeof(name), "CF_modes/%s/basis_re", mode_array_v5hm[index_mode]);
+    ROM_dataset_ref(&refs[n++], grp_names[i], name, NULL, &submodel->Breal);
+    snprintf(name, sizeof(name), "CF_modes/%s/basis_im", mode_array_v5hm[index_mode]);
+    ROM_dataset_ref(&refs[n++], grp_names[i], name, NULL, &submodel->Bimag);
+    snprintf(name, sizeof(name), "CF_modes/%s/MF_grid", mode_array_v5hm[index_mode]);
+    ROM_dataset_ref(&refs[n++], grp_names[i], name, &submodel->gCMode, NULL);
+    //// Orbital phase datasets are used only in the 22 mode
+    if(index_mode == 0){
+      ROM_dataset_ref(&refs[n++], grp_names[i], "phase_carrier/coeff_flattened", &submodel->cvec_phase, NULL);
+      ROM_dataset_ref(&refs[n++], grp_names[i], "phase_carrier/basis", NULL, &submodel->Bphase);
+      ROM_dataset_ref(&refs[n++], grp_names[i], "phase_carrier/MF_grid", &submodel->gPhase, NULL);
+    }
+    ROM_dataset_ref(&refs[n++], grp_names[i], "qvec", &submodel->qvec, NULL);
+    ROM_dataset_ref(&refs[n++], grp_names[i], "chi1vec", &submodel->chi1vec, NULL);
+    ROM_dataset_ref(&refs[n++], grp_names[i], "chi2vec", &submodel->chi2vec, NULL);
+  }
+  return n;
+}
+
+/* Set up a new ROM mode from the ROM data store at store_path, which must
+ * have been made from data_file; fails quietly if the store is unusable */
+static int SEOBNRROMdataDS_Init_mmap(SEOBNRROMdataDS *romdata, UINT4 index_mode, const char store_path[], const char data_file[]) {
+  ROMDatasetRef refs[SEOBNRv5HMROM_MAX_DATASETS];
+  SEOBNRROMdataDS_submodel **submodels[2] = {&romdata->highf, &romdata->lowf};
+
+  for (int i = 0; i < 2; i++) {
+    if (!*submodels[i])
+      *submodels[i] = XLALCalloc(1, sizeof(SEOBNRROMdataDS_submodel));
+    if (!*submodels[i])
+      return XLAL_FAILURE;
+  }
+
+  size_t n = SEOBNRROMdataDS_Datasets(romdata, index_mode, refs);
+  if (ROM_mmap_store_load(&romdata->store, store_path, data_file, refs, n) != XLAL_SUCCESS)
+    return XLAL_FAILURE;
+
+  for (int i = 0; i < 2; i++)
+    SEOBNRROMdataDS_Setup_submodel(*submodels[i], index_mode);
+
+  return XLAL_SUCCESS;
+}
+
 /* Set up a new ROM mode, using data contained in dir */
 int SEOBNRROMdataDS_Init(
   UNUSED SEOBNRROMdataDS *romdata,
@@ -726,6 +782,16 @@ int SEOBNRROMdataDS_Init(
   else{
     snprintf(path, size, "%s/%s", dir, ROM22DataHDF5);
   }
+
+  // Map the ROM data store made from this data file for this mode, if there is one
+  char *store_path = ROM_mmap_store_path(path, mode_array_v5hm[index_mode]);
+  if (store_path && SEOBNRROMdataDS_Init_mmap(romdata, index_mode, store_path, path) == XLAL_SUCCESS) {
+    XLALFree(store_path);
+    XLALFree(path);
+    romdata->setup = 1;
+    return XLAL_SUCCESS;
+  }
+
   LALH5File *file = XLALH5FileOpen(path, "r");
 
   XLALPrintInfo("ROM metadata\n============\n");
@@ -755,10 +821,21 @@ int SEOBNRROMdataDS_Init(
 
   if(XLAL_SUCCESS==ret){
     romdata->setup=1;
+
+    // Save the ROM data store for other processes; failing to do so is harmless
+    if (store_path) {
+      ROMDatasetRef refs[SEOBNRv5HMROM_MAX_DATASETS];
+      size_t n = SEOBNRROMdataDS_Datasets(romdata, index_mode, refs);
+      if (ROM_mmap_store_save(store_path, path, refs, n) != XLAL_SUCCESS) {
+        XLALPrintWarning("%s: could not save ROM data store `%s'\n", __func__, store_path);
+        XLALClearErrno();
+      }
+    }
   }
    else
      SEOBNRROMdataDS_Cleanup(romdata);
 
+  XLALFree(store_path);
   XLALFree(path);
   XLALH5FileClose(file);
   ret = XLAL_SUCCESS;
@@ -778,9 +855,31 @@ static void SEOBNRROMdataDS_Cleanup(SEOBNRROMdataDS *romdata) {
   SEOBNRROMdataDS_Cleanup_submodel((romdata)->lowf);
   XLALFree((romdata)->lowf);
   (romdata)->lowf = NULL;
+  ROM_mmap_store_unmap(romdata->store);
+  romdata->store = NULL;
   romdata->setup=0;
 }
 
+/* Initialize the members of a submodel which are derived from its datasets */
+static void SEOBNRROMdataDS_Setup_submodel(SEOBNRROMdataDS_submodel *submodel, UINT4 index_mode) {
+  submodel->nk_cmode = submodel->gCMode->size;
+  //// Used only in the 22 mode
+  if(index_mode == 0){
+    submodel->nk_phase = submodel->gPhase->size;
+  }
+  submodel->ncx = submodel->qvec->size + 2;
+  submodel->ncy = submodel->chi1vec->size + 2;
+  submodel->ncz = submodel->chi2vec->size + 2;
+
+  // Domain of definition of submodel
+  submodel->q_bounds[0] = gsl_vector_get(submodel->qvec, 0);
+  submodel->q_bounds[1] = gsl_vector_get(submodel->qvec, submodel->qvec->size - 1);
+  submodel->chi1_bounds[0] = gsl_vector_get(submodel->chi1vec, 0);
+  submodel->chi1_bounds[1] = gsl_vector_get(submodel->chi1vec, submodel->chi1vec->size - 1);
+  submodel->chi2_bounds[0] = gsl_vector_get(submodel->chi2vec, 0);
+  submodel->chi2_bounds[1] = gsl_vector_get(submodel->chi2vec, submodel->chi2vec->size - 1);
+}
+
 /* Deallocate contents of the given SEOBNRROMdataDS_submodel structure */
 static void SEOBNRROMdataDS_Cleanup_submodel(SEOBNRROMdataDS_submodel *submodel) {
   if(submodel->cvec_real) gsl_vector_free(submodel->cvec_real);
@@ -879,22 +978,7 @@ UNUSED static int SEOBNRROMdataDS_Init_submodel(
 
 
   // Initialize other members
-  (*submodel)->nk_cmode = (*submodel)->gCMode->size;
-  //// Used only in the 22 mode
-  if(index_mode == 0){
-    (*submodel)->nk_phase = (*submodel)->gPhase->size;
-  }
-  (*submodel)->ncx = (*submodel)->qvec->size + 2;
-  (*submodel)->ncy = (*submodel)->chi1vec->size + 2;
-  (*submodel)->ncz = (*submodel)->chi2vec->size + 2;
-
-  // Domain of definition of submodel
-  (*submodel)->q_bounds[0] = gsl_vector_get((*submodel)->qvec, 0);
-  (*submodel)->q_bounds[1] = gsl_vector_get((*submodel)->qvec, (*submodel)->qvec->size - 1);
-  (*submodel)->chi1_bounds[0] = gsl_vector_get((*submodel)->chi1vec, 0);
-  (*submodel)->chi1_bounds[1] = gsl_vector_get((*submodel)->chi1vec, (*submodel)->chi1vec->size - 1);
-  (*submodel)->chi2_bounds[0] = gsl_vector_get((*submodel)->chi2vec, 0);
-  (*submodel)->chi2_bounds[1] = gsl_vector_get((*submodel)->chi2vec, (*submodel)->chi2vec->size - 1);
+  SEOBNRROMdataDS_Setup_submodel(*submodel, index_mode);
 
   XLALFree(path);
   XLALH5FileClose(file);
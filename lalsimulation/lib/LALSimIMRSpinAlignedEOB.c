@@ -1666,7 +1666,7 @@ XLALSimIMRSpinAlignedEOBModes (
     if ( use_tidal == 1 ) {
         if (!
             (integrator =
-             XLALAdaptiveRungeKutta4Init (4, XLALSpinAlignedHcapDerivative,
+             XLALAdaptiveRungeKutta4ThreadInit (4, XLALSpinAlignedHcapDerivative,
                                           XLALSpinAlignedNSNSStopCondition,
                                           EPS_ABS, EPS_REL)))
         {
@@ -1679,7 +1679,7 @@ XLALSimIMRSpinAlignedEOBModes (
         {
             if (!
                 (integrator =
-                 XLALAdaptiveRungeKutta4InitEighthOrderInstead (4,
+                 XLALAdaptiveRungeKutta4ThreadInitEighthOrderInstead (4,
 							  XLALSpinAlignedHcapDerivativeOptimized,
 							  XLALEOBSpinAlignedStopCondition,
 							  EPS_ABS, EPS_REL)))
@@ -1694,7 +1694,7 @@ XLALSimIMRSpinAlignedEOBModes (
           if(postAdiabaticFlag){
               if (!
                   (integrator =
-                  XLALAdaptiveRungeKutta4Init (4, XLALSpinAlignedHcapDerivativeOptimized,
+                  XLALAdaptiveRungeKutta4ThreadInit (4, XLALSpinAlignedHcapDerivativeOptimized,
             XLALEOBSpinAlignedStopCondition,
             EPS_ABS, EPS_REL)))
               {
@@ -1705,7 +1705,7 @@ XLALSimIMRSpinAlignedEOBModes (
           else{
             if (!
                   (integrator =
-                  XLALAdaptiveRungeKutta4Init (4, XLALSpinAlignedHcapDerivative,
+                  XLALAdaptiveRungeKutta4ThreadInit (4, XLALSpinAlignedHcapDerivative,
             XLALEOBSpinAlignedStopCondition,
             EPS_ABS, EPS_REL)))
               {
@@ -550,6 +550,39 @@ typedef struct tagPNPhasingSeries
 }
 PNPhasingSeries;
 
+/**
+ * TaylorF2 phasing coefficients evaluated at reference values of the
+ * spin-induced quadrupole parameters, together with their derivatives with
+ * respect to dQuadMon1 and dQuadMon2.  The quadrupole terms enter the phasing
+ * linearly, so the coefficients for other values of dQuadMon1 and dQuadMon2
+ * follow without recomputing the mass and spin terms.
+ */
+typedef struct tagPNPhasingSeriesQuadMonTerms
+{
+    PNPhasingSeries ref;        /**< phasing at the reference dQuadMon1, dQuadMon2 */
+    PNPhasingSeries dquadmon1;  /**< derivative of the phasing with respect to dQuadMon1 */
+    PNPhasingSeries dquadmon2;  /**< derivative of the phasing with respect to dQuadMon2 */
+    REAL8 dQuadMon1;            /**< reference value of dQuadMon1 */
+    REAL8 dQuadMon2;            /**< reference value of dQuadMon2 */
+}
+PNPhasingSeriesQuadMonTerms;
+
+/**
+ * A frequency grid together with per-bin quantities that frequency-domain
+ * models otherwise recompute on every call: powers and logarithms of the
+ * frequency.  Models scale these by the appropriate power of the total
+ * mass, so one grid serves any binary.  Create with
+ * XLALCreateSimInspiralFrequencyGrid().
+ */
+typedef struct tagLALSimInspiralFrequencyGrid
+{
+    REAL8Sequence *freqs;       /**< frequencies (Hz) */
+    REAL8Sequence *sixth;       /**< f^(1/6) */
+    REAL8Sequence *third;       /**< f^(1/3) */
+    REAL8Sequence *logf;        /**< log(f) */
+}
+LALSimInspiralFrequencyGrid;
+
 /** @} */
 
 /* general waveform switching generation routines  */
@@ -730,7 +763,11 @@ int XLALHGimriGenerator(REAL8TimeSeries **hplus, REAL8TimeSeries **hcross, REAL8
 /* in module LALSimInspiralTaylorF2.c */
 int XLALSimInspiralTaylorF2AlignedPhasing(PNPhasingSeries **pfa, const REAL8 m1, const REAL8 m2, const REAL8 chi1, const REAL8 chi2, LALDict *extraPars);
 int XLALSimInspiralTaylorF2AlignedPhasingArray(REAL8Vector **phasingvals, REAL8Vector mass1, REAL8Vector mass2, REAL8Vector chi1, REAL8Vector chi2, REAL8Vector lambda1, REAL8Vector lambda2, REAL8Vector dquadmon1, REAL8Vector dquadmon2);
+int XLALSimInspiralTaylorF2AlignedPhasingQuadMonTerms(PNPhasingSeriesQuadMonTerms **terms, const REAL8 m1, const REAL8 m2, const REAL8 chi1, const REAL8 chi2, LALDict *extraPars);
+int XLALSimInspiralTaylorF2AlignedPhasingFromQuadMonTerms(PNPhasingSeries *pfa, const PNPhasingSeriesQuadMonTerms *terms, const REAL8 dQuadMon1, const REAL8 dQuadMon2);
+int XLALSimInspiralTaylorF2AlignedPhasingQuadMonArray(REAL8Vector **phasingvals, const PNPhasingSeriesQuadMonTerms *terms, REAL8Vector dquadmon1, REAL8Vector dquadmon2);
 int XLALSimInspiralTaylorF2Core(COMPLEX16FrequencySeries **htilde, const REAL8Sequence *freqs, const REAL8 phi_ref, const REAL8 m1_SI, const REAL8 m2_SI, const REAL8 f_ref, const REAL8 shft, const REAL8 r, LALDict *LALparams, PNPhasingSeries *pfaP);
+int XLALSimInspiralTaylorF2CoreFrequencyGrid(COMPLEX16FrequencySeries **htilde, const LALSimInspiralFrequencyGrid *grid, const REAL8 phi_ref, const REAL8 m1_SI, const REAL8 m2_SI, const REAL8 f_ref, const REAL8 shft, const REAL8 r, LALDict *LALparams, PNPhasingSeries *pfaP);
 
 int XLALSimInspiralTaylorF2(COMPLEX16FrequencySeries **htilde, const REAL8 phi_ref, const REAL8 deltaF, const REAL8 m1_SI, const REAL8 m2_SI, const REAL8 S1z, const REAL8 S2z, const REAL8 fStart, const REAL8 fEnd, const REAL8 f_ref, const REAL8 r, LALDict *LALpars);
 
@@ -1102,6 +1102,68 @@ XLALSimInspiralPNPhasing_F2(
     }
 }
 
+/* Derivatives of the TaylorF2 phasing with respect to the spin-induced
+ * quadrupole parameters dQuadMon1 and dQuadMon2.  These enter
+ * XLALSimInspiralPNPhasing_F2() linearly at 2PN and 3PN, following the same
+ * spin order switch, so the phasing for any dQuadMon is the phasing at a
+ * reference value plus these series times the change in dQuadMon.
+ * Both series include the overall factor pfaN.
+ */
+static void UNUSED
+XLALSimInspiralPNPhasing_F2QuadMon(
+	PNPhasingSeries *dpfa1, /**< derivative with respect to dQuadMon1 (output) */
+	PNPhasingSeries *dpfa2, /**< derivative with respect to dQuadMon2 (output) */
+	const REAL8 m1, /**< Mass of body 1, in Msol */
+	const REAL8 m2, /**< Mass of body 2, in Msol */
+	const REAL8 chi1L, /**< Component of dimensionless spin 1 along Lhat */
+	const REAL8 chi2L, /**< Component of dimensionless spin 2 along Lhat */
+	const REAL8 chi1sq,/**< Magnitude of dimensionless spin 1 */
+	const REAL8 chi2sq, /**< Magnitude of dimensionless spin 2 */
+	LALDict *p /**< LAL dictionary containing accessory parameters */
+	)
+{
+    const REAL8 mtot = m1 + m2;
+    const REAL8 eta = m1*m2/mtot/mtot;
+    const REAL8 m1M = m1/mtot;
+    const REAL8 m2M = m2/mtot;
+
+    const REAL8 pfaN = 3.L/(128.L * eta);
+
+    memset(dpfa1, 0, sizeof(PNPhasingSeries));
+    memset(dpfa2, 0, sizeof(PNPhasingSeries));
+
+    switch( XLALSimInspiralWaveformParamsLookupPNSpinOrder(p) )
+    {
+        case LAL_SIM_INSPIRAL_SPIN_ORDER_ALL:
+        case LAL_SIM_INSPIRAL_SPIN_ORDER_35PN:
+        case LAL_SIM_INSPIRAL_SPIN_ORDER_3PN:
+            dpfa1->v[6] = pfaN*XLALSimInspiralTaylorF2Phasing_6PNQM2SCoeff(m1M)*chi1sq;
+            dpfa2->v[6] = pfaN*XLALSimInspiralTaylorF2Phasing_6PNQM2SCoeff(m2M)*chi2sq;
+#if __GNUC__ >= 7 && !defined __INTEL_COMPILER
+            __attribute__ ((fallthrough));
+#endif
+        case LAL_SIM_INSPIRAL_SPIN_ORDER_25PN:
+        case LAL_SIM_INSPIRAL_SPIN_ORDER_2PN:
+            dpfa1->v[4] = pfaN*(XLALSimInspiralTaylorF2Phasing_4PNQM2SOCoeff(m1M)*chi1L*chi1L
+	      + XLALSimInspiralTaylorF2Phasing_4PNQM2SCoeff(m1M)*chi1sq);
+            dpfa2->v[4] = pfaN*(XLALSimInspiralTaylorF2Phasing_4PNQM2SOCoeff(m2M)*chi2L*chi2L
+	      + XLALSimInspiralTaylorF2Phasing_4PNQM2SCoeff(m2M)*chi2sq);
+#if __GNUC__ >= 7 && !defined __INTEL_COMPILER
+            __attribute__ ((fallthrough));
+#endif
+        case LAL_SIM_INSPIRAL_SPIN_ORDER_15PN:
+        case LAL_SIM_INSPIRAL_SPIN_ORDER_1PN:
+        case LAL_SIM_INSPIRAL_SPIN_ORDER_05PN:
+        case LAL_SIM_INSPIRAL_SPIN_ORDER_0PN:
+            break;
+        default:
+            XLALPrintError("XLAL Error - %s: Invalid spin PN order %i\n",
+			   __func__, XLALSimInspiralWaveformParamsLookupPNSpinOrder(p) );
+            XLAL_ERROR_VOID(XLAL_EINVAL);
+            break;
+    }
+}
+
 /**
  * Computes the PN Coefficients for using in the TaylorT2 phasing equation.
  *
@@ -3712,17 +3712,17 @@ static int XLALSimInspiralSpinTaylorPNEvolveOrbitIrregularIntervals(
 
     /* initialize the integrator */
     if( approx == SpinTaylorT4 )
-        integrator = XLALAdaptiveRungeKutta4Init(LAL_NUM_ST4_VARIABLES,
+        integrator = XLALAdaptiveRungeKutta4ThreadInit(LAL_NUM_ST4_VARIABLES,
                 XLALSimInspiralSpinTaylorT4DerivativesAvg,
                 XLALSimInspiralSpinTaylorStoppingTest,
                 LAL_ST4_ABSOLUTE_TOLERANCE, LAL_ST4_RELATIVE_TOLERANCE);
     else if( approx == SpinTaylorT5 )
-        integrator = XLALAdaptiveRungeKutta4Init(LAL_NUM_ST4_VARIABLES,
+        integrator = XLALAdaptiveRungeKutta4ThreadInit(LAL_NUM_ST4_VARIABLES,
                 XLALSimInspiralSpinTaylorT5DerivativesAvg,
                 XLALSimInspiralSpinTaylorStoppingTest,
                 LAL_ST4_ABSOLUTE_TOLERANCE, LAL_ST4_RELATIVE_TOLERANCE);
     else if( approx == SpinTaylorT1 )
-        integrator = XLALAdaptiveRungeKutta4Init(LAL_NUM_ST4_VARIABLES,
+        integrator = XLALAdaptiveRungeKutta4ThreadInit(LAL_NUM_ST4_VARIABLES,
                 XLALSimInspiralSpinTaylorT1DerivativesAvg,
                 XLALSimInspiralSpinTaylorStoppingTest,
                 LAL_ST4_ABSOLUTE_TOLERANCE, LAL_ST4_RELATIVE_TOLERANCE);
@@ -4417,17 +4417,17 @@ int XLALSimInspiralSpinTaylorPNEvolveOrbit(
 
     /* initialize the integrator */
     if( approx == SpinTaylorT4 )
-      integrator = XLALAdaptiveRungeKutta4Init(LAL_NUM_ST4_VARIABLES,
+      integrator = XLALAdaptiveRungeKutta4ThreadInit(LAL_NUM_ST4_VARIABLES,
 					       XLALSimInspiralSpinTaylorT4DerivativesAvg,
 					       XLALSimInspiralSpinTaylorStoppingTest,
 					       LAL_ST4_ABSOLUTE_TOLERANCE, LAL_ST4_RELATIVE_TOLERANCE);
     else if( approx == SpinTaylorT5 )
-      integrator = XLALAdaptiveRungeKutta4Init(LAL_NUM_ST4_VARIABLES,
+      integrator = XLALAdaptiveRungeKutta4ThreadInit(LAL_NUM_ST4_VARIABLES,
 					       XLALSimInspiralSpinTaylorT5DerivativesAvg,
 					       XLALSimInspiralSpinTaylorStoppingTest,
 					       LAL_ST4_ABSOLUTE_TOLERANCE, LAL_ST4_RELATIVE_TOLERANCE);
     else if( approx == SpinTaylorT1 )
-      integrator = XLALAdaptiveRungeKutta4Init(LAL_NUM_ST4_VARIABLES,
+      integrator = XLALAdaptiveRungeKutta4ThreadInit(LAL_NUM_ST4_VARIABLES,
 					       XLALSimInspiralSpinTaylorT1DerivativesAvg,
 					       XLALSimInspiralSpinTaylorStoppingTest,
 					       LAL_ST4_ABSOLUTE_TOLERANCE, LAL_ST4_RELATIVE_TOLERANCE);
@@ -4763,17 +4763,17 @@ int XLALSimInspiralSpinTaylorPNEvolveOrbitOnlyFinal(
 
     /* initialize the integrator */
     if( approx == SpinTaylorT4 )
-      integrator = XLALAdaptiveRungeKutta4Init(LAL_NUM_ST4_VARIABLES,
+      integrator = XLALAdaptiveRungeKutta4ThreadInit(LAL_NUM_ST4_VARIABLES,
 					       XLALSimInspiralSpinTaylorT4DerivativesAvg,
 					       XLALSimInspiralSpinTaylorStoppingTest,
 					       LAL_ST4_ABSOLUTE_TOLERANCE, LAL_ST4_RELATIVE_TOLERANCE);
     else if( approx == SpinTaylorT5 )
-      integrator = XLALAdaptiveRungeKutta4Init(LAL_NUM_ST4_VARIABLES,
+      integrator = XLALAdaptiveRungeKutta4ThreadInit(LAL_NUM_ST4_VARIABLES,
 					       XLALSimInspiralSpinTaylorT5DerivativesAvg,
 					       XLALSimInspiralSpinTaylorStoppingTest,
 					       LAL_ST4_ABSOLUTE_TOLERANCE, LAL_ST4_RELATIVE_TOLERANCE);
     else if( approx == SpinTaylorT1 )
-      integrator = XLALAdaptiveRungeKutta4Init(LAL_NUM_ST4_VARIABLES,
+      integrator = XLALAdaptiveRungeKutta4ThreadInit(LAL_NUM_ST4_VARIABLES,
 					       XLALSimInspiralSpinTaylorT1DerivativesAvg,
 					       XLALSimInspiralSpinTaylorStoppingTest,
 					       LAL_ST4_ABSOLUTE_TOLERANCE, LAL_ST4_RELATIVE_TOLERANCE);
@@ -41,6 +41,9 @@
 #define omp ignore
 #endif
 
+/* number of frequency bins evaluated together in XLALSimInspiralTaylorF2Core() */
+#define TAYLORF2_BLOCK_LENGTH 64
+
 /**
  * @addtogroup LALSimInspiralTaylorXX_c
  * @{
@@ -142,10 +145,126 @@ int XLALSimInspiralTaylorF2AlignedPhasingArray(
     return XLAL_SUCCESS;
 }
 
+/** \brief Returns structure containing TaylorF2 phasing coefficients for given
+ *  physical parameters, split so that the spin-induced quadrupole parameters
+ *  can be changed cheaply.
+ *
+ *  The reference coefficients are those of XLALSimInspiralTaylorF2AlignedPhasing()
+ *  at the dQuadMon1, dQuadMon2 found in the dictionary.  Coefficients for other
+ *  values are obtained with XLALSimInspiralTaylorF2AlignedPhasingFromQuadMonTerms()
+ *  or, for many pairs at once, XLALSimInspiralTaylorF2AlignedPhasingQuadMonArray().
+ */
+int XLALSimInspiralTaylorF2AlignedPhasingQuadMonTerms(
+        PNPhasingSeriesQuadMonTerms **terms, /**< phasing coefficients and derivatives (output) */
+        const REAL8 m1,         /**< mass of body 1 */
+        const REAL8 m2,         /**< mass of body 2 */
+        const REAL8 chi1,       /**< aligned spin parameter of body 1 */
+        const REAL8 chi2,       /**< aligned spin parameter of body 2 */
+        LALDict *p              /**< LAL dictionary containing accessory parameters */
+        )
+{
+    PNPhasingSeriesQuadMonTerms *t;
 
-int XLALSimInspiralTaylorF2Core(
+    if (!terms) XLAL_ERROR(XLAL_EFAULT);
+    if (*terms) XLAL_ERROR(XLAL_EFAULT);
+
+    t = (PNPhasingSeriesQuadMonTerms *) LALMalloc(sizeof(PNPhasingSeriesQuadMonTerms));
+    if (!t) XLAL_ERROR(XLAL_ENOMEM);
+
+    XLALSimInspiralPNPhasing_F2(&t->ref, m1, m2, chi1, chi2, chi1*chi1, chi2*chi2, chi1*chi2, p);
+    XLALSimInspiralPNPhasing_F2QuadMon(&t->dquadmon1, &t->dquadmon2, m1, m2, chi1, chi2, chi1*chi1, chi2*chi2, p);
+    t->dQuadMon1 = XLALSimInspiralWaveformParamsLookupdQuadMon1(p);
+    t->dQuadMon2 = XLALSimInspiralWaveformParamsLookupdQuadMon2(p);
+
+    *terms = t;
+
+    return XLAL_SUCCESS;
+}
+
+/** \brief Fills a PNPhasingSeries with the TaylorF2 phasing coefficients for
+ *  new values of the spin-induced quadrupole parameters.
+ *
+ *  At the reference values the result is identical to the reference series.
+ */
+int XLALSimInspiralTaylorF2AlignedPhasingFromQuadMonTerms(
+        PNPhasingSeries *pfa,   /**< phasing coefficients (output) */
+        const PNPhasingSeriesQuadMonTerms *terms, /**< from XLALSimInspiralTaylorF2AlignedPhasingQuadMonTerms() */
+        const REAL8 dQuadMon1,  /**< spin-induced quadrupole parameter of body 1 */
+        const REAL8 dQuadMon2   /**< spin-induced quadrupole parameter of body 2 */
+        )
+{
+    if (!pfa || !terms) XLAL_ERROR(XLAL_EFAULT);
+
+    const REAL8 d1 = dQuadMon1 - terms->dQuadMon1;
+    const REAL8 d2 = dQuadMon2 - terms->dQuadMon2;
+
+    *pfa = terms->ref;
+    /* only the non-logarithmic coefficients depend on the quadrupole */
+    for (int ii = 0; ii <= PN_PHASING_SERIES_MAX_ORDER; ii++)
+        pfa->v[ii] += d1*terms->dquadmon1.v[ii] + d2*terms->dquadmon2.v[ii];
+
+    return XLAL_SUCCESS;
+}
+
+/** \brief Evaluates the TaylorF2 phasing coefficients for many pairs of
+ *  spin-induced quadrupole parameters sharing the same masses and spins.
+ *
+ *  The output has the layout of XLALSimInspiralTaylorF2AlignedPhasingArray():
+ *  the v, vlogv and vlogvsq coefficients of each PN order are stored
+ *  contiguously over the pairs.
+ */
+int XLALSimInspiralTaylorF2AlignedPhasingQuadMonArray(
+        REAL8Vector **phasingvals, /**< phasing coefficients (output) */
+        const PNPhasingSeriesQuadMonTerms *terms, /**< from XLALSimInspiralTaylorF2AlignedPhasingQuadMonTerms() */
+        REAL8Vector dquadmon1, /**< Self-spin deformation of body 1 */
+        REAL8Vector dquadmon2  /**< Self-spin deformation of body 2 */
+        )
+{
+    UINT4 idx, jdx;
+    const UINT4 pnmaxnum = PN_PHASING_SERIES_MAX_ORDER + 1;
+    const UINT4 n = dquadmon1.length;
+
+    if (!phasingvals || !terms) XLAL_ERROR(XLAL_EFAULT);
+    if (*phasingvals) XLAL_ERROR(XLAL_EFAULT);
+    XLAL_CHECK(dquadmon2.length == n, XLAL_EBADLEN, "dquadmon1 and dquadmon2 differ in length");
+
+    *phasingvals = XLALCreateREAL8Vector(n * pnmaxnum * 3);
+    if (!*phasingvals) XLAL_ERROR(XLAL_EFUNC);
+    REAL8 *pv = (*phasingvals)->data;
+
+    for (jdx=0; jdx < pnmaxnum; jdx++)
+    {
+        const REAL8 v0 = terms->ref.v[jdx];
+        const REAL8 a1 = terms->dquadmon1.v[jdx];
+        const REAL8 a2 = terms->dquadmon2.v[jdx];
+        REAL8 *v = pv + jdx*n;
+        REAL8 *vlogv = pv + n*pnmaxnum + jdx*n;
+        REAL8 *vlogvsq = pv + n*pnmaxnum*2 + jdx*n;
+
+        if (a1 == 0. && a2 == 0.)
+            for (idx=0; idx < n; idx++)
+                v[idx] = v0;
+        else
+            for (idx=0; idx < n; idx++)
+                v[idx] = v0 + ((dquadmon1.data[idx] - terms->dQuadMon1)*a1
+                    + (dquadmon2.data[idx] - terms->dQuadMon2)*a2);
+        for (idx=0; idx < n; idx++)
+        {
+            vlogv[idx] = terms->ref.vlogv[jdx];
+            vlogvsq[idx] = terms->ref.vlogvsq[jdx];
+        }
+    }
+
+    return XLAL_SUCCESS;
+}
+
+
+/* If grid is not NULL, the cached powers and logarithms of freqs are used
+ * instead of computing them here. */
+static int TaylorF2Core(
         COMPLEX16FrequencySeries **htilde_out, /**< FD waveform */
 	const REAL8Sequence *freqs,            /**< frequency points at which to evaluate the waveform (Hz) */
+        const LALSimInspiralFrequencyGrid *grid, /**< cached quantities for freqs, or NULL */
         const REAL8 phi_ref,                   /**< reference orbital phase (rad) */
         const REAL8 m1_SI,                     /**< mass of companion 1 (kg) */
         const REAL8 m2_SI,                     /**< mass of companion 2 (kg) */
@@ -382,108 +501,197 @@ int XLALSimInspiralTaylorF2Core(
         ref_phasing /= v5ref;
     } /* End of if(f_ref != 0) block */
 
-    #pragma omp parallel for
-    for (i = 0; i < freqs->length; i++) {
-        const REAL8 f = freqs->data[i];
-        const REAL8 v = cbrt(piM*f);
-        const REAL8 logv = log(v);
-        const REAL8 v2 = v * v;
-        const REAL8 v3 = v * v2;
-        const REAL8 v4 = v * v3;
-        const REAL8 v5 = v * v4;
-        const REAL8 v6 = v * v5;
-        const REAL8 v7 = v * v6;
-        const REAL8 v8 = v * v7;
-        const REAL8 v9 = v * v8;
-        const REAL8 v10 = v * v9;
-        const REAL8 v12 = v2 * v10;
-        const REAL8 v13 = v * v12;
-        const REAL8 v14 = v * v13;
-        const REAL8 v15 = v * v14;
-        REAL8 phasing = 0.;
-        REAL8 dEnergy = 0.;
-        REAL8 flux = 0.;
-        REAL8 amp;
-
-        phasing += pfa7 * v7;
-        phasing += (pfa6 + pfl6 * logv) * v6;
-        phasing += (pfa5 + pfl5 * logv) * v5;
-        phasing += pfa4 * v4;
-        phasing += pfa3 * v3;
-        phasing += pfa2 * v2;
-        phasing += pfa1 * v;
-        phasing += pfaN;
-
-        /* Tidal terms in phasing */
-        phasing += pft15 * v15;
-        phasing += pft14 * v14;
-        phasing += pft13 * v13;
-        phasing += pft12 * v12;
-        phasing += pft10 * v10;
-
-    /* WARNING! Amplitude orders beyond 0 have NOT been reviewed!
-     * Use at your own risk. The default is to turn them off.
-     * These do not currently include spin corrections.
-     * Note that these are not higher PN corrections to the amplitude.
-     * They are the corrections to the leading-order amplitude arising
-     * from the stationary phase approximation. See for instance
-     * Eq 6.9 of arXiv:0810.5336
+    /* Select the SPA amplitude corrections once, outside the frequency loop.
+     * Disabled orders have zero coefficients, which leaves the sums
+     * unchanged, so the loop below is straight-line arithmetic.
      */
-	switch (amplitudeO)
-        {
-            case 7:
-                flux += FTa7 * v7;
-#if __GNUC__ >= 7 && !defined __INTEL_COMPILER
-                __attribute__ ((fallthrough));
-#endif
-            case 6:
-                flux += (FTa6 + FTl6*logv) * v6;
-                dEnergy += dETa3 * v6;
+    REAL8 FTa2c = 0., FTa3c = 0., FTa4c = 0., FTa5c = 0.;
+    REAL8 FTa6c = 0., FTl6c = 0., FTa7c = 0.;
+    REAL8 dETa1c = 0., dETa2c = 0., dETa3c = 0.;
+    switch (amplitudeO)
+    {
+        case 7:
+            FTa7c = FTa7;
 #if __GNUC__ >= 7 && !defined __INTEL_COMPILER
-                __attribute__ ((fallthrough));
+            __attribute__ ((fallthrough));
 #endif
-            case 5:
-                flux += FTa5 * v5;
+        case 6:
+            FTa6c = FTa6;
+            FTl6c = FTl6;
+            dETa3c = dETa3;
 #if __GNUC__ >= 7 && !defined __INTEL_COMPILER
-                __attribute__ ((fallthrough));
+            __attribute__ ((fallthrough));
 #endif
-            case 4:
-                flux += FTa4 * v4;
-                dEnergy += dETa2 * v4;
+        case 5:
+            FTa5c = FTa5;
 #if __GNUC__ >= 7 && !defined __INTEL_COMPILER
-                __attribute__ ((fallthrough));
+            __attribute__ ((fallthrough));
 #endif
-            case 3:
-                flux += FTa3 * v3;
+        case 4:
+            FTa4c = FTa4;
+            dETa2c = dETa2;
 #if __GNUC__ >= 7 && !defined __INTEL_COMPILER
-                __attribute__ ((fallthrough));
+            __attribute__ ((fallthrough));
 #endif
-            case 2:
-                flux += FTa2 * v2;
-                dEnergy += dETa1 * v2;
+        case 3:
+            FTa3c = FTa3;
 #if __GNUC__ >= 7 && !defined __INTEL_COMPILER
-                __attribute__ ((fallthrough));
+            __attribute__ ((fallthrough));
 #endif
-            case -1: /* Default to no SPA amplitude corrections */
-            case 0:
-                flux += 1.;
-                dEnergy += 1.;
+        case 2:
+            FTa2c = FTa2;
+            dETa1c = dETa1;
+            break;
+        default: /* Default to no SPA amplitude corrections */
+            break;
+    }
+
+    /* The frequencies are processed in blocks: the libm calls are made in
+     * one pass, and the phase and amplitude polynomials in a second pass
+     * over contiguous buffers, which the compiler can vectorise.
+     */
+    const size_t nfreqs = freqs->length;
+    const REAL8 piM_third = cbrt(piM);
+    const REAL8 logpiM = log(piM);
+    #pragma omp parallel for
+    for (i = 0; i < nfreqs; i += TAYLORF2_BLOCK_LENGTH) {
+        const size_t nblock = nfreqs - i < TAYLORF2_BLOCK_LENGTH ? nfreqs - i : TAYLORF2_BLOCK_LENGTH;
+        const REAL8 *f = freqs->data + i;
+        REAL8 vblock[TAYLORF2_BLOCK_LENGTH];
+        REAL8 logvblock[TAYLORF2_BLOCK_LENGTH];
+        REAL8 phaseblock[TAYLORF2_BLOCK_LENGTH];
+        REAL8 ampblock[TAYLORF2_BLOCK_LENGTH];
+        size_t k;
+
+        if (grid) {
+            const REAL8 *third = grid->third->data + i;
+            const REAL8 *logf = grid->logf->data + i;
+            for (k = 0; k < nblock; k++) {
+                vblock[k] = piM_third * third[k];
+                logvblock[k] = (logpiM + logf[k]) / 3.;
+            }
+        }
+        else {
+            for (k = 0; k < nblock; k++) {
+                vblock[k] = cbrt(piM*f[k]);
+                logvblock[k] = log(vblock[k]);
+            }
         }
 
-        phasing /= v5;
-        flux *= FTaN * v10;
-        dEnergy *= dETaN * v;
-        // Note the factor of 2 b/c phi_ref is orbital phase
-        phasing += shft * f - 2.*phi_ref - ref_phasing;
-        amp = amp0 * sqrt(-dEnergy/flux) * v;
-        data[i+iStart] = amp * cos(phasing - LAL_PI_4)
-                - amp * sin(phasing - LAL_PI_4) * 1.0j;
+        for (k = 0; k < nblock; k++) {
+            const REAL8 v = vblock[k];
+            const REAL8 logv = logvblock[k];
+            const REAL8 v2 = v * v;
+            const REAL8 v3 = v * v2;
+            const REAL8 v4 = v * v3;
+            const REAL8 v5 = v * v4;
+            const REAL8 v6 = v * v5;
+            const REAL8 v7 = v * v6;
+            const REAL8 v8 = v * v7;
+            const REAL8 v9 = v * v8;
+            const REAL8 v10 = v * v9;
+            const REAL8 v12 = v2 * v10;
+            const REAL8 v13 = v * v12;
+            const REAL8 v14 = v * v13;
+            const REAL8 v15 = v * v14;
+            REAL8 phasing = 0.;
+            REAL8 dEnergy = 0.;
+            REAL8 flux = 0.;
+
+            phasing += pfa7 * v7;
+            phasing += (pfa6 + pfl6 * logv) * v6;
+            phasing += (pfa5 + pfl5 * logv) * v5;
+            phasing += pfa4 * v4;
+            phasing += pfa3 * v3;
+            phasing += pfa2 * v2;
+            phasing += pfa1 * v;
+            phasing += pfaN;
+
+            /* Tidal terms in phasing */
+            phasing += pft15 * v15;
+            phasing += pft14 * v14;
+            phasing += pft13 * v13;
+            phasing += pft12 * v12;
+            phasing += pft10 * v10;
+
+            /* WARNING! Amplitude orders beyond 0 have NOT been reviewed!
+             * Use at your own risk. The default is to turn them off.
+             * These do not currently include spin corrections.
+             * Note that these are not higher PN corrections to the amplitude.
+             * They are the corrections to the leading-order amplitude arising
+             * from the stationary phase approximation. See for instance
+             * Eq 6.9 of arXiv:0810.5336
+             */
+            flux += FTa7c * v7;
+            flux += (FTa6c + FTl6c*logv) * v6;
+            dEnergy += dETa3c * v6;
+            flux += FTa5c * v5;
+            flux += FTa4c * v4;
+            dEnergy += dETa2c * v4;
+            flux += FTa3c * v3;
+            flux += FTa2c * v2;
+            dEnergy += dETa1c * v2;
+            flux += 1.;
+            dEnergy += 1.;
+
+            phasing /= v5;
+            flux *= FTaN * v10;
+            dEnergy *= dETaN * v;
+            // Note the factor of 2 b/c phi_ref is orbital phase
+            phasing += shft * f[k] - 2.*phi_ref - ref_phasing;
+            phaseblock[k] = phasing - LAL_PI_4;
+            ampblock[k] = amp0 * sqrt(-dEnergy/flux) * v;
+        }
+
+        for (k = 0; k < nblock; k++)
+            data[i+k+iStart] = ampblock[k] * cos(phaseblock[k])
+                - ampblock[k] * sin(phaseblock[k]) * 1.0j;
     }
 
     *htilde_out = htilde;
     return XLAL_SUCCESS;
 }
 
+int XLALSimInspiralTaylorF2Core(
+        COMPLEX16FrequencySeries **htilde_out, /**< FD waveform */
+	const REAL8Sequence *freqs,            /**< frequency points at which to evaluate the waveform (Hz) */
+        const REAL8 phi_ref,                   /**< reference orbital phase (rad) */
+        const REAL8 m1_SI,                     /**< mass of companion 1 (kg) */
+        const REAL8 m2_SI,                     /**< mass of companion 2 (kg) */
+        const REAL8 f_ref,                     /**< Reference GW frequency (Hz) - if 0 reference point is coalescence */
+	const REAL8 shft,		       /**< time shift to be applied to frequency-domain phase (sec)*/
+        const REAL8 r,                         /**< distance of source (m) */
+        LALDict *p, /**< Linked list containing the extra testing GR parameters >*/
+        PNPhasingSeries *pfaP /**< Phasing coefficients >**/
+        )
+{
+    return TaylorF2Core(htilde_out, freqs, NULL, phi_ref, m1_SI, m2_SI, f_ref, shft, r, p, pfaP);
+}
+
+/**
+ * As XLALSimInspiralTaylorF2Core(), but evaluated on a frequency grid
+ * created with XLALCreateSimInspiralFrequencyGrid().  The cached powers and
+ * logarithms of the frequencies replace the per-bin cbrt() and log() calls,
+ * which makes repeated calls on the same grid cheaper.  The result agrees
+ * with XLALSimInspiralTaylorF2Core() up to rounding.
+ */
+int XLALSimInspiralTaylorF2CoreFrequencyGrid(
+        COMPLEX16FrequencySeries **htilde_out, /**< FD waveform */
+        const LALSimInspiralFrequencyGrid *grid, /**< frequency grid at which to evaluate the waveform */
+        const REAL8 phi_ref,                   /**< reference orbital phase (rad) */
+        const REAL8 m1_SI,                     /**< mass of companion 1 (kg) */
+        const REAL8 m2_SI,                     /**< mass of companion 2 (kg) */
+        const REAL8 f_ref,                     /**< Reference GW frequency (Hz) - if 0 reference point is coalescence */
+        const REAL8 shft,                      /**< time shift to be applied to frequency-domain phase (sec)*/
+        const REAL8 r,                         /**< distance of source (m) */
+        LALDict *p, /**< Linked list containing the extra testing GR parameters >*/
+        PNPhasingSeries *pfaP /**< Phasing coefficients >**/
+        )
+{
+    if (!grid) XLAL_ERROR(XLAL_EFAULT);
+    return TaylorF2Core(htilde_out, grid->freqs, grid, phi_ref, m1_SI, m2_SI, f_ref, shft, r, p, pfaP);
+}
+
 /**
  * Computes the stationary phase approximation to the Fourier transform of
  * a chirp waveform. The amplitude is given by expanding \f$1/\sqrt{\dot{F}}\f$.
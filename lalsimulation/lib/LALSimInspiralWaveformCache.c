@@ -29,6 +29,8 @@
 #include "check_waveform_macros.h"
 #include "LALSimInspiralPNCoefficients.c"
 
+static int ChooseFDWaveformSequence(COMPLEX16FrequencySeries **hptilde, COMPLEX16FrequencySeries **hctilde, REAL8 phiRef, REAL8 m1, REAL8 m2, REAL8 S1x, REAL8 S1y, REAL8 S1z, REAL8 S2x, REAL8 S2y, REAL8 S2z, REAL8 f_ref, REAL8 distance, REAL8 inclination, LALDict *LALpars, Approximant approximant, REAL8Sequence *frequencies, const LALSimInspiralFrequencyGrid *grid);
+
 /**
  * Bitmask enumerating which parameters have changed, to determine
  * if the requested waveform can be transformed from a cached waveform
@@ -898,6 +900,119 @@ int XLALSimInspiralChooseFDWaveformSequence(
     Approximant approximant,                /**< post-Newtonian approximant to use for waveform production */
     REAL8Sequence *frequencies              /**< sequence of frequencies for which the waveform will be computed. Pass in NULL (or None in python) for standard f_min to f_max sequence. */
 )
+{
+    return ChooseFDWaveformSequence(hptilde, hctilde, phiRef, m1, m2, S1x, S1y, S1z, S2x, S2y, S2z, f_ref, distance, inclination, LALpars, approximant, frequencies, NULL);
+}
+
+/**
+ * Creates a frequency grid for XLALSimInspiralChooseFDWaveformFrequencyGrid().
+ * The frequencies are copied and their powers and logarithms computed once,
+ * so that repeated waveform calls on the same grid, as made by reduced order
+ * quadrature or relative binning likelihoods, do not recompute them.
+ */
+LALSimInspiralFrequencyGrid *XLALCreateSimInspiralFrequencyGrid(
+    const REAL8Sequence *frequencies        /**< frequencies of the grid (Hz); must be positive */
+)
+{
+    LALSimInspiralFrequencyGrid *grid;
+    UINT4 j;
+
+    XLAL_CHECK_NULL(frequencies && frequencies->length > 0, XLAL_EFAULT);
+    for (j = 0; j < frequencies->length; j++)
+        XLAL_CHECK_NULL(frequencies->data[j] > 0, XLAL_EDOM, "Frequencies must be positive");
+
+    grid = XLALCalloc(1, sizeof(*grid));
+    XLAL_CHECK_NULL(grid, XLAL_ENOMEM);
+    grid->freqs = XLALCreateREAL8Sequence(frequencies->length);
+    grid->sixth = XLALCreateREAL8Sequence(frequencies->length);
+    grid->third = XLALCreateREAL8Sequence(frequencies->length);
+    grid->logf = XLALCreateREAL8Sequence(frequencies->length);
+    if (!grid->freqs || !grid->sixth || !grid->third || !grid->logf) {
+        XLALDestroySimInspiralFrequencyGrid(grid);
+        XLAL_ERROR_NULL(XLAL_EFUNC);
+    }
+
+    for (j = 0; j < frequencies->length; j++) {
+        const REAL8 f = frequencies->data[j];
+        grid->freqs->data[j] = f;
+        grid->sixth->data[j] = pow(f, 1.0 / 6.0);
+        grid->third->data[j] = cbrt(f);
+        grid->logf->data[j] = log(f);
+    }
+
+    return grid;
+}
+
+/**
+ * Destroys a frequency grid created with XLALCreateSimInspiralFrequencyGrid().
+ */
+void XLALDestroySimInspiralFrequencyGrid(
+    LALSimInspiralFrequencyGrid *grid       /**< grid to destroy */
+)
+{
+    if (grid) {
+        XLALDestroyREAL8Sequence(grid->freqs);
+        XLALDestroyREAL8Sequence(grid->sixth);
+        XLALDestroyREAL8Sequence(grid->third);
+        XLALDestroyREAL8Sequence(grid->logf);
+        XLALFree(grid);
+    }
+}
+
+/**
+ * As XLALSimInspiralChooseFDWaveformSequence(), but evaluated on a frequency
+ * grid created with XLALCreateSimInspiralFrequencyGrid().  TaylorF2,
+ * IMRPhenomD and the IMRPhenomXAS family use the quantities cached in the
+ * grid; other approximants are generated at the grid frequencies as by
+ * XLALSimInspiralChooseFDWaveformSequence().
+ */
+int XLALSimInspiralChooseFDWaveformFrequencyGrid(
+    COMPLEX16FrequencySeries **hptilde,     /**< FD plus polarization */
+    COMPLEX16FrequencySeries **hctilde,     /**< FD cross polarization */
+    REAL8 phiRef,                           /**< reference orbital phase (rad) */
+    REAL8 m1,                               /**< mass of companion 1 (kg) */
+    REAL8 m2,                               /**< mass of companion 2 (kg) */
+    REAL8 S1x,                              /**< x-component of the dimensionless spin of object 1 */
+    REAL8 S1y,                              /**< y-component of the dimensionless spin of object 1 */
+    REAL8 S1z,                              /**< z-component of the dimensionless spin of object 1 */
+    REAL8 S2x,                              /**< x-component of the dimensionless spin of object 2 */
+    REAL8 S2y,                              /**< y-component of the dimensionless spin of object 2 */
+    REAL8 S2z,                              /**< z-component of the dimensionless spin of object 2 */
+    REAL8 f_ref,                            /**< Reference frequency (Hz) */
+    REAL8 distance,                         /**< distance of source (m) */
+    REAL8 inclination,                      /**< inclination of source (rad) */
+    LALDict *LALpars,                       /**< LALDictionary containing non-mandatory variables/flags */
+    Approximant approximant,                /**< post-Newtonian approximant to use for waveform production */
+    const LALSimInspiralFrequencyGrid *grid /**< frequency grid for which the waveform will be computed */
+)
+{
+    if (!grid) XLAL_ERROR(XLAL_EFAULT);
+    return ChooseFDWaveformSequence(hptilde, hctilde, phiRef, m1, m2, S1x, S1y, S1z, S2x, S2y, S2z, f_ref, distance, inclination, LALpars, approximant, grid->freqs, grid);
+}
+
+/* Implementation of XLALSimInspiralChooseFDWaveformSequence(); if grid is
+ * not NULL, frequencies is grid->freqs and the models that support it use
+ * the cached quantities in grid. */
+static int ChooseFDWaveformSequence(
+    COMPLEX16FrequencySeries **hptilde,     /**< FD plus polarization */
+    COMPLEX16FrequencySeries **hctilde,     /**< FD cross polarization */
+    REAL8 phiRef,                           /**< reference orbital phase (rad) */
+    REAL8 m1,                               /**< mass of companion 1 (kg) */
+    REAL8 m2,                               /**< mass of companion 2 (kg) */
+    REAL8 S1x,                              /**< x-component of the dimensionless spin of object 1 */
+    REAL8 S1y,                              /**< y-component of the dimensionless spin of object 1 */
+    REAL8 S1z,                              /**< z-component of the dimensionless spin of object 1 */
+    REAL8 S2x,                              /**< x-component of the dimensionless spin of object 2 */
+    REAL8 S2y,                              /**< y-component of the dimensionless spin of object 2 */
+    REAL8 S2z,                              /**< z-component of the dimensionless spin of object 2 */
+    REAL8 f_ref,                            /**< Reference frequency (Hz) */
+    REAL8 distance,                         /**< distance of source (m) */
+    REAL8 inclination,                      /**< inclination of source (rad) */
+    LALDict *LALpars,                       /**< LALDictionary containing non-mandatory variables/flags */
+    Approximant approximant,                /**< post-Newtonian approximant to use for waveform production */
+    REAL8Sequence *frequencies,             /**< sequence of frequencies for which the waveform will be computed */
+    const LALSimInspiralFrequencyGrid *grid /**< cached quantities for frequencies, or NULL */
+)
 {
     int ret;
     unsigned int j;
@@ -973,8 +1088,12 @@ int XLALSimInspiralChooseFDWaveformSequence(
             XLALSimInspiralPNPhasing_F2(&pfa, m1/LAL_MSUN_SI, m2/LAL_MSUN_SI,
                                         S1z, S2z, S1z*S1z, S2z*S2z,
                                         S1z*S2z, LALpars);
-            ret = XLALSimInspiralTaylorF2Core(hptilde, frequencies, phiRef,
-                    m1, m2, f_ref, 0., distance, LALpars, &pfa);
+            if (grid)
+                ret = XLALSimInspiralTaylorF2CoreFrequencyGrid(hptilde, grid, phiRef,
+                        m1, m2, f_ref, 0., distance, LALpars, &pfa);
+            else
+                ret = XLALSimInspiralTaylorF2Core(hptilde, frequencies, phiRef,
+                        m1, m2, f_ref, 0., distance, LALpars, &pfa);
             if (ret == XLAL_FAILURE) XLAL_ERROR(XLAL_EFUNC);
             /* Produce both polarizations */
             *hctilde = XLALCreateCOMPLEX16FrequencySeries("FD hcross",
@@ -1278,8 +1397,12 @@ int XLALSimInspiralChooseFDWaveformSequence(
             if( !checkTidesZero(lambda1, lambda2) )
 	        XLAL_ERROR(XLAL_EINVAL, "Non-zero tidal parameters were given, but this is approximant doe not have tidal corrections.");
 
-            ret = XLALSimIMRPhenomDFrequencySequence(hptilde, frequencies,
-                phiRef, f_ref, m1, m2, S1z, S2z, distance, LALpars, NoNRT_V);
+            if (grid)
+                ret = XLALSimIMRPhenomDFrequencyGrid(hptilde, grid,
+                    phiRef, f_ref, m1, m2, S1z, S2z, distance, LALpars, NoNRT_V);
+            else
+                ret = XLALSimIMRPhenomDFrequencySequence(hptilde, frequencies,
+                    phiRef, f_ref, m1, m2, S1z, S2z, distance, LALpars, NoNRT_V);
             if (ret == XLAL_FAILURE) XLAL_ERROR(XLAL_EFUNC);
             /* Produce both polarizations */
             *hctilde = XLALCreateCOMPLEX16FrequencySeries("FD hcross",
@@ -1418,8 +1541,12 @@ int XLALSimInspiralChooseFDWaveformSequence(
               COMPLEX16 Ylmfactor = 2.0*sqrt(5.0 / (64.0 * LAL_PI)) * cexp(-I*2*(LAL_PI/2 ));
               /* The factor for hc is the same but opposite sign */
 
-              ret = XLALSimIMRPhenomXASFrequencySequence(hptilde, frequencies,
-                m1, m2, S1z, S2z, distance, phiRef, f_ref, LALpars);
+              if (grid)
+                ret = XLALSimIMRPhenomXASFrequencyGrid(hptilde, grid,
+                  m1, m2, S1z, S2z, distance, phiRef, f_ref, LALpars);
+              else
+                ret = XLALSimIMRPhenomXASFrequencySequence(hptilde, frequencies,
+                  m1, m2, S1z, S2z, distance, phiRef, f_ref, LALpars);
                 if (ret == XLAL_FAILURE) XLAL_ERROR(XLAL_EFUNC);
 
                 /* Produce both polarizations */
@@ -1454,8 +1581,12 @@ int XLALSimInspiralChooseFDWaveformSequence(
             COMPLEX16 Ylmfactor = 2.0*sqrt(5.0 / (64.0 * LAL_PI)) * cexp(-I*2*(LAL_PI/2 ));
             /* The factor for hc is the same but opposite sign */
 
-            ret = XLALSimIMRPhenomXASFrequencySequence(hptilde, frequencies,
-              m1, m2, S1z, S2z, distance, phiRef, f_ref, LALpars);
+            if (grid)
+              ret = XLALSimIMRPhenomXASFrequencyGrid(hptilde, grid,
+                m1, m2, S1z, S2z, distance, phiRef, f_ref, LALpars);
+            else
+              ret = XLALSimIMRPhenomXASFrequencySequence(hptilde, frequencies,
+                m1, m2, S1z, S2z, distance, phiRef, f_ref, LALpars);
               if (ret == XLAL_FAILURE) XLAL_ERROR(XLAL_EFUNC);
             
             if(LALpars)
@@ -1494,8 +1625,12 @@ int XLALSimInspiralChooseFDWaveformSequence(
             COMPLEX16 Ylmfactor = 2.0*sqrt(5.0 / (64.0 * LAL_PI)) * cexp(-I*2*(LAL_PI/2 ));
             /* The factor for hc is the same but opposite sign */
 
-            ret = XLALSimIMRPhenomXASFrequencySequence(hptilde, frequencies,
-              m1, m2, S1z, S2z, distance, phiRef, f_ref, LALpars);
+            if (grid)
+              ret = XLALSimIMRPhenomXASFrequencyGrid(hptilde, grid,
+                m1, m2, S1z, S2z, distance, phiRef, f_ref, LALpars);
+            else
+              ret = XLALSimIMRPhenomXASFrequencySequence(hptilde, frequencies,
+                m1, m2, S1z, S2z, distance, phiRef, f_ref, LALpars);
               if (ret == XLAL_FAILURE) XLAL_ERROR(XLAL_EFUNC);
             
             if(LALpars)
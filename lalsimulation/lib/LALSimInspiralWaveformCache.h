@@ -111,6 +111,12 @@ int XLALSimInspiralChooseFDWaveformFromCache(COMPLEX16FrequencySeries **hptilde,
 
 int XLALSimInspiralChooseFDWaveformSequence(COMPLEX16FrequencySeries **hptilde, COMPLEX16FrequencySeries **hctilde, REAL8 phiRef, REAL8 m1, REAL8 m2, REAL8 S1x, REAL8 S1y, REAL8 S1z, REAL8 S2x, REAL8 S2y, REAL8 S2z, REAL8 f_ref, REAL8 r, REAL8 i, LALDict *LALpars, Approximant approximant, REAL8Sequence *frequencies);
 
+LALSimInspiralFrequencyGrid *XLALCreateSimInspiralFrequencyGrid(const REAL8Sequence *frequencies);
+
+void XLALDestroySimInspiralFrequencyGrid(LALSimInspiralFrequencyGrid *grid);
+
+int XLALSimInspiralChooseFDWaveformFrequencyGrid(COMPLEX16FrequencySeries **hptilde, COMPLEX16FrequencySeries **hctilde, REAL8 phiRef, REAL8 m1, REAL8 m2, REAL8 S1x, REAL8 S1y, REAL8 S1z, REAL8 S2x, REAL8 S2y, REAL8 S2z, REAL8 f_ref, REAL8 r, REAL8 i, LALDict *LALpars, Approximant approximant, const LALSimInspiralFrequencyGrid *grid);
+
 #if 0
 { /* so that editors will match succeeding brace */
 #elif defined(__cplusplus)
@@ -61,6 +61,9 @@ extern const char * const lalSimNeutronStarEOSNames[111];
 /** Incomplete type for a neutron star family having a particular EOS. */
 typedef struct tagLALSimNeutronStarFamily LALSimNeutronStarFamily;
 
+/** Incomplete type for a cache of neutron star families keyed by EOS parameters. */
+typedef struct tagLALSimNeutronStarFamilyCache LALSimNeutronStarFamilyCache;
+
 void XLALDestroySimNeutronStarEOS(LALSimNeutronStarEOS * eos);
 char *XLALSimNeutronStarEOSName(LALSimNeutronStarEOS * eos);
 
@@ -124,6 +127,13 @@ double XLALSimNeutronStarEOSEnergyDensityDerivOfPressureGeometerized(double p,
     LALSimNeutronStarEOS * eos);
 double XLALSimNeutronStarEOSSpeedOfSoundGeometerized(double h,
     LALSimNeutronStarEOS * eos);
+#ifndef SWIG /* exclude from SWIG interface */
+int XLALSimNeutronStarEOSStateOfPseudoEnthalpyGeometerized(double *p,
+    double *e, double *rho, const double *h, size_t n,
+    LALSimNeutronStarEOS * eos);
+int XLALSimNeutronStarEOSStateOfPressureGeometerized(double *e, double *h,
+    double *dedp, const double *p, size_t n, LALSimNeutronStarEOS * eos);
+#endif
 
 /* TOV ROUTINES */
 
@@ -150,6 +160,8 @@ int XLALSimNeutronStarVirialODEIntegrateWithTolerance(double *radius, double *ma
 void XLALDestroySimNeutronStarFamily(LALSimNeutronStarFamily * fam);
 LALSimNeutronStarFamily * XLALCreateSimNeutronStarFamily(
     LALSimNeutronStarEOS * eos);
+LALSimNeutronStarFamily * XLALCreateSimNeutronStarFamilyAdaptive(
+    LALSimNeutronStarEOS * eos, double tolerance);
 
 double XLALSimNeutronStarFamMinimumMass(LALSimNeutronStarFamily * fam);
 double XLALSimNeutronStarMaximumMass(LALSimNeutronStarFamily * fam);
@@ -157,6 +169,21 @@ double XLALSimNeutronStarCentralPressure(double m,
     LALSimNeutronStarFamily * fam);
 double XLALSimNeutronStarRadius(double m, LALSimNeutronStarFamily * fam);
 double XLALSimNeutronStarLoveNumberK2(double m, LALSimNeutronStarFamily * fam);
+double XLALSimNeutronStarTidalDeformability(double m,
+    LALSimNeutronStarFamily * fam);
+
+void XLALDestroySimNeutronStarFamilyCache(LALSimNeutronStarFamilyCache *
+    cache);
+LALSimNeutronStarFamilyCache * XLALCreateSimNeutronStarFamilyCache(
+    size_t size, double tolerance);
+#ifndef SWIG /* exclude from SWIG interface */
+LALSimNeutronStarFamily * XLALSimNeutronStarFamilyCacheLookup(
+    LALSimNeutronStarEOS ** eos, LALSimNeutronStarFamilyCache * cache,
+    const double *key, size_t nkey);
+int XLALSimNeutronStarFamilyCacheInsert(LALSimNeutronStarFamilyCache * cache,
+    const double *key, size_t nkey, LALSimNeutronStarEOS * eos,
+    LALSimNeutronStarFamily * fam);
+#endif
 
 #endif /* _LALSIMNEUTRONSTAR_H */
 
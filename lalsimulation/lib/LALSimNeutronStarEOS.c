@@ -72,6 +72,11 @@ struct tagLALSimNeutronStarEOS {
     double (*p_of_rho) (double rho, LALSimNeutronStarEOS * myself);
     double (*dedp_of_p) (double p, LALSimNeutronStarEOS * myself);
     double (*v_of_h) (double h, LALSimNeutronStarEOS * myself);
+    /* optional batched evaluations; NULL if not provided */
+    int (*state_of_h) (double *p, double *e, double *rho, const double *h,
+        size_t n, LALSimNeutronStarEOS * myself);
+    int (*state_of_p) (double *e, double *h, double *dedp, const double *p,
+        size_t n, LALSimNeutronStarEOS * myself);
     void (*free) (LALSimNeutronStarEOS * myself);
     int datatype;
     LALSimNeutronStarEOSData data;
@@ -318,6 +323,83 @@ double XLALSimNeutronStarEOSSpeedOfSoundGeometerized(double h,
     return v;
 }
 
+/**
+ * @brief Evaluates the pressure, energy density and rest mass density in
+ * geometerized units (m^-2) at an array of values of the dimensionless
+ * pseudo-enthalpy.
+ * @details Any of @a p, @a e and @a rho may be NULL if that quantity is not
+ * required.  For tabulated equations of state the table interval containing
+ * each pseudo-enthalpy is found once and shared between the requested
+ * quantities, so this is cheaper than calling the scalar routines in turn.
+ * @param[out] p Array of @a n pressures in geometerized units (m^-2), or NULL.
+ * @param[out] e Array of @a n energy densities in geometerized units (m^-2),
+ * or NULL.
+ * @param[out] rho Array of @a n rest mass densities in geometerized units
+ * (m^-2), or NULL.
+ * @param[in] h Array of @a n values of the dimensionless pseudo-enthalpy.
+ * @param[in] n Number of points.
+ * @param eos Pointer to the EOS structure.
+ * @retval 0 Success.
+ * @retval <0 Failure.
+ */
+int XLALSimNeutronStarEOSStateOfPseudoEnthalpyGeometerized(double *p,
+    double *e, double *rho, const double *h, size_t n,
+    LALSimNeutronStarEOS * eos)
+{
+    size_t j;
+    XLAL_CHECK(eos && h, XLAL_EFAULT);
+    if (eos->state_of_h) {
+        XLAL_CHECK(eos->state_of_h(p, e, rho, h, n, eos) == 0, XLAL_EFUNC);
+        return 0;
+    }
+    for (j = 0; j < n; ++j) {
+        if (p)
+            p[j] = eos->p_of_h(h[j], eos);
+        if (e)
+            e[j] = eos->e_of_h(h[j], eos);
+        if (rho)
+            rho[j] = eos->rho_of_h(h[j], eos);
+    }
+    return 0;
+}
+
+/**
+ * @brief Evaluates the energy density in geometerized units (m^-2), the
+ * dimensionless pseudo-enthalpy and the gradient of the energy density with
+ * respect to the pressure at an array of pressures in geometerized units
+ * (m^-2).
+ * @details Any of @a e, @a h and @a dedp may be NULL if that quantity is not
+ * required.  See XLALSimNeutronStarEOSStateOfPseudoEnthalpyGeometerized().
+ * @param[out] e Array of @a n energy densities in geometerized units (m^-2),
+ * or NULL.
+ * @param[out] h Array of @a n values of the pseudo-enthalpy, or NULL.
+ * @param[out] dedp Array of @a n energy density gradients, or NULL.
+ * @param[in] p Array of @a n pressures in geometerized units (m^-2).
+ * @param[in] n Number of points.
+ * @param eos Pointer to the EOS structure.
+ * @retval 0 Success.
+ * @retval <0 Failure.
+ */
+int XLALSimNeutronStarEOSStateOfPressureGeometerized(double *e, double *h,
+    double *dedp, const double *p, size_t n, LALSimNeutronStarEOS * eos)
+{
+    size_t j;
+    XLAL_CHECK(eos && p, XLAL_EFAULT);
+    if (eos->state_of_p) {
+        XLAL_CHECK(eos->state_of_p(e, h, dedp, p, n, eos) == 0, XLAL_EFUNC);
+        return 0;
+    }
+    for (j = 0; j < n; ++j) {
+        if (e)
+            e[j] = eos->e_of_p(p[j], eos);
+        if (h)
+            h[j] = eos->h_of_p(p[j], eos);
+        if (dedp)
+            dedp[j] = eos->dedp_of_p(p[j], eos);
+    }
+    return 0;
+}
+
 /* FUNCTIONS WITH SI UNITS */
 
 /**
@@ -31,6 +31,31 @@
 
 /** @cond */
 
+/* Tabulated abscissae together with a uniform index of buckets that maps any
+ * abscissa to the range of intervals overlapping its bucket.  The interval
+ * containing an abscissa is found by bisection within that range, which takes
+ * constant time when the abscissae are roughly evenly spaced and time
+ * logarithmic in the number of knots falling in one bucket otherwise. */
+struct eos_tabular_knots {
+    const double *x;
+    size_t n;
+    size_t *bucket;
+    size_t nbucket;
+    double scale;
+};
+
+/* Coefficients of a natural cubic spline on each interval of a set of knots.
+ * These are the same interpolants that gsl_interp_cspline would construct,
+ * but evaluating them requires no accelerator, so a tabular EOS holds no
+ * mutable state and can be shared between threads. */
+struct eos_tabular_spline {
+    const struct eos_tabular_knots *knots;
+    const double *y;
+    double *b;
+    double *c;
+    double *d;
+};
+
 /* Contents of the tabular equation of state data structure. */
 struct tagLALSimNeutronStarEOSDataTabular {
     double *nbdat;
@@ -45,24 +70,171 @@ struct tagLALSimNeutronStarEOSDataTabular {
     size_t ncol;
     size_t ndat;
 
-    gsl_interp *log_e_of_log_p_interp;
-    gsl_interp *log_h_of_log_p_interp;
-    gsl_interp *log_e_of_log_h_interp;
-    gsl_interp *log_p_of_log_h_interp;
-    gsl_interp *log_rho_of_log_h_interp;
-    gsl_interp *log_p_of_log_e_interp;
-    gsl_interp *log_p_of_log_rho_interp;
-    gsl_interp *log_cs2_of_log_h_interp;
-    gsl_interp_accel *log_e_of_log_p_acc;
-    gsl_interp_accel *log_h_of_log_p_acc;
-    gsl_interp_accel *log_e_of_log_h_acc;
-    gsl_interp_accel *log_p_of_log_h_acc;
-    gsl_interp_accel *log_rho_of_log_h_acc;
-    gsl_interp_accel *log_p_of_log_e_acc;
-    gsl_interp_accel *log_p_of_log_rho_acc;
-    gsl_interp_accel *log_cs2_of_log_h_acc;
+    struct eos_tabular_knots log_p_knots;
+    struct eos_tabular_knots log_h_knots;
+    struct eos_tabular_knots log_e_knots;
+    struct eos_tabular_knots log_rho_knots;
+    struct eos_tabular_spline log_e_of_log_p;
+    struct eos_tabular_spline log_h_of_log_p;
+    struct eos_tabular_spline log_e_of_log_h;
+    struct eos_tabular_spline log_p_of_log_h;
+    struct eos_tabular_spline log_rho_of_log_h;
+    struct eos_tabular_spline log_p_of_log_e;
+    struct eos_tabular_spline log_p_of_log_rho;
+    struct eos_tabular_spline log_cs2_of_log_h;
 };
 
+/* Number of lookup buckets per tabulated interval. */
+#define EOS_TABULAR_BUCKETS_PER_INTERVAL 4
+
+static int eos_tabular_knots_init(struct eos_tabular_knots *knots,
+    const double *x, size_t n)
+{
+    size_t i, j;
+
+    if (n < 2)
+        XLAL_ERROR(XLAL_EINVAL, "Equation of state table has fewer than two points");
+    for (i = 1; i < n; ++i)
+        if (!(x[i] > x[i - 1]))
+            XLAL_ERROR(XLAL_EINVAL, "Equation of state table is not strictly increasing");
+
+    knots->x = x;
+    knots->n = n;
+    knots->nbucket = EOS_TABULAR_BUCKETS_PER_INTERVAL * (n - 1);
+    knots->scale = knots->nbucket / (x[n - 1] - x[0]);
+    knots->bucket = XLALMalloc((knots->nbucket + 1) * sizeof(*knots->bucket));
+    if (!knots->bucket)
+        XLAL_ERROR(XLAL_ENOMEM);
+
+    /* record the interval containing the lower edge of each bucket; the
+     * entry after the last bucket is the last interval */
+    for (i = 0, j = 0; j < knots->nbucket; ++j) {
+        double xj = x[0] + j / knots->scale;
+        while (i < n - 2 && x[i + 1] <= xj)
+            ++i;
+        knots->bucket[j] = i;
+    }
+    knots->bucket[knots->nbucket] = n - 2;
+    return 0;
+}
+
+static void eos_tabular_knots_free(struct eos_tabular_knots *knots)
+{
+    XLALFree(knots->bucket);
+    return;
+}
+
+/* Index i of the interval x[i] <= x < x[i+1] (the last interval includes its
+ * upper end); x must lie within the tabulated range. */
+static size_t eos_tabular_knots_interval(const struct eos_tabular_knots *knots,
+    double x)
+{
+    size_t j = (x - knots->x[0]) * knots->scale;
+    size_t lo, hi;
+    if (j >= knots->nbucket)
+        j = knots->nbucket - 1;
+    /* the interval lies between those containing the edges of the bucket;
+     * widen the range by one interval if rounding put x in a neighbouring
+     * bucket */
+    lo = knots->bucket[j];
+    hi = knots->bucket[j + 1];
+    if (lo > 0 && x < knots->x[lo])
+        --lo;
+    if (hi < knots->n - 2 && x >= knots->x[hi + 1])
+        ++hi;
+    while (lo < hi) {
+        size_t mid = (lo + hi + 1) / 2;
+        if (x < knots->x[mid])
+            hi = mid - 1;
+        else
+            lo = mid;
+    }
+    return lo;
+}
+
+static int eos_tabular_knots_contain(const struct eos_tabular_knots *knots,
+    double x)
+{
+    return x >= knots->x[0] && x <= knots->x[knots->n - 1];
+}
+
+static int eos_tabular_spline_init(struct eos_tabular_spline *spline,
+    const struct eos_tabular_knots *knots, const double *y)
+{
+    const double *x = knots->x;
+    size_t n = knots->n;
+    double *diag;
+    size_t i;
+
+    spline->knots = knots;
+    spline->y = y;
+    spline->b = XLALMalloc((n - 1) * sizeof(*spline->b));
+    spline->c = XLALMalloc(n * sizeof(*spline->c));
+    spline->d = XLALMalloc((n - 1) * sizeof(*spline->d));
+    diag = XLALMalloc(n * sizeof(*diag));
+    if (!spline->b || !spline->c || !spline->d || !diag) {
+        XLALFree(diag);
+        XLAL_ERROR(XLAL_ENOMEM);
+    }
+
+    /* solve the tridiagonal system for the quadratic coefficients with
+     * natural boundary conditions, c[0] = c[n-1] = 0 */
+    spline->c[0] = spline->c[n - 1] = 0.0;
+    for (i = 1; i < n - 1; ++i) {
+        double h0 = x[i] - x[i - 1];
+        double h1 = x[i + 1] - x[i];
+        diag[i] = 2.0 * (h0 + h1);
+        spline->c[i] = 3.0 * ((y[i + 1] - y[i]) / h1 - (y[i] - y[i - 1]) / h0);
+        if (i > 1) {
+            double w = h0 / diag[i - 1];
+            diag[i] -= w * h0;
+            spline->c[i] -= w * spline->c[i - 1];
+        }
+    }
+    for (i = n - 2; i > 0; --i)
+        spline->c[i] = (spline->c[i] - (x[i + 1] - x[i]) * spline->c[i + 1]) / diag[i];
+    XLALFree(diag);
+
+    for (i = 0; i < n - 1; ++i) {
+        double h = x[i + 1] - x[i];
+        spline->b[i] = (y[i + 1] - y[i]) / h - h * (spline->c[i + 1] + 2.0 * spline->c[i]) / 3.0;
+        spline->d[i] = (spline->c[i + 1] - spline->c[i]) / (3.0 * h);
+    }
+    return 0;
+}
+
+static void eos_tabular_spline_free(struct eos_tabular_spline *spline)
+{
+    XLALFree(spline->d);
+    XLALFree(spline->c);
+    XLALFree(spline->b);
+    return;
+}
+
+static double eos_tabular_spline_eval_interval(
+    const struct eos_tabular_spline *spline, size_t i, double x)
+{
+    double dx = x - spline->knots->x[i];
+    return spline->y[i] + dx * (spline->b[i] + dx * (spline->c[i] + dx * spline->d[i]));
+}
+
+static double eos_tabular_spline_deriv_interval(
+    const struct eos_tabular_spline *spline, size_t i, double x)
+{
+    double dx = x - spline->knots->x[i];
+    return spline->b[i] + dx * (2.0 * spline->c[i] + 3.0 * dx * spline->d[i]);
+}
+
+static double eos_tabular_spline_eval(const struct eos_tabular_spline *spline,
+    double x)
+{
+    size_t i;
+    if (!eos_tabular_knots_contain(spline->knots, x))
+        XLAL_ERROR_REAL8(XLAL_EDOM, "Value %g is outside the range of the equation of state table", x);
+    i = eos_tabular_knots_interval(spline->knots, x);
+    return eos_tabular_spline_eval_interval(spline, i, x);
+}
+
 static double eos_p_of_e_tabular(double e, LALSimNeutronStarEOS * eos)
 {
 	double log_e;
@@ -73,9 +245,7 @@ static double eos_p_of_e_tabular(double e, LALSimNeutronStarEOS * eos)
 	if (log_e < eos->data.tabular->log_edat[0])
 		/* use non-relativistic degenerate gas, p = K * e**(5./3.) */
 		return exp(eos->data.tabular->log_pdat[0] + (5.0 / 3.0) * (log_e - eos->data.tabular->log_edat[0]));
-    log_p = gsl_interp_eval(eos->data.tabular->log_p_of_log_e_interp,
-        eos->data.tabular->log_edat, eos->data.tabular->log_pdat, log_e,
-        eos->data.tabular->log_p_of_log_e_acc);
+    log_p = eos_tabular_spline_eval(&eos->data.tabular->log_p_of_log_e, log_e);
     return exp(log_p);
 }
 
@@ -89,9 +259,7 @@ static double eos_p_of_rho_tabular(double rho, LALSimNeutronStarEOS * eos)
 	if (log_rho < eos->data.tabular->log_rhodat[0])
 		/* use non-relativistic degenerate gas, p = K * rho**(5./3.) */
 		return exp(eos->data.tabular->log_pdat[0] + (5.0 / 3.0) * (log_rho - eos->data.tabular->log_rhodat[0]));
-    log_p = gsl_interp_eval(eos->data.tabular->log_p_of_log_rho_interp,
-        eos->data.tabular->log_rhodat, eos->data.tabular->log_pdat, log_rho,
-        eos->data.tabular->log_p_of_log_rho_acc);
+    log_p = eos_tabular_spline_eval(&eos->data.tabular->log_p_of_log_rho, log_rho);
     return exp(log_p);
 }
 
@@ -105,9 +273,7 @@ static double eos_e_of_p_tabular(double p, LALSimNeutronStarEOS * eos)
 	if (log_p < eos->data.tabular->log_pdat[0])
 		/* use non-relativistic degenerate gas, p = K * e**(5./3.) */
 		return exp(eos->data.tabular->log_edat[0] + (3.0 / 5.0) * (log_p - eos->data.tabular->log_pdat[0]));
-    log_e = gsl_interp_eval(eos->data.tabular->log_e_of_log_p_interp,
-        eos->data.tabular->log_pdat, eos->data.tabular->log_edat, log_p,
-        eos->data.tabular->log_e_of_log_p_acc);
+    log_e = eos_tabular_spline_eval(&eos->data.tabular->log_e_of_log_p, log_p);
     return exp(log_e);
 }
 
@@ -121,9 +287,7 @@ static double eos_e_of_h_tabular(double h, LALSimNeutronStarEOS * eos)
 	if (log_h < eos->data.tabular->log_hdat[0])
 		/* use non-relativistic degenerate gas, e = K * h**(3./2.) */
 		return exp(eos->data.tabular->log_edat[0] + 1.5 * (log_h - eos->data.tabular->log_hdat[0]));
-    log_e = gsl_interp_eval(eos->data.tabular->log_e_of_log_h_interp,
-        eos->data.tabular->log_hdat, eos->data.tabular->log_edat, log_h,
-        eos->data.tabular->log_e_of_log_h_acc);
+    log_e = eos_tabular_spline_eval(&eos->data.tabular->log_e_of_log_h, log_h);
     return exp(log_e);
 }
 
@@ -137,9 +301,7 @@ static double eos_p_of_h_tabular(double h, LALSimNeutronStarEOS * eos)
 	if (log_h < eos->data.tabular->log_hdat[0])
 		/* use non-relativistic degenerate gas, p = K * h**(5./2.) */
 		return exp(eos->data.tabular->log_pdat[0] + 2.5 * (log_h - eos->data.tabular->log_hdat[0]));
-    log_p = gsl_interp_eval(eos->data.tabular->log_p_of_log_h_interp,
-        eos->data.tabular->log_hdat, eos->data.tabular->log_pdat, log_h,
-        eos->data.tabular->log_p_of_log_h_acc);
+    log_p = eos_tabular_spline_eval(&eos->data.tabular->log_p_of_log_h, log_h);
     return exp(log_p);
 }
 
@@ -153,9 +315,7 @@ static double eos_rho_of_h_tabular(double h, LALSimNeutronStarEOS * eos)
 	if (log_h < eos->data.tabular->log_hdat[0])
 		/* use non-relativistic degenerate gas, rho = K * h**(3./2.) */
 		return exp(eos->data.tabular->log_rhodat[0] + 1.5 * (log_h - eos->data.tabular->log_hdat[0]));
-    log_rho = gsl_interp_eval(eos->data.tabular->log_rho_of_log_h_interp,
-        eos->data.tabular->log_hdat, eos->data.tabular->log_rhodat, log_h,
-        eos->data.tabular->log_rho_of_log_h_acc);
+    log_rho = eos_tabular_spline_eval(&eos->data.tabular->log_rho_of_log_h, log_h);
     return exp(log_rho);
 }
 
@@ -169,9 +329,7 @@ static double eos_h_of_p_tabular(double p, LALSimNeutronStarEOS * eos)
 	if (log_p < eos->data.tabular->log_pdat[0])
 		/* use non-relativistic degenerate gas, h = K * p**(2./5.) */
 		return exp(eos->data.tabular->log_hdat[0] + 0.4 * (log_p - eos->data.tabular->log_pdat[0]));
-    log_h = gsl_interp_eval(eos->data.tabular->log_h_of_log_p_interp,
-        eos->data.tabular->log_pdat, eos->data.tabular->log_hdat, log_p,
-        eos->data.tabular->log_h_of_log_p_acc);
+    log_h = eos_tabular_spline_eval(&eos->data.tabular->log_h_of_log_p, log_p);
     return exp(log_h);
 }
 
@@ -180,15 +338,15 @@ static double eos_dedp_of_p_tabular(double p, LALSimNeutronStarEOS * eos)
     double log_p;
     double log_e;
     double d_log_e_d_log_p;
+    size_t i;
 	if (p == 0 || (log_p = log(p)) < eos->data.tabular->log_pdat[0])
 		/* use non-relativistic degenerate gas, p = K * e**(5./3.) */
 		return (3.0 / 5.0) * exp(eos->data.tabular->log_edat[0] - eos->data.tabular->log_pdat[0]);
-    log_e = gsl_interp_eval(eos->data.tabular->log_e_of_log_p_interp,
-        eos->data.tabular->log_pdat, eos->data.tabular->log_edat, log_p,
-        eos->data.tabular->log_e_of_log_p_acc);
-    d_log_e_d_log_p = gsl_interp_eval_deriv(eos->data.tabular->log_e_of_log_p_interp,
-        eos->data.tabular->log_pdat, eos->data.tabular->log_edat, log_p,
-        eos->data.tabular->log_e_of_log_p_acc);
+    if (!eos_tabular_knots_contain(&eos->data.tabular->log_p_knots, log_p))
+        XLAL_ERROR_REAL8(XLAL_EDOM, "Pressure %g is outside the range of the equation of state table", p);
+    i = eos_tabular_knots_interval(&eos->data.tabular->log_p_knots, log_p);
+    log_e = eos_tabular_spline_eval_interval(&eos->data.tabular->log_e_of_log_p, i, log_p);
+    d_log_e_d_log_p = eos_tabular_spline_deriv_interval(&eos->data.tabular->log_e_of_log_p, i, log_p);
     return d_log_e_d_log_p * exp(log_e - log_p);
 }
 
@@ -202,13 +360,75 @@ static double eos_v_of_h_tabular(double h, LALSimNeutronStarEOS * eos)
         return pow(dedp, -0.5);
     }
     log_h = log(h);
-    log_cs2 = gsl_interp_eval(eos->data.tabular->log_cs2_of_log_h_interp,
-    eos->data.tabular->log_hdat, eos->data.tabular->log_cs2dat, log_h,
-    eos->data.tabular->log_cs2_of_log_h_acc);
+    log_cs2 = eos_tabular_spline_eval(&eos->data.tabular->log_cs2_of_log_h, log_h);
     
     return pow(exp(log_cs2), -0.5);
 }
 
+/* Batched evaluation at many pseudo-enthalpies; the interval of the table is
+ * located once per point and shared between the requested quantities. */
+static int eos_state_of_h_tabular(double *p, double *e, double *rho,
+    const double *h, size_t n, LALSimNeutronStarEOS * eos)
+{
+    const LALSimNeutronStarEOSDataTabular *data = eos->data.tabular;
+    size_t j;
+
+    for (j = 0; j < n; ++j) {
+        double log_h;
+        size_t i;
+        if (h[j] == 0.0) {
+            if (p) p[j] = 0.0;
+            if (e) e[j] = 0.0;
+            if (rho) rho[j] = 0.0;
+            continue;
+        }
+        log_h = log(h[j]);
+        if (log_h < data->log_hdat[0]) {
+            /* use non-relativistic degenerate gas as in the scalar routines */
+            if (p) p[j] = exp(data->log_pdat[0] + 2.5 * (log_h - data->log_hdat[0]));
+            if (e) e[j] = exp(data->log_edat[0] + 1.5 * (log_h - data->log_hdat[0]));
+            if (rho) rho[j] = exp(data->log_rhodat[0] + 1.5 * (log_h - data->log_hdat[0]));
+            continue;
+        }
+        if (!eos_tabular_knots_contain(&data->log_h_knots, log_h))
+            XLAL_ERROR(XLAL_EDOM, "Pseudo-enthalpy %g is outside the range of the equation of state table", h[j]);
+        i = eos_tabular_knots_interval(&data->log_h_knots, log_h);
+        if (p) p[j] = exp(eos_tabular_spline_eval_interval(&data->log_p_of_log_h, i, log_h));
+        if (e) e[j] = exp(eos_tabular_spline_eval_interval(&data->log_e_of_log_h, i, log_h));
+        if (rho) rho[j] = exp(eos_tabular_spline_eval_interval(&data->log_rho_of_log_h, i, log_h));
+    }
+    return 0;
+}
+
+/* Batched evaluation at many pressures. */
+static int eos_state_of_p_tabular(double *e, double *h, double *dedp,
+    const double *p, size_t n, LALSimNeutronStarEOS * eos)
+{
+    const LALSimNeutronStarEOSDataTabular *data = eos->data.tabular;
+    size_t j;
+
+    for (j = 0; j < n; ++j) {
+        double log_p;
+        double log_e;
+        size_t i;
+        if (p[j] == 0.0 || (log_p = log(p[j])) < data->log_pdat[0]) {
+            /* use non-relativistic degenerate gas as in the scalar routines */
+            if (e) e[j] = p[j] == 0.0 ? 0.0 : exp(data->log_edat[0] + (3.0 / 5.0) * (log_p - data->log_pdat[0]));
+            if (h) h[j] = p[j] == 0.0 ? 0.0 : exp(data->log_hdat[0] + 0.4 * (log_p - data->log_pdat[0]));
+            if (dedp) dedp[j] = (3.0 / 5.0) * exp(data->log_edat[0] - data->log_pdat[0]);
+            continue;
+        }
+        if (!eos_tabular_knots_contain(&data->log_p_knots, log_p))
+            XLAL_ERROR(XLAL_EDOM, "Pressure %g is outside the range of the equation of state table", p[j]);
+        i = eos_tabular_knots_interval(&data->log_p_knots, log_p);
+        log_e = eos_tabular_spline_eval_interval(&data->log_e_of_log_p, i, log_p);
+        if (e) e[j] = exp(log_e);
+        if (h) h[j] = exp(eos_tabular_spline_eval_interval(&data->log_h_of_log_p, i, log_p));
+        if (dedp) dedp[j] = eos_tabular_spline_deriv_interval(&data->log_e_of_log_p, i, log_p) * exp(log_e - log_p);
+    }
+    return 0;
+}
+
 //static double eos_v_of_h_tabular(double h, LALSimNeutronStarEOS *eos)
 //{
 //      double dpdh, dedh;
@@ -222,22 +442,18 @@ static double eos_v_of_h_tabular(double h, LALSimNeutronStarEOS * eos)
 static void eos_free_tabular_data(LALSimNeutronStarEOSDataTabular * data)
 {
     if (data) {
-        gsl_interp_free(data->log_e_of_log_p_interp);
-        gsl_interp_free(data->log_e_of_log_h_interp);
-        gsl_interp_free(data->log_p_of_log_h_interp);
-        gsl_interp_free(data->log_h_of_log_p_interp);
-        gsl_interp_free(data->log_rho_of_log_h_interp);
-        gsl_interp_free(data->log_p_of_log_e_interp);
-        gsl_interp_free(data->log_p_of_log_rho_interp);
-        gsl_interp_free(data->log_cs2_of_log_h_interp);
-        gsl_interp_accel_free(data->log_e_of_log_p_acc);
-        gsl_interp_accel_free(data->log_e_of_log_h_acc);
-        gsl_interp_accel_free(data->log_p_of_log_h_acc);
-        gsl_interp_accel_free(data->log_h_of_log_p_acc);
-        gsl_interp_accel_free(data->log_rho_of_log_h_acc);
-        gsl_interp_accel_free(data->log_p_of_log_e_acc);
-        gsl_interp_accel_free(data->log_p_of_log_rho_acc);
-        gsl_interp_accel_free(data->log_cs2_of_log_h_acc);
+        eos_tabular_spline_free(&data->log_e_of_log_p);
+        eos_tabular_spline_free(&data->log_e_of_log_h);
+        eos_tabular_spline_free(&data->log_p_of_log_h);
+        eos_tabular_spline_free(&data->log_h_of_log_p);
+        eos_tabular_spline_free(&data->log_rho_of_log_h);
+        eos_tabular_spline_free(&data->log_p_of_log_e);
+        eos_tabular_spline_free(&data->log_p_of_log_rho);
+        eos_tabular_spline_free(&data->log_cs2_of_log_h);
+        eos_tabular_knots_free(&data->log_p_knots);
+        eos_tabular_knots_free(&data->log_h_knots);
+        eos_tabular_knots_free(&data->log_e_knots);
+        eos_tabular_knots_free(&data->log_rho_knots);
         LALFree(data->log_edat);
         LALFree(data->log_pdat);
         LALFree(data->mubdat);
@@ -324,6 +540,8 @@ static LALSimNeutronStarEOS *eos_alloc_tabular(double *nbdat, double *edat, doub
     eos->p_of_rho = eos_p_of_rho_tabular;
     eos->dedp_of_p = eos_dedp_of_p_tabular;
     eos->v_of_h = eos_v_of_h_tabular;
+    eos->state_of_h = eos_state_of_h_tabular;
+    eos->state_of_p = eos_state_of_p_tabular;
 
     data->log_rhodat = XLALMalloc(ndat * sizeof(*data->log_rhodat));
 
@@ -402,11 +620,6 @@ static LALSimNeutronStarEOS *eos_alloc_tabular(double *nbdat, double *edat, doub
             data->yedat[i] = yedat[i];
             data->log_cs2dat[i] = log(cs2dat[i]);
         }
-
-        /* these can be set up only using the new eos tables; so they are set up here */
-        data->log_cs2_of_log_h_acc = gsl_interp_accel_alloc();
-        data->log_cs2_of_log_h_interp = gsl_interp_alloc(gsl_interp_cspline, ndat);
-        gsl_interp_init(data->log_cs2_of_log_h_interp, data->log_hdat, data->log_cs2dat, ndat);
     }
 
     // Find rho from e, p, and h: rho = (e+p)/exp(h)
@@ -418,29 +631,22 @@ static LALSimNeutronStarEOS *eos_alloc_tabular(double *nbdat, double *edat, doub
 
     /* setup interpolation tables */
 
-    data->log_e_of_log_p_acc = gsl_interp_accel_alloc();
-    data->log_h_of_log_p_acc = gsl_interp_accel_alloc();
-    data->log_e_of_log_h_acc = gsl_interp_accel_alloc();
-    data->log_p_of_log_h_acc = gsl_interp_accel_alloc();
-    data->log_rho_of_log_h_acc = gsl_interp_accel_alloc();
-    data->log_p_of_log_e_acc = gsl_interp_accel_alloc();
-    data->log_p_of_log_rho_acc = gsl_interp_accel_alloc();
-
-    data->log_e_of_log_p_interp = gsl_interp_alloc(gsl_interp_cspline, ndat);
-    data->log_h_of_log_p_interp = gsl_interp_alloc(gsl_interp_cspline, ndat);
-    data->log_e_of_log_h_interp = gsl_interp_alloc(gsl_interp_cspline, ndat);
-    data->log_p_of_log_h_interp = gsl_interp_alloc(gsl_interp_cspline, ndat);
-    data->log_rho_of_log_h_interp = gsl_interp_alloc(gsl_interp_cspline, ndat);
-    data->log_p_of_log_e_interp = gsl_interp_alloc(gsl_interp_cspline, ndat);
-    data->log_p_of_log_rho_interp = gsl_interp_alloc(gsl_interp_cspline, ndat);
-
-    gsl_interp_init(data->log_e_of_log_p_interp, data->log_pdat, data->log_edat, ndat);
-    gsl_interp_init(data->log_h_of_log_p_interp, data->log_pdat, data->log_hdat, ndat);
-    gsl_interp_init(data->log_e_of_log_h_interp, data->log_hdat, data->log_edat, ndat);
-    gsl_interp_init(data->log_p_of_log_h_interp, data->log_hdat, data->log_pdat, ndat);
-    gsl_interp_init(data->log_rho_of_log_h_interp, data->log_hdat, data->log_rhodat, ndat);
-    gsl_interp_init(data->log_p_of_log_e_interp, data->log_edat, data->log_pdat, ndat);
-    gsl_interp_init(data->log_p_of_log_rho_interp, data->log_rhodat, data->log_pdat, ndat);
+    if (eos_tabular_knots_init(&data->log_p_knots, data->log_pdat, ndat) < 0
+        || eos_tabular_knots_init(&data->log_h_knots, data->log_hdat, ndat) < 0
+        || eos_tabular_knots_init(&data->log_e_knots, data->log_edat, ndat) < 0
+        || eos_tabular_knots_init(&data->log_rho_knots, data->log_rhodat, ndat) < 0
+        || eos_tabular_spline_init(&data->log_e_of_log_p, &data->log_p_knots, data->log_edat) < 0
+        || eos_tabular_spline_init(&data->log_h_of_log_p, &data->log_p_knots, data->log_hdat) < 0
+        || eos_tabular_spline_init(&data->log_e_of_log_h, &data->log_h_knots, data->log_edat) < 0
+        || eos_tabular_spline_init(&data->log_p_of_log_h, &data->log_h_knots, data->log_pdat) < 0
+        || eos_tabular_spline_init(&data->log_rho_of_log_h, &data->log_h_knots, data->log_rhodat) < 0
+        || eos_tabular_spline_init(&data->log_p_of_log_e, &data->log_e_knots, data->log_pdat) < 0
+        || eos_tabular_spline_init(&data->log_p_of_log_rho, &data->log_rho_knots, data->log_pdat) < 0
+        /* this can be set up only using the new eos tables */
+        || (data->log_cs2dat && eos_tabular_spline_init(&data->log_cs2_of_log_h, &data->log_h_knots, data->log_cs2dat) < 0)) {
+        eos_free_tabular(eos);
+        XLAL_ERROR_NULL(XLAL_EFUNC);
+    }
 
     eos->hMinAcausal =
         eos_min_acausal_pseudo_enthalpy_tabular(eos->hmax, eos);
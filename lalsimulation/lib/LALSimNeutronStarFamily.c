@@ -25,6 +25,7 @@
  */
 
 #include <math.h>
+#include <string.h>
 #include <gsl/gsl_errno.h>
 #include <gsl/gsl_interp.h>
 #include <gsl/gsl_min.h>
@@ -33,6 +34,12 @@ GSL_VAR const gsl_interp_type * lal_gsl_interp_steffen;
 #include <lal/LALStdlib.h>
 #include <lal/LALSimNeutronStar.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp ignore
+#endif
+
 /** @cond */
 
 /* Contents of the neutron star family structure. */
@@ -60,6 +67,185 @@ static double fminimizer_gslfunction(double x, void * params)
     return -m; /* maximum mass is minimum negative mass */
 }
 
+/* Allocates a family with room for ndat stars. */
+static LALSimNeutronStarFamily * family_alloc(size_t ndat)
+{
+    LALSimNeutronStarFamily * fam;
+    fam = LALCalloc(1, sizeof(*fam));
+    if (!fam)
+        XLAL_ERROR_NULL(XLAL_ENOMEM);
+    fam->pdat = LALMalloc(ndat * sizeof(*fam->pdat));
+    fam->mdat = LALMalloc(ndat * sizeof(*fam->mdat));
+    fam->rdat = LALMalloc(ndat * sizeof(*fam->rdat));
+    fam->kdat = LALMalloc(ndat * sizeof(*fam->kdat));
+    if (!fam->pdat || !fam->mdat || !fam->rdat || !fam->kdat) {
+        XLALDestroySimNeutronStarFamily(fam);
+        XLAL_ERROR_NULL(XLAL_ENOMEM);
+    }
+    return fam;
+}
+
+/* Integrates stars with central pressures exp(logpmin + i * dlogp) for
+ * i = 0, 1, ..., ndat - 1, stopping at the first star that is not more
+ * massive than its predecessor; returns its index, or ndat if there is none.
+ * Stars are integrated a block at a time, one per thread, so little work is
+ * wasted beyond the maximum mass. */
+static size_t family_integrate(LALSimNeutronStarFamily * fam, double logpmin,
+    double dlogp, size_t ndat, LALSimNeutronStarEOS * eos)
+{
+    size_t nblock = 1;
+    size_t i;
+#ifdef _OPENMP
+    nblock = omp_get_max_threads();
+#endif
+    for (i = 0; i < ndat; ) {
+        size_t iend = i + nblock < ndat ? i + nblock : ndat;
+        size_t j;
+#pragma omp parallel for schedule(dynamic)
+        for (j = i; j < iend; ++j) {
+            fam->pdat[j] = exp(logpmin + j * dlogp);
+            XLALSimNeutronStarTOVODEIntegrate(&fam->rdat[j], &fam->mdat[j],
+                &fam->kdat[j], fam->pdat[j], eos);
+        }
+        /* determine if maximum mass has been found */
+        for (; i < iend; ++i)
+            if (i > 0 && fam->mdat[i] <= fam->mdat[i-1])
+                break;
+        if (i < iend)
+            break;
+    }
+    return i;
+}
+
+/* Replaces star i, the first one past the maximum mass, with the maximum
+ * mass star and truncates the family there; returns the new length. */
+static size_t family_maximum_mass(LALSimNeutronStarFamily * fam, size_t i,
+    LALSimNeutronStarEOS * eos)
+{
+    const double epsabs = 0.0, epsrel = 1e-6;
+    double a = fam->pdat[i - 2];
+    double x = fam->pdat[i - 1];
+    double b = fam->pdat[i];
+    double fa = -fam->mdat[i - 2];
+    double fx = -fam->mdat[i - 1];
+    double fb = -fam->mdat[i];
+    size_t ndat;
+    int status;
+    gsl_function F;
+    gsl_min_fminimizer * s;
+    F.function = &fminimizer_gslfunction;
+    F.params = eos;
+    s = gsl_min_fminimizer_alloc(gsl_min_fminimizer_brent);
+    gsl_min_fminimizer_set_with_values(s, &F, x, fx, a, fa, b, fb);
+    do {
+        status = gsl_min_fminimizer_iterate(s);
+        x = gsl_min_fminimizer_x_minimum(s);
+        a = gsl_min_fminimizer_x_lower(s);
+        b = gsl_min_fminimizer_x_upper(s);
+        status = gsl_min_test_interval(a, b, epsabs, epsrel);
+    } while (status == GSL_CONTINUE);
+    gsl_min_fminimizer_free(s);
+    fam->pdat[i] = x;
+    XLALSimNeutronStarTOVODEIntegrate(&fam->rdat[i], &fam->mdat[i],
+        &fam->kdat[i], fam->pdat[i], eos);
+
+    /* resize arrays */
+    if(fam->pdat[i] <= fam->pdat[i-1]){
+        fam->pdat[i-1] = fam->pdat[i];
+        ndat = i;
+    }
+    else{
+        ndat = i + 1;
+    }
+
+    fam->pdat = LALRealloc(fam->pdat, ndat * sizeof(*fam->pdat));
+    fam->mdat = LALRealloc(fam->mdat, ndat * sizeof(*fam->mdat));
+    fam->rdat = LALRealloc(fam->rdat, ndat * sizeof(*fam->rdat));
+    fam->kdat = LALRealloc(fam->kdat, ndat * sizeof(*fam->kdat));
+    return ndat;
+}
+
+/* Sets up the interpolators of a family of ndat stars. */
+static void family_init_interp(LALSimNeutronStarFamily * fam, size_t ndat)
+{
+    fam->ndat = ndat;
+
+    fam->p_of_m_acc = gsl_interp_accel_alloc();
+    fam->r_of_m_acc = gsl_interp_accel_alloc();
+    fam->k_of_m_acc = gsl_interp_accel_alloc();
+
+    fam->p_of_m_interp = gsl_interp_alloc(gsl_interp_cspline, ndat);
+    fam->r_of_m_interp = gsl_interp_alloc(lal_gsl_interp_steffen, ndat);
+    fam->k_of_m_interp = gsl_interp_alloc(lal_gsl_interp_steffen, ndat);
+
+    gsl_interp_init(fam->p_of_m_interp, fam->mdat, fam->pdat, ndat);
+    gsl_interp_init(fam->r_of_m_interp, fam->mdat, fam->rdat, ndat);
+    gsl_interp_init(fam->k_of_m_interp, fam->mdat, fam->kdat, ndat);
+    return;
+}
+
+/* Relative difference between v at x and its prediction by the Lagrange
+ * polynomial through the n points (xs[i], vs[i]). */
+static double family_prediction_error(double x, double v, const double *xs,
+    const double *vs, size_t n)
+{
+    double pred = 0.0;
+    size_t i, j;
+    for (i = 0; i < n; ++i) {
+        double w = vs[i];
+        for (j = 0; j < n; ++j)
+            if (j != i)
+                w *= (x - xs[j]) / (xs[i] - xs[j]);
+        pred += w;
+    }
+    return fabs(v - pred) / fabs(v);
+}
+
+/* Largest relative error of the cubic (quadratic at the ends) prediction of
+ * the mass, radius and Love number of a new star with central pressure p
+ * inside interval j, from the (up to) four stars around that interval. */
+static double family_midpoint_error(const LALSimNeutronStarFamily * fam,
+    size_t ndat, size_t j, double p, double m, double r, double k)
+{
+    size_t lo = j > 0 ? j - 1 : j;
+    size_t hi = j + 2 < ndat ? j + 2 : j + 1;
+    double logp[4];
+    double err;
+    size_t i;
+    for (i = lo; i <= hi; ++i)
+        logp[i - lo] = log(fam->pdat[i]);
+    err = family_prediction_error(log(p), m, logp, fam->mdat + lo, hi - lo + 1);
+    err = fmax(err, family_prediction_error(log(p), r, logp, fam->rdat + lo, hi - lo + 1));
+    err = fmax(err, family_prediction_error(log(p), k, logp, fam->kdat + lo, hi - lo + 1));
+    return err;
+}
+
+/* Contents of the neutron star family cache. */
+struct tagLALSimNeutronStarFamilyCache {
+    size_t size;
+    size_t length;
+    double tolerance;
+    unsigned long clock;
+    struct {
+        double *key;
+        size_t nkey;
+        unsigned long used;
+        LALSimNeutronStarEOS *eos;
+        LALSimNeutronStarFamily *fam;
+    } *entry;
+};
+
+/* Whether two cache keys agree to within the cache tolerance. */
+static int family_cache_match(const double *a, const double *b, size_t n,
+    double tolerance)
+{
+    size_t i;
+    for (i = 0; i < n; ++i)
+        if (!(fabs(a[i] - b[i]) <= tolerance * fmax(fabs(a[i]), fabs(b[i]))))
+            return 0;
+    return 1;
+}
+
 /** @endcond */
 
 /**
@@ -107,85 +293,201 @@ LALSimNeutronStarFamily * XLALCreateSimNeutronStarFamily(
     size_t i;
 
     /* allocate memory */
-    fam = LALMalloc(sizeof(*fam));
+    fam = family_alloc(ndat);
     if (!fam)
-        XLAL_ERROR_NULL(XLAL_ENOMEM);
-    fam->pdat = LALMalloc(ndat * sizeof(*fam->pdat));
-    fam->mdat = LALMalloc(ndat * sizeof(*fam->mdat));
-    fam->rdat = LALMalloc(ndat * sizeof(*fam->rdat));
-    fam->kdat = LALMalloc(ndat * sizeof(*fam->kdat));
-    if (!fam->mdat || !fam->rdat || !fam->kdat)
-        XLAL_ERROR_NULL(XLAL_ENOMEM);
+        XLAL_ERROR_NULL(XLAL_EFUNC);
 
     /* compute data tables */
     logpmax = log(XLALSimNeutronStarEOSMaxPressure(eos));
     dlogp = (logpmax - logpmin) / ndat;
-    for (i = 0; i < ndat; ++i) {
-        fam->pdat[i] = exp(logpmin + i * dlogp);
-        XLALSimNeutronStarTOVODEIntegrate(&fam->rdat[i], &fam->mdat[i],
-            &fam->kdat[i], fam->pdat[i], eos);
-        /* determine if maximum mass has been found */
-        if (i > 0 && fam->mdat[i] <= fam->mdat[i-1])
-            break;
-    }
+    i = family_integrate(fam, logpmin, dlogp, ndat, eos);
 
     if (i < ndat) {
+        if (i < 2) {
+            XLALDestroySimNeutronStarFamily(fam);
+            XLAL_ERROR_NULL(XLAL_EFAILED, "Maximum mass reached within the first two stars of the family");
+        }
         /* replace the ith point with the maximum mass */
-        const double epsabs = 0.0, epsrel = 1e-6;
-        double a = fam->pdat[i - 2];
-        double x = fam->pdat[i - 1];
-        double b = fam->pdat[i];
-        double fa = -fam->mdat[i - 2];
-        double fx = -fam->mdat[i - 1];
-        double fb = -fam->mdat[i];
-        int status;
-        gsl_function F;
-        gsl_min_fminimizer * s;
-        F.function = &fminimizer_gslfunction;
-        F.params = eos;
-        s = gsl_min_fminimizer_alloc(gsl_min_fminimizer_brent);
-        gsl_min_fminimizer_set_with_values(s, &F, x, fx, a, fa, b, fb);
-        do {
-            status = gsl_min_fminimizer_iterate(s);
-            x = gsl_min_fminimizer_x_minimum(s);
-            a = gsl_min_fminimizer_x_lower(s);
-            b = gsl_min_fminimizer_x_upper(s);
-            status = gsl_min_test_interval(a, b, epsabs, epsrel);
-        } while (status == GSL_CONTINUE);
-        gsl_min_fminimizer_free(s);
-        fam->pdat[i] = x;
-        XLALSimNeutronStarTOVODEIntegrate(&fam->rdat[i], &fam->mdat[i],
-            &fam->kdat[i], fam->pdat[i], eos);
-
-        /* resize arrays */
-        if(fam->pdat[i] <= fam->pdat[i-1]){
-            fam->pdat[i-1] = fam->pdat[i];
-            ndat = i;
+        ndat = family_maximum_mass(fam, i, eos);
+    }
+
+    /* setup interpolators */
+    family_init_interp(fam, ndat);
+
+    return fam;
+}
+
+/**
+ * @brief Creates a neutron star family structure for a given equation of
+ * state, integrating only as many stars as are needed for a given accuracy.
+ * @details
+ * As XLALCreateSimNeutronStarFamily(), but the family is first sampled at
+ * a coarse set of central pressures, and intervals are then repeatedly
+ * bisected (the stars of each level being integrated in parallel) until the
+ * mass, radius and Love number of each new star agree with their cubic
+ * interpolation from the neighbouring stars to within the relative
+ * tolerance @a tolerance.  For smooth equations of state this needs far fewer TOV
+ * integrations than the fixed grid of XLALCreateSimNeutronStarFamily().
+ * @param eos Pointer to the Equation of State structure.
+ * @param tolerance Relative tolerance of the sampling of the family.
+ * @return A pointer to the neutron star family structure.
+ */
+LALSimNeutronStarFamily * XLALCreateSimNeutronStarFamilyAdaptive(
+    LALSimNeutronStarEOS * eos, double tolerance)
+{
+    LALSimNeutronStarFamily * fam;
+    const size_t ncoarse = 16;
+    const size_t ndatmax = 400;
+    const double logpmin = 75.5;
+    double logpmax;
+    double ptop = 0, mtop = 0, rtop = 0, ktop = 0;
+    int have_top;
+    double *work;
+    double *pdat, *mdat, *rdat, *kdat;
+    double *pmid, *mmid, *rmid, *kmid;
+    size_t *imid;
+    unsigned char *refine, *refine_next;
+    size_t ndat, nmid, nrefine;
+    size_t i, j, q;
+
+    XLAL_CHECK_NULL(eos, XLAL_EFAULT);
+    XLAL_CHECK_NULL(tolerance > 0, XLAL_EINVAL, "Tolerance must be positive");
+
+    fam = family_alloc(ndatmax);
+    work = LALMalloc(8 * ndatmax * sizeof(*work));
+    imid = LALMalloc(ndatmax * sizeof(*imid));
+    refine = LALMalloc(2 * ndatmax * sizeof(*refine));
+    if (!fam || !work || !imid || !refine) {
+        XLALDestroySimNeutronStarFamily(fam);
+        LALFree(refine);
+        LALFree(imid);
+        LALFree(work);
+        XLAL_ERROR_NULL(XLAL_ENOMEM);
+    }
+    pdat = work;
+    mdat = pdat + ndatmax;
+    rdat = mdat + ndatmax;
+    kdat = rdat + ndatmax;
+    pmid = kdat + ndatmax;
+    mmid = pmid + ndatmax;
+    rmid = mmid + ndatmax;
+    kmid = rmid + ndatmax;
+    refine_next = refine + ndatmax;
+
+    /* coarse sampling of the family */
+    logpmax = log(XLALSimNeutronStarEOSMaxPressure(eos));
+    i = family_integrate(fam, logpmin, (logpmax - logpmin) / ncoarse,
+        ncoarse, eos);
+    if (i < 2) {
+        XLALDestroySimNeutronStarFamily(fam);
+        LALFree(refine);
+        LALFree(imid);
+        LALFree(work);
+        XLAL_ERROR_NULL(XLAL_EFAILED, "Maximum mass reached within the first two stars of the family");
+    }
+    have_top = i < ncoarse;
+    if (have_top) {
+        /* set aside the star beyond the maximum mass */
+        ptop = fam->pdat[i];
+        mtop = fam->mdat[i];
+        rtop = fam->rdat[i];
+        ktop = fam->kdat[i];
+    }
+
+    /* refine the stable branch a level at a time; one slot is kept for
+     * the star beyond the maximum mass */
+    ndat = i;
+    for (j = 0; j + 1 < ndat; ++j)
+        refine[j] = 1;
+    nrefine = ndat - 1;
+    while (nrefine > 0 && ndat < ndatmax - 1) {
+        /* bisect (in log pressure) the flagged intervals */
+        for (j = 0, nmid = 0; j + 1 < ndat && ndat + nmid < ndatmax - 1; ++j)
+            if (refine[j])
+                imid[nmid++] = j;
+#pragma omp parallel for schedule(dynamic)
+        for (q = 0; q < nmid; ++q) {
+            pmid[q] = sqrt(fam->pdat[imid[q]] * fam->pdat[imid[q] + 1]);
+            XLALSimNeutronStarTOVODEIntegrate(&rmid[q], &mmid[q], &kmid[q],
+                pmid[q], eos);
         }
-        else{
-            ndat = i + 1;
+
+        /* merge, flagging both halves of any interval where the cubic
+         * prediction from the neighbouring stars did not describe the new
+         * star */
+        for (j = 0, q = 0, i = 0, nrefine = 0; j < ndat; ++j) {
+            pdat[i] = fam->pdat[j];
+            mdat[i] = fam->mdat[j];
+            rdat[i] = fam->rdat[j];
+            kdat[i] = fam->kdat[j];
+            if (q < nmid && imid[q] == j) {
+                int inaccurate = family_midpoint_error(fam, ndat, j, pmid[q],
+                    mmid[q], rmid[q], kmid[q]) > tolerance;
+                refine_next[i++] = inaccurate;
+                pdat[i] = pmid[q];
+                mdat[i] = mmid[q];
+                rdat[i] = rmid[q];
+                kdat[i] = kmid[q];
+                refine_next[i++] = inaccurate;
+                nrefine += 2 * inaccurate;
+                ++q;
+            } else
+                refine_next[i++] = 0;
+        }
+        ndat = i;
+        memcpy(fam->pdat, pdat, ndat * sizeof(*pdat));
+        memcpy(fam->mdat, mdat, ndat * sizeof(*mdat));
+        memcpy(fam->rdat, rdat, ndat * sizeof(*rdat));
+        memcpy(fam->kdat, kdat, ndat * sizeof(*kdat));
+        memcpy(refine, refine_next, ndat * sizeof(*refine));
+
+        /* the maximum mass may lie in the last interval that was
+         * bisected, in which case the new star there is heavier than the
+         * last one: truncate the family at the first star that is not
+         * more massive than its predecessor, which becomes the star
+         * beyond the maximum mass, so that the masses stay increasing */
+        for (i = 1; i < ndat; ++i)
+            if (fam->mdat[i] <= fam->mdat[i-1])
+                break;
+        if (i < ndat) {
+            if (i < 2) {
+                XLALDestroySimNeutronStarFamily(fam);
+                LALFree(refine);
+                LALFree(imid);
+                LALFree(work);
+                XLAL_ERROR_NULL(XLAL_EFAILED, "Maximum mass reached within the first two stars of the family");
+            }
+            have_top = 1;
+            ptop = fam->pdat[i];
+            mtop = fam->mdat[i];
+            rtop = fam->rdat[i];
+            ktop = fam->kdat[i];
+            ndat = i;
+            for (j = 0, nrefine = 0; j + 1 < ndat; ++j)
+                nrefine += refine[j];
         }
+    }
+    LALFree(refine);
+    LALFree(imid);
+    LALFree(work);
 
+    if (have_top) {
+        /* restore the star beyond the maximum mass and find the maximum,
+         * bracketed by the heaviest star and its two neighbours */
+        fam->pdat[ndat] = ptop;
+        fam->mdat[ndat] = mtop;
+        fam->rdat[ndat] = rtop;
+        fam->kdat[ndat] = ktop;
+        ndat = family_maximum_mass(fam, ndat, eos);
+    } else {
         fam->pdat = LALRealloc(fam->pdat, ndat * sizeof(*fam->pdat));
         fam->mdat = LALRealloc(fam->mdat, ndat * sizeof(*fam->mdat));
         fam->rdat = LALRealloc(fam->rdat, ndat * sizeof(*fam->rdat));
         fam->kdat = LALRealloc(fam->kdat, ndat * sizeof(*fam->kdat));
     }
-    fam->ndat = ndat;
 
     /* setup interpolators */
-
-    fam->p_of_m_acc = gsl_interp_accel_alloc();
-    fam->r_of_m_acc = gsl_interp_accel_alloc();
-    fam->k_of_m_acc = gsl_interp_accel_alloc();
-
-    fam->p_of_m_interp = gsl_interp_alloc(gsl_interp_cspline, ndat);
-    fam->r_of_m_interp = gsl_interp_alloc(lal_gsl_interp_steffen, ndat);
-    fam->k_of_m_interp = gsl_interp_alloc(lal_gsl_interp_steffen, ndat);
-
-    gsl_interp_init(fam->p_of_m_interp, fam->mdat, fam->pdat, ndat);
-    gsl_interp_init(fam->r_of_m_interp, fam->mdat, fam->rdat, ndat);
-    gsl_interp_init(fam->k_of_m_interp, fam->mdat, fam->kdat, ndat);
+    family_init_interp(fam, ndat);
 
     return fam;
 }
@@ -253,4 +555,156 @@ double XLALSimNeutronStarLoveNumberK2(double m, LALSimNeutronStarFamily * fam)
     return k;
 }
 
+/**
+ * @brief Returns the dimensionless tidal deformability of a neutron star of
+ * mass @a m.
+ * @details
+ * The dimensionless quadrupolar tidal deformability is
+ * \f$\Lambda = \frac{2}{3} k_2 (R c^2 / G m)^5\f$, as used for the
+ * lambda2Tidal argument of the universal relations.
+ * @param m The mass of the neutron star (kg).
+ * @param fam Pointer to the neutron star family structure.
+ * @return The dimensionless tidal deformability.
+ */
+double XLALSimNeutronStarTidalDeformability(double m,
+    LALSimNeutronStarFamily * fam)
+{
+    double r = XLALSimNeutronStarRadius(m, fam);
+    double k = XLALSimNeutronStarLoveNumberK2(m, fam);
+    double c = m * LAL_MRSUN_SI / (LAL_MSUN_SI * r);
+    return (2.0 / 3.0) * k / pow(c, 5.0);
+}
+
+/**
+ * @brief Creates a cache of neutron star families.
+ * @details
+ * The cache holds up to @a size equations of state together with their
+ * neutron star families, keyed by the parameters of the equation of state,
+ * so that repeated requests for the same (or nearly the same) equation of
+ * state need not repeat the TOV integrations.  Two keys match if every
+ * element agrees to within the relative tolerance @a tolerance; a tolerance
+ * of zero requires exact agreement.  When the cache is full the least
+ * recently used entry is discarded.  A cache must not be shared between
+ * threads without external locking.
+ * @param size Maximum number of entries in the cache.
+ * @param tolerance Relative tolerance for matching keys.
+ * @return A pointer to the neutron star family cache.
+ */
+LALSimNeutronStarFamilyCache * XLALCreateSimNeutronStarFamilyCache(
+    size_t size, double tolerance)
+{
+    LALSimNeutronStarFamilyCache *cache;
+    XLAL_CHECK_NULL(size > 0, XLAL_EINVAL, "Cache size must be positive");
+    XLAL_CHECK_NULL(tolerance >= 0, XLAL_EINVAL, "Tolerance must not be negative");
+    cache = LALCalloc(1, sizeof(*cache));
+    if (!cache)
+        XLAL_ERROR_NULL(XLAL_ENOMEM);
+    cache->entry = LALCalloc(size, sizeof(*cache->entry));
+    if (!cache->entry) {
+        LALFree(cache);
+        XLAL_ERROR_NULL(XLAL_ENOMEM);
+    }
+    cache->size = size;
+    cache->tolerance = tolerance;
+    return cache;
+}
+
+/**
+ * @brief Frees a neutron star family cache together with all the equations
+ * of state and families it holds.
+ * @param cache Pointer to the neutron star family cache.
+ */
+void XLALDestroySimNeutronStarFamilyCache(LALSimNeutronStarFamilyCache *
+    cache)
+{
+    if (cache) {
+        size_t i;
+        for (i = 0; i < cache->length; ++i) {
+            XLALDestroySimNeutronStarFamily(cache->entry[i].fam);
+            XLALDestroySimNeutronStarEOS(cache->entry[i].eos);
+            LALFree(cache->entry[i].key);
+        }
+        LALFree(cache->entry);
+        LALFree(cache);
+    }
+    return;
+}
+
+/**
+ * @brief Looks up the neutron star family of an equation of state in a
+ * cache.
+ * @param[out] eos If not NULL, set to the cached equation of state.
+ * @param cache Pointer to the neutron star family cache.
+ * @param[in] key Parameters of the equation of state.
+ * @param[in] nkey Number of parameters.
+ * @return A pointer to the cached neutron star family, or NULL if there is
+ * none for this key.  The family and equation of state remain owned by the
+ * cache, and are destroyed when they are evicted by a later insertion.
+ */
+LALSimNeutronStarFamily * XLALSimNeutronStarFamilyCacheLookup(
+    LALSimNeutronStarEOS ** eos, LALSimNeutronStarFamilyCache * cache,
+    const double *key, size_t nkey)
+{
+    size_t i;
+    XLAL_CHECK_NULL(cache && (key || nkey == 0), XLAL_EFAULT);
+    for (i = 0; i < cache->length; ++i)
+        if (cache->entry[i].nkey == nkey
+            && family_cache_match(cache->entry[i].key, key, nkey, cache->tolerance)) {
+            cache->entry[i].used = ++cache->clock;
+            if (eos)
+                *eos = cache->entry[i].eos;
+            return cache->entry[i].fam;
+        }
+    return NULL;
+}
+
+/**
+ * @brief Inserts an equation of state and its neutron star family into a
+ * cache.
+ * @details
+ * On success the cache takes ownership of @a eos and @a fam.  If the cache
+ * is full, the least recently used entry is destroyed to make room.
+ * @param cache Pointer to the neutron star family cache.
+ * @param[in] key Parameters of the equation of state.
+ * @param[in] nkey Number of parameters.
+ * @param eos Pointer to the equation of state.
+ * @param fam Pointer to the neutron star family of @a eos.
+ * @retval 0 Success.
+ * @retval <0 Failure.
+ */
+int XLALSimNeutronStarFamilyCacheInsert(LALSimNeutronStarFamilyCache * cache,
+    const double *key, size_t nkey, LALSimNeutronStarEOS * eos,
+    LALSimNeutronStarFamily * fam)
+{
+    double *copy = NULL;
+    size_t i, j;
+
+    XLAL_CHECK(cache && (key || nkey == 0) && eos && fam, XLAL_EFAULT);
+    if (nkey > 0) {
+        copy = LALMalloc(nkey * sizeof(*copy));
+        if (!copy)
+            XLAL_ERROR(XLAL_ENOMEM);
+        memcpy(copy, key, nkey * sizeof(*copy));
+    }
+
+    if (cache->length < cache->size)
+        j = cache->length++;
+    else {
+        /* evict the least recently used entry */
+        for (i = 1, j = 0; i < cache->length; ++i)
+            if (cache->entry[i].used < cache->entry[j].used)
+                j = i;
+        XLALDestroySimNeutronStarFamily(cache->entry[j].fam);
+        XLALDestroySimNeutronStarEOS(cache->entry[j].eos);
+        LALFree(cache->entry[j].key);
+    }
+
+    cache->entry[j].key = copy;
+    cache->entry[j].nkey = nkey;
+    cache->entry[j].used = ++cache->clock;
+    cache->entry[j].eos = eos;
+    cache->entry[j].fam = fam;
+    return 0;
+}
+
 /** @} */
@@ -88,13 +88,13 @@ static int tov_ode(double h, const double *y, double *dy, void *params)
     double m = vars->m;
     double H = vars->H;
     double b = vars->b;
-    double p =
-        XLALSimNeutronStarEOSPressureOfPseudoEnthalpyGeometerized(h, eos);
-    double e =
-        XLALSimNeutronStarEOSEnergyDensityOfPseudoEnthalpyGeometerized(h,
-        eos);
-    double dedp =
-        XLALSimNeutronStarEOSEnergyDensityDerivOfPressureGeometerized(p, eos);
+    double p, e, dedp;
+    /* pressure and energy density share one lookup in a tabulated EOS */
+    if (XLALSimNeutronStarEOSStateOfPseudoEnthalpyGeometerized(&p, &e, NULL,
+            &h, 1, eos) < 0
+        || XLALSimNeutronStarEOSStateOfPressureGeometerized(NULL, NULL,
+            &dedp, &p, 1, eos) < 0)
+        return GSL_EBADFUNC;
     /* Eq. (18) of Damour & Nagar PRD 80 084035 (2009). */
     double A = 1.0 / (1.0 - 2.0 * m / r);
     /* Eq. (28) of Damour & Nagar PRD 80 084035 (2009). */
@@ -259,13 +259,13 @@ static int tov_virial_ode(double h, const double *y, double *dy, void *params)
     double m = vars->m;
     double H = vars->H;
     double b = vars->b;
-    double p =
-        XLALSimNeutronStarEOSPressureOfPseudoEnthalpyGeometerized(h, eos);
-    double e =
-        XLALSimNeutronStarEOSEnergyDensityOfPseudoEnthalpyGeometerized(h,
-        eos);
-    double dedp =
-        XLALSimNeutronStarEOSEnergyDensityDerivOfPressureGeometerized(p, eos);
+    double p, e, dedp;
+    /* pressure and energy density share one lookup in a tabulated EOS */
+    if (XLALSimNeutronStarEOSStateOfPseudoEnthalpyGeometerized(&p, &e, NULL,
+            &h, 1, eos) < 0
+        || XLALSimNeutronStarEOSStateOfPressureGeometerized(NULL, NULL,
+            &dedp, &p, 1, eos) < 0)
+        return GSL_EBADFUNC;
     /* Eq. (18) of Damour & Nagar PRD 80 084035 (2009). */
     double A = 1.0 / (1.0 - 2.0 * m / r);
     /* Eq. (28) of Damour & Nagar PRD 80 084035 (2009). */
@@ -28,6 +28,7 @@
 #include <lal/LALStdlib.h>
 #include <lal/FrequencySeries.h>
 #include <lal/Sequence.h>
+#include <lal/SeqFactories.h>
 #include <lal/TimeSeries.h>
 #include <lal/TimeFreqFFT.h>
 #include <lal/Units.h>
@@ -197,6 +198,268 @@ int XLALSimNoise(
 	return 0;
 }
 
+
+/*
+ * Counter-based random numbers for the noise generator.  The Philox4x32-10
+ * generator of Salmon et al., "Parallel random numbers: as easy as 1, 2,
+ * 3", SC11 (2011), maps a 128-bit counter and a 64-bit key to 128 random
+ * bits.  With (frequency bin, segment number, channel) as the counter and
+ * the seed as the key every frequency bin of every segment of every
+ * channel has its own random numbers, whatever order, and whatever thread,
+ * they are generated in.
+ */
+static void philox4x32(UINT4 ctr[4], const UINT4 key[2])
+{
+	UINT4 k0 = key[0];
+	UINT4 k1 = key[1];
+	int r;
+
+	for (r = 0; r < 10; ++r) {
+		const UINT8 p0 = (UINT8)0xD2511F53 * ctr[0];
+		const UINT8 p1 = (UINT8)0xCD9E8D57 * ctr[2];
+		const UINT4 c0 = (UINT4)(p1 >> 32) ^ ctr[1] ^ k0;
+		const UINT4 c2 = (UINT4)(p0 >> 32) ^ ctr[3] ^ k1;
+		ctr[1] = (UINT4)p1;
+		ctr[3] = (UINT4)p0;
+		ctr[0] = c0;
+		ctr[2] = c2;
+		k0 += 0x9E3779B9;
+		k1 += 0xBB67AE85;
+	}
+}
+
+/* a pair of independent unit-variance Gaussian deviates from 128 random bits (Box-Muller) */
+static COMPLEX16 philox_gaussian_pair(const UINT4 bits[4])
+{
+	/* uniform deviates on (0,1] with 53 bits of precision */
+	const double u1 = ((((UINT8)bits[0] << 32 | bits[1]) >> 11) + 1) * 0x1p-53;
+	const double u2 = ((((UINT8)bits[2] << 32 | bits[3]) >> 11) + 1) * 0x1p-53;
+	const double r = sqrt(-2.0 * log(u1));
+	return crect(r * cos(LAL_TWOPI * u2), r * sin(LAL_TWOPI * u2));
+}
+
+/** Multi-channel streaming noise generator; see XLALSimNoiseGeneratorCreate() */
+struct tagLALSimNoiseGenerator {
+	UINT4 nchannels;		/* number of channels */
+	size_t length;			/* segment length (samples) */
+	size_t stride;			/* block length (samples) */
+	REAL8 deltaT;			/* sample interval */
+	LIGOTimeGPS epoch;		/* epoch of the next block */
+	LALUnit sampleUnits;		/* units of the noise */
+	UINT4 key[2];			/* random number key (seed) */
+	UINT8 segment;			/* number of blocks generated so far */
+	REAL8VectorSequence *sigma;	/* standard deviation of each frequency bin of each channel */
+	REAL8VectorSequence *data;	/* current segment of each channel */
+	REAL8VectorSequence *overlap;	/* overlap of the previous segment of each channel */
+	size_t noverlap;		/* overlap length (samples); the full segment if stride = length */
+	COMPLEX16VectorSequence *stilde; /* frequency domain workspace of each channel */
+	REAL8FFTPlan *plan;		/* reverse FFT plan shared by all channels */
+};
+
+/*
+ * Generates realisation number draw of channel c in gen->data; like
+ * XLALSimNoiseSegment(), the segment is periodic.
+ */
+static int XLALSimNoiseGeneratorSegment(LALSimNoiseGenerator *gen, UINT4 c, UINT8 draw)
+{
+	const size_t nbin = gen->length / 2 + 1;
+	const REAL8 deltaF = 1.0 / (gen->length * gen->deltaT);
+	const REAL8 *sigma = gen->sigma->data + c * nbin;
+	COMPLEX16Vector stilde = { nbin, gen->stilde->data + c * nbin };
+	REAL8Vector data = { gen->length, gen->data->data + c * gen->length };
+	size_t k;
+
+	for (k = 0; k < nbin; ++k) {
+		UINT4 ctr[4] = { k, draw, draw >> 32, c };
+		philox4x32(ctr, gen->key);
+		stilde.data[k] = sigma[k] * philox_gaussian_pair(ctr);
+	}
+
+	/* the DC component is zero, and the Nyquist component of a
+	 * segment of even length is real */
+	stilde.data[0] = 0.0;
+	if (gen->length % 2 == 0)
+		stilde.data[nbin - 1] = creal(stilde.data[nbin - 1]);
+
+	if (XLALREAL8ReverseFFT(&data, &stilde, gen->plan) < 0)
+		XLAL_ERROR(XLAL_EFUNC);
+	for (k = 0; k < data.length; ++k)
+		data.data[k] *= deltaF;
+
+	return 0;
+}
+
+/*
+ * Advances channel c of the generator by one stride, generating a new
+ * segment and feathering it into the overlap with the old one, as
+ * XLALSimNoise() does; on the first call just generates a segment.  If
+ * the stride is the segment length, every block is made, as XLALSimNoise()
+ * does, from two independent realisations feathered together over the
+ * whole segment, so that it is not periodic.
+ */
+static int XLALSimNoiseGeneratorAdvance(LALSimNoiseGenerator *gen, UINT4 c)
+{
+	const size_t noverlap = gen->noverlap;
+	REAL8 *data = gen->data->data + c * gen->length;
+	REAL8 *overlap = gen->overlap->data + c * noverlap;
+	UINT8 draw = gen->segment;
+	size_t j;
+
+	if (gen->stride == gen->length) {
+		draw = 2 * gen->segment;
+		if (XLALSimNoiseGeneratorSegment(gen, c, draw++) < 0)
+			XLAL_ERROR(XLAL_EFUNC);
+	} else if (gen->segment == 0)
+		return XLALSimNoiseGeneratorSegment(gen, c, draw);
+
+	memcpy(overlap, data + gen->length - noverlap, noverlap * sizeof(*overlap));
+	if (XLALSimNoiseGeneratorSegment(gen, c, draw) < 0)
+		XLAL_ERROR(XLAL_EFUNC);
+	for (j = 0; j < noverlap; ++j) {
+		double x = cos(LAL_PI*j/(2.0 * noverlap));
+		double y = sin(LAL_PI*j/(2.0 * noverlap));
+		data[j] = x*overlap[j] + y*data[j];
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Creates a generator of continuous streams of noise in several
+ * channels.
+ *
+ * The noise of each channel is made the same way as by calling
+ * XLALSimNoise() repeatedly with segments of the given length and stride,
+ * one block of stride samples of every channel at a time, with
+ * XLALSimNoiseGeneratorNext(); only the random numbers differ.  In
+ * particular, if the stride equals the length, each block is an
+ * independent, non-periodic segment made by feathering two realisations
+ * together.  Only one segment of each channel is held in
+ * memory, so streams of any duration can be written out block by block.
+ *
+ * Random numbers are drawn from a counter-based generator keyed by seed, so
+ * the noise depends only on the seed, the PSDs, the segment length and the
+ * stride.  In particular, it does not depend on the number of OpenMP
+ * threads the channels and frequency bins are processed with.
+ *
+ * @returns The generator, to be freed with XLALSimNoiseGeneratorDestroy(),
+ * or NULL on failure.
+ */
+LALSimNoiseGenerator *XLALSimNoiseGeneratorCreate(
+	const REAL8FrequencySeries * const *psds,	/**< [in] power spectrum of each channel */
+	UINT4 nchannels,			/**< [in] number of channels */
+	const LIGOTimeGPS *epoch,		/**< [in] start time of the noise */
+	REAL8 deltaT,				/**< [in] sample interval */
+	size_t length,				/**< [in] segment length (samples) */
+	size_t stride,				/**< [in] block length (samples) */
+	UINT8 seed				/**< [in] random number seed */
+)
+{
+	LALSimNoiseGenerator *gen;
+	const size_t nbin = length / 2 + 1;
+	UINT4 c;
+	size_t k;
+
+	XLAL_CHECK_NULL(psds && epoch, XLAL_EFAULT);
+	XLAL_CHECK_NULL(nchannels > 0 && length > 0 && deltaT > 0.0, XLAL_EINVAL);
+	XLAL_CHECK_NULL(stride > 0 && stride <= length, XLAL_EINVAL, "stride must be between 1 and the segment length");
+	for (c = 0; c < nchannels; ++c) {
+		const REAL8FrequencySeries *psd = psds[c];
+		XLAL_CHECK_NULL(psd && psd->data, XLAL_EFAULT);
+		/* make sure that the resolution of the frequency series is
+		 * commensurate with the requested time series */
+		XLAL_CHECK_NULL(psd->data->length == nbin && (size_t)floor(0.5 + 1.0/(deltaT * psd->deltaF)) == length, XLAL_EINVAL, "PSD of channel %u does not match the segment length", c);
+		XLAL_CHECK_NULL(XLALUnitCompare(&psd->sampleUnits, &psds[0]->sampleUnits) == 0, XLAL_EUNIT);
+	}
+
+	gen = XLALCalloc(1, sizeof(*gen));
+	XLAL_CHECK_NULL(gen, XLAL_ENOMEM);
+	gen->nchannels = nchannels;
+	gen->length = length;
+	gen->stride = stride;
+	gen->deltaT = deltaT;
+	gen->epoch = *epoch;
+	gen->key[0] = seed;
+	gen->key[1] = seed >> 32;
+	gen->sigma = XLALCreateREAL8VectorSequence(nchannels, nbin);
+	gen->data = XLALCreateREAL8VectorSequence(nchannels, length);
+	gen->noverlap = stride < length ? length - stride : length;
+	gen->overlap = XLALCreateREAL8VectorSequence(nchannels, gen->noverlap);
+	gen->stilde = XLALCreateCOMPLEX16VectorSequence(nchannels, nbin);
+	gen->plan = XLALCreateReverseREAL8FFTPlan(length, 0);
+	if (!gen->sigma || !gen->data || !gen->overlap || !gen->stilde || !gen->plan) {
+		XLALSimNoiseGeneratorDestroy(gen);
+		XLAL_ERROR_NULL(XLAL_EFUNC);
+	}
+
+	/* units: [noise] = sqrt([psd] * seconds) * Hz */
+	XLALUnitMultiply(&gen->sampleUnits, &psds[0]->sampleUnits, &lalSecondUnit);
+	XLALUnitSqrt(&gen->sampleUnits, &gen->sampleUnits);
+	XLALUnitMultiply(&gen->sampleUnits, &gen->sampleUnits, &lalHertzUnit);
+
+	for (c = 0; c < nchannels; ++c)
+		for (k = 0; k < nbin; ++k)
+			gen->sigma->data[c * nbin + k] = 0.5 * sqrt(psds[c]->data->data[k] / psds[c]->deltaF);
+
+	return gen;
+}
+
+/** Frees a generator created with XLALSimNoiseGeneratorCreate(). */
+void XLALSimNoiseGeneratorDestroy(LALSimNoiseGenerator *gen)
+{
+	if (!gen)
+		return;
+	XLALDestroyREAL8VectorSequence(gen->sigma);
+	XLALDestroyREAL8VectorSequence(gen->data);
+	XLALDestroyREAL8VectorSequence(gen->overlap);
+	XLALDestroyCOMPLEX16VectorSequence(gen->stilde);
+	XLALDestroyREAL8FFTPlan(gen->plan);
+	XLALFree(gen);
+}
+
+/**
+ * @brief Generates the next block of noise of every channel.
+ *
+ * blocks must hold one time series of stride samples for each channel; their
+ * data, epoch, sample interval and units are set.  The channels are
+ * generated in parallel when OpenMP is enabled.
+ */
+int XLALSimNoiseGeneratorNext(
+	LALSimNoiseGenerator *gen,	/**< [in/out] noise generator */
+	REAL8TimeSeries **blocks	/**< [out] next block of each channel */
+)
+{
+	int errnum = XLAL_SUCCESS;
+	UINT4 c;
+
+	XLAL_CHECK(gen && blocks, XLAL_EFAULT);
+	for (c = 0; c < gen->nchannels; ++c) {
+		XLAL_CHECK(blocks[c] && blocks[c]->data, XLAL_EFAULT);
+		XLAL_CHECK(blocks[c]->data->length == gen->stride, XLAL_EBADLEN, "block of channel %u is not %zu samples long", c, gen->stride);
+	}
+
+#pragma omp parallel for schedule(dynamic)
+	for (c = 0; c < gen->nchannels; ++c) {
+		if (XLALGetCollectedErrno(&errnum) != XLAL_SUCCESS)
+			continue;
+		if (XLALSimNoiseGeneratorAdvance(gen, c) < 0) {
+			XLALCollectErrno(&errnum, XLAL_FAILURE);
+			continue;
+		}
+		memcpy(blocks[c]->data->data, gen->data->data + c * gen->length, gen->stride * sizeof(*blocks[c]->data->data));
+		blocks[c]->epoch = gen->epoch;
+		blocks[c]->deltaT = gen->deltaT;
+		blocks[c]->f0 = 0.0;
+		blocks[c]->sampleUnits = gen->sampleUnits;
+	}
+	XLAL_CHECK(errnum == XLAL_SUCCESS, errnum);
+
+	/* advance time */
+	gen->segment++;
+	XLALGPSAdd(&gen->epoch, gen->stride * gen->deltaT);
+	return 0;
+}
+
 /** @} */
 
 /*
@@ -70,6 +70,14 @@ SWIGLAL(FUNCTION_POINTER(aLIGOQuantumHighFrequency, XLALSimNoisePSDAdvVirgo,
 
 int XLALSimNoise(REAL8TimeSeries *s, size_t stride, REAL8FrequencySeries *psd, gsl_rng *rng);
 
+typedef struct tagLALSimNoiseGenerator LALSimNoiseGenerator;
+
+#ifndef SWIG /* exclude from SWIG interface */
+LALSimNoiseGenerator *XLALSimNoiseGeneratorCreate(const REAL8FrequencySeries * const *psds, UINT4 nchannels, const LIGOTimeGPS *epoch, REAL8 deltaT, size_t length, size_t stride, UINT8 seed);
+int XLALSimNoiseGeneratorNext(LALSimNoiseGenerator *gen, REAL8TimeSeries **blocks);
+#endif /* SWIG */
+void XLALSimNoiseGeneratorDestroy(LALSimNoiseGenerator *gen);
+
 
 /*
  * PSD GENERATION FUNCTIONS
@@ -198,66 +198,66 @@ static void highfreq_kernel(double *cached_kernel, int kernel_length, double res
 };
 
 
-/**
- * @brief Transforms the waveform polarizations into a detector strain
- * @details
- * This routine takes the plus and cross waveform polarizations, along
- * with the sky position, polarization angle, and detector structure,
- * and computes the external strain on the detector.
- *
- * The input time series should have their epochs set to the start of
- * those time series at the geocetre (for simplicity the epochs must be
- * the same, and they must have the same length and sample rates)
- *
- * @param[in] hplus Pointer to a REAL8TimeSeries containing the plus polarization waveform
- * @param[in] hcross Pointer to a REAL8TimeSeries containing the cross polarization waveform
- * @param[in] right_ascension The right ascension of the source in radians
- * @param[in] declination The declination of the source in radians
- * @param[in] psi The polarization angle giving the orientation of the wave co-ordinate system in radians
- * @param[in] detector Pointer to a LALDetector structure for the detector into which the injection is destined to be injected
- *
- * @returns
- * The strain time series as seen in the detector, with the epoch set to
- * the start of the time series at that detector.  The output time series
- * units are the same as the two input time series (which must both have
- * the same sample units).
- *
- * @retval NULL Failure
- *
- * @note
- * A 19-sample Welch-windowed sinc kernel is used for sub-sample
- * interpolation.  See XLALREAL8TimeSeriesInterpEval() for more
- * information, and consider the frequency response of this kernel when
- * using this function with injections whose frequency content approaches
- * the Nyquist frequency.
- * @n@n
- * The geometric delay and antenna response are only recalculated every 250
- * ms --- the Earth's rotation is modelled as discontinuous jumps occurring
- * at a rate of 4 Hz.  The Earth rotates at 7e-5 rad/s, therefore given a
- * radius of 6e6 m and c=3e8 m/s, the maximum geometric speed for points on
- * the surface is about 1.5 us/s.  Updating the detector response and
- * geometric delay every 250 ms means the antenna response is accurate to
- * about +/- 20 urad and the geometric delay to about +/- 300 ns (about
- * 0.01 sample at 32 kHz).  Because we use UTC (instead of UT1) sidereal
- * time is only accurate to +/- 900 ms, so assuming the Earth's orientation
- * to be fixed for 250 ms at a time is not the dominant source of Earth
- * orientation error in these calculations, but one should be aware of the
- * periodic nature of the updates if extreme phase stability is required.
- * @n@n
- * The output time series is padded to capture the interpolation kernel
- * structure resulting from possible sharp edges at the start or end of the
- * input time series data.  Neglecting the padding for the interpolation
- * kernel's impulse response, the output time series is, in general, not
- * the same duration as the input time series due to Doppler compression or
- * resulting from Earth rotation.
+/*
+ * Number of samples over which the antenna response and geometric delay
+ * of a detector are held constant:  0.25 s or 1 sample whichever is
+ * larger.  See XLALSimDetectorStrainREAL8TimeSeries().
  */
-REAL8TimeSeries *XLALSimDetectorStrainREAL8TimeSeries(
+
+
+static unsigned detector_response_interval(double deltaT)
+{
+	return round(0.25 / deltaT) < 1 ? 1 : round(0.25 / deltaT);
+}
+
+
+/*
+ * Greenwich mean sidereal times at the start of each interval of
+ * detector_response_interval() samples of hplus.  These do not depend on
+ * the detector, so they are computed once for a network of detectors.
+ * The result must be freed with XLALFree().
+ */
+
+
+static double *detector_response_gmst(const REAL8TimeSeries *hplus)
+{
+	const unsigned det_resp_interval = detector_response_interval(hplus->deltaT);
+	const unsigned n = (hplus->data->length + det_resp_interval - 1) / det_resp_interval;
+	double *gmst = XLALMalloc((n ? n : 1) * sizeof(*gmst));
+	unsigned k;
+
+	if(!gmst)
+		XLAL_ERROR_NULL(XLAL_EFUNC);
+	for(k = 0; k < n; k++) {
+		LIGOTimeGPS t = hplus->epoch;
+		if(!XLALGPSAdd(&t, k * det_resp_interval * hplus->deltaT)) {
+			XLALFree(gmst);
+			XLAL_ERROR_NULL(XLAL_EFUNC);
+		}
+		gmst[k] = XLALGreenwichMeanSiderealTime(&t);
+	}
+
+	return gmst;
+}
+
+
+/*
+ * Computes the strain in one detector;  the work shared by
+ * XLALSimDetectorStrainREAL8TimeSeries() and
+ * XLALSimDetectorStrainNetworkREAL8TimeSeries().  gmst is the output of
+ * detector_response_gmst() for hplus, or NULL to compute the sidereal
+ * times here.
+ */
+
+
+static REAL8TimeSeries *detector_strain_REAL8(
 	const REAL8TimeSeries *hplus,
 	const REAL8TimeSeries *hcross,
 	REAL8 right_ascension,
 	REAL8 declination,
 	REAL8 psi,
-	const LALDetector *detector
+	const LALDetector *detector,
+	const double *gmst
 )
 {
 	/* mean arm length in samples */
@@ -265,8 +265,7 @@ REAL8TimeSeries *XLALSimDetectorStrainREAL8TimeSeries(
 	/* kernel length in samples.  increase by 28 times the arm length
 	 * to accomodate the additional signal delay. */
 	const int kernel_length = 67 + 48 * lround(2.0 * arm_length_samples);
-	/* 0.25 s or 1 sample whichever is larger */
-	const unsigned det_resp_interval = round(0.25 / hplus->deltaT) < 1 ? 1 : round(0.25 / hplus->deltaT);
+	const unsigned det_resp_interval = detector_response_interval(hplus->deltaT);
 	REAL8TimeSeries *xsignal = NULL;
 	REAL8TimeSeries *ysignal = NULL;
 	LALREAL8TimeSeriesInterp *xinterp = NULL;
@@ -362,23 +361,40 @@ REAL8TimeSeries *XLALSimDetectorStrainREAL8TimeSeries(
 
 	xsignal = XLALCreateREAL8TimeSeries("xsignal", &hplus->epoch, hplus->f0, hplus->deltaT, &hplus->sampleUnits, (int) hplus->data->length);
 	ysignal = XLALCreateREAL8TimeSeries("ysignal", &hplus->epoch, hplus->f0, hplus->deltaT, &hplus->sampleUnits, (int) hplus->data->length);
-	for(i = 0; i < hplus->data->length; i++) {
-		t = hplus->epoch;
-		if(!XLALGPSAdd(&t, i * hplus->deltaT))
-			goto error;
+	if(!xsignal || !ysignal)
+		goto error;
+	/* the response is constant over each interval of
+	 * det_resp_interval samples, so it is computed once per interval
+	 * and applied to the whole interval in one loop */
+	for(i = 0; i < hplus->data->length; i += det_resp_interval) {
+		const unsigned end = hplus->data->length - i < det_resp_interval ? hplus->data->length : i + det_resp_interval;
+		const double *hp = hplus->data->data;
+		const double *hc = hcross->data->data;
+		double *x = xsignal->data->data;
+		double *y = ysignal->data->data;
+		double armlen = XLAL_REAL8_FAIL_NAN;
+		double xcos = XLAL_REAL8_FAIL_NAN;
+		double ycos = XLAL_REAL8_FAIL_NAN;
+		double gmst_i;
+		unsigned j;
 		/* Compute detector's response. Here the geometric delay
 		 * from geocenter is neglected since it is small compared
 		 * to the rotational period of the Earth */
-		if(!(i % det_resp_interval)) {
-			double armlen = XLAL_REAL8_FAIL_NAN;
-			double xcos = XLAL_REAL8_FAIL_NAN;
-			double ycos = XLAL_REAL8_FAIL_NAN;
-			XLALComputeDetAMResponseParts(&armlen, &xcos, &ycos, &fxplus, &fyplus, &fxcross, &fycross, detector, right_ascension, declination, psi, XLALGreenwichMeanSiderealTime(&t));
+		if(gmst)
+			gmst_i = gmst[i / det_resp_interval];
+		else {
+			t = hplus->epoch;
+			if(!XLALGPSAdd(&t, i * hplus->deltaT))
+				goto error;
+			gmst_i = XLALGreenwichMeanSiderealTime(&t);
 		}
-		xsignal->data->data[i] = fxplus * hplus->data->data[i] + fxcross * hcross->data->data[i];
-		ysignal->data->data[i] = fyplus * hplus->data->data[i] + fycross * hcross->data->data[i];
-		if(XLAL_IS_REAL8_FAIL_NAN(xsignal->data->data[i]) || XLAL_IS_REAL8_FAIL_NAN(ysignal->data->data[i]))
+		XLALComputeDetAMResponseParts(&armlen, &xcos, &ycos, &fxplus, &fyplus, &fxcross, &fycross, detector, right_ascension, declination, psi, gmst_i);
+		if(XLAL_IS_REAL8_FAIL_NAN(fxplus) || XLAL_IS_REAL8_FAIL_NAN(fxcross) || XLAL_IS_REAL8_FAIL_NAN(fyplus) || XLAL_IS_REAL8_FAIL_NAN(fycross))
 			goto error;
+		for(j = i; j < end; j++) {
+			x[j] = fxplus * hp[j] + fxcross * hc[j];
+			y[j] = fyplus * hp[j] + fycross * hc[j];
+		}
 	}
 
 	/* initialize interpolators. */
@@ -447,48 +463,280 @@ error:
 
 
 /**
- * @brief Adds a detector strain time series to detector data.
+ * @brief Transforms the waveform polarizations into a detector strain
  * @details
- * Essentially a wrapper for XLALAddREAL8TimeSeries(), but performs
- * sub-sample re-interpolation to adjust the source time series epoch to
- * lie on an integer sample boundary in the target time series.  This
- * transformation is done in the frequency domain, so it is convenient to
- * allow a response function to be applied at the same time.  Passing NULL
- * for the response function turns this feature off (i.e., uses a unit
- * response).
+ * This routine takes the plus and cross waveform polarizations, along
+ * with the sky position, polarization angle, and detector structure,
+ * and computes the external strain on the detector.
  *
- * This function accepts source and target time series whose units are not
- * the same, and allows the two time series to be herterodyned (although it
- * currently requires them to have the same heterodyne frequency).
+ * The input time series should have their epochs set to the start of
+ * those time series at the geocetre (for simplicity the epochs must be
+ * the same, and they must have the same length and sample rates)
  *
- * @param[in,out] target Pointer to the time series into which the strain will
- * be added
+ * @param[in] hplus Pointer to a REAL8TimeSeries containing the plus polarization waveform
+ * @param[in] hcross Pointer to a REAL8TimeSeries containing the cross polarization waveform
+ * @param[in] right_ascension The right ascension of the source in radians
+ * @param[in] declination The declination of the source in radians
+ * @param[in] psi The polarization angle giving the orientation of the wave co-ordinate system in radians
+ * @param[in] detector Pointer to a LALDetector structure for the detector into which the injection is destined to be injected
  *
- * @param[in,out] h Pointer to the time series containing the detector strain
- * (the strain data is modified by this routine)
+ * @returns
+ * The strain time series as seen in the detector, with the epoch set to
+ * the start of the time series at that detector.  The output time series
+ * units are the same as the two input time series (which must both have
+ * the same sample units).
  *
- * @param[in] response Pointer to the response function transforming strain to
- * detector output units, or NULL for unit response.
+ * @retval NULL Failure
+ *
+ * @note
+ * A 19-sample Welch-windowed sinc kernel is used for sub-sample
+ * interpolation.  See XLALREAL8TimeSeriesInterpEval() for more
+ * information, and consider the frequency response of this kernel when
+ * using this function with injections whose frequency content approaches
+ * the Nyquist frequency.
+ * @n@n
+ * The geometric delay and antenna response are only recalculated every 250
+ * ms --- the Earth's rotation is modelled as discontinuous jumps occurring
+ * at a rate of 4 Hz.  The Earth rotates at 7e-5 rad/s, therefore given a
+ * radius of 6e6 m and c=3e8 m/s, the maximum geometric speed for points on
+ * the surface is about 1.5 us/s.  Updating the detector response and
+ * geometric delay every 250 ms means the antenna response is accurate to
+ * about +/- 20 urad and the geometric delay to about +/- 300 ns (about
+ * 0.01 sample at 32 kHz).  Because we use UTC (instead of UT1) sidereal
+ * time is only accurate to +/- 900 ms, so assuming the Earth's orientation
+ * to be fixed for 250 ms at a time is not the dominant source of Earth
+ * orientation error in these calculations, but one should be aware of the
+ * periodic nature of the updates if extreme phase stability is required.
+ * @n@n
+ * The output time series is padded to capture the interpolation kernel
+ * structure resulting from possible sharp edges at the start or end of the
+ * input time series data.  Neglecting the padding for the interpolation
+ * kernel's impulse response, the output time series is, in general, not
+ * the same duration as the input time series due to Doppler compression or
+ * resulting from Earth rotation.
+ */
+REAL8TimeSeries *XLALSimDetectorStrainREAL8TimeSeries(
+	const REAL8TimeSeries *hplus,
+	const REAL8TimeSeries *hcross,
+	REAL8 right_ascension,
+	REAL8 declination,
+	REAL8 psi,
+	const LALDetector *detector
+)
+{
+	REAL8TimeSeries *h = detector_strain_REAL8(hplus, hcross, right_ascension, declination, psi, detector, NULL);
+	if(!h)
+		XLAL_ERROR_NULL(XLAL_EFUNC);
+	return h;
+}
+
+
+/**
+ * @brief Transforms the waveform polarizations into the strains in a
+ * network of detectors
+ * @details
+ * Equivalent to calling XLALSimDetectorStrainREAL8TimeSeries() for each of
+ * the detectors in turn, but the work that does not depend on the detector
+ * (the sidereal times at which the antenna responses are updated) is done
+ * once for the whole network, and the detectors are processed in parallel
+ * when OpenMP is enabled.
+ *
+ * @param[out] h Array of ndetectors pointers, which are set to the strain
+ * time series in each detector
+ * @param[in] hplus Pointer to a REAL8TimeSeries containing the plus polarization waveform
+ * @param[in] hcross Pointer to a REAL8TimeSeries containing the cross polarization waveform
+ * @param[in] right_ascension The right ascension of the source in radians
+ * @param[in] declination The declination of the source in radians
+ * @param[in] psi The polarization angle giving the orientation of the wave co-ordinate system in radians
+ * @param[in] detectors Array of ndetectors LALDetector structures for the detectors
+ * @param[in] ndetectors Number of detectors
  *
  * @retval 0 Success
- * @retval <0 Failure
+ * @retval <0 Failure, in which case all elements of h are NULL
  *
- * @attention
- * The source time series is modified in place by this function!
+ * @sa XLALSimDetectorStrainREAL8TimeSeries()
  */
-int XLALSimAddInjectionREAL8TimeSeries(
-	REAL8TimeSeries *target,
-	REAL8TimeSeries *h,
-	const COMPLEX16FrequencySeries *response
+int XLALSimDetectorStrainNetworkREAL8TimeSeries(
+	REAL8TimeSeries **h,
+	const REAL8TimeSeries *hplus,
+	const REAL8TimeSeries *hcross,
+	REAL8 right_ascension,
+	REAL8 declination,
+	REAL8 psi,
+	const LALDetector *detectors,
+	UINT4 ndetectors
 )
+{
+	int errnum = XLAL_SUCCESS;
+	double *gmst;
+	UINT4 k;
+
+	/* check input */
+
+	if(!h || (ndetectors && !detectors))
+		XLAL_ERROR(XLAL_EFAULT);
+	for(k = 0; k < ndetectors; k++)
+		h[k] = NULL;
+	LAL_CHECK_VALID_SERIES(hplus, XLAL_FAILURE);
+	LAL_CHECK_VALID_SERIES(hcross, XLAL_FAILURE);
+	LAL_CHECK_CONSISTENT_TIME_SERIES(hplus, hcross, XLAL_FAILURE);
+
+	/* sidereal times shared by all detectors */
+
+	gmst = detector_response_gmst(hplus);
+	if(!gmst)
+		XLAL_ERROR(XLAL_EFUNC);
+
+#pragma omp parallel for schedule(dynamic)
+	for(k = 0; k < ndetectors; k++) {
+		if(XLALGetCollectedErrno(&errnum) != XLAL_SUCCESS)
+			continue;
+		h[k] = detector_strain_REAL8(hplus, hcross, right_ascension, declination, psi, &detectors[k], gmst);
+		if(!h[k])
+			XLALCollectErrno(&errnum, XLAL_FAILURE);
+	}
+
+	XLALFree(gmst);
+	if(errnum != XLAL_SUCCESS) {
+		for(k = 0; k < ndetectors; k++) {
+			XLALDestroyREAL8TimeSeries(h[k]);
+			h[k] = NULL;
+		}
+		XLAL_ERROR(errnum);
+	}
+
+	return 0;
+}
+
+
+/*
+ * Sub-sample re-interpolation of injections.  The source time series is
+ * padded with at least this many 0's at the start and end before
+ * re-interpolation in an attempt to suppress aperiodicity artifacts, and
+ * 1/2 this many samples is clipped from the start and end afterwards.
+ */
+
+
+#define INJECTION_APERIODICITY_SUPPRESSION_BUFFER 32768
+
+
+/*
+ * compute the integer and fractional parts of the sample index in the
+ * target time series on which the source time series begins.  modf()
+ * returns integer and fractional parts that have the same sign, e.g. -3.9
+ * --> -3 + -0.9.  we adjust these so that the magnitude of the fractional
+ * part is not greater than 0.5, e.g.  -3.9 --> -4 + 0.1, so that we never
+ * do more than 1/2 a sample of re-interpolation.  I don't know if really
+ * makes any difference, though
+ */
+
+
+static void injection_start_sample(const REAL8TimeSeries *target, const REAL8TimeSeries *h, double *start_sample_int, double *start_sample_frac)
+{
+	*start_sample_frac = modf(XLALGPSDiff(&h->epoch, &target->epoch) / target->deltaT, start_sample_int);
+	if(*start_sample_frac < -0.5) {
+		*start_sample_frac += 1.0;
+		*start_sample_int -= 1.0;
+	} else if(*start_sample_frac > +0.5) {
+		*start_sample_frac -= 1.0;
+		*start_sample_int += 1.0;
+	}
+}
+
+
+/*
+ * whether the source must be re-interpolated in the frequency domain
+ */
+
+
+static int injection_needs_interpolation(double start_sample_frac, const COMPLEX16FrequencySeries *response)
 {
 	/* 1 ns is about 10^-5 samples at 16384 Hz */
 	const double noop_threshold = 1e-4;	/* samples */
-	/* the source time series is padded with at least this many 0's at
-	 * the start and end before re-interpolation in an attempt to
-	 * suppress aperiodicity artifacts, and 1/2 this many samples is
-	 * clipped from the start and end afterwards */
-	const unsigned aperiodicity_suppression_buffer = 32768;
+
+	return fabs(start_sample_frac) > noop_threshold || response;
+}
+
+
+/*
+ * length of a source time series of the given length once padded for
+ * re-interpolation;  less than length on integer overflow
+ */
+
+
+static unsigned injection_padded_length(unsigned length)
+{
+	return round_up_to_power_of_two(length + 2 * INJECTION_APERIODICITY_SUPPRESSION_BUFFER);
+}
+
+
+/*
+ * Tukey window applied to the re-interpolated source time series once
+ * half of the padding has been clipped, leaving the given length.  its
+ * tapers lie within the remaining aperiodicity padding, leaving one sample
+ * of the aperiodicty padding untouched on each side of the original time
+ * series because the data might have been shifted into it
+ */
+
+
+static REAL8Window *injection_window(unsigned length)
+{
+	return XLALCreateTukeyREAL8Window(length, (double) (INJECTION_APERIODICITY_SUPPRESSION_BUFFER - 2) / length);
+}
+
+
+/*
+ * FFT plans and window for re-interpolating sources of one padded length,
+ * shared by the detectors of a network
+ */
+
+
+struct injection_plans {
+	unsigned length;
+	REAL8FFTPlan *fwdplan;
+	REAL8FFTPlan *revplan;
+	REAL8Window *window;
+};
+
+
+static void injection_plans_free(struct injection_plans *plans)
+{
+	XLALDestroyREAL8FFTPlan(plans->fwdplan);
+	XLALDestroyREAL8FFTPlan(plans->revplan);
+	XLALDestroyREAL8Window(plans->window);
+	memset(plans, 0, sizeof(*plans));
+}
+
+
+static int injection_plans_init(struct injection_plans *plans, unsigned length)
+{
+	plans->length = length;
+	plans->fwdplan = XLALCreateForwardREAL8FFTPlan(length, 0);
+	plans->revplan = XLALCreateReverseREAL8FFTPlan(length, 0);
+	plans->window = injection_window(length - INJECTION_APERIODICITY_SUPPRESSION_BUFFER);
+	if(!plans->fwdplan || !plans->revplan || !plans->window) {
+		injection_plans_free(plans);
+		XLAL_ERROR(XLAL_EFUNC);
+	}
+	return 0;
+}
+
+
+/*
+ * Adds one detector strain time series to detector data;  the work shared
+ * by XLALSimAddInjectionREAL8TimeSeries() and
+ * XLALSimAddInjectionNetworkREAL8TimeSeries().  plans may be NULL, or
+ * FFT plans and window to use if the padded source has their length.
+ */
+
+
+static int add_injection_REAL8(
+	REAL8TimeSeries *target,
+	REAL8TimeSeries *h,
+	const COMPLEX16FrequencySeries *response,
+	const struct injection_plans *plans
+)
+{
 	double start_sample_int;
 	double start_sample_frac;
 
@@ -504,30 +752,16 @@ int XLALSimAddInjectionREAL8TimeSeries(
 		XLAL_ERROR(XLAL_EINVAL);
 	}
 
-	/* compute the integer and fractional parts of the sample index in
-	 * the target time series on which the source time series begins.
-	 * modf() returns integer and fractional parts that have the same
-	 * sign, e.g. -3.9 --> -3 + -0.9.  we adjust these so that the
-	 * magnitude of the fractional part is not greater than 0.5, e.g.
-	 * -3.9 --> -4 + 0.1, so that we never do more than 1/2 a sample of
-	 * re-interpolation.  I don't know if really makes any difference,
-	 * though */
-
-	start_sample_frac = modf(XLALGPSDiff(&h->epoch, &target->epoch) / target->deltaT, &start_sample_int);
-	if(start_sample_frac < -0.5) {
-		start_sample_frac += 1.0;
-		start_sample_int -= 1.0;
-	} else if(start_sample_frac > +0.5) {
-		start_sample_frac -= 1.0;
-		start_sample_int += 1.0;
-	}
+	injection_start_sample(target, h, &start_sample_int, &start_sample_frac);
 
 	/* perform sub-sample interpolation if needed */
 
-	if(fabs(start_sample_frac) > noop_threshold || response) {
+	if(injection_needs_interpolation(start_sample_frac, response)) {
 		COMPLEX16FrequencySeries *tilde_h;
-		REAL8FFTPlan *plan;
-		REAL8Window *window;
+		REAL8FFTPlan *fwdplan = NULL;
+		REAL8FFTPlan *revplan = NULL;
+		const REAL8Window *window = NULL;
+		REAL8Window *own_window = NULL;
 		unsigned i;
 
 		/* extend the source time series by adding the
@@ -536,7 +770,7 @@ int XLALSimAddInjectionREAL8TimeSeries(
 		 * of two, and don't forget to adjust the start index in
 		 * the target time series. */
 
-		i = round_up_to_power_of_two(h->data->length + 2 * aperiodicity_suppression_buffer);
+		i = injection_padded_length(h->data->length);
 		if(i < h->data->length) {
 			/* integer overflow */
 			XLALPrintError("%s(): error: source time series too long\n", __func__);
@@ -546,19 +780,33 @@ int XLALSimAddInjectionREAL8TimeSeries(
 		if(!XLALResizeREAL8TimeSeries(h, -(int) (i - h->data->length) / 2, i))
 			XLAL_ERROR(XLAL_EFUNC);
 
+		/* use the caller's FFT plans and window if they are for
+		 * this length, otherwise make our own */
+
+		if(plans && plans->length == h->data->length) {
+			fwdplan = plans->fwdplan;
+			revplan = plans->revplan;
+			window = plans->window;
+		}
+
 		/* transform source time series to frequency domain.  the
 		 * FFT function populates the frequency series' metadata
 		 * with the appropriate values. */
 
 		tilde_h = XLALCreateCOMPLEX16FrequencySeries(NULL, &h->epoch, 0, 0, &lalDimensionlessUnit, h->data->length / 2 + 1);
-		plan = XLALCreateForwardREAL8FFTPlan(h->data->length, 0);
-		if(!tilde_h || !plan) {
-			XLALDestroyCOMPLEX16FrequencySeries(tilde_h);
-			XLALDestroyREAL8FFTPlan(plan);
+		if(!tilde_h)
 			XLAL_ERROR(XLAL_EFUNC);
+		if(fwdplan)
+			i = XLALREAL8TimeFreqFFT(tilde_h, h, fwdplan);
+		else {
+			REAL8FFTPlan *plan = XLALCreateForwardREAL8FFTPlan(h->data->length, 0);
+			if(!plan) {
+				XLALDestroyCOMPLEX16FrequencySeries(tilde_h);
+				XLAL_ERROR(XLAL_EFUNC);
+			}
+			i = XLALREAL8TimeFreqFFT(tilde_h, h, plan);
+			XLALDestroyREAL8FFTPlan(plan);
 		}
-		i = XLALREAL8TimeFreqFFT(tilde_h, h, plan);
-		XLALDestroyREAL8FFTPlan(plan);
 		if(i) {
 			XLALDestroyCOMPLEX16FrequencySeries(tilde_h);
 			XLAL_ERROR(XLAL_EFUNC);
@@ -632,13 +880,17 @@ int XLALSimAddInjectionREAL8TimeSeries(
 
 		/* return to time domain */
 
-		plan = XLALCreateReverseREAL8FFTPlan(h->data->length, 0);
-		if(!plan) {
-			XLALDestroyCOMPLEX16FrequencySeries(tilde_h);
-			XLAL_ERROR(XLAL_EFUNC);
+		if(revplan)
+			i = XLALREAL8FreqTimeFFT(h, tilde_h, revplan);
+		else {
+			REAL8FFTPlan *plan = XLALCreateReverseREAL8FFTPlan(h->data->length, 0);
+			if(!plan) {
+				XLALDestroyCOMPLEX16FrequencySeries(tilde_h);
+				XLAL_ERROR(XLAL_EFUNC);
+			}
+			i = XLALREAL8FreqTimeFFT(h, tilde_h, plan);
+			XLALDestroyREAL8FFTPlan(plan);
 		}
-		i = XLALREAL8FreqTimeFFT(h, tilde_h, plan);
-		XLALDestroyREAL8FFTPlan(plan);
 		XLALDestroyCOMPLEX16FrequencySeries(tilde_h);
 		if(i)
 			XLAL_ERROR(XLAL_EFUNC);
@@ -668,7 +920,7 @@ int XLALSimAddInjectionREAL8TimeSeries(
 		 * and end of the source time series in a continuing effort
 		 * to suppress aperiodicity artifacts. */
 
-		if(!XLALResizeREAL8TimeSeries(h, aperiodicity_suppression_buffer / 2, h->data->length - aperiodicity_suppression_buffer))
+		if(!XLALResizeREAL8TimeSeries(h, INJECTION_APERIODICITY_SUPPRESSION_BUFFER / 2, h->data->length - INJECTION_APERIODICITY_SUPPRESSION_BUFFER))
 			XLAL_ERROR(XLAL_EFUNC);
 
 		/* apply a Tukey window whose tapers lie within the
@@ -677,12 +929,14 @@ int XLALSimAddInjectionREAL8TimeSeries(
 		 * original time series because the data might have been
 		 * shifted into it */
 
-		window = XLALCreateTukeyREAL8Window(h->data->length, (double) (aperiodicity_suppression_buffer - 2) / h->data->length);
-		if(!window)
-			XLAL_ERROR(XLAL_EFUNC);
+		if(!window) {
+			window = own_window = injection_window(h->data->length);
+			if(!window)
+				XLAL_ERROR(XLAL_EFUNC);
+		}
 		for(i = 0; i < h->data->length; i++)
 			h->data->data[i] *= window->data->data[i];
-		XLALDestroyREAL8Window(window);
+		XLALDestroyREAL8Window(own_window);
 	}
 
 	/* add source time series to target time series */
@@ -696,6 +950,208 @@ int XLALSimAddInjectionREAL8TimeSeries(
 }
 
 
+/**
+ * @brief Adds a detector strain time series to detector data.
+ * @details
+ * Essentially a wrapper for XLALAddREAL8TimeSeries(), but performs
+ * sub-sample re-interpolation to adjust the source time series epoch to
+ * lie on an integer sample boundary in the target time series.  This
+ * transformation is done in the frequency domain, so it is convenient to
+ * allow a response function to be applied at the same time.  Passing NULL
+ * for the response function turns this feature off (i.e., uses a unit
+ * response).
+ *
+ * This function accepts source and target time series whose units are not
+ * the same, and allows the two time series to be herterodyned (although it
+ * currently requires them to have the same heterodyne frequency).
+ *
+ * @param[in,out] target Pointer to the time series into which the strain will
+ * be added
+ *
+ * @param[in,out] h Pointer to the time series containing the detector strain
+ * (the strain data is modified by this routine)
+ *
+ * @param[in] response Pointer to the response function transforming strain to
+ * detector output units, or NULL for unit response.
+ *
+ * @retval 0 Success
+ * @retval <0 Failure
+ *
+ * @attention
+ * The source time series is modified in place by this function!
+ */
+int XLALSimAddInjectionREAL8TimeSeries(
+	REAL8TimeSeries *target,
+	REAL8TimeSeries *h,
+	const COMPLEX16FrequencySeries *response
+)
+{
+	if(add_injection_REAL8(target, h, response, NULL))
+		XLAL_ERROR(XLAL_EFUNC);
+	return 0;
+}
+
+
+/**
+ * @brief Adds detector strain time series to the data of a network of
+ * detectors.
+ * @details
+ * Equivalent to calling XLALSimAddInjectionREAL8TimeSeries() for each of
+ * the detectors in turn, but the FFT plans and window used for sub-sample
+ * re-interpolation are made once for each padded length of the strain time
+ * series (normally once for the whole network, whose strains have nearly
+ * the same length), and the detectors are processed in parallel when
+ * OpenMP is enabled.
+ *
+ * @param[in,out] targets Array of ndetectors pointers to the time series
+ * into which the strains will be added
+ *
+ * @param[in,out] h Array of ndetectors pointers to the time series
+ * containing the detector strains (the strain data is modified by this
+ * routine)
+ *
+ * @param[in] responses Array of ndetectors pointers to the response
+ * functions transforming strain to detector output units, or NULL for unit
+ * response.  Individual elements may also be NULL.
+ *
+ * @param[in] ndetectors Number of detectors
+ *
+ * @retval 0 Success
+ * @retval <0 Failure
+ *
+ * @attention
+ * The source time series are modified in place by this function!
+ */
+int XLALSimAddInjectionNetworkREAL8TimeSeries(
+	REAL8TimeSeries **targets,
+	REAL8TimeSeries **h,
+	const COMPLEX16FrequencySeries * const *responses,
+	UINT4 ndetectors
+)
+{
+	struct injection_plans *plans;
+	UINT4 nplans = 0;
+	UINT4 *plan_index;
+	int errnum = XLAL_SUCCESS;
+	UINT4 k, l;
+
+	/* check input */
+
+	if(ndetectors && (!targets || !h))
+		XLAL_ERROR(XLAL_EFAULT);
+	for(k = 0; k < ndetectors; k++)
+		if(!targets[k] || !h[k])
+			XLAL_ERROR(XLAL_EFAULT);
+
+	/* make the FFT plans and windows for the distinct padded lengths
+	 * of the strains that need re-interpolation */
+
+	plans = XLALCalloc(ndetectors ? ndetectors : 1, sizeof(*plans));
+	plan_index = XLALMalloc((ndetectors ? ndetectors : 1) * sizeof(*plan_index));
+	if(!plans || !plan_index) {
+		XLALFree(plans);
+		XLALFree(plan_index);
+		XLAL_ERROR(XLAL_EFUNC);
+	}
+	for(k = 0; k < ndetectors; k++) {
+		double start_sample_int;
+		double start_sample_frac;
+		unsigned length;
+
+		plan_index[k] = ndetectors;
+		if(h[k]->deltaT != targets[k]->deltaT)
+			continue;	/* reported by add_injection_REAL8() */
+		injection_start_sample(targets[k], h[k], &start_sample_int, &start_sample_frac);
+		if(!injection_needs_interpolation(start_sample_frac, responses ? responses[k] : NULL))
+			continue;
+		length = injection_padded_length(h[k]->data->length);
+		if(length < h[k]->data->length)
+			continue;	/* reported by add_injection_REAL8() */
+		for(l = 0; l < nplans && plans[l].length != length; l++);
+		if(l == nplans && injection_plans_init(&plans[nplans++], length) < 0) {
+			errnum = XLAL_EFUNC;
+			break;
+		}
+		plan_index[k] = l;
+	}
+
+	/* add the strains */
+
+#pragma omp parallel for schedule(dynamic)
+	for(k = 0; k < ndetectors; k++) {
+		if(XLALGetCollectedErrno(&errnum) != XLAL_SUCCESS)
+			continue;
+		XLALCollectErrno(&errnum, add_injection_REAL8(targets[k], h[k], responses ? responses[k] : NULL, plan_index[k] < nplans ? &plans[plan_index[k]] : NULL));
+	}
+
+	for(l = 0; l < nplans; l++)
+		injection_plans_free(&plans[l]);
+	XLALFree(plans);
+	XLALFree(plan_index);
+	if(errnum != XLAL_SUCCESS)
+		XLAL_ERROR(errnum);
+
+	return 0;
+}
+
+
+/**
+ * @brief Projects a waveform into a network of detectors and adds the
+ * strains to the detector data.
+ * @details
+ * Combines XLALSimDetectorStrainNetworkREAL8TimeSeries() and
+ * XLALSimAddInjectionNetworkREAL8TimeSeries().  The strain time series are
+ * freed before returning.
+ *
+ * @param[in,out] targets Array of ndetectors pointers to the time series
+ * into which the strains will be added
+ * @param[in] hplus Pointer to a REAL8TimeSeries containing the plus polarization waveform
+ * @param[in] hcross Pointer to a REAL8TimeSeries containing the cross polarization waveform
+ * @param[in] right_ascension The right ascension of the source in radians
+ * @param[in] declination The declination of the source in radians
+ * @param[in] psi The polarization angle giving the orientation of the wave co-ordinate system in radians
+ * @param[in] detectors Array of ndetectors LALDetector structures for the detectors
+ * @param[in] responses Array of ndetectors pointers to the response
+ * functions, or NULL for unit response
+ * @param[in] ndetectors Number of detectors
+ *
+ * @retval 0 Success
+ * @retval <0 Failure
+ */
+int XLALSimInjectNetworkStrainREAL8TimeSeries(
+	REAL8TimeSeries **targets,
+	const REAL8TimeSeries *hplus,
+	const REAL8TimeSeries *hcross,
+	REAL8 right_ascension,
+	REAL8 declination,
+	REAL8 psi,
+	const LALDetector *detectors,
+	const COMPLEX16FrequencySeries * const *responses,
+	UINT4 ndetectors
+)
+{
+	REAL8TimeSeries **h;
+	int retval;
+	UINT4 k;
+
+	h = XLALMalloc((ndetectors ? ndetectors : 1) * sizeof(*h));
+	if(!h)
+		XLAL_ERROR(XLAL_EFUNC);
+	if(XLALSimDetectorStrainNetworkREAL8TimeSeries(h, hplus, hcross, right_ascension, declination, psi, detectors, ndetectors) < 0) {
+		XLALFree(h);
+		XLAL_ERROR(XLAL_EFUNC);
+	}
+	retval = XLALSimAddInjectionNetworkREAL8TimeSeries(targets, h, responses, ndetectors);
+	for(k = 0; k < ndetectors; k++)
+		XLALDestroyREAL8TimeSeries(h[k]);
+	XLALFree(h);
+	if(retval < 0)
+		XLAL_ERROR(XLAL_EFUNC);
+
+	return 0;
+}
+
+
 /**
  * @brief Adds a detector strain time series to detector data.
  * @details
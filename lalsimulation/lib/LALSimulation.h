@@ -166,6 +166,40 @@ int XLALSimAddInjectionREAL4TimeSeries(
 	const COMPLEX8FrequencySeries *response
 );
 
+#ifndef SWIG /* exclude from SWIG interface */
+
+int XLALSimDetectorStrainNetworkREAL8TimeSeries(
+	REAL8TimeSeries **h,
+	const REAL8TimeSeries *hplus,
+	const REAL8TimeSeries *hcross,
+	REAL8 right_ascension,
+	REAL8 declination,
+	REAL8 psi,
+	const LALDetector *detectors,
+	UINT4 ndetectors
+);
+
+int XLALSimAddInjectionNetworkREAL8TimeSeries(
+	REAL8TimeSeries **targets,
+	REAL8TimeSeries **h,
+	const COMPLEX16FrequencySeries * const *responses,
+	UINT4 ndetectors
+);
+
+int XLALSimInjectNetworkStrainREAL8TimeSeries(
+	REAL8TimeSeries **targets,
+	const REAL8TimeSeries *hplus,
+	const REAL8TimeSeries *hcross,
+	REAL8 right_ascension,
+	REAL8 declination,
+	REAL8 psi,
+	const LALDetector *detectors,
+	const COMPLEX16FrequencySeries * const *responses,
+	UINT4 ndetectors
+);
+
+#endif /* SWIG */
+
 int XLALSimInjectDetectorStrainREAL8TimeSeries(
 	REAL8TimeSeries *target,
 	const REAL8TimeSeries *hplus,
@@ -0,0 +1,235 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <lal/LALStdlib.h>
+#include <lal/LALConstants.h>
+#include <lal/LALSimNeutronStar.h>
+
+#define ADAPTIVE_TOLERANCE	1e-6
+#define MAXMASS_THRESH		1e-8	/* fractional maximum mass difference */
+#define KNOT_THRESH		1e-9	/* fractional central pressure error at a shared star */
+#define CACHE_TOLERANCE		1e-9
+#define NSTATE			500	/* points at which batched EOS evaluation is checked */
+
+/* log10 p1 (SI), Gamma1, Gamma2, Gamma3 of the piecewise polytrope fits to
+ * a few tabulated equations of state (Read et al. 2009, Table III) */
+static const double polytropes[][4] = {
+	{ 33.384, 3.005, 2.988, 2.851 },	/* SLy */
+	{ 33.269, 2.830, 3.445, 3.348 },	/* APR4 */
+	{ 33.495, 3.446, 3.572, 2.887 },	/* MPA1 */
+	{ 33.669, 2.909, 2.246, 2.144 },	/* H4 */
+};
+
+
+/*
+ * Builds the family of each equation of state with both the fixed-grid and
+ * the adaptive builder, and checks that they agree on the maximum mass and,
+ * for stars integrated at pressures sampled by both (the coarse adaptive
+ * grid of 16 intervals and the fixed grid of 100 share every fourth of the
+ * pressure range), that both recover the central pressure from the mass.
+ */
+static int TestXLALCreateSimNeutronStarFamilyAdaptive(void)
+{
+	const double logpmin = 75.5;
+	size_t n;
+	int errors = 0;
+
+	for (n = 0; n < sizeof(polytropes) / sizeof(*polytropes); ++n) {
+		LALSimNeutronStarEOS *eos = XLALSimNeutronStarEOS4ParameterPiecewisePolytrope(polytropes[n][0], polytropes[n][1], polytropes[n][2], polytropes[n][3]);
+		LALSimNeutronStarFamily *fixed = XLALCreateSimNeutronStarFamily(eos);
+		LALSimNeutronStarFamily *adaptive = XLALCreateSimNeutronStarFamilyAdaptive(eos, ADAPTIVE_TOLERANCE);
+		const double logpmax = log(XLALSimNeutronStarEOSMaxPressure(eos));
+		const double mmax_fixed = XLALSimNeutronStarMaximumMass(fixed);
+		const double mmax_adaptive = XLALSimNeutronStarMaximumMass(adaptive);
+		const double pmax = XLALSimNeutronStarCentralPressure(mmax_fixed, fixed);
+		double maxerr = 0.0;
+		int k;
+
+		if (fabs(mmax_adaptive - mmax_fixed) > MAXMASS_THRESH * mmax_fixed) {
+			fprintf(stderr, "%s(): EOS %zu: maximum mass %.12g (adaptive) != %.12g (fixed)\n", __func__, n, mmax_adaptive / LAL_MSUN_SI, mmax_fixed / LAL_MSUN_SI);
+			++errors;
+		}
+
+		for (k = 0; k < 4; ++k) {
+			const double p = exp(logpmin + k * (logpmax - logpmin) / 4);
+			double r, m, k2;
+			if (p >= pmax)
+				break;	/* past the maximum mass */
+			XLALSimNeutronStarTOVODEIntegrate(&r, &m, &k2, p, eos);
+			maxerr = fmax(maxerr, fabs(XLALSimNeutronStarCentralPressure(m, fixed) - p) / p);
+			maxerr = fmax(maxerr, fabs(XLALSimNeutronStarCentralPressure(m, adaptive) - p) / p);
+		}
+		if (maxerr > KNOT_THRESH) {
+			fprintf(stderr, "%s(): EOS %zu: central pressure of a shared star recovered with fractional error %g\n", __func__, n, maxerr);
+			++errors;
+		}
+
+		fprintf(stderr, "%s(): EOS %zu: maximum mass %.9f Msun (fixed) %.9f Msun (adaptive), shared star error %g\n", __func__, n, mmax_fixed / LAL_MSUN_SI, mmax_adaptive / LAL_MSUN_SI, maxerr);
+		XLALDestroySimNeutronStarFamily(adaptive);
+		XLALDestroySimNeutronStarFamily(fixed);
+		XLALDestroySimNeutronStarEOS(eos);
+	}
+
+	return errors;
+}
+
+
+/*
+ * Fills a cache of two entries with three equations of state and checks
+ * lookups, matching within the tolerance, and least-recently-used eviction.
+ */
+static int TestXLALSimNeutronStarFamilyCache(void)
+{
+	LALSimNeutronStarFamilyCache *cache = XLALCreateSimNeutronStarFamilyCache(2, CACHE_TOLERANCE);
+	LALSimNeutronStarEOS *eos[3];
+	LALSimNeutronStarFamily *fam[3];
+	LALSimNeutronStarEOS *found_eos;
+	double key[3][4];
+	double near[4];
+	size_t n, i;
+	int errors = 0;
+
+	for (n = 0; n < 3; ++n) {
+		for (i = 0; i < 4; ++i)
+			key[n][i] = polytropes[n][i];
+		eos[n] = XLALSimNeutronStarEOS4ParameterPiecewisePolytrope(key[n][0], key[n][1], key[n][2], key[n][3]);
+		fam[n] = XLALCreateSimNeutronStarFamily(eos[n]);
+	}
+
+	/* an empty cache finds nothing */
+	if (XLALSimNeutronStarFamilyCacheLookup(NULL, cache, key[0], 4) != NULL)
+		++errors;
+
+	if (XLALSimNeutronStarFamilyCacheInsert(cache, key[0], 4, eos[0], fam[0]) < 0)
+		return 1;
+	if (XLALSimNeutronStarFamilyCacheInsert(cache, key[1], 4, eos[1], fam[1]) < 0)
+		return 1;
+
+	/* exact and nearby keys match, returning the cached EOS too */
+	found_eos = NULL;
+	if (XLALSimNeutronStarFamilyCacheLookup(&found_eos, cache, key[0], 4) != fam[0] || found_eos != eos[0])
+		++errors;
+	for (i = 0; i < 4; ++i)
+		near[i] = key[1][i] * (1.0 + 0.1 * CACHE_TOLERANCE);
+	if (XLALSimNeutronStarFamilyCacheLookup(NULL, cache, near, 4) != fam[1])
+		++errors;
+	/* keys differing by more than the tolerance, or of another length, do not */
+	near[2] = key[1][2] * (1.0 + 10.0 * CACHE_TOLERANCE);
+	if (XLALSimNeutronStarFamilyCacheLookup(NULL, cache, near, 4) != NULL)
+		++errors;
+	if (XLALSimNeutronStarFamilyCacheLookup(NULL, cache, key[1], 3) != NULL)
+		++errors;
+
+	/* once key 1 has been used after key 0, a third insertion evicts key 0 */
+	if (XLALSimNeutronStarFamilyCacheLookup(NULL, cache, key[1], 4) != fam[1])
+		++errors;
+	if (XLALSimNeutronStarFamilyCacheInsert(cache, key[2], 4, eos[2], fam[2]) < 0)
+		return 1;
+	if (XLALSimNeutronStarFamilyCacheLookup(NULL, cache, key[0], 4) != NULL)
+		++errors;
+	if (XLALSimNeutronStarFamilyCacheLookup(NULL, cache, key[1], 4) != fam[1])
+		++errors;
+	if (XLALSimNeutronStarFamilyCacheLookup(NULL, cache, key[2], 4) != fam[2])
+		++errors;
+
+	/* the cache owns, and frees, what it holds */
+	XLALDestroySimNeutronStarFamilyCache(cache);
+
+	fprintf(stderr, "%s(): %d error(s)\n", __func__, errors);
+	return errors;
+}
+
+
+/*
+ * Returns the tabulated SLy4 equation of state, from the source tree when
+ * run by "make check" and from the LAL data path otherwise.
+ */
+static LALSimNeutronStarEOS *tabulated_eos(void)
+{
+	const char *dir = getenv("LAL_TEST_PKGDATADIR");
+	char fname[FILENAME_MAX];
+	LALSimNeutronStarEOS *eos;
+	if (!dir)
+		return XLALSimNeutronStarEOSByName("SLY4");
+	snprintf(fname, sizeof(fname), "%s/LALSimNeutronStarEOS_SLY4.dat", dir);
+	eos = XLALSimNeutronStarEOSFromFile(fname);
+	return eos;
+}
+
+
+/* equal, or both not-a-number as the derivative at zero pressure can be */
+static int same_value(double a, double b)
+{
+	return a == b || (isnan(a) && isnan(b));
+}
+
+
+/*
+ * Checks that the batched evaluations of a tabulated and of a piecewise
+ * polytrope equation of state give the same values as the scalar routines,
+ * from zero through the degenerate gas extension below the table up to the
+ * maximum pressure, and that any of the outputs may be omitted.
+ */
+static int TestXLALSimNeutronStarEOSState(void)
+{
+	LALSimNeutronStarEOS *eos[2];
+	static double h[NSTATE], p[NSTATE];
+	static double p_of_h[NSTATE], e_of_h[NSTATE], rho_of_h[NSTATE];
+	static double e_of_p[NSTATE], h_of_p[NSTATE], dedp_of_p[NSTATE];
+	static double only[NSTATE];
+	size_t n, j;
+	int errors = 0;
+
+	eos[0] = tabulated_eos();
+	eos[1] = XLALSimNeutronStarEOS4ParameterPiecewisePolytrope(polytropes[0][0], polytropes[0][1], polytropes[0][2], polytropes[0][3]);
+
+	for (n = 0; n < sizeof(eos) / sizeof(*eos); ++n) {
+		const double hmax = XLALSimNeutronStarEOSMaxPseudoEnthalpy(eos[n]) * (1.0 - 1e-12);
+		const double pmax = XLALSimNeutronStarEOSMaxPressureGeometerized(eos[n]) * (1.0 - 1e-12);
+		int nerr = 0;
+
+		/* zero, then logarithmically spaced points falling to far below the table */
+		h[0] = p[0] = 0.0;
+		for (j = 1; j < NSTATE; ++j) {
+			h[j] = hmax * exp(-25.0 * (NSTATE - 1 - j) / (NSTATE - 2));
+			p[j] = pmax * exp(-60.0 * (NSTATE - 1 - j) / (NSTATE - 2));
+		}
+
+		if (XLALSimNeutronStarEOSStateOfPseudoEnthalpyGeometerized(p_of_h, e_of_h, rho_of_h, h, NSTATE, eos[n]) < 0
+			|| XLALSimNeutronStarEOSStateOfPressureGeometerized(e_of_p, h_of_p, dedp_of_p, p, NSTATE, eos[n]) < 0)
+			return 1;
+		for (j = 0; j < NSTATE; ++j) {
+			nerr += !same_value(p_of_h[j], XLALSimNeutronStarEOSPressureOfPseudoEnthalpyGeometerized(h[j], eos[n]));
+			nerr += !same_value(e_of_h[j], XLALSimNeutronStarEOSEnergyDensityOfPseudoEnthalpyGeometerized(h[j], eos[n]));
+			nerr += !same_value(rho_of_h[j], XLALSimNeutronStarEOSRestMassDensityOfPseudoEnthalpyGeometerized(h[j], eos[n]));
+			nerr += !same_value(e_of_p[j], XLALSimNeutronStarEOSEnergyDensityOfPressureGeometerized(p[j], eos[n]));
+			nerr += !same_value(h_of_p[j], XLALSimNeutronStarEOSPseudoEnthalpyOfPressureGeometerized(p[j], eos[n]));
+			nerr += !same_value(dedp_of_p[j], XLALSimNeutronStarEOSEnergyDensityDerivOfPressureGeometerized(p[j], eos[n]));
+		}
+
+		/* one quantity at a time */
+		if (XLALSimNeutronStarEOSStateOfPseudoEnthalpyGeometerized(NULL, NULL, only, h, NSTATE, eos[n]) < 0)
+			return 1;
+		nerr += memcmp(only, rho_of_h, sizeof(only)) != 0;
+		if (XLALSimNeutronStarEOSStateOfPressureGeometerized(NULL, NULL, only, p, NSTATE, eos[n]) < 0)
+			return 1;
+		nerr += memcmp(only, dedp_of_p, sizeof(only)) != 0;
+
+		fprintf(stderr, "%s(): %s EOS: %d mismatch(es) between batched and scalar evaluation\n", __func__, n ? "piecewise polytrope" : "tabulated", nerr);
+		errors += nerr;
+		XLALDestroySimNeutronStarEOS(eos[n]);
+	}
+
+	return errors;
+}
+
+
+int main(int argc, char *argv[])
+{
+	(void) argc;	/* silence unused parameter warning */
+	(void) argv;	/* silence unused parameter warning */
+	XLALSetErrorHandler(XLALAbortErrorHandler);
+	return TestXLALSimNeutronStarEOSState() || TestXLALCreateSimNeutronStarFamilyAdaptive() || TestXLALSimNeutronStarFamilyCache();
+}
@@ -0,0 +1,112 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <lal/LALStdlib.h>
+#include <lal/LALConstants.h>
+#include <lal/FrequencySeries.h>
+#include <lal/TimeSeries.h>
+#include <lal/TimeFreqFFT.h>
+#include <lal/Units.h>
+#include <lal/Window.h>
+#include <lal/LALSimNoise.h>
+
+#define SRATE		1024.0	/* Hz */
+#define SEGLENGTH	1024	/* samples in a generator segment */
+#define NBLOCKS_TIME	256.0	/* seconds of noise to generate */
+#define WELCHLENGTH	256	/* samples in a Welch segment */
+#define NCHANNELS	2
+#define BANDBINS	8	/* PSD bins averaged before comparison */
+#define PSDTHRESH	0.05	/* maximum fractional error of band-averaged PSD */
+#define SEED		20231018
+
+
+/* a mildly coloured spectrum, different in each channel */
+static double model_psd(unsigned channel, double f)
+{
+	const double f0 = channel ? 50.0 : 150.0;
+	return 1e-40 * (1.0 + (f / f0) * (f / f0));
+}
+
+
+/*
+ * Streams noise in blocks of stride samples, joins the blocks of each
+ * channel, and checks that the Welch estimate of their PSD agrees with the
+ * PSD the generator was given.
+ */
+static int TestXLALSimNoiseGeneratorPSD(size_t stride)
+{
+	const size_t nbin = SEGLENGTH / 2 + 1;
+	const size_t nblocks = (size_t)(NBLOCKS_TIME * SRATE) / stride;
+	LIGOTimeGPS epoch = {0, 0};
+	REAL8FrequencySeries *psds[NCHANNELS];
+	REAL8TimeSeries *blocks[NCHANNELS];
+	REAL8TimeSeries *series[NCHANNELS];
+	REAL8FrequencySeries *estimate;
+	REAL8Window *window;
+	REAL8FFTPlan *plan;
+	LALSimNoiseGenerator *gen;
+	double maxerr = 0.0;
+	unsigned c;
+	size_t j, k;
+
+	for (c = 0; c < NCHANNELS; ++c) {
+		psds[c] = XLALCreateREAL8FrequencySeries(NULL, &epoch, 0.0, SRATE / SEGLENGTH, &lalSecondUnit, nbin);
+		for (k = 0; k < nbin; ++k)
+			psds[c]->data->data[k] = model_psd(c, k * psds[c]->deltaF);
+		blocks[c] = XLALCreateREAL8TimeSeries(NULL, &epoch, 0.0, 1.0 / SRATE, &lalDimensionlessUnit, stride);
+		series[c] = XLALCreateREAL8TimeSeries(NULL, &epoch, 0.0, 1.0 / SRATE, &lalDimensionlessUnit, nblocks * stride);
+	}
+
+	gen = XLALSimNoiseGeneratorCreate((const REAL8FrequencySeries * const *) psds, NCHANNELS, &epoch, 1.0 / SRATE, SEGLENGTH, stride, SEED);
+	if (!gen)
+		return 1;
+	for (j = 0; j < nblocks; ++j) {
+		if (XLALSimNoiseGeneratorNext(gen, blocks) < 0)
+			return 1;
+		for (c = 0; c < NCHANNELS; ++c)
+			memcpy(series[c]->data->data + j * stride, blocks[c]->data->data, stride * sizeof(*blocks[c]->data->data));
+	}
+	XLALSimNoiseGeneratorDestroy(gen);
+
+	window = XLALCreateHannREAL8Window(WELCHLENGTH);
+	plan = XLALCreateForwardREAL8FFTPlan(WELCHLENGTH, 0);
+	estimate = XLALCreateREAL8FrequencySeries(NULL, &epoch, 0.0, SRATE / WELCHLENGTH, &lalDimensionlessUnit, WELCHLENGTH / 2 + 1);
+	for (c = 0; c < NCHANNELS; ++c) {
+		if (XLALREAL8AverageSpectrumWelch(estimate, series[c], WELCHLENGTH, WELCHLENGTH / 2, window, plan) < 0)
+			return 1;
+		/* skip the DC band and the Nyquist bin, which the generator
+		 * does not fill with full-variance noise */
+		for (k = BANDBINS; k + BANDBINS < estimate->data->length; k += BANDBINS) {
+			double measured = 0.0, expected = 0.0;
+			for (j = k; j < k + BANDBINS; ++j) {
+				measured += estimate->data->data[j];
+				expected += model_psd(c, j * estimate->deltaF);
+			}
+			if (fabs(measured / expected - 1.0) > maxerr)
+				maxerr = fabs(measured / expected - 1.0);
+		}
+	}
+
+	XLALDestroyREAL8FrequencySeries(estimate);
+	XLALDestroyREAL8FFTPlan(plan);
+	XLALDestroyREAL8Window(window);
+	for (c = 0; c < NCHANNELS; ++c) {
+		XLALDestroyREAL8FrequencySeries(psds[c]);
+		XLALDestroyREAL8TimeSeries(blocks[c]);
+		XLALDestroyREAL8TimeSeries(series[c]);
+	}
+
+	fprintf(stderr, "%s(): stride = %zu, maximum fractional PSD error = %g\n", __func__, stride, maxerr);
+	return maxerr > PSDTHRESH;
+}
+
+
+int main(int argc, char *argv[])
+{
+	(void) argc;	/* silence unused parameter warning */
+	(void) argv;	/* silence unused parameter warning */
+	XLALSetErrorHandler(XLALAbortErrorHandler);
+	return TestXLALSimNoiseGeneratorPSD(SEGLENGTH / 2) || TestXLALSimNoiseGeneratorPSD(SEGLENGTH);
+}
@@ -20,6 +20,7 @@
 #include <stdlib.h>
 #include <math.h>
 #include <lal/LALSimInspiral.h>
+#include <lal/AVFactories.h>
 #include <lal/Units.h>
 #include <lal/XLALError.h>
 #include <lal/LALSimInspiralTestGRParams.h>
@@ -585,6 +586,150 @@ static int test_consistency_T4(
 
 }
 
+/* Testing that the phasing at given quadrupole parameters is the phasing at
+ * zero quadrupole deformation plus the quadrupole derivatives. */
+
+static int test_quadmon_F2(
+    const REAL8 m1M,
+    const REAL8 chi1,
+    const REAL8 chi2,
+    const REAL8 dqm1,
+    const REAL8 dqm2
+    )
+{
+    REAL8 m2M = 1.-m1M;
+
+    LALDict *extraParams=XLALCreateDict();
+    PNPhasingSeries phasing0, dphasing1, dphasing2, phasing;
+    XLALSimInspiralPNPhasing_F2(&phasing0, m1M, m2M, chi1, chi2,\
+                                chi1*chi1, chi2*chi2, chi1*chi2,\
+                                extraParams);
+    XLALSimInspiralPNPhasing_F2QuadMon(&dphasing1, &dphasing2, m1M, m2M,\
+                                       chi1, chi2, chi1*chi1, chi2*chi2,\
+                                       extraParams);
+    XLALSimInspiralWaveformParamsInsertdQuadMon1(extraParams,dqm1);
+    XLALSimInspiralWaveformParamsInsertdQuadMon2(extraParams,dqm2);
+    XLALSimInspiralPNPhasing_F2(&phasing, m1M, m2M, chi1, chi2,\
+                                chi1*chi1, chi2*chi2, chi1*chi2,\
+                                extraParams);
+    XLALDestroyDict(extraParams);
+
+    /* Divide the phasing by the leading-order term */
+    REAL8 phase0 = phasing.v[0];
+    for (int i = 0; i <= PN_PHASING_SERIES_MAX_ORDER; i++)
+    {
+        phasing0.v[i] = (phasing0.v[i] + dqm1*dphasing1.v[i] + dqm2*dphasing2.v[i]) / phase0;
+        phasing0.vlogv[i] /= phase0;
+        phasing.v[i] /= phase0;
+        phasing.vlogv[i] /= phase0;
+    }
+
+    return compare_pnseries(&phasing0, &phasing);
+}
+
+static int pnseries_equal(
+    const PNPhasingSeries *s1,
+    const PNPhasingSeries *s2)
+{
+    for (int i = 0; i <= PN_PHASING_SERIES_MAX_ORDER; i++)
+        if (s1->v[i] != s2->v[i] || s1->vlogv[i] != s2->vlogv[i] || s1->vlogvsq[i] != s2->vlogvsq[i] || s1->vneg[i] != s2->vneg[i])
+            return 0;
+    return 1;
+}
+
+/* Testing that the public quadrupole-term routines, with a nonzero reference
+ * point, reproduce XLALSimInspiralTaylorF2AlignedPhasing() and
+ * XLALSimInspiralTaylorF2AlignedPhasingArray() at other quadrupole parameters. */
+
+static int test_quadmon_terms_F2(
+    const REAL8 m1,
+    const REAL8 m2,
+    const REAL8 chi1,
+    const REAL8 chi2,
+    const REAL8 dqm1ref,
+    const REAL8 dqm2ref
+    )
+{
+    const REAL8 dqm1[] = {dqm1ref, 0., 1., 3.5, -0.5};
+    const REAL8 dqm2[] = {dqm2ref, 0., 6., 1., 2.};
+    const UINT4 n = sizeof(dqm1)/sizeof(*dqm1);
+    REAL8 mass1[n], mass2[n], spin1[n], spin2[n], lambda[n];
+    REAL8Vector mass1vec = {n, mass1}, mass2vec = {n, mass2};
+    REAL8Vector spin1vec = {n, spin1}, spin2vec = {n, spin2};
+    REAL8Vector lambdavec = {n, lambda};
+    REAL8Vector dqm1vec = {n, (REAL8 *) dqm1}, dqm2vec = {n, (REAL8 *) dqm2};
+    REAL8Vector *full = NULL, *fromterms = NULL;
+    PNPhasingSeriesQuadMonTerms *terms = NULL;
+    int ret = 0;
+
+    LALDict *extraParams=XLALCreateDict();
+    XLALSimInspiralWaveformParamsInsertdQuadMon1(extraParams,dqm1ref);
+    XLALSimInspiralWaveformParamsInsertdQuadMon2(extraParams,dqm2ref);
+    XLALSimInspiralTaylorF2AlignedPhasingQuadMonTerms(&terms, m1, m2, chi1, chi2, extraParams);
+
+    for (UINT4 j = 0; j < n; j++)
+    {
+        PNPhasingSeries *phasing = NULL, updated;
+        XLALSimInspiralWaveformParamsInsertdQuadMon1(extraParams,dqm1[j]);
+        XLALSimInspiralWaveformParamsInsertdQuadMon2(extraParams,dqm2[j]);
+        XLALSimInspiralTaylorF2AlignedPhasing(&phasing, m1, m2, chi1, chi2, extraParams);
+        XLALSimInspiralTaylorF2AlignedPhasingFromQuadMonTerms(&updated, terms, dqm1[j], dqm2[j]);
+
+        /* the reference point is reproduced exactly */
+        if (j == 0 && (!pnseries_equal(&terms->ref, phasing) || !pnseries_equal(&updated, phasing)))
+        {
+            fprintf(stderr, "FAILED: reference phasing differs from XLALSimInspiralTaylorF2AlignedPhasing()\n");
+            ret += 1;
+        }
+
+        /* Divide the phasing by the leading-order term */
+        REAL8 phase0 = phasing->v[0];
+        for (int i = 0; i <= PN_PHASING_SERIES_MAX_ORDER; i++)
+        {
+            updated.v[i] /= phase0;
+            updated.vlogv[i] /= phase0;
+            phasing->v[i] /= phase0;
+            phasing->vlogv[i] /= phase0;
+        }
+        ret += compare_pnseries(&updated, phasing);
+        LALFree(phasing);
+
+        mass1[j] = m1;
+        mass2[j] = m2;
+        spin1[j] = chi1;
+        spin2[j] = chi2;
+        lambda[j] = 0.;
+    }
+    XLALDestroyDict(extraParams);
+
+    /* the array routines share their layout */
+    XLALSimInspiralTaylorF2AlignedPhasingArray(&full, mass1vec, mass2vec, spin1vec, spin2vec, lambdavec, lambdavec, dqm1vec, dqm2vec);
+    XLALSimInspiralTaylorF2AlignedPhasingQuadMonArray(&fromterms, terms, dqm1vec, dqm2vec);
+    if (!full || !fromterms || full->length != fromterms->length)
+    {
+        fprintf(stderr, "FAILED: phasing arrays differ in length\n");
+        ret += 1;
+    }
+    else
+    {
+        int nerr = 0;
+        for (UINT4 i = 0; i < full->length; i++)
+        {
+            REAL8 phase0 = full->data[i % n];
+            nerr += compare_value(fromterms->data[i] / phase0, full->data[i] / phase0);
+        }
+        ret += nerr;
+        if (nerr)
+            fprintf(stderr, "FAILED: XLALSimInspiralTaylorF2AlignedPhasingQuadMonArray() differs from XLALSimInspiralTaylorF2AlignedPhasingArray()\n");
+    }
+
+    XLALDestroyREAL8Vector(full);
+    XLALDestroyREAL8Vector(fromterms);
+    LALFree(terms);
+
+    return ret;
+}
+
 /* Testing tidal coefficients. Since they are symmetric with respect to both objects
  * it is sufficient to test only one non-zero coefficient.  */
 
@@ -808,6 +953,13 @@ int main (int argc, char **argv)
     ret += test_consistency_T4(0.9, 0.9, -0.9, 3., 2.);
     ret += test_consistency_T4(0.01, 0.9, 0.9, 4., 4.);
 
+    fprintf(stdout, "Testing quadrupole derivatives.\n");
+    ret += test_quadmon_F2(0.5, 0.9, -0.9, 1., 4.5);
+    ret += test_quadmon_F2(0.9, 0.3, 0.7, 2., 2.);
+    ret += test_quadmon_F2(0.01, -0.6, 0.4, 4., 0.);
+    ret += test_quadmon_terms_F2(1.4, 1.3, 0.9, -0.5, 2., 3.);
+    ret += test_quadmon_terms_F2(30., 3., 0.3, 0.8, 10., 0.5);
+
     fprintf(stdout, "Testing tidal terms.\n");
     for (UINT4 idx=1;idx<=9;idx++) {
       ret += test_tidal_F2(0.1*((REAL8)idx));
@@ -0,0 +1,110 @@
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with with program; see the file COPYING. If not, write to the
+ *  Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ *  MA  02110-1301  USA
+ */
+
+/**
+ * \file
+ *
+ * \brief Check ChooseFDWaveformFrequencyGrid is consistent with
+ * ChooseFDWaveformSequence on the same non-uniform frequencies
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <lal/LALStdlib.h>
+#include <lal/LALConstants.h>
+#include <lal/Sequence.h>
+#include <lal/FrequencySeries.h>
+#include <lal/LALSimInspiral.h>
+#include <lal/LALSimInspiralWaveformCache.h>
+
+#define NFREQ 512
+#define FMIN 20.0
+#define FMAX 1024.0
+/* largest difference allowed, relative to the largest amplitude */
+#define REL_THRESH 1e-12
+
+/* largest difference between two frequency series, relative to the largest
+ * amplitude of the first */
+static double max_rel_diff(const COMPLEX16FrequencySeries *a, const COMPLEX16FrequencySeries *b)
+{
+    double amax = 0.0, dmax = 0.0;
+    UINT4 j;
+    for (j = 0; j < a->data->length; j++) {
+        amax = fmax(amax, cabs(a->data->data[j]));
+        dmax = fmax(dmax, cabs(a->data->data[j] - b->data->data[j]));
+    }
+    return amax > 0.0 ? dmax / amax : dmax;
+}
+
+static int test_approximant(Approximant approximant, REAL8Sequence *freqs, const LALSimInspiralFrequencyGrid *grid)
+{
+    const REAL8 m1 = 30.0 * LAL_MSUN_SI, m2 = 25.0 * LAL_MSUN_SI;
+    const REAL8 s1z = 0.3, s2z = -0.2;
+    const REAL8 f_ref = 30.0, phiRef = 0.7;
+    const REAL8 distance = 400.0e6 * LAL_PC_SI, inclination = 0.9;
+    COMPLEX16FrequencySeries *hptilde = NULL, *hctilde = NULL;
+    COMPLEX16FrequencySeries *hptildeG = NULL, *hctildeG = NULL;
+    double plusdiff, crossdiff;
+
+    if (XLALSimInspiralChooseFDWaveformSequence(&hptilde, &hctilde, phiRef,
+            m1, m2, 0., 0., s1z, 0., 0., s2z, f_ref, distance, inclination,
+            NULL, approximant, freqs) == XLAL_FAILURE)
+        return 1;
+    if (XLALSimInspiralChooseFDWaveformFrequencyGrid(&hptildeG, &hctildeG, phiRef,
+            m1, m2, 0., 0., s1z, 0., 0., s2z, f_ref, distance, inclination,
+            NULL, approximant, grid) == XLAL_FAILURE)
+        return 1;
+    if (hptildeG->data->length != hptilde->data->length || hctildeG->data->length != hctilde->data->length) {
+        printf("%s: lengths differ\n", XLALSimInspiralGetStringFromApproximant(approximant));
+        return 1;
+    }
+
+    plusdiff = max_rel_diff(hptilde, hptildeG);
+    crossdiff = max_rel_diff(hctilde, hctildeG);
+    printf("%s: largest relative difference in plus polarization is %g, in cross polarization %g\n",
+        XLALSimInspiralGetStringFromApproximant(approximant), plusdiff, crossdiff);
+
+    XLALDestroyCOMPLEX16FrequencySeries(hptilde);
+    XLALDestroyCOMPLEX16FrequencySeries(hctilde);
+    XLALDestroyCOMPLEX16FrequencySeries(hptildeG);
+    XLALDestroyCOMPLEX16FrequencySeries(hctildeG);
+    return plusdiff > REL_THRESH || crossdiff > REL_THRESH;
+}
+
+int main(void) {
+    const Approximant approximants[] = { TaylorF2, IMRPhenomD, IMRPhenomXAS };
+    REAL8Sequence *freqs = XLALCreateREAL8Sequence(NFREQ);
+    LALSimInspiralFrequencyGrid *grid;
+    unsigned int j;
+    int ret = 0;
+
+    XLALSetErrorHandler(XLALAbortErrorHandler);
+
+    /* logarithmically spaced frequencies, as used by reduced order quadrature
+     * and relative binning, with a slight jitter so no two spacings agree */
+    for (j = 0; j < NFREQ; j++)
+        freqs->data[j] = FMIN * pow(FMAX / FMIN, (j + 0.25 * sin(j)) / (NFREQ - 1.0));
+    freqs->data[NFREQ - 1] = FMAX;
+    grid = XLALCreateSimInspiralFrequencyGrid(freqs);
+
+    for (j = 0; j < sizeof(approximants) / sizeof(*approximants); j++)
+        ret |= test_approximant(approximants[j], freqs, grid);
+
+    XLALDestroySimInspiralFrequencyGrid(grid);
+    XLALDestroyREAL8Sequence(freqs);
+    return ret;
+}
@@ -0,0 +1,185 @@
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <lal/Date.h>
+#include <lal/LALConstants.h>
+#include <lal/LALDetectors.h>
+#include <lal/LALSimulation.h>
+#include <lal/FrequencySeries.h>
+#include <lal/TimeSeries.h>
+#include <lal/Units.h>
+
+/*
+ * Checks that the network functions give the same strains and injections
+ * as XLALSimDetectorStrainREAL8TimeSeries() and
+ * XLALSimAddInjectionREAL8TimeSeries() called for each detector in turn.
+ */
+
+#define DELTA_T		(1.0 / 4096)	/* seconds */
+#define SIMLENGTH	(4096 * 4)	/* samples */
+#define DSTLENGTH	(4096 * 16)	/* samples */
+#define OFFSET		5.123456789	/* seconds */
+#define NDETECTORS	4
+#define RA		1.3
+#define DEC		-0.4
+#define PSI		0.7
+
+
+/* sine-Gaussian h+ and hx, centred in the time series */
+static void make_polarizations(REAL8TimeSeries **hplus, REAL8TimeSeries **hcross)
+{
+	LIGOTimeGPS epoch = {1000000000, 0};
+	unsigned i;
+
+	XLALGPSAdd(&epoch, OFFSET);
+	*hplus = XLALCreateREAL8TimeSeries("hplus", &epoch, 0.0, DELTA_T, &lalStrainUnit, SIMLENGTH);
+	*hcross = XLALCreateREAL8TimeSeries("hcross", &epoch, 0.0, DELTA_T, &lalStrainUnit, SIMLENGTH);
+	for(i = 0; i < SIMLENGTH; i++) {
+		double t = (i - SIMLENGTH / 2.0) * DELTA_T;
+		double env = 1e-21 * exp(-t * t / (2 * 0.1 * 0.1));
+		(*hplus)->data->data[i] = env * cos(LAL_TWOPI * 150.0 * t);
+		(*hcross)->data->data[i] = env * sin(LAL_TWOPI * 150.0 * t);
+	}
+}
+
+
+/* zero detector data starting at a whole second */
+static REAL8TimeSeries *make_target(void)
+{
+	LIGOTimeGPS epoch = {1000000000, 0};
+	REAL8TimeSeries *target = XLALCreateREAL8TimeSeries("target", &epoch, 0.0, DELTA_T, &lalStrainUnit, DSTLENGTH);
+	memset(target->data->data, 0, target->data->length * sizeof(*target->data->data));
+	return target;
+}
+
+
+/* response with a frequency-dependent gain and phase */
+static COMPLEX16FrequencySeries *make_response(void)
+{
+	LIGOTimeGPS epoch = {0, 0};
+	COMPLEX16FrequencySeries *response = XLALCreateCOMPLEX16FrequencySeries("response", &epoch, 0.0, 1.0, &lalDimensionlessUnit, 2049);
+	unsigned i;
+	for(i = 0; i < response->data->length; i++)
+		response->data->data[i] = (2.0 + i / 1000.0) * cexp(I * 1e-3 * i);
+	return response;
+}
+
+
+static int series_nonzero(const REAL8TimeSeries *series)
+{
+	unsigned i;
+	for(i = 0; i < series->data->length; i++)
+		if(series->data->data[i] != 0.0)
+			return 1;
+	return 0;
+}
+
+
+static int series_equal(const char *what, const char *detector, const REAL8TimeSeries *a, const REAL8TimeSeries *b)
+{
+	unsigned i;
+	if(!a || !b) {
+		fprintf(stderr, "%s in %s: missing time series\n", what, detector);
+		return 0;
+	}
+	if(XLALGPSCmp(&a->epoch, &b->epoch) || a->deltaT != b->deltaT || a->data->length != b->data->length) {
+		fprintf(stderr, "%s in %s: epoch, sample rate or length differ\n", what, detector);
+		return 0;
+	}
+	for(i = 0; i < a->data->length; i++)
+		if(a->data->data[i] != b->data->data[i]) {
+			fprintf(stderr, "%s in %s: sample %u differs: %.17g != %.17g\n", what, detector, i, a->data->data[i], b->data->data[i]);
+			return 0;
+		}
+	return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+	LALDetector detectors[NDETECTORS];
+	const COMPLEX16FrequencySeries *responses[NDETECTORS];
+	COMPLEX16FrequencySeries *response = make_response();
+	REAL8TimeSeries *hplus, *hcross;
+	REAL8TimeSeries *h[NDETECTORS], *hnet[NDETECTORS];
+	REAL8TimeSeries *target[NDETECTORS], *targetnet[NDETECTORS], *targetinj[NDETECTORS];
+	int failed = 0;
+	unsigned k;
+
+	(void) argc;	/* silence unused parameter warning */
+	(void) argv;	/* silence unused parameter warning */
+
+	/* two detectors with a response, two without */
+	detectors[0] = lalCachedDetectors[LAL_LHO_4K_DETECTOR];
+	detectors[1] = lalCachedDetectors[LAL_LLO_4K_DETECTOR];
+	detectors[2] = lalCachedDetectors[LAL_VIRGO_DETECTOR];
+	detectors[3] = lalCachedDetectors[LAL_KAGRA_DETECTOR];
+	responses[0] = response;
+	responses[1] = NULL;
+	responses[2] = response;
+	responses[3] = NULL;
+
+	make_polarizations(&hplus, &hcross);
+
+	/* strains */
+	if(XLALSimDetectorStrainNetworkREAL8TimeSeries(hnet, hplus, hcross, RA, DEC, PSI, detectors, NDETECTORS) < 0) {
+		fprintf(stderr, "XLALSimDetectorStrainNetworkREAL8TimeSeries() failed\n");
+		return 1;
+	}
+	for(k = 0; k < NDETECTORS; k++) {
+		h[k] = XLALSimDetectorStrainREAL8TimeSeries(hplus, hcross, RA, DEC, PSI, &detectors[k]);
+		failed |= !series_equal("strain", detectors[k].frDetector.prefix, hnet[k], h[k]);
+	}
+	if(!failed)
+		fprintf(stderr, "XLALSimDetectorStrainNetworkREAL8TimeSeries() agrees with XLALSimDetectorStrainREAL8TimeSeries()\n");
+
+	/* injections of those strains */
+	for(k = 0; k < NDETECTORS; k++) {
+		target[k] = make_target();
+		targetnet[k] = make_target();
+		targetinj[k] = make_target();
+		if(XLALSimAddInjectionREAL8TimeSeries(target[k], h[k], responses[k]) < 0) {
+			fprintf(stderr, "XLALSimAddInjectionREAL8TimeSeries() failed\n");
+			return 1;
+		}
+		if(!series_nonzero(target[k])) {
+			fprintf(stderr, "injection in %s is zero\n", detectors[k].frDetector.prefix);
+			return 1;
+		}
+	}
+	if(XLALSimAddInjectionNetworkREAL8TimeSeries(targetnet, hnet, responses, NDETECTORS) < 0) {
+		fprintf(stderr, "XLALSimAddInjectionNetworkREAL8TimeSeries() failed\n");
+		return 1;
+	}
+	for(k = 0; k < NDETECTORS; k++)
+		failed |= !series_equal("injection", detectors[k].frDetector.prefix, targetnet[k], target[k]);
+	if(!failed)
+		fprintf(stderr, "XLALSimAddInjectionNetworkREAL8TimeSeries() agrees with XLALSimAddInjectionREAL8TimeSeries()\n");
+
+	/* projection and injection in one call */
+	if(XLALSimInjectNetworkStrainREAL8TimeSeries(targetinj, hplus, hcross, RA, DEC, PSI, detectors, responses, NDETECTORS) < 0) {
+		fprintf(stderr, "XLALSimInjectNetworkStrainREAL8TimeSeries() failed\n");
+		return 1;
+	}
+	for(k = 0; k < NDETECTORS; k++)
+		failed |= !series_equal("network injection", detectors[k].frDetector.prefix, targetinj[k], target[k]);
+	if(!failed)
+		fprintf(stderr, "XLALSimInjectNetworkStrainREAL8TimeSeries() agrees with the single-detector functions\n");
+
+	for(k = 0; k < NDETECTORS; k++) {
+		XLALDestroyREAL8TimeSeries(h[k]);
+		XLALDestroyREAL8TimeSeries(hnet[k]);
+		XLALDestroyREAL8TimeSeries(target[k]);
+		XLALDestroyREAL8TimeSeries(targetnet[k]);
+		XLALDestroyREAL8TimeSeries(targetinj[k]);
+	}
+	XLALDestroyREAL8TimeSeries(hplus);
+	XLALDestroyREAL8TimeSeries(hcross);
+	XLALDestroyCOMPLEX16FrequencySeries(response);
+	LALCheckMemoryLeaks();
+
+	return failed;
+}